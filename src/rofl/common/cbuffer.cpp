@@ -6,7 +6,8 @@
 
 using namespace rofl;
 
-cbuffer::cbuffer(size_t len) : cmemory(len), wbytes(0), rbytes(0) {}
+cbuffer::cbuffer(size_t len, cmemory_init_t init)
+    : cmemory(len, init), wbytes(0), rbytes(0) {}
 
 cbuffer::cbuffer(uint8_t *data, size_t datalen)
     : cmemory(data, datalen), wbytes(datalen), rbytes(0) {}
@@ -61,8 +61,9 @@ public:
    * (default: 1024 bytes).
    *
    * @param len length of new buffer area to be allocated via malloc.
+   * @param init INIT_UNINITIALIZED skips zero-filling the buffer area
    */
-  cbuffer(size_t len = CBUFFER_DEFAULT_SIZE);
+  cbuffer(size_t len = CBUFFER_DEFAULT_SIZE, cmemory_init_t init = INIT_ZERO);
 
   /**
    * @brief	Constructor. Allocates a new buffer area and clones specified
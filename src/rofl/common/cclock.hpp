@@ -0,0 +1,31 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * cclock.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SRC_ROFL_COMMON_CCLOCK_HPP_
+#define SRC_ROFL_COMMON_CCLOCK_HPP_
+
+#include <stdint.h>
+#include <time.h>
+
+namespace rofl {
+
+/**
+ * @brief	Returns CLOCK_MONOTONIC in nanoseconds, used for timestamping
+ * queued messages
+ */
+inline uint64_t now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+}; // end of namespace rofl
+
+#endif /* SRC_ROFL_COMMON_CCLOCK_HPP_ */
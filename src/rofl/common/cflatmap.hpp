@@ -0,0 +1,218 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * cflatmap.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SRC_ROFL_COMMON_CFLATMAP_HPP_
+#define SRC_ROFL_COMMON_CFLATMAP_HPP_
+
+#include <algorithm>
+#include <stddef.h>
+#include <stdexcept>
+#include <utility>
+
+namespace rofl {
+
+/**
+ * @brief	Sorted associative array in contiguous memory
+ *
+ * Drop-in replacement for std::map for small maps of trivially copyable
+ * keys and values. The first N elements are stored inside the object, larger
+ * maps move to a single heap array. Lookups are binary searches, inserting
+ * in ascending key order appends.
+ *
+ * Unlike std::map, inserting or erasing invalidates all iterators and
+ * references into the map.
+ */
+template <typename key_t, typename value_t, size_t N = 8> class cflatmap {
+public:
+  typedef std::pair<key_t, value_t> value_type;
+  typedef value_type *iterator;
+  typedef const value_type *const_iterator;
+
+public:
+  /**
+   *
+   */
+  ~cflatmap() { release(); };
+
+  /**
+   *
+   */
+  cflatmap() : elems(inline_elems), num(0), cap(N){};
+
+  /**
+   *
+   */
+  cflatmap(const cflatmap &map) : elems(inline_elems), num(0), cap(N) {
+    *this = map;
+  };
+
+  /**
+   *
+   */
+  cflatmap &operator=(const cflatmap &map) {
+    if (this == &map)
+      return *this;
+    num = 0;
+    reserve(map.num);
+    std::copy(map.begin(), map.end(), elems);
+    num = map.num;
+    return *this;
+  };
+
+public:
+  iterator begin() { return elems; };
+  iterator end() { return elems + num; };
+  const_iterator begin() const { return elems; };
+  const_iterator end() const { return elems + num; };
+
+  size_t size() const { return num; };
+  bool empty() const { return (0 == num); };
+
+  /**
+   * @brief	Removes all elements, keeps the allocated capacity
+   */
+  void clear() { num = 0; };
+
+  /**
+   * @brief	Ensures capacity for len elements
+   */
+  void reserve(size_t len) {
+    if (len <= cap)
+      return;
+    size_t ncap = std::max(len, 2 * cap);
+    value_type *nelems = new value_type[ncap];
+    std::copy(begin(), end(), nelems);
+    release();
+    elems = nelems;
+    cap = ncap;
+  };
+
+  /**
+   *
+   */
+  iterator find(const key_t &key) {
+    iterator it = lower_bound(key);
+    return ((it != end()) && (it->first == key)) ? it : end();
+  };
+
+  /**
+   *
+   */
+  const_iterator find(const key_t &key) const {
+    const_iterator it = lower_bound(key);
+    return ((it != end()) && (it->first == key)) ? it : end();
+  };
+
+  /**
+   *
+   */
+  size_t count(const key_t &key) const { return (find(key) != end()); };
+
+  /**
+   * @brief	Returns value for key, inserts a value-initialized one if needed
+   */
+  value_t &operator[](const key_t &key) {
+    /* fast path: append in ascending key order */
+    if ((0 == num) || (elems[num - 1].first < key)) {
+      return insert_at(num, key)->second;
+    }
+    iterator it = lower_bound(key);
+    if (it->first == key) {
+      return it->second;
+    }
+    return insert_at(it - elems, key)->second;
+  };
+
+  /**
+   *
+   */
+  value_t &at(const key_t &key) {
+    iterator it = find(key);
+    if (it == end()) {
+      throw std::out_of_range("cflatmap::at()");
+    }
+    return it->second;
+  };
+
+  /**
+   *
+   */
+  const value_t &at(const key_t &key) const {
+    const_iterator it = find(key);
+    if (it == end()) {
+      throw std::out_of_range("cflatmap::at()");
+    }
+    return it->second;
+  };
+
+  /**
+   *
+   */
+  iterator erase(iterator it) {
+    std::copy(it + 1, end(), it);
+    num--;
+    return it;
+  };
+
+  /**
+   *
+   */
+  size_t erase(const key_t &key) {
+    iterator it = find(key);
+    if (it == end()) {
+      return 0;
+    }
+    erase(it);
+    return 1;
+  };
+
+private:
+  iterator lower_bound(const key_t &key) {
+    return std::lower_bound(begin(), end(), key, less_key);
+  };
+
+  const_iterator lower_bound(const key_t &key) const {
+    return std::lower_bound(begin(), end(), key, less_key);
+  };
+
+  static bool less_key(const value_type &elem, const key_t &key) {
+    return (elem.first < key);
+  };
+
+  iterator insert_at(size_t pos, const key_t &key) {
+    reserve(num + 1);
+    std::copy_backward(elems + pos, end(), end() + 1);
+    elems[pos] = value_type(key, value_t());
+    num++;
+    return elems + pos;
+  };
+
+  void release() {
+    if (elems != inline_elems) {
+      delete[] elems;
+      elems = inline_elems;
+      cap = N;
+    }
+  };
+
+private:
+  // points to inline_elems or a heap array
+  value_type *elems;
+  // number of elements
+  size_t num;
+  // capacity of elems
+  size_t cap;
+  // storage for small maps
+  value_type inline_elems[N];
+};
+
+}; // end of namespace rofl
+
+#endif /* SRC_ROFL_COMMON_CFLATMAP_HPP_ */
@@ -3,15 +3,18 @@
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
 #include "cmemory.h"
+#include "cslab.hpp"
 
 using namespace rofl;
 
 /*static*/ std::set<cmemory *> cmemory::cmemory_list;
 /*static*/ pthread_mutex_t cmemory::memlock;
 /*static*/ int cmemory::memlockcnt = 0;
+/*static*/ thread_local cmemory_stats cmemory::stats;
 
-cmemory::cmemory(size_t len)
-    : data(std::make_pair<uint8_t *, size_t>(NULL, 0)) {
+cmemory::cmemory(size_t len, cmemory_init_t init)
+    : data(std::make_pair<uint8_t *, size_t>(NULL, 0)), capacity(0),
+      allocator(ALLOC_NONE) {
 #if 0
 	if (0 == cmemory::memlockcnt)
 	{
@@ -21,12 +24,13 @@ cmemory::cmemory(size_t len)
 #endif
 
   if (len > 0) {
-    mallocate(len);
+    mallocate(len, init);
   }
 }
 
 cmemory::cmemory(uint8_t *data, size_t datalen)
-    : data(std::make_pair<uint8_t *, size_t>(NULL, 0)) {
+    : data(std::make_pair<uint8_t *, size_t>(NULL, 0)), capacity(0),
+      allocator(ALLOC_NONE) {
 #if 0
 	if (0 == cmemory::memlockcnt)
 	{
@@ -36,13 +40,14 @@ cmemory::cmemory(uint8_t *data, size_t datalen)
 #endif
 
   if (datalen > 0) {
-    mallocate(datalen);
+    mallocate(datalen, INIT_UNINITIALIZED);
     memcpy(somem(), data, datalen);
   }
 }
 
 cmemory::cmemory(const cmemory &m)
-    : data(std::make_pair<uint8_t *, size_t>(NULL, 0)) {
+    : data(std::make_pair<uint8_t *, size_t>(NULL, 0)), capacity(0),
+      allocator(ALLOC_NONE) {
 #if 0
 	if (0 == cmemory::memlockcnt)
 	{
@@ -70,7 +75,7 @@ cmemory &cmemory::operator=(const cmemory &m) {
   if (this == &m)
     return *this;
 
-  mallocate(m.memlen());
+  mallocate(m.memlen(), INIT_UNINITIALIZED);
 
   if (m.somem())
     memcpy(this->somem(), m.somem(), m.memlen());
@@ -174,33 +179,47 @@ bool cmemory::operator!=(const cmemory &m) const { return (not operator==(m)); }
 
 void cmemory::assign(uint8_t *buf, size_t buflen) {
   resize(buflen);
-  clear();
-  memcpy(somem(), buf, buflen);
+  if (buflen > 0)
+    memcpy(somem(), buf, buflen);
 }
 
 uint8_t *cmemory::resize(size_t len) {
   if (0 == len) {
     mfree();
-  } else if (len <= data.second) {
-    if ((data.first = (uint8_t *)realloc(data.first, len)) == 0) {
-      throw eSysCall("realloc syscall failed")
-          .set_func(__FUNCTION__)
-          .set_line(__LINE__);
+  } else if (len <= capacity) {
+    if (len > data.second) {
+      memset(data.first + data.second, 0x00, len - data.second);
     }
-    // memset(data.first + len, 0x00, data.second);
 
     // adjust data
     data.second = len;
-  } else {
+  } else if ((ALLOC_HEAP == allocator) &&
+             ((not cslab::is_attached()) || (len > cslab::get_max_size()))) {
     if ((data.first = (uint8_t *)realloc(data.first, len)) == 0) {
       throw eSysCall("realloc syscall failed")
           .set_func(__FUNCTION__)
           .set_line(__LINE__);
     }
+    stats.heap_allocs++;
     memset(data.first + data.second, 0x00, len - data.second);
 
     // adjust data
     data.second = len;
+    capacity = len;
+  } else {
+    /* len exceeds capacity, so mget() never returns inline_data here */
+    uint8_t *ptr = data.first;
+    uint8_t alloc = allocator;
+    uint8_t *p_ptr = mget(len);
+    if (data.second > 0) {
+      memcpy(p_ptr, ptr, data.second);
+    }
+    memset(p_ptr + data.second, 0x00, len - data.second);
+    mput(ptr, alloc);
+
+    // adjust data
+    data.first = p_ptr;
+    data.second = len;
   }
   return data.first;
 }
@@ -223,27 +242,65 @@ std::string cmemory::toString() const {
   return std::string((const char *)somem(), memlen());
 }
 
-void cmemory::mallocate(size_t len) {
-  if (data.first) {
+void cmemory::mallocate(size_t len, cmemory_init_t init) {
+  if ((data.first == nullptr) || (len > capacity)) {
     mfree();
+    data.first = mget(len);
   }
   data.second = len;
 
-  if ((data.first = (uint8_t *)calloc(1, data.second)) == 0) {
-    throw eSysCall("calloc syscall failed")
-        .set_func(__FUNCTION__)
-        .set_line(__LINE__);
+  if (INIT_ZERO == init) {
+    memset(data.first, 0, data.second);
   }
-
-  memset(data.first, 0, data.second);
 }
 
 void cmemory::mfree() {
   if (data.first) {
-    memset(data.first, 0, data.second);
-    free(data.first);
+    mput(data.first, allocator);
   }
   data = std::make_pair<uint8_t *, size_t>(NULL, 0);
+  capacity = 0;
+  allocator = ALLOC_NONE;
+}
+
+uint8_t *cmemory::mget(size_t len) {
+  if (len <= CMEMORY_INLINE_SIZE) {
+    stats.inline_allocs++;
+    capacity = CMEMORY_INLINE_SIZE;
+    allocator = ALLOC_INLINE;
+    return inline_data;
+  }
+
+  if (cslab::is_attached() && (len <= cslab::get_max_size())) {
+    uint8_t *ptr = (uint8_t *)cslab::allocate(len);
+    stats.slab_allocs++;
+    capacity = cslab::usable_size(ptr);
+    allocator = ALLOC_SLAB;
+    return ptr;
+  }
+
+  uint8_t *ptr = (uint8_t *)malloc(len);
+  if (ptr == nullptr) {
+    throw eSysCall("malloc syscall failed")
+        .set_func(__FUNCTION__)
+        .set_line(__LINE__);
+  }
+  stats.heap_allocs++;
+  capacity = len;
+  allocator = ALLOC_HEAP;
+  return ptr;
+}
+
+void cmemory::mput(uint8_t *ptr, uint8_t allocator) {
+  switch (allocator) {
+  case ALLOC_SLAB: {
+    cslab::deallocate(ptr);
+  } break;
+  case ALLOC_HEAP: {
+    free(ptr);
+  } break;
+  default: {};
+  }
 }
 
 uint8_t *cmemory::insert(uint8_t *ptr, size_t len) {
@@ -268,23 +325,11 @@ uint8_t *cmemory::insert(unsigned int offset, size_t len) {
     return somem();
   }
 
-  uint8_t *p_ptr = (uint8_t *)0;
-  size_t p_len = data.second + len;
-
-  if ((p_ptr = (uint8_t *)calloc(1, p_len)) == 0) {
-    throw eSysCall("calloc syscall failed")
-        .set_func(__FUNCTION__)
-        .set_line(__LINE__);
-  }
-
-  memcpy(p_ptr, data.first, offset);
-  memset(p_ptr + offset, 0x00, len);
-  memcpy(p_ptr + offset + len, data.first + offset, data.second - offset);
-
-  free(data.first);
+  size_t tail = data.second - offset;
+  cmemory::resize(data.second + len);
 
-  data.first = p_ptr;
-  data.second = p_len;
+  memmove(data.first + offset + len, data.first + offset, tail);
+  memset(data.first + offset, 0x00, len);
 
   return (somem() + offset);
 }
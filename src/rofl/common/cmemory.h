@@ -28,6 +28,37 @@ public:
   eMemNotFound(const std::string &__arg) : eMemBase(__arg){};
 };
 
+/**
+ * @brief	Allocation counters of cmemory instances
+ */
+class cmemory_stats {
+public:
+  cmemory_stats() : inline_allocs(0), slab_allocs(0), heap_allocs(0){};
+
+  /**
+   * @brief	Number of memory areas allocated from the heap allocator or
+   * slab caches
+   */
+  uint64_t get_allocs() const { return slab_allocs + heap_allocs; };
+
+public:
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const cmemory_stats &stats) {
+    os << "<cmemory_stats inline-allocs: " << stats.inline_allocs
+       << " slab-allocs: " << stats.slab_allocs
+       << " heap-allocs: " << stats.heap_allocs << " >";
+    return os;
+  };
+
+public:
+  // memory areas stored within the cmemory instance
+  uint64_t inline_allocs;
+  // memory areas allocated from a slab cache
+  uint64_t slab_allocs;
+  // memory areas allocated by malloc() or grown by realloc()
+  uint64_t heap_allocs;
+};
+
 /**
  * @class 	cmemory
  * @brief	C++ abstraction for malloc'ed memory areas.
@@ -41,6 +72,12 @@ public:
  * such changes and updates its internal variables appropriately.
  * Memory addresses kept outside of cmemory must be updated by
  * the developer explicitly.
+ *
+ * Memory areas of up to CMEMORY_INLINE_SIZE bytes, e.g. MAC and IP
+ * addresses, are stored within the cmemory instance itself. Areas up to
+ * cslab::get_max_size() are taken from the calling thread's slab cache if
+ * the thread owns one, all others from malloc(). Shrinking an area keeps
+ * its allocation for later growth.
  */
 class cmemory {
 private:
@@ -52,15 +89,22 @@ private:
       data; //< memory area including head- and tail-space
 
 #define CMEMORY_DEFAULT_SIZE 0
+#define CMEMORY_INLINE_SIZE 16
 
 public:
+  enum cmemory_init_t {
+    INIT_ZERO = 0,          // zero-fill new memory area
+    INIT_UNINITIALIZED = 1, // caller overwrites memory area anyway
+  };
+
   /**
    * @brief	Constructor. Allocates a new memory area with specified size
    * (default: 1024 bytes).
    *
    * @param len length of new memory area to be allocated via malloc.
+   * @param init INIT_UNINITIALIZED skips zero-filling the memory area
    */
-  cmemory(size_t len = CMEMORY_DEFAULT_SIZE);
+  cmemory(size_t len = CMEMORY_DEFAULT_SIZE, cmemory_init_t init = INIT_ZERO);
 
   /**
    * @brief	Constructor. Allocates a new memory area and clones specified
@@ -278,17 +322,57 @@ public:
 
   /**@}*/
 
+public:
+  /**
+   * @brief	Returns allocation counters of the calling thread
+   */
+  static const cmemory_stats &get_stats() { return stats; };
+
+  /**
+   * @brief	Resets allocation counters of the calling thread
+   */
+  static void clear_stats() { stats = cmemory_stats(); };
+
 private: // methods
          /** allocate memory
           *
           */
-  void mallocate(size_t len);
+  void mallocate(size_t len, cmemory_init_t init = INIT_ZERO);
 
   /** free memory
    *
    */
   void mfree();
 
+  /** allocate memory area of at least len bytes, sets capacity and
+   * allocator
+   */
+  uint8_t *mget(size_t len);
+
+  /** return memory area obtained from mget()
+   */
+  void mput(uint8_t *ptr, uint8_t allocator);
+
+private:
+  enum cmemory_allocator_t {
+    ALLOC_NONE = 0,
+    ALLOC_INLINE = 1,
+    ALLOC_SLAB = 2,
+    ALLOC_HEAP = 3,
+  };
+
+  // usable size of memory area
+  size_t capacity;
+
+  // cmemory_allocator_t the memory area was obtained from
+  uint8_t allocator;
+
+  // storage for small memory areas
+  uint8_t inline_data[CMEMORY_INLINE_SIZE];
+
+  // allocation counters of the calling thread
+  static thread_local cmemory_stats stats;
+
 public:
   friend std::ostream &operator<<(std::ostream &os, const cmemory &mem) {
     os << "<cmemory: data:" << (void *)mem.data.first
@@ -74,10 +74,14 @@ public:
    */
   cpacket(uint8_t *buf, size_t buflen, size_t head = DEFAULT_HSPACE,
           size_t tail = DEFAULT_TSPACE)
-      : rofl::cmemory(head + buflen + tail), head(head), tail(tail),
-        initial_head(head), initial_tail(tail) {
+      : rofl::cmemory(head + buflen + tail, INIT_UNINITIALIZED), head(head),
+        tail(tail), initial_head(head), initial_tail(tail) {
+    memset(somem(), 0, head);
     if (buf)
       memcpy(somem() + head, buf, buflen);
+    else
+      memset(somem() + head, 0, buflen);
+    memset(somem() + head + buflen, 0, tail);
   };
 
   /**
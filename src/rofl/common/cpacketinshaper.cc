@@ -0,0 +1,195 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * cpacketinshaper.cc
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <algorithm>
+#include <string.h>
+#include <time.h>
+
+#include "rofl/common/cpacketinshaper.h"
+
+using namespace rofl;
+
+// credit of a single token, buckets are refilled by rate per nanosecond
+static const uint64_t TOKEN = 1000000000ULL;
+
+cpacketinshaper::cpacketinshaper()
+    : next_buffer_id(0), buffered(0), evicted(0) {
+  memset(buckets, 0, sizeof(buckets));
+}
+
+/*static*/ uint64_t cpacketinshaper::now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+cpacketinshaper &cpacketinshaper::set_rate_limit(uint8_t reason,
+                                                 unsigned int rate,
+                                                 unsigned int burst) {
+  if (reason >= MAX_REASONS) {
+    throw eInvalid("cpacketinshaper::set_rate_limit() invalid reason",
+                   __FILE__, __FUNCTION__, __LINE__);
+  }
+  AcquireReadWriteLock lock(buckets_lock);
+  bucket_t &bucket = buckets[reason];
+  bucket.rate = rate;
+  bucket.burst = std::max(burst, 1U);
+  bucket.credit = (uint64_t)bucket.burst * TOKEN;
+  bucket.last_ns = now_ns();
+  return *this;
+}
+
+unsigned int cpacketinshaper::get_rate_limit(uint8_t reason) const {
+  if (reason >= MAX_REASONS) {
+    return 0;
+  }
+  AcquireReadLock lock(buckets_lock);
+  return buckets[reason].rate;
+}
+
+cpacketinshaper &cpacketinshaper::clear_rate_limits() {
+  AcquireReadWriteLock lock(buckets_lock);
+  for (auto &bucket : buckets) {
+    bucket.rate = 0;
+  }
+  return *this;
+}
+
+bool cpacketinshaper::admit(uint8_t reason, uint64_t now) {
+  if (reason >= MAX_REASONS) {
+    return true;
+  }
+
+  AcquireReadWriteLock lock(buckets_lock);
+  bucket_t &bucket = buckets[reason];
+
+  if (0 == bucket.rate) {
+    bucket.admitted++;
+    return true;
+  }
+
+  /* refill, a bucket idle for longer than needed to fill it is full */
+  uint64_t limit = (uint64_t)bucket.burst * TOKEN;
+  if (now > bucket.last_ns) {
+    uint64_t elapsed = now - bucket.last_ns;
+    if (elapsed >= (limit - bucket.credit) / bucket.rate) {
+      bucket.credit = limit;
+    } else {
+      bucket.credit += elapsed * bucket.rate;
+    }
+    bucket.last_ns = now;
+  }
+
+  if (bucket.credit < TOKEN) {
+    bucket.dropped++;
+    return false;
+  }
+
+  bucket.credit -= TOKEN;
+  bucket.admitted++;
+  return true;
+}
+
+uint64_t cpacketinshaper::get_admitted(uint8_t reason) const {
+  if (reason >= MAX_REASONS) {
+    return 0;
+  }
+  AcquireReadLock lock(buckets_lock);
+  return buckets[reason].admitted;
+}
+
+uint64_t cpacketinshaper::get_dropped(uint8_t reason) const {
+  if (reason >= MAX_REASONS) {
+    return 0;
+  }
+  AcquireReadLock lock(buckets_lock);
+  return buckets[reason].dropped;
+}
+
+cpacketinshaper &cpacketinshaper::set_buffers(unsigned int num_buffers) {
+  AcquireReadWriteLock lock(buffers_lock);
+  buffers.clear();
+  buffers.resize(num_buffers);
+  for (auto &buffer : buffers) {
+    buffer.buffer_id = NO_BUFFER;
+  }
+  return *this;
+}
+
+unsigned int cpacketinshaper::get_buffers() const {
+  AcquireReadLock lock(buffers_lock);
+  return buffers.size();
+}
+
+uint32_t cpacketinshaper::store(const uint8_t *frame, size_t framelen) {
+  uint32_t buffer_id = reserve();
+  store(buffer_id, frame, framelen);
+  return buffer_id;
+}
+
+uint32_t cpacketinshaper::reserve() {
+  AcquireReadWriteLock lock(buffers_lock);
+
+  if (buffers.empty()) {
+    return NO_BUFFER;
+  }
+
+  uint32_t buffer_id = next_buffer_id;
+  if (++next_buffer_id == NO_BUFFER) {
+    next_buffer_id = 0;
+  }
+  return buffer_id;
+}
+
+void cpacketinshaper::store(uint32_t buffer_id, const uint8_t *frame,
+                            size_t framelen) {
+  AcquireReadWriteLock lock(buffers_lock);
+
+  if (buffers.empty() || (NO_BUFFER == buffer_id)) {
+    return;
+  }
+
+  /* slots keep their memory, frames of similar size are stored without
+   * allocating */
+  buffer_t &buffer = buffers[buffer_id % buffers.size()];
+  if (NO_BUFFER != buffer.buffer_id) {
+    evicted++;
+  }
+  buffer.buffer_id = buffer_id;
+  buffer.frame.assign((uint8_t *)frame, framelen);
+  buffered++;
+}
+
+bool cpacketinshaper::retrieve(uint32_t buffer_id, rofl::cmemory &frame) {
+  AcquireReadWriteLock lock(buffers_lock);
+
+  if (buffers.empty() || (NO_BUFFER == buffer_id)) {
+    return false;
+  }
+
+  buffer_t &buffer = buffers[buffer_id % buffers.size()];
+  if (buffer.buffer_id != buffer_id) {
+    return false;
+  }
+  frame.assign(buffer.frame.somem(), buffer.frame.length());
+  buffer.buffer_id = NO_BUFFER;
+
+  return true;
+}
+
+uint64_t cpacketinshaper::get_buffered() const {
+  AcquireReadLock lock(buffers_lock);
+  return buffered;
+}
+
+uint64_t cpacketinshaper::get_evicted() const {
+  AcquireReadLock lock(buffers_lock);
+  return evicted;
+}
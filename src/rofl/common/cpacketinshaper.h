@@ -0,0 +1,224 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * cpacketinshaper.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SRC_ROFL_COMMON_CPACKETINSHAPER_H_
+#define SRC_ROFL_COMMON_CPACKETINSHAPER_H_
+
+#include <inttypes.h>
+#include <ostream>
+#include <vector>
+
+#include "rofl/common/cmemory.h"
+#include "rofl/common/exception.hpp"
+#include "rofl/common/locking.hpp"
+
+namespace rofl {
+
+/**
+ * @ingroup common_devel_workflow
+ * @brief	Per-reason rate limiting and buffer-id store for Packet-Ins
+ *
+ * A datapath sends Packet-Ins to a controller entity through a
+ * cpacketinshaper owned by the respective rofl::crofctl instance.
+ *
+ * Each Packet-In reason may be assigned a token bucket admitting rate
+ * Packet-Ins per second with bursts of up to burst Packet-Ins. A flood
+ * of table-miss Packet-Ins thus cannot exhaust the controller's TX
+ * queue and starve Packet-Ins sent for other reasons.
+ *
+ * When buffers are enabled, the datapath stores full frames locally and
+ * sends truncated frames along with the assigned buffer-id. The store
+ * holds a fixed number of frames, the oldest frame is evicted when a new
+ * frame is stored.
+ */
+class cpacketinshaper {
+public:
+  // Packet-In reasons with a token bucket of their own
+  static const unsigned int MAX_REASONS = 8;
+
+  // buffer-id indicating an unbuffered Packet-In, see OFP_NO_BUFFER
+  static const uint32_t NO_BUFFER = 0xffffffff;
+
+public:
+  /**
+   *
+   */
+  ~cpacketinshaper(){};
+
+  /**
+   * @brief	Creates a shaper admitting all Packet-Ins without buffering
+   */
+  cpacketinshaper();
+
+public:
+  /**
+   * @brief	Limits Packet-Ins for reason to rate per second
+   *
+   * @param reason Packet-In reason (OFPR_*)
+   * @param rate admitted Packet-Ins per second, 0 disables the limit
+   * @param burst maximum number of Packet-Ins admitted at once
+   * @exception eInvalid reason exceeds MAX_REASONS
+   */
+  cpacketinshaper &set_rate_limit(uint8_t reason, unsigned int rate,
+                                  unsigned int burst);
+
+  /**
+   * @brief	Returns admitted Packet-Ins per second for reason, 0: no limit
+   */
+  unsigned int get_rate_limit(uint8_t reason) const;
+
+  /**
+   * @brief	Removes all rate limits
+   */
+  cpacketinshaper &clear_rate_limits();
+
+  /**
+   * @brief	Takes a token for a Packet-In with reason
+   *
+   * Reasons beyond MAX_REASONS are never limited.
+   *
+   * @param now timestamp in nanoseconds, see now_ns()
+   * @return true if the Packet-In may be sent, false if it must be dropped
+   */
+  bool admit(uint8_t reason, uint64_t now = now_ns());
+
+  /**
+   * @brief	Returns number of Packet-Ins admitted for reason
+   */
+  uint64_t get_admitted(uint8_t reason) const;
+
+  /**
+   * @brief	Returns number of Packet-Ins dropped for reason
+   */
+  uint64_t get_dropped(uint8_t reason) const;
+
+public:
+  /**
+   * @brief	Sets number of frames stored locally, 0 disables buffering
+   *
+   * All frames currently stored are dropped.
+   */
+  cpacketinshaper &set_buffers(unsigned int num_buffers);
+
+  /**
+   *
+   */
+  unsigned int get_buffers() const;
+
+  /**
+   * @brief	Stores a copy of frame and returns its buffer-id
+   *
+   * @return buffer-id or NO_BUFFER if buffering is disabled
+   */
+  uint32_t store(const uint8_t *frame, size_t framelen);
+
+  /**
+   * @brief	Assigns a buffer-id without storing a frame yet
+   *
+   * The frame is stored by store(buffer_id, ...) once the Packet-In
+   * carrying the buffer-id has been queued. A buffer-id whose Packet-In
+   * is dropped is never stored and evicts no other frame.
+   *
+   * @return buffer-id or NO_BUFFER if buffering is disabled
+   */
+  uint32_t reserve();
+
+  /**
+   * @brief	Stores a copy of frame for a buffer-id assigned by reserve()
+   */
+  void store(uint32_t buffer_id, const uint8_t *frame, size_t framelen);
+
+  /**
+   * @brief	Removes the frame stored for buffer_id
+   *
+   * @param frame receives the stored frame
+   * @return false if buffer_id is unknown or has been evicted already
+   */
+  bool retrieve(uint32_t buffer_id, rofl::cmemory &frame);
+
+  /**
+   * @brief	Returns number of frames stored
+   */
+  uint64_t get_buffered() const;
+
+  /**
+   * @brief	Returns number of frames evicted before being retrieved
+   */
+  uint64_t get_evicted() const;
+
+public:
+  /**
+   * @brief	Returns CLOCK_MONOTONIC in nanoseconds
+   */
+  static uint64_t now_ns();
+
+public:
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const cpacketinshaper &shaper) {
+    os << "<cpacketinshaper buffers: " << shaper.get_buffers()
+       << " buffered: " << shaper.get_buffered()
+       << " evicted: " << shaper.get_evicted() << " >" << std::endl;
+    for (unsigned int reason = 0; reason < MAX_REASONS; reason++) {
+      if ((0 == shaper.get_rate_limit(reason)) &&
+          (0 == shaper.get_admitted(reason)))
+        continue;
+      os << "  <reason: " << reason
+         << " rate: " << shaper.get_rate_limit(reason)
+         << " admitted: " << shaper.get_admitted(reason)
+         << " dropped: " << shaper.get_dropped(reason) << " >" << std::endl;
+    }
+    return os;
+  };
+
+private:
+  struct bucket_t {
+    // tokens added per second, 0: unlimited
+    unsigned int rate;
+    // maximum number of tokens
+    unsigned int burst;
+    // available tokens multiplied by 10^9
+    uint64_t credit;
+    // last refill
+    uint64_t last_ns;
+    // statistics
+    uint64_t admitted;
+    uint64_t dropped;
+  };
+
+  struct buffer_t {
+    // buffer-id assigned to frame
+    uint32_t buffer_id;
+    // stored frame
+    rofl::cmemory frame;
+  };
+
+  // token buckets indexed by reason
+  bucket_t buckets[MAX_REASONS];
+
+  // rwlock for buckets
+  crwlock buckets_lock;
+
+  // ring of stored frames, slot is buffer_id modulo buffers.size()
+  std::vector<buffer_t> buffers;
+
+  // next buffer-id to assign
+  uint32_t next_buffer_id;
+
+  // statistics
+  uint64_t buffered;
+  uint64_t evicted;
+
+  // rwlock for buffers
+  crwlock buffers_lock;
+};
+
+}; // end of namespace rofl
+
+#endif /* SRC_ROFL_COMMON_CPACKETINSHAPER_H_ */
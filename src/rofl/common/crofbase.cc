@@ -12,6 +12,7 @@
 
 #include "crofbase.h"
 #include <cinttypes>
+#include <map>
 
 using namespace rofl;
 
@@ -43,8 +44,10 @@ crofbase::~crofbase() {
 
 crofbase::crofbase()
     : thread_num(cthread::get_mgt_thread_num_from_pool()), state(STATE_RUNNING),
-      generation_is_defined(false),
-      cached_generation_id((uint64_t)((int64_t)-1)), enforce_tls(false) {
+      rofdpts_next_id(0), rofctls_next_id(0), listen_mode(LISTEN_MODE_SINGLE),
+      listen_backlog(DEFAULT_LISTEN_BACKLOG), generation_is_defined(false),
+      cached_generation_id((uint64_t)((int64_t)-1)), enforce_tls(false),
+      capture(nullptr) {
   AcquireReadWriteLock rwlock(rofbases_rwlock);
   if (crofbase::rofbases.empty()) {
     crofbase::initialize();
@@ -132,6 +135,21 @@ void crofbase::send_packet_in_message(const cauxid &auxid, uint32_t buffer_id,
                                       uint8_t *data, size_t datalen) {
   bool sent_out = false;
 
+  /* Packet-In packed once per OpenFlow version and shared by all
+   * controllers using this version, keyed by version. Controllers
+   * buffering frames assign their own buffer-ids and are served
+   * individually. */
+  std::map<uint8_t, std::shared_ptr<const rofl::cmemory>> wires;
+  std::map<uint8_t, unsigned int> num_ctls;
+
+  for (auto it : rofctls) {
+    uint8_t version = it.second->get_version();
+    if (it.second->is_established() &&
+        (0 == it.second->get_packet_in_shaper().get_buffers())) {
+      num_ctls[version]++;
+    }
+  }
+
   for (auto it : rofctls) {
 
     crofctl &ctl = *(it.second);
@@ -140,12 +158,28 @@ void crofbase::send_packet_in_message(const cauxid &auxid, uint32_t buffer_id,
       continue;
     }
 
-    ctl.send_packet_in_message(auxid, buffer_id, total_len, reason, table_id,
-                               cookie,
-                               in_port, // for OF1.0
-                               match, data, datalen);
-
     sent_out = true;
+
+    /* a single controller gets its Packet-In packed directly */
+    uint8_t version = ctl.get_version();
+    if ((num_ctls[version] < 2) ||
+        (ctl.get_packet_in_shaper().get_buffers() > 0)) {
+      ctl.send_packet_in_message(auxid, buffer_id, total_len, reason,
+                                 table_id, cookie,
+                                 in_port, // for OF1.0
+                                 match, data, datalen);
+      continue;
+    }
+
+    std::shared_ptr<const rofl::cmemory> &wire = wires[version];
+    if (not wire) {
+      rofl::openflow::cofmsg_packet_in msg(version, 0, buffer_id, total_len,
+                                           reason, table_id, cookie, in_port,
+                                           match, data, datalen);
+      wire = rofl::openflow::cofmsg_packet_in_shared::make_wire(msg);
+    }
+
+    ctl.send_packet_in_message(auxid, reason, wire);
   }
 
   if (not sent_out) {
@@ -205,12 +239,55 @@ void crofbase::send_port_status_message(const cauxid &auxid, uint8_t reason,
   }
 }
 
-int crofbase::listen(const csockaddr &baddr) {
+std::vector<crofbase::listener_t>
+crofbase::open_listeners(const csockaddr &baddr) {
+  std::vector<listener_t> listeners;
+  switch (listen_mode) {
+  case LISTEN_MODE_REUSEPORT: {
+    try {
+      for (uint32_t i = 0; i < cthread::get_num_io_threads(); i++) {
+        listener_t listener;
+        listener.sd = listen(baddr, true);
+        listener.thread_num = cthread::get_io_thread_num_from_pool();
+        listeners.push_back(listener);
+      }
+    } catch (eSysCall &e) {
+      for (auto &listener : listeners) {
+        ::close(listener.sd);
+      }
+      throw;
+    }
+  } break;
+  case LISTEN_MODE_SINGLE:
+  default: {
+    listener_t listener;
+    listener.sd = listen(baddr);
+    listener.thread_num = thread_num;
+    listeners.push_back(listener);
+  };
+  }
+
+  /* instruct threads to read from socket descriptors */
+  for (auto &listener : listeners) {
+    cthread::thread(listener.thread_num).add_fd(this, listener.sd);
+    cthread::thread(listener.thread_num).add_read_fd(this, listener.sd, false);
+  }
+  return listeners;
+}
+
+void crofbase::close_listeners(const std::vector<listener_t> &listeners) {
+  for (auto &listener : listeners) {
+    cthread::thread(listener.thread_num).drop_fd(listener.sd, false);
+    ::close(listener.sd);
+  }
+}
+
+int crofbase::listen(const csockaddr &baddr, bool reuseport) {
   int sd;
   int rc;
   int type = SOCK_STREAM;
   int protocol = IPPROTO_TCP;
-  int backlog = 10;
+  int backlog = listen_backlog;
 
   /* open socket */
   if ((sd = ::socket(baddr.get_family(), type, protocol)) < 0) {
@@ -236,12 +313,12 @@ int crofbase::listen(const csockaddr &baddr) {
       throw eSysCall("setsockopt() SOL_SOCKET, SO_REUSEADDR");
     }
 
-#if 0
-		int on = 1;
-		if ((rc = ::setsockopt(sd, SOL_SOCKET, SO_REUSEPORT, &on, sizeof(on))) < 0) {
-			throw eSysCall("setsockopt(SOL_SOCKET, SO_REUSEPORT)");
-		}
-#endif
+    // set SO_REUSEPORT option for sharded listening sockets
+    if (reuseport &&
+        ((rc = ::setsockopt(sd, SOL_SOCKET, SO_REUSEPORT, (int *)&optval,
+                            sizeof(optval))) < 0)) {
+      throw eSysCall("setsockopt() SOL_SOCKET, SO_REUSEPORT");
+    }
 
     // set TCP_NODELAY option on TCP sockets
     if ((rc = ::setsockopt(sd, IPPROTO_TCP, TCP_NODELAY, (int *)&optval,
@@ -306,7 +383,7 @@ void crofbase::handle_timeout(cthread &thread, uint32_t timer_id) {
 void crofbase::handle_read_event(cthread &thread, int fd) {
   if (delete_in_progress())
     return;
-  std::map<csockaddr, int>::iterator it;
+  std::map<csockaddr, std::vector<listener_t>>::iterator it;
 
   {
     /* incoming datapath connection */
@@ -334,7 +411,8 @@ void crofbase::handle_read_event(cthread &thread, int fd) {
 
         if (enforce_tls) {
           (new crofconn(this))
-              ->set_tls_capath(capath)
+              ->set_capture(capture)
+              .set_tls_capath(capath)
               .set_tls_cafile(cafile)
               .set_tls_certfile(certfile)
               .set_tls_keyfile(keyfile)
@@ -345,7 +423,8 @@ void crofbase::handle_read_event(cthread &thread, int fd) {
               .tls_accept(sockfd, versionbitmap, crofconn::MODE_CONTROLLER);
         } else {
           (new crofconn(this))
-              ->tcp_accept(sockfd, versionbitmap, crofconn::MODE_CONTROLLER);
+              ->set_capture(capture)
+              .tcp_accept(sockfd, versionbitmap, crofconn::MODE_CONTROLLER);
         }
       }
     }
@@ -377,7 +456,8 @@ void crofbase::handle_read_event(cthread &thread, int fd) {
 
         if (enforce_tls) {
           (new crofconn(this))
-              ->set_tls_capath(capath)
+              ->set_capture(capture)
+              .set_tls_capath(capath)
               .set_tls_cafile(cafile)
               .set_tls_certfile(certfile)
               .set_tls_keyfile(keyfile)
@@ -388,13 +468,61 @@ void crofbase::handle_read_event(cthread &thread, int fd) {
               .tls_accept(sockfd, versionbitmap, crofconn::MODE_DATAPATH);
         } else {
           (new crofconn(this))
-              ->tcp_accept(sockfd, versionbitmap, crofconn::MODE_DATAPATH);
+              ->set_capture(capture)
+              .tcp_accept(sockfd, versionbitmap, crofconn::MODE_DATAPATH);
         }
       }
     }
   }
 }
 
+size_t crofbase::replay_dpt(const crofcapture &capture, bool paced) {
+  crofconn *conn = new crofconn(this);
+  conn->set_capture(this->capture);
+  conn->replay_accept(versionbitmap, crofconn::MODE_CONTROLLER);
+  return conn->replay(capture, paced);
+}
+
+crofdpt *crofbase::find_dpt(const cdpid &dpid) const {
+  auto range = rofdpts_dpids.equal_range(dpid);
+  if (range.first == range.second) {
+    return nullptr;
+  }
+  /* several instances may share a dpid, prefer the lowest dptid */
+  cdptid dptid = range.first->second;
+  for (auto it = range.first; it != range.second; ++it) {
+    dptid = std::min(dptid, it->second);
+  }
+  return rofdpts.at(dptid);
+}
+
+void crofbase::erase_dpid(const cdpid &dpid, const cdptid &dptid) {
+  auto range = rofdpts_dpids.equal_range(dpid);
+  for (auto it = range.first; it != range.second; ++it) {
+    if (it->second == dptid) {
+      rofdpts_dpids.erase(it);
+      return;
+    }
+  }
+  /* dpid changed concurrently, search by dptid instead */
+  for (auto it = rofdpts_dpids.begin(); it != rofdpts_dpids.end(); ++it) {
+    if (it->second == dptid) {
+      rofdpts_dpids.erase(it);
+      return;
+    }
+  }
+}
+
+void crofbase::handle_dpid_changed(crofdpt &dpt, const cdpid &old_dpid) {
+  AcquireReadWriteLock rwlock(rofdpts_rwlock);
+  auto it = rofdpts.find(dpt.get_dptid());
+  if ((it == rofdpts.end()) || (it->second != &dpt)) {
+    return;
+  }
+  erase_dpid(old_dpid, dpt.get_dptid());
+  rofdpts_dpids.insert(std::make_pair(dpt.get_dpid(), dpt.get_dptid()));
+}
+
 void crofbase::handle_established(crofconn &conn, uint8_t ofp_version) {
   if (delete_in_progress())
     return;
@@ -402,14 +530,9 @@ void crofbase::handle_established(crofconn &conn, uint8_t ofp_version) {
 
   switch (conn.get_mode()) {
   case crofconn::MODE_CONTROLLER: {
-    rofl::cdptid dptid;
     /* if datapath for dpid already exists add connection there
      * or create new crofdpt instance */
-    if (not has_dpt(cdpid(conn.get_dpid()))) {
-      dptid = add_dpt().get_dptid();
-    } else {
-      dptid = set_dpt(cdpid(conn.get_dpid())).get_dptid();
-    }
+    rofl::cdptid dptid = set_dpt(cdpid(conn.get_dpid())).get_dptid();
 
     /* add new connection to crofdpt instance */
     set_dpt(dptid).add_conn(&conn);
@@ -463,9 +586,7 @@ void crofbase::handle_accept_failed(crofconn &conn) {
 }
 
 void crofbase::handle_negotiation_failed(crofconn &conn) {
-  if (delete_in_progress())
-    return;
-  delete &conn;
+  /* connection is closed next, handle_closed() deletes it */
 }
 
 void crofbase::handle_closed(crofconn &conn) {
@@ -14,6 +14,7 @@
 #define CROFBASE_H 1
 
 #include <glog/logging.h>
+#include <unordered_map>
 #include <vector>
 
 #include "rofl/common/exception.hpp"
@@ -57,6 +58,14 @@ class crofbase : public virtual rofl::cthread_env,
     STATE_DELETE_IN_PROGRESS,
   };
 
+public:
+  enum listen_mode_t {
+    // single listening socket served by the management thread
+    LISTEN_MODE_SINGLE,
+    // one SO_REUSEPORT listening socket per IO thread
+    LISTEN_MODE_REUSEPORT,
+  };
+
 public:
   /**
    * @brief	crofbase destructor
@@ -68,6 +77,37 @@ public:
    */
   crofbase();
 
+public:
+  /**
+   * @brief	Sets the mode for listening sockets opened afterwards
+   *
+   * In LISTEN_MODE_REUSEPORT, the kernel distributes incoming connections
+   * over one listening socket per IO thread, so accepting connections is
+   * spread over all IO threads.
+   */
+  crofbase &set_listen_mode(listen_mode_t listen_mode) {
+    this->listen_mode = listen_mode;
+    return *this;
+  };
+
+  /**
+   *
+   */
+  listen_mode_t get_listen_mode() const { return listen_mode; };
+
+  /**
+   * @brief	Sets the backlog for listening sockets opened afterwards
+   */
+  crofbase &set_listen_backlog(int listen_backlog) {
+    this->listen_backlog = listen_backlog;
+    return *this;
+  };
+
+  /**
+   *
+   */
+  int get_listen_backlog() const { return listen_backlog; };
+
 public:
   /**
    *
@@ -77,6 +117,42 @@ public:
     return *this;
   };
 
+public:
+  /**
+   * @brief	Returns capture attached to accepted connections
+   */
+  crofcapture *get_capture() const { return capture; };
+
+  /**
+   * @brief	Sets capture attached to connections accepted afterwards
+   *
+   * Records of concurrent connections are interleaved in the capture,
+   * so a session meant for replay_dpt() should be captured with a single
+   * datapath connected. See crofsock::set_capture() for details.
+   *
+   * @param capture capture opened for writing or nullptr
+   */
+  crofbase &set_capture(crofcapture *capture) {
+    this->capture = capture;
+    return *this;
+  };
+
+  /**
+   * @brief	Replays a captured datapath connection without a socket
+   *
+   * Creates a connection in controller mode and feeds all messages
+   * received in the capture through crofconn and crofdpt like on an
+   * accepted connection, see crofsock::replay(). The capture must start
+   * with the datapath's HELLO and FEATURES.reply messages. Messages sent
+   * to the datapath are discarded.
+   *
+   * @param capture capture opened for reading
+   * @param paced when true, messages are delivered at their recorded time
+   * offsets, otherwise as fast as possible
+   * @return number of messages replayed
+   */
+  size_t replay_dpt(const crofcapture &capture, bool paced = false);
+
 public:
   /**
    *
@@ -205,8 +281,7 @@ public:
   void close_dpt_socks() {
     AcquireReadWriteLock rwlock(dpt_sockets_rwlock);
     for (auto it : dpt_sockets) {
-      ::close(it.second);
-      cthread::thread(thread_num).drop_read_fd(it.second, false);
+      close_listeners(it.second);
     }
     dpt_sockets.clear();
   };
@@ -223,11 +298,7 @@ public:
       return;
     }
 
-    dpt_sockets[baddr] = listen(baddr);
-
-    /* instruct thread to read from socket descriptor */
-    cthread::thread(thread_num).add_fd(this, dpt_sockets[baddr]);
-    cthread::thread(thread_num).add_read_fd(this, dpt_sockets[baddr], false);
+    dpt_sockets[baddr] = open_listeners(baddr);
   };
 
   /**
@@ -240,8 +311,7 @@ public:
     if (dpt_sockets.find(baddr) == dpt_sockets.end()) {
       return false;
     }
-    ::close(dpt_sockets[baddr]);
-    cthread::thread(thread_num).drop_read_fd(dpt_sockets[baddr], false);
+    close_listeners(dpt_sockets[baddr]);
     dpt_sockets.erase(baddr);
     return true;
   };
@@ -275,8 +345,7 @@ public:
   void close_ctl_socks() {
     AcquireReadWriteLock rwlock(ctl_sockets_rwlock);
     for (auto it : ctl_sockets) {
-      ::close(it.second);
-      cthread::thread(thread_num).drop_read_fd(it.second, false);
+      close_listeners(it.second);
     }
     ctl_sockets.clear();
   };
@@ -293,11 +362,7 @@ public:
       return;
     }
 
-    ctl_sockets[baddr] = listen(baddr);
-
-    /* instruct thread to read from socket descriptor */
-    cthread::thread(thread_num).add_fd(this, ctl_sockets[baddr]);
-    cthread::thread(thread_num).add_read_fd(this, ctl_sockets[baddr], false);
+    ctl_sockets[baddr] = open_listeners(baddr);
   };
 
   /**
@@ -310,8 +375,7 @@ public:
     if (ctl_sockets.find(baddr) == ctl_sockets.end()) {
       return false;
     }
-    ::close(dpt_sockets[baddr]);
-    cthread::thread(thread_num).drop_read_fd(ctl_sockets[baddr], false);
+    close_listeners(ctl_sockets[baddr]);
     ctl_sockets.erase(baddr);
     return true;
   };
@@ -364,6 +428,7 @@ public:
       rofdpts_deletion.insert(it.second);
     }
     rofdpts.clear();
+    rofdpts_dpids.clear();
     if (not cthread::thread(thread_num)
                 .has_timer(this, TIMER_ID_ROFDPT_DESTROY)) {
       cthread::thread(thread_num)
@@ -394,12 +459,7 @@ public:
    */
   rofl::crofdpt &add_dpt() {
     AcquireReadWriteLock rwlock(rofdpts_rwlock);
-    cdptid id = 0;
-    while (rofdpts.find(id) != rofdpts.end()) {
-      id++;
-    }
-    rofdpts[id] = new crofdpt(this, id);
-    return *(rofdpts[id]);
+    return create_dpt(alloc_dptid());
   };
 
   /**
@@ -426,11 +486,11 @@ public:
   rofl::crofdpt &add_dpt(const rofl::cdptid &dptid) {
     AcquireReadWriteLock rwlock(rofdpts_rwlock);
     if (rofdpts.find(dptid) != rofdpts.end()) {
+      erase_dpid(rofdpts[dptid]->get_dpid(), dptid);
       delete rofdpts[dptid];
       rofdpts.erase(dptid);
     }
-    rofdpts[dptid] = new crofdpt(this, dptid);
-    return *(rofdpts[dptid]);
+    return create_dpt(dptid);
   };
 
   /**
@@ -452,7 +512,7 @@ public:
     if (rofdpts.find(dptid) == rofdpts.end()) {
       if (raise)
         throw eRofBaseNotFound("rofl::crofbase::set_dpt() dptid not found");
-      rofdpts[dptid] = new crofdpt(this, dptid);
+      create_dpt(dptid);
     }
     return *(rofdpts[dptid]);
   };
@@ -484,7 +544,7 @@ public:
       rofl::cdptid dptid) { // make a copy here, do not use a const reference
     if (delete_in_progress())
       return true;
-    AcquireReadLock rlock(rofdpts_rwlock);
+    AcquireReadWriteLock rwlock(rofdpts_rwlock);
     if (rofdpts.find(dptid) == rofdpts.end()) {
       return false;
     }
@@ -496,6 +556,7 @@ public:
     /* add pointer to crofdpt instance on heap to rofdpts_deletion */
     rofdpts_deletion.insert(rofdpts[dptid]);
     /* mark its dptid as free */
+    erase_dpid(rofdpts[dptid]->get_dpid(), dptid);
     rofdpts.erase(dptid);
     /* trigger management thread for doing the clean-up work */
     if (not cthread::thread(thread_num)
@@ -540,17 +601,11 @@ public:
    */
   rofl::crofdpt &set_dpt(const rofl::cdpid &dpid) {
     AcquireReadWriteLock rwlock(rofdpts_rwlock);
-    std::map<cdptid, crofdpt *>::iterator it;
-    if ((it = find_if(rofdpts.begin(), rofdpts.end(),
-                      crofdpt::crofdpt_find_by_dpid(dpid))) != rofdpts.end()) {
-      return *(it->second);
+    crofdpt *dpt = find_dpt(dpid);
+    if (nullptr != dpt) {
+      return *dpt;
     }
-    cdptid id = 0;
-    while (rofdpts.find(id) != rofdpts.end()) {
-      id++;
-    }
-    rofdpts[id] = new crofdpt(this, id);
-    return *(rofdpts[id]);
+    return create_dpt(alloc_dptid());
   };
 
   /**
@@ -562,12 +617,7 @@ public:
    */
   bool has_dpt(const rofl::cdpid &dpid) const {
     AcquireReadLock rlock(rofdpts_rwlock);
-    std::map<rofl::cdptid, crofdpt *>::const_iterator it;
-    if ((it = find_if(rofdpts.begin(), rofdpts.end(),
-                      crofdpt::crofdpt_find_by_dpid(dpid))) == rofdpts.end()) {
-      return false;
-    }
-    return true;
+    return (nullptr != find_dpt(dpid));
   };
 
   /**@}*/
@@ -637,12 +687,8 @@ public:
    */
   rofl::crofctl &add_ctl() {
     AcquireReadWriteLock rwlock(rofctls_rwlock);
-    uint64_t id = 0;
-    while (rofctls.find(cctlid(id)) != rofctls.end()) {
-      id++;
-    }
-    rofctls[cctlid(id)] = new crofctl(this, cctlid(id));
-    return *(rofctls[cctlid(id)]);
+    cctlid ctlid(alloc_ctlid());
+    return *(rofctls[ctlid] = new crofctl(this, ctlid));
   };
 
   /**
@@ -727,7 +773,7 @@ public:
       rofl::cctlid ctlid) { // make a copy here, do not use a const reference
     if (delete_in_progress())
       return true;
-    AcquireReadLock rlock(rofctls_rwlock);
+    AcquireReadWriteLock rwlock(rofctls_rwlock);
     if (rofctls.find(ctlid) == rofctls.end()) {
       return false;
     }
@@ -1230,6 +1276,23 @@ public:
   virtual void handle_stats_reply_timeout(rofl::crofdpt &dpt, uint32_t xid,
                                           uint8_t stats_type){};
 
+  /**
+   * @brief	OpenFlow Stats-Reply segment received.
+   *
+   * Called for each segment of a streamed multipart reply without a
+   * dedicated segment handler, see rofl::crofdpt::set_multipart_streaming().
+   * msg is an instance of the reply class specific to its stats type.
+   *
+   * @param dpt datapath instance
+   * @param auxid control connection identifier
+   * @param msg OpenFlow message instance carrying this segment's entries
+   * @param last true for the final segment of this reply
+   */
+  virtual void
+  handle_stats_reply_segment(rofl::crofdpt &dpt, const rofl::cauxid &auxid,
+                             rofl::openflow::cofmsg_stats_reply &msg,
+                             bool last){};
+
   /**
    * @brief	OpenFlow Desc-Stats-Reply message received.
    *
@@ -1326,6 +1389,22 @@ public:
   virtual void handle_flow_stats_reply_timeout(rofl::crofdpt &dpt,
                                                uint32_t xid){};
 
+  /**
+   * @brief	OpenFlow Flow-Stats-Reply segment received.
+   *
+   * Called instead of handle_flow_stats_reply() for each segment as it
+   * arrives if streaming of Flow-Stats-Replies is enabled, see
+   * rofl::crofdpt::set_multipart_streaming().
+   *
+   * @param dpt datapath instance
+   * @param auxid control connection identifier
+   * @param msg OpenFlow message instance carrying this segment's entries
+   * @param last true for the final segment of this reply
+   */
+  virtual void handle_flow_stats_reply_segment(
+      rofl::crofdpt &dpt, const rofl::cauxid &auxid,
+      rofl::openflow::cofmsg_flow_stats_reply &msg, bool last){};
+
   /**
    * @brief	OpenFlow Aggregate-Stats-Reply message received.
    *
@@ -2145,14 +2224,26 @@ public:
 
   /**@}*/
 
+private:
+  struct listener_t {
+    // socket descriptor
+    int sd;
+    // thread observing the socket
+    uint32_t thread_num;
+  };
+
 public:
   class csocket_find_by_sock_descriptor {
     int sd;
 
   public:
     csocket_find_by_sock_descriptor(int sd) : sd(sd){};
-    bool operator()(const std::pair<csockaddr, int> &p) {
-      return (p.second == sd);
+    bool operator()(const std::pair<csockaddr, std::vector<listener_t>> &p) {
+      for (auto &listener : p.second) {
+        if (listener.sd == sd)
+          return true;
+      }
+      return false;
     };
   };
 
@@ -2172,6 +2263,8 @@ public:
 private:
   static const uint32_t DEFAULT_POOL_MAX_NUM_THREADS = 16;
 
+  static const int DEFAULT_LISTEN_BACKLOG = 10;
+
   static void
   initialize(uint32_t pool_max_num_threads = DEFAULT_POOL_MAX_NUM_THREADS);
 
@@ -2261,7 +2354,18 @@ private:
    *
    * @return socket descriptor
    */
-  int listen(const csockaddr &baddr);
+  int listen(const csockaddr &baddr, bool reuseport = false);
+
+  /**
+   * @brief	open listening sockets according to listen_mode and register
+   * them with their threads
+   */
+  std::vector<listener_t> open_listeners(const csockaddr &baddr);
+
+  /**
+   * @brief	deregister and close listening sockets
+   */
+  void close_listeners(const std::vector<listener_t> &listeners);
 
   /**
    * @brief Check for state delete in progress
@@ -2280,6 +2384,7 @@ private:
       delete it.second;
     }
     rofdpts.clear();
+    rofdpts_dpids.clear();
   };
 
   /**
@@ -2293,6 +2398,50 @@ private:
     rofctls.clear();
   };
 
+private:
+  /**
+   * @brief	Returns an unused dptid, rofdpts_rwlock must be held
+   */
+  cdptid alloc_dptid() {
+    while (rofdpts.find(rofdpts_next_id) != rofdpts.end()) {
+      rofdpts_next_id++;
+    }
+    return rofdpts_next_id++;
+  };
+
+  /**
+   * @brief	Returns an unused ctlid, rofctls_rwlock must be held
+   */
+  uint64_t alloc_ctlid() {
+    while (rofctls.find(cctlid(rofctls_next_id)) != rofctls.end()) {
+      rofctls_next_id++;
+    }
+    return rofctls_next_id++;
+  };
+
+  /**
+   * @brief	Creates a new rofl::crofdpt instance, rofdpts_rwlock must be held
+   */
+  crofdpt &create_dpt(const cdptid &dptid) {
+    crofdpt *dpt = new crofdpt(this, dptid);
+    rofdpts[dptid] = dpt;
+    rofdpts_dpids.insert(std::make_pair(dpt->get_dpid(), dptid));
+    return *dpt;
+  };
+
+  /**
+   * @brief	Returns crofdpt instance with given dpid or nullptr,
+   * rofdpts_rwlock must be held
+   */
+  crofdpt *find_dpt(const cdpid &dpid) const;
+
+  /**
+   * @brief	Removes dptid from the dpid index, rofdpts_rwlock must be held
+   */
+  void erase_dpid(const cdpid &dpid, const cdptid &dptid);
+
+  virtual void handle_dpid_changed(crofdpt &dpt, const cdpid &old_dpid);
+
 private:
   enum crofbase_timer_t {
     TIMER_ID_ROFCTL_DESTROY,
@@ -2317,6 +2466,15 @@ private:
   // lock for peer datapath elements
   mutable crwlock rofdpts_rwlock;
 
+  // index of peer datapath elements by their dpid
+  std::unordered_multimap<cdpid, cdptid> rofdpts_dpids;
+
+  // next dptid to be allocated
+  cdptid rofdpts_next_id;
+
+  // next ctlid to be allocated
+  uint64_t rofctls_next_id;
+
   /*
    *
    */
@@ -2331,14 +2489,20 @@ private:
    *
    */
 
+  // mode for new listening sockets
+  listen_mode_t listen_mode;
+
+  // backlog for new listening sockets
+  int listen_backlog;
+
   // listening sockets for accepting connections from datapath elements
-  std::map<csockaddr, int> dpt_sockets;
+  std::map<csockaddr, std::vector<listener_t>> dpt_sockets;
 
   // associated rwlock
   mutable crwlock dpt_sockets_rwlock;
 
   // listening sockets for accepting connections from controller elements
-  std::map<csockaddr, int> ctl_sockets;
+  std::map<csockaddr, std::vector<listener_t>> ctl_sockets;
 
   mutable crwlock ctl_sockets_rwlock;
 
@@ -2354,6 +2518,9 @@ private:
   // enforce use of tls for accepted connections
   bool enforce_tls;
 
+  // capture attached to accepted connections, not owned
+  crofcapture *capture;
+
   std::string capath;
   std::string cafile;
   std::string certfile;
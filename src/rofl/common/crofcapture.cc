@@ -0,0 +1,241 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * crofcapture.cc
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <fcntl.h>
+#include <sched.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "rofl/common/crofcapture.h"
+
+using namespace rofl;
+
+crofcapture::~crofcapture() {
+  try {
+    close();
+  } catch (...) {
+  }
+}
+
+crofcapture::crofcapture()
+    : fd(-1), base(nullptr), capacity(0), writable(false), writers(0),
+      start_ns(0), wpos(0), length(0), records(0), dropped(0) {}
+
+/*static*/ uint64_t crofcapture::now_ns() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+void crofcapture::open_write(const std::string &path, size_t capacity) {
+  close();
+
+  if (capacity < sizeof(header_t)) {
+    throw eInvalid("crofcapture::open_write() capacity too small", __FILE__,
+                   __FUNCTION__, __LINE__);
+  }
+
+  if ((fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644)) < 0) {
+    throw eSysCall("eSysCall", "open", __FILE__, __FUNCTION__, __LINE__);
+  }
+
+  if (::ftruncate(fd, capacity) < 0) {
+    ::close(fd);
+    fd = -1;
+    throw eSysCall("eSysCall", "ftruncate", __FILE__, __FUNCTION__, __LINE__);
+  }
+
+  void *addr =
+      ::mmap(NULL, capacity, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  if (MAP_FAILED == addr) {
+    ::close(fd);
+    fd = -1;
+    throw eSysCall("eSysCall", "mmap", __FILE__, __FUNCTION__, __LINE__);
+  }
+
+  struct timespec ts;
+  clock_gettime(CLOCK_REALTIME, &ts);
+
+  this->path = path;
+  this->base = (uint8_t *)addr;
+  this->capacity = capacity;
+  this->start_ns = now_ns();
+  this->wpos = 0;
+  this->length = 0;
+  this->records = 0;
+  this->dropped = 0;
+
+  header_t *hdr = (header_t *)base;
+  hdr->magic = CAPTURE_MAGIC;
+  hdr->version = CAPTURE_VERSION;
+  hdr->reserved = 0;
+  hdr->start_ns = (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+  hdr->length = 0;
+
+  /* accept appends once the header is in place */
+  this->writable = true;
+}
+
+void crofcapture::open_read(const std::string &path) {
+  close();
+
+  if ((fd = ::open(path.c_str(), O_RDONLY)) < 0) {
+    throw eSysCall("eSysCall", "open", __FILE__, __FUNCTION__, __LINE__);
+  }
+
+  struct stat st;
+  if (::fstat(fd, &st) < 0) {
+    ::close(fd);
+    fd = -1;
+    throw eSysCall("eSysCall", "fstat", __FILE__, __FUNCTION__, __LINE__);
+  }
+
+  if ((size_t)st.st_size < sizeof(header_t)) {
+    ::close(fd);
+    fd = -1;
+    throw eInvalid("crofcapture::open_read() file too short", __FILE__,
+                   __FUNCTION__, __LINE__);
+  }
+
+  /* private writable mapping: crofsock parses messages in place */
+  void *addr = ::mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                      fd, 0);
+  if (MAP_FAILED == addr) {
+    ::close(fd);
+    fd = -1;
+    throw eSysCall("eSysCall", "mmap", __FILE__, __FUNCTION__, __LINE__);
+  }
+
+  this->path = path;
+  this->base = (uint8_t *)addr;
+  this->capacity = st.st_size;
+  this->writable = false;
+  this->records = 0;
+  this->dropped = 0;
+
+  const header_t *hdr = (const header_t *)base;
+  if ((CAPTURE_MAGIC != hdr->magic) || (CAPTURE_VERSION != hdr->version) ||
+      (hdr->length > capacity - sizeof(header_t))) {
+    close();
+    throw eInvalid("crofcapture::open_read() invalid header", __FILE__,
+                   __FUNCTION__, __LINE__);
+  }
+  this->start_ns = hdr->start_ns;
+  this->length = hdr->length;
+
+  /* validate all records once, so iterators never leave the mapping */
+  size_t pos = 0;
+  while (pos < length) {
+    if ((length - pos) < sizeof(record_t)) {
+      close();
+      throw eInvalid("crofcapture::open_read() truncated record", __FILE__,
+                     __FUNCTION__, __LINE__);
+    }
+    const record_t *rec = (const record_t *)(base + sizeof(header_t) + pos);
+    if ((rec->dir > DIR_TX) || (record_size(rec->len) > (length - pos))) {
+      close();
+      throw eInvalid("crofcapture::open_read() invalid record", __FILE__,
+                     __FUNCTION__, __LINE__);
+    }
+    pos += record_size(rec->len);
+    records++;
+  }
+}
+
+void crofcapture::close() {
+  if (nullptr == base) {
+    return;
+  }
+
+  /* stop new appends, then wait for those still copying into the
+   * mapping */
+  bool was_writable = writable.exchange(false);
+  while (writers.load() > 0) {
+    sched_yield();
+  }
+
+  size_t used = was_writable ? wpos.load() : length;
+
+  /* all reserved records are complete now */
+  if (was_writable) {
+    ((header_t *)base)->length = used;
+  }
+
+  ::munmap(base, capacity);
+  base = nullptr;
+
+  if (was_writable) {
+    if (::ftruncate(fd, sizeof(header_t) + used) < 0) {
+      ::close(fd);
+      fd = -1;
+      throw eSysCall("eSysCall", "ftruncate", __FILE__, __FUNCTION__,
+                     __LINE__);
+    }
+  }
+
+  ::close(fd);
+  fd = -1;
+  length = used;
+}
+
+bool crofcapture::append(direction_t dir, const uint8_t *buf, size_t buflen) {
+  struct iovec iov;
+  iov.iov_base = (void *)buf;
+  iov.iov_len = buflen;
+  return append(dir, &iov, 1);
+}
+
+bool crofcapture::append(direction_t dir, const struct iovec *iov,
+                         int iovcnt) {
+  /* announce the writer before checking writable, so that close() either
+   * sees it or this append sees the capture closed */
+  writers++;
+  if (not writable) {
+    writers--;
+    return false;
+  }
+
+  size_t len = 0;
+  for (int i = 0; i < iovcnt; i++) {
+    len += iov[i].iov_len;
+  }
+
+  /* reserve space, RX and TX threads may append concurrently */
+  size_t size = record_size(len);
+  size_t limit = capacity - sizeof(header_t);
+  size_t pos = wpos.load();
+  do {
+    if ((size > limit) || (pos > limit - size)) {
+      dropped++;
+      writers--;
+      return false;
+    }
+  } while (not wpos.compare_exchange_weak(pos, pos + size));
+
+  record_t *rec = (record_t *)(base + sizeof(header_t) + pos);
+  rec->ts_ns = now_ns() - start_ns;
+  rec->len = len;
+  rec->dir = dir;
+  memset(rec->pad, 0, sizeof(rec->pad));
+
+  uint8_t *data = rec->data;
+  for (int i = 0; i < iovcnt; i++) {
+    memcpy(data, iov[i].iov_base, iov[i].iov_len);
+    data += iov[i].iov_len;
+  }
+
+  records++;
+  writers--;
+
+  return true;
+}
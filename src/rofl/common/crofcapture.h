@@ -0,0 +1,243 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * crofcapture.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SRC_ROFL_COMMON_CROFCAPTURE_H_
+#define SRC_ROFL_COMMON_CROFCAPTURE_H_
+
+#include <atomic>
+#include <inttypes.h>
+#include <ostream>
+#include <string>
+#include <sys/uio.h>
+
+#include "rofl/common/exception.hpp"
+
+namespace rofl {
+
+/**
+ * @ingroup common_devel_workflow
+ * @brief	Memory-mapped capture file of OpenFlow byte streams
+ *
+ * A capture file starts with a crofcapture::header_t followed by
+ * crofcapture::record_t entries, each holding the OpenFlow bytes
+ * received or sent by a crofsock together with a timestamp in
+ * nanoseconds relative to opening the capture. Records are aligned to
+ * 8 bytes and stored in host byte order.
+ *
+ * For writing, the file is mapped with its full capacity up front and
+ * records are appended lock-free from the RX and TX threads of a socket.
+ * Records exceeding the remaining capacity are dropped. close() truncates
+ * the file to the bytes actually written.
+ *
+ * For reading, the file is mapped privately and all records are validated
+ * on open(), so iterating over a capture never leaves the mapping.
+ * See crofsock::replay() for feeding a capture back into the library.
+ */
+class crofcapture {
+public:
+  enum direction_t {
+    DIR_RX = 0, // bytes received from the peer
+    DIR_TX = 1, // bytes sent to the peer
+  };
+
+  /* on-disk file header */
+  struct header_t {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint64_t start_ns; // wall clock time of opening the capture
+    uint64_t length;   // bytes of records following this header
+  };
+
+  /* on-disk record */
+  struct record_t {
+    uint64_t ts_ns; // time since opening the capture
+    uint32_t len;   // number of bytes in data
+    uint8_t dir;    // direction_t
+    uint8_t pad[3];
+    uint8_t data[0];
+  };
+
+  /**
+   * @brief	Iterator over the records of a capture opened for reading
+   */
+  class const_iterator {
+  public:
+    const_iterator(const uint8_t *pos) : pos(pos){};
+    const record_t &operator*() const { return *(const record_t *)pos; };
+    const record_t *operator->() const { return (const record_t *)pos; };
+    const_iterator &operator++() {
+      pos += record_size(((const record_t *)pos)->len);
+      return *this;
+    };
+    bool operator==(const const_iterator &it) const { return pos == it.pos; };
+    bool operator!=(const const_iterator &it) const { return pos != it.pos; };
+
+  private:
+    const uint8_t *pos;
+  };
+
+public:
+  /**
+   *
+   */
+  ~crofcapture();
+
+  /**
+   *
+   */
+  crofcapture();
+
+public:
+  /**
+   * @brief	Creates or truncates a capture file and maps it for appending
+   *
+   * @param path name of capture file
+   * @param capacity maximum size of capture file in bytes
+   */
+  void open_write(const std::string &path,
+                  size_t capacity = CAPACITY_DEFAULT);
+
+  /**
+   * @brief	Maps an existing capture file for reading
+   *
+   * @param path name of capture file
+   * @exception eInvalid malformed capture file
+   */
+  void open_read(const std::string &path);
+
+  /**
+   * @brief	Unmaps the capture file and truncates it after writing
+   *
+   * Stops further appends and waits for appends still running on the RX
+   * and TX threads before the record length is published in the header
+   * and the file is unmapped.
+   */
+  void close();
+
+  /**
+   *
+   */
+  bool is_open() const { return (nullptr != base); };
+
+  /**
+   *
+   */
+  bool is_writable() const { return writable.load(); };
+
+public:
+  /**
+   * @brief	Appends a record, returns false if the capture is full
+   */
+  bool append(direction_t dir, const uint8_t *buf, size_t buflen);
+
+  /**
+   * @brief	Appends a record gathered from iovcnt buffers
+   */
+  bool append(direction_t dir, const struct iovec *iov, int iovcnt);
+
+public:
+  /**
+   *
+   */
+  const_iterator begin() const {
+    return const_iterator(base + sizeof(header_t));
+  };
+
+  /**
+   *
+   */
+  const_iterator end() const {
+    return const_iterator(base + sizeof(header_t) + get_length());
+  };
+
+  /**
+   * @brief	Returns number of bytes used by records
+   */
+  size_t get_length() const {
+    return writable ? wpos.load() : length;
+  };
+
+  /**
+   * @brief	Returns number of records stored
+   */
+  uint64_t get_records() const { return records; };
+
+  /**
+   * @brief	Returns number of records dropped due to exhausted capacity
+   */
+  uint64_t get_dropped() const { return dropped; };
+
+  /**
+   * @brief	Returns monotonic time in nanoseconds
+   */
+  static uint64_t now_ns();
+
+  /**
+   * @brief	Returns number of bytes a record of len bytes occupies
+   */
+  static size_t record_size(size_t len) {
+    return (sizeof(record_t) + len + 7) & ~(size_t)7;
+  };
+
+public:
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const crofcapture &capture) {
+    os << "<crofcapture path: " << capture.path
+       << " writable: " << capture.writable
+       << " length: " << capture.get_length()
+       << " records: " << capture.get_records()
+       << " dropped: " << capture.get_dropped() << " >" << std::endl;
+    return os;
+  };
+
+private:
+  /**
+   * @brief	Private copy constructor for suppressing any copy attempt.
+   */
+  crofcapture(const crofcapture &capture);
+
+  /**
+   * @brief	Private assignment operator.
+   */
+  crofcapture &operator=(const crofcapture &capture);
+
+private:
+  static const uint32_t CAPTURE_MAGIC = 0x52464331; // "RFC1"
+  static const uint16_t CAPTURE_VERSION = 1;
+  static const size_t CAPACITY_DEFAULT = 64 * 1024 * 1024;
+
+  // name of capture file
+  std::string path;
+  // file descriptor of capture file
+  int fd;
+  // mapped capture file including header
+  uint8_t *base;
+  // size of mapping
+  size_t capacity;
+  // mapping was opened for writing, cleared first by close()
+  std::atomic_bool writable;
+  // appends in progress, see close()
+  std::atomic<unsigned int> writers;
+  // monotonic time of opening the capture
+  uint64_t start_ns;
+  // bytes of records reserved so far when writing
+  std::atomic<size_t> wpos;
+  // bytes of records when reading
+  size_t length;
+  // number of records stored
+  std::atomic<uint64_t> records;
+  // number of records dropped
+  std::atomic<uint64_t> dropped;
+};
+
+}; // end of namespace rofl
+
+#endif /* SRC_ROFL_COMMON_CROFCAPTURE_H_ */
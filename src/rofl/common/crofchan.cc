@@ -30,22 +30,21 @@ crofchan::send_message(const cauxid &auxid, rofl::openflow::cofmsg *msg) {
   AcquireReadLock rwlock(conns_rwlock);
   if (not is_established()) {
     throw eRofConnNotConnected(
-        "crofchan::send_message() channel not established")
-        .set_func(__FUNCTION__)
-        .set_line(__LINE__);
+        "crofchan::send_message() channel not established", __FILE__,
+        __FUNCTION__, __LINE__);
   }
   if (conns.find(auxid) == conns.end()) {
-    throw eRofConnNotConnected("crofchan::send_message() connection not found")
-        .set_func(__FUNCTION__)
-        .set_line(__LINE__)
-        .set_key("auxid", auxid.str());
+    eRofConnNotConnected e("crofchan::send_message() connection not found",
+                           __FILE__, __FUNCTION__, __LINE__);
+    e.set_key("auxid", auxid.str());
+    throw e;
   }
   if (not conns[auxid]->is_established()) {
-    throw eRofConnNotConnected(
-        "crofchan::send_message() connection not established")
-        .set_func(__FUNCTION__)
-        .set_line(__LINE__)
-        .set_key("auxid", auxid.str());
+    eRofConnNotConnected e(
+        "crofchan::send_message() connection not established", __FILE__,
+        __FUNCTION__, __LINE__);
+    e.set_key("auxid", auxid.str());
+    throw e;
   }
   return conns[auxid]->send_message(msg);
 }
@@ -56,22 +55,56 @@ rofl::crofsock::msg_result_t crofchan::send_message(const cauxid &auxid,
   AcquireReadLock rwlock(conns_rwlock);
   if (not is_established()) {
     throw eRofConnNotConnected(
-        "crofchan::send_message() channel not established")
-        .set_func(__FUNCTION__)
-        .set_line(__LINE__);
+        "crofchan::send_message() channel not established", __FILE__,
+        __FUNCTION__, __LINE__);
   }
   if (conns.find(auxid) == conns.end()) {
-    throw eRofConnNotConnected("crofchan::send_message() connection not found")
-        .set_func(__FUNCTION__)
-        .set_line(__LINE__)
-        .set_key("auxid", auxid.str());
+    eRofConnNotConnected e("crofchan::send_message() connection not found",
+                           __FILE__, __FUNCTION__, __LINE__);
+    e.set_key("auxid", auxid.str());
+    throw e;
   }
   if (not conns[auxid]->is_established()) {
-    throw eRofConnNotConnected(
-        "crofchan::send_message() connection not established")
-        .set_func(__FUNCTION__)
-        .set_line(__LINE__)
-        .set_key("auxid", auxid.str());
+    eRofConnNotConnected e(
+        "crofchan::send_message() connection not established", __FILE__,
+        __FUNCTION__, __LINE__);
+    e.set_key("auxid", auxid.str());
+    throw e;
   }
   return conns[auxid]->send_message(msg, ts);
 }
+
+rofl::crofsock::msg_result_t
+crofchan::try_send_message(const cauxid &auxid, rofl::openflow::cofmsg *msg) {
+  AcquireReadLock rwlock(conns_rwlock);
+  crofconn *conn = find_established_conn(auxid);
+  if (conn == nullptr) {
+    delete msg;
+    return rofl::crofsock::MSG_QUEUEING_FAILED_NOT_ESTABLISHED;
+  }
+  return conn->send_message(msg);
+}
+
+rofl::crofsock::msg_result_t
+crofchan::try_send_message(const cauxid &auxid, rofl::openflow::cofmsg *msg,
+                           const ctimespec &ts) {
+  AcquireReadLock rwlock(conns_rwlock);
+  crofconn *conn = find_established_conn(auxid);
+  if (conn == nullptr) {
+    delete msg;
+    return rofl::crofsock::MSG_QUEUEING_FAILED_NOT_ESTABLISHED;
+  }
+  return conn->send_message(msg, ts);
+}
+
+crofconn *crofchan::find_established_conn(const cauxid &auxid) const {
+  auto it = conns.find(cauxid(0));
+  if ((it == conns.end()) || (not it->second->is_established()))
+    return nullptr;
+  if (auxid.get_id() != 0) {
+    it = conns.find(auxid);
+    if ((it == conns.end()) || (not it->second->is_established()))
+      return nullptr;
+  }
+  return it->second;
+}
@@ -33,27 +33,46 @@ namespace rofl {
 
 class eRofChanBase : public exception {
 public:
-  eRofChanBase(const std::string &__arg) : exception(__arg){};
+  eRofChanBase(const std::string &__arg,
+               const std::string &__file = std::string(""),
+               const std::string &__func = std::string(""), int __line = 0)
+      : exception(__arg, __file, __func, __line){};
 };
 class eRofChanNotFound : public eRofChanBase {
 public:
-  eRofChanNotFound(const std::string &__arg) : eRofChanBase(__arg){};
+  eRofChanNotFound(const std::string &__arg,
+                   const std::string &__file = std::string(""),
+                   const std::string &__func = std::string(""), int __line = 0)
+      : eRofChanBase(__arg, __file, __func, __line){};
 };
 class eRofChanExists : public eRofChanBase {
 public:
-  eRofChanExists(const std::string &__arg) : eRofChanBase(__arg){};
+  eRofChanExists(const std::string &__arg,
+                 const std::string &__file = std::string(""),
+                 const std::string &__func = std::string(""), int __line = 0)
+      : eRofChanBase(__arg, __file, __func, __line){};
 };
 class eRofChanInval : public eRofChanBase {
 public:
-  eRofChanInval(const std::string &__arg) : eRofChanBase(__arg){};
+  eRofChanInval(const std::string &__arg,
+                const std::string &__file = std::string(""),
+                const std::string &__func = std::string(""), int __line = 0)
+      : eRofChanBase(__arg, __file, __func, __line){};
 };
 class eRofChanNotConnected : public eRofChanBase {
 public:
-  eRofChanNotConnected(const std::string &__arg) : eRofChanBase(__arg){};
+  eRofChanNotConnected(const std::string &__arg,
+                       const std::string &__file = std::string(""),
+                       const std::string &__func = std::string(""),
+                       int __line = 0)
+      : eRofChanBase(__arg, __file, __func, __line){};
 };
 class eRofChanExhausted : public eRofChanBase {
 public:
-  eRofChanExhausted(const std::string &__arg) : eRofChanBase(__arg){};
+  eRofChanExhausted(const std::string &__arg,
+                    const std::string &__file = std::string(""),
+                    const std::string &__func = std::string(""), int __line = 0)
+      : eRofChanBase(__arg, __file, __func, __line){};
 };
 
 class crofchan; // forward declaration
@@ -72,10 +91,8 @@ public:
     if (crofchan_env::channel_envs.find(env) ==
         crofchan_env::channel_envs.end()) {
       throw eRofChanNotFound(
-          "crofchan_env::call_env() crofchan_env instance not found")
-          .set_func(__FUNCTION__)
-          .set_file(__FILE__)
-          .set_line(__LINE__);
+          "crofchan_env::call_env() crofchan_env instance not found", __FILE__,
+          __FUNCTION__, __LINE__);
     }
     return *(env);
   };
@@ -163,7 +180,8 @@ public:
   crofchan(crofchan_env *env)
       : env(env), thread_num(cthread::get_mgt_thread_num_from_pool()),
         state(STATE_DISCONNECTED), last_auxid(0),
-        ofp_version(rofl::openflow::OFP_VERSION_UNKNOWN) {
+        ofp_version(rofl::openflow::OFP_VERSION_UNKNOWN),
+        multipart_streaming(0) {
     VLOG(4) << __FUNCTION__
             << "thread: " << cthread::thread(thread_num).get_thread_name();
   };
@@ -182,6 +200,22 @@ public:
                                             rofl::openflow::cofmsg *msg,
                                             const ctimespec &ts);
 
+  /**
+   * @brief Sends message without throwing exceptions
+   *
+   * Returns MSG_QUEUEING_FAILED_NOT_ESTABLISHED if the channel or the
+   * connection for auxid is not established. The message is always consumed.
+   */
+  rofl::crofsock::msg_result_t try_send_message(const cauxid &auxid,
+                                                rofl::openflow::cofmsg *msg);
+
+  /**
+   * @brief Sends message without throwing exceptions
+   */
+  rofl::crofsock::msg_result_t try_send_message(const cauxid &auxid,
+                                                rofl::openflow::cofmsg *msg,
+                                                const ctimespec &ts);
+
 public:
   /**
    *
@@ -193,6 +227,25 @@ public:
    */
   uint8_t get_version() const { return ofp_version; };
 
+  /**
+   * @brief	Returns bitmask of multipart types streamed to the application
+   */
+  uint32_t get_multipart_streaming() const { return multipart_streaming; };
+
+  /**
+   * @brief	Selects multipart reply types streamed to the application on
+   * all current and future connections, see
+   * crofconn::set_multipart_streaming()
+   */
+  crofchan &set_multipart_streaming(uint32_t stats_types) {
+    AcquireReadLock rwlock(conns_rwlock);
+    multipart_streaming = stats_types;
+    for (auto it : conns) {
+      it.second->set_multipart_streaming(stats_types);
+    }
+    return *this;
+  };
+
 public:
   /**
    *
@@ -257,12 +310,11 @@ public:
       last_auxid = (last_auxid == 255) ? 0 : last_auxid + 1;
     }
     if (cnt == 0) {
-      throw eRofChanExhausted("crofchan::add_conn() cauxid namespace exhausted")
-          .set_func(__FUNCTION__)
-          .set_file(__FILE__)
-          .set_line(__LINE__);
+      throw eRofChanExhausted("crofchan::add_conn() cauxid namespace exhausted",
+                              __FILE__, __FUNCTION__, __LINE__);
     }
     (conns[last_auxid] = new crofconn(this))->set_auxid(cauxid(last_auxid));
+    conns[last_auxid]->set_multipart_streaming(multipart_streaming);
     return *(conns[last_auxid]);
   };
 
@@ -275,6 +327,7 @@ public:
       delete conns[auxid];
     }
     (conns[auxid] = new crofconn(this))->set_auxid(auxid);
+    conns[auxid]->set_multipart_streaming(multipart_streaming);
     return *(conns[auxid]);
   };
 
@@ -283,10 +336,8 @@ public:
    */
   crofconn &add_conn(crofconn *conn) {
     if (nullptr == conn) {
-      throw eRofChanInval("crofchan::add_conn() null pointer")
-          .set_func(__FUNCTION__)
-          .set_file(__FILE__)
-          .set_line(__LINE__);
+      throw eRofChanInval("crofchan::add_conn() null pointer", __FILE__,
+                          __FUNCTION__, __LINE__);
     }
     AcquireReadWriteLock rwlock(conns_rwlock);
     cauxid auxid(conn->get_auxid());
@@ -305,6 +356,7 @@ public:
       }
     }
     (conns[auxid] = conn)->set_env(this);
+    conn->set_multipart_streaming(multipart_streaming);
     if (auxid == cauxid(0)) {
       ofp_version = conn->get_version();
     }
@@ -318,6 +370,7 @@ public:
     AcquireReadWriteLock rwlock(conns_rwlock);
     if (conns.find(auxid) == conns.end()) {
       (conns[auxid] = new crofconn(this))->set_auxid(auxid);
+      conns[auxid]->set_multipart_streaming(multipart_streaming);
     }
     return *(conns[auxid]);
   };
@@ -328,11 +381,10 @@ public:
   const crofconn &get_conn(const cauxid &auxid) const {
     AcquireReadLock rwlock(conns_rwlock);
     if (conns.find(auxid) == conns.end()) {
-      throw eRofChanNotFound("crofchan::get_conn() auxid not found")
-          .set_func(__FUNCTION__)
-          .set_file(__FILE__)
-          .set_line(__LINE__)
-          .set_key("auxid", auxid.get_id());
+      eRofChanNotFound e("crofchan::get_conn() auxid not found", __FILE__,
+                         __FUNCTION__, __LINE__);
+      e.set_key("auxid", auxid.get_id());
+      throw e;
     }
     return *(conns.at(auxid));
   };
@@ -479,6 +531,12 @@ public:
   };
 
 private:
+  /**
+   * @brief Returns connection for auxid if it and the main connection are
+   * established, nullptr otherwise. Caller must hold conns_rwlock.
+   */
+  crofconn *find_established_conn(const cauxid &auxid) const;
+
   virtual void handle_established(crofconn &conn, uint8_t ofp_version) {
     if (delete_in_progress())
       return;
@@ -680,6 +738,9 @@ private:
   // OFP version negotiated
   std::atomic_uint_fast8_t ofp_version;
 
+  // bitmask of multipart reply types streamed, see crofconn
+  std::atomic_uint_fast32_t multipart_streaming;
+
   // connections scheduled for deletion
   std::set<crofconn *> conns_deletion;
 
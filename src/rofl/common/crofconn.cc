@@ -29,16 +29,19 @@ using namespace rofl;
 crofconn::~crofconn() {
   flag_set(FLAG_DELETE_IN_PROGRESS, true);
   /* stop worker thread */
+  cthread::pool_drop_job(this);
   cthread::thread(thread_num).drop(this);
 }
 
 crofconn::crofconn(crofconn_env *env)
-    : env(env), thread_num(cthread::get_hnd_thread_num_from_pool()),
-      rofsock(this), dpid(0), auxid(0),
+    : cthread_job(/*stealable=*/true), env(env),
+      thread_num(cthread::get_hnd_thread_num_from_pool()), rofsock(this),
+      dpid(0), auxid(0),
       ofp_version(rofl::openflow::OFP_VERSION_UNKNOWN), mode(MODE_UNKNOWN),
       state(STATE_DISCONNECTED), flag_hello_sent(false), flag_hello_rcvd(false),
-      rxweights(QUEUE_MAX), rxqueues(QUEUE_MAX), rx_thread_working(false),
-      rx_thread_scheduled(false), rxqueue_max_size(RXQUEUE_MAX_SIZE_DEFAULT),
+      rxsched(QUEUE_MAX), rxqueues(QUEUE_MAX), rx_thread_working(false),
+      rx_thread_scheduled(false), handler_busy(false), rx_deferred(false),
+      timers_deferred(0), rxqueue_max_size(RXQUEUE_MAX_SIZE_DEFAULT),
       segmentation_threshold(DEFAULT_SEGMENTATION_THRESHOLD),
       timeout_hello(DEFAULT_HELLO_TIMEOUT),
       timeout_features(DEFAULT_FEATURES_TIMEOUT),
@@ -48,12 +51,13 @@ crofconn::crofconn(crofconn_env *env)
       xid_features_request_last(random.uint32()),
       xid_echo_request_last(random.uint32()),
       timeout_segments(DEFAULT_SEGMENTS_TIMEOUT),
-      pending_segments_max(DEFAULT_PENDING_SEGMENTS_MAX) {
-  /* scheduler weights for transmission */
-  rxweights[QUEUE_OAM] = 16;
-  rxweights[QUEUE_MGMT] = 32;
-  rxweights[QUEUE_FLOW] = 16;
-  rxweights[QUEUE_PKT] = 8;
+      pending_segments_max(DEFAULT_PENDING_SEGMENTS_MAX),
+      multipart_streaming(0) {
+  /* scheduler quanta for reception in bytes */
+  rxsched.set_strict_priority(QUEUE_OAM);
+  rxsched.set_quantum(QUEUE_MGMT, 16384);
+  rxsched.set_quantum(QUEUE_FLOW, 8192);
+  rxsched.set_quantum(QUEUE_PKT, 4096);
   /* set maximum queue size */
   for (unsigned int queue_id = 0; queue_id < QUEUE_MAX; queue_id++) {
     rxqueues[queue_id].set_queue_max_size(rxqueue_max_size);
@@ -101,9 +105,59 @@ void crofconn::tls_connect(
   rofsock.tls_connect(reconnect);
 };
 
+void crofconn::replay_accept(
+    const rofl::openflow::cofhello_elem_versionbitmap &versionbitmap,
+    enum crofconn_mode_t mode) {
+  set_versionbitmap(versionbitmap);
+  set_mode(mode);
+  run_finite_state_machine(STATE_ACCEPT_PENDING);
+  rofsock.replay_accept();
+};
+
 void crofconn::handle_timeout(cthread &thread, uint32_t timer_id) {
   if (flag_test(FLAG_DELETE_IN_PROGRESS))
     return;
+  /* a stolen RX job is running, it hands the timer back when leaving */
+  timers_deferred |= (1U << timer_id);
+  if (not handler_enter())
+    return;
+  run_deferred_timers();
+  handler_leave();
+}
+
+bool crofconn::handler_enter() {
+  bool busy = false;
+  return handler_busy.compare_exchange_strong(busy, true);
+}
+
+void crofconn::handler_leave() {
+  handler_busy = false;
+  /* work deferred meanwhile goes back to its thread */
+  if (rx_deferred.exchange(false)) {
+    cthread::thread(thread_num).schedule_job(this);
+  }
+  if (timers_deferred.load()) {
+    cthread::thread(thread_num).wakeup(this);
+  }
+}
+
+void crofconn::run_deferred_timers() {
+  uint32_t timers = 0;
+  while ((timers = timers_deferred.exchange(0)) != 0) {
+    for (uint32_t timer_id = 0; timers != 0; timer_id++, timers >>= 1) {
+      if (timers & 1) {
+        try {
+          dispatch_timeout(timer_id);
+        } catch (...) {
+          handler_leave();
+          throw;
+        }
+      }
+    }
+  }
+}
+
+void crofconn::dispatch_timeout(uint32_t timer_id) {
   switch (timer_id) {
   case TIMER_ID_NEED_LIFE_CHECK: {
     send_echo_request();
@@ -167,7 +221,7 @@ void crofconn::run_finite_state_machine(enum crofconn_state_t new_state) {
         /* stop periodic checks for connection state (OAM) */
         // cthread::thread(thread_num).drop_timer(this,
         // TIMER_ID_NEED_LIFE_CHECK);
-        cthread::thread(thread_num).drop_timers(this);
+        drop_timers();
 
         clear_pending_requests();
         clear_pending_segments();
@@ -186,7 +240,7 @@ void crofconn::run_finite_state_machine(enum crofconn_state_t new_state) {
         versionbitmap_peer.clear();
         set_version(rofl::openflow::OFP_VERSION_UNKNOWN);
 
-        for (auto rxqueue : rxqueues) {
+        for (auto &rxqueue : rxqueues) {
           rxqueue.clear();
         }
 
@@ -208,7 +262,7 @@ void crofconn::run_finite_state_machine(enum crofconn_state_t new_state) {
         versionbitmap_peer.clear();
         set_version(rofl::openflow::OFP_VERSION_UNKNOWN);
 
-        for (auto rxqueue : rxqueues) {
+        for (auto &rxqueue : rxqueues) {
           rxqueue.clear();
         }
 
@@ -229,9 +283,8 @@ void crofconn::run_finite_state_machine(enum crofconn_state_t new_state) {
                 << " laddr=" << rofsock.get_laddr().str()
                 << " raddr=" << rofsock.get_raddr().str();
         if (not flag_hello_rcvd) {
-          cthread::thread(thread_num)
-              .add_timer(this, TIMER_ID_WAIT_FOR_HELLO,
-                         ctimespec().expire_in(timeout_hello));
+          add_timer(TIMER_ID_WAIT_FOR_HELLO,
+                    ctimespec().expire_in(timeout_hello));
         }
         if (not flag_hello_sent) {
           send_hello_message();
@@ -243,7 +296,7 @@ void crofconn::run_finite_state_machine(enum crofconn_state_t new_state) {
                 << versionbitmap_peer.str()
                 << " laddr=" << rofsock.get_laddr().str()
                 << " raddr=" << rofsock.get_raddr().str();
-        cthread::thread(thread_num).drop_timer(this, TIMER_ID_WAIT_FOR_HELLO);
+        drop_timer(TIMER_ID_WAIT_FOR_HELLO);
         send_features_request();
 
       } break;
@@ -252,11 +305,10 @@ void crofconn::run_finite_state_machine(enum crofconn_state_t new_state) {
                 << static_cast<unsigned>(ofp_version.load())
                 << " laddr=" << rofsock.get_laddr().str()
                 << " raddr=" << rofsock.get_raddr().str();
-        cthread::thread(thread_num).drop_timer(this, TIMER_ID_WAIT_FOR_HELLO);
+        drop_timer(TIMER_ID_WAIT_FOR_HELLO);
         /* start periodic checks for connection state (OAM) */
-        cthread::thread(thread_num)
-            .add_timer(this, TIMER_ID_NEED_LIFE_CHECK,
-                       ctimespec().expire_in(timeout_lifecheck));
+        add_timer(TIMER_ID_NEED_LIFE_CHECK,
+                  ctimespec().expire_in(timeout_lifecheck));
         calls.push_back(STATE_ESTABLISHED);
 
       } break;
@@ -315,7 +367,7 @@ void crofconn::error_rcvd(rofl::openflow::cofmsg *pmsg) {
     return;
   }
 
-  cthread::thread(thread_num).drop_timer(this, TIMER_ID_WAIT_FOR_HELLO);
+  drop_timer(TIMER_ID_WAIT_FOR_HELLO);
 
   try {
 
@@ -428,7 +480,7 @@ void crofconn::hello_rcvd(rofl::openflow::cofmsg *pmsg) {
 
   flag_hello_rcvd = true;
 
-  cthread::thread(thread_num).drop_timer(this, TIMER_ID_WAIT_FOR_HELLO);
+  drop_timer(TIMER_ID_WAIT_FOR_HELLO);
 
   try {
 
@@ -604,9 +656,8 @@ void crofconn::hello_expired() {
 
 void crofconn::send_features_request() {
   try {
-    cthread::thread(thread_num)
-        .add_timer(this, TIMER_ID_WAIT_FOR_FEATURES,
-                   ctimespec().expire_in(timeout_features));
+    add_timer(TIMER_ID_WAIT_FOR_FEATURES,
+              ctimespec().expire_in(timeout_features));
 
     rofl::openflow::cofmsg_features_request *msg =
         new rofl::openflow::cofmsg_features_request(
@@ -637,7 +688,7 @@ void crofconn::features_reply_rcvd(rofl::openflow::cofmsg *pmsg) {
     return;
   }
 
-  cthread::thread(thread_num).drop_timer(this, TIMER_ID_WAIT_FOR_FEATURES);
+  drop_timer(TIMER_ID_WAIT_FOR_FEATURES);
 
   try {
     set_dpid(msg->get_dpid());
@@ -674,15 +725,12 @@ void crofconn::send_echo_request() {
               << " need life check while socket is congested, skipping check: "
               << " laddr=" << rofsock.get_laddr().str()
               << " raddr=" << rofsock.get_raddr().str();
-      cthread::thread(thread_num)
-          .add_timer(this, TIMER_ID_NEED_LIFE_CHECK,
-                     ctimespec().expire_in(timeout_lifecheck));
+      add_timer(TIMER_ID_NEED_LIFE_CHECK,
+                ctimespec().expire_in(timeout_lifecheck));
       return;
     }
 
-    cthread::thread(thread_num)
-        .add_timer(this, TIMER_ID_WAIT_FOR_ECHO,
-                   ctimespec().expire_in(timeout_echo));
+    add_timer(TIMER_ID_WAIT_FOR_ECHO, ctimespec().expire_in(timeout_echo));
 
     rofl::openflow::cofmsg_echo_request *msg =
         new rofl::openflow::cofmsg_echo_request(ofp_version,
@@ -707,14 +755,13 @@ void crofconn::echo_reply_rcvd(rofl::openflow::cofmsg *pmsg) {
 
   assert(nullptr != msg);
 
-  cthread::thread(thread_num).drop_timer(this, TIMER_ID_WAIT_FOR_ECHO);
+  drop_timer(TIMER_ID_WAIT_FOR_ECHO);
 
   try {
     delete msg;
 
-    cthread::thread(thread_num)
-        .add_timer(this, TIMER_ID_NEED_LIFE_CHECK,
-                   ctimespec().expire_in(timeout_lifecheck));
+    add_timer(TIMER_ID_NEED_LIFE_CHECK,
+              ctimespec().expire_in(timeout_lifecheck));
 
   } catch (std::runtime_error &e) {
     VLOG(5) << __FUNCTION__ << " runtime error: " << e.what()
@@ -1063,8 +1110,11 @@ void crofconn::handle_recv(crofsock &socket, rofl::openflow::cofmsg *msg) {
 
   try {
 
-    /* check pending xids */
-    if (has_pending_request(msg->get_xid())) {
+    /* check pending xids, the request of a streamed multipart reply
+     * stays pending until its final segment */
+    if (is_streamed_segment(msg)) {
+      refresh_pending_request(msg->get_xid());
+    } else {
       drop_pending_request(msg->get_xid());
     }
 
@@ -1263,15 +1313,48 @@ void crofconn::handle_recv(crofsock &socket, rofl::openflow::cofmsg *msg) {
 
   /* wakeup working thread in state ESTABLISHED; otherwise keep sleeping
    * and enqueue message until state ESTABLISHED is reached */
-  if ((STATE_ESTABLISHED == get_state()) && (not rx_thread_working)) {
-    cthread::thread(thread_num).wakeup(this);
+  if (STATE_ESTABLISHED == get_state()) {
+    schedule_rx_messages();
+  }
+}
+
+void crofconn::schedule_rx_messages() {
+  switch (cthread::get_hnd_scheduler()) {
+  case cthread::HND_SCHEDULER_WORK_STEALING: {
+    /* idle handler threads may pick up this connection's rxqueues */
+    cthread::thread(thread_num).schedule_job(this);
+  } break;
+  default: {
+    if (not rx_thread_working) {
+      cthread::thread(thread_num).wakeup(this);
+    }
+  };
   }
 }
 
 void crofconn::handle_wakeup(cthread &thread) {
   if (flag_test(FLAG_DELETE_IN_PROGRESS))
     return;
+  if (not handler_enter())
+    return;
+  run_deferred_timers();
+  /* with work stealing, rxqueues are drained by handle_job() only */
+  if (cthread::get_hnd_scheduler() != cthread::HND_SCHEDULER_WORK_STEALING) {
+    handle_rx_messages();
+  }
+  handler_leave();
+}
+
+void crofconn::handle_job(cthread &thread) {
+  if (flag_test(FLAG_DELETE_IN_PROGRESS))
+    return;
+  /* a timer handler is running on the home thread, it reschedules us */
+  rx_deferred = true;
+  if (not handler_enter())
+    return;
+  rx_deferred = false;
   handle_rx_messages();
+  handler_leave();
 }
 
 void crofconn::handle_rx_messages() {
@@ -1279,68 +1362,75 @@ void crofconn::handle_rx_messages() {
   rx_thread_working = true;
   rx_thread_scheduled = false;
 
-  cthread::thread(thread_num).drop_timer(this, TIMER_ID_NEED_LIFE_CHECK);
+  drop_timer(TIMER_ID_NEED_LIFE_CHECK);
 
   unsigned int keep_running = 1;
 
   do {
     try {
-      /* iterate over all rxqueues */
-      for (unsigned int queue_id = 0; queue_id < QUEUE_MAX; ++queue_id) {
+      /* deficit round robin over all rxqueues, handle not more than a
+       * single round of bytes per pass */
+      size_t budget = rxsched.get_round_bytes();
+      while (budget > 0) {
 
         if (STATE_ESTABLISHED != get_state()) {
           rx_thread_working = false;
           return;
         }
 
-        if (rxqueues[queue_id].empty()) {
-          continue; // no messages at all in this queue
+        size_t msglen = 0;
+        unsigned int queue_id = rxsched.select([&](unsigned int queue_id) {
+          return (msglen = rxqueues[queue_id].front_length());
+        });
+        if (queue_id >= QUEUE_MAX) {
+          break; // no messages at all in rxqueues
         }
 
-        /* get not more than rxweights[queue_id] messages from rxqueue[queue_id]
-         */
-        for (unsigned int num = 0; num < rxweights[queue_id]; ++num) {
-
-          rofl::openflow::cofmsg *msg = (rofl::openflow::cofmsg *)0;
-
-          if (STATE_ESTABLISHED != get_state()) {
-            rx_thread_working = false;
-            return;
-          }
-
-          if ((msg = rxqueues[queue_id].retrieve()) == NULL) {
-            break; // no further messages in this queue
-          }
-
-          /* segmentation and reassembly */
-          switch (ofp_version.load()) {
-          case rofl::openflow10::OFP_VERSION:
-          case rofl::openflow12::OFP_VERSION: {
+        /* the queue may have been cleared meanwhile */
+        rofl::openflow::cofmsg *msg = rxqueues[queue_id].retrieve();
+        if (msg == nullptr) {
+          continue;
+        }
+        msglen = msg->length();
+        rxsched.dequeued(queue_id, msglen, rxqueues[queue_id].get_stored_ns());
+        budget -= std::min(msglen, budget);
+
+        /* segmentation and reassembly */
+        switch (ofp_version.load()) {
+        case rofl::openflow10::OFP_VERSION:
+        case rofl::openflow12::OFP_VERSION: {
+          VLOG(5) << __FUNCTION__
+                  << " call application: " << msg->str().c_str();
+          // no segmentation and reassembly below OFP1.3, so hand over message
+          // directly to higher layers
+          crofconn_env::call_env(env).handle_recv(*this, msg);
+        } break;
+        default: {
+          switch (msg->get_type()) {
+          case rofl::openflow13::OFPT_MULTIPART_REQUEST:
+          case rofl::openflow13::OFPT_MULTIPART_REPLY: {
+            handle_rx_multipart_message(msg);
+          } break;
+          default: {
             VLOG(5) << __FUNCTION__
                     << " call application: " << msg->str().c_str();
-            // no segmentation and reassembly below OFP1.3, so hand over message
-            // directly to higher layers
             crofconn_env::call_env(env).handle_recv(*this, msg);
-          } break;
-          default: {
-            switch (msg->get_type()) {
-            case rofl::openflow13::OFPT_MULTIPART_REQUEST:
-            case rofl::openflow13::OFPT_MULTIPART_REPLY: {
-              handle_rx_multipart_message(msg);
-            } break;
-            default: {
-              VLOG(5) << __FUNCTION__
-                      << " call application: " << msg->str().c_str();
-              crofconn_env::call_env(env).handle_recv(*this, msg);
-            };
-            }
           };
           }
+        };
         }
+      }
 
-        /* reschedule this method */
+      /* reschedule this method */
+      for (unsigned int queue_id = 0; queue_id < QUEUE_MAX; ++queue_id) {
         if (not rxqueues[queue_id].empty()) {
-          cthread::thread(thread_num).wakeup(this);
+          if (cthread::get_hnd_scheduler() ==
+              cthread::HND_SCHEDULER_WORK_STEALING) {
+            cthread::thread(thread_num).schedule_job(this);
+          } else {
+            cthread::thread(thread_num).wakeup(this);
+          }
+          break;
         }
       }
 
@@ -1364,9 +1454,8 @@ void crofconn::handle_rx_messages() {
 
   rx_thread_working = false;
 
-  cthread::thread(thread_num)
-      .add_timer(this, TIMER_ID_NEED_LIFE_CHECK,
-                 ctimespec().expire_in(timeout_lifecheck));
+  add_timer(TIMER_ID_NEED_LIFE_CHECK,
+            ctimespec().expire_in(timeout_lifecheck));
 
   /* reenable reception of messages on socket */
   if (rofsock.is_rx_disabled()) {
@@ -1439,6 +1528,15 @@ void crofconn::handle_rx_multipart_message(rofl::openflow::cofmsg *msg) {
       return;
     }
 
+    // streaming: hand over each segment, unless a reassembly is in progress
+    if ((stats->get_stats_type() < 32) &&
+        (multipart_streaming & (1U << stats->get_stats_type())) &&
+        not has_pending_segment(msg->get_xid())) {
+      VLOG(5) << __FUNCTION__ << " call application: " << msg->str().c_str();
+      crofconn_env::call_env(env).handle_recv(*this, msg);
+      return;
+    }
+
     // start new or continue pending transaction
     if (stats->get_stats_flags() & rofl::openflow13::OFPMPF_REQ_MORE) {
 
@@ -1476,53 +1574,95 @@ void crofconn::handle_rx_multipart_message(rofl::openflow::cofmsg *msg) {
   }
 }
 
+bool crofconn::is_streamed_segment(rofl::openflow::cofmsg *msg) const {
+  if ((0 == multipart_streaming) ||
+      (msg->get_version() < rofl::openflow13::OFP_VERSION) ||
+      (msg->get_type() != rofl::openflow13::OFPT_MULTIPART_REPLY)) {
+    return false;
+  }
+  rofl::openflow::cofmsg_stats_reply *stats =
+      dynamic_cast<rofl::openflow::cofmsg_stats_reply *>(msg);
+  return (NULL != stats) && (stats->get_stats_type() < 32) &&
+         (multipart_streaming & (1U << stats->get_stats_type())) &&
+         (stats->get_stats_flags() & rofl::openflow13::OFPMPF_REPLY_MORE);
+}
+
 rofl::crofsock::msg_result_t crofconn::send_message(rofl::openflow::cofmsg *msg,
                                                     const ctimespec &ts) {
 
-  switch (msg->get_version()) {
-  case rofl::openflow10::OFP_VERSION: {
+  /* msg is consumed by segment_and_send_message() */
+  uint32_t xid = msg->get_xid();
 
-    switch (msg->get_type()) {
-    case rofl::openflow10::OFPT_STATS_REQUEST: {
-      add_pending_request(
-          msg->get_xid(), ts, msg->get_type(),
-          dynamic_cast<rofl::openflow::cofmsg_stats_request *>(msg)
-              ->get_stats_type());
-    } break;
-    default: { add_pending_request(msg->get_xid(), ts, msg->get_type()); };
+  /* a flow-mod batch is tracked by its trailing Barrier-Request */
+  rofl::openflow::cofmsg_flow_mod_batch *batch =
+      rofl::openflow::flow_mod_batch_cast(msg);
+  if (batch != nullptr) {
+    if (not batch->has_barrier_request()) {
+      return segment_and_send_message(msg);
     }
+    xid = batch->get_barrier_xid();
+    add_pending_request(xid, ts,
+                        (msg->get_version() == rofl::openflow10::OFP_VERSION)
+                            ? (uint8_t)rofl::openflow10::OFPT_BARRIER_REQUEST
+                            : (uint8_t)rofl::openflow12::OFPT_BARRIER_REQUEST);
+  } else {
+    switch (msg->get_version()) {
+    case rofl::openflow10::OFP_VERSION: {
+
+      switch (msg->get_type()) {
+      case rofl::openflow10::OFPT_STATS_REQUEST: {
+        add_pending_request(
+            msg->get_xid(), ts, msg->get_type(),
+            dynamic_cast<rofl::openflow::cofmsg_stats_request *>(msg)
+                ->get_stats_type());
+      } break;
+      default: { add_pending_request(msg->get_xid(), ts, msg->get_type()); };
+      }
 
-  } break;
-  case rofl::openflow12::OFP_VERSION: {
-
-    switch (msg->get_type()) {
-    case rofl::openflow12::OFPT_STATS_REQUEST: {
-      add_pending_request(
-          msg->get_xid(), ts, msg->get_type(),
-          dynamic_cast<rofl::openflow::cofmsg_stats_request *>(msg)
-              ->get_stats_type());
     } break;
-    default: { add_pending_request(msg->get_xid(), ts, msg->get_type()); };
-    }
+    case rofl::openflow12::OFP_VERSION: {
+
+      switch (msg->get_type()) {
+      case rofl::openflow12::OFPT_STATS_REQUEST: {
+        add_pending_request(
+            msg->get_xid(), ts, msg->get_type(),
+            dynamic_cast<rofl::openflow::cofmsg_stats_request *>(msg)
+                ->get_stats_type());
+      } break;
+      default: { add_pending_request(msg->get_xid(), ts, msg->get_type()); };
+      }
 
-  } break;
-  case rofl::openflow13::OFP_VERSION: {
-
-    switch (msg->get_type()) {
-    case rofl::openflow13::OFPT_MULTIPART_REQUEST: {
-      add_pending_request(
-          msg->get_xid(), ts, msg->get_type(),
-          dynamic_cast<rofl::openflow::cofmsg_stats_request *>(msg)
-              ->get_stats_type());
     } break;
-    default: { add_pending_request(msg->get_xid(), ts, msg->get_type()); };
+    case rofl::openflow13::OFP_VERSION: {
+
+      switch (msg->get_type()) {
+      case rofl::openflow13::OFPT_MULTIPART_REQUEST: {
+        add_pending_request(
+            msg->get_xid(), ts, msg->get_type(),
+            dynamic_cast<rofl::openflow::cofmsg_stats_request *>(msg)
+                ->get_stats_type());
+      } break;
+      default: { add_pending_request(msg->get_xid(), ts, msg->get_type()); };
+      }
+
+    } break;
+    default: {};
     }
+  }
+
+  rofl::crofsock::msg_result_t msg_result = segment_and_send_message(msg);
 
+  /* requests never sent must not linger until they expire */
+  switch (msg_result) {
+  case rofl::crofsock::MSG_QUEUEING_FAILED_QUEUE_FULL:
+  case rofl::crofsock::MSG_QUEUEING_FAILED_NOT_ESTABLISHED:
+  case rofl::crofsock::MSG_QUEUEING_FAILED_SHUTDOWN_IN_PROGRESS: {
+    drop_pending_request(xid);
   } break;
   default: {};
   }
 
-  return segment_and_send_message(msg);
+  return msg_result;
 };
 
 rofl::crofsock::msg_result_t
@@ -1532,7 +1672,8 @@ crofconn::segment_and_send_message(rofl::openflow::cofmsg *msg) {
   VLOG(5) << __FUNCTION__ << " state: " << state
           << " message sent: " << msg->str().c_str();
 
-  if (msg->length() <= segmentation_threshold) {
+  if ((msg->length() <= segmentation_threshold) ||
+      (rofl::openflow::flow_mod_batch_cast(msg) != nullptr)) {
     msg_result = rofsock.send_message(
         msg); // default behaviour for now: send message directly to rofsock
 
@@ -1655,473 +1796,244 @@ crofconn::segment_and_send_message(rofl::openflow::cofmsg *msg) {
 
 rofl::crofsock::msg_result_t crofconn::segment_table_features_stats_request(
     rofl::openflow::cofmsg_table_features_stats_request *msg) {
-  std::list<rofl::openflow::cofmsg_table_features_stats_request *> segments;
-  const int MAX_LENGTH = 64000 /*bytes*/;
-  auto tableids = msg->get_tables().keys();
-  rofl::crofsock::msg_result_t msg_result = rofl::crofsock::MSG_QUEUED;
-
-  /* create fragments */
-  while (not tableids.empty()) {
-    rofl::openflow::coftables array(msg->get_version());
-
-    while ((not tableids.empty()) && (array.length() < MAX_LENGTH)) {
-      uint8_t tableid = tableids.front();
-      tableids.pop_front();
-      array.add_table(tableid) = msg->get_tables().get_table(tableid);
-    }
-
-    segments.push_back(new rofl::openflow::cofmsg_table_features_stats_request(
-        msg->get_version(), msg->get_xid(), msg->get_stats_flags(), array));
+  rofl::openflow::cofmsg_stats_segmenter<
+      rofl::openflow::cofmsg_stats_request_segment,
+      rofl::openflow::coftable_features>
+      segmenter(msg->get_version(), msg->get_xid(), msg->get_stats_type(),
+                msg->get_stats_flags());
+
+  /* serialise entries into segments */
+  auto &array = msg->set_tables();
+  for (auto tableid : array.keys()) {
+    segmenter.add(array.set_table(tableid));
   }
 
+  auto segments = segmenter.get_segments(rofl::openflow13::OFPMPF_REQ_MORE);
+
   /* delete original message */
   delete msg;
 
-  /* send fragments */
-  while (not segments.empty()) {
-    rofl::openflow::cofmsg_table_features_stats_request *msg = segments.front();
-    segments.pop_front();
-    // set MORE flag on all segments except last one
-    if (not segments.empty()) {
-      msg->set_stats_flags(msg->get_stats_flags() |
-                           rofl::openflow13::OFPMPF_REQ_MORE);
-    }
-    /* when enforcing queueing, there are only two return values possible:
-     * MSQ_QUEUED and MSG_QUEUED_CONGESTION. We return the result received for
-     * the last fragment. */
-    msg_result = rofsock.send_message(msg, /*enforce-queueing*/ true);
-  }
-
-  return msg_result;
+  return send_segments(segments);
 }
 
 rofl::crofsock::msg_result_t crofconn::segment_table_features_stats_reply(
     rofl::openflow::cofmsg_table_features_stats_reply *msg) {
-  std::list<rofl::openflow::cofmsg_table_features_stats_reply *> segments;
-  const int MAX_LENGTH = 64000 /*bytes*/;
-  auto tableids = msg->get_tables().keys();
-  rofl::crofsock::msg_result_t msg_result = rofl::crofsock::MSG_QUEUED;
-
-  /* create fragments */
-  while (not tableids.empty()) {
-    rofl::openflow::coftables array(msg->get_version());
-
-    while ((not tableids.empty()) && (array.length() < MAX_LENGTH)) {
-      uint8_t tableid = tableids.front();
-      tableids.pop_front();
-      array.add_table(tableid) = msg->get_tables().get_table(tableid);
-    }
-
-    segments.push_back(new rofl::openflow::cofmsg_table_features_stats_reply(
-        msg->get_version(), msg->get_xid(), msg->get_stats_flags(), array));
+  rofl::openflow::cofmsg_stats_segmenter<
+      rofl::openflow::cofmsg_stats_reply_segment,
+      rofl::openflow::coftable_features>
+      segmenter(msg->get_version(), msg->get_xid(), msg->get_stats_type(),
+                msg->get_stats_flags());
+
+  /* serialise entries into segments */
+  auto &array = msg->set_tables();
+  for (auto tableid : array.keys()) {
+    segmenter.add(array.set_table(tableid));
   }
 
+  auto segments = segmenter.get_segments(rofl::openflow13::OFPMPF_REPLY_MORE);
+
   /* delete original message */
   delete msg;
 
-  /* send fragments */
-  while (not segments.empty()) {
-    rofl::openflow::cofmsg_table_features_stats_reply *msg = segments.front();
-    segments.pop_front();
-    // set MORE flag on all segments except last one
-    if (not segments.empty()) {
-      msg->set_stats_flags(msg->get_stats_flags() |
-                           rofl::openflow13::OFPMPF_REPLY_MORE);
-    }
-    /* when enforcing queueing, there are only two return values possible:
-     * MSQ_QUEUED and MSG_QUEUED_CONGESTION. We return the result received for
-     * the last fragment. */
-    msg_result = rofsock.send_message(msg, /*enforce-queueing*/ true);
-  }
-
-  return msg_result;
+  return send_segments(segments);
 }
 
 rofl::crofsock::msg_result_t crofconn::segment_flow_stats_reply(
     rofl::openflow::cofmsg_flow_stats_reply *msg) {
-  std::list<rofl::openflow::cofmsg_flow_stats_reply *> segments;
-  const int MAX_LENGTH = 64000 /*bytes*/;
-  auto flowids = msg->get_flow_stats_array().keys();
-  rofl::crofsock::msg_result_t msg_result = rofl::crofsock::MSG_QUEUED;
-
-  /* create fragments */
-  while (not flowids.empty()) {
-    rofl::openflow::cofflowstatsarray array(msg->get_version());
-
-    while ((not flowids.empty()) && (array.length() < MAX_LENGTH)) {
-      uint32_t flowid = flowids.front();
-      flowids.pop_front();
-      array.add_flow_stats(flowid) =
-          msg->get_flow_stats_array().get_flow_stats(flowid);
-    }
-
-    segments.push_back(new rofl::openflow::cofmsg_flow_stats_reply(
-        msg->get_version(), msg->get_xid(), msg->get_stats_flags(), array));
+  rofl::openflow::cofmsg_stats_segmenter<
+      rofl::openflow::cofmsg_stats_reply_segment,
+      rofl::openflow::cofflow_stats_reply>
+      segmenter(msg->get_version(), msg->get_xid(), msg->get_stats_type(),
+                msg->get_stats_flags());
+
+  /* serialise entries into segments */
+  auto &array = msg->set_flow_stats_array();
+  for (auto flowid : array.keys()) {
+    segmenter.add(array.set_flow_stats(flowid));
   }
 
+  auto segments = segmenter.get_segments(rofl::openflow13::OFPMPF_REPLY_MORE);
+
   /* delete original message */
   delete msg;
 
-  /* send fragments */
-  while (not segments.empty()) {
-    rofl::openflow::cofmsg_flow_stats_reply *msg = segments.front();
-    segments.pop_front();
-    // set MORE flag on all segments except last one
-    if (not segments.empty()) {
-      msg->set_stats_flags(msg->get_stats_flags() |
-                           rofl::openflow13::OFPMPF_REPLY_MORE);
-    }
-    /* when enforcing queueing, there are only two return values possible:
-     * MSQ_QUEUED and MSG_QUEUED_CONGESTION. We return the result received for
-     * the last fragment. */
-    msg_result = rofsock.send_message(msg, /*enforce-queueing*/ true);
-  }
-
-  return msg_result;
+  return send_segments(segments);
 }
 
 rofl::crofsock::msg_result_t crofconn::segment_group_desc_stats_reply(
     rofl::openflow::cofmsg_group_desc_stats_reply *msg) {
-  std::list<rofl::openflow::cofmsg_group_desc_stats_reply *> segments;
-  const int MAX_LENGTH = 64000 /*bytes*/;
-  auto groupids = msg->get_group_desc_stats_array().keys();
-  rofl::crofsock::msg_result_t msg_result = rofl::crofsock::MSG_QUEUED;
-
-  /* create fragments */
-  while (not groupids.empty()) {
-    rofl::openflow::cofgroupdescstatsarray array(msg->get_version());
-
-    while ((not groupids.empty()) && (array.length() < MAX_LENGTH)) {
-      uint32_t groupid = groupids.front();
-      groupids.pop_front();
-      array.add_group_desc_stats(groupid) =
-          msg->get_group_desc_stats_array().get_group_desc_stats(groupid);
-    }
-
-    segments.push_back(new rofl::openflow::cofmsg_group_desc_stats_reply(
-        msg->get_version(), msg->get_xid(), msg->get_stats_flags(), array));
+  rofl::openflow::cofmsg_stats_segmenter<
+      rofl::openflow::cofmsg_stats_reply_segment,
+      rofl::openflow::cofgroup_desc_stats_reply>
+      segmenter(msg->get_version(), msg->get_xid(), msg->get_stats_type(),
+                msg->get_stats_flags());
+
+  /* serialise entries into segments */
+  auto &array = msg->set_group_desc_stats_array();
+  for (auto groupid : array.keys()) {
+    segmenter.add(array.set_group_desc_stats(groupid));
   }
 
+  auto segments = segmenter.get_segments(rofl::openflow13::OFPMPF_REPLY_MORE);
+
   /* delete original message */
   delete msg;
 
-  /* send fragments */
-  while (not segments.empty()) {
-    rofl::openflow::cofmsg_group_desc_stats_reply *msg = segments.front();
-    segments.pop_front();
-    // set MORE flag on all segments except last one
-    if (not segments.empty()) {
-      msg->set_stats_flags(msg->get_stats_flags() |
-                           rofl::openflow13::OFPMPF_REPLY_MORE);
-    }
-    /* when enforcing queueing, there are only two return values possible:
-     * MSQ_QUEUED and MSG_QUEUED_CONGESTION. We return the result received for
-     * the last fragment. */
-    msg_result = rofsock.send_message(msg, /*enforce-queueing*/ true);
-  }
-
-  return msg_result;
+  return send_segments(segments);
 }
 
 rofl::crofsock::msg_result_t crofconn::segment_group_stats_reply(
     rofl::openflow::cofmsg_group_stats_reply *msg) {
-  std::list<rofl::openflow::cofmsg_group_stats_reply *> segments;
-  const int MAX_LENGTH = 64000 /*bytes*/;
-  auto groupids = msg->get_group_stats_array().keys();
-  rofl::crofsock::msg_result_t msg_result = rofl::crofsock::MSG_QUEUED;
-
-  /* create fragments */
-  while (not groupids.empty()) {
-    rofl::openflow::cofgroupstatsarray array(msg->get_version());
-
-    while ((not groupids.empty()) && (array.length() < MAX_LENGTH)) {
-      uint32_t groupid = groupids.front();
-      groupids.pop_front();
-      array.add_group_stats(groupid) =
-          msg->get_group_stats_array().get_group_stats(groupid);
-    }
-
-    segments.push_back(new rofl::openflow::cofmsg_group_stats_reply(
-        msg->get_version(), msg->get_xid(), msg->get_stats_flags(), array));
+  rofl::openflow::cofmsg_stats_segmenter<
+      rofl::openflow::cofmsg_stats_reply_segment,
+      rofl::openflow::cofgroup_stats_reply>
+      segmenter(msg->get_version(), msg->get_xid(), msg->get_stats_type(),
+                msg->get_stats_flags());
+
+  /* serialise entries into segments */
+  auto &array = msg->set_group_stats_array();
+  for (auto groupid : array.keys()) {
+    segmenter.add(array.set_group_stats(groupid));
   }
 
+  auto segments = segmenter.get_segments(rofl::openflow13::OFPMPF_REPLY_MORE);
+
   /* delete original message */
   delete msg;
 
-  /* send fragments */
-  while (not segments.empty()) {
-    rofl::openflow::cofmsg_group_stats_reply *msg = segments.front();
-    segments.pop_front();
-    // set MORE flag on all segments except last one
-    if (not segments.empty()) {
-      msg->set_stats_flags(msg->get_stats_flags() |
-                           rofl::openflow13::OFPMPF_REPLY_MORE);
-    }
-    /* when enforcing queueing, there are only two return values possible:
-     * MSQ_QUEUED and MSG_QUEUED_CONGESTION. We return the result received for
-     * the last fragment. */
-    msg_result = rofsock.send_message(msg, /*enforce-queueing*/ true);
-  }
-
-  return msg_result;
+  return send_segments(segments);
 }
 
 rofl::crofsock::msg_result_t crofconn::segment_table_stats_reply(
     rofl::openflow::cofmsg_table_stats_reply *msg) {
-  std::list<rofl::openflow::cofmsg_table_stats_reply *> segments;
-  const int MAX_LENGTH = 64000 /*bytes*/;
-  auto tableids = msg->get_table_stats_array().keys();
-  rofl::crofsock::msg_result_t msg_result = rofl::crofsock::MSG_QUEUED;
-
-  /* create fragments */
-  while (not tableids.empty()) {
-    rofl::openflow::coftablestatsarray array(msg->get_version());
-
-    while ((not tableids.empty()) && (array.length() < MAX_LENGTH)) {
-      uint32_t tableid = tableids.front();
-      tableids.pop_front();
-      array.add_table_stats(tableid) =
-          msg->get_table_stats_array().get_table_stats(tableid);
-    }
-
-    segments.push_back(new rofl::openflow::cofmsg_table_stats_reply(
-        msg->get_version(), msg->get_xid(), msg->get_stats_flags(), array));
+  rofl::openflow::cofmsg_stats_segmenter<
+      rofl::openflow::cofmsg_stats_reply_segment,
+      rofl::openflow::coftable_stats_reply>
+      segmenter(msg->get_version(), msg->get_xid(), msg->get_stats_type(),
+                msg->get_stats_flags());
+
+  /* serialise entries into segments */
+  auto &array = msg->set_table_stats_array();
+  for (auto tableid : array.keys()) {
+    segmenter.add(array.set_table_stats(tableid));
   }
 
+  auto segments = segmenter.get_segments(rofl::openflow13::OFPMPF_REPLY_MORE);
+
   /* delete original message */
   delete msg;
 
-  /* send fragments */
-  while (not segments.empty()) {
-    rofl::openflow::cofmsg_table_stats_reply *msg = segments.front();
-    segments.pop_front();
-    // set MORE flag on all segments except last one
-    if (not segments.empty()) {
-      msg->set_stats_flags(msg->get_stats_flags() |
-                           rofl::openflow13::OFPMPF_REPLY_MORE);
-    }
-    /* when enforcing queueing, there are only two return values possible:
-     * MSQ_QUEUED and MSG_QUEUED_CONGESTION. We return the result received for
-     * the last fragment. */
-    msg_result = rofsock.send_message(msg, /*enforce-queueing*/ true);
-  }
-
-  return msg_result;
+  return send_segments(segments);
 }
 
 rofl::crofsock::msg_result_t crofconn::segment_port_stats_reply(
     rofl::openflow::cofmsg_port_stats_reply *msg) {
-  std::list<rofl::openflow::cofmsg_port_stats_reply *> segments;
-  const int MAX_LENGTH = 64000 /*bytes*/;
-  auto portids = msg->get_port_stats_array().keys();
-  rofl::crofsock::msg_result_t msg_result = rofl::crofsock::MSG_QUEUED;
-
-  /* create fragments */
-  while (not portids.empty()) {
-    rofl::openflow::cofportstatsarray array(msg->get_version());
-
-    while ((not portids.empty()) && (array.length() < MAX_LENGTH)) {
-      uint32_t portid = portids.front();
-      portids.pop_front();
-      array.add_port_stats(portid) =
-          msg->get_port_stats_array().get_port_stats(portid);
-    }
-
-    segments.push_back(new rofl::openflow::cofmsg_port_stats_reply(
-        msg->get_version(), msg->get_xid(), msg->get_stats_flags(), array));
+  rofl::openflow::cofmsg_stats_segmenter<
+      rofl::openflow::cofmsg_stats_reply_segment,
+      rofl::openflow::cofport_stats_reply>
+      segmenter(msg->get_version(), msg->get_xid(), msg->get_stats_type(),
+                msg->get_stats_flags());
+
+  /* serialise entries into segments */
+  auto &array = msg->set_port_stats_array();
+  for (auto portid : array.keys()) {
+    segmenter.add(array.set_port_stats(portid));
   }
 
+  auto segments = segmenter.get_segments(rofl::openflow13::OFPMPF_REPLY_MORE);
+
   /* delete original message */
   delete msg;
 
-  /* send fragments */
-  while (not segments.empty()) {
-    rofl::openflow::cofmsg_port_stats_reply *msg = segments.front();
-    segments.pop_front();
-    // set MORE flag on all segments except last one
-    if (not segments.empty()) {
-      msg->set_stats_flags(msg->get_stats_flags() |
-                           rofl::openflow13::OFPMPF_REPLY_MORE);
-    }
-    /* when enforcing queueing, there are only two return values possible:
-     * MSQ_QUEUED and MSG_QUEUED_CONGESTION. We return the result received for
-     * the last fragment. */
-    msg_result = rofsock.send_message(msg, /*enforce-queueing*/ true);
-  }
-
-  return msg_result;
+  return send_segments(segments);
 }
 
 rofl::crofsock::msg_result_t crofconn::segment_queue_stats_reply(
     rofl::openflow::cofmsg_queue_stats_reply *msg) {
-  std::list<rofl::openflow::cofmsg_queue_stats_reply *> segments;
-  const int MAX_LENGTH = 64000 /*bytes*/;
-  auto portids = msg->get_queue_stats_array().keys();
-  rofl::crofsock::msg_result_t msg_result = rofl::crofsock::MSG_QUEUED;
-
-  /* create fragments */
-  while (not portids.empty()) {
-    rofl::openflow::cofqueuestatsarray array(msg->get_version());
-
-    while ((not portids.empty()) && (array.length() < MAX_LENGTH)) {
-      uint32_t portid = portids.front();
-      portids.pop_front();
-
-      for (auto queueid : msg->get_queue_stats_array().keys(portid)) {
-        array.add_queue_stats(portid, queueid) =
-            msg->get_queue_stats_array().get_queue_stats(portid, queueid);
-      }
+  rofl::openflow::cofmsg_stats_segmenter<
+      rofl::openflow::cofmsg_stats_reply_segment,
+      rofl::openflow::cofqueue_stats_reply>
+      segmenter(msg->get_version(), msg->get_xid(), msg->get_stats_type(),
+                msg->get_stats_flags());
+
+  /* serialise entries into segments */
+  auto &array = msg->set_queue_stats_array();
+  for (auto portid : array.keys()) {
+    for (auto queueid : array.keys(portid)) {
+      segmenter.add(array.set_queue_stats(portid, queueid));
     }
-
-    segments.push_back(new rofl::openflow::cofmsg_queue_stats_reply(
-        msg->get_version(), msg->get_xid(), msg->get_stats_flags(), array));
   }
 
+  auto segments = segmenter.get_segments(rofl::openflow13::OFPMPF_REPLY_MORE);
+
   /* delete original message */
   delete msg;
 
-  /* send fragments */
-  while (not segments.empty()) {
-    rofl::openflow::cofmsg_queue_stats_reply *msg = segments.front();
-    segments.pop_front();
-    // set MORE flag on all segments except last one
-    if (not segments.empty()) {
-      msg->set_stats_flags(msg->get_stats_flags() |
-                           rofl::openflow13::OFPMPF_REPLY_MORE);
-    }
-    /* when enforcing queueing, there are only two return values possible:
-     * MSQ_QUEUED and MSG_QUEUED_CONGESTION. We return the result received for
-     * the last fragment. */
-    msg_result = rofsock.send_message(msg, /*enforce-queueing*/ true);
-  }
-
-  return msg_result;
+  return send_segments(segments);
 }
 
 rofl::crofsock::msg_result_t crofconn::segment_port_desc_stats_reply(
     rofl::openflow::cofmsg_port_desc_stats_reply *msg) {
-  std::list<rofl::openflow::cofmsg_port_desc_stats_reply *> segments;
-  const int MAX_LENGTH = 64000 /*bytes*/;
-  auto portids = msg->get_ports().keys();
-  rofl::crofsock::msg_result_t msg_result = rofl::crofsock::MSG_QUEUED;
-
-  /* create fragments */
-  while (not portids.empty()) {
-    rofl::openflow::cofports ports(msg->get_version());
-
-    while ((not portids.empty()) && (ports.length() < MAX_LENGTH)) {
-      uint32_t portid = portids.front();
-      portids.pop_front();
-      ports.add_port(portid) = msg->get_ports().get_port(portid);
-    }
-
-    segments.push_back(new rofl::openflow::cofmsg_port_desc_stats_reply(
-        msg->get_version(), msg->get_xid(), msg->get_stats_flags(), ports));
+  rofl::openflow::cofmsg_stats_segmenter<
+      rofl::openflow::cofmsg_stats_reply_segment,
+      rofl::openflow::cofport>
+      segmenter(msg->get_version(), msg->get_xid(), msg->get_stats_type(),
+                msg->get_stats_flags());
+
+  /* serialise entries into segments */
+  auto &array = msg->set_ports();
+  for (auto portid : array.keys()) {
+    segmenter.add(array.set_port(portid));
   }
 
+  auto segments = segmenter.get_segments(rofl::openflow13::OFPMPF_REPLY_MORE);
+
   /* delete original message */
   delete msg;
 
-  /* send fragments */
-  while (not segments.empty()) {
-    rofl::openflow::cofmsg_port_desc_stats_reply *msg = segments.front();
-    segments.pop_front();
-    // set MORE flag on all segments except last one
-    if (not segments.empty()) {
-      msg->set_stats_flags(msg->get_stats_flags() |
-                           rofl::openflow13::OFPMPF_REPLY_MORE);
-    }
-    /* when enforcing queueing, there are only two return values possible:
-     * MSQ_QUEUED and MSG_QUEUED_CONGESTION. We return the result received for
-     * the last fragment. */
-    msg_result = rofsock.send_message(msg, /*enforce-queueing*/ true);
-  }
-
-  return msg_result;
+  return send_segments(segments);
 }
 
 rofl::crofsock::msg_result_t crofconn::segment_meter_stats_reply(
     rofl::openflow::cofmsg_meter_stats_reply *msg) {
-  std::list<rofl::openflow::cofmsg_meter_stats_reply *> segments;
-  const int MAX_LENGTH = 64000 /*bytes*/;
-  auto meterids = msg->get_meter_stats_array().keys();
-  rofl::crofsock::msg_result_t msg_result = rofl::crofsock::MSG_QUEUED;
-
-  /* create fragments */
-  while (not meterids.empty()) {
-    rofl::openflow::cofmeterstatsarray array(msg->get_version());
-
-    while ((not meterids.empty()) && (array.length() < MAX_LENGTH)) {
-      uint32_t meterid = meterids.front();
-      meterids.pop_front();
-      array.add_meter_stats(meterid) =
-          msg->get_meter_stats_array().get_meter_stats(meterid);
-    }
-
-    segments.push_back(new rofl::openflow::cofmsg_meter_stats_reply(
-        msg->get_version(), msg->get_xid(), msg->get_stats_flags(), array));
+  rofl::openflow::cofmsg_stats_segmenter<
+      rofl::openflow::cofmsg_stats_reply_segment,
+      rofl::openflow::cofmeter_stats_reply>
+      segmenter(msg->get_version(), msg->get_xid(), msg->get_stats_type(),
+                msg->get_stats_flags());
+
+  /* serialise entries into segments */
+  auto &array = msg->set_meter_stats_array();
+  for (auto meterid : array.keys()) {
+    segmenter.add(array.set_meter_stats(meterid));
   }
 
+  auto segments = segmenter.get_segments(rofl::openflow13::OFPMPF_REPLY_MORE);
+
   /* delete original message */
   delete msg;
 
-  /* send fragments */
-  while (not segments.empty()) {
-    rofl::openflow::cofmsg_meter_stats_reply *msg = segments.front();
-    segments.pop_front();
-    // set MORE flag on all segments except last one
-    if (not segments.empty()) {
-      msg->set_stats_flags(msg->get_stats_flags() |
-                           rofl::openflow13::OFPMPF_REPLY_MORE);
-    }
-    /* when enforcing queueing, there are only two return values possible:
-     * MSQ_QUEUED and MSG_QUEUED_CONGESTION. We return the result received for
-     * the last fragment. */
-    msg_result = rofsock.send_message(msg, /*enforce-queueing*/ true);
-  }
-
-  return msg_result;
+  return send_segments(segments);
 }
 
 rofl::crofsock::msg_result_t crofconn::segment_meter_config_stats_reply(
     rofl::openflow::cofmsg_meter_config_stats_reply *msg) {
-  std::list<rofl::openflow::cofmsg_meter_config_stats_reply *> segments;
-  const int MAX_LENGTH = 64000 /*bytes*/;
-  auto meterids = msg->get_meter_config_array().keys();
-  rofl::crofsock::msg_result_t msg_result = rofl::crofsock::MSG_QUEUED;
-
-  /* create fragments */
-  while (not meterids.empty()) {
-    rofl::openflow::cofmeterconfigarray array(msg->get_version());
-
-    while ((not meterids.empty()) && (array.length() < MAX_LENGTH)) {
-      uint32_t meterid = meterids.front();
-      meterids.pop_front();
-      array.add_meter_config(meterid) =
-          msg->get_meter_config_array().get_meter_config(meterid);
-    }
-
-    segments.push_back(new rofl::openflow::cofmsg_meter_config_stats_reply(
-        msg->get_version(), msg->get_xid(), msg->get_stats_flags(), array));
+  rofl::openflow::cofmsg_stats_segmenter<
+      rofl::openflow::cofmsg_stats_reply_segment,
+      rofl::openflow::cofmeter_config_reply>
+      segmenter(msg->get_version(), msg->get_xid(), msg->get_stats_type(),
+                msg->get_stats_flags());
+
+  /* serialise entries into segments */
+  auto &array = msg->set_meter_config_array();
+  for (auto meterid : array.keys()) {
+    segmenter.add(array.set_meter_config(meterid));
   }
 
+  auto segments = segmenter.get_segments(rofl::openflow13::OFPMPF_REPLY_MORE);
+
   /* delete original message */
   delete msg;
 
-  /* send fragments */
-  while (not segments.empty()) {
-    rofl::openflow::cofmsg_meter_config_stats_reply *msg = segments.front();
-    segments.pop_front();
-    // set MORE flag on all segments except last one
-    if (not segments.empty()) {
-      msg->set_stats_flags(msg->get_stats_flags() |
-                           rofl::openflow13::OFPMPF_REPLY_MORE);
-    }
-    /* when enforcing queueing, there are only two return values possible:
-     * MSQ_QUEUED and MSG_QUEUED_CONGESTION. We return the result received for
-     * the last fragment. */
-    msg_result = rofsock.send_message(msg, /*enforce-queueing*/ true);
-  }
-
-  return msg_result;
+  return send_segments(segments);
 }
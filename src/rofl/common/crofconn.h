@@ -16,39 +16,59 @@
 #include <atomic>
 #include <bitset>
 #include <inttypes.h>
+#include <map>
 #include <set>
+#include <unordered_map>
 
 #include "rofl/common/cauxid.h"
 #include "rofl/common/crandom.h"
 #include "rofl/common/crofqueue.h"
+#include "rofl/common/crofsched.h"
 #include "rofl/common/crofsock.h"
 #include "rofl/common/csegment.hpp"
 #include "rofl/common/cthread.hpp"
 #include "rofl/common/exception.hpp"
 #include "rofl/common/openflow/cofhelloelems.h"
 #include "rofl/common/openflow/cofhelloelemversionbitmap.h"
+#include "rofl/common/openflow/messages/cofmsg_stats_segment.h"
 
 namespace rofl {
 
 class eRofConnBase : public exception {
 public:
-  eRofConnBase(const std::string &__arg) : exception(__arg){};
+  eRofConnBase(const std::string &__arg,
+               const std::string &__file = std::string(""),
+               const std::string &__func = std::string(""), int __line = 0)
+      : exception(__arg, __file, __func, __line){};
 };
 class eRofConnBusy : public eRofConnBase {
 public:
-  eRofConnBusy(const std::string &__arg) : eRofConnBase(__arg){};
+  eRofConnBusy(const std::string &__arg,
+               const std::string &__file = std::string(""),
+               const std::string &__func = std::string(""), int __line = 0)
+      : eRofConnBase(__arg, __file, __func, __line){};
 }; // connection already established
 class eRofConnNotFound : public eRofConnBase {
 public:
-  eRofConnNotFound(const std::string &__arg) : eRofConnBase(__arg){};
+  eRofConnNotFound(const std::string &__arg,
+                   const std::string &__file = std::string(""),
+                   const std::string &__func = std::string(""), int __line = 0)
+      : eRofConnBase(__arg, __file, __func, __line){};
 };
 class eRofConnInvalid : public eRofConnBase {
 public:
-  eRofConnInvalid(const std::string &__arg) : eRofConnBase(__arg){};
+  eRofConnInvalid(const std::string &__arg,
+                  const std::string &__file = std::string(""),
+                  const std::string &__func = std::string(""), int __line = 0)
+      : eRofConnBase(__arg, __file, __func, __line){};
 };
 class eRofConnNotConnected : public eRofConnBase {
 public:
-  eRofConnNotConnected(const std::string &__arg) : eRofConnBase(__arg){};
+  eRofConnNotConnected(const std::string &__arg,
+                       const std::string &__file = std::string(""),
+                       const std::string &__func = std::string(""),
+                       int __line = 0)
+      : eRofConnBase(__arg, __file, __func, __line){};
 };
 
 class crofconn; // forward declaration
@@ -67,10 +87,8 @@ public:
     if (crofconn_env::connection_envs.find(env) ==
         crofconn_env::connection_envs.end()) {
       throw eRofConnNotFound(
-          "crofconn_env::call_env() crofconn_env instance not found")
-          .set_func(__FUNCTION__)
-          .set_file(__FILE__)
-          .set_line(__LINE__);
+          "crofconn_env::call_env() crofconn_env instance not found", __FILE__,
+          __FUNCTION__, __LINE__);
     }
     return *(env);
   };
@@ -117,7 +135,7 @@ private:
  * @ingroup common_devel_workflow
  * @brief	A single OpenFlow control connection
  */
-class crofconn : public cthread_env, public crofsock_env {
+class crofconn : public cthread_env, public cthread_job, public crofsock_env {
 
   enum crofconn_flag_t {
     FLAG_DELETE_IN_PROGRESS,
@@ -221,6 +239,22 @@ public:
   tls_connect(const rofl::openflow::cofhello_elem_versionbitmap &versionbitmap,
               enum crofconn_mode_t mode, bool reconnect = true);
 
+  /**
+   * @brief	Starts negotiation on a socket without descriptor for
+   * replaying a capture, see crofsock::replay_accept()
+   */
+  virtual void replay_accept(
+      const rofl::openflow::cofhello_elem_versionbitmap &versionbitmap,
+      enum crofconn_mode_t mode);
+
+  /**
+   * @brief	Feeds received messages of a capture into this connection, see
+   * crofsock::replay()
+   */
+  size_t replay(const crofcapture &capture, bool paced = false) {
+    return rofsock.replay(capture, paced);
+  };
+
 public:
   /**
    *
@@ -323,10 +357,8 @@ public:
    */
   size_t get_rxqueue_max_size(outqueue_type_t queue_id) const {
     if (rxqueues.size() <= queue_id) {
-      throw eRofConnInvalid("crofconn::get_rxqueue_max_size() invalid queue_id")
-          .set_func(__FUNCTION__)
-          .set_file(__FILE__)
-          .set_line(__LINE__);
+      throw eRofConnInvalid("crofconn::get_rxqueue_max_size() invalid queue_id",
+                            __FILE__, __FUNCTION__, __LINE__);
     }
     return rxqueues[queue_id].get_queue_max_size();
   };
@@ -337,15 +369,68 @@ public:
   crofconn &set_rxqueue_max_size(outqueue_type_t queue_id,
                                  size_t rxqueue_max_size) {
     if (rxqueues.size() <= queue_id) {
-      throw eRofConnInvalid("crofconn::set_rxqueue_max_size() invalid queue_id")
-          .set_func(__FUNCTION__)
-          .set_file(__FILE__)
-          .set_line(__LINE__);
+      throw eRofConnInvalid("crofconn::set_rxqueue_max_size() invalid queue_id",
+                            __FILE__, __FUNCTION__, __LINE__);
     }
     rxqueues[queue_id].set_queue_max_size(rxqueue_max_size);
     return *this;
   };
 
+public:
+  /**
+   * @brief	Returns number of bytes an rxqueue may hand over to the
+   * application per scheduling round
+   */
+  size_t get_rx_quantum(outqueue_type_t queue_id) const {
+    return rxsched.get_quantum(queue_id);
+  };
+
+  /**
+   * @brief	Sets number of bytes an rxqueue may hand over to the
+   * application per scheduling round
+   *
+   * rxqueues are served in deficit round robin order, except QUEUE_OAM,
+   * which has strict priority over all other rxqueues.
+   */
+  crofconn &set_rx_quantum(outqueue_type_t queue_id, size_t quantum) {
+    rxsched.set_quantum(queue_id, quantum);
+    return *this;
+  };
+
+  /**
+   * @brief	Returns rxqueue scheduler with per queue message, byte and
+   * latency counters
+   */
+  const crofsched &get_rx_sched() const { return rxsched; };
+
+  /**
+   * @brief	Sets number of bytes a txqueue may send per scheduling round
+   */
+  crofconn &set_tx_quantum(outqueue_type_t queue_id, size_t quantum) {
+    rofsock.set_tx_quantum(queue_id, quantum);
+    return *this;
+  };
+
+  /**
+   * @brief	Returns txqueue scheduler of the underlying socket
+   */
+  const crofsched &get_tx_sched() const { return rofsock.get_tx_sched(); };
+
+public:
+  /**
+   * @brief	Returns capture of the underlying socket
+   */
+  crofcapture *get_capture() const { return rofsock.get_capture(); };
+
+  /**
+   * @brief	Sets capture of the underlying socket, see
+   * crofsock::set_capture()
+   */
+  crofconn &set_capture(crofcapture *capture) {
+    rofsock.set_capture(capture);
+    return *this;
+  };
+
 public:
   /**
    *
@@ -597,6 +682,24 @@ public:
     return *this;
   };
 
+  /**
+   * @brief	Returns bitmask of multipart types streamed to the application
+   */
+  uint32_t get_multipart_streaming() const { return multipart_streaming; };
+
+  /**
+   * @brief	Selects multipart reply types streamed to the application
+   *
+   * Bit n of stats_types selects multipart type n (OFPMP_*). Segments of a
+   * streamed multipart reply are handed over one by one as they arrive
+   * instead of being reassembled, the last segment lacks the
+   * OFPMPF_REPLY_MORE flag. OpenFlow 1.3 and above only.
+   */
+  crofconn &set_multipart_streaming(uint32_t stats_types) {
+    multipart_streaming = stats_types;
+    return *this;
+  };
+
   friend std::ostream &operator<<(std::ostream &os, const crofconn &conn) {
     os << "<crofconn ofp-version: " << (int)conn.ofp_version
        << " openflow-connection-established: " << conn.is_established()
@@ -661,10 +764,8 @@ private:
     if (versionbitmap.get_highest_ofp_version() ==
         rofl::openflow::OFP_VERSION_UNKNOWN) {
       throw eRofConnInvalid(
-          "crofconn::set_versionbitmap() versionbitmap invalid")
-          .set_func(__FUNCTION__)
-          .set_file(__FILE__)
-          .set_line(__LINE__);
+          "crofconn::set_versionbitmap() versionbitmap invalid", __FILE__,
+          __FUNCTION__, __LINE__);
     }
     this->versionbitmap = versionbitmap;
   };
@@ -728,11 +829,67 @@ private:
 
   virtual void handle_write_event(cthread &thread, int fd){};
 
+  virtual void handle_job(cthread &thread);
+
 private:
+  /**
+   * @brief	Enters the RX job or a timer handler, fails while the other one
+   * is running for this connection
+   *
+   * With work stealing, the RX job may run on any handler thread, while
+   * timers always fire on the home thread. Work finding the connection busy
+   * is deferred and handed back by handler_leave(), so neither timers nor
+   * application callbacks of a connection ever run concurrently.
+   */
+  bool handler_enter();
+
+  /**
+   * @brief	Leaves the RX job or a timer handler, reschedules deferred work
+   */
+  void handler_leave();
+
+  /**
+   * @brief	Runs the timers fired while the connection was busy
+   */
+  void run_deferred_timers();
+
+  /**
+   * @brief	Handles a single expired timer
+   */
+  void dispatch_timeout(uint32_t timer_id);
+
+  /**
+   * @brief	Arms timer on the home thread, supersedes a deferred expiry
+   */
+  bool add_timer(uint32_t timer_id, const ctimespec &tspec) {
+    timers_deferred &= ~(1U << timer_id);
+    return cthread::thread(thread_num).add_timer(this, timer_id, tspec);
+  };
+
+  /**
+   * @brief	Cancels timer including a deferred expiry
+   */
+  bool drop_timer(uint32_t timer_id) {
+    timers_deferred &= ~(1U << timer_id);
+    return cthread::thread(thread_num).drop_timer(this, timer_id);
+  };
+
+  /**
+   * @brief	Cancels all timers including deferred expiries
+   */
+  void drop_timers() {
+    timers_deferred = 0;
+    cthread::thread(thread_num).drop_timers(this);
+  };
+
+  void schedule_rx_messages();
+
   void handle_rx_messages();
 
   void handle_rx_multipart_message(rofl::openflow::cofmsg *msg);
 
+  bool is_streamed_segment(rofl::openflow::cofmsg *msg) const;
+
 private:
   void error_rcvd(rofl::openflow::cofmsg *msg);
 
@@ -832,6 +989,22 @@ private:
   rofl::crofsock::msg_result_t segment_meter_config_stats_reply(
       rofl::openflow::cofmsg_meter_config_stats_reply *msg);
 
+  /**
+   * @brief	Sends segments in order, enforcing queueing
+   */
+  template <class segment_t>
+  rofl::crofsock::msg_result_t
+  send_segments(const std::list<segment_t *> &segments) {
+    rofl::crofsock::msg_result_t msg_result = rofl::crofsock::MSG_QUEUED;
+    for (auto segment : segments) {
+      /* when enforcing queueing, there are only two return values possible:
+       * MSQ_QUEUED and MSG_QUEUED_CONGESTION. We return the result received
+       * for the last fragment. */
+      msg_result = rofsock.send_message(segment, /*enforce-queueing*/ true);
+    }
+    return msg_result;
+  };
+
 private:
   /**
    *
@@ -840,21 +1013,27 @@ private:
   public:
     uint32_t xid;
     ctimespec tspec;
+    // timeout relative to sending the request
+    ctimespec timeout;
     uint8_t type;
     uint16_t subtype;
+    // position in crofconn::pending_requests_timeouts
+    std::multimap<ctimespec, uint32_t>::iterator timeout_it;
 
   public:
     /**
      *
      */
-    ctransaction() : xid(0), type(0), subtype(0){};
+    ctransaction()
+        : xid(0), timeout(::timespec{0, 0}), type(0), subtype(0){};
 
     /**
      *
      */
     ctransaction(uint32_t xid, const ctimespec tspec, uint8_t type,
                  uint16_t subtype = 0)
-        : xid(xid), tspec(tspec), type(type), subtype(subtype){};
+        : xid(xid), tspec(tspec), timeout(tspec - ctimespec::now()),
+          type(type), subtype(subtype){};
 
     /**
      *
@@ -869,16 +1048,13 @@ private:
         return *this;
       xid = ta.xid;
       tspec = ta.tspec;
+      timeout = ta.timeout;
       type = ta.type;
       subtype = ta.subtype;
+      timeout_it = ta.timeout_it;
       return *this;
     };
 
-    /**
-     *
-     */
-    bool operator<(const ctransaction &ta) const { return (tspec < ta.tspec); };
-
   public:
     uint32_t get_xid() const { return xid; };
 
@@ -887,17 +1063,6 @@ private:
     uint16_t get_subtype() const { return subtype; };
 
     const ctimespec &get_tspec() const { return tspec; };
-
-  public:
-    class ctransaction_find_by_xid {
-      uint32_t xid;
-
-    public:
-      ctransaction_find_by_xid(uint32_t xid) : xid(xid){};
-      bool operator()(const ctransaction &ta) const {
-        return (ta.get_xid() == xid);
-      };
-    };
   };
 
   /**
@@ -906,28 +1071,31 @@ private:
   void clear_pending_requests() {
     AcquireReadWriteLock rwlock(pending_requests_rwlock);
     pending_requests.clear();
-    cthread::thread(thread_num).drop_timer(this, TIMER_ID_PENDING_REQUESTS);
+    pending_requests_timeouts.clear();
+    drop_timer(TIMER_ID_PENDING_REQUESTS);
   };
 
   /**
+   * @brief	Tracks a request until its reply arrives or ts expires
    *
+   * A request reusing the xid of a pending request replaces the latter.
    */
   void add_pending_request(uint32_t xid, const ctimespec &ts, uint8_t type,
                            uint16_t sub_type = 0) {
     AcquireReadWriteLock rwlock(pending_requests_rwlock);
-    if (not pending_requests.empty()) {
-      uint32_t xid_first = pending_requests.begin()->get_xid();
-      pending_requests.insert(ctransaction(xid, ts, type, sub_type));
-      const ctransaction &ta_first = *(pending_requests.begin());
-      if (xid_first != ta_first.get_xid()) {
-        cthread::thread(thread_num)
-            .add_timer(this, TIMER_ID_PENDING_REQUESTS, ta_first.tspec);
-      }
-    } else {
-      pending_requests.insert(ctransaction(xid, ts, type, sub_type));
-      cthread::thread(thread_num)
-          .add_timer(this, TIMER_ID_PENDING_REQUESTS,
-                     pending_requests.begin()->tspec);
+    auto it = pending_requests.find(xid);
+    if (it != pending_requests.end()) {
+      pending_requests_timeouts.erase(it->second.timeout_it);
+      pending_requests.erase(it);
+    }
+    bool rearm = pending_requests_timeouts.empty() ||
+                 (ts < pending_requests_timeouts.begin()->first);
+    it = pending_requests.emplace(xid, ctransaction(xid, ts, type, sub_type))
+             .first;
+    it->second.timeout_it =
+        pending_requests_timeouts.insert(std::make_pair(ts, xid));
+    if (rearm) {
+      add_timer(TIMER_ID_PENDING_REQUESTS, ts);
     }
   };
 
@@ -936,12 +1104,33 @@ private:
    */
   void drop_pending_request(uint32_t xid) {
     AcquireReadWriteLock rwlock(pending_requests_rwlock);
-    std::set<ctransaction>::iterator it;
-    while ((it = find_if(pending_requests.begin(), pending_requests.end(),
-                         ctransaction::ctransaction_find_by_xid(xid))) !=
-           pending_requests.end()) {
-      pending_requests.erase(it);
+    auto it = pending_requests.find(xid);
+    if (it == pending_requests.end()) {
+      return;
     }
+    /* an armed timer for this request finds nothing to do and rearms */
+    pending_requests_timeouts.erase(it->second.timeout_it);
+    pending_requests.erase(it);
+  };
+
+  /**
+   * @brief	Restarts the timeout of a pending request
+   *
+   * Used for each segment of a streamed multipart reply, the request
+   * stays pending until the final segment arrives.
+   */
+  void refresh_pending_request(uint32_t xid) {
+    AcquireReadWriteLock rwlock(pending_requests_rwlock);
+    auto it = pending_requests.find(xid);
+    if (it == pending_requests.end()) {
+      return;
+    }
+    /* the deadline moves ahead only, an armed timer finds nothing to do
+     * and rearms */
+    pending_requests_timeouts.erase(it->second.timeout_it);
+    it->second.tspec = ctimespec::now() + it->second.timeout;
+    it->second.timeout_it =
+        pending_requests_timeouts.insert(std::make_pair(it->second.tspec, xid));
   };
 
   /**
@@ -949,13 +1138,7 @@ private:
    */
   bool has_pending_request(uint32_t xid) const {
     AcquireReadLock rlock(pending_requests_rwlock);
-    std::set<ctransaction>::iterator it;
-    if ((it = find_if(pending_requests.begin(), pending_requests.end(),
-                      ctransaction::ctransaction_find_by_xid(xid))) !=
-        pending_requests.end()) {
-      return true;
-    }
-    return false;
+    return (pending_requests.find(xid) != pending_requests.end());
   };
 
   /**
@@ -966,16 +1149,18 @@ private:
       ctransaction ta;
       {
         AcquireReadWriteLock rwlock(pending_requests_rwlock);
-        if (pending_requests.empty()) {
+        if (pending_requests_timeouts.empty()) {
           return;
         }
-        ta = *(pending_requests.begin());
-        if (not ta.get_tspec().is_expired()) {
-          cthread::thread(thread_num)
-              .add_timer(this, TIMER_ID_PENDING_REQUESTS, ta.get_tspec());
+        auto it = pending_requests_timeouts.begin();
+        if (not it->first.is_expired()) {
+          add_timer(TIMER_ID_PENDING_REQUESTS, it->first);
           return;
         }
-        pending_requests.erase(pending_requests.begin());
+        auto jt = pending_requests.find(it->second);
+        ta = jt->second;
+        pending_requests.erase(jt);
+        pending_requests_timeouts.erase(it);
       } // release rwlock
       try {
         crofconn_env::call_env(env).handle_transaction_timeout(
@@ -993,7 +1178,7 @@ private:
   void clear_pending_segments() {
     AcquireReadWriteLock rwlock(pending_segments_rwlock);
     pending_segments.clear();
-    cthread::thread(thread_num).drop_timer(this, TIMER_ID_PENDING_SEGMENTS);
+    drop_timer(TIMER_ID_PENDING_SEGMENTS);
   };
 
   /**
@@ -1004,19 +1189,16 @@ private:
     AcquireReadWriteLock rwlock(pending_segments_rwlock);
     if (not(pending_segments.size() < pending_segments_max)) {
       throw eRofConnInvalid("crofconn::add_pending_segment() too many segments "
-                            "in transit, dropping")
-          .set_func(__FUNCTION__)
-          .set_file(__FILE__)
-          .set_line(__LINE__);
+                            "in transit, dropping",
+                            __FILE__, __FUNCTION__, __LINE__);
     }
     pending_segments[xid] =
         csegment(xid, ctimespec().expire_in(timeout_segments), msg_type,
                  msg_multipart_type);
     if (not cthread::thread(thread_num)
                 .has_timer(this, TIMER_ID_PENDING_SEGMENTS)) {
-      cthread::thread(thread_num)
-          .add_timer(this, TIMER_ID_PENDING_SEGMENTS,
-                     ctimespec().expire_in(timeout_segments));
+      add_timer(TIMER_ID_PENDING_SEGMENTS,
+                ctimespec().expire_in(timeout_segments));
     }
     return pending_segments[xid];
   };
@@ -1029,10 +1211,8 @@ private:
     AcquireReadWriteLock rwlock(pending_segments_rwlock);
     if (not(pending_segments.size() < pending_segments_max)) {
       throw eRofConnInvalid("crofconn::set_pending_segment() too many segments "
-                            "in transit, dropping")
-          .set_func(__FUNCTION__)
-          .set_file(__FILE__)
-          .set_line(__LINE__);
+                            "in transit, dropping",
+                            __FILE__, __FUNCTION__, __LINE__);
     }
     if (pending_segments.find(xid) == pending_segments.end()) {
       pending_segments[xid] =
@@ -1041,9 +1221,8 @@ private:
     }
     if (not cthread::thread(thread_num)
                 .has_timer(this, TIMER_ID_PENDING_SEGMENTS)) {
-      cthread::thread(thread_num)
-          .add_timer(this, TIMER_ID_PENDING_SEGMENTS,
-                     ctimespec().expire_in(timeout_segments));
+      add_timer(TIMER_ID_PENDING_SEGMENTS,
+                ctimespec().expire_in(timeout_segments));
     }
     return pending_segments[xid];
   };
@@ -1055,22 +1234,17 @@ private:
     AcquireReadWriteLock rwlock(pending_segments_rwlock);
     if (not(pending_segments.size() < pending_segments_max)) {
       throw eRofConnInvalid("crofconn::set_pending_segment() too many segments "
-                            "in transit, dropping")
-          .set_func(__FUNCTION__)
-          .set_file(__FILE__)
-          .set_line(__LINE__);
+                            "in transit, dropping",
+                            __FILE__, __FUNCTION__, __LINE__);
     }
     if (pending_segments.find(xid) == pending_segments.end()) {
-      throw eRofConnNotFound("crofconn::set_pending_segment() xid not found")
-          .set_func(__FUNCTION__)
-          .set_file(__FILE__)
-          .set_line(__LINE__);
+      throw eRofConnNotFound("crofconn::set_pending_segment() xid not found",
+                             __FILE__, __FUNCTION__, __LINE__);
     }
     if (not cthread::thread(thread_num)
                 .has_timer(this, TIMER_ID_PENDING_SEGMENTS)) {
-      cthread::thread(thread_num)
-          .add_timer(this, TIMER_ID_PENDING_SEGMENTS,
-                     ctimespec().expire_in(timeout_segments));
+      add_timer(TIMER_ID_PENDING_SEGMENTS,
+                ctimespec().expire_in(timeout_segments));
     }
     return pending_segments[xid];
   };
@@ -1081,10 +1255,8 @@ private:
   const csegment &get_pending_segment(uint32_t xid) const {
     AcquireReadLock rlock(pending_segments_rwlock);
     if (pending_segments.find(xid) == pending_segments.end()) {
-      throw eRofConnNotFound("crofconn::get_pending_segment() xid not found")
-          .set_func(__FUNCTION__)
-          .set_file(__FILE__)
-          .set_line(__LINE__);
+      throw eRofConnNotFound("crofconn::get_pending_segment() xid not found",
+                             __FILE__, __FUNCTION__, __LINE__);
     }
     return pending_segments.at(xid);
   };
@@ -1121,9 +1293,8 @@ private:
       pending_segments.erase(it);
     }
     if (not pending_segments.empty()) {
-      cthread::thread(thread_num)
-          .add_timer(this, TIMER_ID_PENDING_SEGMENTS,
-                     ctimespec().expire_in(timeout_segments));
+      add_timer(TIMER_ID_PENDING_SEGMENTS,
+                ctimespec().expire_in(timeout_segments));
     }
   };
 
@@ -1179,8 +1350,8 @@ private:
   // hello lock
   rofl::crwlock hello_lock;
 
-  // relative scheduling weights for rxqueues
-  std::vector<unsigned int> rxweights;
+  // deficit round robin scheduler for rxqueues
+  crofsched rxsched;
 
   // queues for storing received messages
   std::vector<crofqueue> rxqueues;
@@ -1191,6 +1362,15 @@ private:
   // internal thread is scheduled for working on pending messages
   std::atomic_bool rx_thread_scheduled;
 
+  // RX job or timer handler running, see handler_enter()
+  std::atomic_bool handler_busy;
+
+  // RX job found the connection busy
+  std::atomic_bool rx_deferred;
+
+  // timers fired while the connection was busy, bit per timer id
+  std::atomic<uint32_t> timers_deferred;
+
   // max size of rx queue
   size_t rxqueue_max_size;
   static const int RXQUEUE_MAX_SIZE_DEFAULT;
@@ -1217,8 +1397,11 @@ private:
   time_t timeout_lifecheck;
   static const time_t DEFAULT_LIFECHECK_TIMEOUT;
 
-  // set of pending requests
-  std::set<ctransaction> pending_requests;
+  // pending requests indexed by xid
+  std::unordered_map<uint32_t, ctransaction> pending_requests;
+
+  // xids of pending requests ordered by expiry
+  std::multimap<ctimespec, uint32_t> pending_requests_timeouts;
 
   // .. and associated rwlock
   crwlock pending_requests_rwlock;
@@ -1245,6 +1428,9 @@ private:
   // maximum number of pending segments in parallel
   unsigned int pending_segments_max;
   static const unsigned int DEFAULT_PENDING_SEGMENTS_MAX;
+
+  // bitmask of multipart reply types passed on without reassembly
+  std::atomic_uint_fast32_t multipart_streaming;
 };
 
 }; /* namespace rofl */
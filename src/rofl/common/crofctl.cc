@@ -24,7 +24,8 @@ crofctl::crofctl(crofctl_env *env, const cctlid &ctlid)
     : env(env), state(STATE_RUNNING), ctlid(ctlid), rofchan(this),
       xid_last(random.uint32()),
       async_config_role_default_template(rofl::openflow13::OFP_VERSION),
-      async_config(rofl::openflow13::OFP_VERSION) {
+      async_config(rofl::openflow13::OFP_VERSION),
+      miss_send_len(OFP_DEFAULT_MISS_SEND_LEN) {
   init_async_config_role_default_template();
   async_config = get_async_config_role_default_template();
 };
@@ -68,6 +69,9 @@ void crofctl::handle_recv(crofchan &chan, crofconn &conn,
       } break;
       case rofl::openflow10::OFPT_SET_CONFIG: {
 
+        miss_send_len =
+            dynamic_cast<rofl::openflow::cofmsg_set_config &>(*msg)
+                .get_miss_send_len();
         crofctl_env::call_env(env).handle_set_config(
             *this, conn.get_auxid(),
             dynamic_cast<rofl::openflow::cofmsg_set_config &>(*msg));
@@ -206,6 +210,9 @@ void crofctl::handle_recv(crofchan &chan, crofconn &conn,
       case rofl::openflow12::OFPT_SET_CONFIG: {
 
         check_role();
+        miss_send_len =
+            dynamic_cast<rofl::openflow::cofmsg_set_config &>(*msg)
+                .get_miss_send_len();
         crofctl_env::call_env(env).handle_set_config(
             *this, conn.get_auxid(),
             dynamic_cast<rofl::openflow::cofmsg_set_config &>(*msg));
@@ -405,6 +412,9 @@ void crofctl::handle_recv(crofchan &chan, crofconn &conn,
       case rofl::openflow13::OFPT_SET_CONFIG: {
 
         check_role();
+        miss_send_len =
+            dynamic_cast<rofl::openflow::cofmsg_set_config &>(*msg)
+                .get_miss_send_len();
         crofctl_env::call_env(env).handle_set_config(
             *this, conn.get_auxid(),
             dynamic_cast<rofl::openflow::cofmsg_set_config &>(*msg));
@@ -2557,40 +2567,50 @@ rofl::crofsock::msg_result_t crofctl::send_packet_in_message(
     const rofl::openflow::cofmatch &match, uint8_t *data, size_t datalen) {
   rofl::openflow::cofmsg *msg = nullptr;
   try {
-    switch (rofchan.get_version()) {
-    case rofl::openflow12::OFP_VERSION: {
-      if (is_slave()) {
-        return rofl::crofsock::MSG_IGNORED;
-      }
-    } break;
-    case rofl::openflow13::OFP_VERSION: {
-      switch (role.get_role()) {
-      case rofl::openflow13::OFPCR_ROLE_EQUAL:
-      case rofl::openflow13::OFPCR_ROLE_MASTER: {
-        if (not(async_config.get_packet_in_mask_master() & (1 << reason))) {
-          return rofl::crofsock::MSG_IGNORED;
-        }
-      } break;
-      case rofl::openflow13::OFPCR_ROLE_SLAVE: {
-        if (not(async_config.get_packet_in_mask_slave() & (1 << reason))) {
-          return rofl::crofsock::MSG_IGNORED;
-        }
-      } break;
-      default: {
-        // unknown role: send packet-in to controller
-      };
-      }
-    } break;
-    default: {
-      // send packet-in
-    };
+    if (packet_in_filtered(reason) || not shaper.admit(reason)) {
+      return rofl::crofsock::MSG_IGNORED;
     }
 
+    size_t framelen = datalen;
+    bool buffered = packet_in_reserve(reason, buffer_id, datalen);
+
     msg = new rofl::openflow::cofmsg_packet_in(
         rofchan.get_version(), ++xid_last, buffer_id, total_len, reason,
         table_id, cookie, in_port, /* in_port for OF1.0 */
         match, data, datalen);
 
+    rofl::crofsock::msg_result_t result = rofchan.send_message(auxid, msg);
+    if (buffered) {
+      packet_in_store(result, buffer_id, data, framelen);
+    }
+    return result;
+
+  } catch (eRofConnNotConnected &e) {
+    VLOG(1) << __FUNCTION__ << " dropping message " << e.what();
+    delete msg;
+    throw;
+  } catch (eRofQueueFull &e) {
+    VLOG(1) << __FUNCTION__ << " dropping message " << e.what();
+    delete msg;
+    throw;
+  }
+}
+
+rofl::crofsock::msg_result_t crofctl::send_packet_in_message(
+    const cauxid &auxid, uint8_t reason,
+    const std::shared_ptr<const rofl::cmemory> &wire) {
+  rofl::openflow::cofmsg *msg = nullptr;
+  try {
+    if (packet_in_filtered(reason) || not shaper.admit(reason)) {
+      return rofl::crofsock::MSG_IGNORED;
+    }
+
+    msg = new rofl::openflow::cofmsg_packet_in_shared(++xid_last, wire);
+
+    if (msg->get_version() != rofchan.get_version()) {
+      throw eBadVersion("eBadVersion", __FILE__, __FUNCTION__, __LINE__);
+    }
+
     return rofchan.send_message(auxid, msg);
 
   } catch (eRofConnNotConnected &e) {
@@ -2601,7 +2621,93 @@ rofl::crofsock::msg_result_t crofctl::send_packet_in_message(
     VLOG(1) << __FUNCTION__ << " dropping message " << e.what();
     delete msg;
     throw;
+  } catch (eBadVersion &e) {
+    VLOG(1) << __FUNCTION__ << " dropping message " << e.what();
+    delete msg;
+    throw;
+  }
+}
+
+rofl::crofsock::msg_result_t crofctl::try_send_packet_in_message(
+    const cauxid &auxid, uint32_t buffer_id, uint16_t total_len, uint8_t reason,
+    uint8_t table_id, uint64_t cookie,
+    uint16_t in_port, // for OF 1.0
+    const rofl::openflow::cofmatch &match, uint8_t *data, size_t datalen) {
+  if (not rofchan.is_established()) {
+    return rofl::crofsock::MSG_QUEUEING_FAILED_NOT_ESTABLISHED;
+  }
+  if (packet_in_filtered(reason) || not shaper.admit(reason)) {
+    return rofl::crofsock::MSG_IGNORED;
+  }
+  size_t framelen = datalen;
+  bool buffered = packet_in_reserve(reason, buffer_id, datalen);
+  rofl::crofsock::msg_result_t result = rofchan.try_send_message(
+      auxid, new rofl::openflow::cofmsg_packet_in(
+                 rofchan.get_version(), ++xid_last, buffer_id, total_len,
+                 reason, table_id, cookie, in_port, /* in_port for OF1.0 */
+                 match, data, datalen));
+  if (buffered) {
+    packet_in_store(result, buffer_id, data, framelen);
+  }
+  return result;
+}
+
+bool crofctl::packet_in_reserve(uint8_t reason, uint32_t &buffer_id,
+                                size_t &datalen) {
+  if ((rofl::openflow13::OFPR_NO_MATCH != reason) ||
+      (rofl::openflow13::OFP_NO_BUFFER != buffer_id) ||
+      (rofl::openflow13::OFPCML_NO_BUFFER == miss_send_len) ||
+      (datalen <= miss_send_len)) {
+    return false;
+  }
+  uint32_t reserved = shaper.reserve();
+  if (rofl::cpacketinshaper::NO_BUFFER == reserved) {
+    return false;
+  }
+  buffer_id = reserved;
+  datalen = miss_send_len;
+  return true;
+}
+
+void crofctl::packet_in_store(rofl::crofsock::msg_result_t result,
+                              uint32_t buffer_id, const uint8_t *data,
+                              size_t framelen) {
+  /* keep the full frame, the controller refers to it by buffer_id */
+  switch (result) {
+  case rofl::crofsock::MSG_QUEUED:
+  case rofl::crofsock::MSG_QUEUED_CONGESTION: {
+    shaper.store(buffer_id, data, framelen);
+  } break;
+  default: {
+    // Packet-In dropped, the frame is not referenced
+  };
+  }
+}
+
+bool crofctl::packet_in_filtered(uint8_t reason) const {
+  switch (rofchan.get_version()) {
+  case rofl::openflow12::OFP_VERSION: {
+    return is_slave();
+  } break;
+  case rofl::openflow13::OFP_VERSION: {
+    switch (role.get_role()) {
+    case rofl::openflow13::OFPCR_ROLE_EQUAL:
+    case rofl::openflow13::OFPCR_ROLE_MASTER: {
+      return not(async_config.get_packet_in_mask_master() & (1 << reason));
+    } break;
+    case rofl::openflow13::OFPCR_ROLE_SLAVE: {
+      return not(async_config.get_packet_in_mask_slave() & (1 << reason));
+    } break;
+    default: {
+      // unknown role: send packet-in to controller
+    };
+    }
+  } break;
+  default: {
+    // send packet-in
+  };
   }
+  return false;
 }
 
 rofl::crofsock::msg_result_t crofctl::send_barrier_reply(const cauxid &auxid,
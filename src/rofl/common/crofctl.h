@@ -20,6 +20,7 @@
 #include "rofl/common/cauxid.h"
 #include "rofl/common/cctlid.h"
 #include "rofl/common/cmemory.h"
+#include "rofl/common/cpacketinshaper.h"
 #include "rofl/common/crofchan.h"
 #include "rofl/common/exception.hpp"
 #include "rofl/common/locking.hpp"
@@ -759,6 +760,37 @@ public:
     return async_config_role_default_template;
   };
 
+  /**
+   * @brief	Returns a reference to the Packet-In rate limits and buffers
+   * of this controller entity.
+   */
+  rofl::cpacketinshaper &set_packet_in_shaper() { return shaper; };
+
+  /**
+   * @brief	Returns a const reference to the Packet-In rate limits and
+   * buffers of this controller entity.
+   */
+  const rofl::cpacketinshaper &get_packet_in_shaper() const {
+    return shaper;
+  };
+
+  /**
+   * @brief	Returns the number of bytes of a table-miss Packet-In's frame
+   * sent to this controller entity when buffers are enabled.
+   *
+   * Updated by Set-Config messages received from the controller entity.
+   */
+  uint16_t get_miss_send_len() const { return miss_send_len; };
+
+  /**
+   * @brief	Sets the number of bytes of a table-miss Packet-In's frame
+   * sent to this controller entity when buffers are enabled.
+   */
+  crofctl &set_miss_send_len(uint16_t miss_send_len) {
+    this->miss_send_len = miss_send_len;
+    return *this;
+  };
+
   /**@}*/
 
 public:
@@ -1090,6 +1122,11 @@ public:
   /**
    * @brief	Sends OpenFlow Packet-In message to attached controller entity.
    *
+   * Packet-Ins exceeding the rate limit for reason are dropped and
+   * MSG_IGNORED is returned. With buffers enabled, unbuffered table-miss
+   * Packet-Ins are stored locally and sent with a frame truncated to
+   * get_miss_send_len() bytes, see rofl::cpacketinshaper.
+   *
    * @param buffer_id buffer ID assigned by data path
    * @param total_len Full length of frame
    * @param reason reason packet is being sent (one of OFPR_* flags)
@@ -1106,6 +1143,33 @@ public:
       uint16_t in_port, // for OF1.0
       const rofl::openflow::cofmatch &match, uint8_t *data, size_t datalen);
 
+  /**
+   * @brief	Sends a Packet-In packed once for several controllers
+   *
+   * Applies the role and async-config filters and the rate limit for
+   * reason and queues a cofmsg_packet_in_shared referencing wire with a
+   * new xid of this controller.
+   *
+   * @param reason reason stored in wire
+   * @param wire Packet-In packed via cofmsg_packet_in_shared::make_wire()
+   * @exception eBadVersion wire not packed for this controller's version
+   */
+  rofl::crofsock::msg_result_t
+  send_packet_in_message(const rofl::cauxid &auxid, uint8_t reason,
+                         const std::shared_ptr<const rofl::cmemory> &wire);
+
+  /**
+   * @brief	Sends OpenFlow Packet-In message, never throws.
+   *
+   * Failures are reported via the returned msg_result_t only, e.g.
+   * MSG_QUEUEING_FAILED_NOT_ESTABLISHED or MSG_QUEUEING_FAILED_QUEUE_FULL.
+   */
+  rofl::crofsock::msg_result_t try_send_packet_in_message(
+      const rofl::cauxid &auxid, uint32_t buffer_id, uint16_t total_len,
+      uint8_t reason, uint8_t table_id, uint64_t cookie,
+      uint16_t in_port, // for OF1.0
+      const rofl::openflow::cofmatch &match, uint8_t *data, size_t datalen);
+
   /**
    * @brief	Sends OpenFlow Barrier-Reply message to attached controller
    * entity.
@@ -1328,6 +1392,28 @@ private:
 private:
   void init_async_config_role_default_template();
 
+  /**
+   * @brief Returns true if role and async config suppress this Packet-In
+   */
+  bool packet_in_filtered(uint8_t reason) const;
+
+  /**
+   * @brief Assigns a buffer-id to a table-miss Packet-In when buffers are
+   * enabled and truncates it to miss_send_len
+   *
+   * @return true if the frame must be stored by packet_in_store()
+   */
+  bool packet_in_reserve(uint8_t reason, uint32_t &buffer_id,
+                         size_t &datalen);
+
+  /**
+   * @brief Stores the full frame for buffer_id once its Packet-In has
+   * been queued
+   */
+  void packet_in_store(rofl::crofsock::msg_result_t result,
+                       uint32_t buffer_id, const uint8_t *data,
+                       size_t framelen);
+
   bool delete_in_progress() const {
     return (STATE_DELETE_IN_PROGRESS == state);
   };
@@ -1362,6 +1448,12 @@ private:
 
   // role of associated remote controller
   rofl::openflow::cofrole role;
+
+  // Packet-In rate limits and buffers
+  rofl::cpacketinshaper shaper;
+
+  // frame bytes sent in buffered table-miss Packet-Ins
+  std::atomic<uint16_t> miss_send_len;
 };
 
 }; // end of namespace
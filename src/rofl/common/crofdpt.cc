@@ -29,6 +29,8 @@ void crofdpt::handle_recv(rofl::crofchan &chan, rofl::crofconn &conn,
                           rofl::openflow::cofmsg *msg) {
   if (delete_in_progress())
     return;
+  if (reply_rcvd(conn.get_auxid(), msg))
+    return;
   try {
     switch (msg->get_version()) {
     case rofl::openflow10::OFP_VERSION: {
@@ -168,6 +170,9 @@ void crofdpt::handle_transaction_timeout(crofchan &chan, crofconn &conn,
     return;
   VLOG(2) << __FUNCTION__ << " transaction xid=" << (unsigned int)xid;
 
+  if (reply_timeout(xid))
+    return;
+
   try {
     switch (get_version()) {
     case rofl::openflow10::OFP_VERSION: {
@@ -413,13 +418,27 @@ void crofdpt::handle_transaction_timeout(crofchan &chan, crofconn &conn,
   }
 }
 
+crofdpt &crofdpt::set_dpid(const rofl::cdpid &dpid) {
+  if (this->dpid == dpid) {
+    return *this;
+  }
+  rofl::cdpid old_dpid = this->dpid;
+  this->dpid = dpid;
+  try {
+    crofdpt_env::call_env(env).handle_dpid_changed(*this, old_dpid);
+  } catch (eRofDptNotFound &e) {
+    /* do nothing */
+  }
+  return *this;
+}
+
 void crofdpt::features_reply_rcvd(const rofl::cauxid &auxid,
                                   rofl::openflow::cofmsg *msg) {
   rofl::openflow::cofmsg_features_reply &reply =
       dynamic_cast<rofl::openflow::cofmsg_features_reply &>(*msg);
 
   if (snoop) {
-    dpid = rofl::cdpid(reply.get_dpid());
+    set_dpid(rofl::cdpid(reply.get_dpid()));
     n_buffers = reply.get_n_buffers();
     n_tables = reply.get_n_tables();
     capabilities = reply.get_capabilities();
@@ -466,6 +485,11 @@ void crofdpt::multipart_reply_rcvd(const rofl::cauxid &auxid,
       dynamic_cast<rofl::openflow::cofmsg_stats_reply *>(msg);
   assert(reply != NULL);
 
+  if (get_multipart_streaming(reply->get_stats_type())) {
+    multipart_segment_rcvd(auxid, msg);
+    return;
+  }
+
   switch (reply->get_stats_type()) {
   case rofl::openflow13::OFPMP_DESC: {
     desc_stats_reply_rcvd(auxid, msg);
@@ -540,6 +564,27 @@ void crofdpt::port_stats_reply_rcvd(const rofl::cauxid &auxid,
   crofdpt_env::call_env(env).handle_port_stats_reply(*this, auxid, reply);
 }
 
+void crofdpt::multipart_segment_rcvd(const rofl::cauxid &auxid,
+                                     rofl::openflow::cofmsg *msg) {
+  rofl::openflow::cofmsg_stats_reply &reply =
+      dynamic_cast<rofl::openflow::cofmsg_stats_reply &>(*msg);
+
+  bool last =
+      not(reply.get_stats_flags() & rofl::openflow13::OFPMPF_REPLY_MORE);
+
+  switch (reply.get_stats_type()) {
+  case rofl::openflow13::OFPMP_FLOW: {
+    crofdpt_env::call_env(env).handle_flow_stats_reply_segment(
+        *this, auxid,
+        dynamic_cast<rofl::openflow::cofmsg_flow_stats_reply &>(*msg), last);
+  } break;
+  default: {
+    crofdpt_env::call_env(env).handle_stats_reply_segment(*this, auxid, reply,
+                                                          last);
+  };
+  }
+}
+
 void crofdpt::flow_stats_reply_rcvd(const rofl::cauxid &auxid,
                                     rofl::openflow::cofmsg *msg) {
   rofl::openflow::cofmsg_flow_stats_reply &reply =
@@ -1289,6 +1334,67 @@ crofdpt::send_packet_out_message(const rofl::cauxid &auxid, uint32_t buffer_id,
   }
 }
 
+rofl::crofsock::msg_result_t crofdpt::send_packet_out_message(
+    const rofl::cauxid &auxid, uint32_t buffer_id, uint32_t in_port,
+    const rofl::openflow::cofactions &actions,
+    const std::shared_ptr<const rofl::cmemory> &frame, uint32_t *xid) {
+  rofl::openflow::cofmsg *msg = nullptr;
+  uint32_t __xid = ++xid_last;
+  try {
+    msg = new rofl::openflow::cofmsg_packet_out(rofchan.get_version(), __xid,
+                                                buffer_id, in_port, actions,
+                                                frame);
+
+    if (xid != nullptr) {
+      *xid = __xid;
+    }
+    return rofchan.send_message(auxid, msg);
+
+  } catch (eRofConnNotConnected &e) {
+    VLOG(1) << __FUNCTION__ << " dropping mesage " << e.what();
+    delete msg;
+    throw;
+  } catch (eRofQueueFull &e) {
+    VLOG(1) << __FUNCTION__ << " dropping mesage " << e.what();
+    delete msg;
+    throw;
+  }
+}
+
+rofl::crofsock::msg_result_t crofdpt::try_send_packet_out_message(
+    const rofl::cauxid &auxid, uint32_t buffer_id, uint32_t in_port,
+    const rofl::openflow::cofactions &actions, uint8_t *data, size_t datalen,
+    uint32_t *xid) {
+  if (not rofchan.is_established()) {
+    return rofl::crofsock::MSG_QUEUEING_FAILED_NOT_ESTABLISHED;
+  }
+  uint32_t __xid = ++xid_last;
+  if (xid != nullptr) {
+    *xid = __xid;
+  }
+  return rofchan.try_send_message(
+      auxid, new rofl::openflow::cofmsg_packet_out(rofchan.get_version(), __xid,
+                                                   buffer_id, in_port, actions,
+                                                   data, datalen));
+}
+
+rofl::crofsock::msg_result_t crofdpt::try_send_packet_out_message(
+    const rofl::cauxid &auxid, uint32_t buffer_id, uint32_t in_port,
+    const rofl::openflow::cofactions &actions,
+    const std::shared_ptr<const rofl::cmemory> &frame, uint32_t *xid) {
+  if (not rofchan.is_established()) {
+    return rofl::crofsock::MSG_QUEUEING_FAILED_NOT_ESTABLISHED;
+  }
+  uint32_t __xid = ++xid_last;
+  if (xid != nullptr) {
+    *xid = __xid;
+  }
+  return rofchan.try_send_message(
+      auxid, new rofl::openflow::cofmsg_packet_out(rofchan.get_version(), __xid,
+                                                   buffer_id, in_port, actions,
+                                                   frame));
+}
+
 rofl::crofsock::msg_result_t
 crofdpt::send_barrier_request(const rofl::cauxid &auxid, int timeout_in_secs,
                               uint32_t *xid) {
@@ -1367,6 +1473,94 @@ crofdpt::send_flow_mod_message(const rofl::cauxid &auxid,
   }
 }
 
+rofl::crofsock::msg_result_t
+crofdpt::send_flow_mod_message(const rofl::cauxid &auxid,
+                               const rofl::openflow::cofflowmod_template &tmpl,
+                               uint32_t *xid) {
+  rofl::openflow::cofmsg_flow_mod_batch *msg = nullptr;
+  uint32_t __xid = ++xid_last;
+  try {
+    msg = new rofl::openflow::cofmsg_flow_mod_batch(
+        rofchan.get_version(),
+        sizeof(struct rofl::openflow::ofp_header) + tmpl.length());
+    msg->add_flow_mod(__xid, tmpl);
+
+    if (xid != nullptr) {
+      *xid = __xid;
+    }
+    return rofchan.send_message(auxid, msg);
+
+  } catch (rofl::exception &e) {
+    VLOG(1) << __FUNCTION__ << " dropping message " << e.what();
+    delete msg;
+    throw;
+  }
+}
+
+rofl::crofsock::msg_result_t
+crofdpt::try_send_flow_mod_message(const rofl::cauxid &auxid,
+                                   const rofl::openflow::cofflowmod &fe,
+                                   uint32_t *xid) {
+  if (not rofchan.is_established()) {
+    return rofl::crofsock::MSG_QUEUEING_FAILED_NOT_ESTABLISHED;
+  }
+  uint32_t __xid = ++xid_last;
+  if (xid != nullptr) {
+    *xid = __xid;
+  }
+  return rofchan.try_send_message(
+      auxid,
+      new rofl::openflow::cofmsg_flow_mod(rofchan.get_version(), __xid, fe));
+}
+
+rofl::crofsock::msg_result_t crofdpt::send_flow_mod_batch(
+    const rofl::cauxid &auxid, const rofl::openflow::cofflowmod *flowmods,
+    size_t num, bool barrier, uint32_t *first_xid, uint32_t *last_xid,
+    int timeout_in_secs) {
+  size_t num_msgs = num + (barrier ? 1 : 0);
+  if (num_msgs == 0) {
+    return rofl::crofsock::MSG_IGNORED;
+  }
+
+  /* reserve consecutive xids for all messages in this batch */
+  uint32_t __xid = xid_last.fetch_add(num_msgs) + 1;
+
+  size_t buflen = num_msgs * sizeof(struct rofl::openflow::ofp_header);
+  for (size_t i = 0; i < num; i++) {
+    buflen += flowmods[i].length();
+  }
+
+  rofl::openflow::cofmsg_flow_mod_batch *msg = nullptr;
+  try {
+    msg = new rofl::openflow::cofmsg_flow_mod_batch(rofchan.get_version(),
+                                                    buflen);
+    for (size_t i = 0; i < num; i++) {
+      msg->add_flow_mod(__xid + i, flowmods[i]);
+    }
+    if (barrier) {
+      msg->add_barrier_request(__xid + num);
+    }
+
+    if (first_xid != nullptr) {
+      *first_xid = __xid;
+    }
+    if (last_xid != nullptr) {
+      *last_xid = __xid + num_msgs - 1;
+    }
+
+    if (barrier) {
+      return rofchan.send_message(auxid, msg,
+                                  ctimespec().expire_in(timeout_in_secs));
+    }
+    return rofchan.send_message(auxid, msg);
+
+  } catch (rofl::exception &e) {
+    VLOG(1) << __FUNCTION__ << " dropping message " << e.what();
+    delete msg;
+    throw;
+  }
+}
+
 rofl::crofsock::msg_result_t
 crofdpt::send_group_mod_message(const rofl::cauxid &auxid,
                                 const rofl::openflow::cofgroupmod &ge,
@@ -1632,3 +1826,366 @@ rofl::crofsock::msg_result_t crofdpt::send_experimenter_message(
     throw;
   }
 }
+
+rofl::crofsock::msg_result_t
+crofdpt::send_barrier_request(const rofl::cauxid &auxid, const reply_cb_t &cb,
+                              int timeout_in_secs, uint32_t *xid) {
+  uint32_t __xid = ++xid_last;
+  if (xid != nullptr) {
+    *xid = __xid;
+  }
+  return send_request(
+      auxid,
+      new rofl::openflow::cofmsg_barrier_request(rofchan.get_version(), __xid),
+      make_reply_fn(cb, __xid), timeout_in_secs);
+}
+
+crofdpt::reply_future_t
+crofdpt::async_barrier_request(const rofl::cauxid &auxid, int timeout_in_secs,
+                               uint32_t *xid) {
+  uint32_t __xid = ++xid_last;
+  if (xid != nullptr) {
+    *xid = __xid;
+  }
+  return send_async_request(
+      auxid,
+      new rofl::openflow::cofmsg_barrier_request(rofchan.get_version(), __xid),
+      timeout_in_secs);
+}
+
+rofl::crofsock::msg_result_t
+crofdpt::send_desc_stats_request(const rofl::cauxid &auxid, uint16_t flags,
+                                 const reply_cb_t &cb, int timeout_in_secs,
+                                 uint32_t *xid) {
+  uint32_t __xid = ++xid_last;
+  if (xid != nullptr) {
+    *xid = __xid;
+  }
+  return send_request(auxid,
+                      new rofl::openflow::cofmsg_desc_stats_request(
+                          rofchan.get_version(), __xid, flags),
+                      make_reply_fn(cb, __xid), timeout_in_secs);
+}
+
+crofdpt::reply_future_t
+crofdpt::async_desc_stats_request(const rofl::cauxid &auxid, uint16_t flags,
+                                  int timeout_in_secs, uint32_t *xid) {
+  uint32_t __xid = ++xid_last;
+  if (xid != nullptr) {
+    *xid = __xid;
+  }
+  return send_async_request(auxid,
+                            new rofl::openflow::cofmsg_desc_stats_request(
+                                rofchan.get_version(), __xid, flags),
+                            timeout_in_secs);
+}
+
+rofl::crofsock::msg_result_t crofdpt::send_flow_stats_request(
+    const rofl::cauxid &auxid, uint16_t flags,
+    const rofl::openflow::cofflow_stats_request &flow_stats_request,
+    const reply_cb_t &cb, int timeout_in_secs, uint32_t *xid) {
+  uint32_t __xid = ++xid_last;
+  if (xid != nullptr) {
+    *xid = __xid;
+  }
+  return send_request(auxid,
+                      new rofl::openflow::cofmsg_flow_stats_request(
+                          rofchan.get_version(), __xid, flags,
+                          flow_stats_request),
+                      make_reply_fn(cb, __xid), timeout_in_secs);
+}
+
+crofdpt::reply_future_t crofdpt::async_flow_stats_request(
+    const rofl::cauxid &auxid, uint16_t flags,
+    const rofl::openflow::cofflow_stats_request &flow_stats_request,
+    int timeout_in_secs, uint32_t *xid) {
+  uint32_t __xid = ++xid_last;
+  if (xid != nullptr) {
+    *xid = __xid;
+  }
+  return send_async_request(auxid,
+                            new rofl::openflow::cofmsg_flow_stats_request(
+                                rofchan.get_version(), __xid, flags,
+                                flow_stats_request),
+                            timeout_in_secs);
+}
+
+rofl::crofsock::msg_result_t crofdpt::send_aggr_stats_request(
+    const rofl::cauxid &auxid, uint16_t flags,
+    const rofl::openflow::cofaggr_stats_request &aggr_stats_request,
+    const reply_cb_t &cb, int timeout_in_secs, uint32_t *xid) {
+  uint32_t __xid = ++xid_last;
+  if (xid != nullptr) {
+    *xid = __xid;
+  }
+  return send_request(auxid,
+                      new rofl::openflow::cofmsg_aggr_stats_request(
+                          rofchan.get_version(), __xid, flags,
+                          aggr_stats_request),
+                      make_reply_fn(cb, __xid), timeout_in_secs);
+}
+
+crofdpt::reply_future_t crofdpt::async_aggr_stats_request(
+    const rofl::cauxid &auxid, uint16_t flags,
+    const rofl::openflow::cofaggr_stats_request &aggr_stats_request,
+    int timeout_in_secs, uint32_t *xid) {
+  uint32_t __xid = ++xid_last;
+  if (xid != nullptr) {
+    *xid = __xid;
+  }
+  return send_async_request(auxid,
+                            new rofl::openflow::cofmsg_aggr_stats_request(
+                                rofchan.get_version(), __xid, flags,
+                                aggr_stats_request),
+                            timeout_in_secs);
+}
+
+rofl::crofsock::msg_result_t
+crofdpt::send_table_stats_request(const rofl::cauxid &auxid, uint16_t flags,
+                                  const reply_cb_t &cb, int timeout_in_secs,
+                                  uint32_t *xid) {
+  uint32_t __xid = ++xid_last;
+  if (xid != nullptr) {
+    *xid = __xid;
+  }
+  return send_request(auxid,
+                      new rofl::openflow::cofmsg_table_stats_request(
+                          rofchan.get_version(), __xid, flags),
+                      make_reply_fn(cb, __xid), timeout_in_secs);
+}
+
+crofdpt::reply_future_t
+crofdpt::async_table_stats_request(const rofl::cauxid &auxid, uint16_t flags,
+                                   int timeout_in_secs, uint32_t *xid) {
+  uint32_t __xid = ++xid_last;
+  if (xid != nullptr) {
+    *xid = __xid;
+  }
+  return send_async_request(auxid,
+                            new rofl::openflow::cofmsg_table_stats_request(
+                                rofchan.get_version(), __xid, flags),
+                            timeout_in_secs);
+}
+
+rofl::crofsock::msg_result_t crofdpt::send_port_stats_request(
+    const rofl::cauxid &auxid, uint16_t flags,
+    const rofl::openflow::cofport_stats_request &port_stats_request,
+    const reply_cb_t &cb, int timeout_in_secs, uint32_t *xid) {
+  uint32_t __xid = ++xid_last;
+  if (xid != nullptr) {
+    *xid = __xid;
+  }
+  return send_request(auxid,
+                      new rofl::openflow::cofmsg_port_stats_request(
+                          rofchan.get_version(), __xid, flags,
+                          port_stats_request),
+                      make_reply_fn(cb, __xid), timeout_in_secs);
+}
+
+crofdpt::reply_future_t crofdpt::async_port_stats_request(
+    const rofl::cauxid &auxid, uint16_t flags,
+    const rofl::openflow::cofport_stats_request &port_stats_request,
+    int timeout_in_secs, uint32_t *xid) {
+  uint32_t __xid = ++xid_last;
+  if (xid != nullptr) {
+    *xid = __xid;
+  }
+  return send_async_request(auxid,
+                            new rofl::openflow::cofmsg_port_stats_request(
+                                rofchan.get_version(), __xid, flags,
+                                port_stats_request),
+                            timeout_in_secs);
+}
+
+rofl::crofsock::msg_result_t
+crofdpt::send_request(const rofl::cauxid &auxid, rofl::openflow::cofmsg *msg,
+                      const reply_t &reply, int timeout_in_secs) {
+  uint32_t xid = msg->get_xid();
+
+  /* register before sending, the reply may arrive before send_message()
+   * returns */
+  {
+    AcquireReadWriteLock rwlock(pending_replies_lock);
+    pending_replies[xid] = reply;
+  }
+
+  try {
+    rofl::crofsock::msg_result_t result;
+    if (timeout_in_secs > 0) {
+      result = rofchan.send_message(auxid, msg,
+                                    ctimespec().expire_in(timeout_in_secs));
+    } else {
+      result = rofchan.send_message(auxid, msg);
+    }
+
+    switch (result) {
+    case rofl::crofsock::MSG_QUEUEING_FAILED_QUEUE_FULL:
+    case rofl::crofsock::MSG_QUEUEING_FAILED_NOT_ESTABLISHED:
+    case rofl::crofsock::MSG_QUEUEING_FAILED_SHUTDOWN_IN_PROGRESS: {
+      AcquireReadWriteLock rwlock(pending_replies_lock);
+      pending_replies.erase(xid);
+    } break;
+    default: {};
+    }
+    return result;
+
+  } catch (eRofConnNotConnected &e) {
+    VLOG(1) << __FUNCTION__ << " dropping mesage " << e.what();
+    {
+      AcquireReadWriteLock rwlock(pending_replies_lock);
+      pending_replies.erase(xid);
+    }
+    delete msg;
+    throw;
+  } catch (eRofQueueFull &e) {
+    VLOG(1) << __FUNCTION__ << " dropping mesage " << e.what();
+    {
+      AcquireReadWriteLock rwlock(pending_replies_lock);
+      pending_replies.erase(xid);
+    }
+    delete msg;
+    throw;
+  }
+}
+
+crofdpt::reply_future_t
+crofdpt::send_async_request(const rofl::cauxid &auxid,
+                            rofl::openflow::cofmsg *msg, int timeout_in_secs) {
+  reply_future_t future;
+  switch (send_request(auxid, msg, make_reply_fn(future), timeout_in_secs)) {
+  case rofl::crofsock::MSG_QUEUEING_FAILED_QUEUE_FULL: {
+    throw eRofQueueFull("crofdpt::send_async_request() tx queue full",
+                        __FILE__, __FUNCTION__, __LINE__);
+  };
+  case rofl::crofsock::MSG_QUEUEING_FAILED_NOT_ESTABLISHED:
+  case rofl::crofsock::MSG_QUEUEING_FAILED_SHUTDOWN_IN_PROGRESS: {
+    throw eRofConnNotConnected("crofdpt::send_async_request() not connected",
+                               __FILE__, __FUNCTION__, __LINE__);
+  };
+  default: {};
+  }
+  return future;
+}
+
+crofdpt::reply_t crofdpt::make_reply_fn(const reply_cb_t &cb, uint32_t xid) {
+  reply_t reply;
+  reply.fn = [this, cb, xid](std::unique_ptr<rofl::openflow::cofmsg> msg) {
+    try {
+      cb(*this, xid, msg.get());
+    } catch (rofl::exception &e) {
+      VLOG(1) << __FUNCTION__ << " error: " << e.what();
+    } catch (std::runtime_error &e) {
+      VLOG(1) << __FUNCTION__ << " runtime error: " << e.what();
+    }
+  };
+  reply.each_segment = true;
+  return reply;
+}
+
+crofdpt::reply_t crofdpt::make_reply_fn(reply_future_t &future) {
+  auto promise =
+      std::make_shared<std::promise<std::unique_ptr<rofl::openflow::cofmsg>>>();
+  future = promise->get_future();
+  reply_t reply;
+  reply.fn = [promise](std::unique_ptr<rofl::openflow::cofmsg> msg) {
+    promise->set_value(std::move(msg));
+  };
+  reply.each_segment = false;
+  return reply;
+}
+
+bool crofdpt::reply_rcvd(const rofl::cauxid &auxid,
+                         rofl::openflow::cofmsg *msg) {
+  switch (msg->get_type()) {
+  /* asynchronous messages, type codes are identical in OpenFlow 1.0-1.3 */
+  case rofl::openflow13::OFPT_PACKET_IN:
+  case rofl::openflow13::OFPT_FLOW_REMOVED:
+  case rofl::openflow13::OFPT_PORT_STATUS:
+    return false;
+  default: {};
+  }
+
+  /* segment of a streamed multipart reply? */
+  bool streamed = false, last = true;
+  if ((msg->get_version() >= rofl::openflow13::OFP_VERSION) &&
+      (msg->get_type() == rofl::openflow13::OFPT_MULTIPART_REPLY)) {
+    rofl::openflow::cofmsg_stats_reply *stats =
+        dynamic_cast<rofl::openflow::cofmsg_stats_reply *>(msg);
+    if (stats != nullptr) {
+      streamed = get_multipart_streaming(stats->get_stats_type());
+      last = not(stats->get_stats_flags() &
+                 rofl::openflow13::OFPMPF_REPLY_MORE);
+    }
+  }
+
+  reply_fn_t fn;
+  bool each_segment = false;
+  {
+    AcquireReadWriteLock rwlock(pending_replies_lock);
+    if (pending_replies.empty()) {
+      return false;
+    }
+    auto it = pending_replies.find(msg->get_xid());
+    if (it == pending_replies.end()) {
+      return false;
+    }
+    each_segment = it->second.each_segment;
+    if (streamed && each_segment) {
+      /* callbacks consume each segment, the final one completes the
+       * request */
+      fn = it->second.fn;
+      if (last) {
+        pending_replies.erase(it);
+      }
+    } else if (not last) {
+      /* segments for the segment handlers */
+      return false;
+    } else {
+      fn = std::move(it->second.fn);
+      pending_replies.erase(it);
+    }
+  }
+
+  /* the final segment of a streamed reply reaches the segment handlers
+   * before completing a future */
+  if (streamed && last && not each_segment) {
+    try {
+      multipart_segment_rcvd(auxid, msg);
+    } catch (rofl::exception &e) {
+      VLOG(1) << __FUNCTION__ << " error: " << e.what();
+    } catch (std::runtime_error &e) {
+      VLOG(1) << __FUNCTION__ << " runtime error: " << e.what();
+    }
+  }
+
+  fn(std::unique_ptr<rofl::openflow::cofmsg>(msg));
+  return true;
+}
+
+bool crofdpt::reply_timeout(uint32_t xid) {
+  reply_fn_t fn;
+  {
+    AcquireReadWriteLock rwlock(pending_replies_lock);
+    auto it = pending_replies.find(xid);
+    if (it == pending_replies.end()) {
+      return false;
+    }
+    fn = std::move(it->second.fn);
+    pending_replies.erase(it);
+  }
+
+  fn(nullptr);
+  return true;
+}
+
+void crofdpt::flush_pending_replies() {
+  std::unordered_map<uint32_t, reply_t> replies;
+  {
+    AcquireReadWriteLock rwlock(pending_replies_lock);
+    replies.swap(pending_replies);
+  }
+
+  for (auto &it : replies) {
+    it.second.fn(nullptr);
+  }
+}
@@ -16,11 +16,16 @@
 #include <algorithm>
 #include <atomic>
 #include <bitset>
+#include <functional>
+#include <future>
 #include <inttypes.h>
 #include <map>
+#include <memory>
 #include <set>
 #include <stdio.h>
 #include <strings.h>
+#include <unordered_map>
+#include <vector>
 
 #include "rofl/common/cmemory.h"
 
@@ -129,6 +134,15 @@ protected:
    */
   virtual void handle_established(crofdpt &dpt, uint8_t ofp_version){};
 
+  /**
+   * @brief	Called after the OpenFlow datapath identifier of a datapath
+   * instance has changed.
+   *
+   * @param dpt datapath instance
+   * @param old_dpid previous datapath identifier
+   */
+  virtual void handle_dpid_changed(crofdpt &dpt, const rofl::cdpid &old_dpid){};
+
   /**
    * @brief 	Called when the control channel has been closed by the peer
    * entity.
@@ -327,6 +341,23 @@ protected:
   virtual void handle_stats_reply_timeout(rofl::crofdpt &dpt, uint32_t xid,
                                           uint8_t stats_type){};
 
+  /**
+   * @brief	OpenFlow Stats-Reply segment received.
+   *
+   * Called for each segment of a streamed multipart reply without a
+   * dedicated segment handler, see rofl::crofdpt::set_multipart_streaming().
+   * msg is an instance of the reply class specific to its stats type.
+   *
+   * @param dpt datapath instance
+   * @param auxid control connection identifier
+   * @param msg OpenFlow message instance carrying this segment's entries
+   * @param last true for the final segment of this reply
+   */
+  virtual void
+  handle_stats_reply_segment(rofl::crofdpt &dpt, const rofl::cauxid &auxid,
+                             rofl::openflow::cofmsg_stats_reply &msg,
+                             bool last){};
+
   /**
    * @brief	OpenFlow Desc-Stats-Reply message received.
    *
@@ -423,6 +454,22 @@ protected:
   virtual void handle_flow_stats_reply_timeout(rofl::crofdpt &dpt,
                                                uint32_t xid){};
 
+  /**
+   * @brief	OpenFlow Flow-Stats-Reply segment received.
+   *
+   * Called instead of handle_flow_stats_reply() for each segment as it
+   * arrives if streaming of Flow-Stats-Replies is enabled, see
+   * rofl::crofdpt::set_multipart_streaming().
+   *
+   * @param dpt datapath instance
+   * @param auxid control connection identifier
+   * @param msg OpenFlow message instance carrying this segment's entries
+   * @param last true for the final segment of this reply
+   */
+  virtual void handle_flow_stats_reply_segment(
+      rofl::crofdpt &dpt, const rofl::cauxid &auxid,
+      rofl::openflow::cofmsg_flow_stats_reply &msg, bool last){};
+
   /**
    * @brief	OpenFlow Aggregate-Stats-Reply message received.
    *
@@ -940,6 +987,45 @@ public:
     return *this;
   };
 
+  /**
+   * @brief	Returns true if multipart replies of stats_type are streamed
+   */
+  bool get_multipart_streaming(uint16_t stats_type) const {
+    return (stats_type < 32) &&
+           (rofchan.get_multipart_streaming() & (1U << stats_type));
+  };
+
+  /**
+   * @brief	Enables/disables streaming of multipart replies of stats_type
+   *
+   * Segments of a streamed multipart reply are passed to
+   * crofdpt_env::handle_flow_stats_reply_segment() or
+   * crofdpt_env::handle_stats_reply_segment() as they arrive instead of
+   * being reassembled and passed to the regular reply handler, so memory
+   * is bounded by a single segment. A callback bound to a streamed
+   * request is called for each segment instead, a future bound to a
+   * streamed request completes with the final segment once it has been
+   * passed to the segment handler.
+   *
+   * @param stats_type multipart type (OFPMP_*), below 32
+   * @param enable enable or disable streaming
+   * @exception rofl::eRofDptBase invalid stats_type
+   */
+  crofdpt &set_multipart_streaming(uint16_t stats_type, bool enable = true) {
+    if (stats_type >= 32) {
+      throw eRofDptBase(
+          "crofdpt::set_multipart_streaming() invalid stats type");
+    }
+    uint32_t stats_types = rofchan.get_multipart_streaming();
+    if (enable) {
+      stats_types |= (1U << stats_type);
+    } else {
+      stats_types &= ~(1U << stats_type);
+    }
+    rofchan.set_multipart_streaming(stats_types);
+    return *this;
+  };
+
   /**
    * @brief	Returns OpenFlow datapath identifier for this instance
    *
@@ -947,6 +1033,16 @@ public:
    */
   const rofl::cdpid &get_dpid() const { return dpid; };
 
+  /**
+   * @brief	Sets OpenFlow datapath identifier for this instance
+   *
+   * The datapath identifier is learned from the control connections, so
+   * there is usually no need to call this method.
+   *
+   * @param dpid OpenFlow datapath identifier
+   */
+  crofdpt &set_dpid(const rofl::cdpid &dpid);
+
   /**
    *
    */
@@ -1090,7 +1186,7 @@ public:
    */
   crofconn &add_conn(crofconn *conn) {
     if (nullptr != conn) {
-      dpid = cdpid(conn->get_dpid());
+      set_dpid(cdpid(conn->get_dpid()));
     }
     return rofchan.add_conn(conn);
   };
@@ -1421,6 +1517,52 @@ public:
       const rofl::openflow::cofactions &actions, uint8_t *data = NULL,
       size_t datalen = 0, uint32_t *xid = nullptr);
 
+  /**
+   * @brief	Sends OpenFlow Packet-Out message without copying the frame.
+   *
+   * The frame is referenced by the message until it has been handed over
+   * to the kernel, where it is attached to the packed header and actions
+   * as a separate iovec. On TLS connections, it is copied once into the
+   * transmission buffer. The frame must not be modified meanwhile; for a
+   * caller-owned buffer, pass a std::shared_ptr with a no-op deleter and
+   * keep the buffer alive until the Packet-Out has been sent.
+   *
+   * @param auxid controller connection identifier
+   * @param buffer_id OpenFlow packet buffer identifier
+   * @param in_port incoming port for OpenFlow matches
+   * @param actions OpenFlow actions list
+   * @param frame packet frame shared with the caller
+   * @return OpenFlow transaction ID assigned to this request
+   * @exception rofl::eRofBaseNotConnected
+   * @exception rofl::eRofBaseCongested
+   */
+  rofl::crofsock::msg_result_t send_packet_out_message(
+      const rofl::cauxid &auxid, uint32_t buffer_id, uint32_t in_port,
+      const rofl::openflow::cofactions &actions,
+      const std::shared_ptr<const rofl::cmemory> &frame,
+      uint32_t *xid = nullptr);
+
+  /**
+   * @brief	Sends OpenFlow Packet-Out message, never throws.
+   *
+   * Failures are reported via the returned msg_result_t only, e.g.
+   * MSG_QUEUEING_FAILED_NOT_ESTABLISHED or MSG_QUEUEING_FAILED_QUEUE_FULL.
+   */
+  rofl::crofsock::msg_result_t try_send_packet_out_message(
+      const rofl::cauxid &auxid, uint32_t buffer_id, uint32_t in_port,
+      const rofl::openflow::cofactions &actions, uint8_t *data = NULL,
+      size_t datalen = 0, uint32_t *xid = nullptr);
+
+  /**
+   * @brief	Sends OpenFlow Packet-Out message without copying the frame,
+   * never throws.
+   */
+  rofl::crofsock::msg_result_t try_send_packet_out_message(
+      const rofl::cauxid &auxid, uint32_t buffer_id, uint32_t in_port,
+      const rofl::openflow::cofactions &actions,
+      const std::shared_ptr<const rofl::cmemory> &frame,
+      uint32_t *xid = nullptr);
+
   /**
    * @brief	Sends OpenFlow Barrier-Request message to attached datapath
    * element.
@@ -1465,6 +1607,75 @@ public:
                         const rofl::openflow::cofflowmod &flowmod,
                         uint32_t *xid = nullptr);
 
+  /**
+   * @brief	Sends OpenFlow Flow-Mod message from a pre-packed template.
+   *
+   * The template body is copied into the outgoing message, no cofmatch,
+   * cofinstructions or cofactions are built or packed.
+   *
+   * @param auxid controller connection identifier
+   * @param tmpl Flow-Mod template, version must match the connection
+   * @return OpenFlow transaction ID assigned to this request
+   * @exception rofl::eRofBaseNotConnected
+   * @exception rofl::eRofBaseCongested
+   */
+  rofl::crofsock::msg_result_t
+  send_flow_mod_message(const rofl::cauxid &auxid,
+                        const rofl::openflow::cofflowmod_template &tmpl,
+                        uint32_t *xid = nullptr);
+
+  /**
+   * @brief	Sends OpenFlow Flow-Mod message, never throws.
+   *
+   * Failures are reported via the returned msg_result_t only.
+   */
+  rofl::crofsock::msg_result_t
+  try_send_flow_mod_message(const rofl::cauxid &auxid,
+                            const rofl::openflow::cofflowmod &flowmod,
+                            uint32_t *xid = nullptr);
+
+  /**
+   * @brief	Sends a batch of OpenFlow Flow-Mod messages to attached
+   * datapath element.
+   *
+   * All Flow-Mods are serialised into a single wire buffer, which is
+   * queued and sent as one unit. Flow-Mods get consecutive transaction
+   * IDs, an optional trailing Barrier-Request gets the last one and is
+   * tracked like send_barrier_request(). A batch occupies the connection
+   * until it has been sent, so split bulk installations into batches of
+   * a few thousand entries.
+   *
+   * @param auxid controller connection identifier
+   * @param flowmods array of OpenFlow flow mod entries
+   * @param num number of entries in flowmods
+   * @param barrier append a Barrier-Request to this batch
+   * @param first_xid OpenFlow transaction ID of the first message
+   * @param last_xid OpenFlow transaction ID of the last message
+   * @param timeout_in_secs timeout for the Barrier-Request
+   * @exception rofl::eRofBaseNotConnected
+   * @exception rofl::eRofBaseCongested
+   */
+  rofl::crofsock::msg_result_t
+  send_flow_mod_batch(const rofl::cauxid &auxid,
+                      const rofl::openflow::cofflowmod *flowmods, size_t num,
+                      bool barrier = false, uint32_t *first_xid = nullptr,
+                      uint32_t *last_xid = nullptr,
+                      int timeout_in_secs = DEFAULT_REQUEST_TIMEOUT);
+
+  /**
+   * @brief	Sends a batch of OpenFlow Flow-Mod messages to attached
+   * datapath element.
+   */
+  rofl::crofsock::msg_result_t
+  send_flow_mod_batch(const rofl::cauxid &auxid,
+                      const std::vector<rofl::openflow::cofflowmod> &flowmods,
+                      bool barrier = false, uint32_t *first_xid = nullptr,
+                      uint32_t *last_xid = nullptr,
+                      int timeout_in_secs = DEFAULT_REQUEST_TIMEOUT) {
+    return send_flow_mod_batch(auxid, flowmods.data(), flowmods.size(),
+                               barrier, first_xid, last_xid, timeout_in_secs);
+  };
+
   /**
    * @brief	Sends OpenFlow Group-Mod message to attached datapath element.
    *
@@ -1629,6 +1840,172 @@ public:
 
   /**@}*/
 
+public:
+  /**
+   * @name	Methods for pipelined requests
+   *
+   * Requests sent via these methods deliver their reply to a callback or
+   * future bound to the request's xid instead of the respective
+   * rofl::crofdpt_env handler. Any number of requests may be outstanding at
+   * the same time, replies are matched in constant time.
+   *
+   * The reply is nullptr if the request timed out or the control channel
+   * was closed before the reply arrived. A timeout of 0 seconds never
+   * expires. An OpenFlow Error message sent in response to a request is
+   * delivered as its reply. See set_multipart_streaming() for streamed
+   * multipart replies, whose timeout restarts with each segment.
+   */
+
+  /**@{*/
+
+  /**
+   * @brief	Callback for a reply, msg is valid during the call only
+   */
+  typedef std::function<void(rofl::crofdpt &dpt, uint32_t xid,
+                             rofl::openflow::cofmsg *msg)>
+      reply_cb_t;
+
+  /**
+   * @brief	Future for a reply, the future owns the reply message
+   *
+   * Futures outstanding when this rofl::crofdpt instance is destroyed are
+   * broken.
+   */
+  typedef std::future<std::unique_ptr<rofl::openflow::cofmsg>> reply_future_t;
+
+  /**
+   * @brief	Returns number of requests waiting for a callback or future
+   */
+  size_t get_pending_replies() const {
+    AcquireReadLock rlock(pending_replies_lock);
+    return pending_replies.size();
+  };
+
+  /**
+   * @brief	Sends OpenFlow Barrier-Request message and calls cb with the
+   * Barrier-Reply.
+   *
+   * @param auxid controller connection identifier
+   * @param cb callback receiving the reply
+   * @param timeout_in_secs timeout for this request
+   * @param xid OpenFlow transaction ID assigned to this request
+   * @exception rofl::eRofBaseNotConnected
+   * @exception rofl::eRofBaseCongested
+   */
+  rofl::crofsock::msg_result_t
+  send_barrier_request(const rofl::cauxid &auxid, const reply_cb_t &cb,
+                       int timeout_in_secs = DEFAULT_REQUEST_TIMEOUT,
+                       uint32_t *xid = nullptr);
+
+  /**
+   * @brief	Sends OpenFlow Barrier-Request message and returns a future
+   * for the Barrier-Reply.
+   *
+   * @exception rofl::eRofConnNotConnected
+   * @exception rofl::eRofQueueFull request could not be queued, retry later
+   */
+  reply_future_t
+  async_barrier_request(const rofl::cauxid &auxid,
+                        int timeout_in_secs = DEFAULT_REQUEST_TIMEOUT,
+                        uint32_t *xid = nullptr);
+
+  /**
+   * @brief	Sends OpenFlow Desc-Stats-Request message and calls cb with
+   * the Desc-Stats-Reply.
+   */
+  rofl::crofsock::msg_result_t
+  send_desc_stats_request(const rofl::cauxid &auxid, uint16_t stats_flags,
+                          const reply_cb_t &cb,
+                          int timeout_in_secs = DEFAULT_REQUEST_TIMEOUT,
+                          uint32_t *xid = nullptr);
+
+  /**
+   * @brief	Sends OpenFlow Desc-Stats-Request message and returns a future
+   * for the Desc-Stats-Reply.
+   */
+  reply_future_t
+  async_desc_stats_request(const rofl::cauxid &auxid, uint16_t stats_flags = 0,
+                           int timeout_in_secs = DEFAULT_REQUEST_TIMEOUT,
+                           uint32_t *xid = nullptr);
+
+  /**
+   * @brief	Sends OpenFlow Flow-Stats-Request message and calls cb with
+   * the Flow-Stats-Reply.
+   */
+  rofl::crofsock::msg_result_t send_flow_stats_request(
+      const rofl::cauxid &auxid, uint16_t stats_flags,
+      const rofl::openflow::cofflow_stats_request &flow_stats_request,
+      const reply_cb_t &cb, int timeout_in_secs = DEFAULT_REQUEST_TIMEOUT,
+      uint32_t *xid = nullptr);
+
+  /**
+   * @brief	Sends OpenFlow Flow-Stats-Request message and returns a future
+   * for the Flow-Stats-Reply.
+   */
+  reply_future_t async_flow_stats_request(
+      const rofl::cauxid &auxid, uint16_t stats_flags,
+      const rofl::openflow::cofflow_stats_request &flow_stats_request,
+      int timeout_in_secs = DEFAULT_REQUEST_TIMEOUT, uint32_t *xid = nullptr);
+
+  /**
+   * @brief	Sends OpenFlow Aggregate-Stats-Request message and calls cb
+   * with the Aggregate-Stats-Reply.
+   */
+  rofl::crofsock::msg_result_t send_aggr_stats_request(
+      const rofl::cauxid &auxid, uint16_t stats_flags,
+      const rofl::openflow::cofaggr_stats_request &aggr_stats_request,
+      const reply_cb_t &cb, int timeout_in_secs = DEFAULT_REQUEST_TIMEOUT,
+      uint32_t *xid = nullptr);
+
+  /**
+   * @brief	Sends OpenFlow Aggregate-Stats-Request message and returns a
+   * future for the Aggregate-Stats-Reply.
+   */
+  reply_future_t async_aggr_stats_request(
+      const rofl::cauxid &auxid, uint16_t stats_flags,
+      const rofl::openflow::cofaggr_stats_request &aggr_stats_request,
+      int timeout_in_secs = DEFAULT_REQUEST_TIMEOUT, uint32_t *xid = nullptr);
+
+  /**
+   * @brief	Sends OpenFlow Table-Stats-Request message and calls cb with
+   * the Table-Stats-Reply.
+   */
+  rofl::crofsock::msg_result_t
+  send_table_stats_request(const rofl::cauxid &auxid, uint16_t stats_flags,
+                           const reply_cb_t &cb,
+                           int timeout_in_secs = DEFAULT_REQUEST_TIMEOUT,
+                           uint32_t *xid = nullptr);
+
+  /**
+   * @brief	Sends OpenFlow Table-Stats-Request message and returns a
+   * future for the Table-Stats-Reply.
+   */
+  reply_future_t
+  async_table_stats_request(const rofl::cauxid &auxid, uint16_t stats_flags = 0,
+                            int timeout_in_secs = DEFAULT_REQUEST_TIMEOUT,
+                            uint32_t *xid = nullptr);
+
+  /**
+   * @brief	Sends OpenFlow Port-Stats-Request message and calls cb with
+   * the Port-Stats-Reply.
+   */
+  rofl::crofsock::msg_result_t send_port_stats_request(
+      const rofl::cauxid &auxid, uint16_t stats_flags,
+      const rofl::openflow::cofport_stats_request &port_stats_request,
+      const reply_cb_t &cb, int timeout_in_secs = DEFAULT_REQUEST_TIMEOUT,
+      uint32_t *xid = nullptr);
+
+  /**
+   * @brief	Sends OpenFlow Port-Stats-Request message and returns a future
+   * for the Port-Stats-Reply.
+   */
+  reply_future_t async_port_stats_request(
+      const rofl::cauxid &auxid, uint16_t stats_flags,
+      const rofl::openflow::cofport_stats_request &port_stats_request,
+      int timeout_in_secs = DEFAULT_REQUEST_TIMEOUT, uint32_t *xid = nullptr);
+
+  /**@}*/
+
 public:
   /**
    * @brief 	Predicate for finding a rofl::crofdpt instance by its
@@ -1686,6 +2063,7 @@ private:
   virtual void handle_closed(crofchan &chan) {
     if (delete_in_progress())
       return;
+    flush_pending_replies();
     crofdpt_env::call_env(env).handle_closed(*this);
   };
 
@@ -1746,6 +2124,36 @@ private:
   virtual void handle_recv(rofl::crofchan &chan, rofl::crofconn &conn,
                            rofl::openflow::cofmsg *msg);
 
+private:
+  // consumes a reply, takes ownership of msg, nullptr on timeout or close
+  typedef std::function<void(std::unique_ptr<rofl::openflow::cofmsg> msg)>
+      reply_fn_t;
+
+  struct reply_t {
+    reply_fn_t fn;
+    // fn consumes each segment of a streamed multipart reply
+    bool each_segment;
+  };
+
+  rofl::crofsock::msg_result_t send_request(const rofl::cauxid &auxid,
+                                            rofl::openflow::cofmsg *msg,
+                                            const reply_t &reply,
+                                            int timeout_in_secs);
+
+  reply_future_t send_async_request(const rofl::cauxid &auxid,
+                                    rofl::openflow::cofmsg *msg,
+                                    int timeout_in_secs);
+
+  reply_t make_reply_fn(const reply_cb_t &cb, uint32_t xid);
+
+  reply_t make_reply_fn(reply_future_t &future);
+
+  bool reply_rcvd(const rofl::cauxid &auxid, rofl::openflow::cofmsg *msg);
+
+  bool reply_timeout(uint32_t xid);
+
+  void flush_pending_replies();
+
 private:
   void experimenter_rcvd(const rofl::cauxid &auxid,
                          rofl::openflow::cofmsg *msg);
@@ -1811,6 +2219,9 @@ private:
 
   void port_mod_sent(rofl::openflow::cofmsg *pack);
 
+  void multipart_segment_rcvd(const rofl::cauxid &auxid,
+                              rofl::openflow::cofmsg *msg);
+
   void packet_in_rcvd(const rofl::cauxid &auxid, rofl::openflow::cofmsg *msg);
 
   void flow_removed_rcvd(const rofl::cauxid &auxid,
@@ -1855,6 +2266,12 @@ private:
   // default request timeout
   static const time_t DEFAULT_REQUEST_TIMEOUT = 0; // seconds (0 : no timeout)
 
+  // requests waiting for a callback or future indexed by xid
+  std::unordered_map<uint32_t, reply_t> pending_replies;
+
+  // .. and associated rwlock
+  crwlock pending_replies_lock;
+
   // datapath identifier
   rofl::cdpid dpid;
 
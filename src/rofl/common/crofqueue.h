@@ -8,9 +8,13 @@
 #ifndef CROFQUEUE_H_
 #define CROFQUEUE_H_
 
+#include <atomic>
 #include <list>
 #include <ostream>
+#include <sched.h>
+#include <utility>
 
+#include "rofl/common/cclock.hpp"
 #include "rofl/common/locking.hpp"
 #include "rofl/common/openflow/messages/cofmsg.h"
 
@@ -52,139 +56,357 @@ public:
   /**
    *
    */
-  crofqueue() : queue_max_size(QUEUE_MAX_SIZE_DEFAULT){};
+  crofqueue()
+      : ring(nullptr), ring_mask(0), ring_head(0), ring_tail(0),
+        ring_resizing(false), overflow_size(0), queue_size(0),
+        front_src(SRC_NONE), front_stored_ns(0),
+        queue_max_size(QUEUE_MAX_SIZE_DEFAULT) {
+    consumer_lock.clear();
+    ring_allocate(ring_size_for(QUEUE_MAX_SIZE_DEFAULT));
+  };
 
   /**
    *
    */
-  ~crofqueue() { clear(); };
+  ~crofqueue() {
+    clear();
+    delete[] ring;
+  };
+
+private:
+  crofqueue(const crofqueue &queue);
+
+  crofqueue &operator=(const crofqueue &queue);
 
 public:
   /**
    *
    */
-  bool empty() const {
-    AcquireReadLock rwlock(queue_lock);
-    return queue.empty();
-  };
+  bool empty() const { return (queue_size.load() == 0); };
 
   /**
    *
    */
-  size_t size() const {
-    AcquireReadLock rwlock(queue_lock);
-    return queue.size();
-  };
+  size_t size() const { return queue_size.load(); };
 
   /**
+   * @brief	Drops and deletes all messages stored in this queue.
    *
+   * May be called from any thread, calls are serialised with the consumer.
    */
   void clear() {
-    while (true) {
-      rofl::openflow::cofmsg *msg = nullptr;
-      {
-        AcquireReadWriteLock rwlock(queue_lock);
-        if (queue.empty()) {
-          return;
-        }
-        msg = queue.front();
-        queue.pop_front();
-      }
+    AcquireConsumerLock lock(consumer_lock);
+    rofl::openflow::cofmsg *msg = nullptr;
+    while ((msg = consumer_front()) != nullptr) {
+      consumer_pop();
       delete msg;
     }
   };
 
   /**
+   * @brief	Stores a message in this queue, safe for multiple producers.
+   *
+   * Lock-free unless the ring is full, in which case messages are
+   * appended to an overflow list until the consumer has drained it.
+   * Each message is timestamped for measuring its queueing latency.
    *
+   * @param msg message to be stored
+   * @param enforce store message even if queue max size has been reached
+   * @return number of messages in this queue
+   * @throws eRofQueueFull queue max size reached and enforce is false
    */
   size_t store(rofl::openflow::cofmsg *msg, bool enforce = false) {
-    AcquireReadWriteLock rwlock(queue_lock);
-    if ((not enforce) && (queue.size() >= queue_max_size)) {
+    size_t qsize = try_store(msg, enforce);
+    if (qsize == 0) {
       throw eRofQueueFull("crofqueue::store() queue max size exceeded",
                           __FILE__, __FUNCTION__, __LINE__);
     }
-    queue.push_back(msg);
-    return queue.size();
+    return qsize;
   };
 
   /**
+   * @brief	Stores a message in this queue like store(), but reports a
+   * full queue by its return value.
    *
+   * @param msg message to be stored, not taken over if the queue is full
+   * @param enforce store message even if queue max size has been reached
+   * @return number of messages in this queue or 0 if the queue is full
+   */
+  size_t try_store(rofl::openflow::cofmsg *msg, bool enforce = false) {
+    size_t qsize = queue_size.load();
+    if (enforce) {
+      qsize = queue_size.fetch_add(1) + 1;
+    } else {
+      do {
+        if (qsize >= queue_max_size.load()) {
+          return 0;
+        }
+      } while (not queue_size.compare_exchange_weak(qsize, qsize + 1));
+      qsize++;
+    }
+
+    /* preserve order: once messages were diverted to the overflow list,
+     * all producers use it until the consumer has drained it */
+    uint64_t stored_ns = now_ns();
+    if (ring_resizing.load() || (overflow_size.load() > 0) ||
+        (not ring_enqueue(msg, stored_ns))) {
+      AcquireReadWriteLock rwlock(overflow_lock);
+      overflow.push_back(overflow_entry_t(msg, stored_ns));
+      overflow_size++;
+    }
+    return qsize;
+  };
+
+  /**
+   * @brief	Removes and returns the first message, consumer only.
+   *
+   * @return first message or nullptr if queue is empty
    */
   rofl::openflow::cofmsg *retrieve() {
-    rofl::openflow::cofmsg *msg = (rofl::openflow::cofmsg *)0;
-    AcquireReadWriteLock rwlock(queue_lock);
-    if (queue.empty()) {
-      return msg;
+    AcquireConsumerLock lock(consumer_lock);
+    rofl::openflow::cofmsg *msg = consumer_front();
+    if (msg != nullptr) {
+      consumer_pop();
     }
-    msg = queue.front();
-    queue.pop_front();
     return msg;
   };
 
   /**
+   * @brief	Removes and returns the first message unless it exceeds
+   * max_length bytes, consumer only.
+   *
+   * Peeking and removing happen under the consumer lock, so clear() from
+   * another thread cannot delete the message in between.
    *
+   * @return first message or nullptr if queue is empty or the first
+   * message exceeds max_length
    */
-  rofl::openflow::cofmsg *front() {
-    rofl::openflow::cofmsg *msg = (rofl::openflow::cofmsg *)0;
-    AcquireReadWriteLock rwlock(queue_lock);
-    if (queue.empty()) {
-      return msg;
+  rofl::openflow::cofmsg *retrieve(size_t max_length) {
+    AcquireConsumerLock lock(consumer_lock);
+    rofl::openflow::cofmsg *msg = consumer_front();
+    if ((msg == nullptr) || (msg->length() > max_length)) {
+      return nullptr;
     }
-    msg = queue.front();
+    consumer_pop();
     return msg;
   };
 
   /**
+   * @brief	Returns length of the first message in bytes, consumer only.
    *
+   * The message itself is not handed out, clear() may drop it any time.
+   *
+   * @return length of first message or 0 if queue is empty
    */
-  void pop() {
-    AcquireReadWriteLock rwlock(queue_lock);
-    if (queue.empty()) {
-      return;
-    }
-    queue.pop_front();
+  size_t front_length() {
+    AcquireConsumerLock lock(consumer_lock);
+    rofl::openflow::cofmsg *msg = consumer_front();
+    return (msg == nullptr) ? 0 : msg->length();
   };
 
+  /**
+   * @brief	Returns time in nanoseconds the message last returned by
+   * retrieve() was stored, consumer only.
+   *
+   * See rofl::now_ns() for the clock used.
+   */
+  uint64_t get_stored_ns() const { return front_stored_ns; };
+
   /**
    *
    */
   size_t capacity() const {
-    AcquireReadLock rwlock(queue_lock);
-    return (queue.size() < queue_max_size) ? (queue_max_size - queue.size())
-                                           : 0;
+    size_t qsize = queue_size.load();
+    size_t qmax = queue_max_size.load();
+    return (qsize < qmax) ? (qmax - qsize) : 0;
   };
 
 public:
   /**
    *
    */
-  size_t get_queue_max_size() const { return queue_max_size; };
+  size_t get_queue_max_size() const { return queue_max_size.load(); };
 
   /**
+   * @brief	Sets the queue max size.
    *
+   * The ring is resized only while the queue is empty, producers storing
+   * messages meanwhile use the overflow list.
    */
   crofqueue &set_queue_max_size(size_t queue_max_size) {
     this->queue_max_size = queue_max_size;
+    AcquireConsumerLock lock(consumer_lock);
+    size_t ring_size = ring_size_for(queue_max_size);
+    if (ring_size != ring_mask + 1) {
+      ring_resizing = true;
+      /* producers reserve queue_size before touching the ring */
+      if (queue_size.load() == 0) {
+        delete[] ring;
+        ring_allocate(ring_size);
+      }
+      ring_resizing = false;
+    }
     return *this;
   };
 
 public:
   friend std::ostream &operator<<(std::ostream &os, const crofqueue &queue) {
-    AcquireReadLock rwlock(queue.queue_lock);
-    os << "<crofqueue size #" << queue.queue.size() << " >" << std::endl;
-
-    for (std::list<rofl::openflow::cofmsg *>::const_iterator it =
-             queue.queue.begin();
-         it != queue.queue.end(); ++it) {
-      os << *(*it);
+    os << "<crofqueue size #" << queue.size() << " >" << std::endl;
+    AcquireConsumerLock lock(queue.consumer_lock);
+    for (size_t pos = queue.ring_head.load(); pos != queue.ring_tail.load();
+         ++pos) {
+      const slot_t &slot = queue.ring[pos & queue.ring_mask];
+      if (slot.seq.load(std::memory_order_acquire) != pos + 1) {
+        break;
+      }
+      os << *(slot.msg);
+    }
+    AcquireReadLock rwlock(queue.overflow_lock);
+    for (auto &entry : queue.overflow) {
+      os << *(entry.first);
     }
     return os;
   };
 
 private:
-  std::list<rofl::openflow::cofmsg *> queue;
-  mutable crwlock queue_lock;
-  size_t queue_max_size;
+  class AcquireConsumerLock {
+    std::atomic_flag &flag;
+
+  public:
+    AcquireConsumerLock(std::atomic_flag &flag) : flag(flag) {
+      while (flag.test_and_set(std::memory_order_acquire)) {
+        sched_yield();
+      }
+    };
+    ~AcquireConsumerLock() { flag.clear(std::memory_order_release); };
+  };
+
+  struct slot_t {
+    std::atomic<size_t> seq;
+    rofl::openflow::cofmsg *msg;
+    uint64_t stored_ns;
+  };
+
+  typedef std::pair<rofl::openflow::cofmsg *, uint64_t> overflow_entry_t;
+
+  enum front_src_t {
+    SRC_NONE = 0,
+    SRC_RING = 1,
+    SRC_OVERFLOW = 2,
+  };
+
+  static size_t ring_size_for(size_t queue_max_size) {
+    size_t ring_size = RING_SIZE_MIN;
+    while ((ring_size < 2 * queue_max_size) && (ring_size < RING_SIZE_MAX)) {
+      ring_size <<= 1;
+    }
+    return ring_size;
+  };
+
+  void ring_allocate(size_t ring_size) {
+    ring = new slot_t[ring_size];
+    ring_mask = ring_size - 1;
+    for (size_t pos = 0; pos < ring_size; pos++) {
+      ring[pos].seq.store(pos, std::memory_order_relaxed);
+      ring[pos].msg = nullptr;
+      ring[pos].stored_ns = 0;
+    }
+    ring_head.store(0);
+    ring_tail.store(0);
+  };
+
+  /* bounded multi-producer ring, see D. Vyukov's bounded MPMC queue */
+  bool ring_enqueue(rofl::openflow::cofmsg *msg, uint64_t stored_ns) {
+    size_t pos = ring_tail.load(std::memory_order_relaxed);
+    while (true) {
+      slot_t &slot = ring[pos & ring_mask];
+      size_t seq = slot.seq.load(std::memory_order_acquire);
+      intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+      if (diff == 0) {
+        if (ring_tail.compare_exchange_weak(pos, pos + 1,
+                                            std::memory_order_relaxed)) {
+          slot.msg = msg;
+          slot.stored_ns = stored_ns;
+          slot.seq.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        return false; // ring is full
+      } else {
+        pos = ring_tail.load(std::memory_order_relaxed);
+      }
+    }
+  };
+
+  /* must be called with consumer_lock held */
+  rofl::openflow::cofmsg *consumer_front() {
+    size_t pos = ring_head.load(std::memory_order_relaxed);
+    slot_t &slot = ring[pos & ring_mask];
+    if (slot.seq.load(std::memory_order_acquire) == pos + 1) {
+      front_src = SRC_RING;
+      front_stored_ns = slot.stored_ns;
+      return slot.msg;
+    }
+    /* a producer has claimed but not yet filled the head slot */
+    if (pos != ring_tail.load()) {
+      front_src = SRC_NONE;
+      return nullptr;
+    }
+    if (overflow_size.load() > 0) {
+      AcquireReadLock rwlock(overflow_lock);
+      front_src = SRC_OVERFLOW;
+      front_stored_ns = overflow.front().second;
+      return overflow.front().first;
+    }
+    front_src = SRC_NONE;
+    return nullptr;
+  };
+
+  /* must be called with consumer_lock held, after consumer_front() */
+  void consumer_pop() {
+    switch (front_src) {
+    case SRC_RING: {
+      size_t pos = ring_head.load(std::memory_order_relaxed);
+      slot_t &slot = ring[pos & ring_mask];
+      slot.msg = nullptr;
+      slot.seq.store(pos + ring_mask + 1, std::memory_order_release);
+      ring_head.store(pos + 1, std::memory_order_relaxed);
+    } break;
+    case SRC_OVERFLOW: {
+      AcquireReadWriteLock rwlock(overflow_lock);
+      overflow.pop_front();
+      overflow_size--;
+    } break;
+    default: { return; };
+    }
+    front_src = SRC_NONE;
+    queue_size--;
+  };
+
+private:
+  // lock-free ring for the common case
+  slot_t *ring;
+  size_t ring_mask;
+  std::atomic<size_t> ring_head;
+  std::atomic<size_t> ring_tail;
+  std::atomic_bool ring_resizing;
+  static const size_t RING_SIZE_MIN = 16;
+  static const size_t RING_SIZE_MAX = 4096;
+
+  // overflow list for enforced messages when the ring is full
+  std::list<overflow_entry_t> overflow;
+  mutable crwlock overflow_lock;
+  std::atomic<size_t> overflow_size;
+
+  // number of messages stored in ring and overflow list
+  std::atomic<size_t> queue_size;
+
+  // serialises consumer side and clear() calls from other threads
+  mutable std::atomic_flag consumer_lock;
+  front_src_t front_src;
+  uint64_t front_stored_ns;
+
+  std::atomic<size_t> queue_max_size;
   static const size_t QUEUE_MAX_SIZE_DEFAULT = 128;
 };
 
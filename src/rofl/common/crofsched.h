@@ -0,0 +1,267 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * crofsched.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef CROFSCHED_H_
+#define CROFSCHED_H_
+
+#include <algorithm>
+#include <ostream>
+#include <stdint.h>
+#include <vector>
+
+#include "rofl/common/cclock.hpp"
+#include "rofl/common/exception.hpp"
+
+namespace rofl {
+
+/**
+ * @brief	Byte based deficit round robin scheduler for a set of queues
+ *
+ * Each queue earns its quantum in bytes per round and may dequeue
+ * messages as long as their length is covered by its deficit counter.
+ * Queues marked as strict priority are always served first and are not
+ * accounted. The scheduler does not own any queues, callers probe the
+ * head of a queue via a functor, see select().
+ *
+ * The scheduler is not thread safe and must be driven by a single
+ * consumer thread.
+ */
+class crofsched {
+public:
+  /**
+   *
+   */
+  crofsched(unsigned int num_queues, size_t quantum = QUANTUM_DEFAULT)
+      : queues(num_queues), sched_queue_id(0) {
+    for (auto &queue : queues) {
+      queue.quantum = quantum;
+    }
+    if (not queues.empty()) {
+      queues[0].deficit = queues[0].quantum;
+    }
+  };
+
+public:
+  /**
+   *
+   */
+  unsigned int get_num_queues() const { return queues.size(); };
+
+  /**
+   * @brief	Returns number of bytes a queue may send per round
+   */
+  size_t get_quantum(unsigned int queue_id) const {
+    return queue(queue_id).quantum;
+  };
+
+  /**
+   * @brief	Sets number of bytes a queue may send per round
+   *
+   * A message exceeding the quantum is sent once the queue has earned
+   * its length over several rounds.
+   */
+  crofsched &set_quantum(unsigned int queue_id, size_t quantum) {
+    queue(queue_id).quantum = std::max(quantum, (size_t)1);
+    return *this;
+  };
+
+  /**
+   * @brief	Returns sum of all quanta, i.e. the bytes of a full round
+   */
+  size_t get_round_bytes() const {
+    size_t bytes = 0;
+    for (auto &queue : queues) {
+      bytes += queue.quantum;
+    }
+    return bytes;
+  };
+
+  /**
+   *
+   */
+  bool get_strict_priority(unsigned int queue_id) const {
+    return queue(queue_id).strict;
+  };
+
+  /**
+   * @brief	Serves queue before all other queues whenever it is not empty
+   */
+  crofsched &set_strict_priority(unsigned int queue_id, bool strict = true) {
+    queue(queue_id).strict = strict;
+    return *this;
+  };
+
+public:
+  /**
+   * @brief	Selects the queue the next message is taken from
+   *
+   * The head of the returned queue must be dequeued and reported via
+   * dequeued(), or left in its queue for the next call.
+   *
+   * @param head_len functor returning the length of the first message in
+   * a queue or 0 if the queue is empty, the returned queue is the last one
+   * probed
+   * @return queue_id or get_num_queues() if all queues are empty
+   */
+  template <typename F> unsigned int select(F head_len) {
+    unsigned int num_queues = queues.size();
+    for (unsigned int queue_id = 0; queue_id < num_queues; queue_id++) {
+      if (queues[queue_id].strict && (head_len(queue_id) > 0)) {
+        return queue_id;
+      }
+    }
+
+    unsigned int num_idle = 0;
+    while (num_idle < num_queues) {
+      queue_t &queue = queues[sched_queue_id];
+      size_t len = 0;
+      if (queue.strict || ((len = head_len(sched_queue_id)) == 0)) {
+        /* an empty queue does not keep its deficit */
+        queue.deficit = 0;
+        next();
+        num_idle++;
+        continue;
+      }
+      num_idle = 0;
+      if (len <= queue.deficit) {
+        return sched_queue_id;
+      }
+      next();
+    }
+    return num_queues;
+  };
+
+  /**
+   * @brief	Accounts a message dequeued from queue_id
+   *
+   * @param msglen length of message in bytes
+   * @param stored_ns time the message was stored, see rofl::now_ns(), 0 if
+   * unknown
+   */
+  void dequeued(unsigned int queue_id, size_t msglen, uint64_t stored_ns = 0) {
+    queue_t &queue = queues[queue_id];
+    if (not queue.strict) {
+      queue.deficit -= std::min(msglen, queue.deficit);
+    }
+    queue.msgs++;
+    queue.bytes += msglen;
+    if (stored_ns > 0) {
+      uint64_t latency = now_ns() - stored_ns;
+      queue.latency_sum += latency;
+      queue.latency_max = std::max(queue.latency_max, latency);
+      queue.latency_msgs++;
+    }
+  };
+
+public:
+  /**
+   * @brief	Returns number of messages dequeued from queue_id
+   */
+  uint64_t get_msgs(unsigned int queue_id) const {
+    return queue(queue_id).msgs;
+  };
+
+  /**
+   * @brief	Returns number of bytes dequeued from queue_id
+   */
+  uint64_t get_bytes(unsigned int queue_id) const {
+    return queue(queue_id).bytes;
+  };
+
+  /**
+   * @brief	Returns average queueing latency in nanoseconds
+   */
+  uint64_t get_latency_avg(unsigned int queue_id) const {
+    const queue_t &q = queue(queue_id);
+    return (q.latency_msgs == 0) ? 0 : q.latency_sum / q.latency_msgs;
+  };
+
+  /**
+   * @brief	Returns maximum queueing latency in nanoseconds
+   */
+  uint64_t get_latency_max(unsigned int queue_id) const {
+    return queue(queue_id).latency_max;
+  };
+
+  /**
+   * @brief	Resets message, byte and latency counters of all queues
+   */
+  void clear_stats() {
+    for (auto &queue : queues) {
+      queue.msgs = queue.bytes = 0;
+      queue.latency_sum = queue.latency_max = queue.latency_msgs = 0;
+    }
+  };
+
+public:
+  friend std::ostream &operator<<(std::ostream &os, const crofsched &sched) {
+    os << "<crofsched #queues: " << sched.queues.size() << " >" << std::endl;
+    for (unsigned int queue_id = 0; queue_id < sched.queues.size();
+         queue_id++) {
+      os << "<queue " << queue_id
+         << " quantum: " << sched.get_quantum(queue_id)
+         << " strict: " << sched.get_strict_priority(queue_id)
+         << " msgs: " << sched.get_msgs(queue_id)
+         << " bytes: " << sched.get_bytes(queue_id)
+         << " latency avg: " << sched.get_latency_avg(queue_id)
+         << "ns max: " << sched.get_latency_max(queue_id) << "ns >"
+         << std::endl;
+    }
+    return os;
+  };
+
+private:
+  struct queue_t {
+    queue_t()
+        : quantum(0), deficit(0), strict(false), msgs(0), bytes(0),
+          latency_sum(0), latency_max(0), latency_msgs(0){};
+    size_t quantum;
+    size_t deficit;
+    bool strict;
+    uint64_t msgs;
+    uint64_t bytes;
+    uint64_t latency_sum;
+    uint64_t latency_max;
+    uint64_t latency_msgs;
+  };
+
+  const queue_t &queue(unsigned int queue_id) const {
+    if (queue_id >= queues.size())
+      throw eInvalid("crofsched::queue() invalid queue_id", __FILE__,
+                     __FUNCTION__, __LINE__);
+    return queues[queue_id];
+  };
+
+  queue_t &queue(unsigned int queue_id) {
+    if (queue_id >= queues.size())
+      throw eInvalid("crofsched::queue() invalid queue_id", __FILE__,
+                     __FUNCTION__, __LINE__);
+    return queues[queue_id];
+  };
+
+  /* start a new turn for the next queue */
+  void next() {
+    sched_queue_id = (sched_queue_id + 1) % queues.size();
+    queues[sched_queue_id].deficit += queues[sched_queue_id].quantum;
+  };
+
+private:
+  // scheduling state and counters per queue
+  std::vector<queue_t> queues;
+
+  // queue whose turn it currently is
+  unsigned int sched_queue_id;
+
+  static const size_t QUANTUM_DEFAULT = 4096;
+};
+
+}; // end of namespace rofl
+
+#endif /* CROFSCHED_H_ */
@@ -21,9 +21,13 @@ using namespace rofl;
 
 crofsock::~crofsock() {
   flag_set(FLAG_DELETE_IN_PROGRESS, true);
+  replay_wakeup();
   cthread::thread(tx_thread_num).drop(this);
   cthread::thread(rx_thread_num).drop(this);
   close();
+  release_tx_payloads();
+  tls_drop_session();
+  ctlscontext::release(ctx);
 }
 
 crofsock::crofsock(crofsock_env *env)
@@ -33,21 +37,28 @@ crofsock::crofsock(crofsock_env *env)
       reconnect_backoff_max(60 /*secs*/), reconnect_backoff_start(1 /*secs*/),
       reconnect_backoff_current(1 /*secs*/), reconnect_counter(0), sd(-1),
       domain(AF_INET), type(SOCK_STREAM), protocol(IPPROTO_TCP), backlog(64),
-      ctx(NULL), ssl(NULL), bio(NULL), capath("."), cafile("ca.pem"),
+      ctx(NULL), tls_session(NULL), tls_session_reuse(true), ssl(NULL),
+      bio(NULL), capath("."), cafile("ca.pem"),
       certfile("crt.pem"), keyfile("key.pem"), password(""),
       verify_mode("PEER"), verify_depth("1"),
       ciphers("EECDH+ECDSA+AESGCM EECDH+aRSA+AESGCM EECDH+ECDSA+SHA256 "
               "EECDH+aRSA+RC4 EDH+aRSA EECDH RC4 !aNULL !eNULL !LOW !3DES !MD5 "
               "!EXP !PSK !SRP !DSS"),
-      rxbuffer((size_t)65536), rx_disabled(false), txbuffer((size_t)65536),
-      tx_disabled(false), tx_is_running(false), txqueue_pending_pkts(0),
-      txqueue_size_congestion_occurred(0), txqueue_size_tx_threshold(0),
-      txqueues(QUEUE_MAX), txweights(QUEUE_MAX) {
-  /* scheduler weights for transmission */
-  txweights[QUEUE_OAM] = 16;
-  txweights[QUEUE_MGMT] = 32;
-  txweights[QUEUE_FLOW] = 16;
-  txweights[QUEUE_PKT] = 8;
+      rxbuffer((size_t)65536), rx_mode(RX_MODE_MESSAGE), rx_syscalls(0),
+      rx_messages(0), rx_disabled(false), capture(nullptr),
+      txbuffer((size_t)65536),
+      tx_disabled(false), tx_is_running(false),
+      tx_batch_bytes(TX_BATCH_BYTES_DEFAULT),
+      tx_batch_usecs(TX_BATCH_USECS_DEFAULT), tx_batch_msgs(0),
+      tx_payloads_bytes(0), tx_payloads_sent(0),
+      txsched(QUEUE_MAX), tx_syscalls(0), tx_messages(0),
+      txqueue_pending_pkts(0), txqueue_size_congestion_occurred(0),
+      txqueue_size_tx_threshold(0), txqueues(QUEUE_MAX) {
+  /* scheduler quanta for transmission in bytes */
+  txsched.set_strict_priority(QUEUE_OAM);
+  txsched.set_quantum(QUEUE_MGMT, 16384);
+  txsched.set_quantum(QUEUE_FLOW, 8192);
+  txsched.set_quantum(QUEUE_PKT, 4096);
   VLOG(1) << __FUNCTION__ << " "
           << "RX thread: " << cthread::thread(rx_thread_num).get_thread_name()
           << " "
@@ -91,8 +102,6 @@ void crofsock::close() {
     VLOG(6) << __FUNCTION__ << " STATE_TLS_ESTABLISHED sd=" << sd
             << " laddr=" << laddr.str() << " raddr=" << raddr.str();
 
-    AcquireReadWriteLock lock(sslock);
-
     if (ssl) {
       int rc = 0;
       int err_code = 0;
@@ -221,11 +230,14 @@ void crofsock::close() {
     rx_disable();
     tx_disable();
 
-    cthread::thread(rx_thread_num).drop_read_fd(sd, false);
-    if (flag_test(FLAG_CONGESTED)) {
-      cthread::thread(tx_thread_num).drop_write_fd(sd);
+    /* replayed sessions have no socket descriptor */
+    if (sd > 0) {
+      cthread::thread(rx_thread_num).drop_read_fd(sd, false);
+      if (flag_test(FLAG_CONGESTED)) {
+        cthread::thread(tx_thread_num).drop_write_fd(sd);
+      }
+      shutdown(sd, O_RDWR);
     }
-    shutdown(sd, O_RDWR);
 
     /* allow socket to send shutdown notification to peer */
     /* sleep(1); // use SO_LINGER option instead */
@@ -254,7 +266,11 @@ void crofsock::close() {
     rx_disabled = false;
     tx_disabled = false;
 
+    flag_set(FLAG_REPLAY, false);
+
     flag_set(FLAG_CLOSING, false);
+
+    replay_wakeup();
   }
     return; // leave while loop
   default: {};
@@ -269,7 +285,7 @@ void crofsock::listen() {
   }
 
   /* remove all pending messages from tx queues */
-  for (auto queue : txqueues) {
+  for (auto &queue : txqueues) {
     queue.clear();
   }
 
@@ -396,7 +412,7 @@ void crofsock::tcp_accept(int sd) {
   this->sd = sd;
 
   /* remove all pending messages from tx queues */
-  for (auto queue : txqueues) {
+  for (auto &queue : txqueues) {
     queue.clear();
   }
 
@@ -511,6 +527,123 @@ void crofsock::tcp_accept(int sd) {
   }
 }
 
+void crofsock::replay_accept() {
+  if (get_state() != STATE_IDLE) {
+    close();
+  }
+  this->sd = -1;
+
+  /* remove all pending messages from tx queues */
+  for (auto &queue : txqueues) {
+    queue.clear();
+  }
+
+  /* cancel potentially pending reconnect timer */
+  cthread::thread(rx_thread_num).drop_timer(this, TIMER_ID_RECONNECT);
+
+  /* replayed sessions behave like accepted connections */
+  mode = MODE_SERVER;
+
+  flag_set(FLAG_RECONNECT_ON_FAILURE, false);
+  flag_set(FLAG_REPLAY, true);
+
+  state = STATE_TCP_ESTABLISHED;
+
+  VLOG(6) << __FUNCTION__ << " STATE_TCP_ESTABLISHED (replay)";
+
+  crofsock_env::call_env(env).handle_tcp_accepted(*this);
+}
+
+size_t crofsock::replay(const crofcapture &capture, bool paced) {
+  if (not flag_test(FLAG_REPLAY)) {
+    throw eRofSockInvalid("crofsock::replay() called in invalid state",
+                          __FILE__, __FUNCTION__, __LINE__);
+  }
+
+  /* received bytes form a stream, a message may span several records */
+  std::vector<uint8_t> fragment;
+  size_t num_msgs = 0;
+  uint64_t ts_first = 0;
+  uint64_t start_ns = crofcapture::now_ns();
+  bool first = true;
+
+  for (auto it = capture.begin(); it != capture.end(); ++it) {
+    if (crofcapture::DIR_RX != it->dir) {
+      continue;
+    }
+
+    if (paced) {
+      if (first) {
+        ts_first = it->ts_ns;
+      }
+      uint64_t due_ns = start_ns + (it->ts_ns - ts_first);
+      uint64_t now_ns = crofcapture::now_ns();
+      if (due_ns > now_ns) {
+        struct timespec ts;
+        ts.tv_sec = (due_ns - now_ns) / 1000000000ULL;
+        ts.tv_nsec = (due_ns - now_ns) % 1000000000ULL;
+        nanosleep(&ts, NULL);
+      }
+    }
+    first = false;
+
+    /* the private mapping of a capture may be parsed in place */
+    uint8_t *buf = (uint8_t *)it->data;
+    size_t buflen = it->len;
+    if (not fragment.empty()) {
+      fragment.insert(fragment.end(), buf, buf + buflen);
+      buf = fragment.data();
+      buflen = fragment.size();
+    }
+
+    size_t offset = 0;
+    while (buflen - offset >= sizeof(struct rofl::openflow::ofp_header)) {
+      struct rofl::openflow::ofp_header *hdr =
+          (struct rofl::openflow::ofp_header *)(buf + offset);
+      size_t msg_len = be16toh(hdr->length);
+      if (msg_len < sizeof(struct rofl::openflow::ofp_header)) {
+        /* malformed stream, let the parser reject the remaining bytes */
+        msg_len = buflen - offset;
+      }
+      if (msg_len > buflen - offset) {
+        break;
+      }
+
+      /* upper layers may throttle reception, wait for rx_enable() */
+      if (rx_disabled) {
+        std::unique_lock<std::mutex> lock(replay_lock);
+        replay_cond.wait(lock, [this]() {
+          return (not rx_disabled) || (get_state() <= STATE_IDLE) ||
+                 delete_in_progress();
+        });
+      }
+      if ((get_state() <= STATE_IDLE) || delete_in_progress()) {
+        return num_msgs;
+      }
+
+      parse_message(buf + offset, msg_len);
+      rx_messages++;
+      num_msgs++;
+      offset += msg_len;
+    }
+
+    if (offset < buflen) {
+      std::vector<uint8_t> rest(buf + offset, buf + buflen);
+      fragment.swap(rest);
+    } else {
+      fragment.clear();
+    }
+  }
+
+  return num_msgs;
+}
+
+void crofsock::replay_wakeup() {
+  /* taking the lock orders this wakeup after a concurrent predicate check */
+  std::lock_guard<std::mutex> lock(replay_lock);
+  replay_cond.notify_all();
+}
+
 void crofsock::tcp_connect(bool reconnect) {
   int rc;
 
@@ -519,7 +652,7 @@ void crofsock::tcp_connect(bool reconnect) {
   }
 
   /* remove all pending messages from tx queues */
-  for (auto queue : txqueues) {
+  for (auto &queue : txqueues) {
     queue.clear();
   }
 
@@ -660,95 +793,67 @@ void crofsock::tcp_connect(bool reconnect) {
 }
 
 void crofsock::tls_init_context() {
-
-  if (ctx) {
-    tls_term_context();
-  }
+  ctlscontext::params_t params;
+  params.capath = capath;
+  params.cafile = cafile;
+  params.certfile = certfile;
+  params.keyfile = keyfile;
+  params.password = password;
+  params.verify_mode = verify_mode;
+  params.verify_depth = verify_depth;
+  params.ciphers = ciphers;
 
   AcquireReadWriteLock lock(sslock);
 
-#if (OPENSSL_VERSION_NUMBER >= 0x1010000fL)
-  // openssl 1.1.0
-  ctx = SSL_CTX_new(TLS_method());
-#else
-  ctx = SSL_CTX_new(TLSv1_2_method());
-#endif
-
-  // certificate
-  if (!SSL_CTX_use_certificate_file(ctx, certfile.c_str(), SSL_FILETYPE_PEM)) {
-    throw eLibCall("eLibCall", "SSL_CTX_use_certificate_file", __FILE__,
-                   __FUNCTION__, __LINE__)
-        .set_key("certfile", certfile);
-  }
-
-  // private key
-  SSL_CTX_set_default_passwd_cb(ctx, &crofsock::tls_pswd_cb);
-  SSL_CTX_set_default_passwd_cb_userdata(ctx, (void *)this);
-
-  if (!SSL_CTX_use_PrivateKey_file(ctx, keyfile.c_str(), SSL_FILETYPE_PEM)) {
-    throw eLibCall("eLibCall", "SSL_CTX_use_PrivateKey_file", __FILE__,
-                   __FUNCTION__, __LINE__)
-        .set_key("keyfile", keyfile);
-  }
-  // ciphers
-  if ((not ciphers.empty()) &&
-      (0 == SSL_CTX_set_cipher_list(ctx, ciphers.c_str()))) {
-    throw eLibCall("eLibCall", "SSL_CTX_set_cipher_list", __FILE__,
-                   __FUNCTION__, __LINE__)
-        .set_key("ciphers", ciphers);
+  /* keep context across reconnects unless TLS parameters or files changed */
+  if (ctx && (params == ctx_params) && ctlscontext::is_current(ctx, params)) {
+    return;
   }
 
-  // capath/cafile
-  if (!SSL_CTX_load_verify_locations(ctx,
-                                     cafile.empty() ? NULL : cafile.c_str(),
-                                     capath.empty() ? NULL : capath.c_str())) {
-    throw eLibCall("eLibCall", "SSL_CTX_load_verify_locations", __FILE__,
-                   __FUNCTION__, __LINE__)
-        .set_key("cafile", cafile)
-        .set_key("capath", capath);
-  }
+  SSL_CTX *new_ctx = ctlscontext::acquire(params);
 
-  int mode = SSL_VERIFY_NONE;
-  if (verify_mode == "NONE") {
-    mode = SSL_VERIFY_NONE;
-  } else if (verify_mode == "PEER") {
-    mode = SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT;
+  if (tls_session) {
+    SSL_SESSION_free(tls_session);
+    tls_session = NULL;
   }
+  ctlscontext::release(ctx);
 
-  SSL_CTX_set_verify(ctx, mode, NULL);
-
-  int depth;
-  std::istringstream(verify_depth) >> depth;
-
-  SSL_CTX_set_verify_depth(ctx, depth);
+  ctx = new_ctx;
+  ctx_params = params;
 }
 
 void crofsock::tls_term_context() {
   AcquireReadWriteLock lock(sslock);
   if (ssl) {
+    /* remember session of an established active connection for reuse */
+    if (tls_session_reuse && (STATE_TLS_ESTABLISHED == state) &&
+        (not SSL_is_server(ssl))) {
+      SSL_SESSION *session = SSL_get1_session(ssl);
+#if (OPENSSL_VERSION_NUMBER >= 0x10101000L)
+      if (session && (not SSL_SESSION_is_resumable(session))) {
+        SSL_SESSION_free(session);
+        session = NULL;
+      }
+#endif
+      if (session) {
+        if (tls_session) {
+          SSL_SESSION_free(tls_session);
+        }
+        tls_session = session;
+      }
+    }
     SSL_free(ssl);
     ssl = NULL;
     bio = NULL;
   }
-  if (ctx) {
-    SSL_CTX_free(ctx);
-    ctx = NULL;
-  }
 }
 
-int crofsock::tls_pswd_cb(char *buf, int size, int rwflag, void *userdata) {
-  if (userdata == NULL)
-    return 0;
-
-  crofsock &socket = *(static_cast<crofsock *>(userdata));
-
-  if (socket.get_tls_pswd().empty()) {
-    return 0;
+void crofsock::tls_drop_session() {
+  AcquireReadWriteLock lock(sslock);
+  if (tls_session) {
+    SSL_SESSION_free(tls_session);
+    tls_session = NULL;
   }
-
-  strncpy(buf, socket.get_tls_pswd().c_str(), size);
-
-  return strnlen(buf, size);
 }
 
 void crofsock::tls_accept(int sockfd) {
@@ -801,6 +906,11 @@ void crofsock::tls_accept(int sockfd) {
     {
       AcquireReadWriteLock lock(sslock);
 
+      /* handshake completed or connection closed by a concurrent call */
+      if ((NULL == ssl) || SSL_is_init_finished(ssl)) {
+        return;
+      }
+
       VLOG(6) << __FUNCTION__
               << " TLS: run SSL_accept on passive connection sd=" << sd;
 
@@ -880,7 +990,10 @@ void crofsock::tls_accept(int sockfd) {
         return;
       }
 
-      VLOG(6) << __FUNCTION__ << " TLS: SSL_accept succeeded on sd=" << sd;
+      VLOG(6) << __FUNCTION__ << " TLS: SSL_accept succeeded on sd=" << sd
+              << " session reused: " << SSL_session_reused(ssl);
+
+      flag_set(FLAG_TLS_SESSION_REUSED, SSL_session_reused(ssl));
 
       state = STATE_TLS_ESTABLISHED;
 
@@ -935,6 +1048,10 @@ void crofsock::tls_connect(bool reconnect) {
 
     SSL_set_connect_state(ssl);
 
+    if (tls_session_reuse && tls_session) {
+      SSL_set_session(ssl, tls_session);
+    }
+
     state = STATE_TLS_CONNECTING;
 
     VLOG(6) << __FUNCTION__ << " TLS: start active connection sd=" << sd;
@@ -947,6 +1064,11 @@ void crofsock::tls_connect(bool reconnect) {
     {
       AcquireReadWriteLock lock(sslock);
 
+      /* handshake completed or connection closed by a concurrent call */
+      if ((NULL == ssl) || SSL_is_init_finished(ssl)) {
+        return;
+      }
+
       VLOG(6) << __FUNCTION__
               << " TLS: run SSL_connect on active connection sd=" << sd;
 
@@ -1003,6 +1125,8 @@ void crofsock::tls_connect(bool reconnect) {
 
       tls_term_context();
 
+      tls_drop_session();
+
       crofsock::close();
 
       crofsock_env::call_env(env).handle_tls_connect_failed(*this);
@@ -1019,6 +1143,8 @@ void crofsock::tls_connect(bool reconnect) {
 
         tls_term_context();
 
+        tls_drop_session();
+
         crofsock::close();
 
         crofsock_env::call_env(env).handle_tls_connect_failed(*this);
@@ -1026,7 +1152,10 @@ void crofsock::tls_connect(bool reconnect) {
         return;
       }
 
-      VLOG(6) << __FUNCTION__ << " TLS: SSL_connect succeeded on sd=" << sd;
+      VLOG(6) << __FUNCTION__ << " TLS: SSL_connect succeeded on sd=" << sd
+              << " session reused: " << SSL_session_reused(ssl);
+
+      flag_set(FLAG_TLS_SESSION_REUSED, SSL_session_reused(ssl));
 
       state = STATE_TLS_ESTABLISHED;
 
@@ -1342,6 +1471,9 @@ bool crofsock::is_rx_disabled() const { return rx_disabled; }
 
 void crofsock::rx_disable() {
   rx_disabled = true;
+  if (flag_test(FLAG_REPLAY)) {
+    return;
+  }
   switch (state.load()) {
   case STATE_TCP_ESTABLISHED:
   case STATE_TLS_ESTABLISHED: {
@@ -1356,6 +1488,10 @@ void crofsock::rx_disable() {
 
 void crofsock::rx_enable() {
   rx_disabled = false;
+  if (flag_test(FLAG_REPLAY)) {
+    replay_wakeup();
+    return;
+  }
   switch (state.load()) {
   case STATE_TCP_ESTABLISHED:
   case STATE_TLS_ESTABLISHED: {
@@ -1382,6 +1518,28 @@ void crofsock::tx_enable() {
   cthread::thread(tx_thread_num).wakeup(this);
 }
 
+crofsock &crofsock::set_rx_mode(rx_mode_t rx_mode, size_t rxbuffer_size) {
+  if ((state == STATE_TCP_ESTABLISHED) || (state == STATE_TLS_ESTABLISHED)) {
+    throw eRofSockInvalid("crofsock::set_rx_mode() called in invalid state",
+                          __FILE__, __FUNCTION__, __LINE__);
+  }
+  switch (rx_mode) {
+  case RX_MODE_BATCH: {
+    /* we need room for at least two maximum sized messages */
+    if (rxbuffer_size < 2 * 65536) {
+      rxbuffer_size = 2 * 65536;
+    }
+    rxbuffer = cbuffer(rxbuffer_size);
+  } break;
+  case RX_MODE_MESSAGE:
+  default: {
+    rxbuffer = cbuffer((size_t)65536);
+  };
+  }
+  this->rx_mode = rx_mode;
+  return *this;
+}
+
 void crofsock::handle_timeout(cthread &thread, uint32_t timer_id) {
   if (delete_in_progress()) {
     return;
@@ -1429,92 +1587,78 @@ crofsock::msg_result_t crofsock::send_message(rofl::openflow::cofmsg *msg,
     enforce_queueing = true;
   }
 
-  try {
-
-    /* enqueue the message in rofl's internal queue, as long
-     * as these are not exhausted */
-    switch (msg->get_version()) {
-    case rofl::openflow10::OFP_VERSION: {
-      switch (msg->get_type()) {
-      case rofl::openflow10::OFPT_PACKET_IN:
-      case rofl::openflow10::OFPT_PACKET_OUT: {
-        txqueues[QUEUE_PKT].store(msg, enforce_queueing);
-      } break;
-      case rofl::openflow10::OFPT_FLOW_MOD:
-      case rofl::openflow10::OFPT_FLOW_REMOVED:
-      case rofl::openflow10::OFPT_BARRIER_REPLY:
-      case rofl::openflow10::OFPT_BARRIER_REQUEST: {
-        txqueues[QUEUE_FLOW].store(msg, enforce_queueing);
-      } break;
-      case rofl::openflow10::OFPT_ECHO_REQUEST:
-      case rofl::openflow10::OFPT_ECHO_REPLY: {
-        txqueues[QUEUE_OAM].store(msg, enforce_queueing);
-      } break;
-      default: { txqueues[QUEUE_MGMT].store(msg, enforce_queueing); };
-      }
+  /* select rofl's internal queue for this message */
+  unsigned int queue = QUEUE_MGMT;
+  switch (msg->get_version()) {
+  case rofl::openflow10::OFP_VERSION: {
+    switch (msg->get_type()) {
+    case rofl::openflow10::OFPT_PACKET_IN:
+    case rofl::openflow10::OFPT_PACKET_OUT: {
+      queue = QUEUE_PKT;
     } break;
-    case rofl::openflow12::OFP_VERSION: {
-      switch (msg->get_type()) {
-      case rofl::openflow12::OFPT_PACKET_IN:
-      case rofl::openflow12::OFPT_PACKET_OUT: {
-        txqueues[QUEUE_PKT].store(msg, enforce_queueing);
-      } break;
-      case rofl::openflow12::OFPT_FLOW_MOD:
-      case rofl::openflow12::OFPT_FLOW_REMOVED:
-      case rofl::openflow12::OFPT_GROUP_MOD:
-      case rofl::openflow12::OFPT_PORT_MOD:
-      case rofl::openflow12::OFPT_TABLE_MOD:
-      case rofl::openflow12::OFPT_BARRIER_REPLY:
-      case rofl::openflow12::OFPT_BARRIER_REQUEST: {
-        txqueues[QUEUE_FLOW].store(msg, enforce_queueing);
-      } break;
-      case rofl::openflow12::OFPT_ECHO_REQUEST:
-      case rofl::openflow12::OFPT_ECHO_REPLY: {
-        txqueues[QUEUE_OAM].store(msg, enforce_queueing);
-      } break;
-      default: { txqueues[QUEUE_MGMT].store(msg, enforce_queueing); };
-      }
+    case rofl::openflow10::OFPT_FLOW_MOD:
+    case rofl::openflow10::OFPT_FLOW_REMOVED:
+    case rofl::openflow10::OFPT_BARRIER_REPLY:
+    case rofl::openflow10::OFPT_BARRIER_REQUEST: {
+      queue = QUEUE_FLOW;
     } break;
-    case rofl::openflow13::OFP_VERSION:
-    default: {
-      switch (msg->get_type()) {
-      case rofl::openflow13::OFPT_PACKET_IN:
-      case rofl::openflow13::OFPT_PACKET_OUT: {
-        txqueues[QUEUE_PKT].store(msg, enforce_queueing);
-      } break;
-      case rofl::openflow13::OFPT_FLOW_MOD:
-      case rofl::openflow13::OFPT_FLOW_REMOVED:
-      case rofl::openflow13::OFPT_GROUP_MOD:
-      case rofl::openflow13::OFPT_PORT_MOD:
-      case rofl::openflow13::OFPT_TABLE_MOD:
-      case rofl::openflow13::OFPT_BARRIER_REPLY:
-      case rofl::openflow13::OFPT_BARRIER_REQUEST: {
-        txqueues[QUEUE_FLOW].store(msg, enforce_queueing);
-      } break;
-      case rofl::openflow13::OFPT_ECHO_REQUEST:
-      case rofl::openflow13::OFPT_ECHO_REPLY: {
-        txqueues[QUEUE_OAM].store(msg, enforce_queueing);
-      } break;
-      default: { txqueues[QUEUE_MGMT].store(msg, enforce_queueing); };
-      }
-    };
+    case rofl::openflow10::OFPT_ECHO_REQUEST:
+    case rofl::openflow10::OFPT_ECHO_REPLY: {
+      queue = QUEUE_OAM;
+    } break;
+    default: { queue = QUEUE_MGMT; };
     }
-
-    txqueue_pending_pkts++;
-
-    if (not tx_is_running) {
-      cthread::thread(tx_thread_num).wakeup(this);
+  } break;
+  case rofl::openflow12::OFP_VERSION: {
+    switch (msg->get_type()) {
+    case rofl::openflow12::OFPT_PACKET_IN:
+    case rofl::openflow12::OFPT_PACKET_OUT: {
+      queue = QUEUE_PKT;
+    } break;
+    case rofl::openflow12::OFPT_FLOW_MOD:
+    case rofl::openflow12::OFPT_FLOW_REMOVED:
+    case rofl::openflow12::OFPT_GROUP_MOD:
+    case rofl::openflow12::OFPT_PORT_MOD:
+    case rofl::openflow12::OFPT_TABLE_MOD:
+    case rofl::openflow12::OFPT_BARRIER_REPLY:
+    case rofl::openflow12::OFPT_BARRIER_REQUEST: {
+      queue = QUEUE_FLOW;
+    } break;
+    case rofl::openflow12::OFPT_ECHO_REQUEST:
+    case rofl::openflow12::OFPT_ECHO_REPLY: {
+      queue = QUEUE_OAM;
+    } break;
+    default: { queue = QUEUE_MGMT; };
     }
-
-    if (flag_test(FLAG_TX_BLOCK_QUEUEING)) {
-      /* message was queued, but congestion prevents us from sending it */
-      return MSG_QUEUED_CONGESTION;
+  } break;
+  case rofl::openflow13::OFP_VERSION:
+  default: {
+    switch (msg->get_type()) {
+    case rofl::openflow13::OFPT_PACKET_IN:
+    case rofl::openflow13::OFPT_PACKET_OUT: {
+      queue = QUEUE_PKT;
+    } break;
+    case rofl::openflow13::OFPT_FLOW_MOD:
+    case rofl::openflow13::OFPT_FLOW_REMOVED:
+    case rofl::openflow13::OFPT_GROUP_MOD:
+    case rofl::openflow13::OFPT_PORT_MOD:
+    case rofl::openflow13::OFPT_TABLE_MOD:
+    case rofl::openflow13::OFPT_BARRIER_REPLY:
+    case rofl::openflow13::OFPT_BARRIER_REQUEST: {
+      queue = QUEUE_FLOW;
+    } break;
+    case rofl::openflow13::OFPT_ECHO_REQUEST:
+    case rofl::openflow13::OFPT_ECHO_REPLY: {
+      queue = QUEUE_OAM;
+    } break;
+    default: { queue = QUEUE_MGMT; };
     }
+  };
+  }
 
-    /* message was queued, waiting for transmission */
-    return MSG_QUEUED;
-
-  } catch (eRofQueueFull &e) {
+  /* enqueue the message in rofl's internal queue, as long
+   * as it is not exhausted */
+  if (txqueues[queue].try_store(msg, enforce_queueing) == 0) {
     VLOG(6) << __FUNCTION__ << " txqueue exhausted, "
             << " msg=" << msg
             << " txqueue_pending_pkts=" << txqueue_pending_pkts
@@ -1524,6 +1668,20 @@ crofsock::msg_result_t crofsock::send_message(rofl::openflow::cofmsg *msg,
     /* message was not stored in txqueue and deleted here */
     return MSG_QUEUEING_FAILED_QUEUE_FULL;
   }
+
+  txqueue_pending_pkts++;
+
+  if (not tx_is_running) {
+    cthread::thread(tx_thread_num).wakeup(this);
+  }
+
+  if (flag_test(FLAG_TX_BLOCK_QUEUEING)) {
+    /* message was queued, but congestion prevents us from sending it */
+    return MSG_QUEUED_CONGESTION;
+  }
+
+  /* message was queued, waiting for transmission */
+  return MSG_QUEUED;
 }
 
 void crofsock::handle_wakeup(cthread &thread) {
@@ -1533,7 +1691,9 @@ void crofsock::handle_wakeup(cthread &thread) {
 
   if (&thread == &cthread::thread(rx_thread_num)) {
     // recv_message();
-    handle_read_event_rxthread(thread, sd);
+    if (not flag_test(FLAG_REPLAY)) {
+      handle_read_event_rxthread(thread, sd);
+    }
   } else if (&thread == &cthread::thread(tx_thread_num)) {
     send_from_queue();
   }
@@ -1566,254 +1726,455 @@ void crofsock::send_from_queue() {
 
   tx_is_running = true;
 
-  bool reschedule;
-  do {
-    reschedule = false;
-    for (unsigned int queue_id = 0; queue_id < QUEUE_MAX; ++queue_id) {
+  while (true) {
 
-      for (unsigned int num = 0; num < txweights[queue_id]; ++num) {
+    if ((tx_disabled) || (get_state() < STATE_TCP_ESTABLISHED)) {
+      tx_is_running = false;
+      return;
+    }
 
-        if ((tx_disabled) || (get_state() < STATE_TCP_ESTABLISHED)) {
-          tx_is_running = false;
-          return;
-        }
+    /* no pending fragment, pack next batch of messages */
+    if (txbuffer.empty() && (pack_into_txbuffer() == 0)) {
+      break;
+    }
+
+    /* send txbuffer, stop here when blocked or on error */
+    if (not flush_txbuffer()) {
+      return;
+    }
+
+    if ((not flag_test(FLAG_CONGESTED)) && flag_test(FLAG_TX_BLOCK_QUEUEING)) {
+      if (txqueue_pending_pkts <= txqueue_size_tx_threshold) {
+        flag_set(FLAG_TX_BLOCK_QUEUEING, false);
+        VLOG(6) << __FUNCTION__ << " sd=" << sd << " congestion solved"
+                << " txqueue_pending_pkts" << txqueue_pending_pkts
+                << " txqueue_size_congestion_occurred"
+                << txqueue_size_congestion_occurred
+                << " txqueue_size_tx_threshold" << txqueue_size_tx_threshold
+                << " laddr=" << laddr.str() << " raddr=" << raddr.str();
+
+        crofsock_env::call_env(env).congestion_solved_indication(*this);
+      }
+    }
+  }
+
+  tx_is_running = false;
+
+  if ((txqueue_pending_pkts > 0) && (not flag_test(FLAG_TX_BLOCK_QUEUEING))) {
+    cthread::thread(tx_thread_num).wakeup(this);
+  }
+}
+
+unsigned int crofsock::pack_into_txbuffer() {
+  /* grow txbuffer for larger batches, txbuffer is empty here */
+  if (txbuffer.length() < tx_batch_bytes) {
+    txbuffer = cbuffer(tx_batch_bytes);
+  }
+
+  unsigned int usecs = tx_batch_usecs;
+  ctimespec deadline(usecs / 1000000, (long)(usecs % 1000000) * 1000);
+  unsigned int num_packed = 0;
+  size_t batch_bytes = 0;
+
+  /* deficit round robin over all txqueues, continuing where the last
+   * batch stopped */
+  while (true) {
+
+    size_t msglen = 0;
+    unsigned int queue_id = txsched.select([&](unsigned int queue_id) {
+      return (msglen = txqueues[queue_id].front_length());
+    });
+    if (queue_id >= QUEUE_MAX) {
+      break;
+    }
+
+    /* message does not fit into current batch, send batch first */
+    if ((num_packed > 0) && ((batch_bytes + msglen > tx_batch_bytes) ||
+                             (msglen > txbuffer.wmemlen()))) {
+      break;
+    }
 
-        /* no pending fragment */
-        if (txbuffer.empty()) {
-          rofl::openflow::cofmsg *msg = nullptr;
+    /* single message exceeding txbuffer, e.g. a flow-mod batch, grow
+     * txbuffer before taking the message so that packing cannot fail */
+    if (msglen > txbuffer.wmemlen()) {
+      txbuffer = cbuffer(msglen);
+    }
 
-          /* fetch a new message for transmission from tx queue */
-          if ((msg = txqueues[queue_id].retrieve()) == NULL)
-            break;
-          // txqueues[queue_id].pop();
+    /* the queue may have been cleared meanwhile, take the message only if
+     * it still fits */
+    rofl::openflow::cofmsg *msg =
+        txqueues[queue_id].retrieve(txbuffer.wmemlen());
+    if (msg == nullptr) {
+      continue;
+    }
+    msglen = msg->length();
+    txsched.dequeued(queue_id, msglen, txqueues[queue_id].get_stored_ns());
+
+    /* pack message into txbuffer, a payload is referenced instead of copied
+     * unless TLS needs a contiguous buffer */
+    bool keep_msg = false;
+    if (flag_test(FLAG_TLS_IN_USE) ||
+        (tx_payloads.size() >= TX_PAYLOADS_MAX)) {
+      msg->pack(txbuffer.sowmem(), txbuffer.wmemlen());
+      txbuffer.wseek(msglen);
+    } else {
+      struct iovec payload;
+      txbuffer.wseek(
+          msg->pack_head(txbuffer.sowmem(), txbuffer.wmemlen(), payload));
+      if (payload.iov_len > 0) {
+        tx_payloads.push_back(tx_payload_t(txbuffer.rmemlen(), payload));
+        tx_payload_msgs.push_back(msg);
+        tx_payloads_bytes += payload.iov_len;
+        keep_msg = true;
+      }
+    }
+    batch_bytes += msglen;
+    num_packed++;
 
-          /* pack message into txbuffer */
-          msg->pack(txbuffer.sowmem(), txbuffer.wmemlen());
-          txbuffer.wseek(msg->length());
+    VLOG(6) << __FUNCTION__ << " sd=" << sd
+            << " message sent: " << msg->str().c_str()
+            << " laddr=" << laddr.str() << " raddr=" << raddr.str();
 
-          VLOG(6) << __FUNCTION__ << " sd=" << sd
-                  << " message sent: " << msg->str().c_str()
+    /* echo and barrier messages are sent immediately */
+    bool urgent = false;
+    switch (msg->get_type()) {
+    case rofl::openflow::OFPT_ECHO_REQUEST:
+    case rofl::openflow::OFPT_ECHO_REPLY: {
+      urgent = true;
+    } break;
+    case rofl::openflow::OFPT_FLOW_MOD: {
+      rofl::openflow::cofmsg_flow_mod_batch *batch =
+          rofl::openflow::flow_mod_batch_cast(msg);
+      urgent = (batch != nullptr) && batch->has_barrier_request();
+    } break;
+    default: {
+      switch (msg->get_version()) {
+      case rofl::openflow10::OFP_VERSION: {
+        urgent = (msg->get_type() == rofl::openflow10::OFPT_BARRIER_REQUEST) ||
+                 (msg->get_type() == rofl::openflow10::OFPT_BARRIER_REPLY);
+      } break;
+      default: {
+        urgent = (msg->get_type() == rofl::openflow13::OFPT_BARRIER_REQUEST) ||
+                 (msg->get_type() == rofl::openflow13::OFPT_BARRIER_REPLY);
+      };
+      }
+    };
+    }
+
+    /* remove C++ message object from heap */
+    if (not keep_msg) {
+      delete msg;
+    }
+
+    if (urgent || deadline.is_expired()) {
+      break;
+    }
+  }
+
+  tx_batch_msgs = num_packed;
+
+  crofcapture *capture = this->capture;
+  if (capture && (num_packed > 0)) {
+    capture_txbuffer(capture);
+  }
+
+  return num_packed;
+}
+
+bool crofsock::flush_txbuffer() {
+  if (flag_test(FLAG_REPLAY)) {
+    /* no peer in replay mode, batch is considered sent */
+    txbuffer.rseek(txbuffer.rmemlen());
+    release_tx_payloads();
+    txqueue_pending_pkts -= tx_batch_msgs;
+    tx_messages += tx_batch_msgs;
+    tx_batch_msgs = 0;
+    return true;
+  }
+
+  switch (state.load()) {
+  case STATE_TCP_ESTABLISHED: {
+
+    /* send memory block via socket in non-blocking mode */
+    int nbytes = tx_payloads.empty()
+                     ? ::send(sd, txbuffer.sormem(), txbuffer.rmemlen(),
+                              MSG_DONTWAIT | MSG_NOSIGNAL)
+                     : send_txbuffer_iov();
+    tx_syscalls++;
+
+    /* error occurred */
+    if (nbytes < 0) {
+      switch (errno) {
+      case EAGAIN: /* socket would block */ {
+        tx_is_running = false;
+        flag_set(FLAG_CONGESTED, true);
+        cthread::thread(tx_thread_num).add_write_fd(this, sd);
+
+        if (not flag_test(FLAG_TX_BLOCK_QUEUEING)) {
+          /* block transmission of further packets */
+          flag_set(FLAG_TX_BLOCK_QUEUEING, true);
+          /* remember queue size, when congestion occurred */
+          txqueue_size_congestion_occurred = txqueue_pending_pkts;
+          /* threshold for re-enabling acceptance of packets */
+          txqueue_size_tx_threshold = txqueue_pending_pkts / 2;
+
+          VLOG(6) << __FUNCTION__ << " sd=" << sd << " congestion occurred"
+                  << " txqueue_pending_pkts: " << txqueue_pending_pkts
+                  << " txqueue_size_congestion_occurred: "
+                  << txqueue_size_congestion_occurred
+                  << " txqueue_size_tx_threshold: " << txqueue_size_tx_threshold
                   << " laddr=" << laddr.str() << " raddr=" << raddr.str();
 
-          /* remove C++ message object from heap */
-          delete msg;
+          crofsock_env::call_env(env).congestion_occurred_indication(*this);
         }
+      }
+        return false;
+      case SIGPIPE:
+      default: {
+        VLOG(1) << __FUNCTION__ << " sd=" << sd
+                << " ::send() syscall failed, error: " << errno << ": "
+                << strerror(errno);
+        tx_is_running = false;
+      }
+        return false;
+      }
 
-        switch (state.load()) {
-        case STATE_TCP_ESTABLISHED: {
-
-          /* send memory block via socket in non-blocking mode */
-          int nbytes = ::send(sd, txbuffer.sormem(), txbuffer.rmemlen(),
-                              MSG_DONTWAIT | MSG_NOSIGNAL);
-
-          /* error occurred */
-          if (nbytes < 0) {
-            switch (errno) {
-            case EAGAIN: /* socket would block */ {
-              tx_is_running = false;
-              flag_set(FLAG_CONGESTED, true);
-              cthread::thread(tx_thread_num).add_write_fd(this, sd);
-
-              if (not flag_test(FLAG_TX_BLOCK_QUEUEING)) {
-                /* block transmission of further packets */
-                flag_set(FLAG_TX_BLOCK_QUEUEING, true);
-                /* remember queue size, when congestion occurred */
-                txqueue_size_congestion_occurred = txqueue_pending_pkts;
-                /* threshold for re-enabling acceptance of packets */
-                txqueue_size_tx_threshold = txqueue_pending_pkts / 2;
-
-                VLOG(6) << __FUNCTION__ << " sd=" << sd
-                        << " congestion occurred"
-                        << " txqueue_pending_pkts: " << txqueue_pending_pkts
-                        << " txqueue_size_congestion_occurred: "
-                        << txqueue_size_congestion_occurred
-                        << " txqueue_size_tx_threshold: "
-                        << txqueue_size_tx_threshold << " laddr=" << laddr.str()
-                        << " raddr=" << raddr.str();
-
-                crofsock_env::call_env(env).congestion_occurred_indication(
-                    *this);
-              }
-            }
-              return;
-            case SIGPIPE:
-            default: {
-              VLOG(1) << __FUNCTION__ << " sd=" << sd
-                      << " ::send() syscall failed, error: " << errno << ": "
-                      << strerror(errno);
-              tx_is_running = false;
-            }
-              return;
-            }
-
-            /* at least some bytes were sent successfully */
-          } else {
-            txbuffer.rseek(nbytes);
-            flag_set(FLAG_CONGESTED, false);
-
-            if (txbuffer.empty()) {
-              txqueue_pending_pkts--;
-            }
-
-            VLOG(6) << __FUNCTION__ << " sd=" << sd << " sent " << nbytes
-                    << " bytes, remaining_bytes_to_sent=" << txbuffer.rmemlen()
-                    << " tx_fragment_pending="
-                    << (txbuffer.empty() ? "no" : "yes")
-                    << " txqueue_pending_pkts=" << txqueue_pending_pkts;
-          }
+      /* at least some bytes were sent successfully */
+    } else {
+      if (tx_payloads.empty()) {
+        txbuffer.rseek(nbytes);
+      } else if ((tx_payloads_sent += nbytes) ==
+                 txbuffer.rmemlen() + tx_payloads_bytes) {
+        txbuffer.rseek(txbuffer.rmemlen());
+        release_tx_payloads();
+      }
+      flag_set(FLAG_CONGESTED, false);
 
-        } break;
-        case STATE_TLS_ESTABLISHED: {
-          int err_code = 0, nbytes = 0;
-
-          {
-            AcquireReadWriteLock lock(sslock);
-
-            /* send memory block via OpenSSL structure in non-blocking mode */
-            if ((nbytes = SSL_write(ssl, txbuffer.sormem(),
-                                    txbuffer.rmemlen())) <= 0) {
-              err_code = SSL_get_error(ssl, nbytes);
-            }
-
-            VLOG(6) << __FUNCTION__ << " TLS: SSL_write on sd=" << sd
-                    << " nbytes: " << nbytes << " errno: " << errno << " ("
-                    << strerror(errno) << ")";
-          }
-
-          if (nbytes < 0) {
-            switch (err_code) {
-            case SSL_ERROR_WANT_READ: { /* waiting for more data, stop
-                                           processing for now */
-              VLOG(6) << __FUNCTION__ << " TLS: SSL_write WANT READ sd=" << sd;
-              // add_read_fd(sd) is always active, so we can skip it here
-            }
-              return;
-            case SSL_ERROR_WANT_WRITE: { /* assumption: underlying socket is
-                                            blocking */
-              VLOG(6) << __FUNCTION__ << " TLS: SSL_write WANT WRITE sd=" << sd;
-              tx_is_running = false;
-              flag_set(FLAG_CONGESTED, true);
-              cthread::thread(tx_thread_num).add_write_fd(this, sd);
-
-              if (not flag_test(FLAG_TX_BLOCK_QUEUEING)) {
-                /* block transmission of further packets */
-                flag_set(FLAG_TX_BLOCK_QUEUEING, true);
-                /* remember queue size, when congestion occurred */
-                txqueue_size_congestion_occurred = txqueue_pending_pkts;
-                /* threshold for re-enabling acceptance of packets */
-                txqueue_size_tx_threshold = txqueue_pending_pkts / 2;
-
-                VLOG(6) << __FUNCTION__ << " sd=" << sd
-                        << " congestion occurred"
-                        << " txqueue_pending_pkts: " << txqueue_pending_pkts
-                        << " txqueue_size_congestion_occurred: "
-                        << txqueue_size_congestion_occurred
-                        << " txqueue_size_tx_threshold: "
-                        << txqueue_size_tx_threshold << " laddr=" << laddr.str()
-                        << " raddr=" << raddr.str();
-
-                crofsock_env::call_env(env).congestion_occurred_indication(
-                    *this);
-              }
-            }
-              return;
-            case SSL_ERROR_WANT_ACCEPT: { /* should never happen here, though */
-              VLOG(6) << __FUNCTION__
-                      << " TLS: SSL_write WANT ACCEPT on sd=" << sd;
-              tx_is_running = false;
-            }
-              return;
-            case SSL_ERROR_WANT_CONNECT: { /* should never happen here, though
-                                              */
-              VLOG(6) << __FUNCTION__
-                      << " TLS: SSL_write WANT CONNECT on sd=" << sd;
-              tx_is_running = false;
-            }
-              return;
-
-            case SSL_ERROR_NONE: { /* no error occured, just continue */
-              VLOG(6) << __FUNCTION__
-                      << " TLS: SSL_write succeeded ERROR NONE on sd=" << sd;
-            } break;
-            case SSL_ERROR_SSL: { /* error on SSL layer */
-              VLOG(6) << __FUNCTION__
-                      << " TLS: SSL_write failed ERROR SSL on sd=" << sd;
-              tx_is_running = false;
-            }
-              return;
-            case SSL_ERROR_SYSCALL: { /* error on underlying system call */
-              VLOG(6) << __FUNCTION__
-                      << " TLS: SSL_write failed ERROR SYSCALL on sd=" << sd
-                      << " nbytes: " << nbytes << " errno: " << errno << " ("
-                      << strerror(errno) << ")";
-              tx_is_running = false;
-            }
-              return;
-            case SSL_ERROR_ZERO_RETURN: { /* peer initiated shutdown */
-              VLOG(6) << __FUNCTION__
-                      << " TLS: SSL_write failed ERROR ZERO RETURN on sd="
-                      << sd;
-              tx_is_running = false;
-            }
-              return;
-            default: {
-              VLOG(6) << __FUNCTION__ << " TLS: SSL_write failed on sd=" << sd;
-              tx_is_running = false;
-            }
-              return;
-            }
-
-            /* at least some bytes were sent successfully */
-          } else {
-            txbuffer.rseek(nbytes);
-            flag_set(FLAG_CONGESTED, false);
-
-            if (txbuffer.empty()) {
-              txqueue_pending_pkts--;
-            }
-
-            VLOG(6) << __FUNCTION__ << " sd=" << sd << " sent " << nbytes
-                    << " bytes, remaining_bytes_to_sent=" << txbuffer.rmemlen()
-                    << " tx_fragment_pending="
-                    << (txbuffer.empty() ? "no" : "yes")
-                    << " txqueue_pending_pkts=" << txqueue_pending_pkts;
-          }
+      if (txbuffer.empty()) {
+        txqueue_pending_pkts -= tx_batch_msgs;
+        tx_messages += tx_batch_msgs;
+        tx_batch_msgs = 0;
+      }
 
-        } break;
-        default: {
+      VLOG(6) << __FUNCTION__ << " sd=" << sd << " sent " << nbytes
+              << " bytes, remaining_bytes_to_sent=" << txbuffer.rmemlen()
+              << " tx_fragment_pending=" << (txbuffer.empty() ? "no" : "yes")
+              << " txqueue_pending_pkts=" << txqueue_pending_pkts;
+    }
 
-          VLOG(6) << __FUNCTION__ << " unable to send in state=" << str()
-                  << " on sd=" << sd;
-        };
+  } break;
+  case STATE_TLS_ESTABLISHED: {
+    int err_code = 0, nbytes = 0;
+
+    /* batch packed before TLS was started */
+    if (not tx_payloads.empty()) {
+      linearize_txbuffer();
+    }
+
+    {
+      AcquireReadWriteLock lock(sslock);
+
+      /* send memory block via OpenSSL structure in non-blocking mode */
+      if ((nbytes = SSL_write(ssl, txbuffer.sormem(), txbuffer.rmemlen())) <=
+          0) {
+        err_code = SSL_get_error(ssl, nbytes);
+      }
+      tx_syscalls++;
+
+      VLOG(6) << __FUNCTION__ << " TLS: SSL_write on sd=" << sd
+              << " nbytes: " << nbytes << " errno: " << errno << " ("
+              << strerror(errno) << ")";
+    }
+
+    if (nbytes < 0) {
+      switch (err_code) {
+      case SSL_ERROR_WANT_READ: { /* waiting for more data, stop
+                                     processing for now */
+        VLOG(6) << __FUNCTION__ << " TLS: SSL_write WANT READ sd=" << sd;
+        // add_read_fd(sd) is always active, so we can skip it here
+      }
+        return false;
+      case SSL_ERROR_WANT_WRITE: { /* assumption: underlying socket is
+                                      blocking */
+        VLOG(6) << __FUNCTION__ << " TLS: SSL_write WANT WRITE sd=" << sd;
+        tx_is_running = false;
+        flag_set(FLAG_CONGESTED, true);
+        cthread::thread(tx_thread_num).add_write_fd(this, sd);
+
+        if (not flag_test(FLAG_TX_BLOCK_QUEUEING)) {
+          /* block transmission of further packets */
+          flag_set(FLAG_TX_BLOCK_QUEUEING, true);
+          /* remember queue size, when congestion occurred */
+          txqueue_size_congestion_occurred = txqueue_pending_pkts;
+          /* threshold for re-enabling acceptance of packets */
+          txqueue_size_tx_threshold = txqueue_pending_pkts / 2;
+
+          VLOG(6) << __FUNCTION__ << " sd=" << sd << " congestion occurred"
+                  << " txqueue_pending_pkts: " << txqueue_pending_pkts
+                  << " txqueue_size_congestion_occurred: "
+                  << txqueue_size_congestion_occurred
+                  << " txqueue_size_tx_threshold: " << txqueue_size_tx_threshold
+                  << " laddr=" << laddr.str() << " raddr=" << raddr.str();
+
+          crofsock_env::call_env(env).congestion_occurred_indication(*this);
         }
       }
+        return false;
+      case SSL_ERROR_WANT_ACCEPT: { /* should never happen here, though */
+        VLOG(6) << __FUNCTION__ << " TLS: SSL_write WANT ACCEPT on sd=" << sd;
+        tx_is_running = false;
+      }
+        return false;
+      case SSL_ERROR_WANT_CONNECT: { /* should never happen here, though */
+        VLOG(6) << __FUNCTION__ << " TLS: SSL_write WANT CONNECT on sd=" << sd;
+        tx_is_running = false;
+      }
+        return false;
 
-      if (not txqueues[queue_id].empty()) {
-        reschedule = true;
+      case SSL_ERROR_NONE: { /* no error occured, just continue */
+        VLOG(6) << __FUNCTION__
+                << " TLS: SSL_write succeeded ERROR NONE on sd=" << sd;
+      } break;
+      case SSL_ERROR_SSL: { /* error on SSL layer */
+        VLOG(6) << __FUNCTION__ << " TLS: SSL_write failed ERROR SSL on sd="
+                << sd;
+        tx_is_running = false;
       }
+        return false;
+      case SSL_ERROR_SYSCALL: { /* error on underlying system call */
+        VLOG(6) << __FUNCTION__
+                << " TLS: SSL_write failed ERROR SYSCALL on sd=" << sd
+                << " nbytes: " << nbytes << " errno: " << errno << " ("
+                << strerror(errno) << ")";
+        tx_is_running = false;
+      }
+        return false;
+      case SSL_ERROR_ZERO_RETURN: { /* peer initiated shutdown */
+        VLOG(6) << __FUNCTION__
+                << " TLS: SSL_write failed ERROR ZERO RETURN on sd=" << sd;
+        tx_is_running = false;
+      }
+        return false;
+      default: {
+        VLOG(6) << __FUNCTION__ << " TLS: SSL_write failed on sd=" << sd;
+        tx_is_running = false;
+      }
+        return false;
+      }
+
+      /* at least some bytes were sent successfully */
+    } else {
+      txbuffer.rseek(nbytes);
+      flag_set(FLAG_CONGESTED, false);
+
+      if (txbuffer.empty()) {
+        txqueue_pending_pkts -= tx_batch_msgs;
+        tx_messages += tx_batch_msgs;
+        tx_batch_msgs = 0;
+      }
+
+      VLOG(6) << __FUNCTION__ << " sd=" << sd << " sent " << nbytes
+              << " bytes, remaining_bytes_to_sent=" << txbuffer.rmemlen()
+              << " tx_fragment_pending=" << (txbuffer.empty() ? "no" : "yes")
+              << " txqueue_pending_pkts=" << txqueue_pending_pkts;
     }
 
-    if ((not flag_test(FLAG_CONGESTED)) && flag_test(FLAG_TX_BLOCK_QUEUEING)) {
-      if (txqueue_pending_pkts <= txqueue_size_tx_threshold) {
-        flag_set(FLAG_TX_BLOCK_QUEUEING, false);
-        VLOG(6) << __FUNCTION__ << " sd=" << sd << " congestion solved"
-                << " txqueue_pending_pkts" << txqueue_pending_pkts
-                << " txqueue_size_congestion_occurred"
-                << txqueue_size_congestion_occurred
-                << " txqueue_size_tx_threshold" << txqueue_size_tx_threshold
-                << " laddr=" << laddr.str() << " raddr=" << raddr.str();
+  } break;
+  default: {
 
-        crofsock_env::call_env(env).congestion_solved_indication(*this);
+    VLOG(6) << __FUNCTION__ << " unable to send in state=" << str()
+            << " on sd=" << sd;
+    tx_is_running = false;
+  }
+    return false;
+  }
+  return true;
+}
+
+int crofsock::send_txbuffer_iov() {
+  struct iovec iov[2 * TX_PAYLOADS_MAX + 1];
+  int iovcnt = 0;
+  size_t skip = tx_payloads_sent;
+  size_t offset = 0;
+
+  /* txbuffer segments interleaved with payloads, skipping sent bytes */
+  for (unsigned int i = 0; i <= tx_payloads.size(); i++) {
+    size_t end = (i < tx_payloads.size()) ? tx_payloads[i].offset
+                                           : txbuffer.rmemlen();
+    struct iovec segs[2] = {};
+    segs[0].iov_base = txbuffer.sormem() + offset;
+    segs[0].iov_len = end - offset;
+    if (i < tx_payloads.size()) {
+      segs[1] = tx_payloads[i].iov;
+    }
+    for (unsigned int j = 0; j < 2; j++) {
+      if (skip >= segs[j].iov_len) {
+        skip -= segs[j].iov_len;
+        continue;
       }
+      iov[iovcnt].iov_base = (uint8_t *)segs[j].iov_base + skip;
+      iov[iovcnt].iov_len = segs[j].iov_len - skip;
+      iovcnt++;
+      skip = 0;
     }
+    offset = end;
+  }
+
+  struct msghdr msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.msg_iov = iov;
+  msg.msg_iovlen = iovcnt;
+  return ::sendmsg(sd, &msg, MSG_DONTWAIT | MSG_NOSIGNAL);
+}
 
-  } while (reschedule);
+void crofsock::linearize_txbuffer() {
+  cbuffer buffer(std::max(txbuffer.length(),
+                          txbuffer.rmemlen() + tx_payloads_bytes));
+  size_t offset = 0;
+  for (auto &payload : tx_payloads) {
+    memcpy(buffer.sowmem(), txbuffer.sormem() + offset,
+           payload.offset - offset);
+    buffer.wseek(payload.offset - offset);
+    memcpy(buffer.sowmem(), payload.iov.iov_base, payload.iov.iov_len);
+    buffer.wseek(payload.iov.iov_len);
+    offset = payload.offset;
+  }
+  memcpy(buffer.sowmem(), txbuffer.sormem() + offset,
+         txbuffer.rmemlen() - offset);
+  buffer.wseek(txbuffer.rmemlen() - offset);
+  buffer.rseek(tx_payloads_sent);
+  txbuffer = buffer;
+  release_tx_payloads();
+}
 
-  tx_is_running = false;
+void crofsock::capture_txbuffer(crofcapture *capture) {
+  struct iovec iov[2 * TX_PAYLOADS_MAX + 1];
+  int iovcnt = 0;
+  size_t offset = 0;
 
-  if ((txqueue_pending_pkts > 0) && (not flag_test(FLAG_TX_BLOCK_QUEUEING))) {
-    cthread::thread(tx_thread_num).wakeup(this);
+  /* txbuffer segments interleaved with payloads */
+  for (auto &payload : tx_payloads) {
+    iov[iovcnt].iov_base = txbuffer.sormem() + offset;
+    iov[iovcnt].iov_len = payload.offset - offset;
+    iovcnt++;
+    iov[iovcnt++] = payload.iov;
+    offset = payload.offset;
+  }
+  iov[iovcnt].iov_base = txbuffer.sormem() + offset;
+  iov[iovcnt].iov_len = txbuffer.rmemlen() - offset;
+  iovcnt++;
+
+  capture->append(crofcapture::DIR_TX, iov, iovcnt);
+}
+
+void crofsock::release_tx_payloads() {
+  for (auto msg : tx_payload_msgs) {
+    delete msg;
   }
+  tx_payload_msgs.clear();
+  tx_payloads.clear();
+  tx_payloads_bytes = 0;
+  tx_payloads_sent = 0;
 }
 
 void crofsock::handle_read_event(cthread &thread, int fd) {
@@ -1961,6 +2322,11 @@ void crofsock::handle_read_event_rxthread(cthread &thread, int fd) {
 }
 
 void crofsock::recv_message() {
+  if (RX_MODE_BATCH == rx_mode) {
+    recv_message_batch();
+    return;
+  }
+
   int nbytes = 0;
   while (not rx_disabled) {
 
@@ -1995,6 +2361,7 @@ void crofsock::recv_message() {
       /* read from socket more bytes, at most "msg_len - msg_bytes_read" */
       nbytes = ::recv(sd, (void *)(rxbuffer.sowmem()),
                       msg_len - rxbuffer.rmemlen(), MSG_DONTWAIT);
+      rx_syscalls++;
 
       if (nbytes < 0) {
         switch (errno) {
@@ -2031,6 +2398,7 @@ void crofsock::recv_message() {
                                (msg_len - rxbuffer.rmemlen()))) <= 0) {
           err_code = SSL_get_error(ssl, nbytes);
         }
+        rx_syscalls++;
 
         VLOG(6) << __FUNCTION__ << " TLS: SSL_read on sd=" << sd
                 << " nbytes: " << nbytes << " errno: " << errno << " ("
@@ -2117,8 +2485,163 @@ void crofsock::recv_message() {
 
       /* ok, message was received completely */
       if (msg_len == rxbuffer.rmemlen()) {
-        parse_message();
+        /* rxbuffer content remains valid until the next read, but reset
+         * it first, as handle_recv() may close this socket */
+        rx_messages++;
+        rxbuffer.reset();
+        parse_message(rxbuffer.somem(), msg_len);
+      }
+    }
+  }
+
+  return;
+
+on_error:
+
+  switch (state.load()) {
+  case STATE_TCP_ESTABLISHED:
+  case STATE_TLS_ESTABLISHED: {
+    close();
+
+    if (flag_test(FLAG_RECONNECT_ON_FAILURE)) {
+      backoff_reconnect(true);
+    }
+
+    try {
+      crofsock_env::call_env(env).handle_closed(*this);
+    } catch (std::runtime_error &e) {
+      VLOG(1) << __FUNCTION__ << " sd=" << sd
+              << " caught runtime error, what: %s" << e.what()
+              << " laddr=" << laddr.str() << " raddr=" << raddr.str();
+    }
+    // WARNING: handle_closed might delete this socket, don't call anything here
+  } break;
+  default: { VLOG(6) << __FUNCTION__ << " error in state=" << str(); };
+  }
+}
+
+void crofsock::recv_message_batch() {
+  /* complete messages left in rxbuffer while reception was disabled */
+  if (not parse_rxbuffer()) {
+    goto on_error;
+  }
+
+  while (not rx_disabled) {
+
+    if ((get_state() <= STATE_IDLE) || delete_in_progress()) {
+      VLOG(6) << __FUNCTION__ << "() ignoring message sd=" << sd
+              << " laddr=" << laddr.str() << " raddr=" << raddr.str()
+              << " state=" << state;
+      return;
+    }
+
+    /* move a trailing message fragment to the start of rxbuffer, once the
+     * remaining space cannot hold a message of maximum size anymore */
+    if ((rxbuffer.wmemlen() < 65536) &&
+        (rxbuffer.sormem() != rxbuffer.somem())) {
+      size_t fraglen = rxbuffer.rmemlen();
+      memmove(rxbuffer.somem(), rxbuffer.sormem(), fraglen);
+      rxbuffer.rseek(0, SEEK_SET);
+      rxbuffer.wseek(fraglen, SEEK_SET);
+    }
+
+    size_t rxlen = rxbuffer.wmemlen();
+    int nbytes = 0;
+
+    switch (state.load()) {
+    case STATE_TCP_ESTABLISHED: {
+      /* read as many bytes as available, at most "rxlen" */
+      nbytes = ::recv(sd, (void *)(rxbuffer.sowmem()), rxlen, MSG_DONTWAIT);
+      rx_syscalls++;
+
+      if (nbytes < 0) {
+        switch (errno) {
+        case EAGAIN: {
+          VLOG(6) << __FUNCTION__ << " EAGAIN on sd=" << sd;
+          return;
+        } break;
+        default: {
+          VLOG(1) << __FUNCTION__
+                  << " ::recv() syscall failed, error: " << errno << ": "
+                  << strerror(errno) << " laddr=" << laddr.str()
+                  << " raddr=" << raddr.str();
+          goto on_error;
+        };
+        }
+      } else if (nbytes == 0) {
+        /* shutdown from peer */
+        VLOG(6) << __FUNCTION__ << " TCP: peer shutdown sd=" << sd
+                << " laddr=" << laddr.str() << " raddr=" << raddr.str();
+        goto on_error;
+      }
+    } break;
+    case STATE_TLS_ESTABLISHED: {
+      int err_code = 0;
+
+      {
+        AcquireReadWriteLock lock(sslock);
+
+        /* read as many bytes as available, at most "rxlen" */
+        if ((nbytes = SSL_read(ssl, (void *)(rxbuffer.sowmem()), rxlen)) <=
+            0) {
+          err_code = SSL_get_error(ssl, nbytes);
+        }
+        rx_syscalls++;
+      }
+
+      if (nbytes <= 0) {
+        switch (err_code) {
+        case SSL_ERROR_WANT_READ: {
+          VLOG(6) << __FUNCTION__ << " TLS: SSL_read WANT READ on sd=" << sd;
+        }
+          return;
+        case SSL_ERROR_WANT_WRITE: {
+          VLOG(6) << __FUNCTION__ << " TLS: SSL_read WANT WRITE on sd=" << sd;
+          cthread::thread(tx_thread_num).add_write_fd(this, sd);
+        }
+          return;
+        case SSL_ERROR_SYSCALL: {
+          VLOG(6) << __FUNCTION__
+                  << " TLS: SSL_read failed ERROR SYSCALL on sd=" << sd
+                  << " nbytes: " << nbytes << " errno: " << errno << " ("
+                  << strerror(errno) << ")";
+          tls_log_errors();
+        }
+          goto on_error;
+        case SSL_ERROR_SSL:
+        case SSL_ERROR_ZERO_RETURN: {
+          VLOG(6) << __FUNCTION__ << " TLS: SSL_read failed on sd=" << sd
+                  << " laddr=" << laddr.str() << " raddr=" << raddr.str();
+        }
+          goto on_error;
+        default: {
+          VLOG(6) << __FUNCTION__ << " TLS: SSL_read failed sd=" << sd;
+        }
+          return;
+        }
       }
+
+    } break;
+    default: {
+      VLOG(6) << __FUNCTION__ << " unable to receive in state=" << str()
+              << " on sd=" << sd;
+    }
+      return;
+    }
+
+    rxbuffer.wseek(nbytes);
+
+    if (not parse_rxbuffer()) {
+      goto on_error;
+    }
+    if ((get_state() <= STATE_IDLE) || delete_in_progress()) {
+      return;
+    }
+
+    /* a short read on a TCP socket indicates an empty receive queue in
+     * the kernel, so we can skip the final ::recv() returning EAGAIN */
+    if ((STATE_TCP_ESTABLISHED == state) && ((size_t)nbytes < rxlen)) {
+      return;
     }
   }
 
@@ -2129,6 +2652,8 @@ on_error:
   switch (state.load()) {
   case STATE_TCP_ESTABLISHED:
   case STATE_TLS_ESTABLISHED: {
+    rxbuffer.reset();
+
     close();
 
     if (flag_test(FLAG_RECONNECT_ON_FAILURE)) {
@@ -2148,13 +2673,50 @@ on_error:
   }
 }
 
-void crofsock::parse_message() {
+bool crofsock::parse_rxbuffer() {
+  while ((not rx_disabled) &&
+         (rxbuffer.rmemlen() >= sizeof(struct openflow::ofp_header))) {
+    struct openflow::ofp_header *header =
+        (struct openflow::ofp_header *)(rxbuffer.sormem());
+    uint16_t msg_len = be16toh(header->length);
+
+    /* sanity check: 8 <= msg_len <= 2^16 */
+    if (msg_len < sizeof(struct openflow::ofp_header)) {
+      VLOG(6) << __FUNCTION__ << " TCP: openflow out-of-sync sd=" << sd
+              << " laddr=" << laddr.str() << " raddr=" << raddr.str();
+      return false;
+    }
+
+    /* incomplete message, wait for more data */
+    if (msg_len > rxbuffer.rmemlen()) {
+      break;
+    }
+
+    /* consume message before parsing, see recv_message() */
+    uint8_t *buf = rxbuffer.sormem();
+    rxbuffer.rseek(msg_len);
+    rx_messages++;
+    parse_message(buf, msg_len);
+
+    if ((get_state() <= STATE_IDLE) || delete_in_progress()) {
+      break;
+    }
+  }
+  return true;
+}
+
+void crofsock::parse_message(uint8_t *buf, size_t buflen) {
   struct rofl::openflow::ofp_header *hdr =
-      (struct rofl::openflow::ofp_header *)rxbuffer.somem();
+      (struct rofl::openflow::ofp_header *)buf;
+
+  crofcapture *capture = this->capture;
+  if (capture) {
+    capture->append(crofcapture::DIR_RX, buf, buflen);
+  }
 
   rofl::openflow::cofmsg *msg = (rofl::openflow::cofmsg *)0;
   try {
-    if (rxbuffer.length() < sizeof(struct rofl::openflow::ofp_header)) {
+    if (buflen < sizeof(struct rofl::openflow::ofp_header)) {
       throw eBadRequestBadLen("eBadRequestBadLen", __FILE__, __FUNCTION__,
                               __LINE__);
     }
@@ -2162,13 +2724,13 @@ void crofsock::parse_message() {
     /* make sure to have a valid cofmsg* msg object after parsing */
     switch (hdr->version) {
     case rofl::openflow10::OFP_VERSION: {
-      parse_of10_message(&msg);
+      parse_of10_message(buf, buflen, &msg);
     } break;
     case rofl::openflow12::OFP_VERSION: {
-      parse_of12_message(&msg);
+      parse_of12_message(buf, buflen, &msg);
     } break;
     case rofl::openflow13::OFP_VERSION: {
-      parse_of13_message(&msg);
+      parse_of13_message(buf, buflen, &msg);
     } break;
     default: {
       throw eBadRequestBadVersion("eBadRequestBadVersion", __FILE__,
@@ -2192,8 +2754,7 @@ void crofsock::parse_message() {
             << " laddr=" << laddr.str() << " raddr=" << raddr.str();
 
     send_message(new rofl::openflow::cofmsg_error_bad_request_bad_type(
-        hdr->version, be32toh(hdr->xid), rxbuffer.somem(),
-        (rxbuffer.rmemlen() > 64) ? 64 : rxbuffer.rmemlen()));
+        hdr->version, be32toh(hdr->xid), buf, (buflen > 64) ? 64 : buflen));
 
   } catch (eBadRequestBadStat &e) {
 
@@ -2201,8 +2762,7 @@ void crofsock::parse_message() {
             << " laddr=" << laddr.str() << " raddr=" << raddr.str();
 
     send_message(new rofl::openflow::cofmsg_error_bad_request_bad_stat(
-        hdr->version, be32toh(hdr->xid), rxbuffer.somem(),
-        (rxbuffer.rmemlen() > 64) ? 64 : rxbuffer.rmemlen()));
+        hdr->version, be32toh(hdr->xid), buf, (buflen > 64) ? 64 : buflen));
 
   } catch (eBadRequestBadVersion &e) {
 
@@ -2213,8 +2773,7 @@ void crofsock::parse_message() {
       delete msg;
 
     send_message(new rofl::openflow::cofmsg_error_bad_request_bad_version(
-        hdr->version, be32toh(hdr->xid), rxbuffer.somem(),
-        (rxbuffer.rmemlen() > 64) ? 64 : rxbuffer.rmemlen()));
+        hdr->version, be32toh(hdr->xid), buf, (buflen > 64) ? 64 : buflen));
 
   } catch (eBadRequestBadLen &e) {
 
@@ -2226,8 +2785,7 @@ void crofsock::parse_message() {
       delete msg;
 
     send_message(new rofl::openflow::cofmsg_error_bad_request_bad_len(
-        hdr->version, be32toh(hdr->xid), rxbuffer.somem(),
-        (rxbuffer.rmemlen() > 64) ? 64 : rxbuffer.rmemlen()));
+        hdr->version, be32toh(hdr->xid), buf, (buflen > 64) ? 64 : buflen));
 
   } catch (rofl::exception &e) {
 
@@ -2243,9 +2801,10 @@ void crofsock::parse_message() {
   }
 }
 
-void crofsock::parse_of10_message(rofl::openflow::cofmsg **pmsg) {
+void crofsock::parse_of10_message(uint8_t *buf, size_t buflen,
+                                  rofl::openflow::cofmsg **pmsg) {
   struct openflow::ofp_header *header =
-      (struct openflow::ofp_header *)rxbuffer.somem();
+      (struct openflow::ofp_header *)buf;
 
   switch (header->type) {
   case rofl::openflow10::OFPT_HELLO: {
@@ -2297,13 +2856,13 @@ void crofsock::parse_of10_message(rofl::openflow::cofmsg **pmsg) {
     *pmsg = new rofl::openflow::cofmsg_port_status();
   } break;
   case rofl::openflow10::OFPT_STATS_REQUEST: {
-    if (rxbuffer.length() <
+    if (buflen <
         sizeof(struct rofl::openflow10::ofp_stats_request)) {
       throw eBadRequestBadLen("eBadRequestBadLen", __FILE__, __FUNCTION__,
                               __LINE__);
     }
     uint16_t stats_type = be16toh(
-        ((struct rofl::openflow10::ofp_stats_request *)rxbuffer.somem())->type);
+        ((struct rofl::openflow10::ofp_stats_request *)buf)->type);
     switch (stats_type) {
     case rofl::openflow10::OFPST_DESC: {
       *pmsg = new rofl::openflow::cofmsg_desc_stats_request();
@@ -2333,12 +2892,12 @@ void crofsock::parse_of10_message(rofl::openflow::cofmsg **pmsg) {
     }
   } break;
   case rofl::openflow10::OFPT_STATS_REPLY: {
-    if (rxbuffer.length() < sizeof(struct rofl::openflow10::ofp_stats_reply)) {
+    if (buflen < sizeof(struct rofl::openflow10::ofp_stats_reply)) {
       throw eBadRequestBadLen("eBadRequestBadLen", __FILE__, __FUNCTION__,
                               __LINE__);
     }
     uint16_t stats_type = be16toh(
-        ((struct rofl::openflow10::ofp_stats_reply *)rxbuffer.somem())->type);
+        ((struct rofl::openflow10::ofp_stats_reply *)buf)->type);
     switch (stats_type) {
     case rofl::openflow10::OFPST_DESC: {
       *pmsg = new rofl::openflow::cofmsg_desc_stats_reply();
@@ -2385,13 +2944,13 @@ void crofsock::parse_of10_message(rofl::openflow::cofmsg **pmsg) {
   };
   }
 
-  (*(*pmsg)).unpack(rxbuffer.sormem(), rxbuffer.rmemlen());
-  rxbuffer.reset();
+  (*(*pmsg)).unpack(buf, buflen);
 }
 
-void crofsock::parse_of12_message(rofl::openflow::cofmsg **pmsg) {
+void crofsock::parse_of12_message(uint8_t *buf, size_t buflen,
+                                  rofl::openflow::cofmsg **pmsg) {
   struct openflow::ofp_header *header =
-      (struct openflow::ofp_header *)rxbuffer.somem();
+      (struct openflow::ofp_header *)buf;
 
   switch (header->type) {
   case rofl::openflow12::OFPT_HELLO: {
@@ -2449,13 +3008,13 @@ void crofsock::parse_of12_message(rofl::openflow::cofmsg **pmsg) {
     *pmsg = new rofl::openflow::cofmsg_table_mod();
   } break;
   case rofl::openflow12::OFPT_STATS_REQUEST: {
-    if (rxbuffer.length() <
+    if (buflen <
         sizeof(struct rofl::openflow12::ofp_stats_request)) {
       throw eBadRequestBadLen("eBadRequestBadLen", __FILE__, __FUNCTION__,
                               __LINE__);
     }
     uint16_t stats_type = be16toh(
-        ((struct rofl::openflow12::ofp_stats_request *)rxbuffer.somem())->type);
+        ((struct rofl::openflow12::ofp_stats_request *)buf)->type);
     switch (stats_type) {
     case rofl::openflow12::OFPST_DESC: {
       *pmsg = new rofl::openflow::cofmsg_desc_stats_request();
@@ -2494,12 +3053,12 @@ void crofsock::parse_of12_message(rofl::openflow::cofmsg **pmsg) {
     }
   } break;
   case rofl::openflow12::OFPT_STATS_REPLY: {
-    if (rxbuffer.length() < sizeof(struct rofl::openflow12::ofp_stats_reply)) {
+    if (buflen < sizeof(struct rofl::openflow12::ofp_stats_reply)) {
       throw eBadRequestBadLen("eBadRequestBadLen", __FILE__, __FUNCTION__,
                               __LINE__);
     }
     uint16_t stats_type = be16toh(
-        ((struct rofl::openflow12::ofp_stats_reply *)rxbuffer.somem())->type);
+        ((struct rofl::openflow12::ofp_stats_reply *)buf)->type);
     switch (stats_type) {
     case rofl::openflow12::OFPST_DESC: {
       *pmsg = new rofl::openflow::cofmsg_desc_stats_reply();
@@ -2570,13 +3129,13 @@ void crofsock::parse_of12_message(rofl::openflow::cofmsg **pmsg) {
   };
   }
 
-  (*(*pmsg)).unpack(rxbuffer.sormem(), rxbuffer.rmemlen());
-  rxbuffer.reset();
+  (*(*pmsg)).unpack(buf, buflen);
 }
 
-void crofsock::parse_of13_message(rofl::openflow::cofmsg **pmsg) {
+void crofsock::parse_of13_message(uint8_t *buf, size_t buflen,
+                                  rofl::openflow::cofmsg **pmsg) {
   struct openflow::ofp_header *header =
-      (struct openflow::ofp_header *)rxbuffer.somem();
+      (struct openflow::ofp_header *)buf;
 
   switch (header->type) {
   case rofl::openflow13::OFPT_HELLO: {
@@ -2634,13 +3193,13 @@ void crofsock::parse_of13_message(rofl::openflow::cofmsg **pmsg) {
     *pmsg = new rofl::openflow::cofmsg_table_mod();
   } break;
   case rofl::openflow13::OFPT_MULTIPART_REQUEST: {
-    if (rxbuffer.memlen() <
+    if (buflen <
         sizeof(struct rofl::openflow13::ofp_multipart_request)) {
       throw eBadRequestBadLen("eBadRequestBadLen", __FILE__, __FUNCTION__,
                               __LINE__);
     }
     uint16_t stats_type = be16toh(
-        ((struct rofl::openflow13::ofp_multipart_request *)rxbuffer.somem())
+        ((struct rofl::openflow13::ofp_multipart_request *)buf)
             ->type);
     switch (stats_type) {
     case rofl::openflow13::OFPMP_DESC: {
@@ -2695,13 +3254,13 @@ void crofsock::parse_of13_message(rofl::openflow::cofmsg **pmsg) {
     }
   } break;
   case rofl::openflow13::OFPT_MULTIPART_REPLY: {
-    if (rxbuffer.memlen() <
+    if (buflen <
         sizeof(struct rofl::openflow13::ofp_multipart_reply)) {
       throw eBadRequestBadLen("eBadRequestBadLen", __FILE__, __FUNCTION__,
                               __LINE__);
     }
     uint16_t stats_type = be16toh(
-        ((struct rofl::openflow13::ofp_multipart_reply *)rxbuffer.somem())
+        ((struct rofl::openflow13::ofp_multipart_reply *)buf)
             ->type);
     switch (stats_type) {
     case rofl::openflow13::OFPMP_DESC: {
@@ -2791,6 +3350,5 @@ void crofsock::parse_of13_message(rofl::openflow::cofmsg **pmsg) {
   };
   }
 
-  (*(*pmsg)).unpack(rxbuffer.sormem(), rxbuffer.rmemlen());
-  rxbuffer.reset();
+  (*(*pmsg)).unpack(buf, buflen);
 }
@@ -17,12 +17,14 @@
 #include <assert.h>
 #include <atomic>
 #include <bitset>
+#include <condition_variable>
 #include <deque>
 #include <fcntl.h>
 #include <inttypes.h>
 #include <iostream>
 #include <list>
 #include <map>
+#include <mutex>
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <set>
@@ -34,6 +36,7 @@
 #include <sys/uio.h>
 #include <sys/un.h>
 #include <unistd.h>
+#include <vector>
 
 #include <openssl/bio.h>
 #include <openssl/conf.h>
@@ -44,9 +47,12 @@
 
 #include "rofl/common/cbuffer.hpp"
 #include "rofl/common/cmemory.h"
+#include "rofl/common/crofcapture.h"
+#include "rofl/common/ctlscontext.h"
 
 #include "rofl/common/crandom.h"
 #include "rofl/common/crofqueue.h"
+#include "rofl/common/crofsched.h"
 #include "rofl/common/csockaddr.h"
 #include "rofl/common/cthread.hpp"
 #include "rofl/common/exception.hpp"
@@ -162,10 +168,8 @@ public:
     if (crofsock_env::socket_envs.find(env) ==
         crofsock_env::socket_envs.end()) {
       throw eRofSockNotFound(
-          "crofsock_env::call_env() crofsock_env instance not found")
-          .set_func(__FUNCTION__)
-          .set_file(__FILE__)
-          .set_line(__LINE__);
+          "crofsock_env::call_env() crofsock_env instance not found", __FILE__,
+          __FUNCTION__, __LINE__);
     }
     return *(env);
   };
@@ -236,6 +240,8 @@ class crofsock : public cthread_env {
     FLAG_RECONNECT_ON_FAILURE,
     FLAG_TLS_IN_USE,
     FLAG_CLOSING,
+    FLAG_REPLAY,
+    FLAG_TLS_SESSION_REUSED,
   };
 
   enum socket_mode_t {
@@ -272,6 +278,11 @@ public:
     MSG_QUEUEING_FAILED_SHUTDOWN_IN_PROGRESS,
   };
 
+  enum rx_mode_t {
+    RX_MODE_MESSAGE, // read header and body of each message separately
+    RX_MODE_BATCH,   // fill rxbuffer in one call and parse all messages
+  };
+
 public:
   /**
    *
@@ -389,6 +400,154 @@ public:
     return state;
   };
 
+public:
+  /**
+   * @brief	Returns receive mode
+   */
+  rx_mode_t get_rx_mode() const { return rx_mode; };
+
+  /**
+   * @brief	Sets receive mode
+   *
+   * In RX_MODE_BATCH a single ::recv()/SSL_read() call fills the
+   * receive buffer with as many bytes as the socket holds, and all
+   * complete messages are parsed in place before reading again.
+   * A trailing message fragment stays in the buffer and is completed
+   * by the next read. Must be called before the socket is established.
+   *
+   * @param rx_mode receive mode
+   * @param rxbuffer_size size of receive buffer in RX_MODE_BATCH
+   */
+  crofsock &set_rx_mode(rx_mode_t rx_mode,
+                        size_t rxbuffer_size = RXBUFFER_BATCH_SIZE_DEFAULT);
+
+  /**
+   * @brief	Returns number of receive syscalls issued on this socket
+   */
+  uint64_t get_rx_syscalls() const { return rx_syscalls; };
+
+  /**
+   * @brief	Returns number of messages received on this socket
+   */
+  uint64_t get_rx_messages() const { return rx_messages; };
+
+public:
+  /**
+   * @brief	Returns maximum number of bytes packed into a single send call
+   */
+  size_t get_tx_batch_bytes() const { return tx_batch_bytes; };
+
+  /**
+   * @brief	Returns maximum time in microseconds spent on packing a batch
+   */
+  unsigned int get_tx_batch_usecs() const { return tx_batch_usecs; };
+
+  /**
+   * @brief	Sets budget for coalescing queued messages
+   *
+   * Messages taken from the txqueues in deficit round robin order are
+   * packed back to back into txbuffer and handed over to the kernel
+   * in a single ::send()/SSL_write() call, until either the byte or
+   * the time budget is exhausted. Echo and barrier messages terminate
+   * a batch and are sent immediately. A zero budget sends each message
+   * on its own.
+   *
+   * On TCP connections, frames attached via
+   * cofmsg_packet_out::set_frame() and the wire buffer of a
+   * cofmsg_flow_mod_batch are not copied into txbuffer, but passed to
+   * ::sendmsg() as separate iovecs.
+   *
+   * @param tx_batch_bytes maximum size of a batch in bytes
+   * @param tx_batch_usecs maximum time for packing a batch in microseconds
+   */
+  crofsock &set_tx_batch_budget(size_t tx_batch_bytes,
+                                unsigned int tx_batch_usecs) {
+    this->tx_batch_bytes = tx_batch_bytes;
+    this->tx_batch_usecs = tx_batch_usecs;
+    return *this;
+  };
+
+  /**
+   * @brief	Returns number of send syscalls issued on this socket
+   */
+  uint64_t get_tx_syscalls() const { return tx_syscalls; };
+
+  /**
+   * @brief	Returns number of messages sent on this socket
+   */
+  uint64_t get_tx_messages() const { return tx_messages; };
+
+public:
+  /**
+   * @brief	Returns capture receiving all bytes sent and received
+   */
+  crofcapture *get_capture() const { return capture; };
+
+  /**
+   * @brief	Sets capture receiving all bytes sent and received
+   *
+   * Each received message and each batch handed over to the kernel is
+   * appended as a single record. The capture is not owned by this socket
+   * and must stay open until capturing is disabled again by passing
+   * nullptr or the socket is closed.
+   *
+   * @param capture capture opened for writing or nullptr
+   */
+  crofsock &set_capture(crofcapture *capture) {
+    this->capture = capture;
+    return *this;
+  };
+
+  /**
+   * @brief	Enters established state without a socket descriptor
+   *
+   * The socket acts as an accepted TCP connection for replaying a
+   * capture via replay(). Messages sent by upper layers are discarded
+   * as if they were sent successfully.
+   */
+  void replay_accept();
+
+  /**
+   * @brief	Feeds all received bytes stored in a capture through the
+   * message parser
+   *
+   * Runs in the calling thread instead of the RX thread and blocks while
+   * reception is disabled by upper layers. Stops early when the connection
+   * is closed.
+   *
+   * @param capture capture opened for reading
+   * @param paced when true, messages are delivered at their recorded time
+   * offsets, otherwise as fast as possible
+   * @return number of messages parsed
+   * @exception eRofSockInvalid socket not in replay mode
+   */
+  size_t replay(const crofcapture &capture, bool paced = false);
+
+public:
+  /**
+   * @brief	Returns number of bytes a txqueue may send per scheduling round
+   */
+  size_t get_tx_quantum(unsigned int queue_id) const {
+    return txsched.get_quantum(queue_id);
+  };
+
+  /**
+   * @brief	Sets number of bytes a txqueue may send per scheduling round
+   *
+   * txqueues are served in deficit round robin order, except QUEUE_OAM,
+   * which has strict priority over all other txqueues.
+   */
+  crofsock &set_tx_quantum(unsigned int queue_id, size_t quantum) {
+    txsched.set_quantum(queue_id, quantum);
+    return *this;
+  };
+
+  /**
+   * @brief	Returns txqueue scheduler with per queue message, byte and
+   * latency counters
+   */
+  const crofsched &get_tx_sched() const { return txsched; };
+
 public:
   /**
    * @brief	Returns capacity of transmission queues in messages
@@ -560,6 +719,31 @@ public:
     return *this;
   };
 
+public:
+  /**
+   * @brief	Enables resumption of the last TLS session on reconnect
+   *
+   * An active socket keeps the session of its last established TLS
+   * connection and offers it to the peer when connecting again, e.g.
+   * after backoff_reconnect(). Enabled by default.
+   */
+  crofsock &set_tls_session_reuse(bool tls_session_reuse) {
+    this->tls_session_reuse = tls_session_reuse;
+    return *this;
+  };
+
+  /**
+   *
+   */
+  bool get_tls_session_reuse() const { return tls_session_reuse; };
+
+  /**
+   * @brief	Returns true if the current TLS connection resumed a session
+   */
+  bool is_tls_session_reused() const {
+    return flag_test(FLAG_TLS_SESSION_REUSED);
+  };
+
   friend std::ostream &operator<<(std::ostream &os, crofsock const &rofsock) {
     os << "<crofsock: transport-connection-established: "
        << rofsock.is_established() << ">" << std::endl;
@@ -643,7 +827,7 @@ private:
 
   void tls_term_context();
 
-  static int tls_pswd_cb(char *buf, int size, int rwflag, void *userdata);
+  void tls_drop_session();
 
   bool tls_verify_ok();
 
@@ -652,16 +836,45 @@ private:
 private:
   void recv_message();
 
-  void parse_message();
+  void recv_message_batch();
+
+  /**
+   * @brief	Parses all complete messages in rxbuffer
+   *
+   * Stops when reception is disabled and leaves the remaining bytes in
+   * rxbuffer for rx_enable().
+   *
+   * @return false if the stream is out of sync
+   */
+  bool parse_rxbuffer();
+
+  void parse_message(uint8_t *buf, size_t buflen);
 
-  void parse_of10_message(rofl::openflow::cofmsg **pmsg);
+  void parse_of10_message(uint8_t *buf, size_t buflen,
+                          rofl::openflow::cofmsg **pmsg);
 
-  void parse_of12_message(rofl::openflow::cofmsg **pmsg);
+  void parse_of12_message(uint8_t *buf, size_t buflen,
+                          rofl::openflow::cofmsg **pmsg);
 
-  void parse_of13_message(rofl::openflow::cofmsg **pmsg);
+  void parse_of13_message(uint8_t *buf, size_t buflen,
+                          rofl::openflow::cofmsg **pmsg);
 
   void send_from_queue();
 
+  unsigned int pack_into_txbuffer();
+
+  bool flush_txbuffer();
+
+  int send_txbuffer_iov();
+
+  void linearize_txbuffer();
+
+  void release_tx_payloads();
+
+  void capture_txbuffer(crofcapture *capture);
+
+  void replay_wakeup();
+
 private:
   void backoff_reconnect(bool reset_timeout = false);
 
@@ -732,9 +945,18 @@ private:
    * OpenSSL related structures
    */
 
-  // SSL context
+  // SSL context, shared via ctlscontext
   SSL_CTX *ctx;
 
+  // TLS parameters ctx was acquired for
+  ctlscontext::params_t ctx_params;
+
+  // session of last established TLS connection (active sockets only)
+  SSL_SESSION *tls_session;
+
+  // offer tls_session when reconnecting
+  bool tls_session_reuse;
+
   // SSL session
   SSL *ssl;
 
@@ -760,9 +982,28 @@ private:
   // incomplete fragment message fragment received in last round
   cbuffer rxbuffer;
 
+  // receive mode
+  rx_mode_t rx_mode;
+
+  // default size of rxbuffer in RX_MODE_BATCH
+  static const size_t RXBUFFER_BATCH_SIZE_DEFAULT = 1048576;
+
+  // number of receive syscalls
+  std::atomic<uint64_t> rx_syscalls;
+
+  // number of received messages
+  std::atomic<uint64_t> rx_messages;
+
   // flag for RX reception on socket
   std::atomic_bool rx_disabled;
 
+  // capture for received and sent bytes, not owned
+  std::atomic<crofcapture *> capture;
+
+  // replay() waits here while reception is disabled
+  std::mutex replay_lock;
+  std::condition_variable replay_cond;
+
   /*
    * sending messages
    */
@@ -776,6 +1017,49 @@ private:
   // txthread is actively sending messages
   std::atomic_bool tx_is_running;
 
+  // maximum number of bytes per batch
+  std::atomic<size_t> tx_batch_bytes;
+
+  // maximum time for packing a batch in microseconds
+  std::atomic_uint tx_batch_usecs;
+
+  // default budgets for a batch
+  static const size_t TX_BATCH_BYTES_DEFAULT = 65536;
+  static const unsigned int TX_BATCH_USECS_DEFAULT = 100;
+
+  // number of messages stored in txbuffer
+  unsigned int tx_batch_msgs;
+
+  // payload of a message in txbuffer, sent without copying after the
+  // first offset bytes of txbuffer
+  class tx_payload_t {
+  public:
+    tx_payload_t(size_t offset, const struct iovec &iov)
+        : offset(offset), iov(iov){};
+    size_t offset;
+    struct iovec iov;
+  };
+
+  // payloads of the current batch in txbuffer order
+  std::vector<tx_payload_t> tx_payloads;
+  // messages owning tx_payloads, deleted once the batch has been sent
+  std::vector<rofl::openflow::cofmsg *> tx_payload_msgs;
+  // sum of payload lengths and bytes of the batch sent so far
+  size_t tx_payloads_bytes;
+  size_t tx_payloads_sent;
+
+  // maximum number of payloads per batch, keeps iovecs below IOV_MAX
+  static const unsigned int TX_PAYLOADS_MAX = 256;
+
+  // deficit round robin scheduler for txqueues
+  crofsched txsched;
+
+  // number of send syscalls
+  std::atomic<uint64_t> tx_syscalls;
+
+  // number of sent messages
+  std::atomic<uint64_t> tx_messages;
+
   /*
    * scheduler and txqueues
    */
@@ -791,9 +1075,6 @@ private:
 
   // QUEUE_MAX txqueues
   std::vector<crofqueue> txqueues;
-
-  // relative scheduling weights for txqueues
-  std::vector<unsigned int> txweights;
 };
 
 } /* namespace rofl */
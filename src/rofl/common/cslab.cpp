@@ -0,0 +1,285 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * cslab.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include "rofl/common/cslab.hpp"
+
+#include <stdlib.h>
+
+#include <atomic>
+#include <new>
+#include <set>
+#include <vector>
+
+#include "rofl/common/locking.hpp"
+
+namespace rofl {
+
+namespace {
+
+// smallest size class
+const size_t SLAB_MIN_SIZE = 32;
+// number of size classes: 32, 64, ..., 2048 bytes
+const unsigned int SLAB_NUM_CLASSES = 7;
+// largest size class
+const size_t SLAB_MAX_SIZE = SLAB_MIN_SIZE << (SLAB_NUM_CLASSES - 1);
+// memory carved into blocks of a single size class
+const size_t SLAB_CHUNK_SIZE = 65536;
+
+/*
+ * header preceding each object, keeps the payload 16 byte aligned
+ */
+struct cslab_block {
+  // owning cache, nullptr for objects allocated by malloc
+  cslab_cache *owner;
+  // size class index
+  uint32_t size_class;
+  uint32_t pad;
+};
+
+/*
+ * link of a free block, stored in the block's payload
+ */
+inline cslab_block *&next_free(cslab_block *block) {
+  return *reinterpret_cast<cslab_block **>(block + 1);
+}
+
+inline unsigned int size_class_of(size_t size) {
+  if (size <= SLAB_MIN_SIZE)
+    return 0;
+  return (sizeof(unsigned long) * 8 - __builtin_clzl(size - 1)) - 5;
+}
+
+inline size_t block_size_of(unsigned int size_class) {
+  return sizeof(cslab_block) + (SLAB_MIN_SIZE << size_class);
+}
+
+/*
+ * increments a counter written by its owning thread only
+ */
+inline void count(std::atomic<uint64_t> &counter) {
+  counter.store(counter.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+}
+
+// cache of the calling thread
+thread_local cslab_cache *thread_cache = nullptr;
+
+}; // namespace
+
+class cslab_cache {
+public:
+  cslab_cache();
+
+  ~cslab_cache();
+
+  void *allocate(unsigned int size_class);
+
+  void free_local(cslab_block *block) {
+    next_free(block) = free_lists[block->size_class];
+    free_lists[block->size_class] = block;
+    count(frees);
+  };
+
+  void free_remote(cslab_block *block) {
+    std::atomic<cslab_block *> &head = remote_lists[block->size_class];
+    cslab_block *next = head.load(std::memory_order_relaxed);
+    do {
+      next_free(block) = next;
+    } while (not head.compare_exchange_weak(next, block,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed));
+    remote_frees.fetch_add(1, std::memory_order_relaxed);
+  };
+
+  /*
+   * drops one reference, destroys the cache when the last one is gone
+   */
+  void release() {
+    if (refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      delete this;
+    }
+  };
+
+  void add_to(cslab_stats &stats) const;
+
+public:
+  // counters, large_mallocs are counted by cslab::allocate
+  std::atomic<uint64_t> allocs;
+  std::atomic<uint64_t> frees;
+  std::atomic<uint64_t> remote_frees;
+  std::atomic<uint64_t> chunk_mallocs;
+  std::atomic<uint64_t> large_mallocs;
+
+private:
+  void refill(unsigned int size_class);
+
+private:
+  // outstanding objects plus one reference held by the owning thread
+  std::atomic<size_t> refs;
+  // free lists used by the owning thread only
+  cslab_block *free_lists[SLAB_NUM_CLASSES];
+  // objects freed by other threads
+  std::atomic<cslab_block *> remote_lists[SLAB_NUM_CLASSES];
+  // chunks allocated by this cache
+  std::vector<void *> chunks;
+
+  // all caches and the counters of destroyed ones
+  static std::set<cslab_cache *> caches;
+  static cslab_stats retired;
+  static crwlock caches_lock;
+
+  friend class rofl::cslab;
+};
+
+/*static*/ std::set<cslab_cache *> cslab_cache::caches;
+/*static*/ cslab_stats cslab_cache::retired;
+/*static*/ crwlock cslab_cache::caches_lock;
+
+cslab_cache::cslab_cache()
+    : allocs(0), frees(0), remote_frees(0), chunk_mallocs(0), large_mallocs(0),
+      refs(1) {
+  for (unsigned int i = 0; i < SLAB_NUM_CLASSES; i++) {
+    free_lists[i] = nullptr;
+    remote_lists[i].store(nullptr, std::memory_order_relaxed);
+  }
+  AcquireReadWriteLock lock(caches_lock);
+  caches.insert(this);
+}
+
+cslab_cache::~cslab_cache() {
+  {
+    AcquireReadWriteLock lock(caches_lock);
+    caches.erase(this);
+    add_to(retired);
+  }
+  for (auto chunk : chunks) {
+    ::free(chunk);
+  }
+}
+
+void *cslab_cache::allocate(unsigned int size_class) {
+  cslab_block *block = free_lists[size_class];
+  if (block == nullptr) {
+    /* collect objects freed by other threads before carving a new chunk */
+    free_lists[size_class] =
+        remote_lists[size_class].exchange(nullptr, std::memory_order_acquire);
+    if (free_lists[size_class] == nullptr) {
+      refill(size_class);
+    }
+    block = free_lists[size_class];
+  }
+  free_lists[size_class] = next_free(block);
+  refs.fetch_add(1, std::memory_order_relaxed);
+  count(allocs);
+  return block + 1;
+}
+
+void cslab_cache::refill(unsigned int size_class) {
+  uint8_t *chunk = static_cast<uint8_t *>(::malloc(SLAB_CHUNK_SIZE));
+  if (chunk == nullptr) {
+    throw std::bad_alloc();
+  }
+  chunks.push_back(chunk);
+  count(chunk_mallocs);
+
+  size_t block_size = block_size_of(size_class);
+  cslab_block *head = nullptr;
+  for (size_t offset = 0; offset + block_size <= SLAB_CHUNK_SIZE;
+       offset += block_size) {
+    cslab_block *block = reinterpret_cast<cslab_block *>(chunk + offset);
+    block->owner = this;
+    block->size_class = size_class;
+    next_free(block) = head;
+    head = block;
+  }
+  free_lists[size_class] = head;
+}
+
+void cslab_cache::add_to(cslab_stats &stats) const {
+  stats.allocs += allocs.load(std::memory_order_relaxed);
+  stats.frees += frees.load(std::memory_order_relaxed) +
+                 remote_frees.load(std::memory_order_relaxed);
+  stats.remote_frees += remote_frees.load(std::memory_order_relaxed);
+  stats.chunk_mallocs += chunk_mallocs.load(std::memory_order_relaxed);
+  stats.large_mallocs += large_mallocs.load(std::memory_order_relaxed);
+}
+
+/*static*/ void *cslab::allocate(size_t size) {
+  cslab_cache *cache = thread_cache;
+  if ((cache != nullptr) && (size <= SLAB_MAX_SIZE)) {
+    return cache->allocate(size_class_of(size));
+  }
+  if (cache != nullptr) {
+    count(cache->large_mallocs);
+  }
+  cslab_block *block =
+      static_cast<cslab_block *>(::malloc(sizeof(cslab_block) + size));
+  if (block == nullptr) {
+    throw std::bad_alloc();
+  }
+  block->owner = nullptr;
+  block->size_class = 0;
+  return block + 1;
+}
+
+/*static*/ void cslab::deallocate(void *ptr) {
+  if (ptr == nullptr)
+    return;
+  cslab_block *block = static_cast<cslab_block *>(ptr) - 1;
+  cslab_cache *owner = block->owner;
+  if (owner == nullptr) {
+    ::free(block);
+    return;
+  }
+  if (owner == thread_cache) {
+    owner->free_local(block);
+  } else {
+    owner->free_remote(block);
+  }
+  owner->release();
+}
+
+/*static*/ size_t cslab::usable_size(void *ptr) {
+  if (ptr == nullptr)
+    return 0;
+  cslab_block *block = static_cast<cslab_block *>(ptr) - 1;
+  if (block->owner == nullptr)
+    return 0;
+  return SLAB_MIN_SIZE << block->size_class;
+}
+
+/*static*/ size_t cslab::get_max_size() { return SLAB_MAX_SIZE; }
+
+/*static*/ void cslab::thread_attach() {
+  if (thread_cache != nullptr)
+    return;
+  thread_cache = new cslab_cache();
+}
+
+/*static*/ void cslab::thread_detach() {
+  cslab_cache *cache = thread_cache;
+  if (cache == nullptr)
+    return;
+  thread_cache = nullptr;
+  cache->release();
+}
+
+/*static*/ bool cslab::is_attached() { return (thread_cache != nullptr); }
+
+/*static*/ cslab_stats cslab::get_stats() {
+  AcquireReadLock lock(cslab_cache::caches_lock);
+  cslab_stats stats(cslab_cache::retired);
+  for (auto cache : cslab_cache::caches) {
+    cache->add_to(stats);
+  }
+  return stats;
+}
+
+}; // end of namespace rofl
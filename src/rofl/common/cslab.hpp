@@ -0,0 +1,181 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * cslab.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SRC_ROFL_COMMON_CSLAB_HPP_
+#define SRC_ROFL_COMMON_CSLAB_HPP_
+
+#include <inttypes.h>
+#include <new>
+#include <ostream>
+#include <stddef.h>
+
+namespace rofl {
+
+class cslab_cache; // forward declaration
+
+/**
+ * @brief	Allocation counters of all slab caches
+ */
+class cslab_stats {
+public:
+  cslab_stats()
+      : allocs(0), frees(0), remote_frees(0), chunk_mallocs(0),
+        large_mallocs(0){};
+
+  /**
+   * @brief	Number of calls to malloc() issued on behalf of allocs
+   */
+  uint64_t get_mallocs() const { return chunk_mallocs + large_mallocs; };
+
+  /**
+   * @brief	Number of calls to malloc() saved by the slab caches
+   */
+  uint64_t get_mallocs_avoided() const {
+    return (allocs > get_mallocs()) ? allocs - get_mallocs() : 0;
+  };
+
+public:
+  friend std::ostream &operator<<(std::ostream &os, const cslab_stats &stats) {
+    os << "<cslab_stats allocs: " << stats.allocs << " frees: " << stats.frees
+       << " remote-frees: " << stats.remote_frees
+       << " chunk-mallocs: " << stats.chunk_mallocs
+       << " large-mallocs: " << stats.large_mallocs << " >";
+    return os;
+  };
+
+public:
+  // objects allocated by threads with a slab cache
+  uint64_t allocs;
+  // objects returned to a slab cache, including remote frees
+  uint64_t frees;
+  // objects returned by a thread other than the allocating one
+  uint64_t remote_frees;
+  // chunks allocated for refilling a size class
+  uint64_t chunk_mallocs;
+  // objects exceeding the largest size class
+  uint64_t large_mallocs;
+};
+
+/**
+ * @brief	Size-class slab allocator with per-thread caches
+ *
+ * Each thread attached via thread_attach() owns a cache with one free list
+ * per size class (32 to 2048 bytes). Free lists are refilled by carving
+ * 64KiB chunks, so allocating and freeing an object on its own thread
+ * involves neither malloc nor any lock.
+ *
+ * Objects may be freed on any thread. A foreign thread pushes the object on
+ * a lock-free stack of the owning cache, which the owner collects when its
+ * free list runs empty. A cache outlives its thread until its last object
+ * has been freed.
+ *
+ * Threads without a cache and objects above the largest size class fall
+ * back to malloc. Memory is returned to the system when a cache is
+ * destroyed only.
+ */
+class cslab {
+public:
+  /**
+   * @brief	Allocates size bytes from the calling thread's cache
+   */
+  static void *allocate(size_t size);
+
+  /**
+   * @brief	Returns memory obtained from allocate()
+   */
+  static void deallocate(void *ptr);
+
+  /**
+   * @brief	Returns usable size of memory obtained from allocate(), i.e.
+   * its size class, or 0 for memory allocated by malloc
+   */
+  static size_t usable_size(void *ptr);
+
+  /**
+   * @brief	Returns size of the largest size class
+   */
+  static size_t get_max_size();
+
+  /**
+   * @brief	Creates a cache for the calling thread
+   */
+  static void thread_attach();
+
+  /**
+   * @brief	Detaches the calling thread from its cache
+   */
+  static void thread_detach();
+
+  /**
+   * @brief	Returns true if the calling thread owns a cache
+   */
+  static bool is_attached();
+
+  /**
+   * @brief	Returns counters summed up over all caches
+   */
+  static cslab_stats get_stats();
+};
+
+/**
+ * @brief	Base class allocating derived objects via cslab
+ *
+ * Declares the complete set of class-specific new and delete operators,
+ * so array, nothrow and placement forms remain available to derived
+ * classes. Placement forms construct in the given memory.
+ */
+class cslab_object {
+public:
+  static void *operator new(size_t size) { return cslab::allocate(size); };
+
+  static void *operator new[](size_t size) { return cslab::allocate(size); };
+
+  static void *operator new(size_t size, const std::nothrow_t &) noexcept {
+    try {
+      return cslab::allocate(size);
+    } catch (std::bad_alloc &e) {
+      return nullptr;
+    }
+  };
+
+  static void *operator new[](size_t size, const std::nothrow_t &) noexcept {
+    try {
+      return cslab::allocate(size);
+    } catch (std::bad_alloc &e) {
+      return nullptr;
+    }
+  };
+
+  static void *operator new(size_t size, void *ptr) noexcept { return ptr; };
+
+  static void *operator new[](size_t size, void *ptr) noexcept { return ptr; };
+
+  static void operator delete(void *ptr) noexcept { cslab::deallocate(ptr); };
+
+  static void operator delete[](void *ptr) noexcept {
+    cslab::deallocate(ptr);
+  };
+
+  static void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    cslab::deallocate(ptr);
+  };
+
+  static void operator delete[](void *ptr, const std::nothrow_t &) noexcept {
+    cslab::deallocate(ptr);
+  };
+
+  static void operator delete(void *ptr, void *place) noexcept {};
+
+  static void operator delete[](void *ptr, void *place) noexcept {};
+};
+
+}; // end of namespace rofl
+
+#endif /* SRC_ROFL_COMMON_CSLAB_HPP_ */
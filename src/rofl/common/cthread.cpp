@@ -10,12 +10,23 @@
  */
 
 #include "cthread.hpp"
+#include "rofl/common/cslab.hpp"
+#include <algorithm>
 #include <glog/logging.h>
 #include <iostream>
+#include <iterator>
 #include <sys/eventfd.h>
 
 using namespace rofl;
 
+namespace {
+
+// job run by the calling thread and whether it has been dropped meanwhile
+thread_local cthread_job *running_job = nullptr;
+thread_local bool running_job_dropped = false;
+
+}; // namespace
+
 /*static*/ std::atomic_bool cthread::pool_initialized(false);
 /*static*/ std::map<uint32_t, cthread *> cthread::pool;
 /*static*/ crwlock cthread::pool_lock;
@@ -25,6 +36,15 @@ using namespace rofl;
 /*static*/ uint32_t cthread::pool_io_loop_index;
 /*static*/ uint32_t cthread::pool_num_hnd_threads;
 /*static*/ uint32_t cthread::pool_hnd_loop_index;
+/*static*/ cthread::timer_backend_t cthread::pool_timer_backend;
+/*static*/ cthread::allocator_t cthread::pool_allocator;
+/*static*/ cthread::hnd_scheduler_t cthread::pool_hnd_scheduler =
+    cthread::HND_SCHEDULER_STATIC;
+/*static*/ std::vector<cthread *> cthread::pool_hnd_threads;
+/*static*/ std::atomic<uint32_t> cthread::pool_sibling_index(0);
+/*static*/ std::mutex cthread::pool_drop_mutex;
+/*static*/ std::condition_variable cthread::pool_drop_cond;
+/*static*/ std::atomic<unsigned int> cthread::pool_drop_waiters(0);
 
 /*static*/ std::set<cthread_env *> cthread_env::envs;
 /*static*/ crwlock cthread_env::envs_lock;
@@ -67,7 +87,10 @@ using namespace rofl;
 
 /*static*/ void cthread::pool_initialize(uint32_t pool_num_hnd_threads,
                                          uint32_t pool_num_io_threads,
-                                         uint32_t pool_num_mgt_threads) {
+                                         uint32_t pool_num_mgt_threads,
+                                         timer_backend_t timer_backend,
+                                         allocator_t allocator,
+                                         hnd_scheduler_t hnd_scheduler) {
   AcquireReadWriteLock lock(cthread::pool_lock);
   if (cthread::pool_initialized)
     return;
@@ -82,11 +105,18 @@ using namespace rofl;
   cthread::pool_num_hnd_threads =
       (pool_num_hnd_threads == 0) ? 1 : pool_num_hnd_threads;
 
+  cthread::pool_timer_backend = timer_backend;
+  cthread::pool_allocator = allocator;
+  cthread::pool_hnd_scheduler = hnd_scheduler;
+
   /* number of IO threads should be an even number */
   if (cthread::pool_num_io_threads % 2) {
     cthread::pool_num_io_threads += 1;
   }
 
+  cthread::pool_hnd_threads.clear();
+  cthread::pool_hnd_threads.reserve(cthread::pool_num_hnd_threads);
+
   /* start offsets for loop indices */
   cthread::pool_mgt_loop_index = 0;
   cthread::pool_io_loop_index = cthread::pool_num_mgt_threads;
@@ -97,13 +127,17 @@ using namespace rofl;
        i < cthread::pool_io_loop_index; ++i) {
     std::stringstream thread_name;
     thread_name << "rofl-mgt-(" << (unsigned int)i << ")";
-    (cthread::pool[i] = new cthread(i))->start(thread_name.str());
+    (cthread::pool[i] = new cthread(i, cthread::pool_timer_backend,
+                                     cthread::pool_allocator))
+        ->start(thread_name.str());
   }
   for (uint32_t i = cthread::pool_io_loop_index;
        i < (cthread::pool_hnd_loop_index); ++i) {
     std::stringstream thread_name;
     thread_name << "rofl-io-(" << (unsigned int)i << ")";
-    (cthread::pool[i] = new cthread(i))->start(thread_name.str());
+    (cthread::pool[i] = new cthread(i, cthread::pool_timer_backend,
+                                     cthread::pool_allocator))
+        ->start(thread_name.str());
   }
   for (uint32_t i = cthread::pool_hnd_loop_index;
        i < (cthread::pool_num_mgt_threads + cthread::pool_num_io_threads +
@@ -111,7 +145,10 @@ using namespace rofl;
        ++i) {
     std::stringstream thread_name;
     thread_name << "rofl-app-(" << (unsigned int)i << ")";
-    (cthread::pool[i] = new cthread(i))->start(thread_name.str());
+    (cthread::pool[i] = new cthread(i, cthread::pool_timer_backend,
+                                     cthread::pool_allocator))
+        ->start(thread_name.str());
+    cthread::pool_hnd_threads.push_back(cthread::pool[i]);
   }
   cthread::pool_initialized = true;
 }
@@ -123,6 +160,7 @@ using namespace rofl;
   sleep(2);
   {
     AcquireReadWriteLock lock(cthread::pool_lock);
+    cthread::pool_hnd_threads.clear();
     for (uint32_t i = 0; i < cthread::pool.size(); ++i) {
       delete cthread::pool[i];
     }
@@ -178,6 +216,14 @@ using namespace rofl;
   return pool_io_loop_index;
 }
 
+/*static*/ uint32_t cthread::get_num_io_threads() {
+  if (not cthread::pool_initialized) {
+    cthread::pool_initialize();
+  }
+  AcquireReadLock lock(cthread::pool_lock);
+  return cthread::pool_num_io_threads;
+}
+
 /*static*/ uint32_t cthread::get_hnd_thread_num_from_pool() {
   if (not cthread::pool_initialized) {
     cthread::pool_initialize();
@@ -199,6 +245,14 @@ void cthread::initialize() {
 
   running = false;
   thread_tid = 0;
+  jobs_depth = 0;
+  jobs_stealable = 0;
+  jobs_run = 0;
+  jobs_stolen = 0;
+  fd_slots_num = 0;
+  for (uint32_t i = 0; i < FD_SLOTS_MAX_CHUNKS; i++) {
+    fd_slot_chunks[i].store(nullptr, std::memory_order_relaxed);
+  }
 
   // worker thread
   if ((epfd = epoll_create(1)) < 0) {
@@ -216,7 +270,7 @@ void cthread::initialize() {
   struct epoll_event epev;
   memset((uint8_t *)&epev, 0, sizeof(struct epoll_event));
   epev.events = EPOLLIN; // level-triggered
-  epev.data.fd = event_fd;
+  epev.data.u64 = EVENT_FD_COOKIE;
 
   if (epoll_ctl(epfd, EPOLL_CTL_ADD, event_fd, &epev) < 0) {
     switch (errno) {
@@ -246,6 +300,11 @@ void cthread::release() {
       epoll_ctl(epfd, EPOLL_CTL_DEL, it.first, &epev);
     }
     fds.clear();
+    fd_slots_free.clear();
+    for (uint32_t i = 0; i < FD_SLOTS_MAX_CHUNKS; i++) {
+      delete[] fd_slot_chunks[i].exchange(nullptr);
+    }
+    fd_slots_num = 0;
   }
 
   // deregister event_fd from kernel
@@ -280,10 +339,11 @@ void cthread::add_fd(cthread_env *env, int fd, bool exception,
     return;
 
   uint32_t events = edge_triggered ? EPOLLET : 0;
+  uint64_t cookie = alloc_fd_slot(env, fd);
   struct epoll_event epev;
   memset((uint8_t *)&epev, 0, sizeof(struct epoll_event));
   epev.events = events;
-  epev.data.fd = fd;
+  epev.data.u64 = cookie;
 
   VLOG(7) << __FUNCTION__ << " fd=" << fd << " env=" << env
           << " edge-triggered=" << edge_triggered << " thread: "
@@ -297,15 +357,16 @@ void cthread::add_fd(cthread_env *env, int fd, bool exception,
       /* do nothing */
     } break;
     default: {
-      if (exception)
+      if (exception) {
+        free_fd_slot(cookie);
         throw eSysCall("eSysCall", "epoll_ctl (EPOLL_CTL_ADD)", __FILE__,
                        __FUNCTION__, __LINE__);
+      }
     };
     }
   }
 
-  fds[fd].events = events;
-  fds[fd].env = env;
+  fds[fd] = fd_priv_data_t(events, env, cookie);
 }
 
 void cthread::drop_fd(int fd, bool exception) {
@@ -335,6 +396,7 @@ void cthread::drop_fd(int fd, bool exception) {
     }
   }
 
+  free_fd_slot(fds[fd].cookie);
   fds.erase(fd);
 }
 
@@ -349,7 +411,7 @@ void cthread::add_read_fd(cthread_env *env, int fd, bool exception,
   struct epoll_event epev;
   memset((uint8_t *)&epev, 0, sizeof(struct epoll_event));
   epev.events = fds[fd].events;
-  epev.data.fd = fd;
+  epev.data.u64 = fds[fd].cookie;
 
   VLOG(7) << __FUNCTION__ << " fd=" << fd << " env=" << env
           << " edge-triggered=" << edge_triggered << " thread: "
@@ -381,7 +443,7 @@ void cthread::drop_read_fd(int fd, bool exception) {
   struct epoll_event epev;
   memset((uint8_t *)&epev, 0, sizeof(struct epoll_event));
   epev.events = fds[fd].events;
-  epev.data.fd = fd;
+  epev.data.u64 = fds[fd].cookie;
 
   VLOG(7) << __FUNCTION__ << " fd=" << fd << " thread: "
           << " tid=0x" << std::hex << thread_tid << std::dec
@@ -413,7 +475,7 @@ void cthread::add_write_fd(cthread_env *env, int fd, bool exception,
   struct epoll_event epev;
   memset((uint8_t *)&epev, 0, sizeof(struct epoll_event));
   epev.events = fds[fd].events;
-  epev.data.fd = fd;
+  epev.data.u64 = fds[fd].cookie;
 
   VLOG(7) << __FUNCTION__ << " fd=" << fd << " env=" << env
           << " edge-triggered=" << edge_triggered << " thread: "
@@ -445,7 +507,7 @@ void cthread::drop_write_fd(int fd, bool exception) {
   struct epoll_event epev;
   memset((uint8_t *)&epev, 0, sizeof(struct epoll_event));
   epev.events = fds[fd].events;
-  epev.data.fd = fd;
+  epev.data.u64 = fds[fd].cookie;
 
   VLOG(7) << __FUNCTION__ << " fd=" << fd << " thread: "
           << " tid=0x" << std::hex << thread_tid << std::dec
@@ -475,19 +537,76 @@ restart:
       memset((uint8_t *)&epev, 0, sizeof(struct epoll_event));
       epev.data.fd = it->first;
       epoll_ctl(epfd, EPOLL_CTL_DEL, it->first, &epev);
+      free_fd_slot(it->second.cookie);
       fds.erase(it);
       goto restart;
     }
   }
 }
 
+uint64_t cthread::alloc_fd_slot(cthread_env *env, int fd) {
+  uint32_t index = 0;
+  if (not fd_slots_free.empty()) {
+    index = fd_slots_free.back();
+    fd_slots_free.pop_back();
+  } else {
+    if (fd_slots_num == FD_SLOTS_PER_CHUNK * FD_SLOTS_MAX_CHUNKS)
+      throw eThreadInvalid("no free file descriptor slot");
+    index = fd_slots_num++;
+    if ((index % FD_SLOTS_PER_CHUNK) == 0) {
+      fd_slot_t *chunk = new fd_slot_t[FD_SLOTS_PER_CHUNK];
+      for (uint32_t i = 0; i < FD_SLOTS_PER_CHUNK; i++) {
+        chunk[i].generation.store(0, std::memory_order_relaxed);
+        chunk[i].env.store(nullptr, std::memory_order_relaxed);
+        chunk[i].fd.store(-1, std::memory_order_relaxed);
+      }
+      fd_slot_chunks[index / FD_SLOTS_PER_CHUNK].store(
+          chunk, std::memory_order_release);
+    }
+  }
+  fd_slot_t &slot = fd_slot_chunks[index / FD_SLOTS_PER_CHUNK].load(
+      std::memory_order_relaxed)[index % FD_SLOTS_PER_CHUNK];
+  slot.fd.store(fd, std::memory_order_relaxed);
+  slot.env.store(env, std::memory_order_release);
+  return ((uint64_t)slot.generation.load() << 32) | index;
+}
+
+void cthread::free_fd_slot(uint64_t cookie) {
+  uint32_t index = cookie & 0xffffffff;
+  fd_slot_t &slot = fd_slot_chunks[index / FD_SLOTS_PER_CHUNK].load(
+      std::memory_order_relaxed)[index % FD_SLOTS_PER_CHUNK];
+  /* invalidate pending events before the slot may be reused */
+  slot.generation.fetch_add(1);
+  slot.env.store(nullptr, std::memory_order_release);
+  fd_slots_free.push_back(index);
+}
+
 void cthread::clear_timers() {
   AcquireReadWriteLock lock(tlock);
   ordered_timers.clear();
+  timer_wheel.clear();
 };
 
 bool cthread::add_timer(cthread_env *env, uint32_t timer_id,
                         const ctimespec &tspec) {
+  if (timer_backend == TIMER_BACKEND_WHEEL) {
+    bool rv;
+    bool do_wakeup = false;
+    {
+      AcquireReadWriteLock lock(tlock);
+      int timeout = timer_wheel.get_relative_timeout();
+      if ((timeout < 0) || (tspec.get_relative_timeout() < timeout))
+        do_wakeup = true;
+      rv = timer_wheel.add_timer(env, timer_id, tspec);
+    }
+
+    if ((do_wakeup) && (thread_tid != pthread_self())) {
+      wakeup();
+    }
+
+    return rv;
+  }
+
   std::pair<std::set<ctimer>::iterator, bool> rv;
   bool do_wakeup = false;
   {
@@ -515,6 +634,13 @@ bool cthread::add_timer(cthread_env *env, uint32_t timer_id,
 
 const ctimer &cthread::get_timer(cthread_env *env, uint32_t timer_id) const {
   AcquireReadLock lock(tlock);
+  if (timer_backend == TIMER_BACKEND_WHEEL) {
+    const ctimer *timer = timer_wheel.find_timer(env, timer_id);
+    if (timer == nullptr) {
+      throw eThreadNotFound("cthread::get_timer() timer_id not found");
+    }
+    return *timer;
+  }
   auto timer_it = find_if(ordered_timers.begin(), ordered_timers.end(),
                           ctimer_find_by_timer_env_and_id(env, timer_id));
   if (timer_it == ordered_timers.end()) {
@@ -525,6 +651,9 @@ const ctimer &cthread::get_timer(cthread_env *env, uint32_t timer_id) const {
 
 bool cthread::drop_timer(cthread_env *env, uint32_t timer_id) {
   AcquireReadWriteLock lock(tlock);
+  if (timer_backend == TIMER_BACKEND_WHEEL) {
+    return timer_wheel.drop_timer(env, timer_id);
+  }
   auto timer_it = find_if(ordered_timers.begin(), ordered_timers.end(),
                           ctimer_find_by_timer_env_and_id(env, timer_id));
   if (timer_it == ordered_timers.end()) {
@@ -541,6 +670,10 @@ bool cthread::drop_timer(cthread_env *env, uint32_t timer_id) {
 
 void cthread::drop_timers(cthread_env *env) {
   AcquireReadWriteLock lock(tlock);
+  if (timer_backend == TIMER_BACKEND_WHEEL) {
+    timer_wheel.drop_timers(env);
+    return;
+  }
   bool do_wakeup = false;
   std::set<ctimer>::iterator pos;
   while ((pos = find_if(ordered_timers.begin(), ordered_timers.end(),
@@ -556,6 +689,9 @@ void cthread::drop_timers(cthread_env *env) {
 
 bool cthread::has_timer(cthread_env *env, uint32_t timer_id) const {
   AcquireReadLock lock(tlock);
+  if (timer_backend == TIMER_BACKEND_WHEEL) {
+    return timer_wheel.has_timer(env, timer_id);
+  }
   auto timer_it = find_if(ordered_timers.begin(), ordered_timers.end(),
                           ctimer_find_by_timer_env_and_id(env, timer_id));
   return (not(timer_it == ordered_timers.end()));
@@ -645,10 +781,9 @@ void cthread::handle_wakeup() {
     wakeups.clear();
   }
   for (auto it = envs.begin(); it != envs.end(); ++it) {
-    try {
-      env((*it)).handle_wakeup(*this);
-    } catch (eThreadNotFound &e) {
-    }
+    cthread_env *wakeup_env = cthread_env::find_env(*it);
+    if (wakeup_env != nullptr)
+      wakeup_env->handle_wakeup(*this);
   }
 }
 
@@ -665,6 +800,10 @@ void *cthread::run_loop() {
   sigset_t signal_set;
   sigfillset(&signal_set); // ignore all signals
 
+  if (allocator == ALLOCATOR_SLAB) {
+    cslab::thread_attach();
+  }
+
   while (running) {
     try {
 
@@ -676,7 +815,12 @@ void *cthread::run_loop() {
 
       {
         AcquireReadLock lock(tlock);
-        if (not ordered_timers.empty()) {
+        if (timer_backend == TIMER_BACKEND_WHEEL) {
+          int wheel_timeout = timer_wheel.get_relative_timeout();
+          if (wheel_timeout >= 0 && wheel_timeout < timeout) {
+            timeout = wheel_timeout;
+          }
+        } else if (not ordered_timers.empty()) {
           timeout = ordered_timers.begin()->get_relative_timeout();
         }
       }
@@ -691,19 +835,27 @@ void *cthread::run_loop() {
         ctimer timer;
         {
           AcquireReadWriteLock lock(tlock);
-          if (ordered_timers.empty()) {
-            break;
-          }
-          timer = *(ordered_timers.begin());
-          if (not timer.get_tspec().is_expired()) {
-            break;
+          if (timer_backend == TIMER_BACKEND_WHEEL) {
+            if (not timer_wheel.pop_expired(timer)) {
+              break;
+            }
+          } else {
+            if (ordered_timers.empty()) {
+              break;
+            }
+            timer = *(ordered_timers.begin());
+            if (not timer.get_tspec().is_expired()) {
+              break;
+            }
+            ordered_timers.erase(ordered_timers.begin());
           }
-          ordered_timers.erase(ordered_timers.begin());
         } // release lock here
         if (not running)
           goto out;
 
-        env(timer.env()).handle_timeout(*this, timer.get_timer_id());
+        cthread_env *timer_env = env(timer.env());
+        if (timer_env != nullptr)
+          timer_env->handle_timeout(*this, timer.get_timer_id());
       }
 
       if (not running)
@@ -716,29 +868,29 @@ void *cthread::run_loop() {
           if (not running)
             goto out;
 
-          if (events[i].data.fd == event_fd) {
+          if (events[i].data.u64 == EVENT_FD_COOKIE) {
 
-            if (not running) {
-              return &retval;
-            }
+            if (not running)
+              goto out;
 
             if (events[i].events & EPOLLIN) {
               uint64_t c;
               int rcode = read(event_fd, &c, sizeof(c));
               (void)rcode;
               handle_wakeup();
+              run_jobs();
             }
 
           } else {
-            try {
-              if (events[i].events & EPOLLIN)
-                env(events[i].data.fd)
-                    .handle_read_event(*this, events[i].data.fd);
-              if (events[i].events & EPOLLOUT)
-                env(events[i].data.fd)
-                    .handle_write_event(*this, events[i].data.fd);
-            } catch (eThreadNotFound &e) {
-            }
+            /* skip events of file descriptors dropped meanwhile */
+            int fd = -1;
+            cthread_env *fd_env = nullptr;
+            if ((events[i].events & EPOLLIN) &&
+                ((fd_env = env(events[i].data.u64, fd)) != nullptr))
+              fd_env->handle_read_event(*this, fd);
+            if ((events[i].events & EPOLLOUT) &&
+                ((fd_env = env(events[i].data.u64, fd)) != nullptr))
+              fd_env->handle_write_event(*this, fd);
           }
         }
       } else if (rc < 0) {
@@ -776,5 +928,229 @@ void *cthread::run_loop() {
 
 out:
 
+  if (allocator == ALLOCATOR_SLAB) {
+    cslab::thread_detach();
+  }
+
   return &retval;
 }
+
+void cthread::schedule_job(cthread_job *job) {
+  int job_state = job->job_state.load();
+  while (true) {
+    switch (job_state) {
+    case cthread_job::JOB_STATE_IDLE: {
+      size_t depth = 0;
+      {
+        /* queue before pool_drop_job() may see state QUEUED */
+        AcquireReadWriteLock lock(jobs_lock);
+        if (not job->job_state.compare_exchange_weak(
+                job_state, cthread_job::JOB_STATE_QUEUED)) {
+          continue;
+        }
+        job->job_home = this;
+        push_job(job);
+        depth = jobs_depth;
+      }
+      wakeup();
+      if ((depth > 1) && job->job_stealable &&
+          (pool_hnd_scheduler == HND_SCHEDULER_WORK_STEALING)) {
+        wakeup_sibling();
+      }
+      return;
+    };
+    case cthread_job::JOB_STATE_RUNNING: {
+      /* queued again on this thread once handle_job() returns */
+      job->job_home = this;
+      if (not job->job_state.compare_exchange_weak(
+              job_state, cthread_job::JOB_STATE_RESCHEDULED)) {
+        continue;
+      }
+      return;
+    };
+    default: {
+      /* already queued, rescheduled or dropped */
+      return;
+    };
+    }
+  }
+}
+
+/*static*/ void cthread::pool_drop_job(cthread_job *job) {
+  int job_state = job->job_state.load();
+  while (job_state != cthread_job::JOB_STATE_DROPPED) {
+    switch (job_state) {
+    case cthread_job::JOB_STATE_RUNNING:
+    case cthread_job::JOB_STATE_RESCHEDULED: {
+      if (running_job == job) {
+        /* job drops itself from within handle_job() */
+        running_job_dropped = true;
+        job->job_state.compare_exchange_weak(job_state,
+                                             cthread_job::JOB_STATE_DROPPED);
+      } else {
+        /* wait for run_jobs() on the other thread to release the job */
+        std::unique_lock<std::mutex> lock(pool_drop_mutex);
+        pool_drop_waiters++;
+        pool_drop_cond.wait(lock, [&] {
+          job_state = job->job_state.load();
+          return (job_state != cthread_job::JOB_STATE_RUNNING) &&
+                 (job_state != cthread_job::JOB_STATE_RESCHEDULED);
+        });
+        pool_drop_waiters--;
+      }
+    } break;
+    default: {
+      job->job_state.compare_exchange_weak(job_state,
+                                           cthread_job::JOB_STATE_DROPPED);
+    };
+    }
+  }
+
+  /* no thread picks up a dropped job, remove all references */
+  AcquireReadLock lock(cthread::pool_lock);
+  for (auto &it : cthread::pool) {
+    cthread *thread = it.second;
+    AcquireReadWriteLock jlock(thread->jobs_lock);
+    for (auto jt = thread->jobs.begin(); jt != thread->jobs.end();) {
+      if (*jt == job) {
+        jt = thread->jobs.erase(jt);
+        thread->jobs_depth--;
+        if (job->job_stealable) {
+          thread->jobs_stealable--;
+        }
+      } else {
+        ++jt;
+      }
+    }
+  }
+}
+
+void cthread::run_jobs() {
+  for (unsigned int num = 0; num < JOBS_PER_WAKEUP; num++) {
+    if (not running)
+      return;
+
+    cthread_job *job = pop_job(false);
+    if ((nullptr == job) &&
+        (pool_hnd_scheduler == HND_SCHEDULER_WORK_STEALING)) {
+      job = steal_job();
+    }
+    if (nullptr == job)
+      return;
+
+    running_job = job;
+    running_job_dropped = false;
+    try {
+      job->handle_job(*this);
+    } catch (...) {
+      VLOG(1) << __FUNCTION__ << " job " << job
+              << " on thread=" << thread_name << " failed";
+    }
+    running_job = nullptr;
+    jobs_run++;
+
+    if (running_job_dropped)
+      continue;
+
+    /* job may be deleted as soon as it leaves state RUNNING */
+    int job_state = cthread_job::JOB_STATE_RUNNING;
+    if (not job->job_state.compare_exchange_strong(
+            job_state, cthread_job::JOB_STATE_IDLE)) {
+      if (job_state == cthread_job::JOB_STATE_RESCHEDULED) {
+        /* back to the thread it was scheduled on, not the stealing one */
+        cthread *home = job->job_home.load();
+        {
+          AcquireReadWriteLock lock(home->jobs_lock);
+          if (job->job_state.compare_exchange_strong(
+                  job_state, cthread_job::JOB_STATE_QUEUED)) {
+            home->push_job(job);
+          }
+        }
+        if (home != this) {
+          home->wakeup();
+        }
+      }
+    }
+
+    if (pool_drop_waiters.load() > 0) {
+      std::lock_guard<std::mutex> lock(pool_drop_mutex);
+      pool_drop_cond.notify_all();
+    }
+  }
+
+  /* more jobs pending, give timers and file descriptors a chance first */
+  if (jobs_depth > 0) {
+    wakeup();
+  }
+}
+
+void cthread::push_job(cthread_job *job) {
+  jobs.push_back(job);
+  jobs_depth++;
+  if (job->job_stealable) {
+    jobs_stealable++;
+  }
+}
+
+cthread_job *cthread::pop_job(bool steal) {
+  AcquireReadWriteLock lock(jobs_lock);
+  while (not jobs.empty()) {
+    cthread_job *job = nullptr;
+    if (steal) {
+      /* jobs bound to this thread stay in place */
+      auto jt = std::find_if(jobs.rbegin(), jobs.rend(), [](cthread_job *job) {
+        return job->job_stealable;
+      });
+      if (jt == jobs.rend()) {
+        return nullptr;
+      }
+      job = *jt;
+      jobs.erase(std::next(jt).base());
+    } else {
+      job = jobs.front();
+      jobs.pop_front();
+    }
+    jobs_depth--;
+    if (job->job_stealable) {
+      jobs_stealable--;
+    }
+    int job_state = cthread_job::JOB_STATE_QUEUED;
+    if (job->job_state.compare_exchange_strong(
+            job_state, cthread_job::JOB_STATE_RUNNING)) {
+      return job;
+    }
+  }
+  return nullptr;
+}
+
+cthread_job *cthread::steal_job() {
+  cthread *victim = nullptr;
+  size_t max_depth = 0;
+  for (auto thread : cthread::pool_hnd_threads) {
+    if (thread == this)
+      continue;
+    size_t depth = thread->jobs_stealable.load();
+    if (depth > max_depth) {
+      max_depth = depth;
+      victim = thread;
+    }
+  }
+  if (nullptr == victim)
+    return nullptr;
+  cthread_job *job = victim->pop_job(true);
+  if (nullptr != job) {
+    jobs_stolen++;
+  }
+  return job;
+}
+
+void cthread::wakeup_sibling() {
+  size_t num = cthread::pool_hnd_threads.size();
+  for (size_t i = 0; i < num; i++) {
+    cthread *thread = cthread::pool_hnd_threads[pool_sibling_index++ % num];
+    if ((thread != this) && (thread->jobs_depth.load() == 0)) {
+      thread->wakeup();
+      return;
+    }
+  }
+}
@@ -24,11 +24,15 @@
 
 #include <atomic>
 #include <cassert>
+#include <condition_variable>
+#include <deque>
 #include <inttypes.h>
 #include <iostream>
 #include <list>
 #include <map>
+#include <mutex>
 #include <set>
+#include <vector>
 
 #include <openssl/bio.h>
 #include <openssl/conf.h>
@@ -38,6 +42,7 @@
 #include <openssl/ssl.h>
 
 #include "rofl/common/ctimer.hpp"
+#include "rofl/common/ctimerwheel.hpp"
 #include "rofl/common/exception.hpp"
 #include "rofl/common/locking.hpp"
 
@@ -75,12 +80,15 @@ public:
     envs.erase(this);
   }
   static cthread_env &env(cthread_env *thread_env) {
-    AcquireReadLock lock(envs_lock);
-    if (envs.find(thread_env) == envs.end()) {
+    if (find_env(thread_env) == nullptr) {
       throw eThreadNotFound("thread environment not found");
     }
     return *(thread_env);
   }
+  static cthread_env *find_env(cthread_env *thread_env) {
+    AcquireReadLock lock(envs_lock);
+    return (envs.find(thread_env) == envs.end()) ? nullptr : thread_env;
+  }
 
 protected:
   virtual void handle_wakeup(cthread &thread) = 0;
@@ -89,15 +97,84 @@ protected:
   virtual void handle_write_event(cthread &thread, int fd) = 0;
 };
 
+/**
+ * @brief	Unit of work run by the threads of the pool
+ *
+ * A job is queued at most once and never runs on two threads at the same
+ * time, so work scheduled repeatedly for the same job is done in order.
+ * With the work stealing scheduler, a queued stealable job may run on any
+ * handler thread of the pool. Jobs sharing state with timers or wakeups of
+ * their home thread must not be stealable, they always run on the thread
+ * that scheduled them.
+ */
+class cthread_job {
+  friend class cthread;
+
+public:
+  virtual ~cthread_job(){};
+  cthread_job(bool stealable = false)
+      : job_stealable(stealable), job_state(JOB_STATE_IDLE),
+        job_home(nullptr){};
+
+  /**
+   * @brief	Returns true if idle handler threads may take this job
+   */
+  bool is_stealable() const { return job_stealable; };
+
+protected:
+  virtual void handle_job(cthread &thread) = 0;
+
+private:
+  enum job_state_t {
+    JOB_STATE_IDLE = 0,        // neither queued nor running
+    JOB_STATE_QUEUED = 1,      // waiting in a thread's job queue
+    JOB_STATE_RUNNING = 2,     // handle_job() is being executed
+    JOB_STATE_RESCHEDULED = 3, // running and scheduled again meanwhile
+    JOB_STATE_DROPPED = 4,     // removed by cthread::pool_drop_job()
+  };
+
+  const bool job_stealable;
+  std::atomic<int> job_state;
+  // thread the job was scheduled on, requeued there when rescheduled
+  std::atomic<cthread *> job_home;
+};
+
 class cthread {
 public:
+  /**
+   * @brief Data structure used for storing timers
+   */
+  enum timer_backend_t {
+    TIMER_BACKEND_ORDERED_SET = 0, // std::set ordered by expiry time
+    TIMER_BACKEND_WHEEL = 1,       // hierarchical timing wheel
+  };
+
+  /**
+   * @brief Allocator used for messages and TLVs created by a thread
+   */
+  enum allocator_t {
+    ALLOCATOR_HEAP = 0, // global operator new
+    ALLOCATOR_SLAB = 1, // per-thread slab cache, see cslab
+  };
+
+  /**
+   * @brief Placement of jobs on handler threads
+   */
+  enum hnd_scheduler_t {
+    HND_SCHEDULER_STATIC = 0,        // jobs run on the thread scheduling them
+    HND_SCHEDULER_WORK_STEALING = 1, // idle handler threads steal jobs
+  };
+
   /**
    * @brief Initialize thread pool
    */
   static void
   pool_initialize(uint32_t num_of_hnd_threads = DEFAULT_POOL_NUM_HND_THREADS,
                   uint32_t num_of_io_threads = DEFAULT_POOL_NUM_IO_THREADS,
-                  uint32_t num_of_mgt_threads = DEFAULT_POOL_NUM_MGT_THREADS);
+                  uint32_t num_of_mgt_threads = DEFAULT_POOL_NUM_MGT_THREADS,
+                  timer_backend_t timer_backend = TIMER_BACKEND_ORDERED_SET,
+                  allocator_t allocator = ALLOCATOR_HEAP,
+                  hnd_scheduler_t hnd_scheduler = HND_SCHEDULER_STATIC);
 
   /**
    * @brief Terminate thread pool
@@ -124,11 +201,29 @@ public:
    */
   static uint32_t get_io_thread_num_from_pool();
 
+  /**
+   * @brief Get number of IO threads in pool
+   */
+  static uint32_t get_num_io_threads();
+
   /**
    * @brief Assign next cthread instance
    */
   static uint32_t get_hnd_thread_num_from_pool();
 
+  /**
+   * @brief Get scheduler used for jobs on handler threads
+   */
+  static hnd_scheduler_t get_hnd_scheduler() { return pool_hnd_scheduler; };
+
+  /**
+   * @brief Remove job from all job queues
+   *
+   * Waits for the job to finish if it is running on another thread. Must be
+   * called before destroying a job.
+   */
+  static void pool_drop_job(cthread_job *job);
+
 public:
   /**
    *
@@ -148,7 +243,11 @@ public:
   /**
    *
    */
-  cthread(uint32_t thread_num) : thread_num(thread_num), state(STATE_IDLE) {
+  cthread(uint32_t thread_num,
+          timer_backend_t timer_backend = TIMER_BACKEND_ORDERED_SET,
+          allocator_t allocator = ALLOCATOR_HEAP)
+      : thread_num(thread_num), timer_backend(timer_backend),
+        allocator(allocator), state(STATE_IDLE) {
     initialize();
   };
 
@@ -165,6 +264,21 @@ public:
    *
    */
   pthread_t get_thread_id() const { return thread_tid; };
+  /**
+   *
+   */
+  timer_backend_t get_timer_backend() const { return timer_backend; };
+  /**
+   *
+   */
+  allocator_t get_allocator() const { return allocator; };
+  /**
+   * @brief	Returns number of file descriptor slots in use
+   */
+  size_t get_num_fd_slots() const {
+    AcquireReadLock lock(tlock);
+    return fd_slots_num - fd_slots_free.size();
+  };
 
   /**
    *
@@ -190,6 +304,31 @@ public:
    */
   void drop_wakeup(cthread_env *env);
 
+public:
+  /**
+   * @brief	Queue job for execution by this thread
+   *
+   * Scheduling a running job queues it again on this thread once it has
+   * finished. With the work stealing scheduler, an idle handler thread may
+   * take a stealable job.
+   */
+  void schedule_job(cthread_job *job);
+
+  /**
+   * @brief	Returns number of jobs waiting in this thread's queue
+   */
+  size_t get_job_queue_depth() const { return jobs_depth.load(); };
+
+  /**
+   * @brief	Returns number of jobs run by this thread
+   */
+  uint64_t get_jobs_run() const { return jobs_run.load(); };
+
+  /**
+   * @brief	Returns number of jobs this thread took from other threads
+   */
+  uint64_t get_jobs_stolen() const { return jobs_stolen.load(); };
+
 public:
   /**
    * @brief	Register file descriptor
@@ -288,7 +427,9 @@ public:
        << "num: " << (unsigned int)thread.get_thread_num() << ", "
        << "name: " << thread.get_thread_name() << " " << std::endl;
     AcquireReadLock lock(thread.tlock);
-    if (not thread.ordered_timers.empty()) {
+    if (thread.timer_backend == TIMER_BACKEND_WHEEL) {
+      os << thread.timer_wheel;
+    } else if (not thread.ordered_timers.empty()) {
       os << "next timeout: "
          << thread.ordered_timers.begin()->get_relative_timeout() << std::endl;
       for (auto tspec : thread.ordered_timers) {
@@ -333,23 +474,40 @@ private:
   void *run_loop();
 
   /**
-   * @brief Get environment for file descriptor
-   */
-  cthread_env &env(int fd) {
-    AcquireReadLock lock(tlock);
-    std::map<int, fd_priv_data_t>::const_iterator pos;
-    if ((pos = fds.find(fd)) == fds.end()) {
-      throw eThreadNotFound(
-          "file descriptor to thread environment mapping not found");
+   * @brief Get environment for epoll_event.data of a file descriptor
+   *
+   * Lock-free, returns nullptr if the registration has been dropped since
+   * the event was reported.
+   */
+  cthread_env *env(uint64_t cookie, int &fd) const {
+    uint32_t index = cookie & 0xffffffff;
+    const fd_slot_t *chunk =
+        fd_slot_chunks[index / FD_SLOTS_PER_CHUNK].load(
+            std::memory_order_acquire);
+    const fd_slot_t &slot = chunk[index % FD_SLOTS_PER_CHUNK];
+    cthread_env *env = slot.env.load(std::memory_order_acquire);
+    fd = slot.fd.load(std::memory_order_relaxed);
+    if (slot.generation.load(std::memory_order_acquire) != (cookie >> 32)) {
+      return nullptr;
     }
-    return cthread_env::env(pos->second.env);
+    return env;
   };
 
   /**
-   * @brief Get environment for ctimer_env*
+   * @brief Assign a slot to a file descriptor, returns its cookie
+   */
+  uint64_t alloc_fd_slot(cthread_env *env, int fd);
+
+  /**
+   * @brief Release slot, pending events for its cookie are ignored
+   */
+  void free_fd_slot(uint64_t cookie);
+
+  /**
+   * @brief Get environment for ctimer_env*, nullptr if it has been destroyed
    */
-  cthread_env &env(ctimer_env *env) {
-    return cthread_env::env(dynamic_cast<cthread_env *>(env));
+  cthread_env *env(ctimer_env *env) {
+    return cthread_env::find_env(dynamic_cast<cthread_env *>(env));
   };
 
   /**
@@ -357,6 +515,32 @@ private:
    */
   void handle_wakeup();
 
+  /**
+   * @brief Run queued jobs, steal jobs from other threads if idle
+   */
+  void run_jobs();
+
+  /**
+   * @brief Take job from front (own queue) or last stealable job from back
+   * (stealing) of queue
+   */
+  cthread_job *pop_job(bool steal);
+
+  /**
+   * @brief Append queued job, caller holds jobs_lock
+   */
+  void push_job(cthread_job *job);
+
+  /**
+   * @brief Take job from the handler thread with the longest queue
+   */
+  cthread_job *steal_job();
+
+  /**
+   * @brief Wake up an idle handler thread for stealing
+   */
+  void wakeup_sibling();
+
   /**
    * @brief	Global initialization of OpenSSL libraries
    */
@@ -391,6 +575,12 @@ private:
    * method get_hnd_thread_num_from_pool: returns in a round robin policy thread
    * numbers
    * for application handler operations
+   *
+   * with HND_SCHEDULER_WORK_STEALING, idle handler threads take stealable
+   * jobs queued on busier handler threads. A crofconn's received messages
+   * are processed as a stealable job, so a few busy connections do not
+   * stall all others sharing the same handler thread. Timers and wakeups
+   * still run on the home thread, crofconn serialises them with its job.
    */
 
   // thread pool
@@ -410,6 +600,21 @@ private:
   static uint32_t pool_num_hnd_threads;
   static const uint32_t DEFAULT_POOL_NUM_HND_THREADS = 4;
   static uint32_t pool_hnd_loop_index;
+  // timer backend used by all threads in pool
+  static timer_backend_t pool_timer_backend;
+  // allocator used by all threads in pool
+  static allocator_t pool_allocator;
+  // placement of jobs on handler threads
+  static hnd_scheduler_t pool_hnd_scheduler;
+  // handler threads, victims for stealing jobs
+  static std::vector<cthread *> pool_hnd_threads;
+  // pool_drop_job() waits here for a job running on another thread
+  static std::mutex pool_drop_mutex;
+  static std::condition_variable pool_drop_cond;
+  static std::atomic<unsigned int> pool_drop_waiters;
+  static std::atomic<uint32_t> pool_sibling_index;
+  // jobs run per wakeup before servicing timers and fds again
+  static const unsigned int JOBS_PER_WAKEUP = 64;
 
   // OpenSSL BIO stderr
   static BIO *bio_stderr;
@@ -420,6 +625,12 @@ private:
   // thread number
   uint32_t thread_num;
 
+  // data structure used for storing timers
+  timer_backend_t timer_backend;
+
+  // allocator for objects created by worker thread
+  allocator_t allocator;
+
   // true: continue to run worker thread
   std::atomic_bool running;
 
@@ -434,24 +645,60 @@ private:
 
   crwlock tlock; // thread lock
 
+  // queued jobs
+  std::deque<cthread_job *> jobs;
+  crwlock jobs_lock;
+  std::atomic<size_t> jobs_depth;
+  // stealable jobs in queue
+  std::atomic<size_t> jobs_stealable;
+  std::atomic<uint64_t> jobs_run;
+  std::atomic<uint64_t> jobs_stolen;
+
   class fd_priv_data_t {
   public:
     uint32_t events;
     cthread_env *env;
-    fd_priv_data_t(uint32_t events = 0, cthread_env *env = nullptr)
-        : events(events), env(env){};
+    uint64_t cookie; // slot index and generation, stored in epoll_event.data
+    fd_priv_data_t(uint32_t events = 0, cthread_env *env = nullptr,
+                   uint64_t cookie = 0)
+        : events(events), env(env), cookie(cookie){};
     fd_priv_data_t(const fd_priv_data_t &priv_data) { *this = priv_data; };
     fd_priv_data_t &operator=(const fd_priv_data_t &priv_data) {
       if (this == &priv_data)
         return *this;
       events = priv_data.events;
       env = priv_data.env;
+      cookie = priv_data.cookie;
       return *this;
     };
   };
 
+  /*
+   * registration of a file descriptor for dispatching epoll events
+   *
+   * Slots are allocated in chunks that live as long as the thread, so
+   * run_loop() may read them without holding tlock. Dropping a file
+   * descriptor bumps the slot's generation, which invalidates all events
+   * still pending for the old registration. An env must deregister its
+   * file descriptors via drop() or drop_fd() before being destroyed.
+   */
+  struct fd_slot_t {
+    std::atomic<uint32_t> generation;
+    std::atomic<cthread_env *> env;
+    std::atomic<int> fd;
+  };
+
+  static const uint32_t FD_SLOTS_PER_CHUNK = 1024;
+  static const uint32_t FD_SLOTS_MAX_CHUNKS = 1024;
+  // cookie of the thread's own event_fd
+  static const uint64_t EVENT_FD_COOKIE = UINT64_MAX;
+
   std::map<int, fd_priv_data_t> fds; // set of registered file descriptors
+  std::atomic<fd_slot_t *> fd_slot_chunks[FD_SLOTS_MAX_CHUNKS];
+  uint32_t fd_slots_num;              // number of slots ever allocated
+  std::vector<uint32_t> fd_slots_free; // released slots for reuse
   std::set<ctimer> ordered_timers;   // ordered set of timers
+  ctimerwheel timer_wheel;           // timing wheel indexed by env and id
   std::set<cthread_env *> wakeups; // set of cthread_env instances to be called
 
   enum thread_state_t {
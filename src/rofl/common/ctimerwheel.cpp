@@ -0,0 +1,299 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * ctimerwheel.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <limits.h>
+#include <string.h>
+
+#include "ctimerwheel.hpp"
+
+using namespace rofl;
+
+ctimerwheel::ctimerwheel() : num_slotted(0), cur_tick(0) {
+  memset(slots, 0, sizeof(slots));
+  memset(bitmap, 0, sizeof(bitmap));
+  expired.head = expired.tail = nullptr;
+}
+
+void ctimerwheel::clear() {
+  timers.clear();
+  envs.clear();
+  memset(slots, 0, sizeof(slots));
+  memset(bitmap, 0, sizeof(bitmap));
+  expired.head = expired.tail = nullptr;
+  num_slotted = 0;
+}
+
+bool ctimerwheel::add_timer(ctimer_env *env, uint32_t timer_id,
+                            const ctimespec &tspec) {
+  auto rv = timers.emplace(std::piecewise_construct,
+                           std::forward_as_tuple(env, timer_id),
+                           std::forward_as_tuple());
+  entry_t *entry = &(rv.first->second);
+
+  if (rv.second) {
+    /* new timer, prepend to list of env's timers */
+    entry_t *&env_head = envs[env];
+    entry->env_prev = nullptr;
+    entry->env_next = env_head;
+    if (env_head != nullptr) {
+      env_head->env_prev = entry;
+    }
+    env_head = entry;
+  } else {
+    unlink(entry);
+  }
+
+  entry->timer = ctimer(env, timer_id, tspec);
+  entry->expiry = to_ticks(tspec, /*round_up=*/true);
+  link(entry);
+
+  return rv.second;
+}
+
+const ctimer *ctimerwheel::find_timer(ctimer_env *env,
+                                      uint32_t timer_id) const {
+  auto it = timers.find(key_t(env, timer_id));
+  if (it == timers.end()) {
+    return nullptr;
+  }
+  return &(it->second.timer);
+}
+
+bool ctimerwheel::drop_timer(ctimer_env *env, uint32_t timer_id) {
+  auto it = timers.find(key_t(env, timer_id));
+  if (it == timers.end()) {
+    return false;
+  }
+  erase(&(it->second));
+  return true;
+}
+
+bool ctimerwheel::drop_timers(ctimer_env *env) {
+  auto it = envs.find(env);
+  if (it == envs.end()) {
+    return false;
+  }
+  while (it->second != nullptr) {
+    erase(it->second);
+    if ((it = envs.find(env)) == envs.end()) {
+      break;
+    }
+  }
+  return true;
+}
+
+int ctimerwheel::get_relative_timeout(const ctimespec &now) {
+  if (expired.head != nullptr) {
+    return 0;
+  }
+  if (num_slotted == 0) {
+    return -1;
+  }
+
+  /* earliest tick at which any occupied slot is due for expiry or cascade */
+  uint64_t next_tick = UINT64_MAX;
+  for (unsigned int level = 0; level < WHEEL_LEVELS; level++) {
+    uint64_t base = cur_tick >> (WHEEL_BITS * level);
+    int slot = find_next_slot(level, (base + 1) & WHEEL_MASK);
+    if (slot < 0) {
+      continue;
+    }
+    uint64_t tick = (base & ~(uint64_t)WHEEL_MASK) | slot;
+    if (tick <= base) {
+      tick += WHEEL_SLOTS;
+    }
+    tick <<= (WHEEL_BITS * level);
+    if (tick < next_tick) {
+      next_tick = tick;
+    }
+  }
+
+  uint64_t now_tick = to_ticks(now, /*round_up=*/false);
+  if (next_tick <= now_tick) {
+    return 0;
+  }
+  if (next_tick - now_tick > INT_MAX) {
+    return INT_MAX;
+  }
+  return (int)(next_tick - now_tick);
+}
+
+bool ctimerwheel::pop_expired(ctimer &timer, const ctimespec &now) {
+  if (expired.head == nullptr) {
+    advance(to_ticks(now, /*round_up=*/false));
+  }
+  if (expired.head == nullptr) {
+    return false;
+  }
+  entry_t *entry = expired.head;
+  timer = entry->timer;
+  erase(entry);
+  return true;
+}
+
+uint64_t ctimerwheel::to_ticks(const ctimespec &tspec, bool round_up) const {
+  int64_t nsec =
+      (int64_t)(tspec.get_tspec().tv_sec - origin.get_tspec().tv_sec) *
+          1000000000 +
+      (tspec.get_tspec().tv_nsec - origin.get_tspec().tv_nsec);
+  if (nsec <= 0) {
+    return 0;
+  }
+  return round_up ? (nsec + 999999) / 1000000 : nsec / 1000000;
+}
+
+void ctimerwheel::link(entry_t *entry) {
+  uint64_t expiry = entry->expiry;
+  if (expiry <= cur_tick) {
+    entry->level = LEVEL_EXPIRED;
+    entry->slot = 0;
+  } else {
+    uint64_t delta = expiry - cur_tick;
+    unsigned int level = 0;
+    while ((level < WHEEL_LEVELS - 1) &&
+           (delta >> (WHEEL_BITS * (level + 1)))) {
+      level++;
+    }
+    /* timers beyond the last level are cascaded again */
+    uint64_t max_delta = ((uint64_t)1 << (WHEEL_BITS * WHEEL_LEVELS)) - 1;
+    if (delta > max_delta) {
+      expiry = cur_tick + max_delta;
+    }
+    entry->level = level;
+    entry->slot = (expiry >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    bitmap[level][entry->slot / 64] |= ((uint64_t)1 << (entry->slot % 64));
+    num_slotted++;
+  }
+
+  /* append to slot list */
+  list_t &list = slot_list(entry->level, entry->slot);
+  entry->next = nullptr;
+  entry->prev = list.tail;
+  if (list.tail != nullptr) {
+    list.tail->next = entry;
+  } else {
+    list.head = entry;
+  }
+  list.tail = entry;
+}
+
+void ctimerwheel::unlink(entry_t *entry) {
+  list_t &list = slot_list(entry->level, entry->slot);
+  if (entry->prev != nullptr) {
+    entry->prev->next = entry->next;
+  } else {
+    list.head = entry->next;
+  }
+  if (entry->next != nullptr) {
+    entry->next->prev = entry->prev;
+  } else {
+    list.tail = entry->prev;
+  }
+  entry->prev = entry->next = nullptr;
+
+  if (entry->level != LEVEL_EXPIRED) {
+    if (list.head == nullptr) {
+      bitmap[entry->level][entry->slot / 64] &=
+          ~((uint64_t)1 << (entry->slot % 64));
+    }
+    num_slotted--;
+  }
+}
+
+void ctimerwheel::erase(entry_t *entry) {
+  unlink(entry);
+
+  /* remove from list of env's timers */
+  ctimer_env *env = entry->timer.env();
+  if (entry->env_prev != nullptr) {
+    entry->env_prev->env_next = entry->env_next;
+  } else if (entry->env_next != nullptr) {
+    envs[env] = entry->env_next;
+  } else {
+    envs.erase(env);
+  }
+  if (entry->env_next != nullptr) {
+    entry->env_next->env_prev = entry->env_prev;
+  }
+
+  timers.erase(key_t(env, entry->timer.get_timer_id()));
+}
+
+void ctimerwheel::advance(uint64_t tick) {
+  while (cur_tick < tick) {
+    if (num_slotted == 0) {
+      cur_tick = tick;
+      break;
+    }
+
+    /* skip empty ticks on level 0 up to the next cascade */
+    bool level0_empty = true;
+    for (unsigned int word = 0; word < WHEEL_WORDS; word++) {
+      level0_empty = level0_empty && (bitmap[0][word] == 0);
+    }
+    if (level0_empty) {
+      uint64_t boundary = (cur_tick | WHEEL_MASK) + 1;
+      if (boundary > tick) {
+        cur_tick = tick;
+        break;
+      }
+      cur_tick = boundary - 1;
+    }
+
+    cur_tick++;
+
+    /* cascade upper levels, highest level first */
+    unsigned int levels = 0;
+    while ((levels < WHEEL_LEVELS - 1) &&
+           ((cur_tick & (((uint64_t)1 << (WHEEL_BITS * (levels + 1))) - 1)) ==
+            0)) {
+      levels++;
+    }
+    for (unsigned int level = levels; level > 0; level--) {
+      cascade(level, (cur_tick >> (WHEEL_BITS * level)) & WHEEL_MASK);
+    }
+
+    /* move due timers to list of expired timers */
+    cascade(0, cur_tick & WHEEL_MASK);
+  }
+}
+
+void ctimerwheel::cascade(unsigned int level, unsigned int slot) {
+  list_t list = slots[level][slot];
+  if (list.head == nullptr) {
+    return;
+  }
+  slots[level][slot].head = slots[level][slot].tail = nullptr;
+  bitmap[level][slot / 64] &= ~((uint64_t)1 << (slot % 64));
+
+  entry_t *entry = list.head;
+  while (entry != nullptr) {
+    entry_t *next = entry->next;
+    num_slotted--;
+    link(entry);
+    entry = next;
+  }
+}
+
+int ctimerwheel::find_next_slot(unsigned int level, unsigned int start) const {
+  for (unsigned int n = 0; n <= WHEEL_WORDS; n++) {
+    unsigned int word = (start / 64 + n) % WHEEL_WORDS;
+    uint64_t bits = bitmap[level][word];
+    if (n == 0) {
+      bits &= ~(uint64_t)0 << (start % 64);
+    } else if (n == WHEEL_WORDS) {
+      bits &= ((uint64_t)1 << (start % 64)) - 1;
+    }
+    if (bits != 0) {
+      return word * 64 + __builtin_ctzll(bits);
+    }
+  }
+  return -1;
+}
@@ -0,0 +1,202 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * ctimerwheel.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SRC_ROFL_COMMON_CTIMERWHEEL_HPP_
+#define SRC_ROFL_COMMON_CTIMERWHEEL_HPP_
+
+#include <functional>
+#include <inttypes.h>
+#include <ostream>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+
+#include "rofl/common/ctimer.hpp"
+#include "rofl/common/ctimespec.hpp"
+
+namespace rofl {
+
+/**
+ * @brief	Hierarchical timing wheel for ctimer instances
+ *
+ * Timers are indexed by (ctimer_env, timer_id), so adding, dropping and
+ * looking up a timer takes constant time. The wheel has a resolution of
+ * one millisecond and four levels of 256 slots each, covering about
+ * 49 days. Timers further in the future are cascaded again on expiry of
+ * their slot. Timers never fire before their deadline.
+ *
+ * The wheel is not thread safe, cthread protects it by its thread lock.
+ */
+class ctimerwheel {
+public:
+  /**
+   *
+   */
+  ~ctimerwheel() { clear(); };
+
+  /**
+   *
+   */
+  ctimerwheel();
+
+private:
+  ctimerwheel(const ctimerwheel &wheel);
+
+  ctimerwheel &operator=(const ctimerwheel &wheel);
+
+public:
+  /**
+   * @brief	Returns number of active timers
+   */
+  size_t size() const { return timers.size(); };
+
+  /**
+   * @brief	Returns true if no timer is active
+   */
+  bool empty() const { return timers.empty(); };
+
+  /**
+   * @brief	Removes all timers
+   */
+  void clear();
+
+  /**
+   * @brief	Starts or restarts timer identified by env and timer_id
+   *
+   * @return true if timer was not active before
+   */
+  bool add_timer(ctimer_env *env, uint32_t timer_id, const ctimespec &tspec);
+
+  /**
+   * @brief	Returns pointer to active timer or nullptr
+   */
+  const ctimer *find_timer(ctimer_env *env, uint32_t timer_id) const;
+
+  /**
+   * @brief	Stops timer identified by env and timer_id
+   *
+   * @return true if timer was active
+   */
+  bool drop_timer(ctimer_env *env, uint32_t timer_id);
+
+  /**
+   * @brief	Stops all timers of env
+   *
+   * @return true if at least one timer was active
+   */
+  bool drop_timers(ctimer_env *env);
+
+  /**
+   * @brief	Returns true if timer identified by env and timer_id is active
+   */
+  bool has_timer(ctimer_env *env, uint32_t timer_id) const {
+    return (find_timer(env, timer_id) != nullptr);
+  };
+
+  /**
+   * @brief	Returns milliseconds until the wheel must be advanced next or
+   * -1 if no timer is active
+   *
+   * The value is a lower bound for timers on upper levels, which are
+   * cascaded to lower levels when this time has elapsed.
+   */
+  int get_relative_timeout(const ctimespec &now = ctimespec::now());
+
+  /**
+   * @brief	Removes next expired timer from the wheel
+   *
+   * @param timer copy of the expired timer
+   * @return true if an expired timer was found
+   */
+  bool pop_expired(ctimer &timer, const ctimespec &now = ctimespec::now());
+
+public:
+  friend std::ostream &operator<<(std::ostream &os, const ctimerwheel &wheel) {
+    os << "<ctimerwheel #timers: " << wheel.size()
+       << " tick: " << (unsigned long long)wheel.cur_tick << " >" << std::endl;
+    return os;
+  };
+
+private:
+  static const unsigned int WHEEL_LEVELS = 4;
+  static const unsigned int WHEEL_BITS = 8;
+  static const unsigned int WHEEL_SLOTS = 1 << WHEEL_BITS;
+  static const unsigned int WHEEL_MASK = WHEEL_SLOTS - 1;
+  static const unsigned int WHEEL_WORDS = WHEEL_SLOTS / 64;
+  static const uint8_t LEVEL_EXPIRED = 0xff;
+
+  struct entry_t;
+
+  struct list_t {
+    entry_t *head;
+    entry_t *tail;
+  };
+
+  struct entry_t {
+    ctimer timer;
+    uint64_t expiry; // in ticks
+    uint8_t level;
+    uint8_t slot;
+    entry_t *prev;
+    entry_t *next;
+    entry_t *env_prev;
+    entry_t *env_next;
+  };
+
+  typedef std::pair<ctimer_env *, uint32_t> key_t;
+
+  struct key_hash {
+    size_t operator()(const key_t &key) const {
+      return std::hash<uintptr_t>()((uintptr_t)key.first) ^
+             (std::hash<uint32_t>()(key.second) * 0x9e3779b97f4a7c15ULL);
+    };
+  };
+
+  uint64_t to_ticks(const ctimespec &tspec, bool round_up) const;
+
+  list_t &slot_list(uint8_t level, uint8_t slot) {
+    return (level == LEVEL_EXPIRED) ? expired : slots[level][slot];
+  };
+
+  void link(entry_t *entry);
+
+  void unlink(entry_t *entry);
+
+  void erase(entry_t *entry);
+
+  void advance(uint64_t tick);
+
+  void cascade(unsigned int level, unsigned int slot);
+
+  int find_next_slot(unsigned int level, unsigned int start) const;
+
+private:
+  // timers indexed by (env, timer_id)
+  std::unordered_map<key_t, entry_t, key_hash> timers;
+  // first timer of each env, for dropping all timers of an env
+  std::unordered_map<ctimer_env *, entry_t *> envs;
+
+  // slot lists and occupancy bitmaps per level
+  list_t slots[WHEEL_LEVELS][WHEEL_SLOTS];
+  uint64_t bitmap[WHEEL_LEVELS][WHEEL_WORDS];
+  // number of timers in slot lists
+  size_t num_slotted;
+
+  // expired timers, not yet handed out by pop_expired()
+  list_t expired;
+
+  // tick zero of this wheel and current tick
+  ctimespec origin;
+  uint64_t cur_tick;
+};
+
+}; // end of namespace rofl
+
+#endif /* SRC_ROFL_COMMON_CTIMERWHEEL_HPP_ */
@@ -0,0 +1,214 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * ctlscontext.cc
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <sstream>
+#include <string.h>
+#include <sys/stat.h>
+
+#include <glog/logging.h>
+
+#include "rofl/common/ctlscontext.h"
+
+using namespace rofl;
+
+/*static*/ std::map<ctlscontext::params_t, ctlscontext::entry_t>
+    ctlscontext::contexts;
+/*static*/ std::map<SSL_CTX *, unsigned int> ctlscontext::retired;
+/*static*/ crwlock ctlscontext::contexts_lock;
+/*static*/ std::atomic<uint64_t> ctlscontext::hits(0);
+/*static*/ std::atomic<uint64_t> ctlscontext::misses(0);
+/*static*/ std::atomic<uint64_t> ctlscontext::reloads(0);
+
+/*static*/ SSL_CTX *ctlscontext::acquire(const params_t &params) {
+  stamp_t files = stamp(params);
+
+  AcquireReadWriteLock lock(contexts_lock);
+
+  auto it = contexts.find(params);
+  if (it != contexts.end()) {
+    if (it->second.stamp == files) {
+      it->second.refcnt++;
+      hits++;
+      return it->second.ctx;
+    }
+
+    /* files changed on disk, current holders keep the old context */
+    VLOG(2) << __FUNCTION__ << " TLS: reloading context certfile="
+            << params.certfile;
+    retired[it->second.ctx] = it->second.refcnt;
+    contexts.erase(it);
+    reloads++;
+  }
+
+  SSL_CTX *ctx = create(params);
+  entry_t &entry = contexts[params];
+  entry.ctx = ctx;
+  entry.refcnt = 1;
+  entry.stamp = files;
+  misses++;
+
+  VLOG(2) << __FUNCTION__ << " TLS: new context certfile=" << params.certfile
+          << " contexts=" << contexts.size();
+
+  return ctx;
+}
+
+/*static*/ void ctlscontext::release(SSL_CTX *ctx) {
+  if (NULL == ctx) {
+    return;
+  }
+
+  AcquireReadWriteLock lock(contexts_lock);
+
+  for (auto it = contexts.begin(); it != contexts.end(); ++it) {
+    if (it->second.ctx != ctx) {
+      continue;
+    }
+    if (--(it->second.refcnt) == 0) {
+      SSL_CTX_free(ctx);
+      contexts.erase(it);
+    }
+    return;
+  }
+
+  auto it = retired.find(ctx);
+  if ((it != retired.end()) && (--(it->second) == 0)) {
+    SSL_CTX_free(ctx);
+    retired.erase(it);
+  }
+}
+
+/*static*/ bool ctlscontext::is_current(SSL_CTX *ctx,
+                                        const params_t &params) {
+  stamp_t files = stamp(params);
+
+  AcquireReadLock lock(contexts_lock);
+
+  auto it = contexts.find(params);
+  return (it != contexts.end()) && (it->second.ctx == ctx) &&
+         (it->second.stamp == files);
+}
+
+/*static*/ size_t ctlscontext::size() {
+  AcquireReadLock lock(contexts_lock);
+  return contexts.size() + retired.size();
+}
+
+/*static*/ ctlscontext::stamp_t ctlscontext::stamp(const params_t &params) {
+  stamp_t files;
+  for (auto path : {&params.certfile, &params.keyfile, &params.cafile,
+                    &params.capath}) {
+    struct stat st;
+    if (path->empty() || (stat(path->c_str(), &st) < 0)) {
+      files.push_back(0);
+      files.push_back(0);
+      continue;
+    }
+    files.push_back(st.st_ino);
+    files.push_back(st.st_mtim.tv_sec * 1000000000ULL + st.st_mtim.tv_nsec);
+  }
+  return files;
+}
+
+/*static*/ SSL_CTX *ctlscontext::create(const params_t &params) {
+#if (OPENSSL_VERSION_NUMBER >= 0x1010000fL)
+  // openssl 1.1.0
+  SSL_CTX *ctx = SSL_CTX_new(TLS_method());
+#else
+  SSL_CTX *ctx = SSL_CTX_new(TLSv1_2_method());
+#endif
+
+  if (NULL == ctx) {
+    throw eLibCall("eLibCall", "SSL_CTX_new", __FILE__, __FUNCTION__,
+                   __LINE__);
+  }
+
+  // certificate
+  if (!SSL_CTX_use_certificate_file(ctx, params.certfile.c_str(),
+                                    SSL_FILETYPE_PEM)) {
+    SSL_CTX_free(ctx);
+    throw eLibCall("eLibCall", "SSL_CTX_use_certificate_file", __FILE__,
+                   __FUNCTION__, __LINE__)
+        .set_key("certfile", params.certfile);
+  }
+
+  // private key, password is needed only while loading the key
+  SSL_CTX_set_default_passwd_cb(ctx, &ctlscontext::pswd_cb);
+  SSL_CTX_set_default_passwd_cb_userdata(ctx, (void *)&params);
+
+  int rc = SSL_CTX_use_PrivateKey_file(ctx, params.keyfile.c_str(),
+                                       SSL_FILETYPE_PEM);
+
+  SSL_CTX_set_default_passwd_cb_userdata(ctx, NULL);
+
+  if (!rc) {
+    SSL_CTX_free(ctx);
+    throw eLibCall("eLibCall", "SSL_CTX_use_PrivateKey_file", __FILE__,
+                   __FUNCTION__, __LINE__)
+        .set_key("keyfile", params.keyfile);
+  }
+
+  // ciphers
+  if ((not params.ciphers.empty()) &&
+      (0 == SSL_CTX_set_cipher_list(ctx, params.ciphers.c_str()))) {
+    SSL_CTX_free(ctx);
+    throw eLibCall("eLibCall", "SSL_CTX_set_cipher_list", __FILE__,
+                   __FUNCTION__, __LINE__)
+        .set_key("ciphers", params.ciphers);
+  }
+
+  // capath/cafile
+  if (!SSL_CTX_load_verify_locations(
+          ctx, params.cafile.empty() ? NULL : params.cafile.c_str(),
+          params.capath.empty() ? NULL : params.capath.c_str())) {
+    SSL_CTX_free(ctx);
+    throw eLibCall("eLibCall", "SSL_CTX_load_verify_locations", __FILE__,
+                   __FUNCTION__, __LINE__)
+        .set_key("cafile", params.cafile)
+        .set_key("capath", params.capath);
+  }
+
+  int mode = SSL_VERIFY_NONE;
+  if (params.verify_mode == "NONE") {
+    mode = SSL_VERIFY_NONE;
+  } else if (params.verify_mode == "PEER") {
+    mode = SSL_VERIFY_PEER | SSL_VERIFY_FAIL_IF_NO_PEER_CERT;
+  }
+
+  SSL_CTX_set_verify(ctx, mode, NULL);
+
+  int depth;
+  std::istringstream(params.verify_depth) >> depth;
+
+  SSL_CTX_set_verify_depth(ctx, depth);
+
+  // server side session cache and tickets, clients resume via SSL_set_session
+  static const unsigned char sid_ctx[] = "rofl-common";
+  SSL_CTX_set_session_cache_mode(ctx, SSL_SESS_CACHE_SERVER);
+  SSL_CTX_set_session_id_context(ctx, sid_ctx, sizeof(sid_ctx) - 1);
+
+  return ctx;
+}
+
+/*static*/ int ctlscontext::pswd_cb(char *buf, int size, int rwflag,
+                                    void *userdata) {
+  if (userdata == NULL)
+    return 0;
+
+  const params_t &params = *(static_cast<const params_t *>(userdata));
+
+  if (params.password.empty()) {
+    return 0;
+  }
+
+  strncpy(buf, params.password.c_str(), size);
+
+  return strnlen(buf, size);
+}
@@ -0,0 +1,153 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * ctlscontext.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef SRC_ROFL_COMMON_CTLSCONTEXT_H_
+#define SRC_ROFL_COMMON_CTLSCONTEXT_H_
+
+#include <atomic>
+#include <inttypes.h>
+#include <map>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include <openssl/ssl.h>
+
+#include "rofl/common/exception.hpp"
+#include "rofl/common/locking.hpp"
+
+namespace rofl {
+
+/**
+ * @ingroup common_devel_workflow
+ * @brief	Process-wide cache of reference counted OpenSSL contexts
+ *
+ * Loading certificate, private key and CA locations from disk for every
+ * TLS connection is expensive. ctlscontext shares a single SSL_CTX among
+ * all sockets using identical TLS parameters. A context is created on the
+ * first acquire() for a set of parameters and destroyed when the last
+ * reference is released. A context is reloaded once the certificate, key
+ * or CA files change on disk, sockets still using the old one keep it
+ * until they release it.
+ *
+ * Sharing the context also shares the server side session cache and the
+ * session ticket keys, so peers reconnecting to any socket of this
+ * process may resume their previous TLS session.
+ */
+class ctlscontext {
+public:
+  /* TLS parameters used as key for a context */
+  struct params_t {
+    std::string capath;
+    std::string cafile;
+    std::string certfile;
+    std::string keyfile;
+    std::string password;
+    std::string verify_mode;
+    std::string verify_depth;
+    std::string ciphers;
+
+    bool operator<(const params_t &params) const {
+      return std::tie(capath, cafile, certfile, keyfile, password,
+                      verify_mode, verify_depth, ciphers) <
+             std::tie(params.capath, params.cafile, params.certfile,
+                      params.keyfile, params.password, params.verify_mode,
+                      params.verify_depth, params.ciphers);
+    };
+
+    bool operator==(const params_t &params) const {
+      return not(*this < params) && not(params < *this);
+    };
+
+    bool operator!=(const params_t &params) const {
+      return not(*this == params);
+    };
+  };
+
+public:
+  /**
+   * @brief	Returns a context for params, creating it if necessary
+   *
+   * Each successful call must be paired with a call to release().
+   *
+   * @exception eLibCall loading certificate, key or CA locations failed
+   */
+  static SSL_CTX *acquire(const params_t &params);
+
+  /**
+   * @brief	Drops a reference obtained via acquire()
+   */
+  static void release(SSL_CTX *ctx);
+
+  /**
+   * @brief	Returns true if ctx is the context acquire() would return for
+   * params, i.e. none of its files changed on disk since loading them
+   */
+  static bool is_current(SSL_CTX *ctx, const params_t &params);
+
+  /**
+   * @brief	Returns number of contexts alive, including reloaded ones
+   * still in use
+   */
+  static size_t size();
+
+  /**
+   * @brief	Returns number of acquire() calls served from the cache
+   */
+  static uint64_t get_hits() { return hits; };
+
+  /**
+   * @brief	Returns number of acquire() calls creating a new context
+   */
+  static uint64_t get_misses() { return misses; };
+
+  /**
+   * @brief	Returns number of contexts reloaded due to changed files
+   */
+  static uint64_t get_reloads() { return reloads; };
+
+private:
+  /* inode and modification time of each file a context is loaded from */
+  typedef std::vector<uint64_t> stamp_t;
+
+  static stamp_t stamp(const params_t &params);
+
+  static SSL_CTX *create(const params_t &params);
+
+  static int pswd_cb(char *buf, int size, int rwflag, void *userdata);
+
+private:
+  struct entry_t {
+    // shared OpenSSL context
+    SSL_CTX *ctx;
+    // number of references handed out by acquire()
+    unsigned int refcnt;
+    // files on disk when ctx was created
+    stamp_t stamp;
+  };
+
+  // cached contexts by TLS parameters
+  static std::map<params_t, entry_t> contexts;
+
+  // contexts replaced by a reload, still referenced by sockets
+  static std::map<SSL_CTX *, unsigned int> retired;
+
+  // rwlock for contexts
+  static crwlock contexts_lock;
+
+  // statistics
+  static std::atomic<uint64_t> hits;
+  static std::atomic<uint64_t> misses;
+  static std::atomic<uint64_t> reloads;
+};
+
+}; // end of namespace rofl
+
+#endif /* SRC_ROFL_COMMON_CTLSCONTEXT_H_ */
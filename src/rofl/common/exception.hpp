@@ -99,7 +99,11 @@ public:
   const std::string &get_func() const { return get_key("func"); };
 
   /**
+   * @brief	Sets the function name, returns rofl::exception
    *
+   * "throw eDerived(...).set_func(...)" throws a sliced rofl::exception.
+   * Pass file, function and line to the constructor instead, or decorate
+   * a named instance and throw that one.
    */
   exception &set_func(const std::string &s_func) {
     set_key("func", s_func);
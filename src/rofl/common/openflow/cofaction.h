@@ -16,6 +16,7 @@
 
 #include "rofl/common/caddress.h"
 #include "rofl/common/cmemory.h"
+#include "rofl/common/cslab.hpp"
 #include "rofl/common/exception.hpp"
 #include "rofl/common/openflow/coxmatch.h"
 #include "rofl/common/openflow/openflow_rofl_exceptions.h"
@@ -34,7 +35,7 @@ class eActionInval : public eActionBase {};     // invalid parameter
 class eActionInvalType : public eActionBase {}; // invalid action type
 class eActionNotFound : public eActionBase {};
 
-class cofaction {
+class cofaction : public rofl::cslab_object {
 public:
   /**
    *
@@ -72,6 +73,7 @@ public:
     return *this;
   };
 
+public:
   /**
    *
    */
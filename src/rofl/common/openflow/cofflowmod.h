@@ -405,6 +405,8 @@ public:
   };
 
 private: // data structures
+  friend class cofflowmod_template;
+
   uint8_t ofp_version;
 
   cofmatch match;
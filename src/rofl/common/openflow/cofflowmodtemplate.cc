@@ -0,0 +1,214 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * cofflowmodtemplate.cc
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <stddef.h>
+
+#include "cofflowmodtemplate.h"
+
+using namespace rofl::openflow;
+
+cofflowmod_template::cofflowmod_template(const cofflowmod &flowmod)
+    : ofp_version(flowmod.get_version()), wire(flowmod.length()) {
+  /* pack() is not declared const, but leaves flowmod unaltered */
+  const_cast<cofflowmod &>(flowmod).pack(wire.somem(), wire.length());
+
+  switch (ofp_version) {
+  case rofl::openflow10::OFP_VERSION: {
+    index_actions(offsetof(cofflowmod::ofp10_flow_mod, actions),
+                  wire.length());
+  } break;
+  case rofl::openflow12::OFP_VERSION:
+  case rofl::openflow13::OFP_VERSION: {
+    index_match(offsetof(cofflowmod::ofp13_flow_mod, match));
+  } break;
+  default:
+    throw eBadVersion("eBadVersion", __FILE__, __FUNCTION__, __LINE__);
+  }
+}
+
+void cofflowmod_template::pack(uint8_t *buf, size_t buflen) const {
+  if ((0 == buf) || (0 == buflen))
+    return;
+
+  if (buflen < wire.length())
+    throw eInvalid("cofflowmod_template::pack() buflen too short", __FILE__,
+                   __FUNCTION__, __LINE__);
+
+  memcpy(buf, wire.somem(), wire.length());
+}
+
+size_t cofflowmod_template::get_match_field(uint32_t oxm_type) const {
+  for (auto &field : match_fields) {
+    if ((field.first & 0xfffffe00) == (oxm_type & 0xfffffe00))
+      return field.second;
+  }
+  throw eOxmNotFound("cofflowmod_template::get_match_field() not found");
+}
+
+size_t cofflowmod_template::get_set_field(uint32_t oxm_type,
+                                          unsigned int index) const {
+  for (auto &field : set_fields) {
+    if (((field.first & 0xfffffe00) == (oxm_type & 0xfffffe00)) &&
+        (index-- == 0))
+      return field.second;
+  }
+  throw eOxmActionNotFound("cofflowmod_template::get_set_field() not found");
+}
+
+cofflowmod_template &cofflowmod_template::set_cookie(uint64_t cookie) {
+  switch (ofp_version) {
+  case rofl::openflow10::OFP_VERSION: {
+    return set_u64(offsetof(cofflowmod::ofp10_flow_mod, cookie), cookie);
+  };
+  default: {
+    return set_u64(offsetof(cofflowmod::ofp13_flow_mod, cookie), cookie);
+  };
+  }
+}
+
+cofflowmod_template &cofflowmod_template::set_priority(uint16_t priority) {
+  switch (ofp_version) {
+  case rofl::openflow10::OFP_VERSION: {
+    return set_u16(offsetof(cofflowmod::ofp10_flow_mod, priority), priority);
+  };
+  default: {
+    return set_u16(offsetof(cofflowmod::ofp13_flow_mod, priority), priority);
+  };
+  }
+}
+
+cofflowmod_template &
+cofflowmod_template::set_idle_timeout(uint16_t idle_timeout) {
+  switch (ofp_version) {
+  case rofl::openflow10::OFP_VERSION: {
+    return set_u16(offsetof(cofflowmod::ofp10_flow_mod, idle_timeout),
+                   idle_timeout);
+  };
+  default: {
+    return set_u16(offsetof(cofflowmod::ofp13_flow_mod, idle_timeout),
+                   idle_timeout);
+  };
+  }
+}
+
+cofflowmod_template &
+cofflowmod_template::set_hard_timeout(uint16_t hard_timeout) {
+  switch (ofp_version) {
+  case rofl::openflow10::OFP_VERSION: {
+    return set_u16(offsetof(cofflowmod::ofp10_flow_mod, hard_timeout),
+                   hard_timeout);
+  };
+  default: {
+    return set_u16(offsetof(cofflowmod::ofp13_flow_mod, hard_timeout),
+                   hard_timeout);
+  };
+  }
+}
+
+cofflowmod_template &cofflowmod_template::set_buffer_id(uint32_t buffer_id) {
+  switch (ofp_version) {
+  case rofl::openflow10::OFP_VERSION: {
+    return set_u32(offsetof(cofflowmod::ofp10_flow_mod, buffer_id),
+                   buffer_id);
+  };
+  default: {
+    return set_u32(offsetof(cofflowmod::ofp13_flow_mod, buffer_id),
+                   buffer_id);
+  };
+  }
+}
+
+cofflowmod_template &cofflowmod_template::set_output_port(unsigned int index,
+                                                          uint32_t port_no) {
+  if (index >= output_ports.size())
+    throw eOxmActionNotFound(
+        "cofflowmod_template::set_output_port() not found");
+
+  switch (ofp_version) {
+  case rofl::openflow10::OFP_VERSION: {
+    if (port_no > 0xffff)
+      throw eInvalid("cofflowmod_template::set_output_port() port_no exceeds "
+                     "OpenFlow 1.0 range",
+                     __FILE__, __FUNCTION__, __LINE__);
+    return set_u16(output_ports[index], (uint16_t)port_no);
+  };
+  default: { return set_u32(output_ports[index], port_no); };
+  }
+}
+
+size_t cofflowmod_template::value_offset(uint32_t oxm_id) {
+  /* experimenter OXMs carry a 32bit experimenter id ahead of the value */
+  if ((oxm_id >> 16) == rofl::openflow13::OFPXMC_EXPERIMENTER)
+    return 8;
+  return 4;
+}
+
+void cofflowmod_template::index_match(size_t offset) {
+  uint8_t *buf = wire.somem();
+
+  /* struct ofp_match: type, length, OXM TLVs, padding to 8 bytes */
+  size_t matchlen = be16toh(*(uint16_t *)(buf + offset + 2));
+  size_t end = offset + matchlen;
+  for (size_t oxm = offset + 4; oxm + 4 <= end;) {
+    uint32_t oxm_id = be32toh(*(uint32_t *)(buf + oxm));
+    match_fields.push_back(field_t(oxm_id, oxm + value_offset(oxm_id)));
+    oxm += 4 + (oxm_id & 0x000000ff);
+  }
+
+  index_instructions(offset + ((matchlen + 7) / 8) * 8);
+}
+
+void cofflowmod_template::index_instructions(size_t offset) {
+  uint8_t *buf = wire.somem();
+
+  /* struct ofp_instruction: type, len, body */
+  while (offset + 4 <= wire.length()) {
+    uint16_t type = be16toh(*(uint16_t *)(buf + offset));
+    size_t len = be16toh(*(uint16_t *)(buf + offset + 2));
+    if (len < 4)
+      return;
+    switch (type) {
+    case rofl::openflow13::OFPIT_WRITE_ACTIONS:
+    case rofl::openflow13::OFPIT_APPLY_ACTIONS: {
+      /* struct ofp_instruction_actions: type, len, pad[4], actions */
+      index_actions(offset + 8, offset + len);
+    } break;
+    default: {};
+    }
+    offset += len;
+  }
+}
+
+void cofflowmod_template::index_actions(size_t offset, size_t end) {
+  uint8_t *buf = wire.somem();
+
+  /* struct ofp_action_header: type, len, body */
+  while (offset + 4 <= end) {
+    uint16_t type = be16toh(*(uint16_t *)(buf + offset));
+    size_t len = be16toh(*(uint16_t *)(buf + offset + 2));
+    if (len < 4)
+      return;
+    switch (type) {
+    case rofl::openflow13::OFPAT_OUTPUT: {
+      /* OFPAT_OUTPUT is 0 in all versions, port follows the header */
+      output_ports.push_back(offset + 4);
+    } break;
+    case rofl::openflow13::OFPAT_SET_FIELD: {
+      if (ofp_version != rofl::openflow10::OFP_VERSION) {
+        uint32_t oxm_id = be32toh(*(uint32_t *)(buf + offset + 4));
+        set_fields.push_back(
+            field_t(oxm_id, offset + 4 + value_offset(oxm_id)));
+      }
+    } break;
+    default: {};
+    }
+    offset += len;
+  }
+}
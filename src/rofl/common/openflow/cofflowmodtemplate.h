@@ -0,0 +1,234 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * cofflowmodtemplate.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef ROFL_COMMON_OPENFLOW_COFFLOWMODTEMPLATE_H
+#define ROFL_COMMON_OPENFLOW_COFFLOWMODTEMPLATE_H 1
+
+#include <endian.h>
+#include <string.h>
+#include <utility>
+#include <vector>
+
+#include "rofl/common/caddress.h"
+#include "rofl/common/cmemory.h"
+#include "rofl/common/openflow/cofflowmod.h"
+#include "rofl/common/openflow/coxmatch.h"
+
+namespace rofl {
+namespace openflow {
+
+/**
+ * @brief	Pre-packed Flow-Mod body with in-place patchable fields
+ *
+ * The Flow-Mod is packed once on construction. Values of match fields,
+ * Set-Field actions and Output actions are located by walking the packed
+ * image and are afterwards addressed by their offset, so that a Flow-Mod
+ * differing only in these values is produced without building and
+ * packing cofmatch, cofinstructions and cofactions again. Values are
+ * patched in network byte order, the length of the image never changes.
+ *
+ * Match fields are available for OpenFlow 1.2 and above only. Send a
+ * template via crofdpt::send_flow_mod_message() or add it to a
+ * cofmsg_flow_mod_batch.
+ */
+class cofflowmod_template {
+public:
+  /**
+   *
+   */
+  ~cofflowmod_template(){};
+
+  /**
+   *
+   */
+  cofflowmod_template(const rofl::openflow::cofflowmod &flowmod);
+
+public:
+  /**
+   *
+   */
+  uint8_t get_version() const { return ofp_version; };
+
+  /**
+   * @brief	Returns length of the Flow-Mod body without OpenFlow header
+   */
+  size_t length() const { return wire.length(); };
+
+  /**
+   *
+   */
+  const uint8_t *get_wire() const { return wire.somem(); };
+
+  /**
+   * @brief	Copies the Flow-Mod body to buf
+   */
+  void pack(uint8_t *buf, size_t buflen) const;
+
+public:
+  /**
+   * @brief	Returns offset of the value of a match field
+   *
+   * @param oxm_type OXM type, e.g. OXM_TLV_BASIC_ETH_DST, mask bit and
+   * length are ignored
+   * @exception eOxmNotFound
+   */
+  size_t get_match_field(uint32_t oxm_type) const;
+
+  /**
+   * @brief	Returns offset of the value of a Set-Field action
+   *
+   * @param oxm_type OXM type, mask bit and length are ignored
+   * @param index selects among Set-Field actions of this type
+   * @exception eOxmActionNotFound
+   */
+  size_t get_set_field(uint32_t oxm_type, unsigned int index = 0) const;
+
+  /**
+   * @brief	Returns number of Output actions
+   */
+  size_t get_num_output_ports() const { return output_ports.size(); };
+
+public:
+  /**
+   *
+   */
+  cofflowmod_template &set_cookie(uint64_t cookie);
+
+  /**
+   *
+   */
+  cofflowmod_template &set_priority(uint16_t priority);
+
+  /**
+   *
+   */
+  cofflowmod_template &set_idle_timeout(uint16_t idle_timeout);
+
+  /**
+   *
+   */
+  cofflowmod_template &set_hard_timeout(uint16_t hard_timeout);
+
+  /**
+   *
+   */
+  cofflowmod_template &set_buffer_id(uint32_t buffer_id);
+
+  /**
+   * @brief	Sets port of the index-th Output action in Flow-Mod order
+   *
+   * @exception eOxmActionNotFound
+   * @exception eInvalid port_no exceeds 16 bits on OpenFlow 1.0
+   */
+  cofflowmod_template &set_output_port(unsigned int index, uint32_t port_no);
+
+public:
+  /**
+   *
+   */
+  cofflowmod_template &set_u8(size_t offset, uint8_t value) {
+    *patch(offset, sizeof(value)) = value;
+    return *this;
+  };
+
+  /**
+   *
+   */
+  cofflowmod_template &set_u16(size_t offset, uint16_t value) {
+    value = htobe16(value);
+    memcpy(patch(offset, sizeof(value)), &value, sizeof(value));
+    return *this;
+  };
+
+  /**
+   *
+   */
+  cofflowmod_template &set_u32(size_t offset, uint32_t value) {
+    value = htobe32(value);
+    memcpy(patch(offset, sizeof(value)), &value, sizeof(value));
+    return *this;
+  };
+
+  /**
+   *
+   */
+  cofflowmod_template &set_u64(size_t offset, uint64_t value) {
+    value = htobe64(value);
+    memcpy(patch(offset, sizeof(value)), &value, sizeof(value));
+    return *this;
+  };
+
+  /**
+   *
+   */
+  cofflowmod_template &set_mac(size_t offset, const rofl::caddress_ll &addr) {
+    memcpy(patch(offset, addr.length()), addr.somem(), addr.length());
+    return *this;
+  };
+
+  /**
+   *
+   */
+  cofflowmod_template &set_ipv4(size_t offset,
+                                const rofl::caddress_in4 &addr) {
+    uint32_t value = addr.get_addr_nbo();
+    memcpy(patch(offset, sizeof(value)), &value, sizeof(value));
+    return *this;
+  };
+
+public:
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const cofflowmod_template &tmpl) {
+    os << "<cofflowmod_template version: " << (int)tmpl.get_version()
+       << " length: " << tmpl.length()
+       << " #match-fields: " << tmpl.match_fields.size()
+       << " #set-fields: " << tmpl.set_fields.size()
+       << " #output-ports: " << tmpl.output_ports.size() << " >" << std::endl;
+    return os;
+  };
+
+private:
+  uint8_t *patch(size_t offset, size_t len) {
+    if (offset + len > wire.length())
+      throw eInvalid("cofflowmod_template::patch() offset out of range",
+                     __FILE__, __FUNCTION__, __LINE__);
+    return wire.somem() + offset;
+  };
+
+  static size_t value_offset(uint32_t oxm_id);
+
+  void index_match(size_t offset);
+
+  void index_instructions(size_t offset);
+
+  void index_actions(size_t offset, size_t end);
+
+private:
+  typedef std::pair<uint32_t, size_t> field_t;
+
+  uint8_t ofp_version;
+
+  // packed Flow-Mod body
+  rofl::cmemory wire;
+
+  // (OXM type, offset of value) for all fields in the match
+  std::vector<field_t> match_fields;
+
+  // (OXM type, offset of value) for all Set-Field actions
+  std::vector<field_t> set_fields;
+
+  // offsets of the port of all Output actions
+  std::vector<size_t> output_ports;
+};
+
+}; // end of namespace openflow
+}; // end of namespace rofl
+
+#endif /* ROFL_COMMON_OPENFLOW_COFFLOWMODTEMPLATE_H */
@@ -15,6 +15,7 @@
 #endif
 
 #include "rofl/common/cmemory.h"
+#include "rofl/common/cslab.hpp"
 #include "rofl/common/exception.hpp"
 #include "rofl/common/openflow/cofactions.h"
 #include "rofl/common/openflow/openflow.h"
@@ -22,7 +23,7 @@
 namespace rofl {
 namespace openflow {
 
-class cofinstruction {
+class cofinstruction : public rofl::cslab_object {
 public:
   /**
    *
@@ -52,6 +53,7 @@ public:
     return *this;
   };
 
+public:
   /**
    *
    */
@@ -22,6 +22,7 @@
 
 #include "rofl/common/caddress.h"
 #include "rofl/common/cmemory.h"
+#include "rofl/common/cslab.hpp"
 #include "rofl/common/exception.hpp"
 #include "rofl/common/openflow/openflow.h"
 
@@ -69,7 +70,7 @@ public:
 /**
  *
  */
-class coxmatch {
+class coxmatch : public rofl::cslab_object {
 public:
   /**
    *
@@ -101,6 +102,7 @@ public:
     return *this;
   };
 
+public:
   /**
    *
    */
@@ -10,6 +10,7 @@
  */
 
 #include <stdexcept>
+#include <string.h>
 
 #include "rofl/common/openflow/coxmatches.h"
 
@@ -30,248 +31,268 @@ coxmatches &coxmatches::operator=(coxmatches const &oxms) {
 }
 
 bool coxmatches::operator==(coxmatches const &oxms) const {
+  sync();
+  oxms.sync();
   if (matches.size() != oxms.matches.size()) {
     return false;
   }
-  for (std::map<uint64_t, coxmatch *>::const_iterator it = matches.begin();
-       it != matches.end(); ++it) {
-    if (oxms.matches.find(it->first) == oxms.matches.end()) {
+  for (auto &it : matches) {
+    auto jt = oxms.matches.find(it.first);
+    if (jt == oxms.matches.end()) {
       return false;
     }
-    if (*it->second != *oxms.matches.at(it->first)) {
+    if (it.second.get_oxm_id() != jt->second.get_oxm_id()) {
       return false;
     }
   }
   return true;
 }
 
+namespace {
+
+/* decoder descriptor for a single OXM field */
+struct coxmatch_desc {
+  uint32_t oxm_id; // OXM TLV identifier without mask
+  uint8_t size;    // value length in bytes, 0 for variable length
+  bool maskable;   // hasmask flag permitted
+};
+
+constexpr coxmatch_desc make_desc(uint32_t oxm_id, bool maskable) {
+  return {oxm_id, (uint8_t)(oxm_id & 0xff), maskable};
+}
+
+/* OpenFlow basic class, indexed by field */
+constexpr coxmatch_desc ofb_descs[OFPXMT_OFB_MAX] = {
+    make_desc(OXM_TLV_BASIC_IN_PORT, false),
+    make_desc(OXM_TLV_BASIC_IN_PHY_PORT, false),
+    make_desc(OXM_TLV_BASIC_METADATA, true),
+    make_desc(OXM_TLV_BASIC_ETH_DST, true),
+    make_desc(OXM_TLV_BASIC_ETH_SRC, true),
+    make_desc(OXM_TLV_BASIC_ETH_TYPE, false),
+    make_desc(OXM_TLV_BASIC_VLAN_VID, true),
+    make_desc(OXM_TLV_BASIC_VLAN_PCP, false),
+    make_desc(OXM_TLV_BASIC_IP_DSCP, false),
+    make_desc(OXM_TLV_BASIC_IP_ECN, false),
+    make_desc(OXM_TLV_BASIC_IP_PROTO, false),
+    make_desc(OXM_TLV_BASIC_IPV4_SRC, true),
+    make_desc(OXM_TLV_BASIC_IPV4_DST, true),
+    make_desc(OXM_TLV_BASIC_TCP_SRC, false),
+    make_desc(OXM_TLV_BASIC_TCP_DST, false),
+    make_desc(OXM_TLV_BASIC_UDP_SRC, false),
+    make_desc(OXM_TLV_BASIC_UDP_DST, false),
+    make_desc(OXM_TLV_BASIC_SCTP_SRC, false),
+    make_desc(OXM_TLV_BASIC_SCTP_DST, false),
+    make_desc(OXM_TLV_BASIC_ICMPV4_TYPE, false),
+    make_desc(OXM_TLV_BASIC_ICMPV4_CODE, false),
+    make_desc(OXM_TLV_BASIC_ARP_OP, false),
+    make_desc(OXM_TLV_BASIC_ARP_SPA, true),
+    make_desc(OXM_TLV_BASIC_ARP_TPA, true),
+    make_desc(OXM_TLV_BASIC_ARP_SHA, true),
+    make_desc(OXM_TLV_BASIC_ARP_THA, true),
+    make_desc(OXM_TLV_BASIC_IPV6_SRC, true),
+    make_desc(OXM_TLV_BASIC_IPV6_DST, true),
+    make_desc(OXM_TLV_BASIC_IPV6_FLABEL, true),
+    make_desc(OXM_TLV_BASIC_ICMPV6_TYPE, false),
+    make_desc(OXM_TLV_BASIC_ICMPV6_CODE, false),
+    make_desc(OXM_TLV_BASIC_IPV6_ND_TARGET, false),
+    make_desc(OXM_TLV_BASIC_IPV6_ND_SLL, false),
+    make_desc(OXM_TLV_BASIC_IPV6_ND_TLL, false),
+    make_desc(OXM_TLV_BASIC_MPLS_LABEL, false),
+    make_desc(OXM_TLV_BASIC_MPLS_TC, false),
+    make_desc(OXM_TLV_BASIC_MPLS_BOS, false),
+    make_desc(OXM_TLV_BASIC_PBB_ISID, true),
+    make_desc(OXM_TLV_BASIC_TUNNEL_ID, true),
+    make_desc(OXM_TLV_BASIC_IPV6_EXTHDR, true),
+};
+
+/* ROFL experimenter class, indexed by field */
+constexpr coxmatch_desc ofx_descs[experimental::OFPXMT_OFX_MAX] = {
+    make_desc(experimental::OXM_TLV_EXPR_NW_SRC, true),
+    make_desc(experimental::OXM_TLV_EXPR_NW_DST, true),
+    make_desc(experimental::OXM_TLV_EXPR_NW_PROTO, false),
+    make_desc(experimental::OXM_TLV_EXPR_NW_TOS, false),
+    make_desc(experimental::OXM_TLV_EXPR_TP_SRC, false),
+    make_desc(experimental::OXM_TLV_EXPR_TP_DST, false),
+};
+
+/* any other experimenter, value and mask are stored as opaque bytes */
+constexpr coxmatch_desc exp_desc = {(uint32_t)OFPXMC_EXPERIMENTER << 16, 0,
+                                    true};
+
+/* every table entry must sit at the index of its own field */
+constexpr bool check_descs(const coxmatch_desc *descs, unsigned int num,
+                           unsigned int i = 0) {
+  return (i == num) || ((((descs[i].oxm_id >> 9) & 0x7f) == i) &&
+                        check_descs(descs, num, i + 1));
+}
+
+/* every fixed-size TLV with mask must fit into a slot */
+constexpr bool check_sizes(const coxmatch_desc *descs, unsigned int num,
+                           unsigned int i = 0) {
+  return (i == num) || ((sizeof(struct ofp_oxm_hdr) + 2 * descs[i].size <=
+                         sizeof(coxmatch_slot::buf)) &&
+                        check_sizes(descs, num, i + 1));
+}
+
+static_assert(check_descs(ofb_descs, OFPXMT_OFB_MAX),
+              "ofb_descs not indexed by field");
+static_assert(check_descs(ofx_descs, experimental::OFPXMT_OFX_MAX),
+              "ofx_descs not indexed by field");
+static_assert(check_sizes(ofb_descs, OFPXMT_OFB_MAX),
+              "ofb_descs field exceeds coxmatch_slot");
+static_assert(check_sizes(ofx_descs, experimental::OFPXMT_OFX_MAX),
+              "ofx_descs field exceeds coxmatch_slot");
+
+/* reads the TLV header at buf and checks it against the descriptor table,
+ * returns nullptr for TLVs of unknown classes that are to be skipped */
+const coxmatch_desc *check_tlv(const uint8_t *buf, size_t buflen,
+                               size_t &tlvlen, uint64_t &oxm_type) {
+  uint32_t oxm_id =
+      be32toh(((const struct rofl::openflow::ofp_oxm_tlv_hdr *)buf)->oxm_id);
+  unsigned int field = (oxm_id >> 9) & 0x7f;
+  bool hasmask = (oxm_id & HAS_MASK_FLAG);
+
+  tlvlen = sizeof(struct rofl::openflow::ofp_oxm_hdr) + (oxm_id & 0xff);
+  oxm_type = OXM_ROFL_TYPE(oxm_id);
+
+  if (buflen < tlvlen) {
+    throw eOxmBadLen("coxmatches::unpack() buflen too short");
+  }
+
+  const coxmatch_desc *desc = nullptr;
+  size_t hdrlen = sizeof(struct rofl::openflow::ofp_oxm_hdr);
+
+  switch (oxm_id >> 16) {
+  case rofl::openflow::OFPXMC_OPENFLOW_BASIC: {
+    if (field < OFPXMT_OFB_MAX) {
+      desc = &ofb_descs[field];
+    }
+  } break;
+  case rofl::openflow::OFPXMC_EXPERIMENTER: {
+    hdrlen = sizeof(struct rofl::openflow::ofp_oxm_experimenter_header);
+    if (tlvlen < hdrlen) {
+      throw eOxmBadLen("coxmatches::unpack() invalid oxm_length field");
+    }
+    uint32_t exp_id = be32toh(
+        ((const struct rofl::openflow::ofp_oxm_experimenter_header *)buf)
+            ->experimenter);
+    oxm_type |= ((uint64_t)exp_id) << 32;
+    if ((ROFL_EXP_ID == exp_id) && (field < experimental::OFPXMT_OFX_MAX)) {
+      desc = &ofx_descs[field];
+    } else {
+      desc = &exp_desc;
+    }
+  } break;
+  default: {
+    /* unknown OXM class, skip TLV */
+  };
+  }
+
+  if (desc) {
+    if (hasmask && not desc->maskable) {
+      throw rofl::eBadMatchBadMask("eBadMatchBadMask", __FILE__, __FUNCTION__,
+                             __LINE__);
+    }
+    if (desc->size && (tlvlen != hdrlen + (desc->size << hasmask))) {
+      throw eOxmBadLen("coxmatches::unpack() invalid oxm_length field");
+    }
+  }
+
+  return desc;
+}
+
+}; // namespace
+
 void coxmatches::unpack(uint8_t *buf, size_t buflen) {
   clear();
 
-  while (true) {
+  AcquireReadWriteLock lock(rwlock);
 
-    if (buflen < sizeof(struct openflow::ofp_oxm_hdr)) {
-      return; // not enough bytes to parse an entire ofp_oxm_hdr, possibly
-              // padding bytes found
-    }
+  /* trailing bytes shorter than an ofp_oxm_hdr are padding */
+  while (buflen >= sizeof(struct openflow::ofp_oxm_hdr)) {
 
-    struct openflow::ofp_oxm_hdr *hdr = (struct openflow::ofp_oxm_hdr *)buf;
-
-    switch (be16toh(hdr->oxm_class)) {
-    case rofl::openflow::OFPXMC_OPENFLOW_BASIC: {
-
-      if (buflen < sizeof(struct openflow::ofp_oxm_hdr)) {
-        throw eOxmBadLen("coxmatches::unpack() buflen too short");
-      }
-
-      struct rofl::openflow::ofp_oxm_tlv_hdr *oxm =
-          (struct rofl::openflow::ofp_oxm_tlv_hdr *)buf;
-
-      uint64_t oxm_type = OXM_ROFL_TYPE(be32toh(oxm->oxm_id));
-
-      switch (oxm_type) {
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PORT): {
-        add_ofb_in_port().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT): {
-        add_ofb_in_phy_port().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA): {
-        add_ofb_metadata().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST): {
-        add_ofb_eth_dst().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC): {
-        add_ofb_eth_src().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_TYPE): {
-        add_ofb_eth_type().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID): {
-        add_ofb_vlan_vid().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_PCP): {
-        add_ofb_vlan_pcp().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_DSCP): {
-        add_ofb_ip_dscp().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN): {
-        add_ofb_ip_ecn().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_PROTO): {
-        add_ofb_ip_proto().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC): {
-        add_ofb_ipv4_src().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST): {
-        add_ofb_ipv4_dst().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_SRC): {
-        add_ofb_tcp_src().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_DST): {
-        add_ofb_tcp_dst().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_SRC): {
-        add_ofb_udp_src().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_DST): {
-        add_ofb_udp_dst().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_SRC): {
-        add_ofb_sctp_src().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_DST): {
-        add_ofb_sctp_dst().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE): {
-        add_ofb_icmpv4_type().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE): {
-        add_ofb_icmpv4_code().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP): {
-        add_ofb_arp_opcode().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA): {
-        add_ofb_arp_spa().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA): {
-        add_ofb_arp_tpa().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA): {
-        add_ofb_arp_sha().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA): {
-        add_ofb_arp_tha().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC): {
-        add_ofb_ipv6_src().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST): {
-        add_ofb_ipv6_dst().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL): {
-        add_ofb_ipv6_flabel().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE): {
-        add_ofb_icmpv6_type().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE): {
-        add_ofb_icmpv6_code().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET): {
-        add_ofb_ipv6_nd_target().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL): {
-        add_ofb_ipv6_nd_sll().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL): {
-        add_ofb_ipv6_nd_tll().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL): {
-        add_ofb_mpls_label().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_TC): {
-        add_ofb_mpls_tc().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_BOS): {
-        add_ofb_mpls_bos().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID): {
-        add_ofb_pbb_isid().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID): {
-        add_ofb_mpls_bos().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR): {
-        add_ofb_ipv6_exthdr().unpack(buf, buflen);
-      } break;
-      default: {};
-      }
-
-    } break;
-    case rofl::openflow::OFPXMC_EXPERIMENTER: {
-
-      if (buflen < sizeof(struct openflow::ofp_oxm_experimenter_header)) {
-        throw eOxmBadLen("coxmatches::unpack() buflen too short");
-      }
-
-      struct rofl::openflow::ofp_oxm_experimenter_header *oxm =
-          (struct rofl::openflow::ofp_oxm_experimenter_header *)buf;
-
-      uint64_t oxm_type = ((uint64_t)be32toh(oxm->experimenter)) << 32;
-
-      struct rofl::openflow::ofp_oxm_tlv_hdr *hdr =
-          (struct rofl::openflow::ofp_oxm_tlv_hdr *)buf;
-      oxm_type |= OXM_ROFL_TYPE(be32toh(hdr->oxm_id));
-
-      uint32_t exp_id = be32toh(oxm->experimenter);
-      uint32_t oxm_id = be32toh(hdr->oxm_id);
-
-      switch (oxm_type) {
-      case OXM_ROFL_OFX_TYPE(
-          rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC): {
-        add_ofx_nw_src().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFX_TYPE(
-          rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST): {
-        add_ofx_nw_dst().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFX_TYPE(
-          rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO): {
-        add_ofx_nw_proto().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFX_TYPE(
-          rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS): {
-        add_ofx_nw_tos().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFX_TYPE(
-          rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC): {
-        add_ofx_tp_src().unpack(buf, buflen);
-      } break;
-      case OXM_ROFL_OFX_TYPE(
-          rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST): {
-        add_ofx_tp_dst().unpack(buf, buflen);
-      } break;
-      default: { add_exp_match(exp_id, oxm_id).unpack(buf, buflen); };
-      }
-
-    } break;
+    size_t tlvlen = 0;
+    uint64_t oxm_type = 0;
+    const coxmatch_desc *desc = check_tlv(buf, buflen, tlvlen, oxm_type);
+
+    if (desc) {
+      /* TLVs arrive in ascending order usually, so this appends */
+      memcpy(alloc_slot(oxm_type, tlvlen).tlv(), buf, tlvlen);
     }
 
-    if (buflen >= (sizeof(struct openflow::ofp_oxm_hdr) + hdr->oxm_length)) {
-      buflen -= ((sizeof(struct openflow::ofp_oxm_hdr) + hdr->oxm_length));
-      buf += ((sizeof(struct openflow::ofp_oxm_hdr) + hdr->oxm_length));
-    } else {
-      return;
+    buflen -= tlvlen;
+    buf += tlvlen;
+  }
+}
+
+/*static*/ void coxmatches::validate(const uint8_t *buf, size_t buflen) {
+  while (buflen >= sizeof(struct openflow::ofp_oxm_hdr)) {
+
+    size_t tlvlen = 0;
+    uint64_t oxm_type = 0;
+    check_tlv(buf, buflen, tlvlen, oxm_type);
+
+    buflen -= tlvlen;
+    buf += tlvlen;
+  }
+}
+
+void coxmatches::sync() const {
+  /* fields are modified through the non-const accessors only, which must
+   * not race with readers anyway */
+  if (fields.empty()) {
+    return;
+  }
+  AcquireReadWriteLock lock(rwlock);
+  coxmatches *oxms = const_cast<coxmatches *>(this);
+  for (auto &it : fields) {
+    size_t tlvlen = it.second->length();
+    it.second->pack(oxms->alloc_slot(it.first, tlvlen).tlv(), tlvlen);
+  }
+}
+
+void coxmatches::flush() const {
+  for (auto &it : fields) {
+    delete it.second;
+  }
+  fields.clear();
+}
+
+coxmatch_slot &coxmatches::alloc_slot(uint64_t oxm_type, size_t tlvlen) {
+  coxmatch_slot &slot = matches[oxm_type];
+  if (tlvlen > sizeof(slot.buf)) {
+    if ((nullptr == slot.ext) || (slot.length() < tlvlen)) {
+      delete[] slot.ext;
+      slot.ext = nullptr;
+      slot.ext = new uint8_t[tlvlen];
     }
+  } else if (slot.ext) {
+    delete[] slot.ext;
+    slot.ext = nullptr;
   }
+  return slot;
 }
 
 void coxmatches::pack(uint8_t *buf, size_t buflen) {
+  /* length() syncs the slots */
   if (buflen < length()) {
     throw eBadMatchBadLen("eBadMatchBadLen", __FILE__, __FUNCTION__, __LINE__);
   }
-  for (std::map<uint64_t, coxmatch *>::iterator jt = matches.begin();
-       jt != matches.end(); ++jt) {
+  for (auto &jt : matches) {
 
-    coxmatch *match = (matches[jt->first]);
+    size_t len = jt.second.length();
 
-    match->pack(buf, match->length());
+    memcpy(buf, jt.second.tlv(), len);
 
-    buf += match->length();
+    buf += len;
   }
 }
 
 size_t coxmatches::length() const {
+  sync();
   size_t len = 0;
-  for (std::map<uint64_t, coxmatch *>::const_iterator it = matches.begin();
-       it != matches.end(); ++it) {
-    len += it->second->length();
+  for (auto &it : matches) {
+    len += it.second.length();
   }
   return len;
 }
@@ -288,6 +309,9 @@ bool coxmatches::contains(coxmatches const &oxms,
    * may contain additional OXM TLVs
    */
 
+  sync();
+  oxms.sync();
+
   if (strict) {
     // strict: # of elems for an ofm_class must be the same in oxl for the
     // specific ofm_class
@@ -304,25 +328,25 @@ bool coxmatches::contains(coxmatches const &oxms,
 
   // strict: check all TLVs for specific class in oxl.matches => must exist and
   // have same value
-  for (std::map<uint64_t, coxmatch *>::iterator jt = matches.begin();
-       jt != matches.end(); ++jt) {
+  for (auto jt = matches.begin(); jt != matches.end(); ++jt) {
 
-    coxmatch *lmatch = (jt->second);
+    const coxmatch_slot &lmatch = (jt->second);
 
     // keep in mind: match.get_oxm_id() & 0xfffffe00 == jt->first
 
     // strict: all OXM TLVs must also exist in oxl
     uint64_t id =
-        (__UINT64_C(0xfffffe00) & lmatch->get_oxm_id()) << 32 |
+        (__UINT64_C(0xfffffe00) & lmatch.get_oxm_id()) << 32 |
         0 /*(lmatch->is_experimenter() ? lmatch->get_oxm_exp_id() : 0)*/;
     if (oxms.matches.find(id) == oxms.matches.end()) {
       return false;
     }
 
-    coxmatch const *rmatch = (oxms.matches.find(jt->first)->second);
+    auto rt = oxms.matches.find(jt->first);
 
     // strict: both OXM TLVs must have identical values
-    if (*lmatch != *rmatch) {
+    if ((rt == oxms.matches.end()) ||
+        (lmatch.get_oxm_id() != rt->second.get_oxm_id())) {
       return false;
     }
   }
@@ -334,22 +358,26 @@ bool coxmatches::is_part_of(coxmatches const &oxms, uint16_t &exact_hits,
                             uint16_t &wildcard_hits, uint16_t &missed) {
   bool result = true;
 
-  for (std::map<uint64_t, coxmatch *>::const_iterator jt = oxms.matches.begin();
-       jt != oxms.matches.end(); ++jt) {
+  sync();
+  oxms.sync();
+
+  for (auto jt = oxms.matches.begin(); jt != oxms.matches.end(); ++jt) {
 
-    coxmatch const *rmatch = (jt->second);
+    const coxmatch_slot &rmatch = (jt->second);
 
     // keep in mind: match.get_oxm_id() & 0xfffffe00 == jt->first
 
     uint64_t id =
-        (__UINT64_C(0xfffffe00) & rmatch->get_oxm_id()) << 32 |
+        (__UINT64_C(0xfffffe00) & rmatch.get_oxm_id()) << 32 |
         0 /*(rmatch->is_experimenter() ? rmatch->get_oxm_exp_id() : 0)*/;
     if (matches.find(id) == matches.end()) {
       wildcard_hits++;
       continue;
     }
 
-    if (*matches[jt->first] != *rmatch) {
+    auto lt = matches.find(jt->first);
+    if ((lt == matches.end()) ||
+        (lt->second.get_oxm_id() != rmatch.get_oxm_id())) {
       missed++;
       result = false;
       continue;
@@ -363,157 +391,18 @@ bool coxmatches::is_part_of(coxmatches const &oxms, uint16_t &exact_hits,
 
 void coxmatches::copy_matches(const coxmatches &oxmatches) {
   clear();
-  std::vector<uint64_t> ids = oxmatches.get_ids();
-  for (std::vector<uint64_t>::const_iterator it = ids.begin(); it != ids.end();
-       ++it) {
-    switch (*it) {
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PORT): {
-      add_ofb_in_port() = oxmatches.get_ofb_in_port();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT): {
-      add_ofb_in_phy_port() = oxmatches.get_ofb_in_phy_port();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA): {
-      add_ofb_metadata() = oxmatches.get_ofb_metadata();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST): {
-      add_ofb_eth_dst() = oxmatches.get_ofb_eth_dst();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC): {
-      add_ofb_eth_src() = oxmatches.get_ofb_eth_src();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_TYPE): {
-      add_ofb_eth_type() = oxmatches.get_ofb_eth_type();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID): {
-      add_ofb_vlan_vid() = oxmatches.get_ofb_vlan_vid();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_PCP): {
-      add_ofb_vlan_pcp() = oxmatches.get_ofb_vlan_pcp();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_DSCP): {
-      add_ofb_ip_dscp() = oxmatches.get_ofb_ip_dscp();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN): {
-      add_ofb_ip_ecn() = oxmatches.get_ofb_ip_ecn();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_PROTO): {
-      add_ofb_ip_proto() = oxmatches.get_ofb_ip_proto();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC): {
-      add_ofb_ipv4_src() = oxmatches.get_ofb_ipv4_src();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST): {
-      add_ofb_ipv4_dst() = oxmatches.get_ofb_ipv4_dst();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_SRC): {
-      add_ofb_tcp_src() = oxmatches.get_ofb_tcp_src();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_DST): {
-      add_ofb_tcp_dst() = oxmatches.get_ofb_tcp_dst();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_SRC): {
-      add_ofb_udp_src() = oxmatches.get_ofb_udp_src();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_DST): {
-      add_ofb_udp_dst() = oxmatches.get_ofb_udp_dst();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_SRC): {
-      add_ofb_sctp_src() = oxmatches.get_ofb_sctp_src();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_DST): {
-      add_ofb_sctp_dst() = oxmatches.get_ofb_sctp_dst();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE): {
-      add_ofb_icmpv4_type() = oxmatches.get_ofb_icmpv4_type();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE): {
-      add_ofb_icmpv4_code() = oxmatches.get_ofb_icmpv4_code();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP): {
-      add_ofb_arp_opcode() = oxmatches.get_ofb_arp_opcode();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA): {
-      add_ofb_arp_spa() = oxmatches.get_ofb_arp_spa();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA): {
-      add_ofb_arp_tpa() = oxmatches.get_ofb_arp_tpa();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA): {
-      add_ofb_arp_sha() = oxmatches.get_ofb_arp_sha();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA): {
-      add_ofb_arp_tha() = oxmatches.get_ofb_arp_tha();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC): {
-      add_ofb_ipv6_src() = oxmatches.get_ofb_ipv6_src();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST): {
-      add_ofb_ipv6_dst() = oxmatches.get_ofb_ipv6_dst();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL): {
-      add_ofb_ipv6_flabel() = oxmatches.get_ofb_ipv6_flabel();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE): {
-      add_ofb_icmpv6_type() = oxmatches.get_ofb_icmpv6_type();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE): {
-      add_ofb_icmpv6_code() = oxmatches.get_ofb_icmpv6_code();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET): {
-      add_ofb_ipv6_nd_target() = oxmatches.get_ofb_ipv6_nd_target();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL): {
-      add_ofb_ipv6_nd_sll() = oxmatches.get_ofb_ipv6_nd_sll();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL): {
-      add_ofb_ipv6_nd_tll() = oxmatches.get_ofb_ipv6_nd_tll();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL): {
-      add_ofb_mpls_label() = oxmatches.get_ofb_mpls_label();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_TC): {
-      add_ofb_mpls_tc() = oxmatches.get_ofb_mpls_tc();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_BOS): {
-      add_ofb_mpls_bos() = oxmatches.get_ofb_mpls_bos();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID): {
-      add_ofb_pbb_isid() = oxmatches.get_ofb_pbb_isid();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID): {
-      add_ofb_tunnel_id() = oxmatches.get_ofb_tunnel_id();
-    } break;
-    case OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR): {
-      add_ofb_ipv6_exthdr() = oxmatches.get_ofb_ipv6_exthdr();
-    } break;
-    case OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC): {
-      add_ofx_nw_src() = oxmatches.get_ofx_nw_src();
-    } break;
-    case OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST): {
-      add_ofx_nw_dst() = oxmatches.get_ofx_nw_dst();
-    } break;
-    case OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO): {
-      add_ofx_nw_proto() = oxmatches.get_ofx_nw_proto();
-    } break;
-    case OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS): {
-      add_ofx_nw_tos() = oxmatches.get_ofx_nw_tos();
-    } break;
-    case OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC): {
-      add_ofx_tp_src() = oxmatches.get_ofx_tp_src();
-    } break;
-    case OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST): {
-      add_ofx_tp_dst() = oxmatches.get_ofx_tp_dst();
-    } break;
-    default: {
-      if (OXM_ROFL_CLASS(*it) ==
-          ((uint64_t)rofl::openflow::OFPXMC_EXPERIMENTER << 16)) {
-        uint32_t exp_id = (*it & 0xffffffff00000000) >> 32;
-        uint32_t oxm_id = (*it & 0x00000000fffffe00) >> 0;
-        add_exp_match(exp_id, oxm_id) = oxmatches.get_exp_match(exp_id, oxm_id);
-      }
-    };
+  oxmatches.sync();
+  AcquireReadLock rlock(oxmatches.rwlock);
+  AcquireReadWriteLock lock(rwlock);
+  matches = oxmatches.matches;
+  /* slots are copied bytewise, give each TLV exceeding its slot a buffer of
+   * its own */
+  for (auto &it : matches) {
+    if (it.second.ext) {
+      size_t tlvlen = it.second.length();
+      const uint8_t *ext = it.second.ext;
+      it.second.ext = new uint8_t[tlvlen];
+      memcpy(it.second.ext, ext, tlvlen);
     }
   }
 }
@@ -20,6 +20,7 @@
 
 #include <algorithm>
 
+#include "rofl/common/cflatmap.hpp"
 #include "rofl/common/cmemory.h"
 #include "rofl/common/exception.hpp"
 #include "rofl/common/locking.hpp"
@@ -41,9 +42,38 @@ class eOxmListBadLen : public eOxmListBase {};     // bad length
 class eOxmListNotFound : public eOxmListBase {};   // element not found
 class eOxmListOutOfRange : public eOxmListBase {}; // out of range
 
+/**
+ * @brief	OXM TLV in wire format as stored by coxmatches
+ *
+ * TLVs up to the size of the largest fixed-size field, a masked IPv6
+ * address, are kept inline. Longer experimenter TLVs live in a heap buffer
+ * owned by the coxmatches instance holding the slot.
+ */
+struct coxmatch_slot {
+  // TLV exceeding buf, nullptr otherwise
+  uint8_t *ext;
+  // TLV including its header in network byte order
+  uint8_t buf[sizeof(struct ofp_oxm_hdr) + 2 * 16];
+
+  const uint8_t *tlv() const { return (ext ? ext : buf); };
+
+  uint8_t *tlv() { return (ext ? ext : buf); };
+
+  uint32_t get_oxm_id() const {
+    return be32toh(((const struct ofp_oxm_tlv_hdr *)tlv())->oxm_id);
+  };
+
+  size_t length() const {
+    return sizeof(struct ofp_oxm_hdr) + (get_oxm_id() & 0xff);
+  };
+};
+
 /** this class contains a list of Openflow eXtensible Matches (OXM)
  * it does not contain a full struct ofp_match, see class cofmatch for this
  *
+ * TLVs are stored in wire format. The typed accessors decode a field on
+ * first access and keep it until the field is dropped, references returned
+ * by them stay valid until then.
  */
 class coxmatches {
 public:
@@ -79,10 +109,20 @@ public:
   virtual size_t length() const;
 
   /**
+   * @brief	Decodes an OXM TLV list in one pass via a per-field descriptor
+   * table, rejects bad lengths and masks on non-maskable fields
    *
+   * TLVs are copied into their slots as they are, no per-field objects
+   * are created.
    */
   virtual void unpack(uint8_t *buf, size_t buflen);
 
+  /**
+   * @brief	Runs the checks of unpack() on an OXM TLV list without decoding
+   * it, throws the same exceptions unpack() would
+   */
+  static void validate(const uint8_t *buf, size_t buflen);
+
   /**
    *
    */
@@ -95,14 +135,26 @@ public:
   void copy_matches(const coxmatches &oxmatches);
 
   /**
+   * @brief	Returns the TLV slots indexed by OXM type
    *
+   * Slots hold TLVs in wire format, see coxmatch_slot. Use the typed
+   * accessors below for field values. Invalidates references returned by
+   * the typed accessors.
    */
-  std::map<uint64_t, coxmatch *> &set_matches() { return matches; }
+  rofl::cflatmap<uint64_t, coxmatch_slot> &set_matches() {
+    sync();
+    AcquireReadWriteLock lock(rwlock);
+    flush();
+    return matches;
+  }
 
   /**
-   *
+   * @brief	Returns the TLV slots indexed by OXM type
    */
-  const std::map<uint64_t, coxmatch *> &get_matches() const { return matches; }
+  const rofl::cflatmap<uint64_t, coxmatch_slot> &get_matches() const {
+    sync();
+    return matches;
+  }
 
   /**
    *
@@ -119,9 +171,9 @@ public:
   std::vector<uint64_t> get_ids() const {
     std::vector<uint64_t> ids;
     AcquireReadLock lock(rwlock);
-    for (std::map<uint64_t, coxmatch *>::const_iterator it = matches.begin();
-         it != matches.end(); ++it) {
-      ids.push_back(it->first);
+    ids.reserve(matches.size());
+    for (auto &it : matches) {
+      ids.push_back(it.first);
     }
     return ids;
   };
@@ -131,9 +183,9 @@ public:
    */
   void clear() {
     AcquireReadWriteLock lock(rwlock);
-    for (std::map<uint64_t, coxmatch *>::iterator it = matches.begin();
-         it != matches.end(); ++it) {
-      delete it->second;
+    flush();
+    for (auto &it : matches) {
+      delete[] it.second.ext;
     }
     matches.clear();
   };
@@ -143,65 +195,39 @@ public:
    *
    */
   coxmatch_ofb_in_port &add_ofb_in_port(uint32_t in_port = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IN_PORT)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PORT)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PORT)] =
-        new coxmatch_ofb_in_port(in_port);
-    return dynamic_cast<coxmatch_ofb_in_port &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PORT)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PORT),
+                   coxmatch_ofb_in_port(in_port));
   };
 
   /**
    *
    */
   coxmatch_ofb_in_port &set_ofb_in_port() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IN_PORT)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PORT)] =
-          new coxmatch_ofb_in_port();
-    }
-    return dynamic_cast<coxmatch_ofb_in_port &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PORT)]);
+    return set_oxm<coxmatch_ofb_in_port>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PORT));
   };
 
   /**
    *
    */
   const coxmatch_ofb_in_port &get_ofb_in_port() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IN_PORT)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_in_port() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_in_port &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PORT)));
+    return get_oxm<coxmatch_ofb_in_port>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PORT),
+        "coxmatches::get_ofb_in_port() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_in_port() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IN_PORT)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PORT)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PORT));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PORT));
   };
 
   /**
    *
    */
   bool has_ofb_in_port() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_IN_PORT)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PORT));
   };
 
 public:
@@ -209,68 +235,41 @@ public:
    *
    */
   coxmatch_ofb_in_phy_port &add_ofb_in_phy_port(uint32_t in_phy_port = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(
-          rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT)] =
-        new coxmatch_ofb_in_phy_port(in_phy_port);
-    return dynamic_cast<coxmatch_ofb_in_phy_port &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT),
+                   coxmatch_ofb_in_phy_port(in_phy_port));
   };
 
   /**
    *
    */
   coxmatch_ofb_in_phy_port &set_ofb_in_phy_port() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT)] =
-          new coxmatch_ofb_in_phy_port();
-    }
-    return dynamic_cast<coxmatch_ofb_in_phy_port &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT)]);
+    return set_oxm<coxmatch_ofb_in_phy_port>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT));
   };
 
   /**
    *
    */
   const coxmatch_ofb_in_phy_port &get_ofb_in_phy_port() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_in_phy_port() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_in_phy_port &>(*matches.at(
-        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT)));
+    return get_oxm<coxmatch_ofb_in_phy_port>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT),
+        "coxmatches::get_ofb_in_phy_port() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_in_phy_port() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(
-        rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT));
-    return true;
+    return drop_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT));
   };
 
   /**
    *
    */
   bool has_ofb_in_phy_port() const {
-    AcquireReadLock lock(rwlock);
-    return (
-        not(matches.find(OXM_ROFL_OFB_TYPE(
-                rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT)) == matches.end()));
+    return has_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT));
   };
 
 public:
@@ -278,80 +277,47 @@ public:
    *
    */
   coxmatch_ofb_metadata &add_ofb_metadata(uint64_t metadata = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_METADATA)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA)] =
-        new coxmatch_ofb_metadata(metadata);
-    return dynamic_cast<coxmatch_ofb_metadata &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA),
+                   coxmatch_ofb_metadata(metadata));
   };
 
   /**
    *
    */
   coxmatch_ofb_metadata &add_ofb_metadata(uint64_t metadata, uint64_t mask) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_METADATA)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA)] =
-        new coxmatch_ofb_metadata(metadata, mask);
-    return dynamic_cast<coxmatch_ofb_metadata &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA),
+                   coxmatch_ofb_metadata(metadata, mask));
   };
 
   /**
    *
    */
   coxmatch_ofb_metadata &set_ofb_metadata() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_METADATA)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA)] =
-          new coxmatch_ofb_metadata();
-    }
-    return dynamic_cast<coxmatch_ofb_metadata &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA)]);
+    return set_oxm<coxmatch_ofb_metadata>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA));
   };
 
   /**
    *
    */
   const coxmatch_ofb_metadata &get_ofb_metadata() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_METADATA)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_metadata() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_metadata &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA)));
+    return get_oxm<coxmatch_ofb_metadata>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA),
+        "coxmatches::get_ofb_metadata() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_metadata() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_METADATA)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA));
   };
 
   /**
    *
    */
   bool has_ofb_metadata() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_METADATA)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_METADATA));
   };
 
 public:
@@ -360,81 +326,48 @@ public:
    */
   coxmatch_ofb_eth_dst &
   add_ofb_eth_dst(const rofl::caddress_ll &eth_dst = rofl::caddress_ll()) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ETH_DST)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST)] =
-        new coxmatch_ofb_eth_dst(eth_dst);
-    return dynamic_cast<coxmatch_ofb_eth_dst &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST),
+                   coxmatch_ofb_eth_dst(eth_dst));
   };
 
   /**
    *
    */
-  coxmatch_ofb_eth_dst &add_ofb_eth_dst(const rofl::caddress_ll &eth_dst,
-                                        const rofl::caddress_ll &mask) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ETH_DST)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST)] =
-        new coxmatch_ofb_eth_dst(eth_dst, mask);
-    return dynamic_cast<coxmatch_ofb_eth_dst &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST)]);
+  coxmatch_ofb_eth_dst &add_ofb_eth_dst(
+      const rofl::caddress_ll &eth_dst, const rofl::caddress_ll &mask) {
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST),
+                   coxmatch_ofb_eth_dst(eth_dst, mask));
   };
 
   /**
    *
    */
   coxmatch_ofb_eth_dst &set_ofb_eth_dst() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ETH_DST)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST)] =
-          new coxmatch_ofb_eth_dst();
-    }
-    return dynamic_cast<coxmatch_ofb_eth_dst &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST)]);
+    return set_oxm<coxmatch_ofb_eth_dst>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST));
   };
 
   /**
    *
    */
   const coxmatch_ofb_eth_dst &get_ofb_eth_dst() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ETH_DST)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_eth_dst() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_eth_dst &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST)));
+    return get_oxm<coxmatch_ofb_eth_dst>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST),
+        "coxmatches::get_ofb_eth_dst() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_eth_dst() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ETH_DST)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST));
   };
 
   /**
    *
    */
   bool has_ofb_eth_dst() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_ETH_DST)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_DST));
   };
 
 public:
@@ -443,81 +376,48 @@ public:
    */
   coxmatch_ofb_eth_src &
   add_ofb_eth_src(const rofl::caddress_ll &eth_src = rofl::caddress_ll()) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ETH_SRC)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC)] =
-        new coxmatch_ofb_eth_src(eth_src);
-    return dynamic_cast<coxmatch_ofb_eth_src &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC),
+                   coxmatch_ofb_eth_src(eth_src));
   };
 
   /**
    *
    */
-  coxmatch_ofb_eth_src &add_ofb_eth_src(const rofl::caddress_ll &eth_src,
-                                        const rofl::caddress_ll &mask) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ETH_SRC)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC)] =
-        new coxmatch_ofb_eth_src(eth_src, mask);
-    return dynamic_cast<coxmatch_ofb_eth_src &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC)]);
+  coxmatch_ofb_eth_src &add_ofb_eth_src(
+      const rofl::caddress_ll &eth_src, const rofl::caddress_ll &mask) {
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC),
+                   coxmatch_ofb_eth_src(eth_src, mask));
   };
 
   /**
    *
    */
   coxmatch_ofb_eth_src &set_ofb_eth_src() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ETH_SRC)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC)] =
-          new coxmatch_ofb_eth_src();
-    }
-    return dynamic_cast<coxmatch_ofb_eth_src &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC)]);
+    return set_oxm<coxmatch_ofb_eth_src>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC));
   };
 
   /**
    *
    */
   const coxmatch_ofb_eth_src &get_ofb_eth_src() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ETH_SRC)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_eth_src() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_eth_src &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC)));
+    return get_oxm<coxmatch_ofb_eth_src>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC),
+        "coxmatches::get_ofb_eth_src() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_eth_src() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ETH_SRC)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC));
   };
 
   /**
    *
    */
   bool has_ofb_eth_src() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_ETH_SRC)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_SRC));
   };
 
 public:
@@ -525,65 +425,39 @@ public:
    *
    */
   coxmatch_ofb_eth_type &add_ofb_eth_type(uint16_t eth_type = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ETH_TYPE)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_TYPE)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_TYPE)] =
-        new coxmatch_ofb_eth_type(eth_type);
-    return dynamic_cast<coxmatch_ofb_eth_type &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_TYPE)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_TYPE),
+                   coxmatch_ofb_eth_type(eth_type));
   };
 
   /**
    *
    */
   coxmatch_ofb_eth_type &set_ofb_eth_type() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ETH_TYPE)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_TYPE)] =
-          new coxmatch_ofb_eth_type();
-    }
-    return dynamic_cast<coxmatch_ofb_eth_type &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_TYPE)]);
+    return set_oxm<coxmatch_ofb_eth_type>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_TYPE));
   };
 
   /**
    *
    */
   const coxmatch_ofb_eth_type &get_ofb_eth_type() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ETH_TYPE)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_eth_type() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_eth_type &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_TYPE)));
+    return get_oxm<coxmatch_ofb_eth_type>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_TYPE),
+        "coxmatches::get_ofb_eth_type() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_eth_type() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ETH_TYPE)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_TYPE)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_TYPE));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_TYPE));
   };
 
   /**
    *
    */
   bool has_ofb_eth_type() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_ETH_TYPE)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ETH_TYPE));
   };
 
 public:
@@ -591,80 +465,47 @@ public:
    *
    */
   coxmatch_ofb_vlan_vid &add_ofb_vlan_vid(uint16_t vlan_vid = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_VLAN_VID)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID)] =
-        new coxmatch_ofb_vlan_vid(vlan_vid);
-    return dynamic_cast<coxmatch_ofb_vlan_vid &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID),
+                   coxmatch_ofb_vlan_vid(vlan_vid));
   };
 
   /**
    *
    */
   coxmatch_ofb_vlan_vid &add_ofb_vlan_vid(uint16_t vlan_vid, uint16_t mask) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_VLAN_VID)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID)] =
-        new coxmatch_ofb_vlan_vid(vlan_vid, mask);
-    return dynamic_cast<coxmatch_ofb_vlan_vid &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID),
+                   coxmatch_ofb_vlan_vid(vlan_vid, mask));
   };
 
   /**
    *
    */
   coxmatch_ofb_vlan_vid &set_ofb_vlan_vid() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_VLAN_VID)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID)] =
-          new coxmatch_ofb_vlan_vid();
-    }
-    return dynamic_cast<coxmatch_ofb_vlan_vid &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID)]);
+    return set_oxm<coxmatch_ofb_vlan_vid>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID));
   };
 
   /**
    *
    */
   const coxmatch_ofb_vlan_vid &get_ofb_vlan_vid() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_VLAN_VID)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_vlan_vid() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_vlan_vid &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID)));
+    return get_oxm<coxmatch_ofb_vlan_vid>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID),
+        "coxmatches::get_ofb_vlan_vid() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_vlan_vid() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_VLAN_VID)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID));
   };
 
   /**
    *
    */
   bool has_ofb_vlan_vid() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_VLAN_VID)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_VID));
   };
 
 public:
@@ -672,65 +513,39 @@ public:
    *
    */
   coxmatch_ofb_vlan_pcp &add_ofb_vlan_pcp(uint8_t vlan_pcp = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_VLAN_PCP)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_PCP)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_PCP)] =
-        new coxmatch_ofb_vlan_pcp(vlan_pcp);
-    return dynamic_cast<coxmatch_ofb_vlan_pcp &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_PCP)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_PCP),
+                   coxmatch_ofb_vlan_pcp(vlan_pcp));
   };
 
   /**
    *
    */
   coxmatch_ofb_vlan_pcp &set_ofb_vlan_pcp() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_VLAN_PCP)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_PCP)] =
-          new coxmatch_ofb_vlan_pcp();
-    }
-    return dynamic_cast<coxmatch_ofb_vlan_pcp &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_PCP)]);
+    return set_oxm<coxmatch_ofb_vlan_pcp>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_PCP));
   };
 
   /**
    *
    */
   const coxmatch_ofb_vlan_pcp &get_ofb_vlan_pcp() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_VLAN_PCP)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_vlan_pcp() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_vlan_pcp &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_PCP)));
+    return get_oxm<coxmatch_ofb_vlan_pcp>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_PCP),
+        "coxmatches::get_ofb_vlan_pcp() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_vlan_pcp() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_VLAN_PCP)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_PCP)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_PCP));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_PCP));
   };
 
   /**
    *
    */
   bool has_ofb_vlan_pcp() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_VLAN_PCP)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_VLAN_PCP));
   };
 
 public:
@@ -738,65 +553,39 @@ public:
    *
    */
   coxmatch_ofb_ip_dscp &add_ofb_ip_dscp(uint8_t ip_dscp = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IP_DSCP)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_DSCP)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_DSCP)] =
-        new coxmatch_ofb_ip_dscp(ip_dscp);
-    return dynamic_cast<coxmatch_ofb_ip_dscp &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_DSCP)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_DSCP),
+                   coxmatch_ofb_ip_dscp(ip_dscp));
   };
 
   /**
    *
    */
   coxmatch_ofb_ip_dscp &set_ofb_ip_dscp() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IP_DSCP)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_DSCP)] =
-          new coxmatch_ofb_ip_dscp();
-    }
-    return dynamic_cast<coxmatch_ofb_ip_dscp &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_DSCP)]);
+    return set_oxm<coxmatch_ofb_ip_dscp>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_DSCP));
   };
 
   /**
    *
    */
   const coxmatch_ofb_ip_dscp &get_ofb_ip_dscp() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IP_DSCP)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_ip_dscp() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_ip_dscp &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_DSCP)));
+    return get_oxm<coxmatch_ofb_ip_dscp>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_DSCP),
+        "coxmatches::get_ofb_ip_dscp() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_ip_dscp() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IP_DSCP)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_DSCP)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_DSCP));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_DSCP));
   };
 
   /**
    *
    */
   bool has_ofb_ip_dscp() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_IP_DSCP)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_DSCP));
   };
 
 public:
@@ -804,65 +593,39 @@ public:
    *
    */
   coxmatch_ofb_ip_ecn &add_ofb_ip_ecn(uint8_t ip_ecn = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN)) !=
-        matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN)] =
-        new coxmatch_ofb_ip_ecn(ip_ecn);
-    return dynamic_cast<coxmatch_ofb_ip_ecn &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN),
+                   coxmatch_ofb_ip_ecn(ip_ecn));
   };
 
   /**
    *
    */
   coxmatch_ofb_ip_ecn &set_ofb_ip_ecn() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN)) ==
-        matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN)] =
-          new coxmatch_ofb_ip_ecn();
-    }
-    return dynamic_cast<coxmatch_ofb_ip_ecn &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN)]);
+    return set_oxm<coxmatch_ofb_ip_ecn>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN));
   };
 
   /**
    *
    */
   const coxmatch_ofb_ip_ecn &get_ofb_ip_ecn() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN)) ==
-        matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_ip_ecn() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_ip_ecn &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN)));
+    return get_oxm<coxmatch_ofb_ip_ecn>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN),
+        "coxmatches::get_ofb_ip_ecn() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_ip_ecn() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN)) ==
-        matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN));
   };
 
   /**
    *
    */
   bool has_ofb_ip_ecn() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_IP_ECN)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_ECN));
   };
 
 public:
@@ -870,65 +633,39 @@ public:
    *
    */
   coxmatch_ofb_ip_proto &add_ofb_ip_proto(uint8_t ip_proto = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IP_PROTO)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_PROTO)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_PROTO)] =
-        new coxmatch_ofb_ip_proto(ip_proto);
-    return dynamic_cast<coxmatch_ofb_ip_proto &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_PROTO)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_PROTO),
+                   coxmatch_ofb_ip_proto(ip_proto));
   };
 
   /**
    *
    */
   coxmatch_ofb_ip_proto &set_ofb_ip_proto() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IP_PROTO)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_PROTO)] =
-          new coxmatch_ofb_ip_proto();
-    }
-    return dynamic_cast<coxmatch_ofb_ip_proto &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_PROTO)]);
+    return set_oxm<coxmatch_ofb_ip_proto>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_PROTO));
   };
 
   /**
    *
    */
   const coxmatch_ofb_ip_proto &get_ofb_ip_proto() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IP_PROTO)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_ip_proto() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_ip_proto &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_PROTO)));
+    return get_oxm<coxmatch_ofb_ip_proto>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_PROTO),
+        "coxmatches::get_ofb_ip_proto() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_ip_proto() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IP_PROTO)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_PROTO)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_PROTO));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_PROTO));
   };
 
   /**
    *
    */
   bool has_ofb_ip_proto() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_IP_PROTO)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IP_PROTO));
   };
 
 public:
@@ -937,81 +674,48 @@ public:
    */
   coxmatch_ofb_ipv4_src &
   add_ofb_ipv4_src(const rofl::caddress_in4 &addr = rofl::caddress_in4()) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV4_SRC)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC)] =
-        new coxmatch_ofb_ipv4_src(addr);
-    return dynamic_cast<coxmatch_ofb_ipv4_src &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC),
+                   coxmatch_ofb_ipv4_src(addr));
   };
 
   /**
    *
    */
-  coxmatch_ofb_ipv4_src &add_ofb_ipv4_src(const rofl::caddress_in4 &addr,
-                                          const rofl::caddress_in4 &mask) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV4_SRC)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC)] =
-        new coxmatch_ofb_ipv4_src(addr, mask);
-    return dynamic_cast<coxmatch_ofb_ipv4_src &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC)]);
+  coxmatch_ofb_ipv4_src &add_ofb_ipv4_src(
+      const rofl::caddress_in4 &addr, const rofl::caddress_in4 &mask) {
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC),
+                   coxmatch_ofb_ipv4_src(addr, mask));
   };
 
   /**
    *
    */
   coxmatch_ofb_ipv4_src &set_ofb_ipv4_src() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV4_SRC)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC)] =
-          new coxmatch_ofb_ipv4_src();
-    }
-    return dynamic_cast<coxmatch_ofb_ipv4_src &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC)]);
+    return set_oxm<coxmatch_ofb_ipv4_src>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC));
   };
 
   /**
    *
    */
   const coxmatch_ofb_ipv4_src &get_ofb_ipv4_src() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV4_SRC)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_ipv4_src() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_ipv4_src &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC)));
+    return get_oxm<coxmatch_ofb_ipv4_src>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC),
+        "coxmatches::get_ofb_ipv4_src() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_ipv4_src() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV4_SRC)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC));
   };
 
   /**
    *
    */
   bool has_ofb_ipv4_src() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_IPV4_SRC)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_SRC));
   };
 
 public:
@@ -1020,81 +724,48 @@ public:
    */
   coxmatch_ofb_ipv4_dst &
   add_ofb_ipv4_dst(const rofl::caddress_in4 &addr = rofl::caddress_in4()) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV4_DST)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST)] =
-        new coxmatch_ofb_ipv4_dst(addr);
-    return dynamic_cast<coxmatch_ofb_ipv4_dst &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST),
+                   coxmatch_ofb_ipv4_dst(addr));
   };
 
   /**
    *
    */
-  coxmatch_ofb_ipv4_dst &add_ofb_ipv4_dst(const rofl::caddress_in4 &addr,
-                                          const rofl::caddress_in4 &mask) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV4_DST)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST)] =
-        new coxmatch_ofb_ipv4_dst(addr, mask);
-    return dynamic_cast<coxmatch_ofb_ipv4_dst &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST)]);
+  coxmatch_ofb_ipv4_dst &add_ofb_ipv4_dst(
+      const rofl::caddress_in4 &addr, const rofl::caddress_in4 &mask) {
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST),
+                   coxmatch_ofb_ipv4_dst(addr, mask));
   };
 
   /**
    *
    */
   coxmatch_ofb_ipv4_dst &set_ofb_ipv4_dst() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV4_DST)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST)] =
-          new coxmatch_ofb_ipv4_dst();
-    }
-    return dynamic_cast<coxmatch_ofb_ipv4_dst &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST)]);
+    return set_oxm<coxmatch_ofb_ipv4_dst>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST));
   };
 
   /**
    *
    */
   const coxmatch_ofb_ipv4_dst &get_ofb_ipv4_dst() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV4_DST)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_ipv4_dst() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_ipv4_dst &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST)));
+    return get_oxm<coxmatch_ofb_ipv4_dst>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST),
+        "coxmatches::get_ofb_ipv4_dst() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_ipv4_dst() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV4_DST)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST));
   };
 
   /**
    *
    */
   bool has_ofb_ipv4_dst() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_IPV4_DST)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV4_DST));
   };
 
 public:
@@ -1103,81 +774,48 @@ public:
    */
   coxmatch_ofb_ipv6_src &
   add_ofb_ipv6_src(const rofl::caddress_in6 &addr = rofl::caddress_in6()) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_SRC)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC)] =
-        new coxmatch_ofb_ipv6_src(addr);
-    return dynamic_cast<coxmatch_ofb_ipv6_src &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC),
+                   coxmatch_ofb_ipv6_src(addr));
   };
 
   /**
    *
    */
-  coxmatch_ofb_ipv6_src &add_ofb_ipv6_src(const rofl::caddress_in6 &addr,
-                                          const rofl::caddress_in6 &mask) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_SRC)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC)] =
-        new coxmatch_ofb_ipv6_src(addr, mask);
-    return dynamic_cast<coxmatch_ofb_ipv6_src &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC)]);
+  coxmatch_ofb_ipv6_src &add_ofb_ipv6_src(
+      const rofl::caddress_in6 &addr, const rofl::caddress_in6 &mask) {
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC),
+                   coxmatch_ofb_ipv6_src(addr, mask));
   };
 
   /**
    *
    */
   coxmatch_ofb_ipv6_src &set_ofb_ipv6_src() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_SRC)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC)] =
-          new coxmatch_ofb_ipv6_src();
-    }
-    return dynamic_cast<coxmatch_ofb_ipv6_src &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC)]);
+    return set_oxm<coxmatch_ofb_ipv6_src>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC));
   };
 
   /**
    *
    */
   const coxmatch_ofb_ipv6_src &get_ofb_ipv6_src() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_SRC)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_ipv6_src() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_ipv6_src &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC)));
+    return get_oxm<coxmatch_ofb_ipv6_src>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC),
+        "coxmatches::get_ofb_ipv6_src() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_ipv6_src() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_SRC)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC));
   };
 
   /**
    *
    */
   bool has_ofb_ipv6_src() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_IPV6_SRC)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_SRC));
   };
 
 public:
@@ -1186,81 +824,48 @@ public:
    */
   coxmatch_ofb_ipv6_dst &
   add_ofb_ipv6_dst(const rofl::caddress_in6 &addr = rofl::caddress_in6()) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_DST)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST)] =
-        new coxmatch_ofb_ipv6_dst(addr);
-    return dynamic_cast<coxmatch_ofb_ipv6_dst &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST),
+                   coxmatch_ofb_ipv6_dst(addr));
   };
 
   /**
    *
    */
-  coxmatch_ofb_ipv6_dst &add_ofb_ipv6_dst(const rofl::caddress_in6 &addr,
-                                          const rofl::caddress_in6 &mask) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_DST)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST)] =
-        new coxmatch_ofb_ipv6_dst(addr, mask);
-    return dynamic_cast<coxmatch_ofb_ipv6_dst &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST)]);
+  coxmatch_ofb_ipv6_dst &add_ofb_ipv6_dst(
+      const rofl::caddress_in6 &addr, const rofl::caddress_in6 &mask) {
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST),
+                   coxmatch_ofb_ipv6_dst(addr, mask));
   };
 
   /**
    *
    */
   coxmatch_ofb_ipv6_dst &set_ofb_ipv6_dst() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_DST)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST)] =
-          new coxmatch_ofb_ipv6_dst();
-    }
-    return dynamic_cast<coxmatch_ofb_ipv6_dst &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST)]);
+    return set_oxm<coxmatch_ofb_ipv6_dst>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST));
   };
 
   /**
    *
    */
   const coxmatch_ofb_ipv6_dst &get_ofb_ipv6_dst() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_DST)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_ipv6_dst() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_ipv6_dst &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST)));
+    return get_oxm<coxmatch_ofb_ipv6_dst>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST),
+        "coxmatches::get_ofb_ipv6_dst() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_ipv6_dst() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_DST)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST));
   };
 
   /**
    *
    */
   bool has_ofb_ipv6_dst() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_IPV6_DST)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_DST));
   };
 
 public:
@@ -1268,65 +873,39 @@ public:
    *
    */
   coxmatch_ofb_tcp_src &add_ofb_tcp_src(uint16_t tcp_src = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_TCP_SRC)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_SRC)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_SRC)] =
-        new coxmatch_ofb_tcp_src(tcp_src);
-    return dynamic_cast<coxmatch_ofb_tcp_src &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_SRC)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_SRC),
+                   coxmatch_ofb_tcp_src(tcp_src));
   };
 
   /**
    *
    */
   coxmatch_ofb_tcp_src &set_ofb_tcp_src() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_TCP_SRC)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_SRC)] =
-          new coxmatch_ofb_tcp_src();
-    }
-    return dynamic_cast<coxmatch_ofb_tcp_src &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_SRC)]);
+    return set_oxm<coxmatch_ofb_tcp_src>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_SRC));
   };
 
   /**
    *
    */
   const coxmatch_ofb_tcp_src &get_ofb_tcp_src() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_TCP_SRC)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_tcp_src() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_tcp_src &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_SRC)));
+    return get_oxm<coxmatch_ofb_tcp_src>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_SRC),
+        "coxmatches::get_ofb_tcp_src() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_tcp_src() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_TCP_SRC)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_SRC)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_SRC));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_SRC));
   };
 
   /**
    *
    */
   bool has_ofb_tcp_src() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_TCP_SRC)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_SRC));
   };
 
 public:
@@ -1334,65 +913,39 @@ public:
    *
    */
   coxmatch_ofb_tcp_dst &add_ofb_tcp_dst(uint16_t tcp_dst = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_TCP_DST)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_DST)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_DST)] =
-        new coxmatch_ofb_tcp_dst(tcp_dst);
-    return dynamic_cast<coxmatch_ofb_tcp_dst &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_DST)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_DST),
+                   coxmatch_ofb_tcp_dst(tcp_dst));
   };
 
   /**
    *
    */
   coxmatch_ofb_tcp_dst &set_ofb_tcp_dst() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_TCP_DST)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_DST)] =
-          new coxmatch_ofb_tcp_dst();
-    }
-    return dynamic_cast<coxmatch_ofb_tcp_dst &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_DST)]);
+    return set_oxm<coxmatch_ofb_tcp_dst>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_DST));
   };
 
   /**
    *
    */
   const coxmatch_ofb_tcp_dst &get_ofb_tcp_dst() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_TCP_DST)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_tcp_dst() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_tcp_dst &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_DST)));
+    return get_oxm<coxmatch_ofb_tcp_dst>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_DST),
+        "coxmatches::get_ofb_tcp_dst() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_tcp_dst() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_TCP_DST)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_DST)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_DST));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_DST));
   };
 
   /**
    *
    */
   bool has_ofb_tcp_dst() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_TCP_DST)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TCP_DST));
   };
 
 public:
@@ -1400,65 +953,39 @@ public:
    *
    */
   coxmatch_ofb_udp_src &add_ofb_udp_src(uint16_t udp_src = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_UDP_SRC)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_SRC)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_SRC)] =
-        new coxmatch_ofb_udp_src(udp_src);
-    return dynamic_cast<coxmatch_ofb_udp_src &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_SRC)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_SRC),
+                   coxmatch_ofb_udp_src(udp_src));
   };
 
   /**
    *
    */
   coxmatch_ofb_udp_src &set_ofb_udp_src() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_UDP_SRC)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_SRC)] =
-          new coxmatch_ofb_udp_src();
-    }
-    return dynamic_cast<coxmatch_ofb_udp_src &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_SRC)]);
+    return set_oxm<coxmatch_ofb_udp_src>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_SRC));
   };
 
   /**
    *
    */
   const coxmatch_ofb_udp_src &get_ofb_udp_src() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_UDP_SRC)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_udp_src() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_udp_src &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_SRC)));
+    return get_oxm<coxmatch_ofb_udp_src>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_SRC),
+        "coxmatches::get_ofb_udp_src() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_udp_src() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_UDP_SRC)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_SRC)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_SRC));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_SRC));
   };
 
   /**
    *
    */
   bool has_ofb_udp_src() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_UDP_SRC)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_SRC));
   };
 
 public:
@@ -1466,65 +993,39 @@ public:
    *
    */
   coxmatch_ofb_udp_dst &add_ofb_udp_dst(uint16_t udp_dst = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_UDP_DST)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_DST)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_DST)] =
-        new coxmatch_ofb_udp_dst(udp_dst);
-    return dynamic_cast<coxmatch_ofb_udp_dst &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_DST)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_DST),
+                   coxmatch_ofb_udp_dst(udp_dst));
   };
 
   /**
    *
    */
   coxmatch_ofb_udp_dst &set_ofb_udp_dst() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_UDP_DST)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_DST)] =
-          new coxmatch_ofb_udp_dst();
-    }
-    return dynamic_cast<coxmatch_ofb_udp_dst &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_DST)]);
+    return set_oxm<coxmatch_ofb_udp_dst>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_DST));
   };
 
   /**
    *
    */
   const coxmatch_ofb_udp_dst &get_ofb_udp_dst() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_UDP_DST)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_udp_dst() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_udp_dst &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_DST)));
+    return get_oxm<coxmatch_ofb_udp_dst>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_DST),
+        "coxmatches::get_ofb_udp_dst() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_udp_dst() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_UDP_DST)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_DST)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_DST));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_DST));
   };
 
   /**
    *
    */
   bool has_ofb_udp_dst() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_UDP_DST)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_UDP_DST));
   };
 
 public:
@@ -1532,65 +1033,39 @@ public:
    *
    */
   coxmatch_ofb_sctp_src &add_ofb_sctp_src(uint16_t sctp_src = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_SCTP_SRC)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_SRC)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_SRC)] =
-        new coxmatch_ofb_sctp_src(sctp_src);
-    return dynamic_cast<coxmatch_ofb_sctp_src &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_SRC)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_SRC),
+                   coxmatch_ofb_sctp_src(sctp_src));
   };
 
   /**
    *
    */
   coxmatch_ofb_sctp_src &set_ofb_sctp_src() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_SCTP_SRC)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_SRC)] =
-          new coxmatch_ofb_sctp_src();
-    }
-    return dynamic_cast<coxmatch_ofb_sctp_src &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_SRC)]);
+    return set_oxm<coxmatch_ofb_sctp_src>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_SRC));
   };
 
   /**
    *
    */
   const coxmatch_ofb_sctp_src &get_ofb_sctp_src() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_SCTP_SRC)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_sctp_src() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_sctp_src &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_SRC)));
+    return get_oxm<coxmatch_ofb_sctp_src>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_SRC),
+        "coxmatches::get_ofb_sctp_src() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_sctp_src() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_SCTP_SRC)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_SRC)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_SRC));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_SRC));
   };
 
   /**
    *
    */
   bool has_ofb_sctp_src() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_SCTP_SRC)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_SRC));
   };
 
 public:
@@ -1598,65 +1073,39 @@ public:
    *
    */
   coxmatch_ofb_sctp_dst &add_ofb_sctp_dst(uint16_t sctp_dst = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_SCTP_DST)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_DST)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_DST)] =
-        new coxmatch_ofb_sctp_dst(sctp_dst);
-    return dynamic_cast<coxmatch_ofb_sctp_dst &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_DST)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_DST),
+                   coxmatch_ofb_sctp_dst(sctp_dst));
   };
 
   /**
    *
    */
   coxmatch_ofb_sctp_dst &set_ofb_sctp_dst() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_SCTP_DST)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_DST)] =
-          new coxmatch_ofb_sctp_dst();
-    }
-    return dynamic_cast<coxmatch_ofb_sctp_dst &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_DST)]);
+    return set_oxm<coxmatch_ofb_sctp_dst>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_DST));
   };
 
   /**
    *
    */
   const coxmatch_ofb_sctp_dst &get_ofb_sctp_dst() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_SCTP_DST)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_sctp_dst() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_sctp_dst &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_DST)));
+    return get_oxm<coxmatch_ofb_sctp_dst>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_DST),
+        "coxmatches::get_ofb_sctp_dst() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_sctp_dst() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_SCTP_DST)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_DST)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_DST));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_DST));
   };
 
   /**
    *
    */
   bool has_ofb_sctp_dst() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_SCTP_DST)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_SCTP_DST));
   };
 
 public:
@@ -1664,68 +1113,41 @@ public:
    *
    */
   coxmatch_ofb_icmpv4_type &add_ofb_icmpv4_type(uint8_t icmpv4_type = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(
-          rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE)] =
-        new coxmatch_ofb_icmpv4_type(icmpv4_type);
-    return dynamic_cast<coxmatch_ofb_icmpv4_type &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE),
+                   coxmatch_ofb_icmpv4_type(icmpv4_type));
   };
 
   /**
    *
    */
   coxmatch_ofb_icmpv4_type &set_ofb_icmpv4_type() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE)] =
-          new coxmatch_ofb_icmpv4_type();
-    }
-    return dynamic_cast<coxmatch_ofb_icmpv4_type &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE)]);
+    return set_oxm<coxmatch_ofb_icmpv4_type>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE));
   };
 
   /**
    *
    */
   const coxmatch_ofb_icmpv4_type &get_ofb_icmpv4_type() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_icmpv4_type() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_icmpv4_type &>(*matches.at(
-        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE)));
+    return get_oxm<coxmatch_ofb_icmpv4_type>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE),
+        "coxmatches::get_ofb_icmpv4_type() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_icmpv4_type() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(
-        rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE));
-    return true;
+    return drop_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE));
   };
 
   /**
    *
    */
   bool has_ofb_icmpv4_type() const {
-    AcquireReadLock lock(rwlock);
-    return (
-        not(matches.find(OXM_ROFL_OFB_TYPE(
-                rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE)) == matches.end()));
+    return has_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE));
   };
 
 public:
@@ -1733,68 +1155,41 @@ public:
    *
    */
   coxmatch_ofb_icmpv4_code &add_ofb_icmpv4_code(uint8_t icmpv4_code = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(
-          rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE)] =
-        new coxmatch_ofb_icmpv4_code(icmpv4_code);
-    return dynamic_cast<coxmatch_ofb_icmpv4_code &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE),
+                   coxmatch_ofb_icmpv4_code(icmpv4_code));
   };
 
   /**
    *
    */
   coxmatch_ofb_icmpv4_code &set_ofb_icmpv4_code() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE)] =
-          new coxmatch_ofb_icmpv4_code();
-    }
-    return dynamic_cast<coxmatch_ofb_icmpv4_code &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE)]);
+    return set_oxm<coxmatch_ofb_icmpv4_code>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE));
   };
 
   /**
    *
    */
   const coxmatch_ofb_icmpv4_code &get_ofb_icmpv4_code() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_icmpv4_code() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_icmpv4_code &>(*matches.at(
-        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE)));
+    return get_oxm<coxmatch_ofb_icmpv4_code>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE),
+        "coxmatches::get_ofb_icmpv4_code() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_icmpv4_code() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(
-        rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE));
-    return true;
+    return drop_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE));
   };
 
   /**
    *
    */
   bool has_ofb_icmpv4_code() const {
-    AcquireReadLock lock(rwlock);
-    return (
-        not(matches.find(OXM_ROFL_OFB_TYPE(
-                rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE)) == matches.end()));
+    return has_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE));
   };
 
 public:
@@ -1802,65 +1197,39 @@ public:
    *
    */
   coxmatch_ofb_arp_opcode &add_ofb_arp_opcode(uint16_t arp_opcode = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP)) !=
-        matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP)] =
-        new coxmatch_ofb_arp_opcode(arp_opcode);
-    return dynamic_cast<coxmatch_ofb_arp_opcode &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP),
+                   coxmatch_ofb_arp_opcode(arp_opcode));
   };
 
   /**
    *
    */
   coxmatch_ofb_arp_opcode &set_ofb_arp_opcode() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP)) ==
-        matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP)] =
-          new coxmatch_ofb_arp_opcode();
-    }
-    return dynamic_cast<coxmatch_ofb_arp_opcode &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP)]);
+    return set_oxm<coxmatch_ofb_arp_opcode>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP));
   };
 
   /**
    *
    */
   const coxmatch_ofb_arp_opcode &get_ofb_arp_opcode() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP)) ==
-        matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_arp_opcode() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_arp_opcode &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP)));
+    return get_oxm<coxmatch_ofb_arp_opcode>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP),
+        "coxmatches::get_ofb_arp_opcode() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_arp_opcode() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP)) ==
-        matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP));
   };
 
   /**
    *
    */
   bool has_ofb_arp_opcode() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_ARP_OP)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_OP));
   };
 
 public:
@@ -1868,80 +1237,47 @@ public:
    *
    */
   coxmatch_ofb_arp_spa &add_ofb_arp_spa(uint32_t arp_spa = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_SPA)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA)] =
-        new coxmatch_ofb_arp_spa(arp_spa);
-    return dynamic_cast<coxmatch_ofb_arp_spa &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA),
+                   coxmatch_ofb_arp_spa(arp_spa));
   };
 
   /**
    *
    */
   coxmatch_ofb_arp_spa &add_ofb_arp_spa(uint32_t arp_spa, uint32_t mask) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_SPA)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA)] =
-        new coxmatch_ofb_arp_spa(arp_spa, mask);
-    return dynamic_cast<coxmatch_ofb_arp_spa &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA),
+                   coxmatch_ofb_arp_spa(arp_spa, mask));
   };
 
   /**
    *
    */
   coxmatch_ofb_arp_spa &set_ofb_arp_spa() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_SPA)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA)] =
-          new coxmatch_ofb_arp_spa();
-    }
-    return dynamic_cast<coxmatch_ofb_arp_spa &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA)]);
+    return set_oxm<coxmatch_ofb_arp_spa>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA));
   };
 
   /**
    *
    */
   const coxmatch_ofb_arp_spa &get_ofb_arp_spa() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_SPA)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_arp_spa() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_arp_spa &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA)));
+    return get_oxm<coxmatch_ofb_arp_spa>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA),
+        "coxmatches::get_ofb_arp_spa() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_arp_spa() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_SPA)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA));
   };
 
   /**
    *
    */
   bool has_ofb_arp_spa() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_ARP_SPA)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SPA));
   };
 
 public:
@@ -1949,80 +1285,47 @@ public:
    *
    */
   coxmatch_ofb_arp_tpa &add_ofb_arp_tpa(uint32_t arp_tpa = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_TPA)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA)] =
-        new coxmatch_ofb_arp_tpa(arp_tpa);
-    return dynamic_cast<coxmatch_ofb_arp_tpa &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA),
+                   coxmatch_ofb_arp_tpa(arp_tpa));
   };
 
   /**
    *
    */
   coxmatch_ofb_arp_tpa &add_ofb_arp_tpa(uint32_t arp_tpa, uint32_t mask) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_TPA)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA)] =
-        new coxmatch_ofb_arp_tpa(arp_tpa, mask);
-    return dynamic_cast<coxmatch_ofb_arp_tpa &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA),
+                   coxmatch_ofb_arp_tpa(arp_tpa, mask));
   };
 
   /**
    *
    */
   coxmatch_ofb_arp_tpa &set_ofb_arp_tpa() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_TPA)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA)] =
-          new coxmatch_ofb_arp_tpa();
-    }
-    return dynamic_cast<coxmatch_ofb_arp_tpa &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA)]);
+    return set_oxm<coxmatch_ofb_arp_tpa>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA));
   };
 
   /**
    *
    */
   const coxmatch_ofb_arp_tpa &get_ofb_arp_tpa() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_TPA)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_arp_tpa() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_arp_tpa &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA)));
+    return get_oxm<coxmatch_ofb_arp_tpa>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA),
+        "coxmatches::get_ofb_arp_tpa() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_arp_tpa() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_TPA)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA));
   };
 
   /**
    *
    */
   bool has_ofb_arp_tpa() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_ARP_TPA)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_TPA));
   };
 
 public:
@@ -2030,81 +1333,48 @@ public:
    *
    */
   coxmatch_ofb_arp_sha &add_ofb_arp_sha(const rofl::caddress_ll &arp_sha = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_SHA)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA)] =
-        new coxmatch_ofb_arp_sha(arp_sha);
-    return dynamic_cast<coxmatch_ofb_arp_sha &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA),
+                   coxmatch_ofb_arp_sha(arp_sha));
   };
 
   /**
    *
    */
-  coxmatch_ofb_arp_sha &add_ofb_arp_sha(const rofl::caddress_ll &arp_sha,
-                                        const rofl::caddress_ll &mask) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_SHA)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA)] =
-        new coxmatch_ofb_arp_sha(arp_sha, mask);
-    return dynamic_cast<coxmatch_ofb_arp_sha &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA)]);
+  coxmatch_ofb_arp_sha &add_ofb_arp_sha(
+      const rofl::caddress_ll &arp_sha, const rofl::caddress_ll &mask) {
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA),
+                   coxmatch_ofb_arp_sha(arp_sha, mask));
   };
 
   /**
    *
    */
   coxmatch_ofb_arp_sha &set_ofb_arp_sha() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_SHA)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA)] =
-          new coxmatch_ofb_arp_sha();
-    }
-    return dynamic_cast<coxmatch_ofb_arp_sha &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA)]);
+    return set_oxm<coxmatch_ofb_arp_sha>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA));
   };
 
   /**
    *
    */
   const coxmatch_ofb_arp_sha &get_ofb_arp_sha() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_SHA)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_arp_sha() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_arp_sha &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA)));
+    return get_oxm<coxmatch_ofb_arp_sha>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA),
+        "coxmatches::get_ofb_arp_sha() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_arp_sha() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_SHA)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA));
   };
 
   /**
    *
    */
   bool has_ofb_arp_sha() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_ARP_SHA)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_SHA));
   };
 
 public:
@@ -2112,81 +1382,48 @@ public:
    *
    */
   coxmatch_ofb_arp_tha &add_ofb_arp_tha(const rofl::caddress_ll &arp_tha = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_THA)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA)] =
-        new coxmatch_ofb_arp_tha(arp_tha);
-    return dynamic_cast<coxmatch_ofb_arp_tha &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA),
+                   coxmatch_ofb_arp_tha(arp_tha));
   };
 
   /**
    *
    */
-  coxmatch_ofb_arp_tha &add_ofb_arp_tha(const rofl::caddress_ll &arp_tha,
-                                        const rofl::caddress_ll &mask) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_THA)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA)] =
-        new coxmatch_ofb_arp_tha(arp_tha, mask);
-    return dynamic_cast<coxmatch_ofb_arp_tha &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA)]);
+  coxmatch_ofb_arp_tha &add_ofb_arp_tha(
+      const rofl::caddress_ll &arp_tha, const rofl::caddress_ll &mask) {
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA),
+                   coxmatch_ofb_arp_tha(arp_tha, mask));
   };
 
   /**
    *
    */
   coxmatch_ofb_arp_tha &set_ofb_arp_tha() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_THA)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA)] =
-          new coxmatch_ofb_arp_tha();
-    }
-    return dynamic_cast<coxmatch_ofb_arp_tha &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA)]);
+    return set_oxm<coxmatch_ofb_arp_tha>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA));
   };
 
   /**
    *
    */
   const coxmatch_ofb_arp_tha &get_ofb_arp_tha() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_THA)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_arp_tha() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_arp_tha &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA)));
+    return get_oxm<coxmatch_ofb_arp_tha>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA),
+        "coxmatches::get_ofb_arp_tha() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_arp_tha() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ARP_THA)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA));
   };
 
   /**
    *
    */
   bool has_ofb_arp_tha() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_ARP_THA)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ARP_THA));
   };
 
 public:
@@ -2194,85 +1431,50 @@ public:
    *
    */
   coxmatch_ofb_ipv6_flabel &add_ofb_ipv6_flabel(uint32_t ipv6_flabel = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(
-          rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL)] =
-        new coxmatch_ofb_ipv6_flabel(ipv6_flabel);
-    return dynamic_cast<coxmatch_ofb_ipv6_flabel &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL),
+                   coxmatch_ofb_ipv6_flabel(ipv6_flabel));
   };
 
   /**
    *
    */
-  coxmatch_ofb_ipv6_flabel &add_ofb_ipv6_flabel(uint32_t ipv6_flabel,
-                                                uint32_t mask) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(
-          rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL)] =
-        new coxmatch_ofb_ipv6_flabel(ipv6_flabel, mask);
-    return dynamic_cast<coxmatch_ofb_ipv6_flabel &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL)]);
+  coxmatch_ofb_ipv6_flabel &
+  add_ofb_ipv6_flabel(uint32_t ipv6_flabel, uint32_t mask) {
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL),
+                   coxmatch_ofb_ipv6_flabel(ipv6_flabel, mask));
   };
 
   /**
    *
    */
   coxmatch_ofb_ipv6_flabel &set_ofb_ipv6_flabel() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL)] =
-          new coxmatch_ofb_ipv6_flabel();
-    }
-    return dynamic_cast<coxmatch_ofb_ipv6_flabel &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL)]);
+    return set_oxm<coxmatch_ofb_ipv6_flabel>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL));
   };
 
   /**
    *
    */
   const coxmatch_ofb_ipv6_flabel &get_ofb_ipv6_flabel() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_ipv6_flabel() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_ipv6_flabel &>(*matches.at(
-        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL)));
+    return get_oxm<coxmatch_ofb_ipv6_flabel>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL),
+        "coxmatches::get_ofb_ipv6_flabel() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_ipv6_flabel() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(
-        rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL));
-    return true;
+    return drop_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL));
   };
 
   /**
    *
    */
   bool has_ofb_ipv6_flabel() const {
-    AcquireReadLock lock(rwlock);
-    return (
-        not(matches.find(OXM_ROFL_OFB_TYPE(
-                rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL)) == matches.end()));
+    return has_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL));
   };
 
 public:
@@ -2280,68 +1482,41 @@ public:
    *
    */
   coxmatch_ofb_icmpv6_type &add_ofb_icmpv6_type(uint8_t icmpv6_type = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(
-          rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE)] =
-        new coxmatch_ofb_icmpv6_type(icmpv6_type);
-    return dynamic_cast<coxmatch_ofb_icmpv6_type &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE),
+                   coxmatch_ofb_icmpv6_type(icmpv6_type));
   };
 
   /**
    *
    */
   coxmatch_ofb_icmpv6_type &set_ofb_icmpv6_type() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE)] =
-          new coxmatch_ofb_icmpv6_type();
-    }
-    return dynamic_cast<coxmatch_ofb_icmpv6_type &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE)]);
+    return set_oxm<coxmatch_ofb_icmpv6_type>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE));
   };
 
   /**
    *
    */
   const coxmatch_ofb_icmpv6_type &get_ofb_icmpv6_type() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_icmpv6_type() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_icmpv6_type &>(*matches.at(
-        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE)));
+    return get_oxm<coxmatch_ofb_icmpv6_type>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE),
+        "coxmatches::get_ofb_icmpv6_type() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_icmpv6_type() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(
-        rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE));
-    return true;
+    return drop_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE));
   };
 
   /**
    *
    */
   bool has_ofb_icmpv6_type() const {
-    AcquireReadLock lock(rwlock);
-    return (
-        not(matches.find(OXM_ROFL_OFB_TYPE(
-                rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE)) == matches.end()));
+    return has_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE));
   };
 
 public:
@@ -2349,68 +1524,41 @@ public:
    *
    */
   coxmatch_ofb_icmpv6_code &add_ofb_icmpv6_code(uint8_t icmpv6_code = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(
-          rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE)] =
-        new coxmatch_ofb_icmpv6_code(icmpv6_code);
-    return dynamic_cast<coxmatch_ofb_icmpv6_code &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE),
+                   coxmatch_ofb_icmpv6_code(icmpv6_code));
   };
 
   /**
    *
    */
   coxmatch_ofb_icmpv6_code &set_ofb_icmpv6_code() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE)] =
-          new coxmatch_ofb_icmpv6_code();
-    }
-    return dynamic_cast<coxmatch_ofb_icmpv6_code &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE)]);
+    return set_oxm<coxmatch_ofb_icmpv6_code>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE));
   };
 
   /**
    *
    */
   const coxmatch_ofb_icmpv6_code &get_ofb_icmpv6_code() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_icmpv6_code() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_icmpv6_code &>(*matches.at(
-        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE)));
+    return get_oxm<coxmatch_ofb_icmpv6_code>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE),
+        "coxmatches::get_ofb_icmpv6_code() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_icmpv6_code() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(
-        rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE));
-    return true;
+    return drop_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE));
   };
 
   /**
    *
    */
   bool has_ofb_icmpv6_code() const {
-    AcquireReadLock lock(rwlock);
-    return (
-        not(matches.find(OXM_ROFL_OFB_TYPE(
-                rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE)) == matches.end()));
+    return has_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE));
   };
 
 public:
@@ -2419,71 +1567,42 @@ public:
    */
   coxmatch_ofb_ipv6_nd_target &add_ofb_ipv6_nd_target(
       const rofl::caddress_in6 &ipv6_nd_target = rofl::caddress_in6()) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(
-          rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET)] =
-        new coxmatch_ofb_ipv6_nd_target(ipv6_nd_target);
-    return dynamic_cast<coxmatch_ofb_ipv6_nd_target &>(
-        *matches[OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET)]);
+    return add_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET),
+        coxmatch_ofb_ipv6_nd_target(ipv6_nd_target));
   };
 
   /**
    *
    */
   coxmatch_ofb_ipv6_nd_target &set_ofb_ipv6_nd_target() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET)] =
-          new coxmatch_ofb_ipv6_nd_target();
-    }
-    return dynamic_cast<coxmatch_ofb_ipv6_nd_target &>(
-        *matches[OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET)]);
+    return set_oxm<coxmatch_ofb_ipv6_nd_target>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET));
   };
 
   /**
    *
    */
   const coxmatch_ofb_ipv6_nd_target &get_ofb_ipv6_nd_target() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_ipv6_nd_target() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_ipv6_nd_target &>(*matches.at(
-        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET)));
+    return get_oxm<coxmatch_ofb_ipv6_nd_target>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET),
+        "coxmatches::get_ofb_ipv6_nd_target() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_ipv6_nd_target() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(
-        rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET)];
-    matches.erase(
+    return drop_oxm(
         OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET));
-    return true;
   };
 
   /**
    *
    */
   bool has_ofb_ipv6_nd_target() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET)) ==
-                matches.end()));
+    return has_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET));
   };
 
 public:
@@ -2492,68 +1611,41 @@ public:
    */
   coxmatch_ofb_ipv6_nd_sll &
   add_ofb_ipv6_nd_sll(const rofl::caddress_ll &ipv6_nd_sll = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(
-          rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL)] =
-        new coxmatch_ofb_ipv6_nd_sll(ipv6_nd_sll);
-    return dynamic_cast<coxmatch_ofb_ipv6_nd_sll &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL),
+                   coxmatch_ofb_ipv6_nd_sll(ipv6_nd_sll));
   };
 
   /**
    *
    */
   coxmatch_ofb_ipv6_nd_sll &set_ofb_ipv6_nd_sll() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL)] =
-          new coxmatch_ofb_ipv6_nd_sll();
-    }
-    return dynamic_cast<coxmatch_ofb_ipv6_nd_sll &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL)]);
+    return set_oxm<coxmatch_ofb_ipv6_nd_sll>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL));
   };
 
   /**
    *
    */
   const coxmatch_ofb_ipv6_nd_sll &get_ofb_ipv6_nd_sll() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_ipv6_nd_sll() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_ipv6_nd_sll &>(*matches.at(
-        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL)));
+    return get_oxm<coxmatch_ofb_ipv6_nd_sll>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL),
+        "coxmatches::get_ofb_ipv6_nd_sll() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_ipv6_nd_sll() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(
-        rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL));
-    return true;
+    return drop_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL));
   };
 
   /**
    *
    */
   bool has_ofb_ipv6_nd_sll() const {
-    AcquireReadLock lock(rwlock);
-    return (
-        not(matches.find(OXM_ROFL_OFB_TYPE(
-                rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL)) == matches.end()));
+    return has_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL));
   };
 
 public:
@@ -2562,68 +1654,41 @@ public:
    */
   coxmatch_ofb_ipv6_nd_tll &
   add_ofb_ipv6_nd_tll(const rofl::caddress_ll &ipv6_nd_tll = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(
-          rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL)] =
-        new coxmatch_ofb_ipv6_nd_tll(ipv6_nd_tll);
-    return dynamic_cast<coxmatch_ofb_ipv6_nd_tll &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL),
+                   coxmatch_ofb_ipv6_nd_tll(ipv6_nd_tll));
   };
 
   /**
    *
    */
   coxmatch_ofb_ipv6_nd_tll &set_ofb_ipv6_nd_tll() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL)] =
-          new coxmatch_ofb_ipv6_nd_tll();
-    }
-    return dynamic_cast<coxmatch_ofb_ipv6_nd_tll &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL)]);
+    return set_oxm<coxmatch_ofb_ipv6_nd_tll>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL));
   };
 
   /**
    *
    */
   const coxmatch_ofb_ipv6_nd_tll &get_ofb_ipv6_nd_tll() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_ipv6_nd_tll() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_ipv6_nd_tll &>(*matches.at(
-        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL)));
+    return get_oxm<coxmatch_ofb_ipv6_nd_tll>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL),
+        "coxmatches::get_ofb_ipv6_nd_tll() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_ipv6_nd_tll() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(
-        rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL));
-    return true;
+    return drop_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL));
   };
 
   /**
    *
    */
   bool has_ofb_ipv6_nd_tll() const {
-    AcquireReadLock lock(rwlock);
-    return (
-        not(matches.find(OXM_ROFL_OFB_TYPE(
-                rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL)) == matches.end()));
+    return has_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL));
   };
 
 public:
@@ -2631,67 +1696,40 @@ public:
    *
    */
   coxmatch_ofb_mpls_label &add_ofb_mpls_label(uint32_t mpls_label = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(
-          rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL)] =
-        new coxmatch_ofb_mpls_label(mpls_label);
-    return dynamic_cast<coxmatch_ofb_mpls_label &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL),
+                   coxmatch_ofb_mpls_label(mpls_label));
   };
 
   /**
    *
    */
   coxmatch_ofb_mpls_label &set_ofb_mpls_label() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL)] =
-          new coxmatch_ofb_mpls_label();
-    }
-    return dynamic_cast<coxmatch_ofb_mpls_label &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL)]);
+    return set_oxm<coxmatch_ofb_mpls_label>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL));
   };
 
   /**
    *
    */
   const coxmatch_ofb_mpls_label &get_ofb_mpls_label() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_mpls_label() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_mpls_label &>(*matches.at(
-        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL)));
+    return get_oxm<coxmatch_ofb_mpls_label>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL),
+        "coxmatches::get_ofb_mpls_label() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_mpls_label() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL));
-    return true;
+    return drop_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL));
   };
 
   /**
    *
    */
   bool has_ofb_mpls_label() const {
-    AcquireReadLock lock(rwlock);
-    return (
-        not(matches.find(OXM_ROFL_OFB_TYPE(
-                rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL));
   };
 
 public:
@@ -2699,65 +1737,39 @@ public:
    *
    */
   coxmatch_ofb_mpls_tc &add_ofb_mpls_tc(uint8_t mpls_tc = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_MPLS_TC)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_TC)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_TC)] =
-        new coxmatch_ofb_mpls_tc(mpls_tc);
-    return dynamic_cast<coxmatch_ofb_mpls_tc &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_TC)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_TC),
+                   coxmatch_ofb_mpls_tc(mpls_tc));
   };
 
   /**
    *
    */
   coxmatch_ofb_mpls_tc &set_ofb_mpls_tc() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_MPLS_TC)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_TC)] =
-          new coxmatch_ofb_mpls_tc();
-    }
-    return dynamic_cast<coxmatch_ofb_mpls_tc &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_TC)]);
+    return set_oxm<coxmatch_ofb_mpls_tc>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_TC));
   };
 
   /**
    *
    */
   const coxmatch_ofb_mpls_tc &get_ofb_mpls_tc() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_MPLS_TC)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_mpls_tc() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_mpls_tc &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_TC)));
+    return get_oxm<coxmatch_ofb_mpls_tc>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_TC),
+        "coxmatches::get_ofb_mpls_tc() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_mpls_tc() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_MPLS_TC)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_TC)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_TC));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_TC));
   };
 
   /**
    *
    */
   bool has_ofb_mpls_tc() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_MPLS_TC)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_TC));
   };
 
 public:
@@ -2765,65 +1777,39 @@ public:
    *
    */
   coxmatch_ofb_mpls_bos &add_ofb_mpls_bos(uint8_t mpls_bos = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_MPLS_BOS)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_BOS)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_BOS)] =
-        new coxmatch_ofb_mpls_bos(mpls_bos);
-    return dynamic_cast<coxmatch_ofb_mpls_bos &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_BOS)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_BOS),
+                   coxmatch_ofb_mpls_bos(mpls_bos));
   };
 
   /**
    *
    */
   coxmatch_ofb_mpls_bos &set_ofb_mpls_bos() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_MPLS_BOS)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_BOS)] =
-          new coxmatch_ofb_mpls_bos();
-    }
-    return dynamic_cast<coxmatch_ofb_mpls_bos &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_BOS)]);
+    return set_oxm<coxmatch_ofb_mpls_bos>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_BOS));
   };
 
   /**
    *
    */
   const coxmatch_ofb_mpls_bos &get_ofb_mpls_bos() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_MPLS_BOS)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_mpls_bos() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_mpls_bos &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_BOS)));
+    return get_oxm<coxmatch_ofb_mpls_bos>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_BOS),
+        "coxmatches::get_ofb_mpls_bos() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_mpls_bos() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_MPLS_BOS)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_BOS)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_BOS));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_BOS));
   };
 
   /**
    *
    */
   bool has_ofb_mpls_bos() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_MPLS_BOS)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_MPLS_BOS));
   };
 
 public:
@@ -2831,83 +1817,47 @@ public:
    *
    */
   coxmatch_ofb_tunnel_id &add_ofb_tunnel_id(uint64_t tunnel_id = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(
-          rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID)] =
-        new coxmatch_ofb_tunnel_id(tunnel_id);
-    return dynamic_cast<coxmatch_ofb_tunnel_id &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID),
+                   coxmatch_ofb_tunnel_id(tunnel_id));
   };
 
   /**
    *
    */
   coxmatch_ofb_tunnel_id &add_ofb_tunnel_id(uint64_t tunnel_id, uint64_t mask) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(
-          rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID)] =
-        new coxmatch_ofb_tunnel_id(tunnel_id, mask);
-    return dynamic_cast<coxmatch_ofb_tunnel_id &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID),
+                   coxmatch_ofb_tunnel_id(tunnel_id, mask));
   };
 
   /**
    *
    */
   coxmatch_ofb_tunnel_id &set_ofb_tunnel_id() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID)] =
-          new coxmatch_ofb_tunnel_id();
-    }
-    return dynamic_cast<coxmatch_ofb_tunnel_id &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID)]);
+    return set_oxm<coxmatch_ofb_tunnel_id>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID));
   };
 
   /**
    *
    */
   const coxmatch_ofb_tunnel_id &get_ofb_tunnel_id() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_tunnel_id() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_tunnel_id &>(*matches.at(
-        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID)));
+    return get_oxm<coxmatch_ofb_tunnel_id>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID),
+        "coxmatches::get_ofb_tunnel_id() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_tunnel_id() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID));
   };
 
   /**
    *
    */
   bool has_ofb_tunnel_id() const {
-    AcquireReadLock lock(rwlock);
-    return (
-        not(matches.find(OXM_ROFL_OFB_TYPE(
-                rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID));
   };
 
 public:
@@ -2915,80 +1865,47 @@ public:
    *
    */
   coxmatch_ofb_pbb_isid &add_ofb_pbb_isid(uint32_t pbb_isid = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_PBB_ISID)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID)] =
-        new coxmatch_ofb_pbb_isid(pbb_isid);
-    return dynamic_cast<coxmatch_ofb_pbb_isid &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID),
+                   coxmatch_ofb_pbb_isid(pbb_isid));
   };
 
   /**
    *
    */
   coxmatch_ofb_pbb_isid &add_ofb_pbb_isid(uint32_t pbb_isid, uint32_t mask) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_PBB_ISID)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID)] =
-        new coxmatch_ofb_pbb_isid(pbb_isid, mask);
-    return dynamic_cast<coxmatch_ofb_pbb_isid &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID),
+                   coxmatch_ofb_pbb_isid(pbb_isid, mask));
   };
 
   /**
    *
    */
   coxmatch_ofb_pbb_isid &set_ofb_pbb_isid() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_PBB_ISID)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID)] =
-          new coxmatch_ofb_pbb_isid();
-    }
-    return dynamic_cast<coxmatch_ofb_pbb_isid &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID)]);
+    return set_oxm<coxmatch_ofb_pbb_isid>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID));
   };
 
   /**
    *
    */
   const coxmatch_ofb_pbb_isid &get_ofb_pbb_isid() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_PBB_ISID)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_pbb_isid() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_pbb_isid &>(
-        *matches.at(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID)));
+    return get_oxm<coxmatch_ofb_pbb_isid>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID),
+        "coxmatches::get_ofb_pbb_isid() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_pbb_isid() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_PBB_ISID)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID));
-    return true;
+    return drop_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID));
   };
 
   /**
    *
    */
   bool has_ofb_pbb_isid() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFB_TYPE(
-                    rofl::openflow::OXM_TLV_BASIC_PBB_ISID)) == matches.end()));
+    return has_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_PBB_ISID));
   };
 
 public:
@@ -2996,85 +1913,50 @@ public:
    *
    */
   coxmatch_ofb_ipv6_exthdr &add_ofb_ipv6_exthdr(uint16_t ipv6_exthdr = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(
-          rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR)] =
-        new coxmatch_ofb_ipv6_exthdr(ipv6_exthdr);
-    return dynamic_cast<coxmatch_ofb_ipv6_exthdr &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR)]);
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR),
+                   coxmatch_ofb_ipv6_exthdr(ipv6_exthdr));
   };
 
   /**
    *
    */
-  coxmatch_ofb_ipv6_exthdr &add_ofb_ipv6_exthdr(uint16_t ipv6_exthdr,
-                                                uint16_t mask) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR)) != matches.end()) {
-      delete matches[OXM_ROFL_OFB_TYPE(
-          rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR)];
-    }
-    matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR)] =
-        new coxmatch_ofb_ipv6_exthdr(ipv6_exthdr, mask);
-    return dynamic_cast<coxmatch_ofb_ipv6_exthdr &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR)]);
+  coxmatch_ofb_ipv6_exthdr &
+  add_ofb_ipv6_exthdr(uint16_t ipv6_exthdr, uint16_t mask) {
+    return add_oxm(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR),
+                   coxmatch_ofb_ipv6_exthdr(ipv6_exthdr, mask));
   };
 
   /**
    *
    */
   coxmatch_ofb_ipv6_exthdr &set_ofb_ipv6_exthdr() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR)) == matches.end()) {
-      matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR)] =
-          new coxmatch_ofb_ipv6_exthdr();
-    }
-    return dynamic_cast<coxmatch_ofb_ipv6_exthdr &>(
-        *matches[OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR)]);
+    return set_oxm<coxmatch_ofb_ipv6_exthdr>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR));
   };
 
   /**
    *
    */
   const coxmatch_ofb_ipv6_exthdr &get_ofb_ipv6_exthdr() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_ofb_ipv6_exthdr() not found");
-    }
-    return dynamic_cast<const coxmatch_ofb_ipv6_exthdr &>(*matches.at(
-        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR)));
+    return get_oxm<coxmatch_ofb_ipv6_exthdr>(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR),
+        "coxmatches::get_ofb_ipv6_exthdr() not found");
   };
 
   /**
    *
    */
   bool drop_ofb_ipv6_exthdr() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFB_TYPE(
-            rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFB_TYPE(
-        rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR)];
-    matches.erase(OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR));
-    return true;
+    return drop_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR));
   };
 
   /**
    *
    */
   bool has_ofb_ipv6_exthdr() const {
-    AcquireReadLock lock(rwlock);
-    return (
-        not(matches.find(OXM_ROFL_OFB_TYPE(
-                rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR)) == matches.end()));
+    return has_oxm(
+        OXM_ROFL_OFB_TYPE(rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR));
   };
 
 public:
@@ -3082,232 +1964,132 @@ public:
    *
    */
   coxmatch_ofx_nw_proto &add_ofx_nw_proto(uint8_t nw_proto = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO)) !=
-        matches.end()) {
-      delete matches[OXM_ROFL_OFX_TYPE(
-          rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO)];
-    }
-    matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO)] =
-        new coxmatch_ofx_nw_proto(nw_proto);
-    return dynamic_cast<coxmatch_ofx_nw_proto &>(*matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO)]);
+    return add_oxm(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO),
+        coxmatch_ofx_nw_proto(nw_proto));
   };
 
   /**
    *
    */
   coxmatch_ofx_nw_proto &set_ofx_nw_proto() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO)) ==
-        matches.end()) {
-      matches[OXM_ROFL_OFX_TYPE(
-          rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO)] =
-          new coxmatch_ofx_nw_proto();
-    }
-    return dynamic_cast<coxmatch_ofx_nw_proto &>(*matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO)]);
+    return set_oxm<coxmatch_ofx_nw_proto>(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO));
   };
 
   /**
    *
    */
   const coxmatch_ofx_nw_proto &get_ofx_nw_proto() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO)) ==
-        matches.end()) {
-      throw eOxmInval("coxmatches::get_ofx_nw_proto() not found");
-    }
-    return dynamic_cast<const coxmatch_ofx_nw_proto &>(
-        *matches.at(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO)));
+    return get_oxm<coxmatch_ofx_nw_proto>(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO),
+        "coxmatches::get_ofx_nw_proto() not found");
   };
 
   /**
    *
    */
   bool drop_ofx_nw_proto() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO)) ==
-        matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO)];
-    matches.erase(
+    return drop_oxm(
         OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO));
-    return true;
   };
 
   /**
    *
    */
   bool has_ofx_nw_proto() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFX_TYPE(
-                    rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO)) ==
-                matches.end()));
+    return has_oxm(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO));
   };
 
 public:
   /**
    *
    */
-  coxmatch_ofx_nw_src &
-  add_ofx_nw_src(const rofl::caddress_in4 &nw_src = rofl::caddress_in4(),
-                 const rofl::caddress_in4 &mask = rofl::caddress_in4()) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC)) !=
-        matches.end()) {
-      delete matches[OXM_ROFL_OFX_TYPE(
-          rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC)];
-    }
-    matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC)] =
-        new coxmatch_ofx_nw_src(nw_src, mask);
-    return dynamic_cast<coxmatch_ofx_nw_src &>(*matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC)]);
+  coxmatch_ofx_nw_src &add_ofx_nw_src(
+      const rofl::caddress_in4 &nw_src = rofl::caddress_in4(),
+      const rofl::caddress_in4 &mask = rofl::caddress_in4()) {
+    return add_oxm(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC),
+        coxmatch_ofx_nw_src(nw_src, mask));
   };
 
   /**
    *
    */
   coxmatch_ofx_nw_src &set_ofx_nw_src() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC)) ==
-        matches.end()) {
-      matches[OXM_ROFL_OFX_TYPE(
-          rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC)] =
-          new coxmatch_ofx_nw_src();
-    }
-    return dynamic_cast<coxmatch_ofx_nw_src &>(*matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC)]);
+    return set_oxm<coxmatch_ofx_nw_src>(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC));
   };
 
   /**
    *
    */
   const coxmatch_ofx_nw_src &get_ofx_nw_src() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC)) ==
-        matches.end()) {
-      throw eOxmInval("coxmatches::get_ofx_nw_src() not found");
-    }
-    return dynamic_cast<const coxmatch_ofx_nw_src &>(*matches.at(
-        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC)));
+    return get_oxm<coxmatch_ofx_nw_src>(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC),
+        "coxmatches::get_ofx_nw_src() not found");
   };
 
   /**
    *
    */
   bool drop_ofx_nw_src() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC)) ==
-        matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC)];
-    matches.erase(
+    return drop_oxm(
         OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC));
-    return true;
   };
 
   /**
    *
    */
   bool has_ofx_nw_src() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFX_TYPE(
-                    rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC)) ==
-                matches.end()));
+    return has_oxm(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC));
   };
 
 public:
   /**
    *
    */
-  coxmatch_ofx_nw_dst &
-  add_ofx_nw_dst(const rofl::caddress_in4 &nw_dst = rofl::caddress_in4(),
-                 const rofl::caddress_in4 &mask = rofl::caddress_in4()) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST)) !=
-        matches.end()) {
-      delete matches[OXM_ROFL_OFX_TYPE(
-          rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST)];
-    }
-    matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST)] =
-        new coxmatch_ofx_nw_dst(nw_dst, mask);
-    return dynamic_cast<coxmatch_ofx_nw_dst &>(*matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST)]);
+  coxmatch_ofx_nw_dst &add_ofx_nw_dst(
+      const rofl::caddress_in4 &nw_dst = rofl::caddress_in4(),
+      const rofl::caddress_in4 &mask = rofl::caddress_in4()) {
+    return add_oxm(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST),
+        coxmatch_ofx_nw_dst(nw_dst, mask));
   };
 
   /**
    *
    */
   coxmatch_ofx_nw_dst &set_ofx_nw_dst() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST)) ==
-        matches.end()) {
-      matches[OXM_ROFL_OFX_TYPE(
-          rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST)] =
-          new coxmatch_ofx_nw_dst();
-    }
-    return dynamic_cast<coxmatch_ofx_nw_dst &>(*matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST)]);
+    return set_oxm<coxmatch_ofx_nw_dst>(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST));
   };
 
   /**
    *
    */
   const coxmatch_ofx_nw_dst &get_ofx_nw_dst() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST)) ==
-        matches.end()) {
-      throw eOxmInval("coxmatches::get_ofx_nw_dst() not found");
-    }
-    return dynamic_cast<const coxmatch_ofx_nw_dst &>(*matches.at(
-        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST)));
+    return get_oxm<coxmatch_ofx_nw_dst>(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST),
+        "coxmatches::get_ofx_nw_dst() not found");
   };
 
   /**
    *
    */
   bool drop_ofx_nw_dst() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST)) ==
-        matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST)];
-    matches.erase(
+    return drop_oxm(
         OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST));
-    return true;
   };
 
   /**
    *
    */
   bool has_ofx_nw_dst() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFX_TYPE(
-                    rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST)) ==
-                matches.end()));
+    return has_oxm(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST));
   };
 
 public:
@@ -3315,75 +2097,42 @@ public:
    *
    */
   coxmatch_ofx_nw_tos &add_ofx_nw_tos(uint8_t nw_tos = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS)) !=
-        matches.end()) {
-      delete matches[OXM_ROFL_OFX_TYPE(
-          rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS)];
-    }
-    matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS)] =
-        new coxmatch_ofx_nw_tos(nw_tos);
-    return dynamic_cast<coxmatch_ofx_nw_tos &>(*matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS)]);
+    return add_oxm(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS),
+        coxmatch_ofx_nw_tos(nw_tos));
   };
 
   /**
    *
    */
   coxmatch_ofx_nw_tos &set_ofx_nw_tos() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS)) ==
-        matches.end()) {
-      matches[OXM_ROFL_OFX_TYPE(
-          rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS)] =
-          new coxmatch_ofx_nw_tos();
-    }
-    return dynamic_cast<coxmatch_ofx_nw_tos &>(*matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS)]);
+    return set_oxm<coxmatch_ofx_nw_tos>(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS));
   };
 
   /**
    *
    */
   const coxmatch_ofx_nw_tos &get_ofx_nw_tos() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS)) ==
-        matches.end()) {
-      throw eOxmInval("coxmatches::get_ofx_nw_tos() not found");
-    }
-    return dynamic_cast<const coxmatch_ofx_nw_tos &>(*matches.at(
-        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS)));
+    return get_oxm<coxmatch_ofx_nw_tos>(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS),
+        "coxmatches::get_ofx_nw_tos() not found");
   };
 
   /**
    *
    */
   bool drop_ofx_nw_tos() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS)) ==
-        matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS)];
-    matches.erase(
+    return drop_oxm(
         OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS));
-    return true;
   };
 
   /**
    *
    */
   bool has_ofx_nw_tos() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFX_TYPE(
-                    rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS)) ==
-                matches.end()));
+    return has_oxm(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS));
   };
 
 public:
@@ -3391,75 +2140,42 @@ public:
    *
    */
   coxmatch_ofx_tp_src &add_ofx_tp_src(uint16_t tp_src = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC)) !=
-        matches.end()) {
-      delete matches[OXM_ROFL_OFX_TYPE(
-          rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC)];
-    }
-    matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC)] =
-        new coxmatch_ofx_tp_src(tp_src);
-    return dynamic_cast<coxmatch_ofx_tp_src &>(*matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC)]);
+    return add_oxm(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC),
+        coxmatch_ofx_tp_src(tp_src));
   };
 
   /**
    *
    */
   coxmatch_ofx_tp_src &set_ofx_tp_src() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC)) ==
-        matches.end()) {
-      matches[OXM_ROFL_OFX_TYPE(
-          rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC)] =
-          new coxmatch_ofx_tp_src();
-    }
-    return dynamic_cast<coxmatch_ofx_tp_src &>(*matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC)]);
+    return set_oxm<coxmatch_ofx_tp_src>(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC));
   };
 
   /**
    *
    */
   const coxmatch_ofx_tp_src &get_ofx_tp_src() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC)) ==
-        matches.end()) {
-      throw eOxmInval("coxmatches::get_ofx_tp_src() not found");
-    }
-    return dynamic_cast<const coxmatch_ofx_tp_src &>(*matches.at(
-        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC)));
+    return get_oxm<coxmatch_ofx_tp_src>(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC),
+        "coxmatches::get_ofx_tp_src() not found");
   };
 
   /**
    *
    */
   bool drop_ofx_tp_src() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC)) ==
-        matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC)];
-    matches.erase(
+    return drop_oxm(
         OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC));
-    return true;
   };
 
   /**
    *
    */
   bool has_ofx_tp_src() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFX_TYPE(
-                    rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC)) ==
-                matches.end()));
+    return has_oxm(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC));
   };
 
 public:
@@ -3467,75 +2183,42 @@ public:
    *
    */
   coxmatch_ofx_tp_dst &add_ofx_tp_dst(uint16_t tp_dst = 0) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST)) !=
-        matches.end()) {
-      delete matches[OXM_ROFL_OFX_TYPE(
-          rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST)];
-    }
-    matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST)] =
-        new coxmatch_ofx_tp_dst(tp_dst);
-    return dynamic_cast<coxmatch_ofx_tp_dst &>(*matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST)]);
+    return add_oxm(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST),
+        coxmatch_ofx_tp_dst(tp_dst));
   };
 
   /**
    *
    */
   coxmatch_ofx_tp_dst &set_ofx_tp_dst() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST)) ==
-        matches.end()) {
-      matches[OXM_ROFL_OFX_TYPE(
-          rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST)] =
-          new coxmatch_ofx_tp_dst();
-    }
-    return dynamic_cast<coxmatch_ofx_tp_dst &>(*matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST)]);
+    return set_oxm<coxmatch_ofx_tp_dst>(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST));
   };
 
   /**
    *
    */
   const coxmatch_ofx_tp_dst &get_ofx_tp_dst() const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST)) ==
-        matches.end()) {
-      throw eOxmInval("coxmatches::get_ofx_tp_dst() not found");
-    }
-    return dynamic_cast<const coxmatch_ofx_tp_dst &>(*matches.at(
-        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST)));
+    return get_oxm<coxmatch_ofx_tp_dst>(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST),
+        "coxmatches::get_ofx_tp_dst() not found");
   };
 
   /**
    *
    */
   bool drop_ofx_tp_dst() {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_ROFL_OFX_TYPE(
-            rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST)) ==
-        matches.end()) {
-      return false;
-    }
-    delete matches[OXM_ROFL_OFX_TYPE(
-        rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST)];
-    matches.erase(
+    return drop_oxm(
         OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST));
-    return true;
   };
 
   /**
    *
    */
   bool has_ofx_tp_dst() const {
-    AcquireReadLock lock(rwlock);
-    return (not(matches.find(OXM_ROFL_OFX_TYPE(
-                    rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST)) ==
-                matches.end()));
+    return has_oxm(
+        OXM_ROFL_OFX_TYPE(rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST));
   };
 
 public:
@@ -3543,61 +2226,38 @@ public:
    *
    */
   coxmatch_exp &add_exp_match(uint32_t exp_id, uint32_t oxm_id) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_EXPR_OFX_TYPE(exp_id, oxm_id)) != matches.end()) {
-      delete matches[OXM_EXPR_OFX_TYPE(exp_id, oxm_id)];
-    }
-    matches[OXM_EXPR_OFX_TYPE(exp_id, oxm_id)] =
-        new coxmatch_exp(oxm_id, exp_id); // yes, this order!
-    return dynamic_cast<coxmatch_exp &>(
-        *matches[OXM_EXPR_OFX_TYPE(exp_id, oxm_id)]);
+    return add_oxm(OXM_EXPR_OFX_TYPE(exp_id, oxm_id),
+                   coxmatch_exp(oxm_id, exp_id)); // yes, this order!
   };
 
   /**
    *
    */
   coxmatch_exp &set_exp_match(uint32_t exp_id, uint32_t oxm_id) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_EXPR_OFX_TYPE(exp_id, oxm_id)) == matches.end()) {
-      matches[OXM_EXPR_OFX_TYPE(exp_id, oxm_id)] =
-          new coxmatch_exp(oxm_id, exp_id); // yes, this order!
-    }
-    return dynamic_cast<coxmatch_exp &>(
-        *matches[OXM_EXPR_OFX_TYPE(exp_id, oxm_id)]);
+    return set_oxm(OXM_EXPR_OFX_TYPE(exp_id, oxm_id),
+                   coxmatch_exp(oxm_id, exp_id)); // yes, this order!
   };
 
   /**
    *
    */
   const coxmatch_exp &get_exp_match(uint32_t exp_id, uint32_t oxm_id) const {
-    AcquireReadLock lock(rwlock);
-    if (matches.find(OXM_EXPR_OFX_TYPE(exp_id, oxm_id)) == matches.end()) {
-      throw eOxmInval("coxmatches::get_exp_match() not found");
-    }
-    return dynamic_cast<const coxmatch_exp &>(
-        *matches.at(OXM_EXPR_OFX_TYPE(exp_id, oxm_id)));
+    return get_oxm<coxmatch_exp>(OXM_EXPR_OFX_TYPE(exp_id, oxm_id),
+                                 "coxmatches::get_exp_match() not found");
   };
 
   /**
    *
    */
   bool drop_exp_match(uint32_t exp_id, uint32_t oxm_id) {
-    AcquireReadWriteLock lock(rwlock);
-    if (matches.find(OXM_EXPR_OFX_TYPE(exp_id, oxm_id)) == matches.end()) {
-      return false;
-    }
-    delete matches[OXM_EXPR_OFX_TYPE(exp_id, oxm_id)];
-    matches.erase(OXM_EXPR_OFX_TYPE(exp_id, oxm_id));
-    return true;
+    return drop_oxm(OXM_EXPR_OFX_TYPE(exp_id, oxm_id));
   };
 
   /**
    *
    */
   bool has_exp_match(uint32_t exp_id, uint32_t oxm_id) const {
-    AcquireReadLock lock(rwlock);
-    return (
-        not(matches.find(OXM_EXPR_OFX_TYPE(exp_id, oxm_id)) == matches.end()));
+    return has_oxm(OXM_EXPR_OFX_TYPE(exp_id, oxm_id));
   };
 
 public:
@@ -3767,10 +2427,122 @@ public:
     return os;
   };
 
+private:
+  /**
+   * @brief	Returns the slot for oxm_type sized for a TLV of tlvlen bytes,
+   * inserts it if missing, caller holds rwlock
+   */
+  coxmatch_slot &alloc_slot(uint64_t oxm_type, size_t tlvlen);
+
+  /**
+   * @brief	Writes the fields handed out by reference back to their slots
+   *
+   * Such fields may be modified by the caller at any time, so they take
+   * precedence over their slots until dropped. Called before reading slots.
+   */
+  void sync() const;
+
+  /**
+   * @brief	Deletes the fields handed out by reference, caller holds rwlock
+   */
+  void flush() const;
+
+  /**
+   * @brief	Returns the field for oxm_type, decoded from slot and kept until
+   * dropped, caller holds rwlock
+   */
+  template <class T>
+  T &load_oxm(uint64_t oxm_type, const coxmatch_slot &slot) const {
+    auto it = fields.find(oxm_type);
+    if (it != fields.end()) {
+      return dynamic_cast<T &>(*it->second);
+    }
+    T *oxm = new T();
+    oxm->T::unpack(const_cast<uint8_t *>(slot.tlv()), slot.length());
+    fields[oxm_type] = oxm;
+    return *oxm;
+  };
+
+  /**
+   *
+   */
+  template <class T> T &add_oxm(uint64_t oxm_type, const T &oxm) {
+    AcquireReadWriteLock lock(rwlock);
+    T *field = new T(oxm);
+    auto it = fields.find(oxm_type);
+    if (it != fields.end()) {
+      delete it->second;
+      it->second = field;
+    } else {
+      fields[oxm_type] = field;
+    }
+    size_t tlvlen = field->T::length();
+    field->T::pack(alloc_slot(oxm_type, tlvlen).tlv(), tlvlen);
+    return *field;
+  };
+
+  /**
+   *
+   */
+  template <class T> T &set_oxm(uint64_t oxm_type, const T &oxm = T()) {
+    {
+      AcquireReadWriteLock lock(rwlock);
+      auto it = matches.find(oxm_type);
+      if (it != matches.end()) {
+        return load_oxm<T>(oxm_type, it->second);
+      }
+    }
+    return add_oxm(oxm_type, oxm);
+  };
+
+  /**
+   *
+   */
+  template <class T>
+  const T &get_oxm(uint64_t oxm_type, const char *what) const {
+    AcquireReadWriteLock lock(rwlock);
+    auto it = matches.find(oxm_type);
+    if (it == matches.end()) {
+      throw eOxmInval(what);
+    }
+    return load_oxm<T>(oxm_type, it->second);
+  };
+
+  /**
+   *
+   */
+  bool drop_oxm(uint64_t oxm_type) {
+    AcquireReadWriteLock lock(rwlock);
+    auto it = matches.find(oxm_type);
+    if (it == matches.end()) {
+      return false;
+    }
+    delete[] it->second.ext;
+    matches.erase(it);
+    auto jt = fields.find(oxm_type);
+    if (jt != fields.end()) {
+      delete jt->second;
+      fields.erase(jt);
+    }
+    return true;
+  };
+
+  /**
+   *
+   */
+  bool has_oxm(uint64_t oxm_type) const {
+    AcquireReadLock lock(rwlock);
+    return (matches.find(oxm_type) != matches.end());
+  };
+
 private:
   mutable rofl::crwlock rwlock;
 
-  std::map<uint64_t, coxmatch *> matches;
+  // TLVs sorted by OXM type, in wire order
+  rofl::cflatmap<uint64_t, coxmatch_slot> matches;
+
+  // fields handed out by reference, see sync()
+  mutable rofl::cflatmap<uint64_t, coxmatch *> fields;
 };
 
 }; // end of namespace openflow
@@ -4,6 +4,8 @@
 
 #include "rofl/common/openflow/messages/cofmsg.h"
 
+#include <algorithm>
+
 using namespace rofl::openflow;
 
 size_t cofmsg::length() const {
@@ -19,7 +21,8 @@ void cofmsg::pack(uint8_t *buf, size_t buflen) {
   if (buflen < cofmsg::length())
     throw eInvalid("eInvalid", __FILE__, __FUNCTION__, __LINE__);
 
-  memset(buf, 0, buflen); // ensure padding fields to be set to 0
+  // ensure padding fields to be set to 0, but leave the rest of buf alone
+  memset(buf, 0, std::min(buflen, (size_t)len));
 
   struct rofl::openflow::ofp_header *hdr =
       (struct rofl::openflow::ofp_header *)buf;
@@ -6,7 +6,9 @@
 #define COFMSG_H 1
 
 #include <sstream>
+#include <sys/uio.h>
 
+#include "rofl/common/cslab.hpp"
 #include "rofl/common/openflow/openflow.h"
 #include "rofl/common/openflow/openflow_rofl_exceptions.h"
 
@@ -16,7 +18,7 @@ namespace openflow {
 /**
  *
  */
-class cofmsg {
+class cofmsg : public rofl::cslab_object {
 public:
   /**
    *
@@ -66,6 +68,20 @@ public:
    */
   virtual void pack(uint8_t *buf = (uint8_t *)0, size_t buflen = 0);
 
+  /**
+   * @brief	Packs message except for a trailing payload sent without copying
+   *
+   * Returns the number of bytes written to buf. The remaining bytes of the
+   * message are referenced by payload, which stays valid for the lifetime
+   * of this message. Messages without such a payload are packed entirely.
+   */
+  virtual size_t pack_head(uint8_t *buf, size_t buflen, struct iovec &payload) {
+    pack(buf, buflen);
+    payload.iov_base = nullptr;
+    payload.iov_len = 0;
+    return length();
+  };
+
   /**
    *
    */
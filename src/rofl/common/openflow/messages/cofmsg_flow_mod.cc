@@ -85,3 +85,92 @@ void cofmsg_flow_mod::unpack(uint8_t *buf, size_t buflen) {
     throw eBadRequestBadLen("eBadRequestBadLen", __FILE__, __FUNCTION__,
                             __LINE__);
 }
+
+void cofmsg_flow_mod_batch::pack(uint8_t *buf, size_t buflen) {
+  if ((0 == buf) || (0 == buflen))
+    return;
+
+  if (buflen < wirelen)
+    throw eInvalid("eInvalid", __FILE__, __FUNCTION__, __LINE__);
+
+  memcpy(buf, wire.somem(), wirelen);
+}
+
+size_t cofmsg_flow_mod_batch::pack_head(uint8_t *buf, size_t buflen,
+                                        struct iovec &payload) {
+  payload.iov_base = wire.somem();
+  payload.iov_len = wirelen;
+  return 0;
+}
+
+void cofmsg_flow_mod_batch::unpack(uint8_t *buf, size_t buflen) {
+  throw eInvalid("eInvalid", __FILE__, __FUNCTION__, __LINE__);
+}
+
+cofmsg_flow_mod_batch &
+cofmsg_flow_mod_batch::add_flow_mod(uint32_t xid,
+                                    const rofl::openflow::cofflowmod &flowmod) {
+  if (flowmod.get_version() != get_version()) {
+    rofl::openflow::cofflowmod fm(flowmod);
+    fm.set_version(get_version());
+    return add_flow_mod(xid, fm);
+  }
+
+  size_t bodylen = flowmod.length();
+  uint8_t *buf =
+      append(rofl::openflow::OFPT_FLOW_MOD, xid,
+             sizeof(struct rofl::openflow::ofp_header) + bodylen);
+  /* pack() is not declared const, but leaves flowmod unaltered */
+  const_cast<rofl::openflow::cofflowmod &>(flowmod).pack(
+      ((struct rofl::openflow::ofp_header *)buf)->body, bodylen);
+  return *this;
+}
+
+cofmsg_flow_mod_batch &cofmsg_flow_mod_batch::add_flow_mod(
+    uint32_t xid, const rofl::openflow::cofflowmod_template &tmpl) {
+  if (tmpl.get_version() != get_version())
+    throw eBadVersion("eBadVersion", __FILE__, __FUNCTION__, __LINE__);
+
+  size_t bodylen = tmpl.length();
+  uint8_t *buf =
+      append(rofl::openflow::OFPT_FLOW_MOD, xid,
+             sizeof(struct rofl::openflow::ofp_header) + bodylen);
+  tmpl.pack(((struct rofl::openflow::ofp_header *)buf)->body, bodylen);
+  return *this;
+}
+
+cofmsg_flow_mod_batch &cofmsg_flow_mod_batch::add_barrier_request(uint32_t xid) {
+  uint8_t type = (get_version() == rofl::openflow10::OFP_VERSION)
+                     ? (uint8_t)rofl::openflow10::OFPT_BARRIER_REQUEST
+                     : (uint8_t)rofl::openflow12::OFPT_BARRIER_REQUEST;
+  append(type, xid, sizeof(struct rofl::openflow::ofp_header));
+  barrier = true;
+  barrier_xid = xid;
+  return *this;
+}
+
+uint8_t *cofmsg_flow_mod_batch::append(uint8_t type, uint32_t xid,
+                                       size_t msglen) {
+  /* nothing follows the trailing Barrier-Request */
+  if ((msglen > 0xffff) || barrier)
+    throw eInvalid("eInvalid", __FILE__, __FUNCTION__, __LINE__);
+
+  if (wire.length() < wirelen + msglen) {
+    wire.resize(std::max(wirelen + msglen, 2 * wire.length()));
+  }
+
+  uint8_t *buf = wire.somem() + wirelen;
+  struct rofl::openflow::ofp_header *hdr =
+      (struct rofl::openflow::ofp_header *)buf;
+  hdr->version = get_version();
+  hdr->type = type;
+  hdr->length = htobe16(msglen);
+  hdr->xid = htobe32(xid);
+
+  if (0 == num) {
+    set_xid(xid);
+  }
+  wirelen += msglen;
+  num++;
+  return buf;
+}
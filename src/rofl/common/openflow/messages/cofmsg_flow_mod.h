@@ -8,7 +8,9 @@
 #ifndef COFMSG_FLOW_MOD_H_
 #define COFMSG_FLOW_MOD_H_ 1
 
+#include "rofl/common/cmemory.h"
 #include "rofl/common/openflow/cofflowmod.h"
+#include "rofl/common/openflow/cofflowmodtemplate.h"
 #include "rofl/common/openflow/messages/cofmsg.h"
 
 namespace rofl {
@@ -92,6 +94,138 @@ private:
   rofl::openflow::cofflowmod flowmod;
 };
 
+/**
+ * @brief	Sequence of Flow-Mod messages sent as a single unit
+ *
+ * Flow-Mods are serialised into a contiguous wire buffer when added. The
+ * buffer is handed over to the socket without further copying. Header
+ * fields of this object carry type Flow-Mod and the xid of the first
+ * message added. A trailing Barrier-Request is reported by
+ * has_barrier_request() and tracked as a transaction by crofconn.
+ */
+class cofmsg_flow_mod_batch : public cofmsg {
+public:
+  /**
+   *
+   */
+  virtual ~cofmsg_flow_mod_batch(){};
+
+  /**
+   *
+   * @param version OpenFlow version of all messages in this batch
+   * @param reserve expected size of the wire buffer in bytes
+   */
+  cofmsg_flow_mod_batch(
+      uint8_t version = rofl::openflow::OFP_VERSION_UNKNOWN,
+      size_t reserve = 0)
+      : cofmsg(version, rofl::openflow::OFPT_FLOW_MOD, 0), wire(reserve),
+        wirelen(0), num(0), barrier(false), barrier_xid(0){};
+
+public:
+  /** returns length of all messages in packed state
+   *
+   */
+  virtual size_t length() const { return wirelen; };
+
+  /**
+   *
+   */
+  virtual void pack(uint8_t *buf = (uint8_t *)0, size_t buflen = 0);
+
+  /**
+   * @brief	Returns the wire buffer as payload, no bytes are copied
+   */
+  virtual size_t pack_head(uint8_t *buf, size_t buflen, struct iovec &payload);
+
+  /**
+   * @brief	Batches are never received, throws eInvalid
+   */
+  virtual void unpack(uint8_t *buf, size_t buflen);
+
+public:
+  /**
+   * @brief	Appends a Flow-Mod message
+   */
+  cofmsg_flow_mod_batch &add_flow_mod(uint32_t xid,
+                                      const rofl::openflow::cofflowmod &flowmod);
+
+  /**
+   * @brief	Appends a Flow-Mod message from a pre-packed template
+   *
+   * @exception eBadVersion template and batch versions differ
+   */
+  cofmsg_flow_mod_batch &
+  add_flow_mod(uint32_t xid, const rofl::openflow::cofflowmod_template &tmpl);
+
+  /**
+   * @brief	Appends a Barrier-Request message
+   *
+   * No further messages may be added afterwards.
+   */
+  cofmsg_flow_mod_batch &add_barrier_request(uint32_t xid);
+
+  /**
+   * @brief	Returns true if this batch ends with a Barrier-Request
+   */
+  bool has_barrier_request() const { return barrier; };
+
+  /**
+   * @brief	Returns xid of the trailing Barrier-Request
+   */
+  uint32_t get_barrier_xid() const { return barrier_xid; };
+
+  /**
+   * @brief	Returns number of messages in this batch
+   */
+  size_t size() const { return num; };
+
+  /**
+   *
+   */
+  const uint8_t *get_wire() const { return wire.somem(); };
+
+public:
+  friend std::ostream &operator<<(std::ostream &os,
+                                  const cofmsg_flow_mod_batch &msg) {
+    os << "<cofmsg_flow_mod_batch #msgs: " << msg.size() << " >" << std::endl;
+    { os << dynamic_cast<const cofmsg &>(msg); };
+    return os;
+  };
+
+  std::string str() const {
+    std::stringstream ss;
+    ss << cofmsg::str() << "-Flow-Mod-Batch- #msgs: " << num
+       << " bytes: " << wirelen << " ";
+    return ss.str();
+  };
+
+private:
+  uint8_t *append(uint8_t type, uint32_t xid, size_t msglen);
+
+private:
+  // packed messages, zero-filled beyond wirelen
+  rofl::cmemory wire;
+  // bytes used in wire
+  size_t wirelen;
+  // number of messages
+  size_t num;
+  // batch ends with a Barrier-Request
+  bool barrier;
+  // xid of the trailing Barrier-Request
+  uint32_t barrier_xid;
+};
+
+/**
+ * @brief	Returns msg as flow-mod batch or nullptr
+ *
+ * Checks the message type first, RTTI is used for Flow-Mods only.
+ */
+inline cofmsg_flow_mod_batch *flow_mod_batch_cast(cofmsg *msg) {
+  if (msg->get_type() != rofl::openflow::OFPT_FLOW_MOD)
+    return nullptr;
+  return dynamic_cast<cofmsg_flow_mod_batch *>(msg);
+}
+
 } // end of namespace openflow
 } // end of namespace rofl
 
@@ -19,24 +19,27 @@ const size_t rofl::openflow::cofmsg_packet_in::OFP13_PACKET_IN_STATIC_HDR_LEN =
 size_t cofmsg_packet_in::length() const {
   switch (get_version()) {
   case rofl::openflow10::OFP_VERSION: {
-    return (OFP10_PACKET_IN_STATIC_HDR_LEN + packet.length());
+    return (OFP10_PACKET_IN_STATIC_HDR_LEN + get_framelen());
 
   } break;
   case rofl::openflow12::OFP_VERSION: {
-    return (OFP12_PACKET_IN_STATIC_HDR_LEN + match.length() +
+    return (OFP12_PACKET_IN_STATIC_HDR_LEN + match_length() +
             2 /* bytes padding */
-            + packet.length());
+            + get_framelen());
   } break;
   default: {
-    return (OFP13_PACKET_IN_STATIC_HDR_LEN + match.length() +
+    return (OFP13_PACKET_IN_STATIC_HDR_LEN + match_length() +
             2 /* bytes padding */
-            + packet.length());
+            + get_framelen());
   };
   }
   return 0;
 }
 
 void cofmsg_packet_in::pack(uint8_t *buf, size_t buflen) {
+  decode_match();
+  decode_packet();
+
   cofmsg::pack(buf, buflen);
 
   if ((0 == buf) || (0 == buflen))
@@ -110,6 +113,10 @@ void cofmsg_packet_in::unpack(uint8_t *buf, size_t buflen) {
   match.clear();
   match.set_version(get_version());
   packet.clear();
+  raw.resize(0);
+  raw_data_offset = 0;
+  match_decoded = true;
+  packet_decoded = true;
 
   if ((0 == buf) || (0 == buflen))
     return;
@@ -135,10 +142,7 @@ void cofmsg_packet_in::unpack(uint8_t *buf, size_t buflen) {
     table_id = 0;
     cookie = 0;
 
-    match.set_in_port(in_port);
-
-    packet.unpack(buf + OFP10_PACKET_IN_STATIC_HDR_LEN,
-                  buflen - OFP10_PACKET_IN_STATIC_HDR_LEN);
+    raw_data_offset = OFP10_PACKET_IN_STATIC_HDR_LEN;
 
   } break;
   case rofl::openflow12::OFP_VERSION: {
@@ -172,17 +176,23 @@ void cofmsg_packet_in::unpack(uint8_t *buf, size_t buflen) {
       throw eBadRequestBadLen("eBadRequestBadLen", __FILE__, __FUNCTION__,
                               __LINE__);
 
-    match.unpack((uint8_t *)&(hdr->match), be16toh(hdr->match.length));
-
-    /* set data and datalen variables */
-    uint16_t offset =
-        OFP12_PACKET_IN_STATIC_HDR_LEN + match.length() + 2; // +2: magic :)
+    /* set data and datalen variables, match length includes padding */
+    size_t offset = OFP12_PACKET_IN_STATIC_HDR_LEN +
+                    ((be16toh(hdr->match.length) + 7) & ~7) + 2; // +2: magic :)
 
     if (offset > buflen)
       throw eBadRequestBadLen("eBadRequestBadLen", __FILE__, __FUNCTION__,
                               __LINE__);
 
-    packet.unpack((uint8_t *)(buf + offset), buflen - offset);
+    /* check the OXM TLVs now, the match itself is decoded on demand */
+    if (be16toh(hdr->match.length) < 2 * sizeof(uint16_t))
+      throw eBadMatchBadLen("eBadMatchBadLen", __FILE__, __FUNCTION__,
+                            __LINE__);
+
+    coxmatches::validate(hdr->match.oxm_fields,
+                         be16toh(hdr->match.length) - 2 * sizeof(uint16_t));
+
+    raw_data_offset = offset;
 
   } break;
   default: {
@@ -216,17 +226,209 @@ void cofmsg_packet_in::unpack(uint8_t *buf, size_t buflen) {
       throw eBadRequestBadLen("eBadRequestBadLen", __FILE__, __FUNCTION__,
                               __LINE__);
 
-    match.unpack((uint8_t *)&(hdr->match), be16toh(hdr->match.length));
-
-    /* set data and datalen variables */
-    uint16_t offset =
-        OFP13_PACKET_IN_STATIC_HDR_LEN + match.length() + 2; // +2: magic :)
+    /* set data and datalen variables, match length includes padding */
+    size_t offset = OFP13_PACKET_IN_STATIC_HDR_LEN +
+                    ((be16toh(hdr->match.length) + 7) & ~7) + 2; // +2: magic :)
 
     if (offset > buflen)
       throw eBadRequestBadLen("eBadRequestBadLen", __FILE__, __FUNCTION__,
                               __LINE__);
 
-    packet.unpack((uint8_t *)(buf + offset), buflen - offset);
+    /* check the OXM TLVs now, the match itself is decoded on demand */
+    if (be16toh(hdr->match.length) < 2 * sizeof(uint16_t))
+      throw eBadMatchBadLen("eBadMatchBadLen", __FILE__, __FUNCTION__,
+                            __LINE__);
+
+    coxmatches::validate(hdr->match.oxm_fields,
+                         be16toh(hdr->match.length) - 2 * sizeof(uint16_t));
+
+    raw_data_offset = offset;
+  };
+  }
+
+  /* keep a copy of the message, match and packet are decoded on demand */
+  raw.assign(buf, buflen);
+  match_decoded = false;
+  packet_decoded = false;
+}
+
+uint32_t cofmsg_packet_in::get_match_in_port() const {
+  if (match_decoded) {
+    return match.get_in_port();
+  }
+
+  switch (get_version()) {
+  case rofl::openflow10::OFP_VERSION: {
+    return in_port;
+  } break;
+  default: {
+    /* raw is released by a concurrent decode */
+    std::lock_guard<std::mutex> lock(decode_lock);
+    if (match_decoded) {
+      return match.get_in_port();
+    }
+
+    struct rofl::openflow13::ofp_match *m =
+        (struct rofl::openflow13::ofp_match *)raw_match();
+
+    uint8_t *oxm = m->oxm_fields;
+    size_t oxmlen = be16toh(m->length);
+    oxmlen = (oxmlen > 2 * sizeof(uint16_t)) ? oxmlen - 2 * sizeof(uint16_t)
+                                             : 0;
+
+    while (oxmlen >= sizeof(struct rofl::openflow::ofp_oxm_hdr)) {
+      struct rofl::openflow::ofp_oxm_tlv_hdr *tlv =
+          (struct rofl::openflow::ofp_oxm_tlv_hdr *)oxm;
+      uint32_t oxm_id = be32toh(tlv->oxm_id);
+      size_t tlvlen =
+          sizeof(struct rofl::openflow::ofp_oxm_hdr) + (oxm_id & 0x000000ff);
+      if (tlvlen > oxmlen) {
+        break;
+      }
+      if (((oxm_id & 0xfffffe00) ==
+           (rofl::openflow::OXM_TLV_BASIC_IN_PORT & 0xfffffe00)) &&
+          ((oxm_id & 0x000000ff) >= sizeof(uint32_t))) {
+        uint32_t value;
+        memcpy(&value, tlv->data, sizeof(value));
+        return be32toh(value);
+      }
+      oxm += tlvlen;
+      oxmlen -= tlvlen;
+    }
+  };
+  }
+
+  throw eOxmInval("cofmsg_packet_in::get_match_in_port() not found");
+}
+
+void cofmsg_packet_in::decode_match() const {
+  if (match_decoded) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(decode_lock);
+  if (match_decoded) {
+    return;
+  }
+
+  match.clear();
+  match.set_version(get_version());
+
+  switch (get_version()) {
+  case rofl::openflow10::OFP_VERSION: {
+    match.set_in_port(in_port);
+  } break;
+  default: {
+    struct rofl::openflow13::ofp_match *m =
+        (struct rofl::openflow13::ofp_match *)raw_match();
+    try {
+      match.unpack((uint8_t *)m, be16toh(m->length));
+    } catch (...) {
+      /* unpack() validated the TLVs already, so this is not expected;
+       * drop the partially decoded match, raw remains authoritative */
+      match.clear();
+      throw;
+    }
   };
   }
+
+  match_decoded = true;
+  release_raw();
+}
+
+void cofmsg_packet_in::decode_packet() const {
+  if (packet_decoded) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(decode_lock);
+  if (packet_decoded) {
+    return;
+  }
+
+  packet.unpack(raw.somem() + raw_data_offset, raw.length() - raw_data_offset);
+
+  packet_decoded = true;
+  release_raw();
+}
+
+void cofmsg_packet_in::release_raw() const {
+  if (match_decoded && packet_decoded) {
+    raw.resize(0);
+  }
+}
+
+size_t cofmsg_packet_in::match_length() const {
+  if (match_decoded) {
+    return match.length();
+  }
+  switch (get_version()) {
+  case rofl::openflow10::OFP_VERSION: {
+    return sizeof(struct rofl::openflow10::ofp_match);
+  } break;
+  default: {
+    std::lock_guard<std::mutex> lock(decode_lock);
+    if (match_decoded) {
+      return match.length();
+    }
+    struct rofl::openflow13::ofp_match *m =
+        (struct rofl::openflow13::ofp_match *)raw_match();
+    return ((be16toh(m->length) + 7) & ~7);
+  };
+  }
+}
+
+uint8_t *cofmsg_packet_in::raw_match() const {
+  switch (get_version()) {
+  case rofl::openflow12::OFP_VERSION: {
+    return raw.somem() + OFP12_PACKET_IN_STATIC_HDR_LEN;
+  } break;
+  default: { return raw.somem() + OFP13_PACKET_IN_STATIC_HDR_LEN; };
+  }
+}
+
+cofmsg_packet_in_shared::cofmsg_packet_in_shared(
+    uint32_t xid, const std::shared_ptr<const rofl::cmemory> &wire)
+    : cofmsg(wire->length() ? wire->somem()[0] : 0,
+             rofl::openflow::OFPT_PACKET_IN, xid),
+      wire(wire) {
+  if (wire->length() < sizeof(struct rofl::openflow::ofp_header))
+    throw eInvalid("eInvalid", __FILE__, __FUNCTION__, __LINE__);
+}
+
+/*static*/ std::shared_ptr<const rofl::cmemory>
+cofmsg_packet_in_shared::make_wire(rofl::openflow::cofmsg_packet_in &msg) {
+  std::shared_ptr<rofl::cmemory> wire = std::make_shared<rofl::cmemory>(
+      msg.length(), rofl::cmemory::INIT_UNINITIALIZED);
+  msg.pack(wire->somem(), wire->length());
+  return wire;
+}
+
+void cofmsg_packet_in_shared::pack(uint8_t *buf, size_t buflen) {
+  if ((0 == buf) || (0 == buflen)) {
+    cofmsg::pack(buf, buflen);
+    return;
+  }
+
+  if (buflen < length())
+    throw eInvalid("eInvalid", __FILE__, __FUNCTION__, __LINE__);
+
+  struct iovec payload;
+  size_t headlen = pack_head(buf, buflen, payload);
+  memcpy(buf + headlen, payload.iov_base, payload.iov_len);
+}
+
+size_t cofmsg_packet_in_shared::pack_head(uint8_t *buf, size_t buflen,
+                                          struct iovec &payload) {
+  size_t headlen = sizeof(struct rofl::openflow::ofp_header);
+
+  if (buflen < headlen)
+    throw eInvalid("eInvalid", __FILE__, __FUNCTION__, __LINE__);
+
+  cofmsg::pack(buf, headlen);
+
+  payload.iov_base = wire->somem() + headlen;
+  payload.iov_len = wire->length() - headlen;
+
+  return headlen;
 }
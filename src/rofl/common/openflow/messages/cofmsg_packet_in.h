@@ -8,6 +8,11 @@
 #ifndef COFMSG_PACKET_IN_H_
 #define COFMSG_PACKET_IN_H_ 1
 
+#include <atomic>
+#include <memory>
+#include <mutex>
+
+#include "rofl/common/cmemory.h"
 #include "rofl/common/cpacket.h"
 #include "rofl/common/openflow/cofmatch.h"
 #include "rofl/common/openflow/messages/cofmsg.h"
@@ -37,7 +42,8 @@ public:
       : cofmsg(version, rofl::openflow::OFPT_PACKET_IN, xid),
         buffer_id(buffer_id), total_len(total_len), in_port(in_port),
         reason(reason), table_id(table_id), cookie(cookie), match(match),
-        packet(data, datalen) {
+        packet(data, datalen), raw_data_offset(0), match_decoded(true),
+        packet_decoded(true) {
     this->match.set_version(version);
   };
 
@@ -61,6 +67,10 @@ public:
     cookie = msg.cookie;
     match = msg.match;
     packet = msg.packet;
+    raw = msg.raw;
+    raw_data_offset = msg.raw_data_offset;
+    match_decoded = msg.match_decoded.load();
+    packet_decoded = msg.packet_decoded.load();
     return *this;
   };
 
@@ -142,26 +152,105 @@ public:
   void set_cookie(uint64_t cookie) { this->cookie = cookie; };
 
   /**
+   * @brief	Returns the match, decoding it from the received message on
+   * first access
    *
+   * Concurrent readers may call this on a shared message, the first one
+   * decodes the match under decode_lock.
    */
-  const rofl::openflow::cofmatch &get_match() const { return match; };
+  const rofl::openflow::cofmatch &get_match() const {
+    decode_match();
+    return match;
+  };
 
   /**
    *
    */
-  rofl::openflow::cofmatch &set_match() { return match; };
+  rofl::openflow::cofmatch &set_match() {
+    decode_match();
+    return match;
+  };
+
+  /**
+   * @brief	Returns the frame, copying it from the received message on
+   * first access
+   */
+  const rofl::cpacket &get_packet() const {
+    decode_packet();
+    return packet;
+  };
 
   /**
    *
    */
-  const rofl::cpacket &get_packet() const { return packet; };
+  rofl::cpacket &set_packet() {
+    decode_packet();
+    return packet;
+  };
 
+public:
   /**
+   * @brief	Returns the ingress port without decoding the entire match
    *
+   * For OpenFlow 1.2 and later the OXM TLVs of a received message are
+   * scanned in place for the in_port field.
+   *
+   * @throws eOxmInval if the match contains no in_port field
    */
-  rofl::cpacket &set_packet() { return packet; };
+  uint32_t get_match_in_port() const;
+
+  /**
+   * @brief	Returns a read-only pointer to the start of the frame
+   *
+   * The pointer refers to the received message until the frame is accessed
+   * via get_packet() or set_packet(), by any thread. The received message
+   * is released once both match and frame are decoded, which invalidates
+   * pointers obtained before.
+   */
+  const uint8_t *get_frame() const {
+    if (packet_decoded) {
+      return packet.soframe();
+    }
+    return raw.somem() + raw_data_offset;
+  };
+
+  /**
+   * @brief	Returns the length of the frame in bytes
+   */
+  size_t get_framelen() const {
+    if (packet_decoded) {
+      return packet.length();
+    }
+    return raw.length() - raw_data_offset;
+  };
 
 private:
+  /**
+   *
+   */
+  void decode_match() const;
+
+  /**
+   *
+   */
+  void decode_packet() const;
+
+  /**
+   * @brief	Frees raw once match and frame are decoded, called with
+   * decode_lock held
+   */
+  void release_raw() const;
+
+  /**
+   *
+   */
+  size_t match_length() const;
+
+  /**
+   * @brief	Returns pointer to struct ofp_match within raw (OFP 1.2 and later)
+   */
+  uint8_t *raw_match() const;
+
   /**
    *
    */
@@ -241,8 +330,8 @@ public:
          << std::endl;
     } break;
     }
-    os << msg.match;
-    os << msg.packet;
+    os << msg.get_match();
+    os << msg.get_packet();
     return os;
   };
 
@@ -267,14 +356,91 @@ private:
   uint8_t reason;
   uint8_t table_id; // since OFP 1.2
   uint64_t cookie;  // since OFP 1.3
-  rofl::openflow::cofmatch match;
-  rofl::cpacket packet;
+  mutable rofl::openflow::cofmatch match;
+  mutable rofl::cpacket packet;
+
+  // received message, match and packet are decoded from it on first access,
+  // kept until the next unpack() as get_frame() may still point into it
+  mutable rofl::cmemory raw;
+  // offset of the frame within raw
+  size_t raw_data_offset;
+  // true when match or packet are valid and take precedence over raw
+  mutable std::atomic<bool> match_decoded;
+  mutable std::atomic<bool> packet_decoded;
+  // serializes decoding by concurrent readers of a const message
+  mutable std::mutex decode_lock;
 
   static const size_t OFP10_PACKET_IN_STATIC_HDR_LEN;
   static const size_t OFP12_PACKET_IN_STATIC_HDR_LEN;
   static const size_t OFP13_PACKET_IN_STATIC_HDR_LEN;
 };
 
+/**
+ * @brief	Packet-In referencing a message packed once for several receivers
+ *
+ * A datapath sending the same Packet-In to several controllers packs it
+ * once per OpenFlow version via make_wire(). Each controller queues its own
+ * cofmsg_packet_in_shared referencing this wire image, so only the xid in
+ * the OpenFlow header differs between messages. crofsock writes the header
+ * and sends the remainder of the wire image without copying it.
+ */
+class cofmsg_packet_in_shared : public cofmsg {
+public:
+  /**
+   *
+   */
+  virtual ~cofmsg_packet_in_shared(){};
+
+  /**
+   * @exception eInvalid wire image shorter than an OpenFlow header
+   */
+  cofmsg_packet_in_shared(uint32_t xid,
+                          const std::shared_ptr<const rofl::cmemory> &wire);
+
+public:
+  /**
+   * @brief	Packs msg into a wire image to be shared by several messages
+   */
+  static std::shared_ptr<const rofl::cmemory>
+  make_wire(rofl::openflow::cofmsg_packet_in &msg);
+
+public:
+  /**
+   *
+   */
+  virtual size_t length() const { return wire->length(); };
+
+  /**
+   *
+   */
+  virtual void pack(uint8_t *buf = (uint8_t *)0, size_t buflen = 0);
+
+  /**
+   * @brief	Packs the OpenFlow header, the wire image body is left as payload
+   */
+  virtual size_t pack_head(uint8_t *buf, size_t buflen, struct iovec &payload);
+
+public:
+  /**
+   *
+   */
+  const std::shared_ptr<const rofl::cmemory> &get_wire() const {
+    return wire;
+  };
+
+public:
+  std::string str() const {
+    std::stringstream ss;
+    ss << cofmsg::str() << "-Packet-In-shared- ";
+    ss << "references: " << wire.use_count() << ", ";
+    return ss.str();
+  };
+
+private:
+  // packed Packet-In including its OpenFlow header
+  std::shared_ptr<const rofl::cmemory> wire;
+};
+
 } // end of namespace openflow
 } // end of namespace rofl
 
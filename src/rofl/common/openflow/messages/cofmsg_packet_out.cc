@@ -3,27 +3,48 @@
 using namespace rofl::openflow;
 
 size_t cofmsg_packet_out::length() const {
+  size_t framelen = frame ? frame->length() : 0;
   switch (get_version()) {
   case rofl::openflow10::OFP_VERSION: {
     return (sizeof(struct rofl::openflow10::ofp_packet_out) + actions.length() +
-            packet.length());
+            packet.length() + framelen);
   } break;
   default: {
     return (sizeof(struct rofl::openflow12::ofp_packet_out) + actions.length() +
-            packet.length());
+            packet.length() + framelen);
   };
   }
 }
 
 void cofmsg_packet_out::pack(uint8_t *buf, size_t buflen) {
-  cofmsg::pack(buf, buflen);
-
-  if ((0 == buf) || (0 == buflen))
+  if ((0 == buf) || (0 == buflen)) {
+    cofmsg::pack(buf, buflen);
     return;
+  }
+
+  if (buflen < length())
+    throw eInvalid("eInvalid", __FILE__, __FUNCTION__, __LINE__);
+
+  struct iovec payload;
+  size_t headlen = pack_head(buf, buflen, payload);
+  if (payload.iov_len > 0) {
+    memcpy(buf + headlen, payload.iov_base, payload.iov_len);
+  }
+}
+
+size_t cofmsg_packet_out::pack_head(uint8_t *buf, size_t buflen,
+                                    struct iovec &payload) {
+  size_t framelen = frame ? frame->length() : 0;
+  size_t headlen = length() - framelen;
 
-  if (buflen < get_length())
+  payload.iov_base = framelen ? frame->somem() : nullptr;
+  payload.iov_len = framelen;
+
+  if (buflen < headlen)
     throw eInvalid("eInvalid", __FILE__, __FUNCTION__, __LINE__);
 
+  cofmsg::pack(buf, headlen);
+
   switch (get_version()) {
   case rofl::openflow10::OFP_VERSION: {
 
@@ -65,6 +86,8 @@ void cofmsg_packet_out::pack(uint8_t *buf, size_t buflen) {
     }
   };
   }
+
+  return headlen;
 }
 
 void cofmsg_packet_out::unpack(uint8_t *buf, size_t buflen) {
@@ -73,6 +96,7 @@ void cofmsg_packet_out::unpack(uint8_t *buf, size_t buflen) {
   actions.clear();
   actions.set_version(get_version());
   packet.clear();
+  frame.reset();
 
   if ((0 == buf) || (0 == buflen))
     return;
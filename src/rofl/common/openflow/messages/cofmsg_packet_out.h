@@ -8,6 +8,9 @@
 #ifndef COFMSG_PACKET_OUT_H_
 #define COFMSG_PACKET_OUT_H_ 1
 
+#include <memory>
+
+#include "rofl/common/cmemory.h"
 #include "rofl/common/cpacket.h"
 #include "rofl/common/openflow/cofactions.h"
 #include "rofl/common/openflow/messages/cofmsg.h"
@@ -37,6 +40,17 @@ public:
         buffer_id(buffer_id), in_port(in_port), actions(actions),
         packet(data, datalen){};
 
+  /**
+   * @brief	Packet-Out referencing frame instead of copying it
+   */
+  cofmsg_packet_out(uint8_t version, uint32_t xid, uint32_t buffer_id,
+                    uint32_t in_port,
+                    const rofl::openflow::cofactions &actions,
+                    const std::shared_ptr<const rofl::cmemory> &frame)
+      : cofmsg(version, rofl::openflow::OFPT_PACKET_OUT, xid),
+        buffer_id(buffer_id), in_port(in_port), actions(actions),
+        frame(frame){};
+
   /**
    *
    */
@@ -53,6 +67,7 @@ public:
     in_port = msg.in_port;
     actions = msg.actions;
     packet = msg.packet;
+    frame = msg.frame;
     return *this;
   };
 
@@ -67,6 +82,11 @@ public:
    */
   virtual void pack(uint8_t *buf = (uint8_t *)0, size_t buflen = 0);
 
+  /**
+   * @brief	Packs header, actions and packet, the frame is left as payload
+   */
+  virtual size_t pack_head(uint8_t *buf, size_t buflen, struct iovec &payload);
+
   /**
    *
    */
@@ -113,6 +133,20 @@ public:
    */
   rofl::cpacket &set_packet() { return packet; };
 
+  /**
+   * @brief	Frame sent after the packet without being copied, may be empty
+   */
+  const std::shared_ptr<const rofl::cmemory> &get_frame() const {
+    return frame;
+  };
+
+  /**
+   * @brief	Sets frame, which must not be modified until the message is sent
+   */
+  void set_frame(const std::shared_ptr<const rofl::cmemory> &frame) {
+    this->frame = frame;
+  };
+
 public:
   friend std::ostream &operator<<(std::ostream &os,
                                   cofmsg_packet_out const &msg) {
@@ -142,6 +176,7 @@ private:
   uint32_t in_port;
   rofl::openflow::cofactions actions;
   rofl::cpacket packet;
+  std::shared_ptr<const rofl::cmemory> frame;
 };
 
 } // end of namespace openflow
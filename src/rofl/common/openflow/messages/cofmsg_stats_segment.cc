@@ -0,0 +1,113 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "rofl/common/openflow/messages/cofmsg_stats_segment.h"
+
+using namespace rofl::openflow;
+
+cofmsg_stats_request_segment::~cofmsg_stats_request_segment() {}
+
+cofmsg_stats_request_segment::cofmsg_stats_request_segment(
+    uint8_t version, uint32_t xid, uint16_t stats_type, uint16_t stats_flags)
+    : cofmsg_stats_request(version, xid, stats_type, stats_flags) {}
+
+cofmsg_stats_request_segment::cofmsg_stats_request_segment(
+    const cofmsg_stats_request_segment &msg) {
+  *this = msg;
+}
+
+cofmsg_stats_request_segment &cofmsg_stats_request_segment::
+operator=(const cofmsg_stats_request_segment &msg) {
+  if (this == &msg)
+    return *this;
+  cofmsg_stats_request::operator=(msg);
+  body = msg.body;
+  return *this;
+}
+
+size_t cofmsg_stats_request_segment::length() const {
+  return (cofmsg_stats_request::length() + body.length());
+}
+
+void cofmsg_stats_request_segment::pack(uint8_t *buf, size_t buflen) {
+  cofmsg_stats_request::pack(buf, buflen); // copies common statistics header
+
+  if ((0 == buf) || (0 == buflen))
+    return;
+
+  if (buflen < cofmsg_stats_request_segment::length())
+    throw eInvalid("eInvalid", __FILE__, __FUNCTION__, __LINE__);
+
+  if (not body.empty()) {
+    memcpy(buf + cofmsg_stats_request::length(), body.somem(), body.length());
+  }
+}
+
+void cofmsg_stats_request_segment::unpack(uint8_t *buf, size_t buflen) {
+  cofmsg_stats_request::unpack(buf, buflen);
+
+  body.resize(0);
+
+  if ((0 == buf) || (0 == buflen))
+    return;
+
+  if (buflen > cofmsg_stats_request::length()) {
+    body.assign(buf + cofmsg_stats_request::length(),
+                buflen - cofmsg_stats_request::length());
+  }
+}
+
+cofmsg_stats_reply_segment::~cofmsg_stats_reply_segment() {}
+
+cofmsg_stats_reply_segment::cofmsg_stats_reply_segment(uint8_t version,
+                                                       uint32_t xid,
+                                                       uint16_t stats_type,
+                                                       uint16_t stats_flags)
+    : cofmsg_stats_reply(version, xid, stats_type, stats_flags) {}
+
+cofmsg_stats_reply_segment::cofmsg_stats_reply_segment(
+    const cofmsg_stats_reply_segment &msg) {
+  *this = msg;
+}
+
+cofmsg_stats_reply_segment &cofmsg_stats_reply_segment::
+operator=(const cofmsg_stats_reply_segment &msg) {
+  if (this == &msg)
+    return *this;
+  cofmsg_stats_reply::operator=(msg);
+  body = msg.body;
+  return *this;
+}
+
+size_t cofmsg_stats_reply_segment::length() const {
+  return (cofmsg_stats_reply::length() + body.length());
+}
+
+void cofmsg_stats_reply_segment::pack(uint8_t *buf, size_t buflen) {
+  cofmsg_stats_reply::pack(buf, buflen); // copies common statistics header
+
+  if ((0 == buf) || (0 == buflen))
+    return;
+
+  if (buflen < cofmsg_stats_reply_segment::length())
+    throw eInvalid("eInvalid", __FILE__, __FUNCTION__, __LINE__);
+
+  if (not body.empty()) {
+    memcpy(buf + cofmsg_stats_reply::length(), body.somem(), body.length());
+  }
+}
+
+void cofmsg_stats_reply_segment::unpack(uint8_t *buf, size_t buflen) {
+  cofmsg_stats_reply::unpack(buf, buflen);
+
+  body.resize(0);
+
+  if ((0 == buf) || (0 == buflen))
+    return;
+
+  if (buflen > cofmsg_stats_reply::length()) {
+    body.assign(buf + cofmsg_stats_reply::length(),
+                buflen - cofmsg_stats_reply::length());
+  }
+}
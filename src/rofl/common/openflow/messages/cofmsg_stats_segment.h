@@ -0,0 +1,276 @@
+/* This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+/*
+ * cofmsg_stats_segment.h
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef COFMSG_STATS_SEGMENT_H_
+#define COFMSG_STATS_SEGMENT_H_ 1
+
+#include <iterator>
+#include <list>
+#include <utility>
+#include <vector>
+
+#include "rofl/common/cmemory.h"
+#include "rofl/common/openflow/messages/cofmsg_stats.h"
+
+namespace rofl {
+namespace openflow {
+
+/**
+ * @brief	Segment of a multipart request carrying a pre-serialised body
+ */
+class cofmsg_stats_request_segment : public cofmsg_stats_request {
+public:
+  /**
+   *
+   */
+  virtual ~cofmsg_stats_request_segment();
+
+  /**
+   *
+   */
+  cofmsg_stats_request_segment(uint8_t version = 0, uint32_t xid = 0,
+                               uint16_t stats_type = 0,
+                               uint16_t stats_flags = 0);
+
+  /**
+   *
+   */
+  cofmsg_stats_request_segment(const cofmsg_stats_request_segment &msg);
+
+  /**
+   *
+   */
+  cofmsg_stats_request_segment &
+  operator=(const cofmsg_stats_request_segment &msg);
+
+public:
+  /**
+   *
+   */
+  virtual size_t length() const;
+
+  /**
+   *
+   */
+  virtual void pack(uint8_t *buf = (uint8_t *)0, size_t buflen = 0);
+
+  /**
+   *
+   */
+  virtual void unpack(uint8_t *buf, size_t buflen);
+
+public:
+  /**
+   *
+   */
+  const rofl::cmemory &get_body() const { return body; };
+
+  /**
+   * @brief	Resizes the body and returns a pointer to its start
+   */
+  uint8_t *resize_body(size_t len) { return body.resize(len); };
+
+public:
+  friend std::ostream &operator<<(std::ostream &os,
+                                  cofmsg_stats_request_segment const &msg) {
+    os << dynamic_cast<cofmsg_stats_request const &>(msg);
+    os << "<cofmsg_stats_request_segment body: " << msg.body.length()
+       << " bytes >" << std::endl;
+    return os;
+  };
+
+  virtual std::string str() const {
+    std::stringstream ss;
+    ss << cofmsg_stats_request::str() << "-Segment- body: " << body.length()
+       << " bytes ";
+    return ss.str();
+  };
+
+private:
+  rofl::cmemory body;
+};
+
+/**
+ * @brief	Segment of a multipart reply carrying a pre-serialised body
+ */
+class cofmsg_stats_reply_segment : public cofmsg_stats_reply {
+public:
+  /**
+   *
+   */
+  virtual ~cofmsg_stats_reply_segment();
+
+  /**
+   *
+   */
+  cofmsg_stats_reply_segment(uint8_t version = 0, uint32_t xid = 0,
+                             uint16_t stats_type = 0, uint16_t stats_flags = 0);
+
+  /**
+   *
+   */
+  cofmsg_stats_reply_segment(const cofmsg_stats_reply_segment &msg);
+
+  /**
+   *
+   */
+  cofmsg_stats_reply_segment &operator=(const cofmsg_stats_reply_segment &msg);
+
+public:
+  /**
+   *
+   */
+  virtual size_t length() const;
+
+  /**
+   *
+   */
+  virtual void pack(uint8_t *buf = (uint8_t *)0, size_t buflen = 0);
+
+  /**
+   *
+   */
+  virtual void unpack(uint8_t *buf, size_t buflen);
+
+public:
+  /**
+   *
+   */
+  const rofl::cmemory &get_body() const { return body; };
+
+  /**
+   * @brief	Resizes the body and returns a pointer to its start
+   */
+  uint8_t *resize_body(size_t len) { return body.resize(len); };
+
+public:
+  friend std::ostream &operator<<(std::ostream &os,
+                                  cofmsg_stats_reply_segment const &msg) {
+    os << dynamic_cast<cofmsg_stats_reply const &>(msg);
+    os << "<cofmsg_stats_reply_segment body: " << msg.body.length()
+       << " bytes >" << std::endl;
+    return os;
+  };
+
+  virtual std::string str() const {
+    std::stringstream ss;
+    ss << cofmsg_stats_reply::str() << "-Segment- body: " << body.length()
+       << " bytes ";
+    return ss.str();
+  };
+
+private:
+  rofl::cmemory body;
+};
+
+/**
+ * @brief	Splits a sequence of multipart entries into segments
+ *
+ * Entries are added one by one and serialised exactly once, straight into
+ * the body of the segment they belong to. The running length of the open
+ * segment is tracked incrementally, so splitting n entries takes O(n).
+ * A segment is closed when the next entry would exceed max_length, a single
+ * entry larger than max_length occupies a segment of its own.
+ *
+ * The entries must stay valid until get_segments() has been called.
+ */
+template <class segment_t, class entry_t> class cofmsg_stats_segmenter {
+public:
+  /**
+   *
+   */
+  ~cofmsg_stats_segmenter() {
+    for (auto segment : segments) {
+      delete segment;
+    }
+  };
+
+  /**
+   *
+   */
+  cofmsg_stats_segmenter(uint8_t version, uint32_t xid, uint16_t stats_type,
+                         uint16_t stats_flags, size_t max_length = 64000)
+      : version(version), xid(xid), stats_type(stats_type),
+        stats_flags(stats_flags), max_length(max_length), pending_length(0){};
+
+private:
+  cofmsg_stats_segmenter(const cofmsg_stats_segmenter &segmenter);
+
+  cofmsg_stats_segmenter &operator=(const cofmsg_stats_segmenter &segmenter);
+
+public:
+  /**
+   * @brief	Appends entry to the open segment
+   */
+  void add(entry_t &entry) {
+    size_t len = entry.length();
+    if ((not pending.empty()) && (pending_length + len > max_length)) {
+      flush();
+    }
+    pending.push_back(std::make_pair(&entry, len));
+    pending_length += len;
+  };
+
+  /**
+   * @brief	Closes the open segment and hands out all segments
+   *
+   * The MORE flag is set on all segments except the last one. The caller
+   * takes ownership of the returned messages.
+   */
+  std::list<segment_t *> get_segments(uint16_t more_flag) {
+    flush();
+    if (segments.empty()) {
+      segments.push_back(new segment_t(version, xid, stats_type, stats_flags));
+    }
+    std::list<segment_t *> result;
+    result.swap(segments);
+    for (auto it = result.begin(); it != result.end(); ++it) {
+      if (std::next(it) != result.end()) {
+        (*it)->set_stats_flags((*it)->get_stats_flags() | more_flag);
+      }
+    }
+    return result;
+  };
+
+private:
+  void flush() {
+    if (pending.empty()) {
+      return;
+    }
+    segment_t *segment = new segment_t(version, xid, stats_type, stats_flags);
+    uint8_t *buf = segment->resize_body(pending_length);
+    for (auto &it : pending) {
+      it.first->pack(buf, it.second);
+      buf += it.second;
+    }
+    segments.push_back(segment);
+    pending.clear();
+    pending_length = 0;
+  };
+
+private:
+  uint8_t version;
+  uint32_t xid;
+  uint16_t stats_type;
+  uint16_t stats_flags;
+  size_t max_length;
+
+  // entries of the open segment and their lengths
+  std::vector<std::pair<entry_t *, size_t>> pending;
+  size_t pending_length;
+
+  // closed segments
+  std::list<segment_t *> segments;
+};
+
+}; // end of namespace openflow
+}; // end of namespace rofl
+
+#endif /* COFMSG_STATS_SEGMENT_H_ */
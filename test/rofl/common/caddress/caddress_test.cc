@@ -1,8 +1,11 @@
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
 
+#include "../testutil.hpp"
 #include "caddress_test.h"
 
 CPPUNIT_TEST_SUITE_REGISTRATION(caddress_test);
@@ -11,6 +14,16 @@ CPPUNIT_TEST_SUITE_REGISTRATION(caddress_test);
 //#undef DEBUG
 #endif
 
+namespace {
+
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+}; // namespace
+
 void caddress_test::setUp() {}
 
 void caddress_test::tearDown() {}
@@ -99,3 +112,56 @@ void caddress_test::testAddressIn6() {
   CPPUNIT_ASSERT(masked < addr);
   CPPUNIT_ASSERT(addr > masked);
 }
+
+void caddress_test::testBenchmark() {
+  const unsigned int num = testutil::bench_size(1000000, 10000);
+
+  /* former allocation path of a 6 byte cmemory */
+  volatile uint8_t sink = 0;
+  double start = now();
+  for (unsigned int i = 0; i < num; i++) {
+    uint8_t *mem = (uint8_t *)calloc(1, 6);
+    memset(mem, 0, 6);
+    mem[i % 6] = i;
+    sink = sink + mem[5];
+    memset(mem, 0, 6);
+    free(mem);
+  }
+  double t_ref = now() - start;
+
+  rofl::cmemory::clear_stats();
+  start = now();
+  for (unsigned int i = 0; i < num; i++) {
+    rofl::caddress_ll addr(0x020000000000ULL + i);
+    rofl::caddress_ll copy(addr);
+    sink = sink + copy[5];
+  }
+  double t_ll = now() - start;
+
+  start = now();
+  for (unsigned int i = 0; i < num; i++) {
+    rofl::caddress_in4 addr;
+    addr.set_addr_hbo(0x0a000000 + i);
+    rofl::caddress_in4 copy(addr);
+    sink = sink + copy[3];
+  }
+  double t_in4 = now() - start;
+
+  rofl::caddress_in6 in6("a0a1:a2a3:a4a5:a6a7:a8a9:aaab:acad:aeaf");
+  start = now();
+  for (unsigned int i = 0; i < num; i++) {
+    rofl::caddress_in6 copy(in6);
+    sink = sink + copy[15];
+  }
+  double t_in6 = now() - start;
+
+  rofl::cmemory_stats stats = rofl::cmemory::get_stats();
+  std::cerr << "caddress: former 6 bytes: " << 1e9 * t_ref / num
+            << " ns ll+copy: " << 1e9 * t_ll / num
+            << " ns in4+copy: " << 1e9 * t_in4 / num
+            << " ns in6 copy: " << 1e9 * t_in6 / num << " ns " << stats
+            << std::endl;
+
+  CPPUNIT_ASSERT(stats.get_allocs() == 0);
+  CPPUNIT_ASSERT(stats.inline_allocs >= 5 * num);
+}
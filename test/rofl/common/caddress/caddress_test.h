@@ -9,6 +9,7 @@ class caddress_test : public CppUnit::TestFixture {
   CPPUNIT_TEST(testAddressLL);
   CPPUNIT_TEST(testAddressIn4);
   CPPUNIT_TEST(testAddressIn6);
+  CPPUNIT_TEST(testBenchmark);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -19,4 +20,5 @@ public:
   void testAddressLL();
   void testAddressIn4();
   void testAddressIn6();
+  void testBenchmark();
 };
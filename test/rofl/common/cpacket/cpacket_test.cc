@@ -1,8 +1,11 @@
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
 
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
 
+#include "../testutil.hpp"
 #include "cpacket_test.h"
 
 CPPUNIT_TEST_SUITE_REGISTRATION(cpacket_test);
@@ -11,6 +14,16 @@ CPPUNIT_TEST_SUITE_REGISTRATION(cpacket_test);
 #undef DEBUG
 #endif
 
+namespace {
+
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+}; // namespace
+
 void cpacket_test::setUp() {}
 
 void cpacket_test::tearDown() {}
@@ -34,3 +47,88 @@ void cpacket_test::test_push() {
 }
 
 void cpacket_test::test_pop() {}
+
+void cpacket_test::test_resize() {
+  uint8_t frame[4096];
+  for (unsigned int i = 0; i < sizeof(frame); i++) {
+    frame[i] = i % 251;
+  }
+
+  for (unsigned int attach = 0; attach < 2; attach++) {
+    if (attach)
+      rofl::cslab::thread_attach();
+
+    /* inline, slab or heap, and back */
+    rofl::cpacket p(frame, 8, 0, 0);
+    size_t lengths[] = {100, 1500, 4096, 50, 2000, 12};
+    size_t len = 8;
+    for (auto newlen : lengths) {
+      p.resize(newlen);
+      CPPUNIT_ASSERT(p.length() == newlen);
+      size_t kept = std::min(len, newlen);
+      CPPUNIT_ASSERT(memcmp(p.soframe(), frame, kept) == 0);
+      for (size_t i = kept; i < newlen; i++) {
+        CPPUNIT_ASSERT(p.soframe()[i] == 0);
+      }
+      memcpy(p.soframe(), frame, newlen);
+      len = newlen;
+    }
+
+    rofl::cpacket q(p);
+    CPPUNIT_ASSERT(q == p);
+    q.assign(frame, 1024);
+    CPPUNIT_ASSERT(memcmp(q.soframe(), frame, 1024) == 0);
+
+    if (attach)
+      rofl::cslab::thread_detach();
+  }
+}
+
+void cpacket_test::test_benchmark() {
+  const unsigned int num = testutil::bench_size(200000, 2000);
+  uint8_t frame[1500];
+  memset(frame, 0xa5, sizeof(frame));
+  size_t memlen = 64 + sizeof(frame) + 32;
+
+  /* former allocation path: calloc, memset, memcpy, memset on free */
+  volatile uint8_t sink = 0;
+  double start = now();
+  for (unsigned int i = 0; i < num; i++) {
+    uint8_t *mem = (uint8_t *)calloc(1, memlen);
+    memset(mem, 0, memlen);
+    memcpy(mem + 64, frame, sizeof(frame));
+    sink = sink + mem[64 + i % sizeof(frame)];
+    memset(mem, 0, memlen);
+    free(mem);
+  }
+  double t_ref = now() - start;
+
+  rofl::cmemory::clear_stats();
+  start = now();
+  for (unsigned int i = 0; i < num; i++) {
+    rofl::cpacket pkt(frame, sizeof(frame));
+  }
+  double t_heap = now() - start;
+  uint64_t allocs_heap = rofl::cmemory::get_stats().get_allocs();
+
+  rofl::cslab::thread_attach();
+  rofl::cmemory::clear_stats();
+  start = now();
+  for (unsigned int i = 0; i < num; i++) {
+    rofl::cpacket pkt(frame, sizeof(frame));
+  }
+  double t_slab = now() - start;
+  rofl::cmemory_stats stats = rofl::cmemory::get_stats();
+  rofl::cslab::thread_detach();
+
+  std::cerr << "cpacket 1500 bytes: former: " << 1e9 * t_ref / num
+            << " ns heap: " << 1e9 * t_heap / num
+            << " ns slab: " << 1e9 * t_slab / num << " ns" << std::endl
+            << "allocs per packet: heap: " << (double)allocs_heap / num
+            << " slab: " << (double)stats.slab_allocs / num
+            << " heap-allocs with slab: " << stats.heap_allocs << std::endl;
+
+  CPPUNIT_ASSERT(allocs_heap == num);
+  CPPUNIT_ASSERT(stats.slab_allocs == num);
+  CPPUNIT_ASSERT(stats.heap_allocs == 0);
+}
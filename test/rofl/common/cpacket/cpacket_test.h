@@ -1,4 +1,5 @@
 #include "rofl/common/cpacket.h"
+#include "rofl/common/cslab.hpp"
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 
@@ -7,6 +8,8 @@ class cpacket_test : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(cpacket_test);
   CPPUNIT_TEST(test_push);
   CPPUNIT_TEST(test_pop);
+  CPPUNIT_TEST(test_resize);
+  CPPUNIT_TEST(test_benchmark);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -16,4 +19,6 @@ public:
 
   void test_push();
   void test_pop();
+  void test_resize();
+  void test_benchmark();
 };
@@ -5,17 +5,340 @@
  *      Author: andi
  */
 
+#include <dirent.h>
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
 #include <stdlib.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <mutex>
+#include <set>
+#include <vector>
 
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
 
+#include "../testutil.hpp"
 #include "crofbasetest.hpp"
 
 using namespace rofl;
 
 CPPUNIT_TEST_SUITE_REGISTRATION(crofbasetest);
 
+namespace {
+
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* bookkeeping done by crofbase for a newly established main connection */
+rofl::cdptid attach(rofl::crofbase &base, const rofl::cdpid &dpid) {
+  return base.set_dpt(dpid).set_dpid(dpid).get_dptid();
+}
+
+/* minimal OpenFlow 1.3 switch: completes the handshake, counts Flow-Mods
+ * and answers Echo- and Barrier-Requests, stops reading while replies are
+ * held */
+struct stub_switch {
+  int sd;
+  uint64_t dpid;
+  std::atomic_bool keep_running;
+  std::atomic_bool hold_replies;
+  std::atomic_uint num_flow_mods;
+  std::atomic_uint num_barriers;
+  // Flow-Stats-Reply segment sent num_flow_stats_segments times per request
+  const std::vector<uint8_t> *flow_stats_segment;
+  unsigned int num_flow_stats_segments;
+  // omit the final segment
+  std::atomic_bool flow_stats_stall;
+};
+
+void stub_switch_send(stub_switch *sw, uint8_t *buf, size_t buflen) {
+  size_t sent = 0;
+  while (sent < buflen) {
+    ssize_t rc = send(sw->sd, buf + sent, buflen - sent, MSG_NOSIGNAL);
+    if (rc <= 0)
+      return;
+    sent += rc;
+  }
+}
+
+void stub_switch_reply(stub_switch *sw, uint8_t type, uint32_t xid) {
+  struct rofl::openflow13::ofp_switch_features msg;
+  size_t len = sizeof(struct rofl::openflow::ofp_header);
+  memset(&msg, 0, sizeof(msg));
+  if (type == rofl::openflow13::OFPT_FEATURES_REPLY) {
+    len = sizeof(msg);
+    msg.datapath_id = htobe64(sw->dpid);
+    msg.n_tables = 1;
+  }
+  msg.header.version = rofl::openflow13::OFP_VERSION;
+  msg.header.type = type;
+  msg.header.length = htobe16(len);
+  msg.header.xid = htobe32(xid);
+  stub_switch_send(sw, (uint8_t *)&msg, len);
+}
+
+void *run_stub_switch(void *arg) {
+  stub_switch *sw = (stub_switch *)arg;
+  std::vector<uint8_t> buf(1 << 20);
+  size_t filled = 0;
+
+  stub_switch_reply(sw, rofl::openflow13::OFPT_HELLO, 1);
+
+  while (sw->keep_running) {
+    if (sw->hold_replies) {
+      usleep(1000);
+      continue;
+    }
+    ssize_t rc = recv(sw->sd, buf.data() + filled, buf.size() - filled, 0);
+    if (rc <= 0) {
+      if ((rc < 0) && ((errno == EAGAIN) || (errno == EINTR)))
+        continue;
+      break;
+    }
+    filled += rc;
+
+    size_t offset = 0;
+    while (filled - offset >= sizeof(struct rofl::openflow::ofp_header)) {
+      struct rofl::openflow::ofp_header *hdr =
+          (struct rofl::openflow::ofp_header *)(buf.data() + offset);
+      size_t len = be16toh(hdr->length);
+      if (filled - offset < len)
+        break;
+      switch (hdr->type) {
+      case rofl::openflow13::OFPT_FEATURES_REQUEST: {
+        stub_switch_reply(sw, rofl::openflow13::OFPT_FEATURES_REPLY,
+                          be32toh(hdr->xid));
+      } break;
+      case rofl::openflow13::OFPT_ECHO_REQUEST: {
+        stub_switch_reply(sw, rofl::openflow13::OFPT_ECHO_REPLY,
+                          be32toh(hdr->xid));
+      } break;
+      case rofl::openflow13::OFPT_FLOW_MOD: {
+        sw->num_flow_mods++;
+      } break;
+      case rofl::openflow13::OFPT_BARRIER_REQUEST: {
+        stub_switch_reply(sw, rofl::openflow13::OFPT_BARRIER_REPLY,
+                          be32toh(hdr->xid));
+        sw->num_barriers++;
+      } break;
+      case rofl::openflow13::OFPT_MULTIPART_REQUEST: {
+        if (sw->flow_stats_segment == nullptr)
+          break;
+        std::vector<uint8_t> segment(*(sw->flow_stats_segment));
+        struct rofl::openflow13::ofp_multipart_reply *reply =
+            (struct rofl::openflow13::ofp_multipart_reply *)segment.data();
+        reply->header.xid = hdr->xid;
+        for (unsigned int i = 0; i < sw->num_flow_stats_segments; i++) {
+          bool last = (i + 1 == sw->num_flow_stats_segments);
+          if (last && sw->flow_stats_stall)
+            break;
+          reply->flags =
+              htobe16(last ? 0 : rofl::openflow13::OFPMPF_REPLY_MORE);
+          stub_switch_send(sw, segment.data(), segment.size());
+        }
+      } break;
+      default: {};
+      }
+      offset += len;
+    }
+    memmove(buf.data(), buf.data() + offset, filled - offset);
+    filled -= offset;
+  }
+  return nullptr;
+}
+
+/* minimal OpenFlow 1.3 controller: completes the handshake, counts
+ * Packet-Ins and answers Echo-Requests */
+struct stub_controller {
+  int sd;
+  std::atomic_bool keep_running;
+  std::atomic_uint num_packet_ins;
+  std::atomic_uint num_bad_packet_ins;
+  uint32_t last_xid;
+  size_t packet_in_len;
+};
+
+void *run_stub_controller(void *arg) {
+  stub_controller *ctl = (stub_controller *)arg;
+  std::vector<uint8_t> buf(1 << 20);
+  size_t filled = 0;
+
+  stub_switch sw;
+  sw.sd = ctl->sd;
+  stub_switch_reply(&sw, rofl::openflow13::OFPT_HELLO, 1);
+
+  while (ctl->keep_running) {
+    ssize_t rc = recv(ctl->sd, buf.data() + filled, buf.size() - filled, 0);
+    if (rc <= 0) {
+      if ((rc < 0) && ((errno == EAGAIN) || (errno == EINTR)))
+        continue;
+      break;
+    }
+    filled += rc;
+
+    size_t offset = 0;
+    while (filled - offset >= sizeof(struct rofl::openflow::ofp_header)) {
+      struct rofl::openflow::ofp_header *hdr =
+          (struct rofl::openflow::ofp_header *)(buf.data() + offset);
+      size_t len = be16toh(hdr->length);
+      if (filled - offset < len)
+        break;
+      switch (hdr->type) {
+      case rofl::openflow13::OFPT_ECHO_REQUEST: {
+        stub_switch_reply(&sw, rofl::openflow13::OFPT_ECHO_REPLY,
+                          be32toh(hdr->xid));
+      } break;
+      case rofl::openflow13::OFPT_PACKET_IN: {
+        /* xids are assigned per controller in ascending order */
+        uint32_t xid = be32toh(hdr->xid);
+        if ((len != ctl->packet_in_len) || (xid <= ctl->last_xid)) {
+          ctl->num_bad_packet_ins++;
+        }
+        ctl->last_xid = xid;
+        ctl->num_packet_ins++;
+      } break;
+      default: {};
+      }
+      offset += len;
+    }
+    memmove(buf.data(), buf.data() + offset, filled - offset);
+    filled -= offset;
+  }
+  return nullptr;
+}
+
+bool wait_for(const std::atomic_uint &counter, unsigned int value,
+              double timeout) {
+  double start = now();
+  while ((counter < value) && (now() - start < timeout)) {
+    sched_yield();
+  }
+  return (counter >= value);
+}
+
+unsigned int num_open_fds() {
+  unsigned int num = 0;
+  DIR *dir = opendir("/proc/self/fd");
+  if (dir == nullptr)
+    return 0;
+  while (readdir(dir) != nullptr)
+    num++;
+  closedir(dir);
+  return num;
+}
+
+/* crofbase recording the threads serving its listening sockets */
+class accept_counting_base : public rofl::crofbase {
+public:
+  size_t get_num_accept_threads() {
+    std::lock_guard<std::mutex> lock(accept_threads_lock);
+    return accept_threads.size();
+  };
+
+protected:
+  virtual void handle_read_event(rofl::cthread &thread, int fd) {
+    {
+      std::lock_guard<std::mutex> lock(accept_threads_lock);
+      accept_threads.insert(thread.get_thread_num());
+    }
+    rofl::crofbase::handle_read_event(thread, fd);
+  };
+
+private:
+  std::mutex accept_threads_lock;
+  std::set<uint32_t> accept_threads;
+};
+
+size_t get_rss() {
+  long pages = 0, resident = 0;
+  FILE *fp = fopen("/proc/self/statm", "r");
+  if (fp == nullptr)
+    return 0;
+  if (fscanf(fp, "%ld %ld", &pages, &resident) != 2)
+    resident = 0;
+  fclose(fp);
+  return resident * sysconf(_SC_PAGESIZE);
+}
+
+/* Flow-Stats-Reply with num_entries entries, sent repeatedly by the stub
+ * switch */
+std::vector<uint8_t> make_flow_stats_segment(unsigned int num_entries) {
+  rofl::openflow::cofflowstatsarray array(rofl::openflow13::OFP_VERSION);
+  for (unsigned int i = 0; i < num_entries; i++) {
+    rofl::caddress_in4 ipv4_dst;
+    ipv4_dst.set_addr_hbo(0x0a000000 + i);
+    rofl::openflow::cofflow_stats_reply &stats = array.add_flow_stats(i);
+    stats.set_table_id(0);
+    stats.set_priority(0x8000);
+    stats.set_match().set_eth_type(0x0800);
+    stats.set_match().set_ipv4_dst(ipv4_dst);
+    stats.set_instructions()
+        .set_inst_apply_actions()
+        .set_actions()
+        .add_action_output(rofl::cindex(0))
+        .set_port_no(1);
+  }
+  rofl::openflow::cofmsg_flow_stats_reply msg(rofl::openflow13::OFP_VERSION, 0,
+                                              0, array);
+  std::vector<uint8_t> segment(msg.length());
+  msg.pack(segment.data(), segment.size());
+  return segment;
+}
+
+/* controller counting Flow-Stats entries of full and streamed replies */
+class flow_stats_controller : public rofl::crofbase {
+public:
+  flow_stats_controller()
+      : num_entries(0), num_replies(0), t_first(0), peak_rss(0){};
+
+  void reset() {
+    num_entries = 0;
+    num_replies = 0;
+    t_first = 0;
+    peak_rss = get_rss();
+  };
+
+  std::atomic_uint num_entries;
+  std::atomic_uint num_replies;
+  double t_first;
+  size_t peak_rss;
+
+private:
+  void entries_rcvd(const rofl::openflow::cofmsg_flow_stats_reply &msg) {
+    if (t_first == 0)
+      t_first = now();
+    peak_rss = std::max(peak_rss, get_rss());
+    num_entries += msg.get_flow_stats_array().size();
+  };
+
+  virtual void
+  handle_flow_stats_reply(rofl::crofdpt &dpt, const rofl::cauxid &auxid,
+                          rofl::openflow::cofmsg_flow_stats_reply &msg) {
+    entries_rcvd(msg);
+    num_replies++;
+  };
+
+  virtual void handle_flow_stats_reply_segment(
+      rofl::crofdpt &dpt, const rofl::cauxid &auxid,
+      rofl::openflow::cofmsg_flow_stats_reply &msg, bool last) {
+    entries_rcvd(msg);
+    if (last)
+      num_replies++;
+  };
+};
+
+}; // namespace
+
 void crofbasetest::setUp() {
   rofl::cthread::pool_initialize(/*#threads=*/16);
   datapath = new cdatapath();
@@ -43,6 +366,748 @@ void crofbasetest::test() {
   LOG(INFO) << std::endl;
 }
 
+void crofbasetest::test_dpid_index() {
+  rofl::crofbase base;
+
+  rofl::cdptid dptid1 = base.add_dpt().get_dptid();
+  CPPUNIT_ASSERT(not base.has_dpt(rofl::cdpid(0x1000)));
+  base.set_dpt(dptid1).set_dpid(0x1000);
+  CPPUNIT_ASSERT(base.has_dpt(rofl::cdpid(0x1000)));
+  CPPUNIT_ASSERT(base.set_dpt(rofl::cdpid(0x1000)).get_dptid() == dptid1);
+
+  /* dpid learned from a connection replaces the old one */
+  base.set_dpt(dptid1).set_dpid(0x2000);
+  CPPUNIT_ASSERT(not base.has_dpt(rofl::cdpid(0x1000)));
+  CPPUNIT_ASSERT(base.set_dpt(rofl::cdpid(0x2000)).get_dptid() == dptid1);
+
+  /* unknown dpid creates a new instance */
+  rofl::cdptid dptid2 = attach(base, 0x3000);
+  CPPUNIT_ASSERT(dptid2 != dptid1);
+  CPPUNIT_ASSERT(attach(base, 0x3000) == dptid2);
+  CPPUNIT_ASSERT(base.dpt_keys().size() == 2);
+
+  /* instances sharing a dpid resolve to the lowest dptid */
+  base.set_dpt(dptid2).set_dpid(0x2000);
+  CPPUNIT_ASSERT(base.set_dpt(rofl::cdpid(0x2000)).get_dptid() ==
+                 std::min(dptid1, dptid2));
+  base.set_dpt(dptid2).set_dpid(0x3000);
+
+  /* dropped instances leave the index, their dptids are not reused */
+  CPPUNIT_ASSERT(base.drop_dpt(dptid1));
+  CPPUNIT_ASSERT(not base.has_dpt(rofl::cdpid(0x2000)));
+  CPPUNIT_ASSERT(base.has_dpt(rofl::cdpid(0x3000)));
+  rofl::cdptid dptid3 = base.add_dpt().get_dptid();
+  CPPUNIT_ASSERT((dptid3 != dptid1) && (dptid3 != dptid2));
+
+  /* explicitly assigned dptids are skipped */
+  base.add_dpt(dptid3 + 1);
+  rofl::cdptid dptid4 = base.add_dpt().get_dptid();
+  CPPUNIT_ASSERT(dptid4 == dptid3 + 2);
+
+  base.drop_dpts();
+  CPPUNIT_ASSERT(not base.has_dpt(rofl::cdpid(0x3000)));
+
+  rofl::cctlid ctlid1 = base.add_ctl().get_ctlid();
+  rofl::cctlid ctlid2 = base.add_ctl().get_ctlid();
+  CPPUNIT_ASSERT(not(ctlid1 == ctlid2));
+  base.drop_ctl(ctlid1);
+  rofl::cctlid ctlid3 = base.add_ctl().get_ctlid();
+  CPPUNIT_ASSERT(not(ctlid3 == ctlid1) && not(ctlid3 == ctlid2));
+}
+
+void crofbasetest::test_attach_benchmark() {
+  std::vector<unsigned int> sizes = {500};
+  if (testutil::bench()) {
+    sizes = {500, 1000, 2000, 4000};
+  }
+  for (unsigned int num_dpts : sizes) {
+    rofl::crofbase base;
+
+    /* all switches attach at once */
+    double start = now();
+    for (unsigned int i = 0; i < num_dpts; i++) {
+      attach(base, 0x1000 + i);
+    }
+    double t_attach = now() - start;
+    CPPUNIT_ASSERT(base.dpt_keys().size() == num_dpts);
+
+    /* and reconnect after a controller restart */
+    base.drop_dpts();
+    start = now();
+    for (unsigned int i = 0; i < num_dpts; i++) {
+      attach(base, 0x1000 + i);
+    }
+    double t_reattach = now() - start;
+    CPPUNIT_ASSERT(base.dpt_keys().size() == num_dpts);
+
+    std::cerr << "attach " << num_dpts
+              << " datapaths: " << 1e6 * t_attach / num_dpts
+              << " us/dpt reattach: " << 1e6 * t_reattach / num_dpts
+              << " us/dpt" << std::endl;
+  }
+}
+
+double
+crofbasetest::run_accept_benchmark(rofl::crofbase::listen_mode_t listen_mode,
+                                   unsigned int num_clients,
+                                   size_t &num_accept_threads) {
+  rofl::openflow::cofhello_elem_versionbitmap vbitmap;
+  vbitmap.add_ofp_version(rofl::openflow13::OFP_VERSION);
+  rofl::csockaddr baddr(AF_INET, "127.0.0.1", testutil::free_port());
+
+  accept_counting_base *base = new accept_counting_base();
+  base->set_listen_mode(listen_mode).set_listen_backlog(SOMAXCONN);
+  base->set_versionbitmap(vbitmap);
+  base->dpt_sock_listen(baddr);
+  unsigned int num_fds = num_open_fds();
+
+  int epfd = epoll_create1(0);
+  CPPUNIT_ASSERT(epfd >= 0);
+  std::vector<int> clients;
+
+  /* all clients connect at once, a connection counts as accepted once the
+   * HELLO message from crofbase has been received */
+  double start = now();
+  for (unsigned int i = 0; i < num_clients; i++) {
+    int sd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    CPPUNIT_ASSERT(sd >= 0);
+    int rc = connect(sd, baddr.ca_saddr, baddr.salen);
+    CPPUNIT_ASSERT((rc == 0) || (errno == EINPROGRESS));
+    struct epoll_event epev;
+    memset(&epev, 0, sizeof(epev));
+    epev.events = EPOLLIN;
+    epev.data.fd = sd;
+    CPPUNIT_ASSERT(epoll_ctl(epfd, EPOLL_CTL_ADD, sd, &epev) == 0);
+    clients.push_back(sd);
+  }
+
+  unsigned int num_accepted = 0;
+  struct epoll_event events[256];
+  while ((num_accepted < num_clients) && (now() - start < 60)) {
+    int num = epoll_wait(epfd, events, 256, 100);
+    for (int i = 0; i < num; i++) {
+      uint8_t buf[64];
+      if (recv(events[i].data.fd, buf, sizeof(buf), 0) > 0) {
+        num_accepted++;
+      }
+      epoll_ctl(epfd, EPOLL_CTL_DEL, events[i].data.fd, NULL);
+    }
+  }
+  double t_accept = now() - start;
+  CPPUNIT_ASSERT(num_accepted == num_clients);
+
+  num_accept_threads = base->get_num_accept_threads();
+
+  for (auto sd : clients) {
+    close(sd);
+  }
+  close(epfd);
+
+  /* wait for crofbase to release the closed connections */
+  start = now();
+  while ((num_open_fds() > num_fds) && (now() - start < 10)) {
+    usleep(10000);
+  }
+  CPPUNIT_ASSERT(num_open_fds() <= num_fds);
+  delete base;
+
+  return num_clients / t_accept;
+}
+
+void crofbasetest::test_accept_benchmark() {
+  unsigned int num_clients = testutil::bench_size(5000, 200);
+
+  /* clients and accepted connections */
+  struct rlimit rlim;
+  CPPUNIT_ASSERT(getrlimit(RLIMIT_NOFILE, &rlim) == 0);
+  rlim.rlim_cur = rlim.rlim_max;
+  setrlimit(RLIMIT_NOFILE, &rlim);
+  if (rlim.rlim_cur < 3 * num_clients) {
+    num_clients = rlim.rlim_cur / 3;
+  }
+
+  size_t single_threads, reuseport_threads;
+  double single = run_accept_benchmark(rofl::crofbase::LISTEN_MODE_SINGLE,
+                                       num_clients, single_threads);
+  double reuseport = run_accept_benchmark(
+      rofl::crofbase::LISTEN_MODE_REUSEPORT, num_clients, reuseport_threads);
+
+  std::cerr << "accept " << num_clients << " clients: single listener: "
+            << single << " conns/s reuseport listeners: " << reuseport
+            << " conns/s on " << reuseport_threads << " of "
+            << rofl::cthread::get_num_io_threads() << " io threads"
+            << std::endl;
+
+  /* the management thread serves a single listener, the kernel spreads
+   * connections over the reuseport listeners of all io threads */
+  CPPUNIT_ASSERT(single_threads == 1);
+  CPPUNIT_ASSERT(reuseport_threads ==
+                 std::min<size_t>(rofl::cthread::get_num_io_threads(),
+                                  num_clients));
+}
+
+void crofbasetest::test_flow_mod_batch_benchmark() {
+  const unsigned int num_flows = testutil::bench_size(100000, 5000);
+  const unsigned int batch_size = 1000;
+  rofl::cauxid auxid(0);
+
+  rofl::openflow::cofhello_elem_versionbitmap vbitmap;
+  vbitmap.add_ofp_version(rofl::openflow13::OFP_VERSION);
+  rofl::csockaddr baddr(AF_INET, "127.0.0.1", testutil::free_port());
+
+  rofl::crofbase *base = new rofl::crofbase();
+  base->set_versionbitmap(vbitmap);
+  base->dpt_sock_listen(baddr);
+
+  stub_switch sw;
+  sw.dpid = 0x1234;
+  sw.keep_running = true;
+  sw.hold_replies = false;
+  sw.num_flow_mods = 0;
+  sw.num_barriers = 0;
+  sw.flow_stats_segment = nullptr;
+  sw.sd = socket(AF_INET, SOCK_STREAM, 0);
+  CPPUNIT_ASSERT(sw.sd >= 0);
+  CPPUNIT_ASSERT(connect(sw.sd, baddr.ca_saddr, baddr.salen) == 0);
+  struct timeval tv = {0, 100000};
+  setsockopt(sw.sd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  pthread_t tid;
+  CPPUNIT_ASSERT(pthread_create(&tid, NULL, run_stub_switch, &sw) == 0);
+
+  double start = now();
+  while ((not base->has_dpt(rofl::cdpid(sw.dpid)) ||
+          not base->set_dpt(rofl::cdpid(sw.dpid)).is_established()) &&
+         (now() - start < 10)) {
+    usleep(1000);
+  }
+  CPPUNIT_ASSERT(base->has_dpt(rofl::cdpid(sw.dpid)));
+  rofl::crofdpt &dpt = base->set_dpt(rofl::cdpid(sw.dpid));
+
+  std::vector<rofl::openflow::cofflowmod> flowmods(
+      num_flows,
+      rofl::openflow::cofflowmod(rofl::openflow13::OFP_VERSION));
+  for (unsigned int i = 0; i < num_flows; i++) {
+    rofl::caddress_in4 ipv4_dst;
+    ipv4_dst.set_addr_hbo(0x0a000000 + i);
+    flowmods[i].set_command(rofl::openflow13::OFPFC_ADD);
+    flowmods[i].set_table_id(0);
+    flowmods[i].set_priority(0x8000);
+    flowmods[i].set_match().set_eth_type(0x0800);
+    flowmods[i].set_match().set_ipv4_dst(ipv4_dst);
+    flowmods[i]
+        .set_instructions()
+        .set_inst_apply_actions()
+        .set_actions()
+        .add_action_output(rofl::cindex(0))
+        .set_port_no(1);
+  }
+
+  /* one Flow-Mod per call, barrier at the end */
+  start = now();
+  for (unsigned int i = 0; i < num_flows; i++) {
+    while (dpt.try_send_flow_mod_message(auxid, flowmods[i]) ==
+           rofl::crofsock::MSG_QUEUEING_FAILED_QUEUE_FULL) {
+      sched_yield();
+    }
+  }
+  while (dpt.send_barrier_request(auxid) ==
+         rofl::crofsock::MSG_QUEUEING_FAILED_QUEUE_FULL) {
+    sched_yield();
+  }
+  CPPUNIT_ASSERT(wait_for(sw.num_barriers, 1, 60));
+  double t_single = now() - start;
+  CPPUNIT_ASSERT(sw.num_flow_mods == num_flows);
+
+  /* batches with a trailing barrier on the last one */
+  uint32_t first_xid = 0, last_xid = 0;
+  start = now();
+  for (unsigned int i = 0; i < num_flows; i += batch_size) {
+    bool barrier = (i + batch_size >= num_flows);
+    while (dpt.send_flow_mod_batch(auxid, &flowmods[i], batch_size, barrier,
+                                   &first_xid, &last_xid) ==
+           rofl::crofsock::MSG_QUEUEING_FAILED_QUEUE_FULL) {
+      sched_yield();
+    }
+    CPPUNIT_ASSERT(last_xid - first_xid == batch_size - (barrier ? 0 : 1));
+  }
+  CPPUNIT_ASSERT(wait_for(sw.num_barriers, 2, 60));
+  double t_batch = now() - start;
+  CPPUNIT_ASSERT(sw.num_flow_mods == 2 * num_flows);
+
+  std::cerr << "flow-mods " << num_flows << ": single: "
+            << (unsigned int)(num_flows / t_single)
+            << " flows/s batch of " << batch_size << ": "
+            << (unsigned int)(num_flows / t_batch)
+            << " flows/s speedup: " << t_single / t_batch << std::endl;
+
+  sw.keep_running = false;
+  pthread_join(tid, NULL);
+  close(sw.sd);
+  sleep(1);
+  delete base;
+}
+
+void crofbasetest::run_packet_in_fanout(unsigned int num_ctls,
+                                       unsigned int num_pkts,
+                                       double &t_per_ctl, double &t_fanout) {
+  const unsigned int burst = 64;
+  rofl::cauxid auxid(0);
+
+  rofl::openflow::cofhello_elem_versionbitmap vbitmap;
+  vbitmap.add_ofp_version(rofl::openflow13::OFP_VERSION);
+  rofl::csockaddr baddr(AF_INET, "127.0.0.1", testutil::free_port());
+
+  int lsd = socket(AF_INET, SOCK_STREAM, 0);
+  CPPUNIT_ASSERT(lsd >= 0);
+  int optval = 1;
+  setsockopt(lsd, SOL_SOCKET, SO_REUSEADDR, &optval, sizeof(optval));
+  CPPUNIT_ASSERT(bind(lsd, baddr.ca_saddr, baddr.salen) == 0);
+  CPPUNIT_ASSERT(listen(lsd, num_ctls) == 0);
+
+  /* datapath attached to num_ctls controllers in role EQUAL */
+  rofl::crofbase *base = new rofl::crofbase();
+  for (unsigned int i = 0; i < num_ctls; i++) {
+    base->add_ctl()
+        .add_conn(auxid)
+        .set_raddr(baddr)
+        .tcp_connect(vbitmap, rofl::crofconn::MODE_DATAPATH, false);
+  }
+
+  uint8_t frame[1500];
+  for (unsigned int i = 0; i < sizeof(frame); i++) {
+    frame[i] = i;
+  }
+  rofl::openflow::cofmatch match(rofl::openflow13::OFP_VERSION);
+  match.set_in_port(1);
+  match.set_eth_type(0x0800);
+  rofl::openflow::cofmsg_packet_in packet_in(
+      rofl::openflow13::OFP_VERSION, 0, rofl::openflow13::OFP_NO_BUFFER,
+      sizeof(frame), rofl::openflow13::OFPR_NO_MATCH, 0, 0, 0, match, frame,
+      sizeof(frame));
+
+  std::vector<stub_controller *> ctls;
+  std::vector<pthread_t> tids;
+  for (unsigned int i = 0; i < num_ctls; i++) {
+    stub_controller *ctl = new stub_controller;
+    ctl->sd = accept(lsd, NULL, NULL);
+    CPPUNIT_ASSERT(ctl->sd >= 0);
+    ctl->keep_running = true;
+    ctl->num_packet_ins = 0;
+    ctl->num_bad_packet_ins = 0;
+    ctl->last_xid = 0;
+    ctl->packet_in_len = packet_in.length();
+    struct timeval tv = {0, 100000};
+    setsockopt(ctl->sd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    pthread_t tid;
+    CPPUNIT_ASSERT(pthread_create(&tid, NULL, run_stub_controller, ctl) == 0);
+    ctls.push_back(ctl);
+    tids.push_back(tid);
+  }
+
+  std::list<rofl::cctlid> ctlids = base->ctl_keys();
+  double start = now();
+  for (auto ctlid : ctlids) {
+    while (not base->set_ctl(ctlid).is_established() &&
+           (now() - start < 10)) {
+      usleep(1000);
+    }
+    CPPUNIT_ASSERT(base->set_ctl(ctlid).is_established());
+  }
+
+  /* time spent in the send calls only, bursts stay below the txqueue
+   * size and are drained by the controllers before the next one */
+  t_per_ctl = t_fanout = 0;
+  for (unsigned int round = 0; round < 2; round++) {
+    double &elapsed = round ? t_fanout : t_per_ctl;
+    for (unsigned int sent = 0; sent < num_pkts;) {
+      unsigned int n = std::min(burst, num_pkts - sent);
+      start = now();
+      for (unsigned int i = 0; i < n; i++) {
+        if (round) {
+          base->send_packet_in_message(
+              auxid, rofl::openflow13::OFP_NO_BUFFER, sizeof(frame),
+              rofl::openflow13::OFPR_NO_MATCH, 0, 0, 0, match, frame,
+              sizeof(frame));
+        } else {
+          /* previous behaviour: a Packet-In built and packed per controller */
+          for (auto ctlid : ctlids) {
+            base->set_ctl(ctlid).send_packet_in_message(
+                auxid, rofl::openflow13::OFP_NO_BUFFER, sizeof(frame),
+                rofl::openflow13::OFPR_NO_MATCH, 0, 0, 0, match, frame,
+                sizeof(frame));
+          }
+        }
+      }
+      elapsed += now() - start;
+      sent += n;
+      for (auto ctl : ctls) {
+        CPPUNIT_ASSERT(
+            wait_for(ctl->num_packet_ins, round * num_pkts + sent, 10));
+      }
+    }
+  }
+
+  for (unsigned int i = 0; i < num_ctls; i++) {
+    CPPUNIT_ASSERT(ctls[i]->num_packet_ins == 2 * num_pkts);
+    CPPUNIT_ASSERT(ctls[i]->num_bad_packet_ins == 0);
+    ctls[i]->keep_running = false;
+    pthread_join(tids[i], NULL);
+    close(ctls[i]->sd);
+    delete ctls[i];
+  }
+  close(lsd);
+  sleep(1);
+  delete base;
+}
+
+void crofbasetest::test_packet_in_fanout_benchmark() {
+  const unsigned int num_pkts = testutil::bench_size(20000, 1000);
+  std::vector<unsigned int> sizes = {1, 2};
+  if (testutil::bench()) {
+    sizes = {1, 2, 4, 8};
+  }
+
+  for (unsigned int num_ctls : sizes) {
+    double t_per_ctl, t_fanout;
+    run_packet_in_fanout(num_ctls, num_pkts, t_per_ctl, t_fanout);
+
+    std::cerr << "packet-in fan-out to " << num_ctls
+              << " controllers: packed per controller: "
+              << 1e6 * t_per_ctl / num_pkts
+              << " us/packet-in packed once: " << 1e6 * t_fanout / num_pkts
+              << " us/packet-in speedup: " << t_per_ctl / t_fanout
+              << std::endl;
+  }
+}
+
+void crofbasetest::test_pending_requests_benchmark() {
+  const unsigned int num_requests = testutil::bench_size(10000, 1000);
+  const unsigned int num_timeouts = num_requests / 10;
+  rofl::cauxid auxid(0);
+
+  rofl::openflow::cofhello_elem_versionbitmap vbitmap;
+  vbitmap.add_ofp_version(rofl::openflow13::OFP_VERSION);
+  rofl::csockaddr baddr(AF_INET, "127.0.0.1", testutil::free_port());
+
+  rofl::crofbase *base = new rofl::crofbase();
+  base->set_versionbitmap(vbitmap);
+  base->dpt_sock_listen(baddr);
+
+  stub_switch sw;
+  sw.dpid = 0x5678;
+  sw.keep_running = true;
+  sw.hold_replies = false;
+  sw.num_flow_mods = 0;
+  sw.num_barriers = 0;
+  sw.flow_stats_segment = nullptr;
+  sw.sd = socket(AF_INET, SOCK_STREAM, 0);
+  CPPUNIT_ASSERT(sw.sd >= 0);
+  CPPUNIT_ASSERT(connect(sw.sd, baddr.ca_saddr, baddr.salen) == 0);
+  struct timeval tv = {0, 100000};
+  setsockopt(sw.sd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  pthread_t tid;
+  CPPUNIT_ASSERT(pthread_create(&tid, NULL, run_stub_switch, &sw) == 0);
+
+  double start = now();
+  while ((not base->has_dpt(rofl::cdpid(sw.dpid)) ||
+          not base->set_dpt(rofl::cdpid(sw.dpid)).is_established()) &&
+         (now() - start < 10)) {
+    usleep(1000);
+  }
+  CPPUNIT_ASSERT(base->has_dpt(rofl::cdpid(sw.dpid)));
+  rofl::crofdpt &dpt = base->set_dpt(rofl::cdpid(sw.dpid));
+
+  std::atomic_uint num_replied(0);
+  std::atomic_uint num_expired(0);
+  std::atomic_uint num_bad(0);
+  rofl::crofdpt::reply_cb_t cb = [&](rofl::crofdpt &, uint32_t xid,
+                                     rofl::openflow::cofmsg *msg) {
+    if (msg == nullptr) {
+      num_expired++;
+      return;
+    }
+    if ((msg->get_type() != rofl::openflow13::OFPT_BARRIER_REPLY) ||
+        (msg->get_xid() != xid)) {
+      num_bad++;
+    }
+    num_replied++;
+  };
+
+  /* callbacks: all requests outstanding before the first reply, wait for
+   * the stub's pending recv() to time out */
+  sw.hold_replies = true;
+  usleep(200000);
+  start = now();
+  for (unsigned int i = 0; i < num_requests; i++) {
+    while (dpt.send_barrier_request(auxid, cb, 60) ==
+           rofl::crofsock::MSG_QUEUEING_FAILED_QUEUE_FULL) {
+      sched_yield();
+    }
+  }
+  double t_send = now() - start;
+  CPPUNIT_ASSERT(dpt.get_pending_replies() == num_requests);
+
+  start = now();
+  sw.hold_replies = false;
+  CPPUNIT_ASSERT(wait_for(num_replied, num_requests, 60));
+  double t_callbacks = now() - start;
+  CPPUNIT_ASSERT(num_bad == 0);
+  CPPUNIT_ASSERT(num_expired == 0);
+  CPPUNIT_ASSERT(dpt.get_pending_replies() == 0);
+
+  /* futures */
+  std::vector<rofl::crofdpt::reply_future_t> futures;
+  futures.reserve(num_requests);
+  sw.hold_replies = true;
+  usleep(200000);
+  for (unsigned int i = 0; i < num_requests; i++) {
+    while (true) {
+      try {
+        futures.push_back(dpt.async_barrier_request(auxid, 60));
+        break;
+      } catch (rofl::eRofQueueFull &e) {
+        sched_yield();
+      }
+    }
+  }
+  CPPUNIT_ASSERT(dpt.get_pending_replies() == num_requests);
+
+  start = now();
+  sw.hold_replies = false;
+  for (auto &future : futures) {
+    std::unique_ptr<rofl::openflow::cofmsg> msg = future.get();
+    CPPUNIT_ASSERT(msg != nullptr);
+    CPPUNIT_ASSERT(msg->get_type() == rofl::openflow13::OFPT_BARRIER_REPLY);
+  }
+  double t_futures = now() - start;
+
+  /* timeouts: callbacks are called with nullptr */
+  sw.hold_replies = true;
+  usleep(200000);
+  start = now();
+  for (unsigned int i = 0; i < num_timeouts; i++) {
+    while (dpt.send_barrier_request(auxid, cb, 1) ==
+           rofl::crofsock::MSG_QUEUEING_FAILED_QUEUE_FULL) {
+      sched_yield();
+    }
+  }
+  CPPUNIT_ASSERT(wait_for(num_expired, num_timeouts, 10));
+  double t_timeouts = now() - start;
+  CPPUNIT_ASSERT(dpt.get_pending_replies() == 0);
+  CPPUNIT_ASSERT(num_replied == num_requests);
+  sw.hold_replies = false;
+
+  std::cerr << "pending requests " << num_requests
+            << ": send: " << (unsigned int)(num_requests / t_send)
+            << " req/s callbacks: "
+            << (unsigned int)(num_requests / t_callbacks)
+            << " replies/s futures: "
+            << (unsigned int)(num_requests / t_futures) << " replies/s, "
+            << num_timeouts << " timeouts after " << t_timeouts << "s"
+            << std::endl;
+
+  sw.keep_running = false;
+  pthread_join(tid, NULL);
+  close(sw.sd);
+  sleep(1);
+  delete base;
+}
+
+void crofbasetest::run_flow_stats_dump(bool streaming,
+                                       unsigned int num_segments,
+                                       const std::vector<uint8_t> &segment,
+                                       double &t_first, double &t_total,
+                                       size_t &peak_rss) {
+  rofl::cauxid auxid(0);
+
+  rofl::openflow::cofhello_elem_versionbitmap vbitmap;
+  vbitmap.add_ofp_version(rofl::openflow13::OFP_VERSION);
+  rofl::csockaddr baddr(AF_INET, "127.0.0.1", testutil::free_port());
+
+  flow_stats_controller *base = new flow_stats_controller();
+  base->set_versionbitmap(vbitmap);
+  base->dpt_sock_listen(baddr);
+
+  stub_switch sw;
+  sw.dpid = 0x9abc;
+  sw.keep_running = true;
+  sw.hold_replies = false;
+  sw.num_flow_mods = 0;
+  sw.num_barriers = 0;
+  sw.flow_stats_segment = &segment;
+  sw.num_flow_stats_segments = num_segments;
+  sw.flow_stats_stall = false;
+  sw.sd = socket(AF_INET, SOCK_STREAM, 0);
+  CPPUNIT_ASSERT(sw.sd >= 0);
+  CPPUNIT_ASSERT(connect(sw.sd, baddr.ca_saddr, baddr.salen) == 0);
+  struct timeval tv = {0, 100000};
+  setsockopt(sw.sd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  pthread_t tid;
+  CPPUNIT_ASSERT(pthread_create(&tid, NULL, run_stub_switch, &sw) == 0);
+
+  double start = now();
+  while ((not base->has_dpt(rofl::cdpid(sw.dpid)) ||
+          not base->set_dpt(rofl::cdpid(sw.dpid)).is_established()) &&
+         (now() - start < 10)) {
+    usleep(1000);
+  }
+  CPPUNIT_ASSERT(base->has_dpt(rofl::cdpid(sw.dpid)));
+  rofl::crofdpt &dpt = base->set_dpt(rofl::cdpid(sw.dpid));
+  dpt.set_multipart_streaming(rofl::openflow13::OFPMP_FLOW, streaming);
+  CPPUNIT_ASSERT(dpt.get_multipart_streaming(rofl::openflow13::OFPMP_FLOW) ==
+                 streaming);
+
+  base->reset();
+  size_t base_rss = base->peak_rss;
+  start = now();
+  dpt.send_flow_stats_request(
+      auxid, 0,
+      rofl::openflow::cofflow_stats_request(rofl::openflow13::OFP_VERSION),
+      60);
+  CPPUNIT_ASSERT(wait_for(base->num_replies, 1, 120));
+  t_total = now() - start;
+  t_first = base->t_first - start;
+  peak_rss = base->peak_rss - base_rss;
+
+  struct rofl::openflow13::ofp_multipart_reply *reply =
+      (struct rofl::openflow13::ofp_multipart_reply *)segment.data();
+  unsigned int entries_per_segment =
+      (segment.size() - sizeof(*reply)) /
+      (be16toh(((struct rofl::openflow13::ofp_flow_stats *)reply->body)
+                   ->length));
+  CPPUNIT_ASSERT(base->num_entries == num_segments * entries_per_segment);
+
+  sw.keep_running = false;
+  pthread_join(tid, NULL);
+  close(sw.sd);
+  sleep(1);
+  delete base;
+}
+
+void crofbasetest::test_flow_stats_streaming() {
+  const unsigned int num_segments = 4;
+  const unsigned int entries_per_segment = 10;
+  rofl::cauxid auxid(0);
+  rofl::openflow::cofflow_stats_request request(rofl::openflow13::OFP_VERSION);
+  std::vector<uint8_t> segment = make_flow_stats_segment(entries_per_segment);
+
+  rofl::openflow::cofhello_elem_versionbitmap vbitmap;
+  vbitmap.add_ofp_version(rofl::openflow13::OFP_VERSION);
+  rofl::csockaddr baddr(AF_INET, "127.0.0.1", testutil::free_port());
+
+  flow_stats_controller *base = new flow_stats_controller();
+  base->set_versionbitmap(vbitmap);
+  base->dpt_sock_listen(baddr);
+
+  stub_switch sw;
+  sw.dpid = 0xdef0;
+  sw.keep_running = true;
+  sw.hold_replies = false;
+  sw.num_flow_mods = 0;
+  sw.num_barriers = 0;
+  sw.flow_stats_segment = &segment;
+  sw.num_flow_stats_segments = num_segments;
+  sw.flow_stats_stall = false;
+  sw.sd = socket(AF_INET, SOCK_STREAM, 0);
+  CPPUNIT_ASSERT(sw.sd >= 0);
+  CPPUNIT_ASSERT(connect(sw.sd, baddr.ca_saddr, baddr.salen) == 0);
+  struct timeval tv = {0, 100000};
+  setsockopt(sw.sd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  pthread_t tid;
+  CPPUNIT_ASSERT(pthread_create(&tid, NULL, run_stub_switch, &sw) == 0);
+
+  double start = now();
+  while ((not base->has_dpt(rofl::cdpid(sw.dpid)) ||
+          not base->set_dpt(rofl::cdpid(sw.dpid)).is_established()) &&
+         (now() - start < 10)) {
+    usleep(1000);
+  }
+  CPPUNIT_ASSERT(base->has_dpt(rofl::cdpid(sw.dpid)));
+  rofl::crofdpt &dpt = base->set_dpt(rofl::cdpid(sw.dpid));
+  dpt.set_multipart_streaming(rofl::openflow13::OFPMP_FLOW);
+
+  std::atomic_uint num_segments_rcvd(0);
+  std::atomic_uint num_last(0);
+  std::atomic_uint num_expired(0);
+  rofl::crofdpt::reply_cb_t cb = [&](rofl::crofdpt &, uint32_t xid,
+                                     rofl::openflow::cofmsg *msg) {
+    if (msg == nullptr) {
+      num_expired++;
+      return;
+    }
+    rofl::openflow::cofmsg_stats_reply *stats =
+        dynamic_cast<rofl::openflow::cofmsg_stats_reply *>(msg);
+    if ((stats != nullptr) &&
+        not(stats->get_stats_flags() & rofl::openflow13::OFPMPF_REPLY_MORE)) {
+      num_last++;
+    }
+    num_segments_rcvd++;
+  };
+
+  /* a callback consumes each segment */
+  base->reset();
+  dpt.send_flow_stats_request(auxid, 0, request, cb, 5);
+  CPPUNIT_ASSERT(wait_for(num_last, 1, 10));
+  CPPUNIT_ASSERT(num_segments_rcvd == num_segments);
+  CPPUNIT_ASSERT(base->num_entries == 0);
+  CPPUNIT_ASSERT(dpt.get_pending_replies() == 0);
+
+  /* a future completes with the final segment, all segments reach the
+   * segment handler */
+  base->reset();
+  rofl::crofdpt::reply_future_t future =
+      dpt.async_flow_stats_request(auxid, 0, request, 5);
+  std::unique_ptr<rofl::openflow::cofmsg> msg = future.get();
+  CPPUNIT_ASSERT(msg != nullptr);
+  CPPUNIT_ASSERT(
+      not(dynamic_cast<rofl::openflow::cofmsg_stats_reply &>(*msg)
+              .get_stats_flags() &
+          rofl::openflow13::OFPMPF_REPLY_MORE));
+  CPPUNIT_ASSERT(base->num_replies == 1);
+  CPPUNIT_ASSERT(base->num_entries == num_segments * entries_per_segment);
+
+  /* a stream lacking its final segment times out */
+  sw.flow_stats_stall = true;
+  num_segments_rcvd = 0;
+  dpt.send_flow_stats_request(auxid, 0, request, cb, 1);
+  CPPUNIT_ASSERT(wait_for(num_expired, 1, 10));
+  CPPUNIT_ASSERT(num_segments_rcvd == num_segments - 1);
+  CPPUNIT_ASSERT(dpt.get_pending_replies() == 0);
+
+  sw.keep_running = false;
+  pthread_join(tid, NULL);
+  close(sw.sd);
+  sleep(1);
+  delete base;
+}
+
+void crofbasetest::test_flow_stats_streaming_benchmark() {
+  const unsigned int num_flows = testutil::bench_size(100000, 10000);
+  const unsigned int entries_per_segment = 500;
+
+  std::vector<uint8_t> segment = make_flow_stats_segment(entries_per_segment);
+
+  double t_first[2], t_total[2];
+  size_t peak_rss[2];
+  for (int streaming = 1; streaming >= 0; streaming--) {
+    run_flow_stats_dump(streaming, num_flows / entries_per_segment, segment,
+                        t_first[streaming], t_total[streaming],
+                        peak_rss[streaming]);
+  }
+
+  std::cerr << "flow-stats dump of " << num_flows << " entries in "
+            << num_flows / entries_per_segment << " segments: reassembled: "
+            << "first entry " << t_first[0] * 1e3 << "ms total "
+            << t_total[0] * 1e3 << "ms peak rss +" << (peak_rss[0] >> 10)
+            << "kB streamed: first entry " << t_first[1] * 1e3 << "ms total "
+            << t_total[1] * 1e3 << "ms peak rss +" << (peak_rss[1] >> 10)
+            << "kB" << std::endl;
+
+  CPPUNIT_ASSERT(t_first[1] < t_first[0]);
+  /* streaming holds a single segment instead of the whole dump */
+  CPPUNIT_ASSERT(peak_rss[1] < peak_rss[0] / 2);
+}
+
 void crofbasetest::handle_wakeup(rofl::cthread &thread) {}
 
 void crofbasetest::handle_timeout(rofl::cthread &thread, uint32_t timer_id) {}
@@ -160,6 +160,14 @@ class crofbasetest : public CppUnit::TestFixture, public rofl::cthread_env {
 
   CPPUNIT_TEST_SUITE(crofbasetest);
   CPPUNIT_TEST(test);
+  CPPUNIT_TEST(test_dpid_index);
+  CPPUNIT_TEST(test_attach_benchmark);
+  CPPUNIT_TEST(test_accept_benchmark);
+  CPPUNIT_TEST(test_flow_mod_batch_benchmark);
+  CPPUNIT_TEST(test_packet_in_fanout_benchmark);
+  CPPUNIT_TEST(test_pending_requests_benchmark);
+  CPPUNIT_TEST(test_flow_stats_streaming);
+  CPPUNIT_TEST(test_flow_stats_streaming_benchmark);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -168,6 +176,14 @@ public:
 
 public:
   void test();
+  void test_dpid_index();
+  void test_attach_benchmark();
+  void test_accept_benchmark();
+  void test_flow_mod_batch_benchmark();
+  void test_packet_in_fanout_benchmark();
+  void test_pending_requests_benchmark();
+  void test_flow_stats_streaming();
+  void test_flow_stats_streaming_benchmark();
 
 private:
   virtual void handle_wakeup(rofl::cthread &thread);
@@ -177,6 +193,19 @@ private:
   virtual void handle_read_event(rofl::cthread &thread, int fd){};
   virtual void handle_write_event(rofl::cthread &thread, int fd){};
 
+private:
+  double run_accept_benchmark(rofl::crofbase::listen_mode_t listen_mode,
+                              unsigned int num_clients,
+                              size_t &num_accept_threads);
+
+  void run_packet_in_fanout(unsigned int num_ctls, unsigned int num_pkts,
+                            double &t_per_ctl, double &t_fanout);
+
+  void run_flow_stats_dump(bool streaming, unsigned int num_segments,
+                           const std::vector<uint8_t> &segment,
+                           double &t_first, double &t_total,
+                           size_t &peak_rss);
+
 private:
   // test controller
   ccontroller *controller;
@@ -0,0 +1,371 @@
+/*
+ * crofcapturetest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sstream>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include "../testutil.hpp"
+#include "crofcapturetest.hpp"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(crofcapturetest);
+
+namespace {
+
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+std::vector<uint8_t> pack(rofl::openflow::cofmsg &msg) {
+  std::vector<uint8_t> buf(msg.length());
+  msg.pack(buf.data(), buf.size());
+  return buf;
+}
+
+bool wait_for(std::atomic_uint &counter, unsigned int value, int secs) {
+  double start = now();
+  while ((counter < value) && (now() - start < secs)) {
+    usleep(1000);
+  }
+  return (counter == value);
+}
+
+rofl::openflow::cofhello_elem_versionbitmap versionbitmap() {
+  rofl::openflow::cofhello_elem_versionbitmap vbitmap;
+  vbitmap.add_ofp_version(rofl::openflow13::OFP_VERSION);
+  return vbitmap;
+}
+
+} // namespace
+
+void crofcapturetest::setUp() {
+  std::stringstream ss;
+  ss << "/tmp/crofcapturetest." << getpid();
+  path = ss.str() + ".cap";
+  path_replayed = ss.str() + ".replayed.cap";
+}
+
+void crofcapturetest::tearDown() {
+  unlink(path.c_str());
+  unlink(path_replayed.c_str());
+}
+
+void crofcapturetest::write_session(const std::string &path,
+                                    unsigned int num_packet_in,
+                                    unsigned int usecs_between) {
+  rofl::crofcapture capture;
+  capture.open_write(path);
+
+  rofl::openflow::cofhelloelems helloIEs;
+  helloIEs.add_hello_elem_versionbitmap() = versionbitmap();
+  rofl::openflow::cofmsg_hello hello(rofl::openflow13::OFP_VERSION, 1,
+                                     helloIEs);
+  std::vector<uint8_t> buf = pack(hello);
+  capture.append(rofl::crofcapture::DIR_RX, buf.data(), buf.size());
+
+  rofl::openflow::cofmsg_features_reply features(
+      rofl::openflow13::OFP_VERSION, 2, 0x1234, 256, 1, 0, 0);
+  buf = pack(features);
+  capture.append(rofl::crofcapture::DIR_RX, buf.data(), buf.size());
+
+  uint8_t frame[64];
+  for (unsigned int i = 0; i < sizeof(frame); i++) {
+    frame[i] = i;
+  }
+  rofl::openflow::cofmatch match(rofl::openflow13::OFP_VERSION);
+  match.set_in_port(1);
+  match.set_eth_type(0x0800);
+
+  /* the byte stream is cut into records of varying size, so records
+   * carry several messages or fragments of a message */
+  const size_t chunks[] = {100, 700, 1500, 37};
+  std::vector<uint8_t> stream;
+  for (unsigned int i = 0; i < num_packet_in; i++) {
+    rofl::openflow::cofmsg_packet_in packet_in(
+        rofl::openflow13::OFP_VERSION, 3 + i, 0xffffffff, sizeof(frame),
+        rofl::openflow13::OFPR_NO_MATCH, 0, 0, 0, match, frame,
+        sizeof(frame));
+    buf = pack(packet_in);
+    if (usecs_between > 0) {
+      usleep(usecs_between);
+      capture.append(rofl::crofcapture::DIR_RX, buf.data(), buf.size());
+    } else {
+      stream.insert(stream.end(), buf.begin(), buf.end());
+    }
+  }
+  for (size_t offset = 0, i = 0; offset < stream.size(); i++) {
+    size_t len = std::min(chunks[i % 4], stream.size() - offset);
+    capture.append(rofl::crofcapture::DIR_RX, stream.data() + offset, len);
+    offset += len;
+  }
+
+  CPPUNIT_ASSERT(capture.get_dropped() == 0);
+  capture.close();
+}
+
+void crofcapturetest::test_file() {
+  rofl::crofcapture capture;
+  capture.open_write(path);
+  CPPUNIT_ASSERT(capture.is_open());
+  CPPUNIT_ASSERT(capture.is_writable());
+
+  std::vector<uint8_t> data(256);
+  for (unsigned int i = 0; i < data.size(); i++) {
+    data[i] = i;
+  }
+
+  size_t length = 0;
+  for (unsigned int i = 0; i < 100; i++) {
+    if (i % 2) {
+      struct iovec iov[2];
+      iov[0].iov_base = data.data();
+      iov[0].iov_len = i / 2;
+      iov[1].iov_base = data.data() + i / 2;
+      iov[1].iov_len = i - i / 2;
+      CPPUNIT_ASSERT(capture.append(rofl::crofcapture::DIR_TX, iov, 2));
+    } else {
+      CPPUNIT_ASSERT(
+          capture.append(rofl::crofcapture::DIR_RX, data.data(), i));
+    }
+    length += rofl::crofcapture::record_size(i);
+  }
+  CPPUNIT_ASSERT(capture.get_records() == 100);
+  CPPUNIT_ASSERT(capture.get_length() == length);
+  capture.close();
+  CPPUNIT_ASSERT(not capture.is_open());
+
+  /* file is truncated to the records written */
+  struct stat st;
+  CPPUNIT_ASSERT(stat(path.c_str(), &st) == 0);
+  CPPUNIT_ASSERT((size_t)st.st_size ==
+                 sizeof(rofl::crofcapture::header_t) + length);
+
+  capture.open_read(path);
+  CPPUNIT_ASSERT(not capture.is_writable());
+  CPPUNIT_ASSERT(capture.get_records() == 100);
+
+  unsigned int i = 0;
+  uint64_t ts_ns = 0;
+  for (auto it = capture.begin(); it != capture.end(); ++it, ++i) {
+    CPPUNIT_ASSERT(it->len == i);
+    CPPUNIT_ASSERT(it->dir == ((i % 2) ? rofl::crofcapture::DIR_TX
+                                       : rofl::crofcapture::DIR_RX));
+    CPPUNIT_ASSERT(memcmp(it->data, data.data(), i) == 0);
+    CPPUNIT_ASSERT(it->ts_ns >= ts_ns);
+    ts_ns = it->ts_ns;
+  }
+  CPPUNIT_ASSERT(i == 100);
+}
+
+void crofcapturetest::test_capacity() {
+  rofl::crofcapture capture;
+  capture.open_write(path, sizeof(rofl::crofcapture::header_t) +
+                               10 * rofl::crofcapture::record_size(100));
+
+  uint8_t data[100];
+  memset(data, 0xa5, sizeof(data));
+  for (unsigned int i = 0; i < 20; i++) {
+    CPPUNIT_ASSERT(capture.append(rofl::crofcapture::DIR_RX, data,
+                                  sizeof(data)) == (i < 10));
+  }
+  CPPUNIT_ASSERT(capture.get_records() == 10);
+  CPPUNIT_ASSERT(capture.get_dropped() == 10);
+  capture.close();
+
+  capture.open_read(path);
+  CPPUNIT_ASSERT(capture.get_records() == 10);
+}
+
+/* appends records of a fixed pattern until the capture is closed */
+struct append_arg {
+  rofl::crofcapture *capture;
+  rofl::crofcapture::direction_t dir;
+  unsigned int appended;
+};
+
+static void *run_append(void *arg) {
+  append_arg *aarg = (append_arg *)arg;
+  uint8_t data[64];
+  memset(data, 0x40 + aarg->dir, sizeof(data));
+  while (aarg->capture->append(aarg->dir, data, sizeof(data))) {
+    aarg->appended++;
+  }
+  return NULL;
+}
+
+void crofcapturetest::test_close_concurrent() {
+  rofl::crofcapture capture;
+  capture.open_write(path);
+
+  /* RX and TX threads keep appending while the capture is closed */
+  append_arg args[2];
+  pthread_t tids[2];
+  for (unsigned int i = 0; i < 2; i++) {
+    args[i].capture = &capture;
+    args[i].dir = (i == 0) ? rofl::crofcapture::DIR_RX
+                           : rofl::crofcapture::DIR_TX;
+    args[i].appended = 0;
+    CPPUNIT_ASSERT(pthread_create(&tids[i], NULL, run_append, &args[i]) == 0);
+  }
+  usleep(10000);
+  capture.close();
+  for (unsigned int i = 0; i < 2; i++) {
+    pthread_join(tids[i], NULL);
+  }
+  CPPUNIT_ASSERT(capture.get_dropped() == 0);
+
+  /* every record published in the header is complete */
+  capture.open_read(path);
+  CPPUNIT_ASSERT(capture.get_records() == args[0].appended + args[1].appended);
+  unsigned int num[2] = {0, 0};
+  for (auto it = capture.begin(); it != capture.end(); ++it) {
+    CPPUNIT_ASSERT(it->len == 64);
+    for (unsigned int j = 0; j < it->len; j++) {
+      CPPUNIT_ASSERT(it->data[j] == 0x40 + it->dir);
+    }
+    num[it->dir]++;
+  }
+  CPPUNIT_ASSERT(num[0] == args[0].appended);
+  CPPUNIT_ASSERT(num[1] == args[1].appended);
+}
+
+void crofcapturetest::test_malformed() {
+  /* missing file */
+  rofl::crofcapture capture;
+  CPPUNIT_ASSERT_THROW(capture.open_read(path), rofl::eSysCall);
+
+  /* no capture file */
+  FILE *fp = fopen(path.c_str(), "w");
+  CPPUNIT_ASSERT(fp != NULL);
+  for (unsigned int i = 0; i < 64; i++) {
+    fputc('x', fp);
+  }
+  fclose(fp);
+  CPPUNIT_ASSERT_THROW(capture.open_read(path), rofl::eInvalid);
+  CPPUNIT_ASSERT(not capture.is_open());
+
+  /* truncated record */
+  uint8_t data[100];
+  memset(data, 0, sizeof(data));
+  capture.open_write(path);
+  capture.append(rofl::crofcapture::DIR_RX, data, sizeof(data));
+  capture.append(rofl::crofcapture::DIR_RX, data, sizeof(data));
+  capture.close();
+  CPPUNIT_ASSERT(truncate(path.c_str(), sizeof(rofl::crofcapture::header_t) +
+                                            rofl::crofcapture::record_size(
+                                                sizeof(data)) +
+                                            8) == 0);
+  CPPUNIT_ASSERT_THROW(capture.open_read(path), rofl::eInvalid);
+}
+
+void crofcapturetest::test_replay() {
+  const unsigned int num_packet_in = testutil::bench_size(100000, 10000);
+  write_session(path, num_packet_in);
+
+  rofl::crofcapture capture;
+  capture.open_read(path);
+
+  /* record the replayed session, including messages sent by crofdpt */
+  rofl::crofcapture replayed;
+  replayed.open_write(path_replayed);
+
+  creplaycontroller *controller = new creplaycontroller();
+  controller->set_versionbitmap(versionbitmap());
+  controller->set_capture(&replayed);
+
+  double start = now();
+  size_t num_msgs = controller->replay_dpt(capture);
+  CPPUNIT_ASSERT(wait_for(controller->num_packet_in, num_packet_in, 60));
+  double elapsed = now() - start;
+
+  CPPUNIT_ASSERT(num_msgs == num_packet_in + 2);
+  CPPUNIT_ASSERT(controller->num_dpt_open == 1);
+  CPPUNIT_ASSERT(controller->has_dpt(rofl::cdpid(0x1234)));
+
+  std::cerr << "replay: " << num_msgs << " messages in " << elapsed << "s, "
+            << (unsigned int)(num_msgs / elapsed) << " msgs/s, "
+            << (unsigned int)(elapsed * 1e9 / num_msgs) << " ns/msg"
+            << std::endl;
+
+  delete controller;
+  replayed.close();
+
+  /* each replayed message is recorded on its own, whereas sent messages
+   * are recorded per batch: HELLO and FEATURES.request sent in reply */
+  replayed.open_read(path_replayed);
+  unsigned int num_rx = 0;
+  bool hello_sent = false, features_request_sent = false;
+  for (auto it = replayed.begin(); it != replayed.end(); ++it) {
+    if (rofl::crofcapture::DIR_RX == it->dir) {
+      const struct rofl::openflow::ofp_header *hdr =
+          (const struct rofl::openflow::ofp_header *)it->data;
+      CPPUNIT_ASSERT(it->len == be16toh(hdr->length));
+      num_rx++;
+      continue;
+    }
+    for (size_t offset = 0; offset < it->len;) {
+      const struct rofl::openflow::ofp_header *hdr =
+          (const struct rofl::openflow::ofp_header *)(it->data + offset);
+      hello_sent |= (hdr->type == rofl::openflow::OFPT_HELLO);
+      features_request_sent |=
+          (hdr->type == rofl::openflow::OFPT_FEATURES_REQUEST);
+      offset += be16toh(hdr->length);
+      CPPUNIT_ASSERT(offset <= it->len);
+    }
+  }
+  CPPUNIT_ASSERT(num_rx == num_packet_in + 2);
+  CPPUNIT_ASSERT(hello_sent);
+  CPPUNIT_ASSERT(features_request_sent);
+}
+
+void crofcapturetest::test_replay_paced() {
+  const unsigned int num_packet_in = 50;
+  write_session(path, num_packet_in, 2000);
+
+  rofl::crofcapture capture;
+  capture.open_read(path);
+
+  uint64_t ts_first = capture.begin()->ts_ns;
+  uint64_t ts_last = ts_first;
+  for (auto it = capture.begin(); it != capture.end(); ++it) {
+    ts_last = it->ts_ns;
+  }
+  double recorded = (ts_last - ts_first) / 1e9;
+
+  double elapsed[2];
+  for (unsigned int paced = 0; paced < 2; paced++) {
+    creplaycontroller *controller = new creplaycontroller();
+    controller->set_versionbitmap(versionbitmap());
+
+    double start = now();
+    CPPUNIT_ASSERT(controller->replay_dpt(capture, paced) ==
+                   num_packet_in + 2);
+    elapsed[paced] = now() - start;
+    CPPUNIT_ASSERT(wait_for(controller->num_packet_in, num_packet_in, 10));
+
+    delete controller;
+  }
+
+  std::cerr << "replay: recorded " << recorded << "s, full speed "
+            << elapsed[0] << "s, paced " << elapsed[1] << "s" << std::endl;
+
+  CPPUNIT_ASSERT(elapsed[1] >= recorded);
+  CPPUNIT_ASSERT(elapsed[0] < elapsed[1]);
+}
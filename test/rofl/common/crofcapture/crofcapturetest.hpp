@@ -0,0 +1,72 @@
+/*
+ * crofcapturetest.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef TEST_SRC_ROFL_COMMON_CROFCAPTURETEST_HPP_
+#define TEST_SRC_ROFL_COMMON_CROFCAPTURETEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <atomic>
+#include <string>
+
+#include "rofl/common/crofbase.h"
+#include "rofl/common/crofcapture.h"
+
+class creplaycontroller : public rofl::crofbase {
+public:
+  creplaycontroller() : num_dpt_open(0), num_packet_in(0){};
+
+  // number of datapaths attached
+  std::atomic_uint num_dpt_open;
+
+  // number of Packet-In messages received
+  std::atomic_uint num_packet_in;
+
+private:
+  virtual void handle_dpt_open(rofl::crofdpt &dpt) { num_dpt_open++; };
+
+  virtual void handle_packet_in(rofl::crofdpt &dpt, const rofl::cauxid &auxid,
+                                rofl::openflow::cofmsg_packet_in &msg) {
+    num_packet_in++;
+  };
+};
+
+class crofcapturetest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(crofcapturetest);
+  CPPUNIT_TEST(test_file);
+  CPPUNIT_TEST(test_capacity);
+  CPPUNIT_TEST(test_close_concurrent);
+  CPPUNIT_TEST(test_malformed);
+  CPPUNIT_TEST(test_replay);
+  CPPUNIT_TEST(test_replay_paced);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+public:
+  void test_file();
+  void test_capacity();
+  void test_close_concurrent();
+  void test_malformed();
+  void test_replay();
+  void test_replay_paced();
+
+private:
+  /* write a session of a datapath sending num_packet_in Packet-Ins */
+  void write_session(const std::string &path, unsigned int num_packet_in,
+                     unsigned int usecs_between = 0);
+
+private:
+  // name of capture file used by a test
+  std::string path;
+  // name of capture file recording a replayed session
+  std::string path_replayed;
+};
+
+#endif /* TEST_SRC_ROFL_COMMON_CROFCAPTURETEST_HPP_ */
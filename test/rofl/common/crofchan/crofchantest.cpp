@@ -6,6 +6,7 @@
  */
 
 #include <stdlib.h>
+#include <time.h>
 
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
@@ -17,6 +18,14 @@ using namespace rofl::openflow;
 
 CPPUNIT_TEST_SUITE_REGISTRATION(crofchantest);
 
+namespace {
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+}; // namespace
+
 void crofchantest::setUp() {}
 
 void crofchantest::tearDown() {}
@@ -244,6 +253,42 @@ void crofchantest::test_congestion() {
   delete rofsock;
 }
 
+void crofchantest::test_not_established() {
+  const unsigned int num_msgs = 20000;
+  rofl::crofchan channel(this);
+
+  double start = now();
+  unsigned int caught = 0;
+  for (unsigned int i = 0; i < num_msgs; i++) {
+    rofl::openflow::cofmsg *msg = new rofl::openflow::cofmsg(
+        rofl::openflow13::OFP_VERSION, rofl::openflow13::OFPT_PACKET_OUT, i);
+    try {
+      channel.send_message(rofl::cauxid(0), msg);
+    } catch (rofl::eRofConnNotConnected &e) {
+      delete msg;
+      caught++;
+    }
+  }
+  double t_throw = now() - start;
+  CPPUNIT_ASSERT(caught == num_msgs);
+
+  start = now();
+  unsigned int failed = 0;
+  for (unsigned int i = 0; i < num_msgs; i++) {
+    rofl::openflow::cofmsg *msg = new rofl::openflow::cofmsg(
+        rofl::openflow13::OFP_VERSION, rofl::openflow13::OFPT_PACKET_OUT, i);
+    failed += (channel.try_send_message(rofl::cauxid(0), msg) ==
+               rofl::crofsock::MSG_QUEUEING_FAILED_NOT_ESTABLISHED);
+  }
+  double t_try = now() - start;
+  CPPUNIT_ASSERT(failed == num_msgs);
+
+  std::cerr << "not established: send_message/catch: "
+            << t_throw * 1e9 / num_msgs
+            << " ns/msg try_send_message: " << t_try * 1e9 / num_msgs
+            << " ns/msg speedup: " << t_throw / t_try << std::endl;
+}
+
 void crofchantest::handle_listen(rofl::crofsock &socket) {
   rofl::AcquireReadWriteLock lock(tlock);
   for (auto sd : socket.accept()) {
@@ -26,6 +26,7 @@ class crofchantest : public CppUnit::TestFixture,
   CPPUNIT_TEST(global_initialize);
   CPPUNIT_TEST(test_connections);
   CPPUNIT_TEST(test_congestion);
+  CPPUNIT_TEST(test_not_established);
   CPPUNIT_TEST(global_terminate);
   CPPUNIT_TEST_SUITE_END();
 
@@ -48,6 +49,7 @@ public:
 public:
   void test_connections();
   void test_congestion();
+  void test_not_established();
 
 private:
   uint16_t listening_port;
@@ -7,10 +7,13 @@
 
 #include <stdlib.h>
 
+#include <algorithm>
+
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
 #include <glog/logging.h>
 
+#include "../testutil.hpp"
 #include "crofconntest.hpp"
 
 using namespace rofl::openflow;
@@ -116,6 +119,166 @@ void crofconntest::test() {
   }
 }
 
+std::vector<double>
+crofconntest::run_rx_benchmark(rofl::cthread::hnd_scheduler_t hnd_scheduler,
+                               uint64_t &steals) {
+  const unsigned int num_hnd_threads = 4;
+  const unsigned int num_clients = 16;
+  const unsigned int num_rounds = 100;
+
+  rofl::cthread::pool_terminate();
+  rofl::cthread::pool_initialize(num_hnd_threads, 2, 1,
+                                 rofl::cthread::TIMER_BACKEND_ORDERED_SET,
+                                 rofl::cthread::ALLOCATOR_HEAP, hnd_scheduler);
+
+  std::vector<uint32_t> threads(num_hnd_threads);
+  for (unsigned int i = 0; i < num_hnd_threads; i++) {
+    threads[i] = rofl::cthread::get_hnd_thread_num_from_pool();
+  }
+
+  test_mode = TEST_MODE_RX_BENCH;
+  bench_established = 0;
+  bench_received = 0;
+  bench_errors = 0;
+  versionbitmap_ctl.clear_ofp_versions();
+  versionbitmap_ctl.add_ofp_version(rofl::openflow13::OFP_VERSION);
+  versionbitmap_dpt.clear_ofp_versions();
+  versionbitmap_dpt.add_ofp_version(rofl::openflow13::OFP_VERSION);
+
+  slisten = new rofl::crofsock(this);
+  baddr = rofl::csockaddr(rofl::caddress_in4("127.0.0.1"),
+                          testutil::free_port());
+  slisten->set_baddr(baddr).listen();
+
+  /* handler threads are assigned round robin, clients 0, 4, 8 and 12
+   * share the first handler thread and are the busy ones */
+  for (unsigned int i = 0; i < num_clients; i++) {
+    bench_client_t *client = new bench_client_t();
+    client->conn = new rofl::crofconn(this);
+    client->conn->set_txqueue_max_size(BENCH_TXQUEUE_MAX_SIZE);
+    client->last_xid = 0;
+    client->in_recv = false;
+    /* no reallocation while handlers read send times */
+    client->t_sent.reserve(6 * num_rounds);
+    bench_clients.push_back(client);
+  }
+  for (auto client : bench_clients) {
+    client->conn->set_raddr(baddr).tcp_connect(
+        versionbitmap_dpt, rofl::crofconn::MODE_DATAPATH, /*reconnect=*/false);
+  }
+  CPPUNIT_ASSERT(testutil::wait_for(bench_established, num_clients, 10));
+
+  /* the busy clients exceed a single handler thread's capacity */
+  unsigned int num_sent = 0;
+  for (unsigned int round = 0; round < num_rounds; round++) {
+    for (unsigned int i = 0; i < num_clients; i++) {
+      bench_client_t *client = bench_clients[i];
+      unsigned int num_msgs = (i % num_hnd_threads == 0) ? 6 : 1;
+      for (unsigned int j = 0; j < num_msgs; j++) {
+        uint32_t xid = client->t_sent.size() + 1;
+        client->t_sent.push_back(testutil::now());
+        if (not bench_queued(
+                client->conn->send_message(new rofl::openflow::cofmsg_packet_in(
+                    rofl::openflow13::OFP_VERSION, xid)))) {
+          bench_errors++;
+        }
+        num_sent++;
+      }
+    }
+    usleep(2000);
+  }
+  CPPUNIT_ASSERT(testutil::wait_for(bench_received, num_sent, 60));
+  CPPUNIT_ASSERT(bench_errors == 0);
+
+  steals = 0;
+  for (auto thread_num : threads) {
+    steals += rofl::cthread::thread(thread_num).get_jobs_stolen();
+  }
+
+  std::vector<double> latencies;
+  for (auto client : bench_clients) {
+    latencies.insert(latencies.end(), client->latencies.begin(),
+                     client->latencies.end());
+    delete client->conn;
+    delete client;
+  }
+  bench_clients.clear();
+  slisten->close();
+  delete slisten;
+  usleep(100000);
+  {
+    std::lock_guard<std::mutex> lock(bench_servers_lock);
+    for (auto conn : bench_servers) {
+      delete conn;
+    }
+    bench_servers.clear();
+  }
+
+  std::sort(latencies.begin(), latencies.end());
+  return latencies;
+}
+
+void crofconntest::test_work_stealing() {
+  uint64_t steals_static = 0, steals_ws = 0;
+  std::vector<double> l_static =
+      run_rx_benchmark(rofl::cthread::HND_SCHEDULER_STATIC, steals_static);
+  std::vector<double> l_ws =
+      run_rx_benchmark(rofl::cthread::HND_SCHEDULER_WORK_STEALING, steals_ws);
+
+  /* restore default pool */
+  rofl::cthread::pool_terminate();
+  rofl::cthread::pool_initialize();
+
+  double p50_static = l_static[l_static.size() / 2];
+  double p99_static = l_static[l_static.size() * 99 / 100];
+  double p50_ws = l_ws[l_ws.size() / 2];
+  double p99_ws = l_ws[l_ws.size() * 99 / 100];
+
+  std::cerr << "crofconn round trip static: p50 " << 1e3 * p50_static
+            << "ms p99 " << 1e3 * p99_static << "ms" << std::endl;
+  std::cerr << "crofconn round trip work stealing: p50 " << 1e3 * p50_ws
+            << "ms p99 " << 1e3 * p99_ws << "ms steals " << steals_ws
+            << std::endl;
+
+  CPPUNIT_ASSERT(steals_static == 0);
+  CPPUNIT_ASSERT(steals_ws > 0);
+  CPPUNIT_ASSERT(p99_ws < p99_static);
+}
+
+void crofconntest::bench_recv(rofl::crofconn &conn,
+                              rofl::openflow::cofmsg *msg) {
+  /* controller side echoes each Packet-In */
+  if (msg->get_type() == rofl::openflow::OFPT_PACKET_IN) {
+    if (not bench_queued(conn.send_message(
+            new rofl::openflow::cofmsg_packet_out(msg->get_version(),
+                                                  msg->get_xid())))) {
+      bench_errors++;
+    }
+    delete msg;
+    return;
+  }
+
+  for (auto client : bench_clients) {
+    if (client->conn != &conn)
+      continue;
+    /* callbacks for a connection never overlap, even when stolen */
+    if (client->in_recv.exchange(true)) {
+      bench_errors++;
+    }
+    uint32_t xid = msg->get_xid();
+    if (xid != client->last_xid + 1) {
+      bench_errors++;
+    }
+    client->last_xid = xid;
+    client->latencies.push_back(testutil::now() - client->t_sent[xid - 1]);
+    /* model a handler blocking for 100us */
+    usleep(100);
+    client->in_recv = false;
+    bench_received++;
+  }
+  delete msg;
+}
+
 void crofconntest::handle_listen(rofl::crofsock &socket) {
 
   for (auto sd : socket.accept()) {
@@ -133,6 +296,15 @@ void crofconntest::handle_listen(rofl::crofsock &socket) {
                           rofl::crofconn::MODE_CONTROLLER);
 
     } break;
+    case TEST_MODE_RX_BENCH: {
+      rofl::crofconn *conn = new rofl::crofconn(this);
+      conn->set_txqueue_max_size(BENCH_TXQUEUE_MAX_SIZE);
+      {
+        std::lock_guard<std::mutex> lock(bench_servers_lock);
+        bench_servers.push_back(conn);
+      }
+      conn->tcp_accept(sd, versionbitmap_ctl, rofl::crofconn::MODE_CONTROLLER);
+    } break;
     default: {};
     }
   }
@@ -142,6 +314,12 @@ void crofconntest::handle_established(rofl::crofconn &conn,
                                       uint8_t ofp_version) {
   LOG(INFO) << "crofconntest::handle_established()" << std::endl;
 
+  if (TEST_MODE_RX_BENCH == test_mode) {
+    if (conn.get_mode() == rofl::crofconn::MODE_DATAPATH)
+      bench_established++;
+    return;
+  }
+
   if (&conn == sserver) {
     LOG(INFO) << "[Ss], ";
     send_packet_out(ofp_version);
@@ -205,6 +383,13 @@ void crofconntest::handle_recv(rofl::crofconn &conn,
                                rofl::openflow::cofmsg *pmsg) {
   CPPUNIT_ASSERT(pmsg != nullptr);
 
+  if ((TEST_MODE_RX_BENCH == test_mode) &&
+      ((pmsg->get_type() == rofl::openflow::OFPT_PACKET_IN) ||
+       (pmsg->get_type() == rofl::openflow::OFPT_PACKET_OUT))) {
+    bench_recv(conn, pmsg);
+    return;
+  }
+
   rofl::AcquireReadWriteLock lock(tlock);
 
   // LOG(INFO) << "crofconntest::handle_recv() " << std::endl << *pmsg;
@@ -8,6 +8,10 @@
 #ifndef TEST_SRC_ROFL_COMMON_OPENFLOW_MESSAGES_COFMSGAGGRSTATS_TEST_HPP_
 #define TEST_SRC_ROFL_COMMON_OPENFLOW_MESSAGES_COFMSGAGGRSTATS_TEST_HPP_
 
+#include <atomic>
+#include <mutex>
+#include <vector>
+
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 
@@ -20,6 +24,7 @@ class crofconntest : public CppUnit::TestFixture,
                      public rofl::crofsock_env {
   CPPUNIT_TEST_SUITE(crofconntest);
   CPPUNIT_TEST(test);
+  CPPUNIT_TEST(test_work_stealing);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -28,6 +33,7 @@ public:
 
 public:
   void test();
+  void test_work_stealing();
 
 private:
   virtual void handle_listen(rofl::crofsock &socket);
@@ -89,9 +95,39 @@ private:
 
   void send_packet_out(uint8_t version);
 
+  /* echoes Packet-Ins from 16 clients on 4 handler threads, 4 busy
+   * clients share a thread, returns sorted round trip latencies */
+  std::vector<double>
+  run_rx_benchmark(rofl::cthread::hnd_scheduler_t hnd_scheduler,
+                   uint64_t &steals);
+
+  void bench_recv(rofl::crofconn &conn, rofl::openflow::cofmsg *msg);
+
+  static bool bench_queued(rofl::crofsock::msg_result_t result) {
+    return (result == rofl::crofsock::MSG_QUEUED) ||
+           (result == rofl::crofsock::MSG_QUEUED_CONGESTION);
+  };
+
 private:
   enum crofconn_test_mode_t {
     TEST_MODE_TCP = 1,
+    TEST_MODE_RX_BENCH = 2,
+  };
+
+  /* holds all messages of a busy client, a slow static handler thread
+   * must not make the echoing side drop messages */
+  static const size_t BENCH_TXQUEUE_MAX_SIZE = 1024;
+
+  struct bench_client_t {
+    rofl::crofconn *conn;
+    // send time per xid
+    std::vector<double> t_sent;
+    // round trip times
+    std::vector<double> latencies;
+    // last xid received, replies arrive in order
+    uint32_t last_xid;
+    // handle_recv() is running
+    std::atomic_bool in_recv;
   };
 
   rofl::openflow::cofhello_elem_versionbitmap versionbitmap_ctl;
@@ -124,6 +160,15 @@ private:
   rofl::crwlock tlock;
   std::atomic_bool client_is_closed;
   std::atomic_bool server_is_closed;
+
+  // rx benchmark
+  std::vector<bench_client_t *> bench_clients;
+  std::vector<rofl::crofconn *> bench_servers;
+  std::mutex bench_servers_lock;
+  std::atomic_uint bench_established;
+  std::atomic_uint bench_received;
+  // replies received out of order or handled concurrently per connection
+  std::atomic_uint bench_errors;
 };
 
 #endif /* TEST_SRC_ROFL_COMMON_OPENFLOW_MESSAGES_COFMSGAGGRSTATS_TEST_HPP_ */
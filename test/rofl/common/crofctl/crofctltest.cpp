@@ -0,0 +1,406 @@
+/*
+ * crofctltest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <iostream>
+#include <vector>
+
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include "../testutil.hpp"
+#include "crofctltest.hpp"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(crofctltest);
+
+namespace {
+
+using testutil::now;
+using testutil::wait_for;
+
+const uint16_t MISS_SEND_LEN = 256;
+const size_t FRAME_LEN = 1500;
+
+/* minimal OpenFlow 1.3 controller: completes the handshake, sets
+ * miss_send_len, checks and counts Packet-Ins and answers
+ * Echo-Requests */
+struct stub_controller {
+  int sd;
+  std::atomic_bool keep_running;
+  // Packet-Ins received for reasons no-match and action
+  std::atomic_uint num_packet_ins[2];
+  // Packet-Ins with unexpected buffer-id or frame length
+  std::atomic_uint num_bad_packet_ins;
+  // table-miss Packet-Ins are expected to be buffered
+  bool buffered;
+  // buffer-id of last table-miss Packet-In
+  std::atomic<uint32_t> last_buffer_id;
+};
+
+void stub_controller_send(stub_controller *ctl, uint8_t *buf, size_t buflen) {
+  size_t sent = 0;
+  while (sent < buflen) {
+    ssize_t rc = send(ctl->sd, buf + sent, buflen - sent, MSG_NOSIGNAL);
+    if (rc <= 0)
+      return;
+    sent += rc;
+  }
+}
+
+void stub_controller_packet_in(stub_controller *ctl, const uint8_t *buf,
+                               size_t len) {
+  const struct rofl::openflow13::ofp_packet_in *packet_in =
+      (const struct rofl::openflow13::ofp_packet_in *)buf;
+  size_t matchlen = be16toh(packet_in->match.length);
+  size_t offset = sizeof(struct rofl::openflow::ofp_header) + 16 +
+                  ((matchlen + 7) & ~7) + 2;
+  size_t framelen = len - offset;
+  uint32_t buffer_id = be32toh(packet_in->buffer_id);
+
+  switch (packet_in->reason) {
+  case rofl::openflow13::OFPR_NO_MATCH: {
+    if (ctl->buffered) {
+      if ((rofl::openflow13::OFP_NO_BUFFER == buffer_id) ||
+          (MISS_SEND_LEN != framelen)) {
+        ctl->num_bad_packet_ins++;
+      }
+      ctl->last_buffer_id = buffer_id;
+    } else if ((rofl::openflow13::OFP_NO_BUFFER != buffer_id) ||
+               (FRAME_LEN != framelen)) {
+      ctl->num_bad_packet_ins++;
+    }
+    ctl->num_packet_ins[0]++;
+  } break;
+  case rofl::openflow13::OFPR_ACTION: {
+    if ((rofl::openflow13::OFP_NO_BUFFER != buffer_id) ||
+        (FRAME_LEN != framelen)) {
+      ctl->num_bad_packet_ins++;
+    }
+    ctl->num_packet_ins[1]++;
+  } break;
+  default: { ctl->num_bad_packet_ins++; };
+  }
+}
+
+void *run_stub_controller(void *arg) {
+  stub_controller *ctl = (stub_controller *)arg;
+  std::vector<uint8_t> buf(1 << 20);
+  size_t filled = 0;
+
+  struct rofl::openflow13::ofp_switch_config msg;
+  memset(&msg, 0, sizeof(msg));
+  msg.header.version = rofl::openflow13::OFP_VERSION;
+  msg.header.type = rofl::openflow13::OFPT_HELLO;
+  msg.header.length = htobe16(sizeof(struct rofl::openflow::ofp_header));
+  msg.header.xid = htobe32(1);
+  stub_controller_send(ctl, (uint8_t *)&msg,
+                       sizeof(struct rofl::openflow::ofp_header));
+
+  msg.header.type = rofl::openflow13::OFPT_SET_CONFIG;
+  msg.header.length = htobe16(sizeof(msg));
+  msg.header.xid = htobe32(2);
+  msg.miss_send_len = htobe16(MISS_SEND_LEN);
+  stub_controller_send(ctl, (uint8_t *)&msg, sizeof(msg));
+
+  while (ctl->keep_running) {
+    ssize_t rc = recv(ctl->sd, buf.data() + filled, buf.size() - filled, 0);
+    if (rc <= 0) {
+      if ((rc < 0) && ((errno == EAGAIN) || (errno == EINTR)))
+        continue;
+      break;
+    }
+    filled += rc;
+
+    size_t offset = 0;
+    while (filled - offset >= sizeof(struct rofl::openflow::ofp_header)) {
+      struct rofl::openflow::ofp_header *hdr =
+          (struct rofl::openflow::ofp_header *)(buf.data() + offset);
+      size_t len = be16toh(hdr->length);
+      if (filled - offset < len)
+        break;
+      switch (hdr->type) {
+      case rofl::openflow13::OFPT_ECHO_REQUEST: {
+        hdr->type = rofl::openflow13::OFPT_ECHO_REPLY;
+        stub_controller_send(ctl, (uint8_t *)hdr, len);
+      } break;
+      case rofl::openflow13::OFPT_PACKET_IN: {
+        stub_controller_packet_in(ctl, (uint8_t *)hdr, len);
+      } break;
+      default: {};
+      }
+      offset += len;
+    }
+    memmove(buf.data(), buf.data() + offset, filled - offset);
+    filled -= offset;
+  }
+  return nullptr;
+}
+
+} // namespace
+
+void crofctltest::setUp() {
+  rofl::cthread::pool_initialize(/*#threads=*/16);
+}
+
+void crofctltest::tearDown() { rofl::cthread::pool_terminate(); }
+
+void crofctltest::test_rate_limit() {
+  rofl::cpacketinshaper shaper;
+
+  /* no limits by default */
+  for (unsigned int i = 0; i < 1000; i++) {
+    CPPUNIT_ASSERT(shaper.admit(rofl::openflow13::OFPR_NO_MATCH));
+  }
+  CPPUNIT_ASSERT(shaper.get_admitted(rofl::openflow13::OFPR_NO_MATCH) ==
+                 1000);
+
+  /* 1000 Packet-Ins per second, bursts of 10 */
+  shaper.set_rate_limit(rofl::openflow13::OFPR_NO_MATCH, 1000, 10);
+  CPPUNIT_ASSERT(shaper.get_rate_limit(rofl::openflow13::OFPR_NO_MATCH) ==
+                 1000);
+  uint64_t t = rofl::cpacketinshaper::now_ns();
+  for (unsigned int i = 0; i < 10; i++) {
+    CPPUNIT_ASSERT(shaper.admit(rofl::openflow13::OFPR_NO_MATCH, t));
+  }
+  CPPUNIT_ASSERT(not shaper.admit(rofl::openflow13::OFPR_NO_MATCH, t));
+
+  /* other reasons are not affected */
+  for (unsigned int i = 0; i < 100; i++) {
+    CPPUNIT_ASSERT(shaper.admit(rofl::openflow13::OFPR_ACTION, t));
+  }
+
+  /* 5 tokens after 5ms */
+  t += 5000000;
+  for (unsigned int i = 0; i < 5; i++) {
+    CPPUNIT_ASSERT(shaper.admit(rofl::openflow13::OFPR_NO_MATCH, t));
+  }
+  CPPUNIT_ASSERT(not shaper.admit(rofl::openflow13::OFPR_NO_MATCH, t));
+
+  /* an idle bucket fills up to burst only */
+  t += 1000000000;
+  for (unsigned int i = 0; i < 10; i++) {
+    CPPUNIT_ASSERT(shaper.admit(rofl::openflow13::OFPR_NO_MATCH, t));
+  }
+  CPPUNIT_ASSERT(not shaper.admit(rofl::openflow13::OFPR_NO_MATCH, t));
+
+  CPPUNIT_ASSERT(shaper.get_admitted(rofl::openflow13::OFPR_NO_MATCH) ==
+                 1025);
+  CPPUNIT_ASSERT(shaper.get_dropped(rofl::openflow13::OFPR_NO_MATCH) == 3);
+  CPPUNIT_ASSERT(shaper.get_admitted(rofl::openflow13::OFPR_ACTION) == 100);
+  CPPUNIT_ASSERT(shaper.get_dropped(rofl::openflow13::OFPR_ACTION) == 0);
+
+  shaper.clear_rate_limits();
+  CPPUNIT_ASSERT(shaper.admit(rofl::openflow13::OFPR_NO_MATCH, t));
+
+  CPPUNIT_ASSERT_THROW(
+      shaper.set_rate_limit(rofl::cpacketinshaper::MAX_REASONS, 1000, 10),
+      rofl::eInvalid);
+}
+
+void crofctltest::test_buffers() {
+  rofl::cpacketinshaper shaper;
+  uint8_t frame[64];
+
+  /* disabled by default */
+  CPPUNIT_ASSERT(shaper.store(frame, sizeof(frame)) ==
+                 rofl::cpacketinshaper::NO_BUFFER);
+
+  shaper.set_buffers(4);
+  CPPUNIT_ASSERT(shaper.get_buffers() == 4);
+
+  std::vector<uint32_t> buffer_ids;
+  for (unsigned int i = 0; i < 6; i++) {
+    memset(frame, i, sizeof(frame));
+    buffer_ids.push_back(shaper.store(frame, sizeof(frame) - i));
+  }
+  CPPUNIT_ASSERT(shaper.get_buffered() == 6);
+  CPPUNIT_ASSERT(shaper.get_evicted() == 2);
+
+  /* the two oldest frames have been evicted */
+  rofl::cmemory mem;
+  for (unsigned int i = 0; i < 6; i++) {
+    CPPUNIT_ASSERT(shaper.retrieve(buffer_ids[i], mem) == (i >= 2));
+    if (i < 2)
+      continue;
+    CPPUNIT_ASSERT(mem.length() == sizeof(frame) - i);
+    memset(frame, i, sizeof(frame));
+    CPPUNIT_ASSERT(memcmp(mem.somem(), frame, mem.length()) == 0);
+  }
+
+  /* frames are retrieved once */
+  CPPUNIT_ASSERT(not shaper.retrieve(buffer_ids[5], mem));
+  CPPUNIT_ASSERT(not shaper.retrieve(rofl::cpacketinshaper::NO_BUFFER, mem));
+
+  /* a reserved buffer-id holds no frame until stored and a dropped
+   * reservation evicts nothing */
+  uint32_t dropped = shaper.reserve();
+  uint32_t reserved = shaper.reserve();
+  CPPUNIT_ASSERT(not shaper.retrieve(reserved, mem));
+  memset(frame, 0xaa, sizeof(frame));
+  shaper.store(reserved, frame, sizeof(frame));
+  CPPUNIT_ASSERT(not shaper.retrieve(dropped, mem));
+  CPPUNIT_ASSERT(shaper.retrieve(reserved, mem));
+  CPPUNIT_ASSERT(memcmp(mem.somem(), frame, sizeof(frame)) == 0);
+  CPPUNIT_ASSERT(shaper.get_buffered() == 7);
+  CPPUNIT_ASSERT(shaper.get_evicted() == 2);
+}
+
+crofctltest::flood_result_t crofctltest::run_packet_in_flood(bool shaped,
+                                                            double secs) {
+  const unsigned int rate = 2000, burst = 64, num_buffers = 256;
+  rofl::cauxid auxid(0);
+
+  rofl::openflow::cofhello_elem_versionbitmap vbitmap;
+  vbitmap.add_ofp_version(rofl::openflow13::OFP_VERSION);
+
+  int lsd = socket(AF_INET, SOCK_STREAM, 0);
+  CPPUNIT_ASSERT(lsd >= 0);
+  uint16_t port = testutil::bind_any_port(lsd);
+  CPPUNIT_ASSERT(port != 0);
+  CPPUNIT_ASSERT(listen(lsd, 1) == 0);
+  rofl::csockaddr baddr(AF_INET, "127.0.0.1", port);
+
+  rofl::crofbase *base = new rofl::crofbase();
+  rofl::crofctl &ctl = base->add_ctl();
+  if (shaped) {
+    ctl.set_packet_in_shaper()
+        .set_rate_limit(rofl::openflow13::OFPR_NO_MATCH, rate, burst)
+        .set_buffers(num_buffers);
+  }
+  ctl.add_conn(auxid).set_raddr(baddr).tcp_connect(
+      vbitmap, rofl::crofconn::MODE_DATAPATH, false);
+
+  stub_controller stub;
+  stub.sd = accept(lsd, NULL, NULL);
+  CPPUNIT_ASSERT(stub.sd >= 0);
+  stub.keep_running = true;
+  stub.num_packet_ins[0] = stub.num_packet_ins[1] = 0;
+  stub.num_bad_packet_ins = 0;
+  stub.buffered = shaped;
+  stub.last_buffer_id = rofl::openflow13::OFP_NO_BUFFER;
+  struct timeval tv = {0, 100000};
+  setsockopt(stub.sd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+  pthread_t tid;
+  CPPUNIT_ASSERT(pthread_create(&tid, NULL, run_stub_controller, &stub) == 0);
+
+  /* Set-Config follows Hello */
+  double start = now();
+  while (((not ctl.is_established()) ||
+          (ctl.get_miss_send_len() != MISS_SEND_LEN)) &&
+         (now() - start < 10)) {
+    usleep(1000);
+  }
+  CPPUNIT_ASSERT(ctl.is_established());
+  CPPUNIT_ASSERT(ctl.get_miss_send_len() == MISS_SEND_LEN);
+
+  uint8_t frame[FRAME_LEN];
+  for (unsigned int i = 0; i < sizeof(frame); i++) {
+    frame[i] = i;
+  }
+  rofl::openflow::cofmatch match(rofl::openflow13::OFP_VERSION);
+  match.set_in_port(1);
+  match.set_eth_type(0x0800);
+
+  flood_result_t result;
+  memset(&result, 0, sizeof(result));
+
+  start = now();
+  double t, next_action = start;
+  while ((t = now()) - start < secs) {
+    const uint8_t reasons[2] = {rofl::openflow13::OFPR_NO_MATCH,
+                                rofl::openflow13::OFPR_ACTION};
+    for (unsigned int i = 0; i < 2; i++) {
+      if ((1 == i) && (t < next_action))
+        continue;
+      result.num_sent[i]++;
+      switch (ctl.try_send_packet_in_message(
+          auxid, rofl::openflow13::OFP_NO_BUFFER, sizeof(frame), reasons[i],
+          0, 0, 0, match, frame, sizeof(frame))) {
+      case rofl::crofsock::MSG_QUEUED:
+      case rofl::crofsock::MSG_QUEUED_CONGESTION: {
+        result.num_queued[i]++;
+      } break;
+      default: {};
+      }
+    }
+    if (t >= next_action) {
+      next_action += 0.001;
+    }
+  }
+
+  for (unsigned int i = 0; i < 2; i++) {
+    CPPUNIT_ASSERT(wait_for(stub.num_packet_ins[i], result.num_queued[i], 10));
+    result.num_received[i] = stub.num_packet_ins[i];
+    CPPUNIT_ASSERT(result.num_received[i] == result.num_queued[i]);
+  }
+  CPPUNIT_ASSERT(stub.num_bad_packet_ins == 0);
+
+  std::cerr << "packet-in flood " << (shaped ? "shaped" : "unshaped")
+            << ": no-match " << result.num_received[0] << "/"
+            << result.num_sent[0] << " action " << result.num_received[1]
+            << "/" << result.num_sent[1] << " delivered" << std::endl;
+
+  if (shaped) {
+    const rofl::cpacketinshaper &shaper = ctl.get_packet_in_shaper();
+
+    /* the bucket admits burst plus rate per second */
+    uint64_t admitted = shaper.get_admitted(rofl::openflow13::OFPR_NO_MATCH);
+    CPPUNIT_ASSERT(admitted <= burst + rate * (now() - start));
+    CPPUNIT_ASSERT(admitted >= 0.9 * rate * secs);
+    CPPUNIT_ASSERT(admitted +
+                       shaper.get_dropped(rofl::openflow13::OFPR_NO_MATCH) ==
+                   result.num_sent[0]);
+
+    /* Packet-Ins with reason action are not limited */
+    CPPUNIT_ASSERT(shaper.get_admitted(rofl::openflow13::OFPR_ACTION) ==
+                   result.num_sent[1]);
+    CPPUNIT_ASSERT(shaper.get_dropped(rofl::openflow13::OFPR_ACTION) == 0);
+
+    /* frames are kept for queued table-miss Packet-Ins only, the most
+     * recent one is still stored */
+    CPPUNIT_ASSERT(shaper.get_buffered() == result.num_queued[0]);
+    CPPUNIT_ASSERT(shaper.get_evicted() == result.num_queued[0] - num_buffers);
+    rofl::cmemory mem;
+    CPPUNIT_ASSERT(ctl.set_packet_in_shaper().retrieve(stub.last_buffer_id,
+                                                       mem));
+    CPPUNIT_ASSERT(mem.length() == sizeof(frame));
+    CPPUNIT_ASSERT(memcmp(mem.somem(), frame, sizeof(frame)) == 0);
+
+    std::cerr << ctl.get_packet_in_shaper();
+  }
+
+  stub.keep_running = false;
+  pthread_join(tid, NULL);
+  close(stub.sd);
+  close(lsd);
+  sleep(1);
+  delete base;
+
+  return result;
+}
+
+void crofctltest::test_packet_in_flood() {
+  /* a short flood suffices for the checks, ROFL_BENCH runs a longer one */
+  double secs = testutil::bench_size(1.0, 0.25);
+
+  /* without shaping, table-miss Packet-Ins fill the TX queue and
+   * Packet-Ins with reason action are lost as well */
+  flood_result_t unshaped = run_packet_in_flood(false, secs);
+  CPPUNIT_ASSERT(unshaped.num_sent[1] >= 990 * secs);
+  CPPUNIT_ASSERT(unshaped.num_received[1] < 0.9 * unshaped.num_sent[1]);
+
+  /* with shaping, all Packet-Ins with reason action are delivered, one
+   * per millisecond */
+  flood_result_t shaped = run_packet_in_flood(true, secs);
+  CPPUNIT_ASSERT(shaped.num_sent[1] >= 990 * secs);
+  CPPUNIT_ASSERT(shaped.num_received[1] == shaped.num_sent[1]);
+}
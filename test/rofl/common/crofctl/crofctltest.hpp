@@ -0,0 +1,47 @@
+/*
+ * crofctltest.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef TEST_SRC_ROFL_COMMON_CROFCTLTEST_HPP_
+#define TEST_SRC_ROFL_COMMON_CROFCTLTEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "rofl/common/cpacketinshaper.h"
+#include "rofl/common/crofbase.h"
+
+class crofctltest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(crofctltest);
+  CPPUNIT_TEST(test_rate_limit);
+  CPPUNIT_TEST(test_buffers);
+  CPPUNIT_TEST(test_packet_in_flood);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+public:
+  void test_rate_limit();
+  void test_buffers();
+  void test_packet_in_flood();
+
+private:
+  struct flood_result_t {
+    // Packet-Ins sent per reason
+    unsigned int num_sent[2];
+    // Packet-Ins queued per reason
+    unsigned int num_queued[2];
+    // Packet-Ins received by the controller per reason
+    unsigned int num_received[2];
+  };
+
+  /* floods table-miss Packet-Ins for secs seconds and sends a Packet-In
+   * with reason action every millisecond */
+  flood_result_t run_packet_in_flood(bool shaped, double secs);
+};
+
+#endif /* TEST_SRC_ROFL_COMMON_CROFCTLTEST_HPP_ */
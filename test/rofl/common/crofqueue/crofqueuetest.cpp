@@ -5,11 +5,15 @@
  *      Author: andi
  */
 
+#include <pthread.h>
+#include <sched.h>
 #include <stdlib.h>
+#include <time.h>
 
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
 
+#include "../testutil.hpp"
 #include "crofqueuetest.hpp"
 
 using namespace rofl::openflow;
@@ -91,3 +95,291 @@ void crofqueuetest::test2() {
   CPPUNIT_ASSERT(queue.size() == 0);
   CPPUNIT_ASSERT(queue.empty());
 }
+
+void crofqueuetest::test_front_pop() {
+  rofl::crofqueue queue;
+
+  queue.set_queue_max_size(4);
+  CPPUNIT_ASSERT(queue.front_length() == 0);
+  CPPUNIT_ASSERT(queue.retrieve() == nullptr);
+
+  /* exceed the ring, so that enforced messages use the overflow list */
+  for (uint32_t xid = 0; xid < 64; xid++) {
+    queue.store(new rofl::openflow::cofmsg(rofl::openflow13::OFP_VERSION,
+                                           rofl::openflow13::OFPT_HELLO, xid),
+                true);
+  }
+  CPPUNIT_ASSERT(queue.size() == 64);
+  CPPUNIT_ASSERT(queue.capacity() == 0);
+
+  for (uint32_t xid = 0; xid < 64; xid++) {
+    size_t msglen = queue.front_length();
+    CPPUNIT_ASSERT(msglen == sizeof(struct rofl::openflow::ofp_header));
+    /* a message exceeding max_length stays in the queue */
+    CPPUNIT_ASSERT(queue.retrieve(msglen - 1) == nullptr);
+    rofl::openflow::cofmsg *msg = queue.retrieve(msglen);
+    CPPUNIT_ASSERT(msg != nullptr);
+    CPPUNIT_ASSERT(msg->get_xid() == xid);
+    delete msg;
+
+    /* ring slots are free again, but order must be preserved */
+    if (xid == 8) {
+      queue.store(new rofl::openflow::cofmsg(
+                      rofl::openflow13::OFP_VERSION,
+                      rofl::openflow13::OFPT_HELLO, 64),
+                  true);
+    }
+  }
+
+  rofl::openflow::cofmsg *msg = queue.retrieve();
+  CPPUNIT_ASSERT(msg != nullptr);
+  CPPUNIT_ASSERT(msg->get_xid() == 64);
+  delete msg;
+
+  CPPUNIT_ASSERT(queue.empty());
+  CPPUNIT_ASSERT(queue.capacity() == 4);
+}
+
+namespace {
+
+template <class queue_t> struct producer_arg {
+  queue_t *queue;
+  rofl::openflow::cofmsg *msg;
+  unsigned int producer_id;
+  unsigned int num_msgs;
+};
+
+/* stores messages with increasing xids, ignoring max size */
+void *run_mpsc_producer(void *arg) {
+  producer_arg<rofl::crofqueue> *parg = (producer_arg<rofl::crofqueue> *)arg;
+  for (unsigned int seq = 0; seq < parg->num_msgs; seq++) {
+    parg->queue->store(new rofl::openflow::cofmsg(
+                           rofl::openflow13::OFP_VERSION,
+                           rofl::openflow13::OFPT_HELLO,
+                           (parg->producer_id << 24) | seq),
+                       true);
+  }
+  return nullptr;
+}
+
+/* stores the same message repeatedly, waiting for free capacity */
+template <class queue_t> void *run_contention_producer(void *arg) {
+  producer_arg<queue_t> *parg = (producer_arg<queue_t> *)arg;
+  for (unsigned int seq = 0; seq < parg->num_msgs; seq++) {
+    while (parg->queue->capacity() == 0) {
+      sched_yield();
+    }
+    parg->queue->store(parg->msg, true);
+  }
+  return nullptr;
+}
+
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+}; // namespace
+
+namespace {
+
+struct clear_arg {
+  rofl::crofqueue *queue;
+  std::atomic_bool keep_running;
+};
+
+/* drops all messages while the consumer is peeking and retrieving */
+void *run_clear(void *arg) {
+  clear_arg *carg = (clear_arg *)arg;
+  while (carg->keep_running) {
+    carg->queue->clear();
+    sched_yield();
+  }
+  return nullptr;
+}
+
+}; // namespace
+
+void crofqueuetest::test_concurrent_clear() {
+  const unsigned int num_msgs = 20000;
+  rofl::crofqueue queue;
+  queue.set_queue_max_size(64);
+
+  producer_arg<rofl::crofqueue> parg;
+  parg.queue = &queue;
+  parg.msg = nullptr;
+  parg.producer_id = 1;
+  parg.num_msgs = num_msgs;
+  clear_arg carg;
+  carg.queue = &queue;
+  carg.keep_running = true;
+
+  pthread_t producer, clearer;
+  CPPUNIT_ASSERT(pthread_create(&producer, NULL, run_mpsc_producer, &parg) ==
+                 0);
+  CPPUNIT_ASSERT(pthread_create(&clearer, NULL, run_clear, &carg) == 0);
+
+  /* messages handed out are never deleted by clear(), xids of the
+   * surviving messages still increase */
+  unsigned int received = 0, next_seq = 0;
+  bool producing = true;
+  while (producing || not queue.empty()) {
+    if (producing && (pthread_tryjoin_np(producer, NULL) == 0)) {
+      producing = false;
+    }
+    size_t msglen = queue.front_length();
+    if (msglen == 0) {
+      sched_yield();
+      continue;
+    }
+    rofl::openflow::cofmsg *msg = queue.retrieve(msglen);
+    if (msg == nullptr) {
+      continue;
+    }
+    CPPUNIT_ASSERT(msg->length() == msglen);
+    CPPUNIT_ASSERT((msg->get_xid() >> 24) == 1);
+    CPPUNIT_ASSERT((msg->get_xid() & 0xffffff) >= next_seq);
+    next_seq = (msg->get_xid() & 0xffffff) + 1;
+    received++;
+    delete msg;
+  }
+
+  carg.keep_running = false;
+  pthread_join(clearer, NULL);
+  CPPUNIT_ASSERT(received <= num_msgs);
+  CPPUNIT_ASSERT(queue.empty());
+}
+
+void crofqueuetest::test_mpsc() {
+  const unsigned int num_producers = 4;
+  const unsigned int num_msgs = 20000;
+  rofl::crofqueue queue;
+  queue.set_queue_max_size(64);
+
+  std::vector<producer_arg<rofl::crofqueue>> args(num_producers);
+  std::vector<pthread_t> tids(num_producers);
+  for (unsigned int i = 0; i < num_producers; i++) {
+    args[i].queue = &queue;
+    args[i].msg = nullptr;
+    args[i].producer_id = i;
+    args[i].num_msgs = num_msgs;
+    CPPUNIT_ASSERT(
+        pthread_create(&tids[i], NULL, run_mpsc_producer, &args[i]) == 0);
+  }
+
+  /* single consumer, messages of each producer must arrive in order */
+  std::vector<unsigned int> next_seq(num_producers, 0);
+  unsigned int received = 0;
+  while (received < num_producers * num_msgs) {
+    rofl::openflow::cofmsg *msg = queue.retrieve();
+    if (msg == nullptr) {
+      sched_yield();
+      continue;
+    }
+    unsigned int producer_id = msg->get_xid() >> 24;
+    CPPUNIT_ASSERT(producer_id < num_producers);
+    CPPUNIT_ASSERT((msg->get_xid() & 0x00ffffff) == next_seq[producer_id]);
+    next_seq[producer_id]++;
+    received++;
+    delete msg;
+  }
+
+  for (unsigned int i = 0; i < num_producers; i++) {
+    pthread_join(tids[i], NULL);
+  }
+  CPPUNIT_ASSERT(queue.empty());
+}
+
+template <class queue_t>
+double crofqueuetest::run_contention(unsigned int num_producers,
+                                     unsigned int num_msgs) {
+  queue_t queue;
+  queue.set_queue_max_size(1024);
+  rofl::openflow::cofmsg msg(rofl::openflow13::OFP_VERSION,
+                             rofl::openflow13::OFPT_HELLO, 0);
+
+  std::vector<producer_arg<queue_t>> args(num_producers);
+  std::vector<pthread_t> tids(num_producers);
+  double start = now();
+  for (unsigned int i = 0; i < num_producers; i++) {
+    args[i].queue = &queue;
+    args[i].msg = &msg;
+    args[i].producer_id = i;
+    args[i].num_msgs = num_msgs;
+    CPPUNIT_ASSERT(pthread_create(&tids[i], NULL,
+                                  run_contention_producer<queue_t>,
+                                  &args[i]) == 0);
+  }
+
+  unsigned int received = 0;
+  while (received < num_producers * num_msgs) {
+    if (queue.retrieve() == nullptr) {
+      sched_yield();
+      continue;
+    }
+    received++;
+  }
+  double elapsed = now() - start;
+
+  for (unsigned int i = 0; i < num_producers; i++) {
+    pthread_join(tids[i], NULL);
+  }
+  return elapsed;
+}
+
+void crofqueuetest::test_contention() {
+  const unsigned int num_msgs = testutil::bench_size(200000, 10000);
+  for (unsigned int num_producers : {1, 2, 4, 8}) {
+    double t_locked =
+        run_contention<crofqueue_locked>(num_producers, num_msgs);
+    double t_mpsc = run_contention<rofl::crofqueue>(num_producers, num_msgs);
+    double total = (double)num_producers * num_msgs;
+    std::cerr << "producers=" << num_producers
+              << " locked: " << (unsigned int)(total / t_locked) << " msgs/s"
+              << " mpsc: " << (unsigned int)(total / t_mpsc) << " msgs/s"
+              << " speedup: " << t_locked / t_mpsc << std::endl;
+  }
+}
+
+void crofqueuetest::test_full_queue() {
+  const unsigned int num_msgs = 100000;
+  rofl::crofqueue queue;
+  queue.set_queue_max_size(4);
+  rofl::openflow::cofmsg *msg = new rofl::openflow::cofmsg(
+      rofl::openflow13::OFP_VERSION, rofl::openflow13::OFPT_HELLO, 0);
+
+  for (unsigned int i = 0; i < 4; i++) {
+    CPPUNIT_ASSERT(queue.try_store(new rofl::openflow::cofmsg(
+                       rofl::openflow13::OFP_VERSION,
+                       rofl::openflow13::OFPT_HELLO, i)) == i + 1);
+  }
+
+  /* full queue: try_store fails and leaves msg with the caller */
+  CPPUNIT_ASSERT(queue.try_store(msg) == 0);
+  CPPUNIT_ASSERT(queue.size() == 4);
+  CPPUNIT_ASSERT_THROW(queue.store(msg), rofl::eRofQueueFull);
+
+  double start = now();
+  for (unsigned int i = 0; i < num_msgs; i++) {
+    try {
+      queue.store(msg);
+    } catch (rofl::eRofQueueFull &e) {
+    }
+  }
+  double t_throw = now() - start;
+
+  start = now();
+  unsigned int failed = 0;
+  for (unsigned int i = 0; i < num_msgs; i++) {
+    failed += (queue.try_store(msg) == 0);
+  }
+  double t_try = now() - start;
+  CPPUNIT_ASSERT(failed == num_msgs);
+
+  std::cerr << "full queue: store/catch: " << t_throw * 1e9 / num_msgs
+            << " ns/msg try_store: " << t_try * 1e9 / num_msgs
+            << " ns/msg speedup: " << t_throw / t_try << std::endl;
+
+  delete msg;
+}
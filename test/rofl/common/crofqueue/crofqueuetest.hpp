@@ -11,12 +11,59 @@
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <list>
+
 #include "rofl/common/crofqueue.h"
 
+/* former std::list based crofqueue, reference for benchmarks */
+class crofqueue_locked {
+public:
+  size_t store(rofl::openflow::cofmsg *msg, bool enforce = false) {
+    rofl::AcquireReadWriteLock rwlock(queue_lock);
+    if ((not enforce) && (queue.size() >= queue_max_size)) {
+      throw rofl::eRofQueueFull("crofqueue_locked::store() queue max size "
+                                "exceeded");
+    }
+    queue.push_back(msg);
+    return queue.size();
+  };
+
+  rofl::openflow::cofmsg *retrieve() {
+    rofl::AcquireReadWriteLock rwlock(queue_lock);
+    if (queue.empty()) {
+      return nullptr;
+    }
+    rofl::openflow::cofmsg *msg = queue.front();
+    queue.pop_front();
+    return msg;
+  };
+
+  size_t capacity() const {
+    rofl::AcquireReadLock rwlock(queue_lock);
+    return (queue.size() < queue_max_size) ? (queue_max_size - queue.size())
+                                           : 0;
+  };
+
+  crofqueue_locked &set_queue_max_size(size_t queue_max_size) {
+    this->queue_max_size = queue_max_size;
+    return *this;
+  };
+
+private:
+  std::list<rofl::openflow::cofmsg *> queue;
+  mutable rofl::crwlock queue_lock;
+  size_t queue_max_size;
+};
+
 class crofqueuetest : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(crofqueuetest);
   CPPUNIT_TEST(test1);
   CPPUNIT_TEST(test2);
+  CPPUNIT_TEST(test_front_pop);
+  CPPUNIT_TEST(test_concurrent_clear);
+  CPPUNIT_TEST(test_mpsc);
+  CPPUNIT_TEST(test_contention);
+  CPPUNIT_TEST(test_full_queue);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -26,6 +73,15 @@ public:
 public:
   void test1();
   void test2();
+  void test_front_pop();
+  void test_concurrent_clear();
+  void test_mpsc();
+  void test_contention();
+  void test_full_queue();
+
+private:
+  template <class queue_t>
+  double run_contention(unsigned int num_producers, unsigned int num_msgs);
 };
 
 #endif /* TEST_SRC_ROFL_COMMON_OPENFLOW_MESSAGES_COFMSGAGGRSTATS_TEST_HPP_ */
@@ -0,0 +1,130 @@
+/*
+ * crofschedtest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <iostream>
+#include <unistd.h>
+
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include "crofschedtest.hpp"
+
+CPPUNIT_TEST_SUITE_REGISTRATION(crofschedtest);
+
+void crofschedtest::setUp() { queues.clear(); }
+
+void crofschedtest::tearDown() {}
+
+std::vector<size_t> crofschedtest::run(rofl::crofsched &sched,
+                                       unsigned int num) {
+  std::vector<size_t> bytes(queues.size(), 0);
+  for (unsigned int i = 0; i < num; i++) {
+    unsigned int queue_id = sched.select([&](unsigned int queue_id) {
+      return queues[queue_id].empty() ? 0 : queues[queue_id].front();
+    });
+    if (queue_id >= queues.size()) {
+      break;
+    }
+    size_t msglen = queues[queue_id].front();
+    queues[queue_id].pop_front();
+    sched.dequeued(queue_id, msglen);
+    bytes[queue_id] += msglen;
+  }
+  return bytes;
+}
+
+void crofschedtest::test_empty() {
+  rofl::crofsched sched(4);
+  queues.resize(4);
+
+  CPPUNIT_ASSERT(sched.get_num_queues() == 4);
+  CPPUNIT_ASSERT(sched.select([](unsigned int queue_id) { return 0; }) == 4);
+  CPPUNIT_ASSERT(run(sched, 16) == std::vector<size_t>(4, 0));
+  CPPUNIT_ASSERT_THROW(sched.set_quantum(4, 1024), rofl::eInvalid);
+  CPPUNIT_ASSERT_THROW(sched.get_msgs(4), rofl::eInvalid);
+}
+
+void crofschedtest::test_byte_fairness() {
+  rofl::crofsched sched(3, 8192);
+  sched.set_strict_priority(0);
+  queues.resize(3);
+
+  /* multipart segments in queue 1, small messages in queue 2 */
+  queues[1].assign(1000, 65535);
+  queues[2].assign(1000000, 100);
+
+  std::vector<size_t> bytes = run(sched, 20000);
+  size_t total = bytes[1] + bytes[2];
+  std::cerr << "bytes queue 1: " << bytes[1] << " queue 2: " << bytes[2]
+            << std::endl;
+  CPPUNIT_ASSERT(bytes[0] == 0);
+  CPPUNIT_ASSERT(bytes[1] > total * 0.4);
+  CPPUNIT_ASSERT(bytes[2] > total * 0.4);
+  CPPUNIT_ASSERT(sched.get_bytes(1) == bytes[1]);
+  CPPUNIT_ASSERT(sched.get_msgs(2) == bytes[2] / 100);
+}
+
+void crofschedtest::test_quantum() {
+  rofl::crofsched sched(2);
+  sched.set_quantum(0, 8192).set_quantum(1, 2048);
+  CPPUNIT_ASSERT(sched.get_quantum(0) == 8192);
+  CPPUNIT_ASSERT(sched.get_quantum(1) == 2048);
+  CPPUNIT_ASSERT(sched.get_round_bytes() == 10240);
+  queues.resize(2);
+  queues[0].assign(100000, 128);
+  queues[1].assign(100000, 128);
+
+  std::vector<size_t> bytes = run(sched, 50000);
+  double ratio = (double)bytes[0] / bytes[1];
+  std::cerr << "ratio: " << ratio << std::endl;
+  CPPUNIT_ASSERT((ratio > 3.8) && (ratio < 4.2));
+}
+
+void crofschedtest::test_strict_priority() {
+  rofl::crofsched sched(3, 1024);
+  sched.set_strict_priority(0);
+  CPPUNIT_ASSERT(sched.get_strict_priority(0));
+  CPPUNIT_ASSERT(not sched.get_strict_priority(1));
+  queues.resize(3);
+  queues[0].assign(10, 16);
+  queues[1].assign(1000, 1500);
+  queues[2].assign(1000, 64);
+
+  std::vector<size_t> bytes = run(sched, 10);
+  CPPUNIT_ASSERT(bytes[0] == 160);
+  CPPUNIT_ASSERT(queues[0].empty());
+
+  run(sched, 100);
+  queues[0].assign(1, 16);
+  bytes = run(sched, 1);
+  CPPUNIT_ASSERT(bytes[0] == 16);
+
+  /* strict priority queue is not accounted */
+  CPPUNIT_ASSERT(sched.get_msgs(0) == 11);
+}
+
+void crofschedtest::test_latency() {
+  rofl::crofsched sched(2);
+  rofl::crofqueue queue;
+
+  queue.store(new rofl::openflow::cofmsg(rofl::openflow13::OFP_VERSION,
+                                         rofl::openflow13::OFPT_HELLO, 1));
+  usleep(2000);
+  rofl::openflow::cofmsg *msg = queue.retrieve();
+  sched.dequeued(1, msg->length(), queue.get_stored_ns());
+  delete msg;
+
+  std::cerr << sched;
+  CPPUNIT_ASSERT(sched.get_msgs(1) == 1);
+  CPPUNIT_ASSERT(sched.get_bytes(1) == 8);
+  CPPUNIT_ASSERT(sched.get_latency_avg(1) >= 2000000);
+  CPPUNIT_ASSERT(sched.get_latency_max(1) >= sched.get_latency_avg(1));
+  CPPUNIT_ASSERT(sched.get_latency_avg(0) == 0);
+
+  sched.clear_stats();
+  CPPUNIT_ASSERT(sched.get_msgs(1) == 0);
+  CPPUNIT_ASSERT(sched.get_latency_max(1) == 0);
+}
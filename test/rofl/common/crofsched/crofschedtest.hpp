@@ -0,0 +1,47 @@
+/*
+ * crofschedtest.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef TEST_SRC_ROFL_COMMON_CROFSCHEDTEST_HPP_
+#define TEST_SRC_ROFL_COMMON_CROFSCHEDTEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <deque>
+#include <vector>
+
+#include "rofl/common/crofqueue.h"
+#include "rofl/common/crofsched.h"
+
+class crofschedtest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(crofschedtest);
+  CPPUNIT_TEST(test_empty);
+  CPPUNIT_TEST(test_byte_fairness);
+  CPPUNIT_TEST(test_quantum);
+  CPPUNIT_TEST(test_strict_priority);
+  CPPUNIT_TEST(test_latency);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+public:
+  void test_empty();
+  void test_byte_fairness();
+  void test_quantum();
+  void test_strict_priority();
+  void test_latency();
+
+private:
+  /* dequeue num messages and return bytes sent per queue */
+  std::vector<size_t> run(rofl::crofsched &sched, unsigned int num);
+
+  // message lengths waiting in each queue
+  std::vector<std::deque<size_t>> queues;
+};
+
+#endif /* TEST_SRC_ROFL_COMMON_CROFSCHEDTEST_HPP_ */
@@ -5,12 +5,25 @@
  *      Author: andi
  */
 
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <sstream>
+
+#include <openssl/evp.h>
+#include <openssl/pem.h>
+#include <openssl/x509.h>
 
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
 #include <glog/logging.h>
 
+#include "../testutil.hpp"
 #include "crofsocktest.hpp"
 
 using namespace rofl::openflow;
@@ -48,6 +61,67 @@ using namespace rofl::openflow;
 
 CPPUNIT_TEST_SUITE_REGISTRATION(crofsocktest);
 
+namespace {
+
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* self-signed certificate usable as CA, client and server certificate */
+bool write_tls_credentials(const std::string &certfile,
+                           const std::string &keyfile) {
+  bool result = false;
+  EVP_PKEY *pkey = NULL;
+  X509 *x509 = NULL;
+  FILE *fp = NULL;
+
+  EVP_PKEY_CTX *pctx = EVP_PKEY_CTX_new_id(EVP_PKEY_EC, NULL);
+  if ((NULL == pctx) || (EVP_PKEY_keygen_init(pctx) <= 0) ||
+      (EVP_PKEY_CTX_set_ec_paramgen_curve_nid(pctx, NID_X9_62_prime256v1) <=
+       0) ||
+      (EVP_PKEY_keygen(pctx, &pkey) <= 0)) {
+    goto out;
+  }
+
+  if ((x509 = X509_new()) == NULL) {
+    goto out;
+  }
+  X509_set_version(x509, 2);
+  ASN1_INTEGER_set(X509_get_serialNumber(x509), 1);
+  X509_gmtime_adj(X509_getm_notBefore(x509), -3600);
+  X509_gmtime_adj(X509_getm_notAfter(x509), 86400);
+  X509_set_pubkey(x509, pkey);
+  X509_NAME_add_entry_by_txt(X509_get_subject_name(x509), "CN", MBSTRING_ASC,
+                             (const unsigned char *)"crofsocktest", -1, -1, 0);
+  X509_set_issuer_name(x509, X509_get_subject_name(x509));
+  if (X509_sign(x509, pkey, EVP_sha256()) <= 0) {
+    goto out;
+  }
+
+  if ((fp = fopen(certfile.c_str(), "w")) == NULL) {
+    goto out;
+  }
+  result = PEM_write_X509(fp, x509);
+  fclose(fp);
+
+  if ((fp = fopen(keyfile.c_str(), "w")) == NULL) {
+    result = false;
+    goto out;
+  }
+  result &= PEM_write_PrivateKey(fp, pkey, NULL, NULL, 0, NULL, NULL);
+  fclose(fp);
+
+out:
+  X509_free(x509);
+  EVP_PKEY_free(pkey);
+  EVP_PKEY_CTX_free(pctx);
+  return result;
+}
+
+}; // namespace
+
 void crofsocktest::setUp() {
   baddr = rofl::csockaddr(AF_INET, "0.0.0.0", 0);
   server_msg_counter = 0;
@@ -136,6 +210,192 @@ void crofsocktest::test() {
   }
 }
 
+void crofsocktest::test_rx_batch() {
+  try {
+    for (auto rx_mode :
+         {rofl::crofsock::RX_MODE_MESSAGE, rofl::crofsock::RX_MODE_BATCH}) {
+      std::cerr << "TCP RX MODE (" << rx_mode << ") START" << std::endl;
+      test_mode = TEST_MODE_TCP_RX_BATCH;
+      keep_running = true;
+      timeout = 60;
+      rx_batch_num_msgs = 10000;
+      rx_disable_at = 100;
+      listening_port = 6653;
+      server_msg_counter = 0;
+      client_msg_counter = 0;
+
+      slisten = new rofl::crofsock(this);
+      sclient = new rofl::crofsock(this);
+      sserver = nullptr;
+      rx_mode_server = rx_mode;
+
+      /* try to find idle port for test */
+      bool lookup_idle_port = true;
+      while (lookup_idle_port) {
+        try {
+          baddr =
+              rofl::csockaddr(rofl::caddress_in4("127.0.0.1"), listening_port);
+          slisten->set_baddr(baddr).listen();
+          lookup_idle_port = false;
+          break;
+        } catch (rofl::eSysCall &e) {
+          /* port in use, try another one */
+        }
+        do {
+          listening_port = rand.uint16();
+        } while ((listening_port < 10000) || (listening_port > 49000));
+      }
+
+      /* single message per send call vs. coalesced transmission */
+      if (rofl::crofsock::RX_MODE_MESSAGE == rx_mode) {
+        sclient->set_tx_batch_budget(0, 0);
+      }
+
+      sclient->set_raddr(baddr).tcp_connect(false);
+
+      /* no message is handed over while reception is disabled, not even
+       * those already read into rxbuffer */
+      for (int i = 0; (server_msg_counter < rx_disable_at) && (i < 60000);
+           i++) {
+        usleep(1000);
+      }
+      usleep(100000);
+      CPPUNIT_ASSERT(server_msg_counter == rx_disable_at);
+      CPPUNIT_ASSERT(sserver->is_rx_disabled());
+      sserver->rx_enable();
+
+      while (keep_running && (--timeout > 0)) {
+        struct timespec ts;
+        ts.tv_sec = 1;
+        ts.tv_nsec = 0;
+        pselect(0, NULL, NULL, NULL, &ts, NULL);
+      }
+
+      CPPUNIT_ASSERT(timeout > 0);
+      CPPUNIT_ASSERT(server_msg_counter == rx_batch_num_msgs);
+      CPPUNIT_ASSERT(sclient->get_tx_messages() == (uint64_t)rx_batch_num_msgs);
+
+      std::cerr << "tx_batch_bytes: " << sclient->get_tx_batch_bytes()
+                << " messages: " << sclient->get_tx_messages()
+                << " syscalls: " << sclient->get_tx_syscalls()
+                << " messages/syscall: "
+                << (double)sclient->get_tx_messages() /
+                       (double)sclient->get_tx_syscalls()
+                << std::endl;
+      CPPUNIT_ASSERT(sserver->get_rx_messages() == (uint64_t)rx_batch_num_msgs);
+
+      std::cerr << "rx_mode: " << rx_mode
+                << " messages: " << sserver->get_rx_messages()
+                << " syscalls: " << sserver->get_rx_syscalls()
+                << " messages/syscall: "
+                << (double)sserver->get_rx_messages() /
+                       (double)sserver->get_rx_syscalls()
+                << std::endl;
+
+      slisten->close();
+      sclient->close();
+      sserver->close();
+
+      sleep(1);
+
+      delete slisten;
+      delete sclient;
+      delete sserver;
+
+      std::cerr << "TCP RX MODE (" << rx_mode << ") END" << std::endl;
+    }
+
+  } catch (rofl::eSysCall &e) {
+    LOG(INFO) << "crofsocktest::test_rx_batch() exception, what: " << e.what()
+              << std::endl;
+  } catch (std::runtime_error &e) {
+    LOG(INFO) << "crofsocktest::test_rx_batch() exception, what: " << e.what()
+              << std::endl;
+  }
+}
+
+double crofsocktest::run_packet_out(size_t framelen, int num_msgs,
+                                    bool zero_copy) {
+  test_mode = TEST_MODE_TCP_PACKET_OUT;
+  keep_running = true;
+  timeout = 6000; // 10ms steps
+  rx_batch_num_msgs = num_msgs;
+  listening_port = 6653;
+  server_msg_counter = 0;
+  packet_out_errors = 0;
+  packet_out_zero_copy = zero_copy;
+
+  std::shared_ptr<rofl::cmemory> frame(new rofl::cmemory(framelen));
+  for (size_t i = 0; i < framelen; i++) {
+    (*frame)[i] = i & 0xff;
+  }
+  packet_out_frame = frame;
+
+  slisten = new rofl::crofsock(this);
+  sclient = new rofl::crofsock(this);
+  sserver = nullptr;
+
+  /* try to find idle port for test */
+  bool lookup_idle_port = true;
+  while (lookup_idle_port) {
+    try {
+      baddr = rofl::csockaddr(rofl::caddress_in4("127.0.0.1"), listening_port);
+      slisten->set_baddr(baddr).listen();
+      lookup_idle_port = false;
+      break;
+    } catch (rofl::eSysCall &e) {
+      /* port in use, try another one */
+    }
+    do {
+      listening_port = rand.uint16();
+    } while ((listening_port < 10000) || (listening_port > 49000));
+  }
+
+  double start = now();
+  sclient->set_raddr(baddr).tcp_connect(false);
+
+  while (keep_running && (--timeout > 0)) {
+    struct timespec ts;
+    ts.tv_sec = 0;
+    ts.tv_nsec = 10000000;
+    pselect(0, NULL, NULL, NULL, &ts, NULL);
+  }
+  double elapsed = now() - start;
+
+  CPPUNIT_ASSERT(timeout > 0);
+  CPPUNIT_ASSERT(server_msg_counter == num_msgs);
+  CPPUNIT_ASSERT(packet_out_errors == 0);
+
+  slisten->close();
+  sclient->close();
+  sserver->close();
+
+  sleep(1);
+
+  delete slisten;
+  delete sclient;
+  delete sserver;
+
+  packet_out_frame.reset();
+  return num_msgs / elapsed;
+}
+
+void crofsocktest::test_packet_out() {
+  const struct {
+    size_t framelen;
+    int num_msgs;
+  } runs[] = {{64, 50000}, {1500, 20000}, {9000, 5000}};
+
+  for (auto &run : runs) {
+    double copy = run_packet_out(run.framelen, run.num_msgs, false);
+    double zero_copy = run_packet_out(run.framelen, run.num_msgs, true);
+    std::cerr << "packet-out " << run.framelen << "B: copy " << (int)copy
+              << " msgs/s, zero-copy " << (int)zero_copy << " msgs/s ("
+              << zero_copy * run.framelen * 8 / 1e9 << " Gbit/s)"
+              << std::endl;
+  }
+}
+
 void crofsocktest::test_tls() {
   try {
     for (unsigned int i = 0; i < 2; i++) {
@@ -214,6 +474,166 @@ void crofsocktest::test_tls() {
   }
 }
 
+double crofsocktest::run_tls_setup(int num_conns, bool session_reuse,
+                                   int &num_reused) {
+  test_mode = TEST_MODE_TLS_SETUP_RATE;
+  /* not 6653, sockets of test_tls may still try to reconnect there */
+  do {
+    listening_port = rand.uint16();
+  } while ((listening_port < 10000) || (listening_port > 49000));
+  client_msg_counter = 0;
+  num_reused = 0;
+
+  slisten = new rofl::crofsock(this);
+  sclient = new rofl::crofsock(this);
+
+  /* try to find idle port for test */
+  bool lookup_idle_port = true;
+  while (lookup_idle_port) {
+    try {
+      baddr = rofl::csockaddr(rofl::caddress_in4("127.0.0.1"), listening_port);
+      slisten->set_baddr(baddr).listen();
+      lookup_idle_port = false;
+      break;
+    } catch (rofl::eSysCall &e) {
+      /* port in use, try another one */
+    }
+    do {
+      listening_port = rand.uint16();
+    } while ((listening_port < 10000) || (listening_port > 49000));
+  }
+
+  sclient->set_raddr(baddr)
+      .set_tls_cafile(tls_certfile)
+      .set_tls_certfile(tls_certfile)
+      .set_tls_keyfile(tls_keyfile)
+      .set_tls_session_reuse(session_reuse);
+
+  /* a single client reconnecting over and over again, as after
+   * backoff_reconnect(); each connection is done once the client has
+   * received a message from the server, i.e. any session ticket sent
+   * by the server has been consumed as well */
+  double start = now();
+  for (int i = 0; i < num_conns; i++) {
+    client_msg_counter = 0;
+    /* tcp_connect() binds to laddr, which holds the local port of the
+     * previous connection, still in use until the server closes it */
+    sclient->set_laddr(rofl::csockaddr());
+    sclient->tls_connect(false);
+
+    double deadline = now() + 10;
+    while ((client_msg_counter == 0) && (now() < deadline)) {
+      pthread_yield();
+    }
+    CPPUNIT_ASSERT(client_msg_counter > 0);
+
+    if (sclient->is_tls_session_reused()) {
+      num_reused++;
+    }
+
+    /* client and server use identical TLS parameters */
+    CPPUNIT_ASSERT(rofl::ctlscontext::size() == 1);
+
+    sclient->close();
+  }
+  double elapsed = now() - start;
+
+  slisten->close();
+
+  sleep(1);
+
+  delete slisten;
+  delete sclient;
+  {
+    rofl::AcquireReadWriteLock lock(tlock);
+    for (auto server : sservers) {
+      server->close();
+      delete server;
+    }
+    sservers.clear();
+  }
+
+  /* last reference dropped */
+  CPPUNIT_ASSERT(rofl::ctlscontext::size() == 0);
+
+  return num_conns / elapsed;
+}
+
+void crofsocktest::test_tls_setup_rate() {
+  const int num_conns = testutil::bench_size(500, 50);
+
+  /* SSL_shutdown() on server sockets may write to already closed peers */
+  signal(SIGPIPE, SIG_IGN);
+
+  std::stringstream ss;
+  ss << "/tmp/crofsocktest." << getpid();
+  tls_certfile = ss.str() + ".crt.pem";
+  tls_keyfile = ss.str() + ".key.pem";
+  CPPUNIT_ASSERT(write_tls_credentials(tls_certfile, tls_keyfile));
+
+  int reused_full = 0, reused_resumed = 0;
+  uint64_t misses = rofl::ctlscontext::get_misses();
+  uint64_t hits = rofl::ctlscontext::get_hits();
+  double full = run_tls_setup(num_conns, false, reused_full);
+  double resumed = run_tls_setup(num_conns, true, reused_resumed);
+
+  unlink(tls_certfile.c_str());
+  unlink(tls_keyfile.c_str());
+
+  std::cerr << "TLS setup: full handshake " << (int)full
+            << " conns/s, resumed " << (int)resumed << " conns/s ("
+            << reused_resumed << "/" << num_conns << " sessions reused), "
+            << "context cache hits: " << rofl::ctlscontext::get_hits() - hits
+            << " misses: " << rofl::ctlscontext::get_misses() - misses
+            << std::endl;
+
+  /* one context per run, shared by client and all server sockets */
+  CPPUNIT_ASSERT(rofl::ctlscontext::get_misses() - misses == 2);
+  CPPUNIT_ASSERT(rofl::ctlscontext::get_hits() - hits ==
+                 (uint64_t)(2 * num_conns));
+
+  CPPUNIT_ASSERT(reused_full == 0);
+  CPPUNIT_ASSERT(reused_resumed == num_conns - 1);
+}
+
+void crofsocktest::test_tls_context_reload() {
+  std::stringstream ss;
+  ss << "/tmp/crofsocktest." << getpid();
+  rofl::ctlscontext::params_t params;
+  params.certfile = params.cafile = ss.str() + ".crt.pem";
+  params.keyfile = ss.str() + ".key.pem";
+  params.verify_depth = "1";
+  CPPUNIT_ASSERT(write_tls_credentials(params.certfile, params.keyfile));
+
+  uint64_t reloads = rofl::ctlscontext::get_reloads();
+  SSL_CTX *ctx = rofl::ctlscontext::acquire(params);
+  CPPUNIT_ASSERT(rofl::ctlscontext::acquire(params) == ctx);
+  CPPUNIT_ASSERT(rofl::ctlscontext::is_current(ctx, params));
+
+  /* rotated certificate, file timestamps may be too coarse to tell */
+  CPPUNIT_ASSERT(write_tls_credentials(params.certfile, params.keyfile));
+  struct timespec times[2] = {{0, UTIME_NOW}, {time(NULL) + 60, 0}};
+  CPPUNIT_ASSERT(utimensat(AT_FDCWD, params.certfile.c_str(), times, 0) == 0);
+  CPPUNIT_ASSERT(not rofl::ctlscontext::is_current(ctx, params));
+
+  SSL_CTX *reloaded = rofl::ctlscontext::acquire(params);
+  CPPUNIT_ASSERT(reloaded != ctx);
+  CPPUNIT_ASSERT(rofl::ctlscontext::get_reloads() - reloads == 1);
+  CPPUNIT_ASSERT(rofl::ctlscontext::acquire(params) == reloaded);
+  CPPUNIT_ASSERT(rofl::ctlscontext::size() == 2);
+
+  unlink(params.certfile.c_str());
+  unlink(params.keyfile.c_str());
+
+  /* the old context lives until its last holder releases it */
+  rofl::ctlscontext::release(ctx);
+  rofl::ctlscontext::release(ctx);
+  CPPUNIT_ASSERT(rofl::ctlscontext::size() == 1);
+  rofl::ctlscontext::release(reloaded);
+  rofl::ctlscontext::release(reloaded);
+  CPPUNIT_ASSERT(rofl::ctlscontext::size() == 0);
+}
+
 void crofsocktest::handle_listen(rofl::crofsock &socket) {
   LOG(INFO) << "crofsocktest::handle_listen()" << std::endl;
 
@@ -227,6 +647,14 @@ void crofsocktest::handle_listen(rofl::crofsock &socket) {
     case TEST_MODE_TCP: {
       sserver->tcp_accept(sd);
 
+    } break;
+    case TEST_MODE_TCP_RX_BATCH: {
+      sserver->set_rx_mode(rx_mode_server).tcp_accept(sd);
+
+    } break;
+    case TEST_MODE_TCP_PACKET_OUT: {
+      sserver->tcp_accept(sd);
+
     } break;
     case TEST_MODE_TLS: {
       sserver->set_tls_cafile(cacert)
@@ -234,6 +662,16 @@ void crofsocktest::handle_listen(rofl::crofsock &socket) {
           .set_tls_keyfile(srvkey)
           .tls_accept(sd);
     } break;
+    case TEST_MODE_TLS_SETUP_RATE: {
+      {
+        rofl::AcquireReadWriteLock lock(tlock);
+        sservers.push_back(sserver);
+      }
+      sserver->set_tls_cafile(tls_certfile)
+          .set_tls_certfile(tls_certfile)
+          .set_tls_keyfile(tls_keyfile)
+          .tls_accept(sd);
+    } break;
     default: {};
     }
   }
@@ -258,6 +696,35 @@ void crofsocktest::handle_tcp_connected(rofl::crofsock &socket) {
 
     sclient->send_message(hello);
 
+  } break;
+  case TEST_MODE_TCP_RX_BATCH: {
+
+    /* burst of messages, enforce queueing beyond txqueue size */
+    for (int i = 0; i < rx_batch_num_msgs; i++) {
+      sclient->send_message(
+          new cofmsg_features_request(rofl::openflow13::OFP_VERSION, i), true);
+    }
+
+  } break;
+  case TEST_MODE_TCP_PACKET_OUT: {
+
+    rofl::openflow::cofactions actions(rofl::openflow13::OFP_VERSION);
+    actions.add_action_output(rofl::cindex(0))
+        .set_port_no(rofl::openflow13::OFPP_FLOOD);
+    for (int i = 0; i < rx_batch_num_msgs; i++) {
+      cofmsg_packet_out *msg = nullptr;
+      if (packet_out_zero_copy) {
+        msg = new cofmsg_packet_out(rofl::openflow13::OFP_VERSION, i,
+                                    rofl::openflow13::OFP_NO_BUFFER, 1,
+                                    actions, packet_out_frame);
+      } else {
+        msg = new cofmsg_packet_out(
+            rofl::openflow13::OFP_VERSION, i, rofl::openflow13::OFP_NO_BUFFER,
+            1, actions, packet_out_frame->somem(), packet_out_frame->length());
+      }
+      sclient->send_message(msg, true);
+    }
+
   } break;
   case TEST_MODE_TLS: {
 
@@ -311,7 +778,41 @@ void crofsocktest::congestion_occurred_indication(rofl::crofsock &socket) {
 
 void crofsocktest::handle_recv(rofl::crofsock &socket,
                                rofl::openflow::cofmsg *msg) {
+  if (TEST_MODE_TLS_SETUP_RATE == test_mode) {
+    delete msg;
+    if (&socket == sclient) {
+      client_msg_counter++;
+    }
+    return;
+  }
   rofl::AcquireReadWriteLock lock(tlock);
+  if (TEST_MODE_TCP_PACKET_OUT == test_mode) {
+    cofmsg_packet_out *packet_out = dynamic_cast<cofmsg_packet_out *>(msg);
+    if ((nullptr == packet_out) ||
+        (packet_out->get_packet().length() != packet_out_frame->length()) ||
+        (memcmp(packet_out->get_packet().soframe(), packet_out_frame->somem(),
+                packet_out_frame->length()) != 0)) {
+      packet_out_errors++;
+    }
+    delete msg;
+    if (++server_msg_counter == rx_batch_num_msgs) {
+      keep_running = false;
+    }
+    return;
+  }
+  if (TEST_MODE_TCP_RX_BATCH == test_mode) {
+    delete msg;
+    if (&socket == sserver) {
+      int counter = ++server_msg_counter;
+      if (counter == rx_disable_at) {
+        socket.rx_disable();
+      }
+      if (counter == rx_batch_num_msgs) {
+        keep_running = false;
+      }
+    }
+    return;
+  }
   if (&socket == sserver) {
     LOG(INFO) << "sserver => handle recv " << std::endl << *msg;
     delete msg;
@@ -358,6 +859,10 @@ void crofsocktest::handle_tls_connect_failed(rofl::crofsock &socket) {
 void crofsocktest::handle_tls_connected(rofl::crofsock &socket) {
   LOG(INFO) << "handle tls connected" << std::endl;
 
+  if (TEST_MODE_TLS_SETUP_RATE == test_mode) {
+    return;
+  }
+
   sleep(1);
 
   rofl::openflow::cofmsg_hello *hello =
@@ -373,6 +878,12 @@ void crofsocktest::handle_tls_accept_failed(rofl::crofsock &socket) {
 void crofsocktest::handle_tls_accepted(rofl::crofsock &socket) {
   LOG(INFO) << "handle tls accepted" << std::endl;
 
+  if (TEST_MODE_TLS_SETUP_RATE == test_mode) {
+    socket.send_message(
+        new cofmsg_features_request(rofl::openflow13::OFP_VERSION, 0));
+    return;
+  }
+
   sleep(1);
 
   rofl::openflow::cofmsg_features_request *features =
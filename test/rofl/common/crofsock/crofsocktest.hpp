@@ -11,6 +11,9 @@
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <memory>
+#include <vector>
+
 #include "rofl/common/cmemory.h"
 #include "rofl/common/crandom.h"
 #include "rofl/common/crofsock.h"
@@ -19,6 +22,8 @@ class crofsocktest : public CppUnit::TestFixture, public rofl::crofsock_env {
   CPPUNIT_TEST_SUITE(crofsocktest);
   CPPUNIT_TEST(global_initialize);
   CPPUNIT_TEST(test);
+  CPPUNIT_TEST(test_rx_batch);
+  CPPUNIT_TEST(test_packet_out);
 /* Google's address sanitizer complains about lots of openssl's
  * code fragments upon shutdown of the test application.
  * We have to rewrite the clean-up code for openssl to cope with
@@ -29,6 +34,8 @@ class crofsocktest : public CppUnit::TestFixture, public rofl::crofsock_env {
  * [1] https://wiki.openssl.org/index.php/Library_Initialization */
 #ifndef ASAN
   CPPUNIT_TEST(test_tls);
+  CPPUNIT_TEST(test_tls_setup_rate);
+  CPPUNIT_TEST(test_tls_context_reload);
 #endif
   CPPUNIT_TEST(global_terminate);
   CPPUNIT_TEST_SUITE_END();
@@ -40,9 +47,18 @@ public:
 public:
   void global_initialize();
   void test();
+  void test_rx_batch();
+  void test_packet_out();
   void test_tls();
+  void test_tls_setup_rate();
+  void test_tls_context_reload();
   void global_terminate();
 
+private:
+  double run_packet_out(size_t framelen, int num_msgs, bool zero_copy);
+
+  double run_tls_setup(int num_conns, bool session_reuse, int &num_reused);
+
 private:
   virtual void handle_listen(rofl::crofsock &socket);
 
@@ -78,12 +94,22 @@ private:
   enum crofsock_test_mode_t {
     TEST_MODE_TCP = 1,
     TEST_MODE_TLS = 2,
+    TEST_MODE_TCP_RX_BATCH = 3,
+    TEST_MODE_TCP_PACKET_OUT = 4,
+    TEST_MODE_TLS_SETUP_RATE = 5,
   };
 
   enum crofsock_test_mode_t test_mode;
   std::atomic_bool keep_running;
   int timeout;
   int msg_counter;
+  int rx_batch_num_msgs;
+  // server disables reception after this many messages
+  int rx_disable_at;
+  rofl::crofsock::rx_mode_t rx_mode_server;
+  std::shared_ptr<const rofl::cmemory> packet_out_frame;
+  bool packet_out_zero_copy;
+  std::atomic_int packet_out_errors;
   std::atomic_int server_msg_counter;
   std::atomic_int client_msg_counter;
   rofl::crandom rand;
@@ -92,6 +118,9 @@ private:
   rofl::crofsock *slisten;
   rofl::crofsock *sclient;
   rofl::crofsock *sserver;
+  std::vector<rofl::crofsock *> sservers;
+  std::string tls_certfile;
+  std::string tls_keyfile;
   rofl::crwlock tlock;
 
   static std::string cacert;
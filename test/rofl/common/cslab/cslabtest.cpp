@@ -0,0 +1,298 @@
+/*
+ * cslabtest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <pthread.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include <vector>
+
+#include "../testutil.hpp"
+#include "cslabtest.hpp"
+
+using namespace rofl::openflow;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(cslabtest);
+
+namespace {
+
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+struct objects_t {
+  std::vector<void *> ptrs;
+  bool attach;
+};
+
+void *allocate_objects(void *arg) {
+  objects_t *objects = static_cast<objects_t *>(arg);
+  if (objects->attach)
+    rofl::cslab::thread_attach();
+  for (auto &ptr : objects->ptrs) {
+    ptr = rofl::cslab::allocate(100);
+  }
+  rofl::cslab::thread_detach();
+  return nullptr;
+}
+
+void *deallocate_objects(void *arg) {
+  objects_t *objects = static_cast<objects_t *>(arg);
+  for (auto ptr : objects->ptrs) {
+    rofl::cslab::deallocate(ptr);
+  }
+  return nullptr;
+}
+
+}; // namespace
+
+void cslabtest::setUp() {}
+
+void cslabtest::tearDown() { rofl::cslab::thread_detach(); }
+
+void cslabtest::testSizeClasses() {
+  rofl::cslab::thread_attach();
+  CPPUNIT_ASSERT(rofl::cslab::is_attached());
+  rofl::cslab_stats start = rofl::cslab::get_stats();
+
+  std::vector<std::pair<uint8_t *, size_t>> ptrs;
+  for (size_t size : {1, 24, 32, 33, 100, 128, 200, 1000, 2048}) {
+    uint8_t *ptr = static_cast<uint8_t *>(rofl::cslab::allocate(size));
+    CPPUNIT_ASSERT(((uintptr_t)ptr % 16) == 0);
+    memset(ptr, size & 0xff, size);
+    ptrs.push_back(std::make_pair(ptr, size));
+  }
+  for (auto &it : ptrs) {
+    for (size_t i = 0; i < it.second; i++) {
+      CPPUNIT_ASSERT(it.first[i] == (it.second & 0xff));
+    }
+  }
+
+  /* objects above the largest size class fall back to malloc */
+  void *large = rofl::cslab::allocate(4096);
+  memset(large, 0x5a, 4096);
+  rofl::cslab::deallocate(large);
+
+  rofl::cslab_stats stats = rofl::cslab::get_stats();
+  CPPUNIT_ASSERT(stats.allocs - start.allocs == ptrs.size());
+  CPPUNIT_ASSERT(stats.large_mallocs - start.large_mallocs == 1);
+
+  /* freed blocks are reused without refilling */
+  for (auto &it : ptrs) {
+    rofl::cslab::deallocate(it.first);
+  }
+  uint64_t chunk_mallocs = rofl::cslab::get_stats().chunk_mallocs;
+  void *ptr = rofl::cslab::allocate(1000);
+  CPPUNIT_ASSERT(ptr == ptrs[7].first);
+  rofl::cslab::deallocate(ptr);
+  CPPUNIT_ASSERT(rofl::cslab::get_stats().chunk_mallocs == chunk_mallocs);
+
+  stats = rofl::cslab::get_stats();
+  CPPUNIT_ASSERT(stats.frees - start.frees == stats.allocs - start.allocs);
+
+  /* without cache */
+  rofl::cslab::thread_detach();
+  CPPUNIT_ASSERT(not rofl::cslab::is_attached());
+  ptr = rofl::cslab::allocate(64);
+  rofl::cslab::deallocate(ptr);
+  CPPUNIT_ASSERT(rofl::cslab::get_stats().allocs == stats.allocs);
+}
+
+void cslabtest::testRemoteFree() {
+  const unsigned int num_objects = 10000;
+  rofl::cslab::thread_attach();
+  rofl::cslab_stats start = rofl::cslab::get_stats();
+
+  objects_t objects;
+  objects.ptrs.resize(num_objects);
+  objects.attach = false;
+  for (auto &ptr : objects.ptrs) {
+    ptr = rofl::cslab::allocate(100);
+  }
+  uint64_t chunk_mallocs = rofl::cslab::get_stats().chunk_mallocs;
+
+  pthread_t tid;
+  CPPUNIT_ASSERT(
+      pthread_create(&tid, NULL, &deallocate_objects, &objects) == 0);
+  pthread_join(tid, NULL);
+
+  rofl::cslab_stats stats = rofl::cslab::get_stats();
+  CPPUNIT_ASSERT(stats.remote_frees - start.remote_frees == num_objects);
+
+  /* objects freed remotely are collected by the owner */
+  for (auto &ptr : objects.ptrs) {
+    ptr = rofl::cslab::allocate(100);
+  }
+  CPPUNIT_ASSERT(rofl::cslab::get_stats().chunk_mallocs == chunk_mallocs);
+  for (auto ptr : objects.ptrs) {
+    rofl::cslab::deallocate(ptr);
+  }
+}
+
+void cslabtest::testOrphanedCache() {
+  const unsigned int num_objects = 1000;
+  rofl::cslab_stats start = rofl::cslab::get_stats();
+
+  /* allocating thread terminates before its objects are freed */
+  objects_t objects;
+  objects.ptrs.resize(num_objects);
+  objects.attach = true;
+  pthread_t tid;
+  CPPUNIT_ASSERT(pthread_create(&tid, NULL, &allocate_objects, &objects) == 0);
+  pthread_join(tid, NULL);
+
+  for (auto ptr : objects.ptrs) {
+    memset(ptr, 0xa5, 100);
+  }
+  deallocate_objects(&objects);
+
+  rofl::cslab_stats stats = rofl::cslab::get_stats();
+  CPPUNIT_ASSERT(stats.allocs - start.allocs == num_objects);
+  CPPUNIT_ASSERT(stats.frees - start.frees == num_objects);
+  CPPUNIT_ASSERT(stats.remote_frees - start.remote_frees == num_objects);
+}
+
+void cslabtest::testThreadOption() {
+  cobject object;
+  rofl::cthread thread(0xffff, rofl::cthread::TIMER_BACKEND_ORDERED_SET,
+                       rofl::cthread::ALLOCATOR_SLAB);
+  CPPUNIT_ASSERT(thread.get_allocator() == rofl::cthread::ALLOCATOR_SLAB);
+  rofl::cslab_stats start = rofl::cslab::get_stats();
+
+  thread.start("slab");
+  unsigned int keep_running = 50;
+  while ((--keep_running > 0) && (not object.done)) {
+    thread.wakeup(&object);
+    usleep(100000);
+  }
+  CPPUNIT_ASSERT(object.done);
+  CPPUNIT_ASSERT(object.attached);
+  CPPUNIT_ASSERT(rofl::cslab::get_stats().allocs - start.allocs >= 1);
+
+  thread.stop();
+  thread.drop(&object);
+  delete object.msg;
+
+  CPPUNIT_ASSERT(rofl::cslab::get_stats().remote_frees - start.remote_frees >=
+                 1);
+}
+
+void cslabtest::pack_flow_mod(rofl::cmemory &mem) {
+  uint8_t version = rofl::openflow13::OFP_VERSION;
+  cofmsg_flow_mod msg(version, 0xa1a2a3a4);
+  msg.set_flowmod().set_version(version);
+  msg.set_flowmod().set_table_id(1);
+  msg.set_flowmod().set_priority(0x8000);
+  msg.set_flowmod().set_match().set_in_port(1);
+  msg.set_flowmod().set_match().set_eth_type(0x0800);
+  msg.set_flowmod().set_match().set_eth_dst(
+      rofl::cmacaddr("00:11:11:11:11:11"));
+  msg.set_flowmod().set_match().set_ip_proto(6);
+  msg.set_flowmod().set_match().set_ipv4_dst(rofl::caddress_in4("10.0.0.1"));
+  msg.set_flowmod().set_match().set_tcp_dst(80);
+  rofl::cindex index(0);
+  msg.set_flowmod()
+      .set_instructions()
+      .set_inst_apply_actions()
+      .set_actions()
+      .add_action_copy_ttl_in(index++);
+  msg.set_flowmod()
+      .set_instructions()
+      .set_inst_apply_actions()
+      .set_actions()
+      .add_action_output(index++)
+      .set_port_no(2);
+  msg.set_flowmod().set_instructions().set_inst_goto_table().set_table_id(2);
+  mem.resize(msg.length());
+  msg.pack(mem.somem(), mem.length());
+}
+
+void cslabtest::testMessages() {
+  const unsigned int num_msgs = 1000;
+  rofl::cmemory mem;
+  pack_flow_mod(mem);
+
+  rofl::cslab::thread_attach();
+  rofl::cslab_stats start = rofl::cslab::get_stats();
+
+  for (unsigned int i = 0; i < num_msgs; i++) {
+    cofmsg_flow_mod *msg = new cofmsg_flow_mod();
+    msg->unpack(mem.somem(), mem.length());
+    CPPUNIT_ASSERT(msg->get_flowmod().get_match().get_tcp_dst() == 80);
+    delete msg;
+  }
+
+  rofl::cslab_stats stats = rofl::cslab::get_stats();
+  uint64_t allocs = stats.allocs - start.allocs;
+  uint64_t mallocs = stats.get_mallocs() - start.get_mallocs();
+
+  std::cerr << "flow-mod: slab objects per message: "
+            << (double)allocs / num_msgs
+            << " mallocs avoided per message: "
+            << (double)(allocs - mallocs) / num_msgs << std::endl;
+
+  /* message, instructions and actions, match fields are stored inline */
+  CPPUNIT_ASSERT(allocs >= 5 * num_msgs);
+  CPPUNIT_ASSERT(stats.frees - start.frees == allocs);
+  CPPUNIT_ASSERT(mallocs < allocs / 100);
+}
+
+void cslabtest::testAllocationForms() {
+  rofl::cslab::thread_attach();
+  rofl::cslab_stats start = rofl::cslab::get_stats();
+
+  /* array and nothrow forms are served by the slab cache as well */
+  cofmsg_flow_mod *msgs = new cofmsg_flow_mod[4];
+  cofmsg_flow_mod *msg = new (std::nothrow) cofmsg_flow_mod();
+  CPPUNIT_ASSERT(msg != nullptr);
+  rofl::cslab_stats stats = rofl::cslab::get_stats();
+  /* arrays exceeding the largest size class are counted as large mallocs */
+  CPPUNIT_ASSERT((stats.allocs - start.allocs) +
+                     (stats.large_mallocs - start.large_mallocs) >=
+                 2);
+  delete msg;
+  delete[] msgs;
+  stats = rofl::cslab::get_stats();
+  CPPUNIT_ASSERT(stats.frees - start.frees == stats.allocs - start.allocs);
+
+  /* placement form constructs in the given memory */
+  alignas(cofmsg_flow_mod) uint8_t buf[sizeof(cofmsg_flow_mod)];
+  cofmsg_flow_mod *placed = new (buf) cofmsg_flow_mod();
+  CPPUNIT_ASSERT((void *)placed == (void *)buf);
+  placed->~cofmsg_flow_mod();
+}
+
+double cslabtest::run_benchmark(const rofl::cmemory &mem,
+                                unsigned int num_msgs) {
+  double start = now();
+  for (unsigned int i = 0; i < num_msgs; i++) {
+    cofmsg_flow_mod *msg = new cofmsg_flow_mod();
+    msg->unpack(mem.somem(), mem.length());
+    delete msg;
+  }
+  return now() - start;
+}
+
+void cslabtest::testBenchmark() {
+  const unsigned int num_msgs = testutil::bench_size(100000, 1000);
+  rofl::cmemory mem;
+  pack_flow_mod(mem);
+
+  double t_heap = run_benchmark(mem, num_msgs);
+  rofl::cslab::thread_attach();
+  double t_slab = run_benchmark(mem, num_msgs);
+  rofl::cslab::thread_detach();
+
+  std::cerr << "flow-mod unpack: heap: " << 1e9 * t_heap / num_msgs
+            << " ns/msg slab: " << 1e9 * t_slab / num_msgs
+            << " ns/msg speedup: " << t_heap / t_slab << std::endl;
+}
@@ -0,0 +1,73 @@
+/*
+ * cslabtest.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef TEST_SRC_ROFL_COMMON_CSLAB_TEST_HPP_
+#define TEST_SRC_ROFL_COMMON_CSLAB_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include <atomic>
+
+#include "rofl/common/cmemory.h"
+#include "rofl/common/cslab.hpp"
+#include "rofl/common/cthread.hpp"
+#include "rofl/common/openflow/messages/cofmsg_flow_mod.h"
+
+class cslabtest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(cslabtest);
+  CPPUNIT_TEST(testSizeClasses);
+  CPPUNIT_TEST(testRemoteFree);
+  CPPUNIT_TEST(testOrphanedCache);
+  CPPUNIT_TEST(testThreadOption);
+  CPPUNIT_TEST(testMessages);
+  CPPUNIT_TEST(testAllocationForms);
+  CPPUNIT_TEST(testBenchmark);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  class cobject : public rofl::cthread_env {
+  public:
+    virtual ~cobject(){};
+
+    cobject() : attached(false), msg(nullptr), done(false){};
+
+  protected:
+    virtual void handle_wakeup(rofl::cthread &thread) {
+      attached = rofl::cslab::is_attached();
+      msg = new rofl::openflow::cofmsg(rofl::openflow13::OFP_VERSION,
+                                       rofl::openflow13::OFPT_HELLO, 0);
+      done = true;
+    };
+    virtual void handle_timeout(rofl::cthread &thread, uint32_t timer_id){};
+    virtual void handle_read_event(rofl::cthread &thread, int fd){};
+    virtual void handle_write_event(rofl::cthread &thread, int fd){};
+
+  public:
+    bool attached;
+    rofl::openflow::cofmsg *msg;
+    std::atomic_bool done;
+  };
+
+public:
+  void setUp();
+  void tearDown();
+
+public:
+  void testSizeClasses();
+  void testRemoteFree();
+  void testOrphanedCache();
+  void testThreadOption();
+  void testMessages();
+  void testAllocationForms();
+  void testBenchmark();
+
+private:
+  void pack_flow_mod(rofl::cmemory &mem);
+  double run_benchmark(const rofl::cmemory &mem, unsigned int num_msgs);
+};
+
+#endif /* TEST_SRC_ROFL_COMMON_CSLAB_TEST_HPP_ */
@@ -1,12 +1,29 @@
 #include <stdlib.h>
+#include <sys/eventfd.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <vector>
 
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
 
+#include "../testutil.hpp"
 #include "cthread_test.h"
 
 CPPUNIT_TEST_SUITE_REGISTRATION(cthread_test);
 
+namespace {
+
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+}; // namespace
+
 void cthread_test::setUp() { object = new cobject(); }
 
 void cthread_test::tearDown() { delete object; }
@@ -44,3 +61,470 @@ void cthread_test::cobject::handle_timeout(rofl::cthread &thread,
   default: {};
   }
 };
+
+void cthread_test::test_wheel() {
+  rofl::ctimerwheel wheel;
+  rofl::ctimer timer;
+  rofl::ctimespec start;
+  cobject env1, env2;
+
+  /* spread timers over all levels of the wheel */
+  const time_t timeouts[] = {0, 1, 2, 70, 3600, 6 * 3600, 60 * 86400};
+  const unsigned int num_timeouts = sizeof(timeouts) / sizeof(timeouts[0]);
+  for (unsigned int i = 0; i < num_timeouts; i++) {
+    rofl::ctimespec tspec(start);
+    tspec.set_tspec().tv_sec += timeouts[i];
+    CPPUNIT_ASSERT(wheel.add_timer(&env1, i, tspec));
+    CPPUNIT_ASSERT(wheel.add_timer(&env2, i, tspec));
+  }
+  CPPUNIT_ASSERT(wheel.size() == 2 * num_timeouts);
+  CPPUNIT_ASSERT(wheel.has_timer(&env1, 3));
+  CPPUNIT_ASSERT(wheel.find_timer(&env1, 3)->get_timer_id() == 3);
+  CPPUNIT_ASSERT(not wheel.has_timer(&env1, num_timeouts));
+
+  /* restarting a timer replaces it */
+  rofl::ctimespec tspec(start);
+  tspec.set_tspec().tv_sec += 2;
+  CPPUNIT_ASSERT(not wheel.add_timer(&env1, 1, tspec));
+  CPPUNIT_ASSERT(wheel.size() == 2 * num_timeouts);
+
+  CPPUNIT_ASSERT(wheel.drop_timers(&env2));
+  CPPUNIT_ASSERT(not wheel.drop_timers(&env2));
+  CPPUNIT_ASSERT(wheel.size() == num_timeouts);
+  CPPUNIT_ASSERT(wheel.drop_timer(&env1, 4));
+  CPPUNIT_ASSERT(not wheel.drop_timer(&env1, 4));
+
+  /* advance in steps of 500ms, timers must never fire early */
+  unsigned int num_expired = 0;
+  for (time_t msec = 0; msec <= 61L * 86400 * 1000; msec += 500) {
+    rofl::ctimespec now(start);
+    now.set_tspec().tv_sec += msec / 1000;
+    now.set_tspec().tv_nsec += (msec % 1000) * 1000000;
+    if (now.get_tspec().tv_nsec >= 1000000000) {
+      now.set_tspec().tv_sec += 1;
+      now.set_tspec().tv_nsec -= 1000000000;
+    }
+    int timeout = wheel.get_relative_timeout(now);
+    CPPUNIT_ASSERT((timeout != -1) || wheel.empty());
+    while (wheel.pop_expired(timer, now)) {
+      CPPUNIT_ASSERT(timer.env() == &env1);
+      CPPUNIT_ASSERT(timer.get_tspec() <= now);
+      CPPUNIT_ASSERT(
+          now.get_tspec().tv_sec - timer.get_tspec().get_tspec().tv_sec <= 1);
+      num_expired++;
+    }
+    if (wheel.empty()) {
+      break;
+    }
+    /* skip ahead to the next due slot */
+    if (timeout > 500) {
+      msec += timeout - timeout % 500 - 500;
+    }
+  }
+  CPPUNIT_ASSERT(num_expired == num_timeouts - 1);
+  CPPUNIT_ASSERT(wheel.empty());
+  CPPUNIT_ASSERT(wheel.get_relative_timeout() == -1);
+}
+
+void cthread_test::test_wheel_thread() {
+  unsigned int keep_running = 60;
+
+  rofl::cthread thread(0xffff, rofl::cthread::TIMER_BACKEND_WHEEL);
+  thread.start("wheel");
+  CPPUNIT_ASSERT(thread.get_timer_backend() ==
+                 rofl::cthread::TIMER_BACKEND_WHEEL);
+
+  thread.add_timer(object, 0, rofl::ctimespec().expire_in(1));
+  thread.add_timer(object, 1, rofl::ctimespec().expire_in(2));
+  CPPUNIT_ASSERT(thread.has_timer(object, 1));
+  CPPUNIT_ASSERT(thread.get_timer(object, 1).get_timer_id() == 1);
+
+  while ((--keep_running > 0) && (object->cnt < 10)) {
+    CPPUNIT_ASSERT(not object->error);
+    std::cerr << ".";
+    sleep(1);
+  }
+  std::cerr << std::endl;
+  CPPUNIT_ASSERT(keep_running > 0);
+
+  thread.stop();
+  thread.drop_timers(object);
+  CPPUNIT_ASSERT(not thread.has_timer(object, 0));
+}
+
+double cthread_test::run_timer_benchmark(
+    rofl::cthread::timer_backend_t timer_backend, unsigned int num_envs,
+    unsigned int num_ids) {
+  rofl::cthread thread(0xffff, timer_backend);
+  std::vector<cobject *> envs(num_envs);
+  for (unsigned int i = 0; i < num_envs; i++) {
+    envs[i] = new cobject();
+  }
+
+  struct timespec ts_start, ts_stop;
+  rofl::ctimespec base;
+  clock_gettime(CLOCK_MONOTONIC, &ts_start);
+
+  /* arm timers with distinct deadlines, one millisecond apart */
+  for (unsigned int id = 0; id < num_ids; id++) {
+    for (unsigned int i = 0; i < num_envs; i++) {
+      rofl::ctimespec tspec(base);
+      unsigned int msec = id * num_envs + i;
+      tspec.set_tspec().tv_sec += 1 + msec / 1000;
+      tspec.set_tspec().tv_nsec += (msec % 1000) * 1000000;
+      if (tspec.get_tspec().tv_nsec >= 1000000000) {
+        tspec.set_tspec().tv_sec += 1;
+        tspec.set_tspec().tv_nsec -= 1000000000;
+      }
+      thread.add_timer(envs[i], id, tspec);
+    }
+  }
+  /* cancel them again */
+  for (unsigned int id = 0; id < num_ids; id++) {
+    for (unsigned int i = 0; i < num_envs; i++) {
+      CPPUNIT_ASSERT(thread.drop_timer(envs[i], id));
+    }
+  }
+
+  clock_gettime(CLOCK_MONOTONIC, &ts_stop);
+
+  for (unsigned int i = 0; i < num_envs; i++) {
+    delete envs[i];
+  }
+  return (ts_stop.tv_sec - ts_start.tv_sec) +
+         (ts_stop.tv_nsec - ts_start.tv_nsec) / 1e9;
+}
+
+void cthread_test::test_timer_benchmark() {
+  /* the ordered set scans all timers on each operation, keep it small */
+  double t_set = run_timer_benchmark(
+      rofl::cthread::TIMER_BACKEND_ORDERED_SET, 100, 100);
+  double t_wheel_small =
+      run_timer_benchmark(rofl::cthread::TIMER_BACKEND_WHEEL, 100, 100);
+
+  std::cerr << "arm+cancel 10k timers: ordered set " << t_set << "s, wheel "
+            << t_wheel_small << "s" << std::endl;
+
+  /* 1M timers with ROFL_BENCH set only, see make check-bench */
+  if (not testutil::bench()) {
+    return;
+  }
+  double t_wheel =
+      run_timer_benchmark(rofl::cthread::TIMER_BACKEND_WHEEL, 1000, 1000);
+  std::cerr << "arm+cancel 1M timers: wheel " << t_wheel << "s, "
+            << (unsigned int)(2e6 / t_wheel) << " ops/s" << std::endl;
+}
+
+void cthread_test::cjob::send() {
+  {
+    std::lock_guard<std::mutex> lock(queue_lock);
+    queue.push_back(std::make_pair(now(), seq++));
+  }
+  rofl::cthread::thread(thread_num).schedule_job(this);
+}
+
+void cthread_test::cjob::handle_job(rofl::cthread &thread) {
+  if (running.fetch_add(1) != 0) {
+    error = true;
+  }
+  /* jobs not stealable stay on their home thread */
+  if ((not is_stealable()) && (&thread != &rofl::cthread::thread(thread_num))) {
+    error = true;
+  }
+  while (true) {
+    std::pair<double, unsigned int> msg;
+    {
+      std::lock_guard<std::mutex> lock(queue_lock);
+      if (queue.empty())
+        break;
+      msg = queue.front();
+      queue.pop_front();
+    }
+    unsigned int expected = next_seq.load();
+    if (msg.second != expected) {
+      error = true;
+    }
+    latencies.push_back(now() - msg.first);
+    /* handler blocking on I/O or a lock */
+    usleep(100);
+    next_seq = expected + 1;
+  }
+  running--;
+}
+
+std::vector<double> cthread_test::run_scheduler_benchmark(
+    rofl::cthread::hnd_scheduler_t hnd_scheduler, uint64_t &steals) {
+  const unsigned int num_hnd_threads = 4;
+  const unsigned int num_jobs = 16;
+  const unsigned int num_busy_jobs = 4;
+  const unsigned int num_rounds = 100;
+
+  rofl::cthread::pool_terminate();
+  rofl::cthread::pool_initialize(num_hnd_threads, 2, 1,
+                                 rofl::cthread::TIMER_BACKEND_ORDERED_SET,
+                                 rofl::cthread::ALLOCATOR_HEAP, hnd_scheduler);
+  CPPUNIT_ASSERT(rofl::cthread::get_hnd_scheduler() == hnd_scheduler);
+
+  std::vector<uint32_t> threads(num_hnd_threads);
+  for (unsigned int i = 0; i < num_hnd_threads; i++) {
+    threads[i] = rofl::cthread::get_hnd_thread_num_from_pool();
+  }
+
+  /* busy jobs share the first handler thread, the others are spread */
+  std::vector<cjob *> jobs(num_jobs);
+  for (unsigned int i = 0; i < num_jobs; i++) {
+    jobs[i] = new cjob(
+        (i < num_busy_jobs) ? threads[0]
+                            : threads[1 + i % (num_hnd_threads - 1)]);
+  }
+
+  /* the busy jobs exceed a single thread's capacity */
+  for (unsigned int round = 0; round < num_rounds; round++) {
+    for (unsigned int i = 0; i < num_jobs; i++) {
+      unsigned int num_msgs = (i < num_busy_jobs) ? 6 : 1;
+      for (unsigned int j = 0; j < num_msgs; j++) {
+        jobs[i]->send();
+      }
+    }
+    usleep(2000);
+  }
+
+  unsigned int keep_running = 600;
+  bool done = false;
+  while ((--keep_running > 0) && (not done)) {
+    usleep(100000);
+    done = true;
+    for (auto job : jobs) {
+      if (job->next_seq.load() != job->seq) {
+        done = false;
+      }
+    }
+  }
+  CPPUNIT_ASSERT(done);
+
+  steals = 0;
+  for (auto thread_num : threads) {
+    steals += rofl::cthread::thread(thread_num).get_jobs_stolen();
+    CPPUNIT_ASSERT(rofl::cthread::thread(thread_num).get_job_queue_depth() ==
+                   0);
+  }
+
+  std::vector<double> latencies;
+  for (auto job : jobs) {
+    CPPUNIT_ASSERT(not job->error);
+    latencies.insert(latencies.end(), job->latencies.begin(),
+                     job->latencies.end());
+    rofl::cthread::pool_drop_job(job);
+    delete job;
+  }
+  std::sort(latencies.begin(), latencies.end());
+  return latencies;
+}
+
+void cthread_test::test_work_stealing() {
+  uint64_t steals_static = 0, steals_ws = 0;
+  std::vector<double> l_static = run_scheduler_benchmark(
+      rofl::cthread::HND_SCHEDULER_STATIC, steals_static);
+  std::vector<double> l_ws = run_scheduler_benchmark(
+      rofl::cthread::HND_SCHEDULER_WORK_STEALING, steals_ws);
+
+  /* restore default pool */
+  rofl::cthread::pool_terminate();
+  rofl::cthread::pool_initialize();
+
+  double p50_static = l_static[l_static.size() / 2];
+  double p99_static = l_static[l_static.size() * 99 / 100];
+  double p50_ws = l_ws[l_ws.size() / 2];
+  double p99_ws = l_ws[l_ws.size() * 99 / 100];
+
+  std::cerr << "handler latency static: p50 " << 1e3 * p50_static
+            << "ms p99 " << 1e3 * p99_static << "ms" << std::endl;
+  std::cerr << "handler latency work stealing: p50 " << 1e3 * p50_ws
+            << "ms p99 " << 1e3 * p99_ws << "ms steals " << steals_ws
+            << std::endl;
+
+  CPPUNIT_ASSERT(steals_static == 0);
+  CPPUNIT_ASSERT(steals_ws > 0);
+  CPPUNIT_ASSERT(p99_ws < p99_static);
+}
+
+void cthread_test::test_job_home() {
+  const unsigned int num_hnd_threads = 4;
+  const unsigned int num_jobs = 4;
+
+  rofl::cthread::pool_terminate();
+  rofl::cthread::pool_initialize(num_hnd_threads, 2, 1,
+                                 rofl::cthread::TIMER_BACKEND_ORDERED_SET,
+                                 rofl::cthread::ALLOCATOR_HEAP,
+                                 rofl::cthread::HND_SCHEDULER_WORK_STEALING);
+
+  std::vector<uint32_t> threads(num_hnd_threads);
+  for (unsigned int i = 0; i < num_hnd_threads; i++) {
+    threads[i] = rofl::cthread::get_hnd_thread_num_from_pool();
+  }
+
+  /* busy jobs bound to the first handler thread, idle siblings must not
+   * take them */
+  std::vector<cjob *> jobs(num_jobs);
+  for (unsigned int i = 0; i < num_jobs; i++) {
+    jobs[i] = new cjob(threads[0], false);
+  }
+  for (unsigned int round = 0; round < 20; round++) {
+    for (auto job : jobs) {
+      job->send();
+      job->send();
+    }
+    usleep(1000);
+  }
+
+  unsigned int keep_running = 600;
+  bool done = false;
+  while ((--keep_running > 0) && (not done)) {
+    usleep(10000);
+    done = true;
+    for (auto job : jobs) {
+      if (job->next_seq.load() != job->seq) {
+        done = false;
+      }
+    }
+  }
+  CPPUNIT_ASSERT(done);
+
+  for (auto thread_num : threads) {
+    CPPUNIT_ASSERT(rofl::cthread::thread(thread_num).get_jobs_stolen() == 0);
+  }
+
+  /* dropping a job running on another thread waits for it to finish */
+  cjob *job = jobs[0];
+  for (unsigned int i = 0; i < 50; i++) {
+    job->send();
+  }
+  while (job->running.load() == 0) {
+    usleep(100);
+  }
+  rofl::cthread::pool_drop_job(job);
+  CPPUNIT_ASSERT(job->running.load() == 0);
+  CPPUNIT_ASSERT(rofl::cthread::thread(threads[0]).get_job_queue_depth() == 0);
+
+  for (auto job : jobs) {
+    CPPUNIT_ASSERT(not job->error);
+    rofl::cthread::pool_drop_job(job);
+    delete job;
+  }
+
+  /* restore default pool */
+  rofl::cthread::pool_terminate();
+  rofl::cthread::pool_initialize();
+}
+
+void cthread_test::cfdobject::handle_read_event(rofl::cthread &thread,
+                                               int fd) {
+  cnt++;
+  if (dropped) {
+    error = true;
+  }
+  if ((victim != nullptr) && (not victim->dropped)) {
+    thread.drop_fd(victim_fd);
+    victim->dropped = true;
+  }
+}
+
+void cthread_test::test_dispatch() {
+  const unsigned int num_pairs = 100;
+  rofl::cthread thread(0xffff);
+
+  /* the first object of each pair drops the second one's fd, pending
+   * events for the dropped fd must not be delivered anymore */
+  std::vector<cfdobject *> objects(2 * num_pairs);
+  std::vector<int> fds(2 * num_pairs);
+  for (unsigned int i = 0; i < 2 * num_pairs; i++) {
+    objects[i] = new cfdobject();
+    fds[i] = eventfd(1, EFD_NONBLOCK);
+    CPPUNIT_ASSERT(fds[i] >= 0);
+  }
+  for (unsigned int i = 0; i < 2 * num_pairs; i += 2) {
+    objects[i]->victim = objects[i + 1];
+    objects[i]->victim_fd = fds[i + 1];
+    thread.add_read_fd(objects[i], fds[i], true, false);
+    thread.add_read_fd(objects[i + 1], fds[i + 1], true, false);
+  }
+
+  /* a failed registration must not leave a slot behind */
+  cfdobject invalid;
+  size_t num_fd_slots = thread.get_num_fd_slots();
+  for (unsigned int i = 0; i < 16; i++) {
+    CPPUNIT_ASSERT_THROW(thread.add_read_fd(&invalid, -1, true, false),
+                         rofl::eSysCall);
+  }
+  CPPUNIT_ASSERT(thread.get_num_fd_slots() == num_fd_slots);
+
+  thread.start("dispatch");
+  unsigned int keep_running = 50;
+  bool done = false;
+  while ((--keep_running > 0) && (not done)) {
+    usleep(100000);
+    done = true;
+    for (unsigned int i = 0; i < 2 * num_pairs; i += 2) {
+      if (objects[i]->cnt < 10)
+        done = false;
+    }
+  }
+  thread.stop();
+  CPPUNIT_ASSERT(done);
+
+  for (unsigned int i = 0; i < 2 * num_pairs; i++) {
+    CPPUNIT_ASSERT(not objects[i]->error);
+    CPPUNIT_ASSERT(objects[i]->cnt > 0 || (i % 2));
+    thread.drop(objects[i]);
+    delete objects[i];
+    close(fds[i]);
+  }
+}
+
+double cthread_test::run_dispatch_benchmark(unsigned int num_threads,
+                                            unsigned int num_fds) {
+  std::vector<rofl::cthread *> threads(num_threads);
+  std::vector<cfdobject *> objects(num_threads * num_fds);
+  std::vector<int> fds(num_threads * num_fds);
+
+  /* level-triggered fds that stay readable */
+  for (unsigned int t = 0; t < num_threads; t++) {
+    threads[t] = new rofl::cthread(0xffff);
+    for (unsigned int i = t * num_fds; i < (t + 1) * num_fds; i++) {
+      objects[i] = new cfdobject();
+      fds[i] = eventfd(1, EFD_NONBLOCK);
+      threads[t]->add_read_fd(objects[i], fds[i], true, false);
+    }
+  }
+
+  for (auto thread : threads) {
+    thread->start("dispatch");
+  }
+  double start = now();
+  sleep(1);
+  for (auto thread : threads) {
+    thread->stop();
+  }
+  double elapsed = now() - start;
+
+  uint64_t events = 0;
+  for (unsigned int t = 0; t < num_threads; t++) {
+    for (unsigned int i = t * num_fds; i < (t + 1) * num_fds; i++) {
+      events += objects[i]->cnt;
+      threads[t]->drop(objects[i]);
+      delete objects[i];
+      close(fds[i]);
+    }
+    delete threads[t];
+  }
+  return 1e9 * elapsed / events;
+}
+
+void cthread_test::test_dispatch_benchmark() {
+  unsigned int num_fds = testutil::bench_size(1000, 100);
+  double t_single = run_dispatch_benchmark(1, num_fds);
+  double t_multi = run_dispatch_benchmark(4, num_fds / 4);
+
+  std::cerr << "dispatch cost per event: 1 thread " << t_single
+            << "ns, 4 threads " << t_multi << "ns" << std::endl;
+}
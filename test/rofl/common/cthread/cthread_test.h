@@ -2,10 +2,21 @@
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include <deque>
+#include <mutex>
+#include <vector>
+
 class cthread_test : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(cthread_test);
   CPPUNIT_TEST(test1);
+  CPPUNIT_TEST(test_wheel);
+  CPPUNIT_TEST(test_wheel_thread);
+  CPPUNIT_TEST(test_timer_benchmark);
+  CPPUNIT_TEST(test_work_stealing);
+  CPPUNIT_TEST(test_job_home);
+  CPPUNIT_TEST(test_dispatch);
+  CPPUNIT_TEST(test_dispatch_benchmark);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -37,6 +48,73 @@ private:
     bool error;
   };
 
+  class cjob : public rofl::cthread_job {
+  public:
+    /**
+     *
+     */
+    virtual ~cjob(){};
+
+    /**
+     *
+     */
+    cjob(uint32_t thread_num, bool stealable = true)
+        : rofl::cthread_job(stealable), thread_num(thread_num), seq(0),
+          next_seq(0), running(0), error(false){};
+
+    /**
+     * @brief	Queue a message and schedule this job on its home thread
+     */
+    void send();
+
+  protected:
+    virtual void handle_job(rofl::cthread &thread);
+
+  public:
+    uint32_t thread_num;
+
+    std::mutex queue_lock;
+    std::deque<std::pair<double, unsigned int>> queue;
+    unsigned int seq;
+
+    // written by handle_job() only
+    std::atomic<unsigned int> next_seq;
+    std::vector<double> latencies;
+
+    std::atomic<int> running;
+    std::atomic_bool error;
+  };
+
+  class cfdobject : public rofl::cthread_env {
+  public:
+    /**
+     *
+     */
+    virtual ~cfdobject(){};
+
+    /**
+     *
+     */
+    cfdobject()
+        : victim(nullptr), victim_fd(-1), dropped(false), cnt(0),
+          error(false){};
+
+  protected:
+    virtual void handle_wakeup(rofl::cthread &thread){};
+    virtual void handle_timeout(rofl::cthread &thread, uint32_t timer_id){};
+    virtual void handle_read_event(rofl::cthread &thread, int fd);
+    virtual void handle_write_event(rofl::cthread &thread, int fd){};
+
+  public:
+    // dropped on first read event
+    cfdobject *victim;
+    int victim_fd;
+
+    std::atomic_bool dropped;
+    std::atomic<uint64_t> cnt;
+    std::atomic_bool error;
+  };
+
 private:
   cobject *object;
 
@@ -45,4 +123,21 @@ public:
   void tearDown();
 
   void test1();
+  void test_wheel();
+  void test_wheel_thread();
+  void test_timer_benchmark();
+  void test_work_stealing();
+  void test_job_home();
+  void test_dispatch();
+  void test_dispatch_benchmark();
+
+private:
+  double run_timer_benchmark(rofl::cthread::timer_backend_t timer_backend,
+                             unsigned int num_envs, unsigned int num_ids);
+
+  std::vector<double>
+  run_scheduler_benchmark(rofl::cthread::hnd_scheduler_t hnd_scheduler,
+                          uint64_t &steals);
+
+  double run_dispatch_benchmark(unsigned int num_threads, unsigned int num_fds);
 };
@@ -1,12 +1,54 @@
 #include <stdlib.h>
+#include <time.h>
 
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
 
+#include "../../testutil.hpp"
 #include "cofflowmod_test.h"
 
 CPPUNIT_TEST_SUITE_REGISTRATION(cofflowmod_test);
 
+namespace {
+
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+const uint32_t exp_id = 0x00aabbcc;
+const uint32_t exp_oxm_id =
+    ((uint32_t)rofl::openflow::OFPXMC_EXPERIMENTER << 16) | (1 << 9) |
+    (sizeof(uint32_t) + sizeof(uint16_t));
+
+rofl::openflow::cofflowmod flowmod13(const rofl::cmacaddr &eth_dst,
+                                     uint32_t ipv4_dst,
+                                     const rofl::cmacaddr &eth_src,
+                                     uint32_t port_no, uint64_t cookie) {
+  rofl::caddress_in4 dst;
+  dst.set_addr_hbo(ipv4_dst);
+
+  rofl::openflow::cofflowmod flowmod(rofl::openflow13::OFP_VERSION);
+  flowmod.set_command(rofl::openflow::OFPFC_ADD);
+  flowmod.set_table_id(1);
+  flowmod.set_priority(0x8000);
+  flowmod.set_cookie(cookie);
+  flowmod.set_match().set_eth_dst(eth_dst);
+  flowmod.set_match().set_eth_type(0x0800);
+  flowmod.set_match().set_ipv4_dst(dst);
+  rofl::openflow::cofactions &actions = flowmod.set_instructions()
+                                            .set_inst_apply_actions()
+                                            .set_actions();
+  actions.add_action_set_field(rofl::cindex(0))
+      .set_oxm(rofl::openflow::coxmatch_ofb_eth_src(eth_src));
+  actions.add_action_output(rofl::cindex(1)).set_port_no(port_no);
+  flowmod.set_instructions().set_inst_goto_table().set_table_id(2);
+  return flowmod;
+}
+
+}; // namespace
+
 #if defined DEBUG
 #undef DEBUG
 #endif
@@ -167,3 +209,155 @@ void cofflowmod_test::testFlowMod13() {
       clone.get_instructions().get_inst_goto_table().get_table_id() ==
       (table_id + 1));
 }
+
+void cofflowmod_test::testTemplate10() {
+  rofl::openflow::cofflowmod flowmod(rofl::openflow10::OFP_VERSION);
+  flowmod.set_command(rofl::openflow::OFPFC_ADD);
+  flowmod.set_match().set_eth_type(0x0800);
+  flowmod.set_actions().add_action_output(rofl::cindex(0)).set_port_no(1);
+
+  rofl::openflow::cofflowmod_template tmpl(flowmod);
+  CPPUNIT_ASSERT(tmpl.length() == flowmod.length());
+  CPPUNIT_ASSERT(tmpl.get_num_output_ports() == 1);
+  CPPUNIT_ASSERT_THROW(
+      tmpl.get_match_field(rofl::openflow::OXM_TLV_BASIC_ETH_TYPE),
+      rofl::openflow::eOxmNotFound);
+  CPPUNIT_ASSERT_THROW(tmpl.set_output_port(0, 0x10000), rofl::eInvalid);
+
+  tmpl.set_output_port(0, 0xa1a2).set_cookie(0xb1b2b3b4b5b6b7b8);
+  tmpl.set_priority(0xc1c2).set_idle_timeout(0xd1d2);
+  tmpl.set_hard_timeout(0xe1e2).set_buffer_id(0xf1f2f3f4);
+
+  flowmod.set_actions().set_action_output(rofl::cindex(0)).set_port_no(0xa1a2);
+  flowmod.set_cookie(0xb1b2b3b4b5b6b7b8);
+  flowmod.set_priority(0xc1c2);
+  flowmod.set_idle_timeout(0xd1d2);
+  flowmod.set_hard_timeout(0xe1e2);
+  flowmod.set_buffer_id(0xf1f2f3f4);
+
+  rofl::cmemory expected(flowmod.length());
+  flowmod.pack(expected.somem(), expected.length());
+  rofl::cmemory packed(tmpl.length());
+  tmpl.pack(packed.somem(), packed.length());
+  CPPUNIT_ASSERT(packed == expected);
+}
+
+void cofflowmod_test::testTemplate13() {
+  rofl::openflow::cofflowmod_template tmpl(
+      flowmod13(rofl::cmacaddr("a1:a2:a3:a4:a5:a6"), 0x0a000001,
+                rofl::cmacaddr("b1:b2:b3:b4:b5:b6"), 1, 0));
+  CPPUNIT_ASSERT(tmpl.get_num_output_ports() == 1);
+  CPPUNIT_ASSERT_THROW(
+      tmpl.get_match_field(rofl::openflow::OXM_TLV_BASIC_VLAN_VID),
+      rofl::openflow::eOxmNotFound);
+  CPPUNIT_ASSERT_THROW(
+      tmpl.get_set_field(rofl::openflow::OXM_TLV_BASIC_ETH_SRC, 1),
+      rofl::openflow::eOxmActionNotFound);
+  CPPUNIT_ASSERT_THROW(tmpl.set_output_port(1, 2),
+                       rofl::openflow::eOxmActionNotFound);
+
+  size_t eth_dst = tmpl.get_match_field(rofl::openflow::OXM_TLV_BASIC_ETH_DST);
+  size_t ipv4_dst =
+      tmpl.get_match_field(rofl::openflow::OXM_TLV_BASIC_IPV4_DST);
+  size_t eth_src = tmpl.get_set_field(rofl::openflow::OXM_TLV_BASIC_ETH_SRC);
+
+  rofl::caddress_in4 dst;
+  dst.set_addr_hbo(0x0a0b0c0d);
+  tmpl.set_mac(eth_dst, rofl::cmacaddr("c1:c2:c3:c4:c5:c6"))
+      .set_ipv4(ipv4_dst, dst)
+      .set_mac(eth_src, rofl::cmacaddr("d1:d2:d3:d4:d5:d6"))
+      .set_output_port(0, 0xe1e2e3e4)
+      .set_cookie(0xf1f2f3f4f5f6f7f8);
+
+  rofl::openflow::cofflowmod flowmod = flowmod13(
+      rofl::cmacaddr("c1:c2:c3:c4:c5:c6"), 0x0a0b0c0d,
+      rofl::cmacaddr("d1:d2:d3:d4:d5:d6"), 0xe1e2e3e4, 0xf1f2f3f4f5f6f7f8);
+  rofl::cmemory expected(flowmod.length());
+  flowmod.pack(expected.somem(), expected.length());
+  rofl::cmemory packed(tmpl.length());
+  tmpl.pack(packed.somem(), packed.length());
+  CPPUNIT_ASSERT(packed == expected);
+
+  CPPUNIT_ASSERT_THROW(tmpl.set_u32(tmpl.length() - 2, 0),
+                       rofl::eInvalid);
+}
+
+static rofl::openflow::cofflowmod flowmod13_exp(uint16_t match_value,
+                                                uint16_t set_field_value) {
+  rofl::openflow::cofflowmod flowmod(rofl::openflow13::OFP_VERSION);
+  flowmod.set_command(rofl::openflow::OFPFC_ADD);
+  flowmod.set_match().set_eth_type(0x0800);
+  flowmod.set_match()
+      .set_matches()
+      .add_exp_match(exp_id, exp_oxm_id)
+      .set_u16value(match_value);
+  flowmod.set_instructions()
+      .set_inst_apply_actions()
+      .set_actions()
+      .add_action_set_field(rofl::cindex(0))
+      .set_oxm(rofl::openflow::coxmatch_exp(exp_oxm_id, exp_id,
+                                            set_field_value));
+  return flowmod;
+}
+
+void cofflowmod_test::testTemplateExperimenter() {
+  rofl::openflow::cofflowmod_template tmpl(flowmod13_exp(0x1111, 0x2222));
+
+  /* values of experimenter OXMs follow the experimenter id */
+  size_t match = tmpl.get_match_field(exp_oxm_id);
+  size_t set_field = tmpl.get_set_field(exp_oxm_id);
+  tmpl.set_u16(match, 0xa1a2).set_u16(set_field, 0xb1b2);
+
+  rofl::openflow::cofflowmod flowmod = flowmod13_exp(0xa1a2, 0xb1b2);
+  rofl::cmemory expected(flowmod.length());
+  flowmod.pack(expected.somem(), expected.length());
+  rofl::cmemory packed(tmpl.length());
+  tmpl.pack(packed.somem(), packed.length());
+  CPPUNIT_ASSERT(packed == expected);
+}
+
+void cofflowmod_test::testTemplateBenchmark() {
+  const unsigned int num_flows = testutil::bench_size(100000, 1000);
+  rofl::cmacaddr eth_dst("a1:a2:a3:a4:a5:a6");
+  rofl::cmacaddr eth_src("b1:b2:b3:b4:b5:b6");
+  rofl::cmemory mem(1024);
+  struct rofl::openflow::ofp_header *hdr =
+      (struct rofl::openflow::ofp_header *)mem.somem();
+
+  /* build and pack the object graph for each Flow-Mod */
+  double start = now();
+  for (unsigned int i = 0; i < num_flows; i++) {
+    eth_dst.set_mac(0x020000000000 + i);
+    rofl::openflow::cofmsg_flow_mod msg(
+        rofl::openflow13::OFP_VERSION, i,
+        flowmod13(eth_dst, 0x0a000000 + i, eth_src, i % 48, i));
+    msg.pack(mem.somem(), mem.length());
+  }
+  double t_pack = now() - start;
+
+  /* patch a template */
+  rofl::openflow::cofflowmod_template tmpl(
+      flowmod13(eth_dst, 0, eth_src, 0, 0));
+  size_t eth_dst_offset =
+      tmpl.get_match_field(rofl::openflow::OXM_TLV_BASIC_ETH_DST);
+  size_t ipv4_dst_offset =
+      tmpl.get_match_field(rofl::openflow::OXM_TLV_BASIC_IPV4_DST);
+  start = now();
+  for (unsigned int i = 0; i < num_flows; i++) {
+    eth_dst.set_mac(0x020000000000 + i);
+    tmpl.set_mac(eth_dst_offset, eth_dst)
+        .set_u32(ipv4_dst_offset, 0x0a000000 + i)
+        .set_output_port(0, i % 48)
+        .set_cookie(i);
+    hdr->version = rofl::openflow13::OFP_VERSION;
+    hdr->type = rofl::openflow13::OFPT_FLOW_MOD;
+    hdr->length = htobe16(sizeof(*hdr) + tmpl.length());
+    hdr->xid = htobe32(i);
+    tmpl.pack(hdr->body, mem.length() - sizeof(*hdr));
+  }
+  double t_tmpl = now() - start;
+
+  std::cerr << "flow-mod: build+pack: " << 1e9 * t_pack / num_flows
+            << " ns template: " << 1e9 * t_tmpl / num_flows
+            << " ns speedup: " << t_pack / t_tmpl << std::endl;
+}
@@ -1,6 +1,8 @@
 #include "rofl/common/caddress.h"
 #include "rofl/common/cmemory.h"
 #include "rofl/common/openflow/cofflowmod.h"
+#include "rofl/common/openflow/cofflowmodtemplate.h"
+#include "rofl/common/openflow/messages/cofmsg_flow_mod.h"
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 
@@ -9,6 +11,10 @@ class cofflowmod_test : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(cofflowmod_test);
   CPPUNIT_TEST(testFlowMod10);
   CPPUNIT_TEST(testFlowMod13);
+  CPPUNIT_TEST(testTemplate10);
+  CPPUNIT_TEST(testTemplate13);
+  CPPUNIT_TEST(testTemplateExperimenter);
+  CPPUNIT_TEST(testTemplateBenchmark);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -18,4 +24,8 @@ public:
 
   void testFlowMod10();
   void testFlowMod13();
+  void testTemplate10();
+  void testTemplate13();
+  void testTemplateExperimenter();
+  void testTemplateBenchmark();
 };
@@ -6,16 +6,162 @@
  */
 
 #include <stdlib.h>
+#include <time.h>
+#include <vector>
 
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
 
+#include "../../testutil.hpp"
 #include "coxmatchestest.hpp"
 
 using namespace rofl::openflow;
 
 CPPUNIT_TEST_SUITE_REGISTRATION(coxmatchestest);
 
+namespace {
+
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* OXM TLVs covered by the round-trip tests, in ascending storage order */
+const struct {
+  uint32_t oxm_id;
+  bool maskable;
+} fuzz_fields[] = {
+    {rofl::openflow::OXM_TLV_BASIC_IN_PORT, false},
+    {rofl::openflow::OXM_TLV_BASIC_IN_PHY_PORT, false},
+    {rofl::openflow::OXM_TLV_BASIC_METADATA, true},
+    {rofl::openflow::OXM_TLV_BASIC_ETH_DST, true},
+    {rofl::openflow::OXM_TLV_BASIC_ETH_SRC, true},
+    {rofl::openflow::OXM_TLV_BASIC_ETH_TYPE, false},
+    {rofl::openflow::OXM_TLV_BASIC_VLAN_VID, true},
+    {rofl::openflow::OXM_TLV_BASIC_VLAN_PCP, false},
+    {rofl::openflow::OXM_TLV_BASIC_IP_DSCP, false},
+    {rofl::openflow::OXM_TLV_BASIC_IP_ECN, false},
+    {rofl::openflow::OXM_TLV_BASIC_IP_PROTO, false},
+    {rofl::openflow::OXM_TLV_BASIC_IPV4_SRC, true},
+    {rofl::openflow::OXM_TLV_BASIC_IPV4_DST, true},
+    {rofl::openflow::OXM_TLV_BASIC_TCP_SRC, false},
+    {rofl::openflow::OXM_TLV_BASIC_TCP_DST, false},
+    {rofl::openflow::OXM_TLV_BASIC_UDP_SRC, false},
+    {rofl::openflow::OXM_TLV_BASIC_UDP_DST, false},
+    {rofl::openflow::OXM_TLV_BASIC_SCTP_SRC, false},
+    {rofl::openflow::OXM_TLV_BASIC_SCTP_DST, false},
+    {rofl::openflow::OXM_TLV_BASIC_ICMPV4_TYPE, false},
+    {rofl::openflow::OXM_TLV_BASIC_ICMPV4_CODE, false},
+    {rofl::openflow::OXM_TLV_BASIC_ARP_OP, false},
+    {rofl::openflow::OXM_TLV_BASIC_ARP_SPA, true},
+    {rofl::openflow::OXM_TLV_BASIC_ARP_TPA, true},
+    {rofl::openflow::OXM_TLV_BASIC_ARP_SHA, true},
+    {rofl::openflow::OXM_TLV_BASIC_ARP_THA, true},
+    {rofl::openflow::OXM_TLV_BASIC_IPV6_SRC, true},
+    {rofl::openflow::OXM_TLV_BASIC_IPV6_DST, true},
+    {rofl::openflow::OXM_TLV_BASIC_IPV6_FLABEL, true},
+    {rofl::openflow::OXM_TLV_BASIC_ICMPV6_TYPE, false},
+    {rofl::openflow::OXM_TLV_BASIC_ICMPV6_CODE, false},
+    {rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TARGET, false},
+    {rofl::openflow::OXM_TLV_BASIC_IPV6_ND_SLL, false},
+    {rofl::openflow::OXM_TLV_BASIC_IPV6_ND_TLL, false},
+    {rofl::openflow::OXM_TLV_BASIC_MPLS_LABEL, false},
+    {rofl::openflow::OXM_TLV_BASIC_MPLS_TC, false},
+    {rofl::openflow::OXM_TLV_BASIC_MPLS_BOS, false},
+    {rofl::openflow::OXM_TLV_BASIC_PBB_ISID, true},
+    {rofl::openflow::OXM_TLV_BASIC_TUNNEL_ID, true},
+    {rofl::openflow::OXM_TLV_BASIC_IPV6_EXTHDR, true},
+    {(uint32_t)rofl::openflow::experimental::OXM_TLV_EXPR_NW_SRC, true},
+    {(uint32_t)rofl::openflow::experimental::OXM_TLV_EXPR_NW_DST, true},
+    {(uint32_t)rofl::openflow::experimental::OXM_TLV_EXPR_NW_PROTO, false},
+    {(uint32_t)rofl::openflow::experimental::OXM_TLV_EXPR_NW_TOS, false},
+    {(uint32_t)rofl::openflow::experimental::OXM_TLV_EXPR_TP_SRC, false},
+    {(uint32_t)rofl::openflow::experimental::OXM_TLV_EXPR_TP_DST, false},
+};
+
+/* experimenter id sorting after ROFL_EXP_ID, decoded as opaque coxmatch_exp */
+const uint32_t fuzz_exp_id = 0xb0b1b2b3;
+
+void append_tlv(std::vector<uint8_t> &buf, uint32_t oxm_id, uint32_t exp_id,
+                size_t len, bool hasmask, unsigned int *seed) {
+  size_t oxm_len = (hasmask ? 2 * len : len) + (exp_id ? sizeof(exp_id) : 0);
+  oxm_id = (oxm_id & 0xfffffe00) | (hasmask ? HAS_MASK_FLAG : 0) | oxm_len;
+  for (int i = 24; i >= 0; i -= 8) {
+    buf.push_back(oxm_id >> i);
+  }
+  for (int i = 24; exp_id && (i >= 0); i -= 8) {
+    buf.push_back(exp_id >> i);
+  }
+  for (size_t i = 0; i < (hasmask ? 2 * len : len); i++) {
+    buf.push_back(rand_r(seed));
+  }
+}
+
+/* random but well-formed OXM TLV list in wire format */
+std::vector<uint8_t> random_matches(unsigned int *seed) {
+  std::vector<uint8_t> buf;
+  for (auto &field : fuzz_fields) {
+    if (rand_r(seed) % 3) {
+      continue;
+    }
+    bool hasmask = field.maskable && (rand_r(seed) % 2);
+    uint32_t exp_id =
+        ((field.oxm_id >> 16) == rofl::openflow::OFPXMC_EXPERIMENTER)
+            ? (uint32_t)rofl::openflow::ROFL_EXP_ID
+            : 0;
+    append_tlv(buf, field.oxm_id, exp_id, field.oxm_id & 0xff, hasmask, seed);
+  }
+  if (rand_r(seed) % 2) {
+    append_tlv(buf, (uint32_t)rofl::openflow::OFPXMC_EXPERIMENTER << 16,
+               fuzz_exp_id, 1 + rand_r(seed) % 16, rand_r(seed) % 2, seed);
+  }
+  return buf;
+}
+
+/* match sets captured from flow-mods of typical applications */
+uint8_t captured_l2[] = {
+    0x80, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x01, 0x80, 0x00, 0x06, 0x06,
+    0x00, 0x11, 0x22, 0x33, 0x44, 0x55, 0x80, 0x00, 0x08, 0x06, 0x00, 0x66,
+    0x77, 0x88, 0x99, 0xaa, 0x80, 0x00, 0x0c, 0x02, 0x10, 0x64,
+};
+
+uint8_t captured_ipv4[] = {
+    0x80, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x02, 0x80, 0x00, 0x0a, 0x02,
+    0x08, 0x00, 0x80, 0x00, 0x14, 0x01, 0x06, 0x80, 0x00, 0x16, 0x04, 0x0a,
+    0x00, 0x00, 0x01, 0x80, 0x00, 0x19, 0x08, 0x0a, 0x00, 0x01, 0x00, 0xff,
+    0xff, 0xff, 0x00, 0x80, 0x00, 0x1a, 0x02, 0xc0, 0x00, 0x80, 0x00, 0x1c,
+    0x02, 0x00, 0x50,
+};
+
+uint8_t captured_ipv6[] = {
+    0x80, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x03, 0x80, 0x00, 0x0a, 0x02,
+    0x86, 0xdd, 0x80, 0x00, 0x14, 0x01, 0x11, 0x80, 0x00, 0x20, 0x02, 0x00,
+    0x35, 0x80, 0x00, 0x34, 0x10, 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x80, 0x00, 0x37,
+    0x20, 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0xff, 0xff, 0xff, 0xff, 0xff, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+};
+
+uint8_t captured_arp[] = {
+    0x80, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x04, 0x80, 0x00, 0x0a, 0x02,
+    0x08, 0x06, 0x80, 0x00, 0x2a, 0x02, 0x00, 0x01, 0x80, 0x00, 0x2c, 0x04,
+    0x0a, 0x00, 0x00, 0x01, 0x80, 0x00, 0x2e, 0x04, 0x0a, 0x00, 0x00, 0x02,
+    0x80, 0x00, 0x30, 0x06, 0x00, 0x11, 0x22, 0x33, 0x44, 0x55,
+};
+
+uint8_t captured_mpls[] = {
+    0x80, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x05, 0x80, 0x00, 0x05, 0x10,
+    0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0xff, 0xff, 0xff, 0xff,
+    0x00, 0x00, 0x00, 0x00, 0x80, 0x00, 0x0a, 0x02, 0x88, 0x47, 0x80, 0x00,
+    0x44, 0x04, 0x00, 0x01, 0x23, 0x45, 0x80, 0x00, 0x46, 0x01, 0x03, 0x80,
+    0x00, 0x48, 0x01, 0x01, 0x80, 0x00, 0x4c, 0x08, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x10, 0x00,
+};
+
+}; // namespace
+
 void coxmatchestest::setUp() {}
 
 void coxmatchestest::tearDown() {}
@@ -430,3 +576,352 @@ void coxmatchestest::testExp() {
   CPPUNIT_ASSERT(clone.get_exp_match(exp_id, oxm_id2).get_value() == u17value);
   CPPUNIT_ASSERT(clone.get_exp_match(exp_id, oxm_id2).get_mask() == u17mask);
 }
+
+void coxmatchestest::testOrder() {
+  rofl::openflow::coxmatches matches;
+
+  /* more fields than stored inline, added in descending order */
+  matches.add_ofb_ipv6_exthdr(0x0102);
+  matches.add_ofb_tunnel_id(0x0102030405060708);
+  matches.add_ofb_mpls_label(0x010203);
+  matches.add_ofb_ipv6_src(rofl::caddress_in6("fe80::1"));
+  matches.add_ofb_arp_opcode(1);
+  matches.add_ofb_udp_dst(53);
+  matches.add_ofb_tcp_src(1024);
+  matches.add_ofb_ipv4_dst(rofl::caddress_in4("10.0.0.2"));
+  matches.add_ofb_ip_proto(6);
+  matches.add_ofb_vlan_pcp(3);
+  matches.add_ofb_eth_type(0x0800);
+  matches.add_ofb_eth_dst(rofl::cmacaddr("00:11:22:33:44:55"));
+  matches.add_ofb_in_port(7);
+  CPPUNIT_ASSERT(matches.get_matches().size() == 13);
+
+  /* identifiers and wire order are ascending */
+  std::vector<uint64_t> ids = matches.get_ids();
+  CPPUNIT_ASSERT(ids.size() == 13);
+  for (unsigned int i = 1; i < ids.size(); i++) {
+    CPPUNIT_ASSERT(ids[i - 1] < ids[i]);
+  }
+
+  rofl::cmemory mem(matches.length());
+  matches.pack(mem.somem(), mem.length());
+  struct rofl::openflow::ofp_oxm_hdr *hdr =
+      (struct rofl::openflow::ofp_oxm_hdr *)mem.somem();
+  CPPUNIT_ASSERT(be16toh(hdr->oxm_class) ==
+                 rofl::openflow::OFPXMC_OPENFLOW_BASIC);
+  CPPUNIT_ASSERT((hdr->oxm_field >> 1) == rofl::openflow::OFPXMT_OFB_IN_PORT);
+
+  rofl::openflow::coxmatches clone(matches);
+  CPPUNIT_ASSERT(clone == matches);
+  rofl::openflow::coxmatches unpacked;
+  unpacked.unpack(mem.somem(), mem.length());
+  CPPUNIT_ASSERT(unpacked == matches);
+  CPPUNIT_ASSERT(unpacked.get_ofb_udp_dst().get_u16value() == 53);
+
+  /* replace and drop fields in the middle */
+  matches.add_ofb_ip_proto(17);
+  CPPUNIT_ASSERT(matches.get_matches().size() == 13);
+  CPPUNIT_ASSERT(matches.get_ofb_ip_proto().get_u8value() == 17);
+  CPPUNIT_ASSERT(clone.get_ofb_ip_proto().get_u8value() == 6);
+  CPPUNIT_ASSERT(matches.drop_ofb_tcp_src());
+  CPPUNIT_ASSERT(matches.drop_ofb_in_port());
+  CPPUNIT_ASSERT(matches.drop_ofb_ipv6_exthdr());
+  CPPUNIT_ASSERT(not matches.drop_ofb_ipv6_exthdr());
+  CPPUNIT_ASSERT(matches.get_matches().size() == 10);
+  CPPUNIT_ASSERT(not matches.has_ofb_tcp_src());
+  CPPUNIT_ASSERT(matches.has_ofb_udp_dst());
+  CPPUNIT_ASSERT(matches.get_ofb_tunnel_id().get_u64value() ==
+                 0x0102030405060708);
+
+  ids = matches.get_ids();
+  for (unsigned int i = 1; i < ids.size(); i++) {
+    CPPUNIT_ASSERT(ids[i - 1] < ids[i]);
+  }
+
+  matches.clear();
+  CPPUNIT_ASSERT(matches.get_matches().empty());
+  CPPUNIT_ASSERT(matches.length() == 0);
+}
+
+void coxmatchestest::fill_l2(rofl::openflow::coxmatches &matches) {
+  static const rofl::cmacaddr eth_dst("00:11:11:11:11:11");
+  static const rofl::cmacaddr eth_src("00:22:22:22:22:22");
+  matches.add_ofb_in_port(1);
+  matches.add_ofb_eth_dst(eth_dst);
+  matches.add_ofb_eth_src(eth_src);
+  matches.add_ofb_vlan_vid(rofl::openflow::OFPVID_PRESENT | 100);
+}
+
+void coxmatchestest::fill_l3(rofl::openflow::coxmatches &matches) {
+  static const rofl::caddress_in4 ipv4_src("10.0.0.0");
+  static const rofl::caddress_in4 ipv4_mask("255.255.255.0");
+  static const rofl::caddress_in4 ipv4_dst("10.0.1.1");
+  fill_l2(matches);
+  matches.add_ofb_eth_type(0x0800);
+  matches.add_ofb_ipv4_src(ipv4_src, ipv4_mask);
+  matches.add_ofb_ipv4_dst(ipv4_dst);
+}
+
+void coxmatchestest::fill_l4(rofl::openflow::coxmatches &matches) {
+  fill_l3(matches);
+  matches.add_ofb_ip_proto(6);
+  matches.add_ofb_tcp_dst(80);
+}
+
+void coxmatchestest::run_benchmark(
+    const std::string &name,
+    void (coxmatchestest::*fill)(rofl::openflow::coxmatches &),
+    unsigned int num_iters) {
+  size_t bytes = 0;
+
+  double start = now();
+  for (unsigned int i = 0; i < num_iters; i++) {
+    rofl::openflow::coxmatches matches;
+    (this->*fill)(matches);
+    bytes += matches.get_matches().size();
+  }
+  double t_build = now() - start;
+
+  rofl::openflow::coxmatches matches;
+  (this->*fill)(matches);
+  start = now();
+  for (unsigned int i = 0; i < num_iters; i++) {
+    rofl::openflow::coxmatches copy(matches);
+    bytes += copy.get_matches().size();
+  }
+  double t_copy = now() - start;
+
+  rofl::cmemory mem(matches.length());
+  start = now();
+  for (unsigned int i = 0; i < num_iters; i++) {
+    matches.pack(mem.somem(), matches.length());
+    bytes += mem[0];
+  }
+  double t_pack = now() - start;
+
+  start = now();
+  for (unsigned int i = 0; i < num_iters; i++) {
+    rofl::openflow::coxmatches unpacked;
+    unpacked.unpack(mem.somem(), mem.length());
+    bytes += unpacked.get_matches().size();
+  }
+  double t_unpack = now() - start;
+
+  std::cerr << name << " (" << matches.get_matches().size()
+            << " fields) ns/op: build: " << 1e9 * t_build / num_iters
+            << " copy: " << 1e9 * t_copy / num_iters
+            << " pack: " << 1e9 * t_pack / num_iters
+            << " unpack: " << 1e9 * t_unpack / num_iters << std::endl;
+
+  CPPUNIT_ASSERT(bytes > 0);
+}
+
+void coxmatchestest::testBenchmark() {
+  const unsigned int num_iters = testutil::bench_size(100000, 1000);
+  run_benchmark("L2", &coxmatchestest::fill_l2, num_iters);
+  run_benchmark("L3", &coxmatchestest::fill_l3, num_iters);
+  run_benchmark("L4", &coxmatchestest::fill_l4, num_iters);
+}
+
+void coxmatchestest::testRoundTrip() {
+  unsigned int seed = 0x4f584d00;
+  unsigned int accepted = 0, rejected = 0;
+
+  for (unsigned int i = 0; i < 2000; i++) {
+    std::vector<uint8_t> buf = random_matches(&seed);
+
+    /* well-formed lists decode and encode to identical bytes */
+    rofl::openflow::coxmatches matches;
+    matches.unpack(buf.data(), buf.size());
+    CPPUNIT_ASSERT(matches.length() == buf.size());
+    std::vector<uint8_t> packed(matches.length());
+    matches.pack(packed.data(), packed.size());
+    CPPUNIT_ASSERT(packed == buf);
+
+    /* corrupted lists are either rejected or decode consistently */
+    if (buf.empty()) {
+      continue;
+    }
+    unsigned int num_errors = 1 + rand_r(&seed) % 4;
+    for (unsigned int j = 0; j < num_errors; j++) {
+      buf[rand_r(&seed) % buf.size()] = rand_r(&seed);
+    }
+    if (rand_r(&seed) % 4 == 0) {
+      buf.resize(rand_r(&seed) % buf.size());
+    }
+    rofl::openflow::coxmatches mutated;
+    try {
+      mutated.unpack(buf.data(), buf.size());
+    } catch (rofl::exception &e) {
+      rejected++;
+      continue;
+    }
+    accepted++;
+    packed.resize(mutated.length());
+    mutated.pack(packed.data(), packed.size());
+    rofl::openflow::coxmatches clone;
+    clone.unpack(packed.data(), packed.size());
+    CPPUNIT_ASSERT(clone == mutated);
+  }
+
+  std::cerr << "corrupted OXM lists accepted: " << accepted
+            << " rejected: " << rejected << std::endl;
+  CPPUNIT_ASSERT(rejected > 0);
+}
+
+void coxmatchestest::testMalformed() {
+  rofl::openflow::coxmatches matches;
+
+  /* masked IN_PORT */
+  uint8_t in_port[] = {0x80, 0x00, 0x01, 0x08, 0x00, 0x00, 0x00,
+                       0x01, 0xff, 0xff, 0xff, 0xff};
+  CPPUNIT_ASSERT_THROW(matches.unpack(in_port, sizeof(in_port)),
+                       rofl::eBadMatchBadMask);
+
+  /* ETH_TYPE with three bytes */
+  uint8_t eth_type[] = {0x80, 0x00, 0x0a, 0x03, 0x08, 0x00, 0x00};
+  CPPUNIT_ASSERT_THROW(matches.unpack(eth_type, sizeof(eth_type)),
+                       rofl::openflow::eOxmBadLen);
+
+  /* IPV4_SRC exceeding the buffer */
+  uint8_t ipv4_src[] = {0x80, 0x00, 0x16, 0x04, 0x0a, 0x00};
+  CPPUNIT_ASSERT_THROW(matches.unpack(ipv4_src, sizeof(ipv4_src)),
+                       rofl::openflow::eOxmBadLen);
+
+  /* experimenter TLV without experimenter id */
+  uint8_t exp[] = {0xff, 0xff, 0x00, 0x02, 0xa1, 0xa2, 0xa3, 0xa4};
+  CPPUNIT_ASSERT_THROW(matches.unpack(exp, sizeof(exp)),
+                       rofl::openflow::eOxmBadLen);
+
+  /* unknown fields and classes are skipped, trailing padding is ignored */
+  uint8_t skipped[] = {0x80, 0x00, 0xfe, 0x02, 0x01, 0x02, 0x00, 0x01,
+                       0x00, 0x01, 0xff, 0x80, 0x00, 0x0a, 0x02, 0x08,
+                       0x00, 0x00, 0x00, 0x00};
+  matches.unpack(skipped, sizeof(skipped));
+  CPPUNIT_ASSERT(matches.get_matches().size() == 1);
+  CPPUNIT_ASSERT(matches.get_ofb_eth_type().get_u16value() == 0x0800);
+
+  /* a duplicate field replaces the earlier one */
+  uint8_t dup[] = {0x80, 0x00, 0x14, 0x01, 0x06,
+                   0x80, 0x00, 0x14, 0x01, 0x11};
+  matches.unpack(dup, sizeof(dup));
+  CPPUNIT_ASSERT(matches.get_matches().size() == 1);
+  CPPUNIT_ASSERT(matches.get_ofb_ip_proto().get_u8value() == 17);
+}
+
+void coxmatchestest::testLongExp() {
+  /* not ROFL_EXP_ID, its fields have fixed sizes */
+  const uint32_t exp_id = 0x00c0ffee;
+  const uint32_t oxm_id =
+      ((uint32_t)rofl::openflow::OFPXMC_EXPERIMENTER << 16) | (0x01 << 9);
+
+  /* value and mask exceed an inline slot */
+  rofl::cmemory value(40);
+  rofl::cmemory mask(40);
+  for (unsigned int i = 0; i < value.length(); i++) {
+    value[i] = i;
+    mask[i] = 0xff - i;
+  }
+
+  rofl::openflow::coxmatches matches;
+  matches.add_exp_match(exp_id, oxm_id).set_value(value).set_mask(mask);
+  matches.add_ofb_ip_proto(6);
+  CPPUNIT_ASSERT(matches.get_matches().size() == 2);
+  CPPUNIT_ASSERT(matches.get_exp_match(exp_id, oxm_id).get_value() == value);
+  CPPUNIT_ASSERT(matches.get_exp_match(exp_id, oxm_id).get_mask() == mask);
+
+  rofl::cmemory mem(matches.length());
+  CPPUNIT_ASSERT(mem.length() == 4 + 4 + 80 + 5);
+  matches.pack(mem.somem(), mem.length());
+
+  /* copies own their long TLVs */
+  rofl::openflow::coxmatches copy(matches);
+  matches.clear();
+  CPPUNIT_ASSERT(copy.get_exp_match(exp_id, oxm_id).get_value() == value);
+
+  rofl::openflow::coxmatches unpacked;
+  unpacked.unpack(mem.somem(), mem.length());
+  CPPUNIT_ASSERT(unpacked == copy);
+  CPPUNIT_ASSERT(unpacked.get_exp_match(exp_id, oxm_id).get_mask() == mask);
+
+  /* shrinking the TLV moves it back into its slot */
+  unpacked.set_exp_match(exp_id, oxm_id) =
+      rofl::openflow::coxmatch_exp(oxm_id, exp_id, (uint16_t)0x0800);
+  CPPUNIT_ASSERT(unpacked.length() == 4 + 4 + 2 + 5);
+  CPPUNIT_ASSERT(unpacked.get_exp_match(exp_id, oxm_id).get_u16value() ==
+                 0x0800);
+}
+
+void coxmatchestest::testReferences() {
+  rofl::openflow::coxmatches matches;
+  rofl::openflow::coxmatch_ofb_vlan_vid &vid = matches.add_ofb_vlan_vid(1);
+  matches.add_ofb_ip_proto(6);
+
+  /* modifications through a reference reach the wire format */
+  vid.set_u16value(2).set_u16mask(0x0fff);
+  CPPUNIT_ASSERT(&matches.set_ofb_vlan_vid() == &vid);
+  CPPUNIT_ASSERT(&matches.get_ofb_vlan_vid() == &vid);
+  CPPUNIT_ASSERT(matches.length() == 8 + 5);
+
+  rofl::cmemory mem(matches.length());
+  matches.pack(mem.somem(), mem.length());
+  rofl::openflow::coxmatches unpacked;
+  unpacked.unpack(mem.somem(), mem.length());
+  CPPUNIT_ASSERT(unpacked.get_ofb_vlan_vid().get_u16value() == 2);
+  CPPUNIT_ASSERT(unpacked.get_ofb_vlan_vid().get_u16mask() == 0x0fff);
+
+  /* copies see pending modifications */
+  vid.set_u16value(3);
+  rofl::openflow::coxmatches copy(matches);
+  CPPUNIT_ASSERT(copy == matches);
+  CPPUNIT_ASSERT(copy.get_ofb_vlan_vid().get_u16value() == 3);
+
+  /* fields decoded on first access are kept until dropped */
+  const rofl::openflow::coxmatch_ofb_ip_proto &proto =
+      unpacked.get_ofb_ip_proto();
+  CPPUNIT_ASSERT(&unpacked.get_ofb_ip_proto() == &proto);
+  unpacked.set_ofb_ip_proto().set_u8value(17);
+  CPPUNIT_ASSERT(proto.get_u8value() == 17);
+  CPPUNIT_ASSERT(unpacked.drop_ofb_ip_proto());
+  CPPUNIT_ASSERT(unpacked.length() == 8);
+}
+
+void coxmatchestest::testDecodeBenchmark() {
+  const struct {
+    const char *name;
+    uint8_t *buf;
+    size_t buflen;
+    size_t num_fields;
+  } captured[] = {
+      {"l2", captured_l2, sizeof(captured_l2), 4},
+      {"ipv4", captured_ipv4, sizeof(captured_ipv4), 7},
+      {"ipv6", captured_ipv6, sizeof(captured_ipv6), 6},
+      {"arp", captured_arp, sizeof(captured_arp), 6},
+      {"mpls", captured_mpls, sizeof(captured_mpls), 7},
+  };
+  const unsigned int num_iters = testutil::bench_size(100000, 1000);
+
+  for (auto &set : captured) {
+    rofl::cmemory mem(set.buf, set.buflen);
+
+    rofl::openflow::coxmatches matches;
+    matches.unpack(mem.somem(), mem.length());
+    CPPUNIT_ASSERT(matches.get_matches().size() == set.num_fields);
+    rofl::cmemory packed(matches.length());
+    matches.pack(packed.somem(), packed.length());
+    CPPUNIT_ASSERT(packed == mem);
+
+    size_t num = 0;
+    double start = now();
+    for (unsigned int i = 0; i < num_iters; i++) {
+      matches.unpack(mem.somem(), mem.length());
+      num += matches.get_matches().size();
+    }
+    double t_unpack = now() - start;
+
+    std::cerr << "decode " << set.name << " (" << set.buflen
+              << " bytes) ns/match: " << 1e9 * t_unpack / num_iters
+              << " ns/field: " << 1e9 * t_unpack / num << std::endl;
+    CPPUNIT_ASSERT(num == num_iters * set.num_fields);
+  }
+}
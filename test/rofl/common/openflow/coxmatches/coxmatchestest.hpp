@@ -27,6 +27,13 @@ class coxmatchestest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testNonStrictMatching);
   CPPUNIT_TEST(testOxmVlanVidUnpack);
   CPPUNIT_TEST(testExp);
+  CPPUNIT_TEST(testOrder);
+  CPPUNIT_TEST(testBenchmark);
+  CPPUNIT_TEST(testRoundTrip);
+  CPPUNIT_TEST(testMalformed);
+  CPPUNIT_TEST(testLongExp);
+  CPPUNIT_TEST(testReferences);
+  CPPUNIT_TEST(testDecodeBenchmark);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -47,6 +54,23 @@ public:
   void testOxmVlanVidUnpack();
 
   void testExp();
+
+  void testOrder();
+  void testBenchmark();
+
+  void testRoundTrip();
+  void testMalformed();
+  void testLongExp();
+  void testReferences();
+  void testDecodeBenchmark();
+
+private:
+  void fill_l2(rofl::openflow::coxmatches &matches);
+  void fill_l3(rofl::openflow::coxmatches &matches);
+  void fill_l4(rofl::openflow::coxmatches &matches);
+  void run_benchmark(const std::string &name,
+                     void (coxmatchestest::*fill)(rofl::openflow::coxmatches &),
+                     unsigned int num_iters);
 };
 
 #endif /* TEST_SRC_ROFL_COMMON_OPENFLOW_COXMATCH_TEST_HPP_ */
@@ -362,3 +362,56 @@ void cofmsgflowmodtest::testFlowModParser13() {
     }
   }
 }
+
+void cofmsgflowmodtest::testFlowModBatch13() {
+  uint8_t version = rofl::openflow13::OFP_VERSION;
+  uint32_t xid = 0xa1a2a3a4;
+
+  rofl::openflow::cofmsg_flow_mod_batch batch(version);
+  rofl::cmemory expected(0);
+
+  for (unsigned int i = 0; i < 3; i++) {
+    /* last entry is converted to the batch's version */
+    rofl::openflow::cofflowmod flowmod(
+        (i < 2) ? version : rofl::openflow12::OFP_VERSION);
+    flowmod.set_priority(0x1000 + i);
+    flowmod.set_match().set_eth_type(0x0800);
+    flowmod.set_instructions().add_inst_goto_table().set_table_id(0xee);
+    batch.add_flow_mod(xid + i, flowmod);
+
+    rofl::openflow::cofmsg_flow_mod msg(version, xid + i, flowmod);
+    rofl::cmemory mem(msg.length());
+    msg.pack(mem.somem(), mem.length());
+    expected += mem;
+  }
+  batch.add_barrier_request(xid + 3);
+
+  rofl::openflow::cofmsg_barrier_request barrier(version, xid + 3);
+  rofl::cmemory mem(barrier.length());
+  barrier.pack(mem.somem(), mem.length());
+  expected += mem;
+
+  CPPUNIT_ASSERT(batch.size() == 4);
+  CPPUNIT_ASSERT(batch.length() == expected.length());
+  CPPUNIT_ASSERT(batch.get_type() == rofl::openflow13::OFPT_FLOW_MOD);
+  CPPUNIT_ASSERT(batch.get_xid() == xid);
+  CPPUNIT_ASSERT(batch.has_barrier_request());
+  CPPUNIT_ASSERT(batch.get_barrier_xid() == xid + 3);
+  CPPUNIT_ASSERT(rofl::openflow::flow_mod_batch_cast(&batch) == &batch);
+  CPPUNIT_ASSERT(rofl::openflow::flow_mod_batch_cast(&barrier) == nullptr);
+
+  /* nothing follows the trailing Barrier-Request */
+  CPPUNIT_ASSERT_THROW(batch.add_barrier_request(xid + 4), rofl::eInvalid);
+  CPPUNIT_ASSERT(batch.size() == 4);
+
+  rofl::cmemory packed(batch.length());
+  batch.pack(packed.somem(), packed.length());
+  CPPUNIT_ASSERT(packed == expected);
+
+  /* wire buffer is handed over without copying */
+  struct iovec payload;
+  uint8_t head[64];
+  CPPUNIT_ASSERT(batch.pack_head(head, sizeof(head), payload) == 0);
+  CPPUNIT_ASSERT(payload.iov_base == batch.get_wire());
+  CPPUNIT_ASSERT(payload.iov_len == expected.length());
+}
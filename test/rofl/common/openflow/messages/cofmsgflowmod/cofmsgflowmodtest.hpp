@@ -12,6 +12,7 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 #include "rofl/common/cmemory.h"
+#include "rofl/common/openflow/messages/cofmsg_barrier.h"
 #include "rofl/common/openflow/messages/cofmsg_flow_mod.h"
 
 class cofmsgflowmodtest : public CppUnit::TestFixture {
@@ -22,6 +23,7 @@ class cofmsgflowmodtest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testFlowModParser10);
   CPPUNIT_TEST(testFlowModParser12);
   CPPUNIT_TEST(testFlowModParser13);
+  CPPUNIT_TEST(testFlowModBatch13);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -35,6 +37,7 @@ public:
   void testFlowModParser10();
   void testFlowModParser12();
   void testFlowModParser13();
+  void testFlowModBatch13();
 
 private:
   void testFlowMod(uint8_t version, uint8_t type, uint32_t xid);
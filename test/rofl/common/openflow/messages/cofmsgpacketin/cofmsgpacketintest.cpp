@@ -6,16 +6,31 @@
  */
 
 #include <stdlib.h>
+#include <time.h>
+
+#include <thread>
+#include <vector>
 
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
 
+#include "../../../testutil.hpp"
 #include "cofmsgpacketintest.hpp"
 
 using namespace rofl::openflow;
 
 CPPUNIT_TEST_SUITE_REGISTRATION(cofmsgpacketintest);
 
+namespace {
+
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+}; // namespace
+
 void cofmsgpacketintest::setUp() {}
 
 void cofmsgpacketintest::tearDown() {}
@@ -372,3 +387,255 @@ void cofmsgpacketintest::testPacketInParser13() {
     }
   }
 }
+
+void cofmsgpacketintest::testLazyDecode10() {
+  testLazyDecode(rofl::openflow10::OFP_VERSION);
+}
+
+void cofmsgpacketintest::testLazyDecode13() {
+  testLazyDecode(rofl::openflow13::OFP_VERSION);
+}
+
+void cofmsgpacketintest::testLazyDecode(uint8_t version) {
+  rofl::openflow::cofmatch match(version);
+  match.set_in_port(0x81828384);
+  match.set_eth_type(0x0800);
+  match.set_eth_dst(rofl::caddress_ll("ff:ff:ff:ff:ff:ff"));
+  rofl::cpacket packet(128);
+  for (unsigned int i = 0; i < packet.length(); i++) {
+    packet.soframe()[i] = i;
+  }
+  uint16_t in_port = 0x8182;
+  rofl::openflow::cofmsg_packet_in msg1(version, 0xa1a2a3a4, 0x31323334, 128,
+                                        0x01, 0x61, 0x7172737475767778,
+                                        in_port, match, packet.soframe(),
+                                        packet.length());
+  rofl::cmemory mem(msg1.length());
+  msg1.pack(mem.somem(), mem.length());
+
+  rofl::openflow::cofmsg_packet_in msg2;
+  msg2.unpack(mem.somem(), mem.length());
+
+  /* accessors on the received message, nothing decoded yet */
+  if (version == rofl::openflow10::OFP_VERSION) {
+    CPPUNIT_ASSERT(msg2.get_match_in_port() == in_port);
+  } else {
+    CPPUNIT_ASSERT(msg2.get_match_in_port() == 0x81828384);
+  }
+  CPPUNIT_ASSERT(msg2.get_framelen() == packet.length());
+  CPPUNIT_ASSERT(
+      memcmp(msg2.get_frame(), packet.soframe(), packet.length()) == 0);
+  CPPUNIT_ASSERT(msg2.length() == msg1.length());
+
+  /* a copy kept beyond the receive path owns its data */
+  rofl::openflow::cofmsg_packet_in *msg3 =
+      new rofl::openflow::cofmsg_packet_in(msg2);
+  msg2.unpack(nullptr, 0);
+  CPPUNIT_ASSERT(msg3->get_framelen() == packet.length());
+  CPPUNIT_ASSERT(msg3->get_packet() == packet);
+  if (version > rofl::openflow10::OFP_VERSION) {
+    CPPUNIT_ASSERT(msg3->get_match().get_eth_type() == 0x0800);
+  }
+  CPPUNIT_ASSERT(msg3->length() == msg1.length());
+
+  /* modifications after decoding are reflected by pack() */
+  msg3->set_packet().resize(64);
+  CPPUNIT_ASSERT(msg3->get_framelen() == 64);
+  CPPUNIT_ASSERT(msg3->length() == msg1.length() - 64);
+  rofl::cmemory mem3(msg3->length());
+  msg3->pack(mem3.somem(), mem3.length());
+  rofl::openflow::cofmsg_packet_in msg4;
+  msg4.unpack(mem3.somem(), mem3.length());
+  CPPUNIT_ASSERT(msg4.get_framelen() == 64);
+  CPPUNIT_ASSERT(memcmp(msg4.get_frame(), packet.soframe(), 64) == 0);
+  delete msg3;
+
+  /* missing in_port */
+  if (version > rofl::openflow10::OFP_VERSION) {
+    rofl::openflow::cofmatch match5(version);
+    match5.set_eth_type(0x0800);
+    rofl::openflow::cofmsg_packet_in msg5(version, 0xa1a2a3a4, 0, 0, 0, 0, 0,
+                                          0, match5);
+    rofl::cmemory mem5(msg5.length());
+    msg5.pack(mem5.somem(), mem5.length());
+    rofl::openflow::cofmsg_packet_in msg6;
+    msg6.unpack(mem5.somem(), mem5.length());
+    CPPUNIT_ASSERT_THROW(msg6.get_match_in_port(), rofl::openflow::eOxmInval);
+    CPPUNIT_ASSERT(msg6.get_framelen() == 0);
+  }
+
+  /* the received message is released once match and frame are decoded,
+   * the decoded message packs to the same bytes */
+  rofl::openflow::cofmsg_packet_in msg7;
+  msg7.unpack(mem.somem(), mem.length());
+  CPPUNIT_ASSERT(msg7.get_packet() == packet);
+  if (version > rofl::openflow10::OFP_VERSION) {
+    CPPUNIT_ASSERT(msg7.get_match_in_port() == 0x81828384);
+    CPPUNIT_ASSERT(msg7.get_match().get_eth_type() == 0x0800);
+  }
+  CPPUNIT_ASSERT(msg7.get_framelen() == packet.length());
+  CPPUNIT_ASSERT(
+      memcmp(msg7.get_frame(), packet.soframe(), packet.length()) == 0);
+  CPPUNIT_ASSERT(msg7.length() == msg1.length());
+  rofl::cmemory mem7(msg7.length());
+  msg7.pack(mem7.somem(), mem7.length());
+  CPPUNIT_ASSERT(mem7 == mem);
+}
+
+void cofmsgpacketintest::testBadMatch13() {
+  uint8_t version = rofl::openflow13::OFP_VERSION;
+  rofl::openflow::cofmatch match(version);
+  match.set_in_port(3);
+  match.set_eth_type(0x0800);
+  rofl::cpacket packet(64);
+  rofl::openflow::cofmsg_packet_in msg1(version, 0xa1a2a3a4, 0xffffffff, 64,
+                                        0x01, 0, 0, 0, match, packet.soframe(),
+                                        packet.length());
+  rofl::cmemory mem(msg1.length());
+  msg1.pack(mem.somem(), mem.length());
+
+  struct rofl::openflow13::ofp_packet_in *hdr =
+      (struct rofl::openflow13::ofp_packet_in *)(mem.somem());
+  /* in_port TLV comes first, its oxm_length is the last header byte */
+  uint8_t *oxm_length = hdr->match.oxm_fields + 3;
+  CPPUNIT_ASSERT(*oxm_length == sizeof(uint32_t));
+
+  /* TLV overruns the OXM list */
+  {
+    rofl::cmemory bad(mem);
+    bad.somem()[oxm_length - mem.somem()] = 0xf0;
+    rofl::openflow::cofmsg_packet_in msg;
+    CPPUNIT_ASSERT_THROW(msg.unpack(bad.somem(), bad.length()),
+                         rofl::openflow::eOxmBadLen);
+  }
+
+  /* TLV length does not match the field size */
+  {
+    rofl::cmemory bad(mem);
+    bad.somem()[oxm_length - mem.somem()] = 2;
+    rofl::openflow::cofmsg_packet_in msg;
+    CPPUNIT_ASSERT_THROW(msg.unpack(bad.somem(), bad.length()),
+                         rofl::openflow::eOxmBadLen);
+  }
+
+  /* mask on a non-maskable field */
+  {
+    rofl::cmemory bad(mem);
+    bad.somem()[oxm_length - mem.somem() - 1] |= 0x01;
+    rofl::openflow::cofmsg_packet_in msg;
+    CPPUNIT_ASSERT_THROW(msg.unpack(bad.somem(), bad.length()),
+                         rofl::eBadMatchBadMask);
+  }
+
+  /* match shorter than its own header */
+  {
+    rofl::cmemory bad(mem);
+    ((struct rofl::openflow13::ofp_packet_in *)bad.somem())->match.length =
+        htobe16(2);
+    rofl::openflow::cofmsg_packet_in msg;
+    CPPUNIT_ASSERT_THROW(msg.unpack(bad.somem(), bad.length()),
+                         rofl::eBadMatchBadLen);
+  }
+
+  /* the unmodified message still parses and decodes */
+  rofl::openflow::cofmsg_packet_in msg;
+  msg.unpack(mem.somem(), mem.length());
+  CPPUNIT_ASSERT(msg.get_match().get_in_port() == 3);
+}
+
+void cofmsgpacketintest::testConcurrentDecode() {
+  uint8_t version = rofl::openflow13::OFP_VERSION;
+  rofl::openflow::cofmatch match(version);
+  match.set_in_port(3);
+  match.set_eth_type(0x0800);
+  match.set_eth_dst(rofl::caddress_ll("00:11:11:11:11:11"));
+  rofl::cpacket packet(256);
+  for (unsigned int i = 0; i < packet.length(); i++) {
+    packet.soframe()[i] = i;
+  }
+  rofl::openflow::cofmsg_packet_in msg1(version, 0xa1a2a3a4, 0xffffffff, 256,
+                                        0x01, 0, 0, 0, match, packet.soframe(),
+                                        packet.length());
+  rofl::cmemory mem(msg1.length());
+  msg1.pack(mem.somem(), mem.length());
+
+  for (unsigned int round = 0; round < 100; round++) {
+    rofl::openflow::cofmsg_packet_in msg;
+    msg.unpack(mem.somem(), mem.length());
+    const rofl::openflow::cofmsg_packet_in &cmsg = msg;
+
+    std::vector<std::thread> threads;
+    std::vector<int> results(4, 0);
+    for (unsigned int i = 0; i < results.size(); i++) {
+      threads.emplace_back([&cmsg, &packet, &results, i]() {
+        /* get_frame() refers to the decoded frame after get_packet() */
+        bool ok = (cmsg.get_match().get_in_port() == 3) &&
+                  (cmsg.get_match().get_eth_type() == 0x0800) &&
+                  (cmsg.get_packet() == packet) &&
+                  (memcmp(cmsg.get_frame(), packet.soframe(),
+                          packet.length()) == 0);
+        results[i] = ok ? 1 : -1;
+      });
+    }
+    for (auto &thread : threads) {
+      thread.join();
+    }
+    for (auto result : results) {
+      CPPUNIT_ASSERT(result == 1);
+    }
+  }
+}
+
+void cofmsgpacketintest::testDecodeBenchmark() {
+  const unsigned int num_msgs = testutil::bench_size(200000, 2000);
+  uint8_t version = rofl::openflow13::OFP_VERSION;
+  rofl::openflow::cofmatch match(version);
+  match.set_in_port(3);
+  match.set_eth_type(0x0800);
+  match.set_eth_dst(rofl::caddress_ll("00:11:11:11:11:11"));
+  match.set_eth_src(rofl::caddress_ll("00:22:22:22:22:22"));
+  match.set_ip_proto(17);
+  match.set_ipv4_src(rofl::caddress_in4("10.0.0.1"));
+  match.set_ipv4_dst(rofl::caddress_in4("10.0.0.2"));
+  rofl::cpacket packet(1500);
+  for (unsigned int i = 0; i < packet.length(); i++) {
+    packet.soframe()[i] = i;
+  }
+  rofl::openflow::cofmsg_packet_in msg(version, 0xa1a2a3a4, 0xffffffff, 1500,
+                                       0x01, 0, 0, 0, match, packet.soframe(),
+                                       packet.length());
+  rofl::cmemory mem(msg.length());
+  msg.pack(mem.somem(), mem.length());
+
+  /* eager: decode match and frame, as done on every unpack() before */
+  unsigned long sum_eager = 0;
+  double start = now();
+  for (unsigned int i = 0; i < num_msgs; i++) {
+    rofl::openflow::cofmsg_packet_in *pin =
+        new rofl::openflow::cofmsg_packet_in();
+    pin->unpack(mem.somem(), mem.length());
+    sum_eager += pin->get_match().get_in_port();
+    sum_eager += pin->get_packet().soframe()[12];
+    delete pin;
+  }
+  double t_eager = now() - start;
+
+  /* lazy: look at in_port and a few header bytes only */
+  unsigned long sum_lazy = 0;
+  start = now();
+  for (unsigned int i = 0; i < num_msgs; i++) {
+    rofl::openflow::cofmsg_packet_in *pin =
+        new rofl::openflow::cofmsg_packet_in();
+    pin->unpack(mem.somem(), mem.length());
+    sum_lazy += pin->get_match_in_port();
+    sum_lazy += pin->get_frame()[12];
+    delete pin;
+  }
+  double t_lazy = now() - start;
+
+  std::cerr << "packet-in decode: eager: " << 1e9 * t_eager / num_msgs
+            << " ns/msg lazy: " << 1e9 * t_lazy / num_msgs
+            << " ns/msg speedup: " << t_eager / t_lazy << std::endl;
+
+  CPPUNIT_ASSERT(sum_eager == sum_lazy);
+}
@@ -22,6 +22,11 @@ class cofmsgpacketintest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testPacketInParser10);
   CPPUNIT_TEST(testPacketInParser12);
   CPPUNIT_TEST(testPacketInParser13);
+  CPPUNIT_TEST(testLazyDecode10);
+  CPPUNIT_TEST(testLazyDecode13);
+  CPPUNIT_TEST(testBadMatch13);
+  CPPUNIT_TEST(testConcurrentDecode);
+  CPPUNIT_TEST(testDecodeBenchmark);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -35,10 +40,16 @@ public:
   void testPacketInParser10();
   void testPacketInParser12();
   void testPacketInParser13();
+  void testLazyDecode10();
+  void testLazyDecode13();
+  void testBadMatch13();
+  void testConcurrentDecode();
+  void testDecodeBenchmark();
 
 private:
   void testPacketIn(uint8_t version, uint8_t type, uint32_t xid);
   void testPacketInParser(uint8_t version, uint8_t type, uint32_t xid);
+  void testLazyDecode(uint8_t version);
 };
 
 #endif /* TEST_SRC_ROFL_COMMON_OPENFLOW_MESSAGES_COFMSGPACKET_IN_TEST_HPP_ */
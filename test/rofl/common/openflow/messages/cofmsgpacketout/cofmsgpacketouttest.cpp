@@ -6,16 +6,30 @@
  */
 
 #include <stdlib.h>
+#include <time.h>
+
+#include <memory>
 
 #include <cppunit/extensions/TestFactoryRegistry.h>
 #include <cppunit/ui/text/TestRunner.h>
 
+#include "../../../testutil.hpp"
 #include "cofmsgpacketouttest.hpp"
 
 using namespace rofl::openflow;
 
 CPPUNIT_TEST_SUITE_REGISTRATION(cofmsgpacketouttest);
 
+namespace {
+
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+}; // namespace
+
 void cofmsgpacketouttest::setUp() {}
 
 void cofmsgpacketouttest::tearDown() {}
@@ -375,3 +389,82 @@ void cofmsgpacketouttest::testPacketOutPack13() {
 	std::cerr << mem << std::endl;
 }
 
+void cofmsgpacketouttest::testPacketOutFrame13() {
+  uint32_t xid = 0xa1a2a3a4;
+  rofl::openflow::cofactions actions(rofl::openflow13::OFP_VERSION);
+  actions.add_action_output(rofl::cindex(0)).set_port_no(OFPP_FLOOD);
+  std::shared_ptr<rofl::cmemory> frame(new rofl::cmemory(1500));
+  for (unsigned int i = 0; i < frame->length(); i++) {
+    (*frame)[i] = i;
+  }
+
+  cofmsg_packet_out copied(rofl::openflow13::OFP_VERSION, xid, OFP_NO_BUFFER,
+                           1, actions, frame->somem(), frame->length());
+  cofmsg_packet_out referenced(rofl::openflow13::OFP_VERSION, xid,
+                               OFP_NO_BUFFER, 1, actions, frame);
+  CPPUNIT_ASSERT(referenced.get_packet().empty());
+  CPPUNIT_ASSERT(referenced.length() == copied.length());
+
+  /* same wire format */
+  rofl::cmemory mem1(copied.length());
+  rofl::cmemory mem2(referenced.length());
+  copied.pack(mem1.somem(), mem1.length());
+  referenced.pack(mem2.somem(), mem2.length());
+  CPPUNIT_ASSERT(mem1 == mem2);
+
+  /* header and actions only, the frame is referenced */
+  rofl::cmemory head(referenced.length());
+  struct iovec payload;
+  size_t headlen = referenced.pack_head(head.somem(), head.length(), payload);
+  CPPUNIT_ASSERT(headlen == referenced.length() - frame->length());
+  CPPUNIT_ASSERT(payload.iov_base == frame->somem());
+  CPPUNIT_ASSERT(payload.iov_len == frame->length());
+  CPPUNIT_ASSERT(memcmp(head.somem(), mem1.somem(), headlen) == 0);
+
+  /* messages without frame are packed entirely */
+  headlen = copied.pack_head(head.somem(), head.length(), payload);
+  CPPUNIT_ASSERT(headlen == copied.length());
+  CPPUNIT_ASSERT(payload.iov_len == 0);
+
+  cofmsg_packet_out parsed;
+  parsed.unpack(mem2.somem(), mem2.length());
+  CPPUNIT_ASSERT(not parsed.get_frame());
+  CPPUNIT_ASSERT(parsed.get_packet().length() == frame->length());
+}
+
+void cofmsgpacketouttest::testPacketOutBenchmark() {
+  const unsigned int num_msgs = testutil::bench_size(100000, 1000);
+  rofl::openflow::cofactions actions(rofl::openflow13::OFP_VERSION);
+  actions.add_action_output(rofl::cindex(0)).set_port_no(OFPP_FLOOD);
+  rofl::cmemory txbuffer(65536);
+
+  /* message creation and packing into a transmission buffer */
+  for (size_t framelen : {64, 1500, 9000}) {
+    std::shared_ptr<rofl::cmemory> frame(new rofl::cmemory(framelen));
+
+    double start = now();
+    for (unsigned int i = 0; i < num_msgs; i++) {
+      cofmsg_packet_out *msg = new cofmsg_packet_out(
+          rofl::openflow13::OFP_VERSION, i, OFP_NO_BUFFER, 1, actions,
+          frame->somem(), frame->length());
+      msg->pack(txbuffer.somem(), txbuffer.length());
+      delete msg;
+    }
+    double t_copy = now() - start;
+
+    start = now();
+    for (unsigned int i = 0; i < num_msgs; i++) {
+      cofmsg_packet_out *msg = new cofmsg_packet_out(
+          rofl::openflow13::OFP_VERSION, i, OFP_NO_BUFFER, 1, actions, frame);
+      struct iovec payload;
+      msg->pack_head(txbuffer.somem(), txbuffer.length(), payload);
+      delete msg;
+    }
+    double t_zero_copy = now() - start;
+
+    std::cerr << "packet-out " << framelen
+              << "B: copy: " << 1e9 * t_copy / num_msgs
+              << " ns/msg zero-copy: " << 1e9 * t_zero_copy / num_msgs
+              << " ns/msg" << std::endl;
+  }
+}
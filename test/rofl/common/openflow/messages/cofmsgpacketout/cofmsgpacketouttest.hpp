@@ -23,6 +23,8 @@ class cofmsgpacketouttest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testPacketOutParser12);
   CPPUNIT_TEST(testPacketOutParser13);
   CPPUNIT_TEST(testPacketOutPack13);
+  CPPUNIT_TEST(testPacketOutFrame13);
+  CPPUNIT_TEST(testPacketOutBenchmark);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -37,6 +39,8 @@ public:
   void testPacketOutParser12();
   void testPacketOutParser13();
   void testPacketOutPack13();
+  void testPacketOutFrame13();
+  void testPacketOutBenchmark();
 
 private:
   void testPacketOut(uint8_t version, uint8_t type, uint32_t xid);
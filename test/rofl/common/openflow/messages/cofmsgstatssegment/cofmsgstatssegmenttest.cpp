@@ -0,0 +1,246 @@
+/*
+ * cofmsgstatssegmenttest.cpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#include <stdlib.h>
+#include <time.h>
+
+#include <cppunit/extensions/TestFactoryRegistry.h>
+#include <cppunit/ui/text/TestRunner.h>
+
+#include "../../../testutil.hpp"
+#include "cofmsgstatssegmenttest.hpp"
+
+using namespace rofl::openflow;
+
+CPPUNIT_TEST_SUITE_REGISTRATION(cofmsgstatssegmenttest);
+
+namespace {
+
+double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+}; // namespace
+
+void cofmsgstatssegmenttest::setUp() {}
+
+void cofmsgstatssegmenttest::tearDown() {}
+
+void cofmsgstatssegmenttest::testReplySegment10() {
+  testReplySegment(rofl::openflow10::OFP_VERSION,
+                   rofl::openflow10::OFPT_STATS_REPLY,
+                   rofl::openflow10::OFPST_FLOW);
+}
+
+void cofmsgstatssegmenttest::testReplySegment13() {
+  testReplySegment(rofl::openflow13::OFP_VERSION,
+                   rofl::openflow13::OFPT_MULTIPART_REPLY,
+                   rofl::openflow13::OFPMP_FLOW);
+}
+
+void cofmsgstatssegmenttest::testReplySegment(uint8_t version, uint8_t type,
+                                              uint16_t stats_type) {
+  cofflowstatsarray array(version);
+  fill(array, 16);
+
+  cofmsg_stats_reply_segment msg1(version, 0xa1a2a3a4, stats_type, 0xb1b2);
+  array.pack(msg1.resize_body(array.length()), array.length());
+
+  rofl::cmemory mem(msg1.length());
+  msg1.pack(mem.somem(), mem.length());
+
+  /* a segment is indistinguishable from a regular reply on the wire */
+  cofmsg_flow_stats_reply msg2;
+  msg2.unpack(mem.somem(), mem.length());
+
+  CPPUNIT_ASSERT(msg2.get_version() == version);
+  CPPUNIT_ASSERT(msg2.get_type() == type);
+  CPPUNIT_ASSERT(msg2.get_length() == msg1.length());
+  CPPUNIT_ASSERT(msg2.get_xid() == 0xa1a2a3a4);
+  CPPUNIT_ASSERT(msg2.get_stats_type() == stats_type);
+  CPPUNIT_ASSERT(msg2.get_stats_flags() == 0xb1b2);
+  CPPUNIT_ASSERT(msg2.get_flow_stats_array().size() == array.size());
+
+  rofl::cmemory mem2(msg2.length());
+  msg2.pack(mem2.somem(), mem2.length());
+  CPPUNIT_ASSERT(mem2 == mem);
+
+  cofmsg_stats_reply_segment msg3;
+  msg3.unpack(mem.somem(), mem.length());
+  CPPUNIT_ASSERT(msg3.length() == msg1.length());
+  CPPUNIT_ASSERT(msg3.get_body() == msg1.get_body());
+}
+
+void cofmsgstatssegmenttest::testRequestSegment13() {
+  uint8_t version = rofl::openflow13::OFP_VERSION;
+
+  cofmsg_stats_request_segment msg1(version, 0xa1a2a3a4,
+                                    rofl::openflow13::OFPMP_TABLE_FEATURES,
+                                    rofl::openflow13::OFPMPF_REQ_MORE);
+  memset(msg1.resize_body(64), 0x5a, 64);
+
+  rofl::cmemory mem(msg1.length());
+  msg1.pack(mem.somem(), mem.length());
+
+  cofmsg_stats_request_segment msg2;
+  msg2.unpack(mem.somem(), mem.length());
+
+  CPPUNIT_ASSERT(msg2.get_version() == version);
+  CPPUNIT_ASSERT(msg2.get_type() == rofl::openflow13::OFPT_MULTIPART_REQUEST);
+  CPPUNIT_ASSERT(msg2.get_length() == msg1.length());
+  CPPUNIT_ASSERT(msg2.get_stats_type() ==
+                 rofl::openflow13::OFPMP_TABLE_FEATURES);
+  CPPUNIT_ASSERT(msg2.get_stats_flags() == rofl::openflow13::OFPMPF_REQ_MORE);
+  CPPUNIT_ASSERT(msg2.get_body() == msg1.get_body());
+}
+
+void cofmsgstatssegmenttest::testSegmenter10() {
+  testSegmenter(rofl::openflow10::OFP_VERSION, rofl::openflow10::OFPST_FLOW,
+                rofl::openflow10::OFPSF_REPLY_MORE);
+}
+
+void cofmsgstatssegmenttest::testSegmenter13() {
+  testSegmenter(rofl::openflow13::OFP_VERSION, rofl::openflow13::OFPMP_FLOW,
+                rofl::openflow13::OFPMPF_REPLY_MORE);
+}
+
+void cofmsgstatssegmenttest::testSegmenter(uint8_t version,
+                                           uint16_t stats_type,
+                                           uint16_t more_flag) {
+  const size_t max_length = 4000;
+  cofflowstatsarray array(version);
+  fill(array, 2000);
+
+  rofl::cmemory packed(array.length());
+  array.pack(packed.somem(), packed.length());
+
+  cofmsg_stats_segmenter<cofmsg_stats_reply_segment, cofflow_stats_reply>
+      segmenter(version, 0xa1a2a3a4, stats_type, 0, max_length);
+  for (auto flowid : array.keys()) {
+    segmenter.add(array.set_flow_stats(flowid));
+  }
+  auto segments = segmenter.get_segments(more_flag);
+
+  CPPUNIT_ASSERT(segments.size() > 1);
+
+  rofl::cmemory bodies;
+  cofflowstatsarray reassembled(version);
+  for (auto segment : segments) {
+    CPPUNIT_ASSERT(segment->get_body().length() <= max_length);
+    CPPUNIT_ASSERT(segment->get_xid() == 0xa1a2a3a4);
+    CPPUNIT_ASSERT(segment->get_stats_type() == stats_type);
+    if (segment != segments.back()) {
+      CPPUNIT_ASSERT(segment->get_stats_flags() & more_flag);
+    } else {
+      CPPUNIT_ASSERT(not(segment->get_stats_flags() & more_flag));
+    }
+    bodies += segment->get_body();
+
+    rofl::cmemory mem(segment->length());
+    segment->pack(mem.somem(), mem.length());
+    cofmsg_flow_stats_reply msg;
+    msg.unpack(mem.somem(), mem.length());
+    reassembled += msg.get_flow_stats_array();
+
+    delete segment;
+  }
+
+  CPPUNIT_ASSERT(bodies == packed);
+  CPPUNIT_ASSERT(reassembled.size() == array.size());
+}
+
+void cofmsgstatssegmenttest::fill(cofflowstatsarray &array,
+                                  unsigned int num_flows) {
+  for (unsigned int i = 0; i < num_flows; i++) {
+    cofflow_stats_reply &flow_stats = array.add_flow_stats(i);
+    flow_stats.set_table_id(i % 4);
+    flow_stats.set_priority(0x8000 + (i % 16));
+    flow_stats.set_cookie(i);
+    flow_stats.set_packet_count(i * 10);
+    flow_stats.set_byte_count(i * 1000);
+    flow_stats.set_match().set_in_port(i + 1);
+    flow_stats.set_match().set_eth_type(0x0800);
+    if (i % 3 == 0) {
+      /* entries of varying length */
+      flow_stats.set_match().set_eth_dst(rofl::cmacaddr("11:22:33:44:55:66"));
+    }
+  }
+}
+
+void cofmsgstatssegmenttest::testSegmenterBenchmark() {
+  /* full sizes with ROFL_BENCH set only, see make check-bench */
+  if (not testutil::bench()) {
+    run_benchmark(1000);
+    return;
+  }
+  for (unsigned int num_flows : {10000, 100000, 1000000}) {
+    run_benchmark(num_flows);
+  }
+}
+
+void cofmsgstatssegmenttest::run_benchmark(unsigned int num_flows) {
+  const size_t MAX_LENGTH = 64000;
+  uint8_t version = rofl::openflow13::OFP_VERSION;
+  cofflowstatsarray array(version);
+  fill(array, num_flows);
+
+  size_t bytes_copying = 0;
+  size_t bytes_streaming = 0;
+  unsigned int num_segments = 0;
+
+  /* previous approach: copy entries into an array per segment and recompute
+   * the length of the segment for each entry */
+  double start = now();
+  {
+    std::list<cofmsg_flow_stats_reply *> segments;
+    auto flowids = array.keys();
+    while (not flowids.empty()) {
+      cofflowstatsarray segment(version);
+      while ((not flowids.empty()) && (segment.length() < MAX_LENGTH)) {
+        uint32_t flowid = flowids.front();
+        flowids.pop_front();
+        segment.add_flow_stats(flowid) = array.get_flow_stats(flowid);
+      }
+      segments.push_back(new cofmsg_flow_stats_reply(version, 0, 0, segment));
+    }
+    for (auto msg : segments) {
+      rofl::cmemory mem(msg->length());
+      msg->pack(mem.somem(), mem.length());
+      bytes_copying += mem.length();
+      delete msg;
+    }
+  }
+  double t_copying = now() - start;
+
+  /* streaming segmenter */
+  start = now();
+  {
+    cofmsg_stats_segmenter<cofmsg_stats_reply_segment, cofflow_stats_reply>
+        segmenter(version, 0, rofl::openflow13::OFPMP_FLOW, 0, MAX_LENGTH);
+    for (auto flowid : array.keys()) {
+      segmenter.add(array.set_flow_stats(flowid));
+    }
+    for (auto msg :
+         segmenter.get_segments(rofl::openflow13::OFPMPF_REPLY_MORE)) {
+      rofl::cmemory mem(msg->length());
+      msg->pack(mem.somem(), mem.length());
+      bytes_streaming += mem.length();
+      num_segments++;
+      delete msg;
+    }
+  }
+  double t_streaming = now() - start;
+
+  std::cerr << "flows=" << num_flows << " segments=" << num_segments
+            << " copying: " << t_copying << "s"
+            << " streaming: " << t_streaming << "s"
+            << " speedup: " << t_copying / t_streaming << std::endl;
+
+  CPPUNIT_ASSERT(bytes_streaming > 0);
+  CPPUNIT_ASSERT(bytes_copying > 0);
+}
@@ -0,0 +1,46 @@
+/*
+ * cofmsgstatssegmenttest.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef TEST_SRC_ROFL_COMMON_OPENFLOW_MESSAGES_COFMSGSTATSSEGMENT_TEST_HPP_
+#define TEST_SRC_ROFL_COMMON_OPENFLOW_MESSAGES_COFMSGSTATSSEGMENT_TEST_HPP_
+
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "rofl/common/cmemory.h"
+#include "rofl/common/openflow/messages/cofmsg_flow_stats.h"
+#include "rofl/common/openflow/messages/cofmsg_stats_segment.h"
+
+class cofmsgstatssegmenttest : public CppUnit::TestFixture {
+  CPPUNIT_TEST_SUITE(cofmsgstatssegmenttest);
+  CPPUNIT_TEST(testReplySegment10);
+  CPPUNIT_TEST(testReplySegment13);
+  CPPUNIT_TEST(testRequestSegment13);
+  CPPUNIT_TEST(testSegmenter10);
+  CPPUNIT_TEST(testSegmenter13);
+  CPPUNIT_TEST(testSegmenterBenchmark);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void setUp();
+  void tearDown();
+
+public:
+  void testReplySegment10();
+  void testReplySegment13();
+  void testRequestSegment13();
+  void testSegmenter10();
+  void testSegmenter13();
+  void testSegmenterBenchmark();
+
+private:
+  void testReplySegment(uint8_t version, uint8_t type, uint16_t stats_type);
+  void testSegmenter(uint8_t version, uint16_t stats_type, uint16_t more_flag);
+  void fill(rofl::openflow::cofflowstatsarray &array, unsigned int num_flows);
+  void run_benchmark(unsigned int num_flows);
+};
+
+#endif /* TEST_SRC_ROFL_COMMON_OPENFLOW_MESSAGES_COFMSGSTATSSEGMENT_TEST_HPP_ */
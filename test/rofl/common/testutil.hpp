@@ -0,0 +1,95 @@
+/*
+ * testutil.hpp
+ *
+ *  Created on: Oct 18, 2026
+ */
+
+#ifndef TEST_SRC_ROFL_COMMON_TESTUTIL_HPP_
+#define TEST_SRC_ROFL_COMMON_TESTUTIL_HPP_
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sched.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+#include <atomic>
+
+/* helpers shared by the socket and benchmark tests */
+namespace testutil {
+
+/**
+ * @brief	Returns CLOCK_MONOTONIC in seconds
+ */
+inline double now() {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief	Returns true if benchmarks run at full size, see make check-bench
+ */
+inline bool bench() { return (getenv("ROFL_BENCH") != nullptr); }
+
+/**
+ * @brief	Returns full with ROFL_BENCH set, reduced otherwise
+ *
+ * Keeps benchmarks inside the unit tests short on a plain make check.
+ */
+template <typename T> T bench_size(T full, T reduced) {
+  return bench() ? full : reduced;
+}
+
+/**
+ * @brief	Waits up to timeout seconds until counter reaches value
+ *
+ * @return true if counter reached value in time
+ */
+inline bool wait_for(const std::atomic_uint &counter, unsigned int value,
+                     double timeout) {
+  double start = now();
+  while ((counter < value) && (now() - start < timeout)) {
+    sched_yield();
+  }
+  return (counter >= value);
+}
+
+/**
+ * @brief	Binds sd to an ephemeral port on 127.0.0.1
+ *
+ * @return port in host byte order or 0 on error
+ */
+inline uint16_t bind_any_port(int sd) {
+  struct sockaddr_in sin = {};
+  sin.sin_family = AF_INET;
+  sin.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t sinlen = sizeof(sin);
+  if ((bind(sd, (struct sockaddr *)&sin, sinlen) < 0) ||
+      (getsockname(sd, (struct sockaddr *)&sin, &sinlen) < 0)) {
+    return 0;
+  }
+  return ntohs(sin.sin_port);
+}
+
+/**
+ * @brief	Returns a currently unused TCP port on 127.0.0.1
+ *
+ * For listeners created by the code under test. Tests listening on a
+ * socket of their own use bind_any_port() instead.
+ */
+inline uint16_t free_port() {
+  int sd = socket(AF_INET, SOCK_STREAM, 0);
+  if (sd < 0) {
+    return 0;
+  }
+  uint16_t port = bind_any_port(sd);
+  close(sd);
+  return port;
+}
+
+} // namespace testutil
+
+#endif /* TEST_SRC_ROFL_COMMON_TESTUTIL_HPP_ */